@@ -53,10 +53,16 @@ public:
     {
     public:
         using SharedPtr = std::shared_ptr<ReadTextureTask>;
-        static SharedPtr create(CopyContext* pCtx, const Texture* pTexture, uint32_t subresourceIndex);
+        static SharedPtr create(CopyContext* pCtx, const Texture* pTexture, uint32_t subresourceIndex, ref<Buffer> pStagingBuffer = nullptr);
         void getData(void* pData, size_t size) const;
         std::vector<uint8_t> getData() const;
 
+        /// Returns true if the copy has completed on the GPU, i.e., getData() will not block.
+        bool isComplete() const;
+
+        /// Returns the readback buffer the data is copied to. It can be reused for another read after getData() has been called.
+        const ref<Buffer>& getStagingBuffer() const { return mpBuffer; }
+
     private:
         ReadTextureTask() = default;
         ref<Fence> mpFence;
@@ -221,8 +227,15 @@ public:
 
     /**
      * Read texture data Asynchronously
+     * @param[in] pTexture The texture to read.
+     * @param[in] subresourceIndex The subresource to read.
+     * @param[in] pStagingBuffer Optional readback buffer to copy to. It is used if it is large enough, otherwise a new buffer is created.
      */
-    ReadTextureTask::SharedPtr asyncReadTextureSubresource(const Texture* pTexture, uint32_t subresourceIndex);
+    ReadTextureTask::SharedPtr asyncReadTextureSubresource(
+        const Texture* pTexture,
+        uint32_t subresourceIndex,
+        ref<Buffer> pStagingBuffer = nullptr
+    );
 
     /**
      * Get the low-level context data
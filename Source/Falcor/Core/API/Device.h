@@ -148,6 +148,13 @@ public:
         /// The full path to the root directory for the shader cache. An empty string will disable the cache.
         std::string shaderCachePath = (getRuntimeDirectory() / ".shadercache").string();
 
+        /// The maximum number of entries allowable in the program cache. A value of 0 indicates no limit.
+        uint32_t maxProgramCacheEntryCount = 1000;
+
+        /// The full path to the root directory for the program cache, storing Slang front-end compilation results.
+        /// An empty string will disable the cache.
+        std::string programCachePath = (getRuntimeDirectory() / ".programcache").string();
+
 #if FALCOR_HAS_D3D12
         /// GUID list for experimental features
         std::vector<GUID> experimentalFeatures;
@@ -310,6 +310,11 @@ public:
      */
     const std::filesystem::path& getSourcePath() const { return mSourcePath; }
 
+    /**
+     * In case the texture was loaded from a file, use this to set the import flags used.
+     */
+    void setImportFlags(Bitmap::ImportFlags importFlags) { mImportFlags = importFlags; }
+
     /**
      * In case the texture was loaded from a file, get the import flags used.
      */
@@ -345,6 +345,19 @@ bool Program::link() const
     }
 }
 
+bool Program::isLinkPending() const
+{
+    return mLinkRequired && mProgramVersions.find(ProgramVersionKey{mDefineList, mTypeConformanceList}) == mProgramVersions.end();
+}
+
+void Program::setActiveVersion(const ref<const ProgramVersion>& pVersion) const
+{
+    FALCOR_ASSERT(pVersion);
+    mpActiveVersion = pVersion;
+    mProgramVersions[ProgramVersionKey{mDefineList, mTypeConformanceList}] = pVersion;
+    mLinkRequired = false;
+}
+
 void Program::reset()
 {
     mpActiveVersion = nullptr;
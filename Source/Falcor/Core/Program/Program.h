@@ -791,6 +791,11 @@ protected:
     mutable ref<const ProgramVersion> mpActiveVersion;
     void markDirty() { mLinkRequired = true; }
 
+    /// Check if linking is required to create the active version.
+    bool isLinkPending() const;
+    /// Set the active version to a version that was linked ahead of time.
+    void setActiveVersion(const ref<const ProgramVersion>& pVersion) const;
+
     std::string getProgramDescString() const;
 
     using string_time_map = std::unordered_map<std::string, time_t>;
@@ -0,0 +1,375 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ProgramCache.h"
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+#include "Utils/StringFormatters.h"
+#include <algorithm>
+#include <fstream>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kMagic = 0x43505046; // FPPC
+const uint32_t kVersion = 1;
+
+class Writer
+{
+public:
+    Writer(std::ostream& stream) : mStream(stream) {}
+
+    template<typename T>
+    void write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        mStream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void write(const std::string& str)
+    {
+        write((uint32_t)str.size());
+        mStream.write(str.data(), str.size());
+    }
+
+    void write(const std::vector<uint8_t>& data)
+    {
+        write((uint64_t)data.size());
+        mStream.write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+
+private:
+    std::ostream& mStream;
+};
+
+class Reader
+{
+public:
+    Reader(std::istream& stream, uint64_t size) : mStream(stream), mRemaining(size) {}
+
+    template<typename T>
+    bool read(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return readBytes(&value, sizeof(T));
+    }
+
+    bool read(std::string& str)
+    {
+        uint32_t size;
+        if (!read(size) || size > mRemaining)
+            return false;
+        str.resize(size);
+        return readBytes(str.data(), size);
+    }
+
+    bool read(std::vector<uint8_t>& data)
+    {
+        uint64_t size;
+        if (!read(size) || size > mRemaining)
+            return false;
+        data.resize(size);
+        return readBytes(data.data(), size);
+    }
+
+    /// Read an element count, rejecting counts that can't possibly fit in the remaining data.
+    bool readCount(uint32_t& count, size_t minElementSize)
+    {
+        return read(count) && uint64_t(count) * minElementSize <= mRemaining;
+    }
+
+private:
+    bool readBytes(void* dst, uint64_t size)
+    {
+        if (size > mRemaining)
+            return false;
+        mStream.read(reinterpret_cast<char*>(dst), size);
+        mRemaining -= size;
+        return bool(mStream);
+    }
+
+    std::istream& mStream;
+    uint64_t mRemaining;
+};
+} // namespace
+
+ProgramCache::ProgramCache(const std::filesystem::path& directory, uint32_t maxEntryCount)
+    : mDirectory(directory), mMaxEntryCount(maxEntryCount)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(mDirectory, ec);
+    if (!std::filesystem::is_directory(mDirectory))
+        FALCOR_THROW("Program cache path {} is not a directory.", mDirectory);
+
+    mEntryCount = getEntryPaths().size();
+    evictEntries();
+}
+
+size_t ProgramCache::getEntryCount() const
+{
+    std::lock_guard<std::mutex> lock(mEntryCountMutex);
+    return mEntryCount;
+}
+
+std::optional<ProgramCache::Entry> ProgramCache::load(const Key& key) const
+{
+    auto path = getEntryPath(key);
+    std::error_code ec;
+    auto fileSize = std::filesystem::file_size(path, ec);
+    if (ec)
+        return {};
+
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+        return {};
+
+    Reader reader(stream, fileSize);
+    uint32_t magic, version;
+    if (!reader.read(magic) || !reader.read(version) || magic != kMagic || version != kVersion)
+        return {};
+
+    Entry entry;
+    uint32_t count;
+
+    if (!reader.readCount(count, sizeof(uint32_t) + sizeof(SHA1::MD)))
+        return {};
+    entry.dependencies.resize(count);
+    for (auto& dependency : entry.dependencies)
+    {
+        if (!reader.read(dependency.path) || !reader.read(dependency.hash))
+            return {};
+    }
+
+    if (!reader.readCount(count, 2 * sizeof(uint32_t) + sizeof(uint64_t)))
+        return {};
+    entry.modules.resize(count);
+    for (auto& module : entry.modules)
+    {
+        if (!reader.read(module.name) || !reader.read(module.path) || !reader.read(module.data))
+            return {};
+    }
+
+    if (!reader.readCount(count, sizeof(uint32_t)))
+        return {};
+    entry.translationUnits.resize(count);
+    for (auto& index : entry.translationUnits)
+    {
+        if (!reader.read(index) || index >= entry.modules.size())
+            return {};
+    }
+
+    // Check that none of the source files changed since the entry was written.
+    for (const auto& dependency : entry.dependencies)
+    {
+        auto hash = getFileHash(dependency.path);
+        if (!hash || *hash != dependency.hash)
+        {
+            logDebug("Program cache entry {} is stale, '{}' has changed.", SHA1::toString(key), dependency.path);
+            return {};
+        }
+    }
+
+    // Mark the entry as recently used.
+    stream.close();
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+
+    return entry;
+}
+
+bool ProgramCache::store(const Key& key, const Entry& entry) const
+{
+    auto path = getEntryPath(key);
+
+    // Write to a uniquely named temporary file and move it into place once complete.
+    // This avoids other threads or processes observing partially written entries.
+    auto tmpPath = path;
+    tmpPath += fmt::format(".{:08x}.tmp", std::random_device()());
+
+    {
+        std::ofstream stream(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!stream)
+            return false;
+
+        Writer writer(stream);
+        writer.write(kMagic);
+        writer.write(kVersion);
+
+        writer.write((uint32_t)entry.dependencies.size());
+        for (const auto& dependency : entry.dependencies)
+        {
+            writer.write(dependency.path);
+            writer.write(dependency.hash);
+        }
+
+        writer.write((uint32_t)entry.modules.size());
+        for (const auto& module : entry.modules)
+        {
+            writer.write(module.name);
+            writer.write(module.path);
+            writer.write(module.data);
+        }
+
+        writer.write((uint32_t)entry.translationUnits.size());
+        for (auto index : entry.translationUnits)
+            writer.write(index);
+
+        if (!stream.flush())
+        {
+            stream.close();
+            std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    bool replaced = std::filesystem::exists(path, ec);
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec)
+    {
+        logWarning("Failed to write program cache entry '{}': {}", path, ec.message());
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+
+    if (!replaced)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mEntryCountMutex);
+            mEntryCount++;
+        }
+        evictEntries();
+    }
+
+    return true;
+}
+
+void ProgramCache::clear()
+{
+    std::error_code ec;
+    for (const auto& path : getEntryPaths())
+        std::filesystem::remove(path, ec);
+
+    {
+        std::lock_guard<std::mutex> lock(mEntryCountMutex);
+        mEntryCount = 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mFileHashesMutex);
+    mFileHashes.clear();
+}
+
+std::optional<SHA1::MD> ProgramCache::getFileHash(const std::filesystem::path& path) const
+{
+    std::error_code ec;
+    auto time = std::filesystem::last_write_time(path, ec);
+    if (ec)
+        return {};
+
+    const std::string pathStr = path.string();
+    {
+        std::lock_guard<std::mutex> lock(mFileHashesMutex);
+        auto it = mFileHashes.find(pathStr);
+        if (it != mFileHashes.end() && it->second.time == time)
+            return it->second.hash;
+    }
+
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+        return {};
+
+    SHA1 sha1;
+    char buffer[64 * 1024];
+    while (stream)
+    {
+        stream.read(buffer, sizeof(buffer));
+        sha1.update(buffer, (size_t)stream.gcount());
+    }
+    if (!stream.eof())
+        return {};
+    auto hash = sha1.finalize();
+
+    std::lock_guard<std::mutex> lock(mFileHashesMutex);
+    mFileHashes[pathStr] = {time, hash};
+    return hash;
+}
+
+std::filesystem::path ProgramCache::getEntryPath(const Key& key) const
+{
+    return mDirectory / (SHA1::toString(key) + ".bin");
+}
+
+std::vector<std::filesystem::path> ProgramCache::getEntryPaths() const
+{
+    std::vector<std::filesystem::path> paths;
+    std::error_code ec;
+    for (const auto& it : std::filesystem::directory_iterator(mDirectory, ec))
+    {
+        if (it.is_regular_file(ec) && it.path().extension() == ".bin")
+            paths.push_back(it.path());
+    }
+    return paths;
+}
+
+void ProgramCache::evictEntries() const
+{
+    if (mMaxEntryCount == 0)
+        return;
+
+    // Evict under the lock, so that concurrent stores don't all scan the directory.
+    std::lock_guard<std::mutex> lock(mEntryCountMutex);
+    if (mEntryCount <= mMaxEntryCount)
+        return;
+
+    // Sort the entries from least to most recently used.
+    std::error_code ec;
+    std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> entries;
+    for (auto& path : getEntryPaths())
+    {
+        auto time = std::filesystem::last_write_time(path, ec);
+        if (!ec)
+            entries.emplace_back(time, std::move(path));
+    }
+    std::sort(entries.begin(), entries.end());
+
+    const size_t targetCount = mMaxEntryCount - mMaxEntryCount / 4;
+    size_t entryCount = entries.size();
+    for (const auto& [time, path] : entries)
+    {
+        if (entryCount <= targetCount)
+            break;
+        if (std::filesystem::remove(path, ec))
+            entryCount--;
+    }
+
+    logDebug("Evicted {} program cache entries.", entries.size() - entryCount);
+    mEntryCount = entryCount;
+}
+
+} // namespace Falcor
@@ -0,0 +1,152 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/CryptoUtils.h"
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Falcor
+{
+
+/**
+ * Persistent cache of Slang front-end compilation results.
+ *
+ * Each entry holds the serialized Slang modules (IR and AST) produced when compiling a program version,
+ * so that subsequent runs can load the modules instead of parsing and checking all shader sources again.
+ * Entries are content addressed: the key is a SHA-1 hash over all inputs of the front-end compilation
+ * (sources, defines, compiler flags, compiler version etc.). In addition, each entry records the content
+ * hashes of all source files that were read during compilation. An entry whose dependencies changed on disk
+ * is treated as a cache miss.
+ *
+ * The cache is safe to use from multiple threads and processes. Entries are written to a temporary file
+ * first and then moved into place.
+ *
+ * The number of entries can be limited. When the limit is exceeded, the least recently used entries are
+ * removed until a quarter of the limit is free again, so that the directory is not scanned on every store.
+ */
+class FALCOR_API ProgramCache
+{
+public:
+    using Key = SHA1::MD;
+
+    /// Source file read during compilation.
+    struct Dependency
+    {
+        std::string path;
+        SHA1::MD hash;
+    };
+
+    /// Serialized Slang module.
+    struct Module
+    {
+        std::string name;
+        std::string path;
+        std::vector<uint8_t> data;
+    };
+
+    struct Entry
+    {
+        /// Source files the entry depends on.
+        std::vector<Dependency> dependencies;
+        /// Serialized modules, in the order they need to be loaded.
+        std::vector<Module> modules;
+        /// Index into `modules` for each translation unit of the program.
+        std::vector<uint32_t> translationUnits;
+    };
+
+    /**
+     * Constructor. Throws if the directory can't be created.
+     * @param[in] directory Directory to store the cache entries in. Created if it doesn't exist.
+     * @param[in] maxEntryCount Max number of entries in the cache, or 0 for no limit.
+     */
+    ProgramCache(const std::filesystem::path& directory, uint32_t maxEntryCount = 0);
+
+    const std::filesystem::path& getDirectory() const { return mDirectory; }
+
+    uint32_t getMaxEntryCount() const { return mMaxEntryCount; }
+
+    /// Get the number of entries in the cache. Entries stored by other processes are only counted when evicting.
+    size_t getEntryCount() const;
+
+    /**
+     * Load a cache entry.
+     * @param[in] key Cache key.
+     * @return Returns the entry, or an empty optional if the entry doesn't exist, is corrupt or any of its dependencies changed.
+     */
+    std::optional<Entry> load(const Key& key) const;
+
+    /**
+     * Store a cache entry, replacing any existing entry with the same key.
+     * @param[in] key Cache key.
+     * @param[in] entry Cache entry.
+     * @return Returns true if successful.
+     */
+    bool store(const Key& key, const Entry& entry) const;
+
+    /**
+     * Remove all entries from the cache.
+     */
+    void clear();
+
+    /**
+     * Compute the content hash of a file.
+     * Hashes are memoized based on the file modification time.
+     * @param[in] path File path.
+     * @return Returns the SHA-1 hash of the file contents, or an empty optional if the file can't be read.
+     */
+    std::optional<SHA1::MD> getFileHash(const std::filesystem::path& path) const;
+
+private:
+    std::filesystem::path getEntryPath(const Key& key) const;
+    /// Get the paths of all entries in the cache directory.
+    std::vector<std::filesystem::path> getEntryPaths() const;
+    /// Remove the least recently used entries if the cache exceeds the max entry count.
+    void evictEntries() const;
+
+    struct FileHash
+    {
+        std::filesystem::file_time_type time;
+        SHA1::MD hash;
+    };
+
+    std::filesystem::path mDirectory;
+    uint32_t mMaxEntryCount = 0;
+
+    mutable std::mutex mEntryCountMutex;
+    mutable size_t mEntryCount = 0;
+
+    mutable std::mutex mFileHashesMutex;
+    mutable std::unordered_map<std::string, FileHash> mFileHashes;
+};
+
+} // namespace Falcor
@@ -29,10 +29,14 @@
 #include "Core/API/Device.h"
 #include "Core/Platform/OS.h"
 #include "Utils/Logger.h"
+#include "Utils/TaskManager.h"
 #include "Utils/Timing/CpuTimer.h"
 
 #include <slang.h>
 
+#include <atomic>
+#include <cstring>
+
 namespace Falcor
 {
 
@@ -100,6 +104,67 @@ inline bool doSlangReflection(
     return true;
 }
 
+/// Slang global session used by the current thread, if different from the device's global session.
+thread_local slang::IGlobalSession* tpSlangGlobalSession = nullptr;
+
+/// Version of the program cache key. Increment when changing how Slang sessions are set up.
+const uint32_t kProgramCacheKeyVersion = 1;
+
+/// Blob holding a copy of serialized data passed to Slang.
+class VectorBlob : public ISlangBlob
+{
+public:
+    VectorBlob(std::vector<uint8_t> data) : mData(std::move(data)) {}
+
+    SLANG_NO_THROW SlangResult SLANG_MCALL queryInterface(SlangUUID const& uuid, void** outObject) override
+    {
+        if (isGuid(uuid, ISlangUnknown::getTypeGuid()) || isGuid(uuid, ISlangBlob::getTypeGuid()))
+        {
+            addRef();
+            *outObject = static_cast<ISlangBlob*>(this);
+            return SLANG_OK;
+        }
+        *outObject = nullptr;
+        return SLANG_E_NO_INTERFACE;
+    }
+
+    SLANG_NO_THROW uint32_t SLANG_MCALL addRef() override { return ++mRefCount; }
+
+    SLANG_NO_THROW uint32_t SLANG_MCALL release() override
+    {
+        uint32_t refCount = --mRefCount;
+        if (refCount == 0)
+            delete this;
+        return refCount;
+    }
+
+    SLANG_NO_THROW void const* SLANG_MCALL getBufferPointer() override { return mData.data(); }
+    SLANG_NO_THROW size_t SLANG_MCALL getBufferSize() override { return mData.size(); }
+
+private:
+    static bool isGuid(const SlangUUID& a, const SlangUUID& b) { return std::memcmp(&a, &b, sizeof(SlangUUID)) == 0; }
+
+    std::vector<uint8_t> mData;
+    std::atomic<uint32_t> mRefCount{0};
+};
+
+slang::IModule* findLoadedModule(slang::ISession* pSlangSession, const std::string& name)
+{
+    for (SlangInt i = 0; i < pSlangSession->getLoadedModuleCount(); ++i)
+    {
+        slang::IModule* pModule = pSlangSession->getLoadedModule(i);
+        if (pModule->getName() && name == pModule->getName())
+            return pModule;
+    }
+    return nullptr;
+}
+
+std::vector<uint8_t> toByteVector(ISlangBlob* pBlob)
+{
+    auto data = reinterpret_cast<const uint8_t*>(pBlob->getBufferPointer());
+    return std::vector<uint8_t>(data, data + pBlob->getBufferSize());
+}
+
 ProgramManager::ProgramManager(Device* pDevice) : mpDevice(pDevice)
 {
     // Set global shader defines
@@ -114,62 +179,90 @@ ProgramManager::ProgramManager(Device* pDevice) : mpDevice(pDevice)
 
     addGlobalDefines(globalDefines);
 
+    setProgramCachePath(mpDevice->getDesc().programCachePath);
 }
 
+ProgramManager::~ProgramManager() = default;
+
 ref<const ProgramVersion> ProgramManager::createProgramVersion(const Program& program, std::string& log) const
 {
     CpuTimer timer;
     timer.update();
 
-    auto pSlangRequest = createSlangCompileRequest(program);
-    if (pSlangRequest == nullptr)
-        return nullptr;
+    // Try loading the front-end compilation result from the program cache before invoking the Slang compiler.
+    std::optional<ProgramCache::Key> cacheKey;
+    if (canUseProgramCache(program))
+        cacheKey = computeProgramCacheKey(program);
+
+    Slang::ComPtr<slang::IComponentType> pSlangGlobalScope;
+    std::vector<Slang::ComPtr<slang::IComponentType>> pSlangEntryPoints;
 
-    SlangResult slangResult = spCompile(pSlangRequest);
-    log += spGetDiagnosticOutput(pSlangRequest);
-    if (SLANG_FAILED(slangResult))
+    bool cacheHit = cacheKey && loadFromProgramCache(program, *cacheKey, pSlangGlobalScope, pSlangEntryPoints, log);
+    if (cacheKey)
     {
-        spDestroyCompileRequest(pSlangRequest);
-        return nullptr;
+        std::lock_guard<std::mutex> lock(mCompilationStatsMutex);
+        if (cacheHit)
+            mCompilationStats.programCacheHitCount++;
+        else
+            mCompilationStats.programCacheMissCount++;
     }
 
-    Slang::ComPtr<slang::IComponentType> pSlangGlobalScope;
-    spCompileRequest_getProgram(pSlangRequest, pSlangGlobalScope.writeRef());
+    if (!cacheHit)
+    {
+        pSlangGlobalScope = nullptr;
+        pSlangEntryPoints.clear();
 
-    Slang::ComPtr<slang::ISession> pSlangSession(pSlangGlobalScope->getSession());
+        auto pSlangRequest = createSlangCompileRequest(program);
+        if (pSlangRequest == nullptr)
+            return nullptr;
 
-    // Prepare entry points.
-    std::vector<Slang::ComPtr<slang::IComponentType>> pSlangEntryPoints;
-    for (const auto& entryPointGroup : program.mDesc.entryPointGroups)
-    {
-        for (const auto& entryPoint : entryPointGroup.entryPoints)
+        SlangResult slangResult = spCompile(pSlangRequest);
+        log += spGetDiagnosticOutput(pSlangRequest);
+        if (SLANG_FAILED(slangResult))
         {
-            Slang::ComPtr<slang::IComponentType> pSlangEntryPoint;
-            spCompileRequest_getEntryPoint(pSlangRequest, entryPoint.globalIndex, pSlangEntryPoint.writeRef());
+            spDestroyCompileRequest(pSlangRequest);
+            return nullptr;
+        }
 
-            // Rename entry point in the generated code if the exported name differs from the source name.
-            // This makes it possible to generate different specializations of the same source entry point,
-            // for example by setting different type conformances.
-            if (entryPoint.exportName != entryPoint.name)
-            {
-                Slang::ComPtr<slang::IComponentType> pRenamedEntryPoint;
-                pSlangEntryPoint->renameEntryPoint(entryPoint.exportName.c_str(), pRenamedEntryPoint.writeRef());
-                pSlangEntryPoints.push_back(pRenamedEntryPoint);
-            }
-            else
+        spCompileRequest_getProgram(pSlangRequest, pSlangGlobalScope.writeRef());
+
+        for (const auto& entryPointGroup : program.mDesc.entryPointGroups)
+        {
+            for (const auto& entryPoint : entryPointGroup.entryPoints)
             {
+                Slang::ComPtr<slang::IComponentType> pSlangEntryPoint;
+                spCompileRequest_getEntryPoint(pSlangRequest, entryPoint.globalIndex, pSlangEntryPoint.writeRef());
                 pSlangEntryPoints.push_back(pSlangEntryPoint);
             }
         }
+
+        // Extract list of files referenced, for dependency-tracking purposes.
+        int depFileCount = spGetDependencyFileCount(pSlangRequest);
+        for (int ii = 0; ii < depFileCount; ++ii)
+        {
+            std::string depFilePath = spGetDependencyFilePath(pSlangRequest, ii);
+            if (std::filesystem::exists(depFilePath))
+                program.mFileTimeMap[depFilePath] = getFileModifiedTime(depFilePath);
+        }
+
+        if (cacheKey)
+            storeToProgramCache(program, *cacheKey, pSlangRequest);
     }
 
-    // Extract list of files referenced, for dependency-tracking purposes.
-    int depFileCount = spGetDependencyFileCount(pSlangRequest);
-    for (int ii = 0; ii < depFileCount; ++ii)
+    // Rename entry points in the generated code if the exported name differs from the source name.
+    // This makes it possible to generate different specializations of the same source entry point,
+    // for example by setting different type conformances.
+    for (const auto& entryPointGroup : program.mDesc.entryPointGroups)
     {
-        std::string depFilePath = spGetDependencyFilePath(pSlangRequest, ii);
-        if (std::filesystem::exists(depFilePath))
-            program.mFileTimeMap[depFilePath] = getFileModifiedTime(depFilePath);
+        for (const auto& entryPoint : entryPointGroup.entryPoints)
+        {
+            if (entryPoint.exportName != entryPoint.name)
+            {
+                Slang::ComPtr<slang::IComponentType> pRenamedEntryPoint;
+                pSlangEntryPoints[entryPoint.globalIndex]->renameEntryPoint(entryPoint.exportName.c_str(), pRenamedEntryPoint.writeRef());
+                pSlangEntryPoints[entryPoint.globalIndex] = pRenamedEntryPoint;
+            }
+        }
     }
 
     // Note: the `ProgramReflection` needs to be able to refer back to the
@@ -195,9 +288,6 @@ ref<const ProgramVersion> ProgramManager::createProgramVersion(const Program& pr
     // to just use `pSlangGlobalScope` for the reflection step instead
     // of `pSlangProgram`.
     //
-    Slang::ComPtr<slang::IComponentType> pSlangProgram;
-    spCompileRequest_getProgram(pSlangRequest, pSlangProgram.writeRef());
-
     ref<const ProgramReflection> pReflector;
     if (!doSlangReflection(*pVersion, pSlangGlobalScope, pSlangEntryPoints, pReflector, log))
     {
@@ -209,14 +299,439 @@ ref<const ProgramVersion> ProgramManager::createProgramVersion(const Program& pr
 
     timer.update();
     double time = timer.delta();
-    mCompilationStats.programVersionCount++;
-    mCompilationStats.programVersionTotalTime += time;
-    mCompilationStats.programVersionMaxTime = std::max(mCompilationStats.programVersionMaxTime, time);
-    logDebug("Created program version in {:.3f} s: {}", timer.delta(), descStr);
+    {
+        std::lock_guard<std::mutex> lock(mCompilationStatsMutex);
+        mCompilationStats.programVersionCount++;
+        mCompilationStats.programVersionTotalTime += time;
+        mCompilationStats.programVersionMaxTime = std::max(mCompilationStats.programVersionMaxTime, time);
+    }
+    logDebug("Created program version in {:.3f} s{}: {}", timer.delta(), cacheHit ? " (cached)" : "", descStr);
 
     return pVersion;
 }
 
+/**
+ * Setup of a Slang global session.
+ * This is captured from the device's global session and applied to the global sessions used on worker threads,
+ * so that programs compile the same on all threads.
+ */
+struct ProgramManager::SlangGlobalSessionSetup
+{
+    std::string languagePreludes[SLANG_SOURCE_LANGUAGE_COUNT_OF];
+    std::string downstreamCompilerPreludes[SLANG_PASS_THROUGH_COUNT_OF];
+    SlangPassThrough defaultDownstreamCompilers[SLANG_SOURCE_LANGUAGE_COUNT_OF];
+    SlangPassThrough transitionDownstreamCompilers[SLANG_TARGET_COUNT_OF][SLANG_TARGET_COUNT_OF];
+
+    SlangGlobalSessionSetup(slang::IGlobalSession* pSlangGlobalSession)
+    {
+        auto toString = [](ISlangBlob* pBlob)
+        { return pBlob ? std::string(reinterpret_cast<const char*>(pBlob->getBufferPointer()), pBlob->getBufferSize()) : std::string(); };
+
+        for (int i = 0; i < SLANG_SOURCE_LANGUAGE_COUNT_OF; ++i)
+        {
+            Slang::ComPtr<ISlangBlob> pPrelude;
+            pSlangGlobalSession->getLanguagePrelude(SlangSourceLanguage(i), pPrelude.writeRef());
+            languagePreludes[i] = toString(pPrelude);
+            defaultDownstreamCompilers[i] = pSlangGlobalSession->getDefaultDownstreamCompiler(SlangSourceLanguage(i));
+        }
+        for (int i = 0; i < SLANG_PASS_THROUGH_COUNT_OF; ++i)
+        {
+            Slang::ComPtr<ISlangBlob> pPrelude;
+            pSlangGlobalSession->getDownstreamCompilerPrelude(SlangPassThrough(i), pPrelude.writeRef());
+            downstreamCompilerPreludes[i] = toString(pPrelude);
+        }
+        for (int source = 0; source < SLANG_TARGET_COUNT_OF; ++source)
+            for (int target = 0; target < SLANG_TARGET_COUNT_OF; ++target)
+                transitionDownstreamCompilers[source][target] =
+                    pSlangGlobalSession->getDownstreamCompilerForTransition(SlangCompileTarget(source), SlangCompileTarget(target));
+    }
+
+    void apply(slang::IGlobalSession* pSlangGlobalSession) const
+    {
+        for (int i = 0; i < SLANG_SOURCE_LANGUAGE_COUNT_OF; ++i)
+        {
+            pSlangGlobalSession->setLanguagePrelude(SlangSourceLanguage(i), languagePreludes[i].c_str());
+            pSlangGlobalSession->setDefaultDownstreamCompiler(SlangSourceLanguage(i), defaultDownstreamCompilers[i]);
+        }
+        for (int i = 0; i < SLANG_PASS_THROUGH_COUNT_OF; ++i)
+            pSlangGlobalSession->setDownstreamCompilerPrelude(SlangPassThrough(i), downstreamCompilerPreludes[i].c_str());
+        for (int source = 0; source < SLANG_TARGET_COUNT_OF; ++source)
+            for (int target = 0; target < SLANG_TARGET_COUNT_OF; ++target)
+                pSlangGlobalSession->setDownstreamCompilerForTransition(
+                    SlangCompileTarget(source), SlangCompileTarget(target), transitionDownstreamCompilers[source][target]
+                );
+    }
+};
+
+void ProgramManager::compilePrograms(const std::vector<const Program*>& programs) const
+{
+    // Collect the programs that need linking.
+    std::vector<const Program*> pendingPrograms;
+    for (const Program* pProgram : programs)
+    {
+        if (pProgram && pProgram->isLinkPending() &&
+            std::find(pendingPrograms.begin(), pendingPrograms.end(), pProgram) == pendingPrograms.end())
+            pendingPrograms.push_back(pProgram);
+    }
+
+    // With a single program there is nothing to gain, leave it to be linked lazily.
+    if (!mParallelCompilationEnabled || pendingPrograms.size() < 2)
+        return;
+
+    CpuTimer timer;
+    timer.update();
+
+    struct Result
+    {
+        ref<const ProgramVersion> pVersion;
+        std::string log;
+        std::string error;
+    };
+    std::vector<Result> results(pendingPrograms.size());
+
+    // Worker threads compile with their own global sessions, set up like the device's global session.
+    const SlangGlobalSessionSetup setup(mpDevice->getSlangGlobalSession());
+
+    TaskManager taskManager(true);
+    for (size_t i = 0; i < pendingPrograms.size(); ++i)
+    {
+        taskManager.addTask(
+            [&, i]()
+            {
+                Slang::ComPtr<slang::IGlobalSession> pSlangGlobalSession;
+                try
+                {
+                    pSlangGlobalSession = acquireSlangGlobalSession(setup);
+                    tpSlangGlobalSession = pSlangGlobalSession;
+                    results[i].pVersion = createProgramVersion(*pendingPrograms[i], results[i].log);
+                }
+                catch (const std::exception& e)
+                {
+                    results[i].error = e.what();
+                }
+                catch (...)
+                {
+                    results[i].error = "Unknown error.";
+                }
+                tpSlangGlobalSession = nullptr;
+                if (pSlangGlobalSession)
+                    releaseSlangGlobalSession(std::move(pSlangGlobalSession));
+            }
+        );
+    }
+    taskManager.finish(nullptr);
+
+    size_t linkedCount = 0;
+    for (size_t i = 0; i < pendingPrograms.size(); ++i)
+    {
+        const auto& result = results[i];
+        if (!result.pVersion)
+        {
+            // The program is left unlinked and compiled again on first use, which reports the error the usual way.
+            logWarning("Failed to compile program in parallel:\n{}\n{}", pendingPrograms[i]->getProgramDescString(), result.error);
+            continue;
+        }
+        if (!result.log.empty())
+            logWarning("Warnings in program:\n{}\n{}", pendingPrograms[i]->getProgramDescString(), result.log);
+        pendingPrograms[i]->setActiveVersion(result.pVersion);
+        linkedCount++;
+    }
+
+    timer.update();
+    logInfo("Compiled {} of {} programs in parallel in {:.3f} s.", linkedCount, pendingPrograms.size(), timer.delta());
+}
+
+void ProgramManager::compilePendingPrograms(const void* pOwner) const
+{
+    std::vector<const Program*> programs;
+    for (const Program* pProgram : mLoadedPrograms)
+    {
+        auto it = mProgramOwners.find(pProgram);
+        if (it != mProgramOwners.end() && it->second == pOwner)
+            programs.push_back(pProgram);
+    }
+    compilePrograms(programs);
+}
+
+slang::IGlobalSession* ProgramManager::getSlangGlobalSession() const
+{
+    return tpSlangGlobalSession ? tpSlangGlobalSession : mpDevice->getSlangGlobalSession();
+}
+
+Slang::ComPtr<slang::IGlobalSession> ProgramManager::acquireSlangGlobalSession(const SlangGlobalSessionSetup& setup) const
+{
+    Slang::ComPtr<slang::IGlobalSession> pSlangGlobalSession;
+    {
+        std::lock_guard<std::mutex> lock(mSlangGlobalSessionPoolMutex);
+        if (!mSlangGlobalSessionPool.empty())
+        {
+            pSlangGlobalSession = std::move(mSlangGlobalSessionPool.back());
+            mSlangGlobalSessionPool.pop_back();
+        }
+    }
+
+    // Creating global sessions is thread-safe.
+    if (!pSlangGlobalSession)
+    {
+        if (SLANG_FAILED(slang::createGlobalSession(pSlangGlobalSession.writeRef())))
+            FALCOR_THROW("Failed to create Slang global session.");
+    }
+
+    setup.apply(pSlangGlobalSession);
+    return pSlangGlobalSession;
+}
+
+void ProgramManager::releaseSlangGlobalSession(Slang::ComPtr<slang::IGlobalSession> pSlangGlobalSession) const
+{
+    std::lock_guard<std::mutex> lock(mSlangGlobalSessionPoolMutex);
+    mSlangGlobalSessionPool.push_back(std::move(pSlangGlobalSession));
+}
+
+bool ProgramManager::canUseProgramCache(const Program& program) const
+{
+    if (!isProgramCacheEnabled())
+        return false;
+
+    // Compiler arguments, debug info and intermediates dumping are configured on the compile request.
+    // Modules loaded from the cache are not associated with a compile request, so these programs are
+    // always compiled from source.
+    if (!mGlobalCompilerArguments.empty() || !program.mDesc.compilerArguments.empty())
+        return false;
+    if (mGenerateDebugInfo || is_set(program.mDesc.compilerFlags, SlangCompilerFlags::GenerateDebugInfo))
+        return false;
+    if (is_set(program.mDesc.compilerFlags, SlangCompilerFlags::DumpIntermediates))
+        return false;
+
+    return true;
+}
+
+std::optional<ProgramCache::Key> ProgramManager::computeProgramCacheKey(const Program& program) const
+{
+    SHA1 sha1;
+    auto updateString = [&sha1](std::string_view str)
+    {
+        sha1.update((uint64_t)str.size());
+        sha1.update(str);
+    };
+
+    sha1.update(kProgramCacheKeyVersion);
+    updateString(getSlangGlobalSession()->getBuildTagString());
+    sha1.update((uint32_t)mpDevice->getType());
+    sha1.update((uint32_t)program.mDesc.shaderModel);
+
+    SlangCompilerFlags compilerFlags = program.mDesc.compilerFlags;
+    compilerFlags &= ~mForcedCompilerFlags.disabled;
+    compilerFlags |= mForcedCompilerFlags.enabled;
+    sha1.update((uint32_t)compilerFlags);
+    sha1.update(getEnvironmentVariable("FALCOR_USE_SLANG_SPIRV_BACKEND") == "1" || program.mDesc.useSPIRVBackend);
+
+    for (const auto& path : getShaderDirectoriesList())
+        updateString(path.string());
+
+    sha1.update((uint64_t)mGlobalDefineList.size());
+    for (const auto& [name, value] : mGlobalDefineList)
+    {
+        updateString(name);
+        updateString(value);
+    }
+    sha1.update((uint64_t)program.getDefineList().size());
+    for (const auto& [name, value] : program.getDefineList())
+    {
+        updateString(name);
+        updateString(value);
+    }
+
+    auto updateTypeConformances = [&](const TypeConformanceList& typeConformances)
+    {
+        sha1.update((uint64_t)typeConformances.size());
+        for (const auto& [typeConformance, id] : typeConformances)
+        {
+            updateString(typeConformance.typeName);
+            updateString(typeConformance.interfaceName);
+            sha1.update(id);
+        }
+    };
+    updateTypeConformances(program.getTypeConformances());
+
+    // Hash the top-level sources. Files included or imported by these are recorded
+    // as dependencies in the cache entry and validated when loading.
+    sha1.update((uint64_t)program.mDesc.shaderModules.size());
+    for (const auto& module : program.mDesc.shaderModules)
+    {
+        updateString(module.name);
+        sha1.update((uint64_t)module.sources.size());
+        for (const auto& source : module.sources)
+        {
+            sha1.update((uint32_t)source.type);
+            if (source.type == ProgramDesc::ShaderSource::Type::File)
+            {
+                std::filesystem::path fullPath;
+                if (!findFileInShaderDirectories(source.path, fullPath))
+                    return {};
+                auto hash = mpProgramCache->getFileHash(fullPath);
+                if (!hash)
+                    return {};
+                updateString(fullPath.string());
+                sha1.update(hash->data(), hash->size());
+            }
+            else
+            {
+                updateString(source.path.string());
+                updateString(source.string);
+            }
+        }
+    }
+
+    sha1.update((uint64_t)program.mDesc.entryPointGroups.size());
+    for (const auto& entryPointGroup : program.mDesc.entryPointGroups)
+    {
+        sha1.update(entryPointGroup.shaderModuleIndex);
+        updateTypeConformances(entryPointGroup.typeConformances);
+        sha1.update((uint64_t)entryPointGroup.entryPoints.size());
+        for (const auto& entryPoint : entryPointGroup.entryPoints)
+        {
+            sha1.update((uint32_t)entryPoint.type);
+            updateString(entryPoint.name);
+        }
+    }
+
+    return sha1.finalize();
+}
+
+bool ProgramManager::loadFromProgramCache(
+    const Program& program,
+    const ProgramCache::Key& key,
+    Slang::ComPtr<slang::IComponentType>& pSlangGlobalScope,
+    std::vector<Slang::ComPtr<slang::IComponentType>>& pSlangEntryPoints,
+    std::string& log
+) const
+{
+    auto entry = mpProgramCache->load(key);
+    if (!entry || entry->translationUnits.size() != program.mDesc.shaderModules.size())
+        return false;
+
+    Slang::ComPtr<slang::ISession> pSlangSession = createSlangSession(program, true);
+
+    // Load the serialized modules. Imported modules are stored before the modules importing them.
+    // If a module was already loaded as a dependency of a previous module, the loaded one is used.
+    std::vector<slang::IModule*> modules(entry->modules.size(), nullptr);
+    for (size_t i = 0; i < entry->modules.size(); ++i)
+    {
+        auto& module = entry->modules[i];
+        modules[i] = findLoadedModule(pSlangSession, module.name);
+        if (modules[i])
+            continue;
+
+        Slang::ComPtr<ISlangBlob> pBlob(new VectorBlob(std::move(module.data)));
+        Slang::ComPtr<slang::IBlob> pSlangDiagnostics;
+        modules[i] = pSlangSession->loadModuleFromIRBlob(module.name.c_str(), module.path.c_str(), pBlob, pSlangDiagnostics.writeRef());
+        if (!modules[i])
+        {
+            logDebug(
+                "Failed to load module '{}' from program cache: {}",
+                module.name,
+                pSlangDiagnostics ? (const char*)pSlangDiagnostics->getBufferPointer() : ""
+            );
+            return false;
+        }
+    }
+
+    // Compose the global scope from the translation unit modules, in the same order the compile request would.
+    std::vector<slang::IComponentType*> translationUnitModules;
+    for (auto index : entry->translationUnits)
+        translationUnitModules.push_back(modules[index]);
+
+    Slang::ComPtr<slang::IBlob> pSlangDiagnostics;
+    if (SLANG_FAILED(pSlangSession->createCompositeComponentType(
+            translationUnitModules.data(),
+            (SlangInt)translationUnitModules.size(),
+            pSlangGlobalScope.writeRef(),
+            pSlangDiagnostics.writeRef()
+        )))
+    {
+        return false;
+    }
+
+    for (const auto& entryPointGroup : program.mDesc.entryPointGroups)
+    {
+        slang::IModule* pModule = modules[entry->translationUnits[entryPointGroup.shaderModuleIndex]];
+        for (const auto& entryPoint : entryPointGroup.entryPoints)
+        {
+            Slang::ComPtr<slang::IEntryPoint> pSlangEntryPoint;
+            if (SLANG_FAILED(pModule->findAndCheckEntryPoint(
+                    entryPoint.name.c_str(), getSlangStage(entryPoint.type), pSlangEntryPoint.writeRef(), pSlangDiagnostics.writeRef()
+                )))
+            {
+                return false;
+            }
+            pSlangEntryPoints.push_back(Slang::ComPtr<slang::IComponentType>(pSlangEntryPoint.get()));
+        }
+    }
+
+    program.mFileTimeMap.clear();
+    for (const auto& dependency : entry->dependencies)
+        program.mFileTimeMap[dependency.path] = getFileModifiedTime(dependency.path);
+
+    return true;
+}
+
+void ProgramManager::storeToProgramCache(const Program& program, const ProgramCache::Key& key, SlangCompileRequest* pSlangRequest) const
+{
+    ProgramCache::Entry entry;
+
+    int depFileCount = spGetDependencyFileCount(pSlangRequest);
+    for (int ii = 0; ii < depFileCount; ++ii)
+    {
+        std::string depFilePath = spGetDependencyFilePath(pSlangRequest, ii);
+        // Skip dependencies that are not on disk (source strings).
+        if (!std::filesystem::exists(depFilePath))
+            continue;
+        auto hash = mpProgramCache->getFileHash(depFilePath);
+        if (!hash)
+            return;
+        entry.dependencies.push_back({depFilePath, *hash});
+    }
+
+    std::vector<slang::IModule*> storedModules;
+    auto addModule = [&](slang::IModule* pModule) -> std::optional<uint32_t>
+    {
+        auto it = std::find(storedModules.begin(), storedModules.end(), pModule);
+        if (it != storedModules.end())
+            return uint32_t(it - storedModules.begin());
+
+        Slang::ComPtr<ISlangBlob> pBlob;
+        if (!pModule->getName() || SLANG_FAILED(pModule->serialize(pBlob.writeRef())))
+            return {};
+        entry.modules.push_back({pModule->getName(), pModule->getFilePath() ? pModule->getFilePath() : "", toByteVector(pBlob)});
+        storedModules.push_back(pModule);
+        return uint32_t(storedModules.size() - 1);
+    };
+
+    // Store imported modules first (in load order), followed by the translation units.
+    Slang::ComPtr<slang::IComponentType> pSlangGlobalScope;
+    spCompileRequest_getProgram(pSlangRequest, pSlangGlobalScope.writeRef());
+    slang::ISession* pSlangSession = pSlangGlobalScope->getSession();
+    for (SlangInt i = 0; i < pSlangSession->getLoadedModuleCount(); ++i)
+    {
+        if (!addModule(pSlangSession->getLoadedModule(i)))
+            return;
+    }
+
+    for (size_t i = 0; i < program.mDesc.shaderModules.size(); ++i)
+    {
+        slang::IModule* pModule = nullptr;
+        if (SLANG_FAILED(spCompileRequest_getModule(pSlangRequest, (SlangInt)i, &pModule)) || !pModule)
+            return;
+        auto index = addModule(pModule);
+        if (!index)
+            return;
+        entry.translationUnits.push_back(*index);
+    }
+
+    if (!mpProgramCache->store(key, entry))
+        logWarning("Failed to store program in program cache: {}", program.getProgramDescString());
+}
+
 ref<const ProgramKernels> ProgramManager::createProgramKernels(
     const Program& program,
     const ProgramVersion& programVersion,
@@ -500,9 +1015,12 @@ ref<const ProgramKernels> ProgramManager::createProgramKernels(
 
     timer.update();
     double time = timer.delta();
-    mCompilationStats.programKernelsCount++;
-    mCompilationStats.programKernelsTotalTime += time;
-    mCompilationStats.programKernelsMaxTime = std::max(mCompilationStats.programKernelsMaxTime, time);
+    {
+        std::lock_guard<std::mutex> lock(mCompilationStatsMutex);
+        mCompilationStats.programKernelsCount++;
+        mCompilationStats.programKernelsTotalTime += time;
+        mCompilationStats.programKernelsMaxTime = std::max(mCompilationStats.programKernelsMaxTime, time);
+    }
     logDebug("Created program kernels in {:.3f} s: {}", time, descStr);
 
     return pProgramKernels;
@@ -555,6 +1073,23 @@ std::string ProgramManager::getHlslLanguagePrelude() const
     return std::string(reinterpret_cast<const char*>(prelude->getBufferPointer()), prelude->getBufferSize());
 }
 
+void ProgramManager::setProgramCachePath(const std::filesystem::path& path)
+{
+    mpProgramCache.reset();
+    if (path.empty())
+        return;
+
+    // The cache is optional, so failing to set it up must not prevent the device from being created.
+    try
+    {
+        mpProgramCache = std::make_unique<ProgramCache>(path, mpDevice->getDesc().maxProgramCacheEntryCount);
+    }
+    catch (const std::exception& e)
+    {
+        logWarning("Failed to set up program cache at '{}', running without program cache: {}", path, e.what());
+    }
+}
+
 void ProgramManager::setHlslLanguagePrelude(const std::string& prelude)
 {
     mpDevice->getSlangGlobalSession()->setLanguagePrelude(SLANG_SOURCE_LANGUAGE_HLSL, prelude.c_str());
@@ -563,11 +1098,14 @@ void ProgramManager::setHlslLanguagePrelude(const std::string& prelude)
 void ProgramManager::registerProgramForReload(Program* program)
 {
     mLoadedPrograms.push_back(program);
+    if (mpProgramOwner)
+        mProgramOwners[program] = mpProgramOwner;
 }
 
 void ProgramManager::unregisterProgramForReload(Program* program)
 {
     mLoadedPrograms.erase(std::remove(mLoadedPrograms.begin(), mLoadedPrograms.end(), program), mLoadedPrograms.end());
+    mProgramOwners.erase(program);
 }
 
 bool ProgramManager::reloadAllPrograms(bool forceReload)
@@ -619,9 +1157,9 @@ ProgramManager::ForcedCompilerFlags ProgramManager::getForcedCompilerFlags()
     return mForcedCompilerFlags;
 }
 
-SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& program) const
+Slang::ComPtr<slang::ISession> ProgramManager::createSlangSession(const Program& program, bool addDownstreamArguments) const
 {
-    slang::IGlobalSession* pSlangGlobalSession = mpDevice->getSlangGlobalSession();
+    slang::IGlobalSession* pSlangGlobalSession = getSlangGlobalSession();
     FALCOR_ASSERT(pSlangGlobalSession);
 
     slang::SessionDesc sessionDesc;
@@ -757,6 +1295,19 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
     addStringOption(slang::CompilerOptionName::DisableWarning, "30081"); // implicit conversion
     addStringOption(slang::CompilerOptionName::DisableWarning, "41203"); // reinterpret<> into not equally sized types
 
+#if FALCOR_NVAPI_AVAILABLE
+    // Sessions that don't go through a compile request don't get the command line arguments
+    // set in `createSlangCompileRequest()`, so we need to inform dxc where to find NVAPI here.
+    std::string nvapiInclude = "-I" + (getRuntimeDirectory() / "shaders/nvapi").string();
+    if (addDownstreamArguments)
+    {
+        compilerOptionEntries.push_back(
+            {slang::CompilerOptionName::DownstreamArgs,
+             {slang::CompilerOptionValueKind::String, 0, 0, "dxc", nvapiInclude.c_str()}}
+        );
+    }
+#endif
+
     sessionDesc.compilerOptionEntries = compilerOptionEntries.data();
     sessionDesc.compilerOptionEntryCount = (uint32_t)compilerOptionEntries.size();
 
@@ -764,6 +1315,13 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
     pSlangGlobalSession->createSession(sessionDesc, pSlangSession.writeRef());
     FALCOR_ASSERT(pSlangSession);
 
+    return pSlangSession;
+}
+
+SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& program) const
+{
+    Slang::ComPtr<slang::ISession> pSlangSession = createSlangSession(program, false);
+
     program.mFileTimeMap.clear(); // TODO @skallweit
 
     SlangCompileRequest* pSlangRequest = nullptr;
@@ -27,10 +27,16 @@
  **************************************************************************/
 #pragma once
 #include "Program.h"
+#include "ProgramCache.h"
 #include "Core/Macros.h"
 #include "Core/API/fwd.h"
 
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace Falcor
 {
@@ -39,6 +45,7 @@ class FALCOR_API ProgramManager
 {
 public:
     ProgramManager(Device* pDevice);
+    ~ProgramManager();
 
     /**
      * Defines flags that should be forcefully disabled or enabled on all shaders.
@@ -58,6 +65,8 @@ public:
         double programKernelsMaxTime = 0.0;
         double programVersionTotalTime = 0.0;
         double programKernelsTotalTime = 0.0;
+        size_t programCacheHitCount = 0;  ///< Number of program versions loaded from the program cache.
+        size_t programCacheMissCount = 0; ///< Number of program versions not found in the program cache.
     };
 
     ProgramDesc applyForcedCompilerFlags(ProgramDesc desc) const;
@@ -73,6 +82,43 @@ public:
         std::string& log
     ) const;
 
+    /**
+     * Compile the active versions of the given programs in parallel.
+     * Programs that are already linked are skipped. Programs that fail to compile are logged and left unlinked,
+     * so errors are reported as usual when the program is used.
+     * Must be called from the main thread.
+     * @param[in] programs List of programs.
+     */
+    void compilePrograms(const std::vector<const Program*>& programs) const;
+
+    /**
+     * Compile the active versions of the programs of an owner that are pending linking in parallel.
+     * This is used to compile the programs created by the passes of a render graph ahead of the first frame.
+     * Must be called from the main thread.
+     * @param[in] pOwner Owner of the programs, see `ProgramOwnerScope`.
+     */
+    void compilePendingPrograms(const void* pOwner) const;
+
+    /**
+     * Scope assigning the programs created while it is active to an owner, e.g. a render graph.
+     * Must only be used on the main thread.
+     */
+    class ProgramOwnerScope
+    {
+    public:
+        ProgramOwnerScope(ProgramManager* pProgramManager, const void* pOwner)
+            : mpProgramManager(pProgramManager), mpPrevOwner(std::exchange(pProgramManager->mpProgramOwner, pOwner))
+        {}
+        ~ProgramOwnerScope() { mpProgramManager->mpProgramOwner = mpPrevOwner; }
+
+        ProgramOwnerScope(const ProgramOwnerScope&) = delete;
+        ProgramOwnerScope& operator=(const ProgramOwnerScope&) = delete;
+
+    private:
+        ProgramManager* mpProgramManager;
+        const void* mpPrevOwner;
+    };
+
     ref<const EntryPointGroupKernels> createEntryPointGroupKernels(
         const std::vector<ref<EntryPointKernel>>& kernels,
         const ref<EntryPointBaseReflection>& pReflector
@@ -141,22 +187,92 @@ public:
      */
     ForcedCompilerFlags getForcedCompilerFlags();
 
+    /**
+     * Enable/disable the persistent program cache.
+     * The cache stores the results of the Slang front-end compilation on disk and is only available
+     * if a cache path is set in the device descriptor or with `setProgramCachePath()`.
+     * @param[in] enabled Enable/disable.
+     */
+    void setProgramCacheEnabled(bool enabled) { mProgramCacheEnabled = enabled; }
+
+    /**
+     * Check if the persistent program cache is enabled.
+     * @return Returns true if enabled.
+     */
+    bool isProgramCacheEnabled() const { return mpProgramCache && mProgramCacheEnabled; }
+
+    /**
+     * Get the persistent program cache.
+     * @return Returns the program cache, or nullptr if not available.
+     */
+    ProgramCache* getProgramCache() const { return mpProgramCache.get(); }
+
+    /**
+     * Set the directory of the persistent program cache, replacing the cache set in the device descriptor.
+     * Must not be called while programs are being compiled.
+     * If the cache directory can't be created or accessed, a warning is logged and the cache is disabled.
+     * @param[in] path Cache directory. An empty path disables the cache.
+     */
+    void setProgramCachePath(const std::filesystem::path& path);
+
+    /**
+     * Enable/disable parallel compilation in `compilePrograms()` and `compilePendingPrograms()`.
+     * @param[in] enabled Enable/disable.
+     */
+    void setParallelCompilationEnabled(bool enabled) { mParallelCompilationEnabled = enabled; }
+
+    /**
+     * Check if parallel compilation is enabled.
+     * @return Returns true if enabled.
+     */
+    bool isParallelCompilationEnabled() const { return mParallelCompilationEnabled; }
+
     const CompilationStats& getCompilationStats() { return mCompilationStats; }
     void resetCompilationStats() { mCompilationStats = {}; }
 
 private:
+    struct SlangGlobalSessionSetup;
+
+    slang::IGlobalSession* getSlangGlobalSession() const;
+    Slang::ComPtr<slang::IGlobalSession> acquireSlangGlobalSession(const SlangGlobalSessionSetup& setup) const;
+    void releaseSlangGlobalSession(Slang::ComPtr<slang::IGlobalSession> pSlangGlobalSession) const;
+
+    Slang::ComPtr<slang::ISession> createSlangSession(const Program& program, bool addDownstreamArguments) const;
     SlangCompileRequest* createSlangCompileRequest(const Program& program) const;
 
+    bool canUseProgramCache(const Program& program) const;
+    std::optional<ProgramCache::Key> computeProgramCacheKey(const Program& program) const;
+    bool loadFromProgramCache(
+        const Program& program,
+        const ProgramCache::Key& key,
+        Slang::ComPtr<slang::IComponentType>& pSlangGlobalScope,
+        std::vector<Slang::ComPtr<slang::IComponentType>>& pSlangEntryPoints,
+        std::string& log
+    ) const;
+    void storeToProgramCache(const Program& program, const ProgramCache::Key& key, SlangCompileRequest* pSlangRequest) const;
+
     Device* mpDevice;
 
     std::vector<Program*> mLoadedPrograms;
+    /// Owners of the loaded programs created within a `ProgramOwnerScope`.
+    std::unordered_map<const Program*, const void*> mProgramOwners;
+    const void* mpProgramOwner = nullptr;
     mutable CompilationStats mCompilationStats;
+    mutable std::mutex mCompilationStatsMutex;
+
+    bool mParallelCompilationEnabled = true;
+    /// Slang global sessions for compiling on worker threads. Slang global sessions are not thread-safe.
+    mutable std::vector<Slang::ComPtr<slang::IGlobalSession>> mSlangGlobalSessionPool;
+    mutable std::mutex mSlangGlobalSessionPoolMutex;
 
     DefineList mGlobalDefineList;
     std::vector<std::string> mGlobalCompilerArguments;
     bool mGenerateDebugInfo = false;
     ForcedCompilerFlags mForcedCompilerFlags;
 
+    std::unique_ptr<ProgramCache> mpProgramCache;
+    bool mProgramCacheEnabled = true;
+
     mutable uint32_t mHitGroupID = 0;
 };
 
@@ -32,6 +32,9 @@
 #include "GlobalState.h"
 #include "Core/ObjectPython.h"
 #include "Core/API/Device.h"
+#include "Core/Program/ProgramManager.h"
+#include "Utils/Logger.h"
+#include "Utils/StringUtils.h"
 #include "Utils/Algorithm/DirectedGraphTraversal.h"
 #include "Utils/Scripting/Scripting.h"
 #include "Utils/Scripting/ScriptBindings.h"
@@ -116,6 +119,7 @@ void RenderGraph::setScene(const ref<Scene>& pScene)
     // @skallweit: check that scene resides on the same GPU device
 
     mpScene = pScene;
+    ProgramManager::ProgramOwnerScope programOwnerScope(mpDevice->getProgramManager(), this);
     for (auto& it : mNodeData)
     {
         it.second.pPass->setScene(mpDevice->getRenderContext(), pScene);
@@ -125,6 +129,8 @@ void RenderGraph::setScene(const ref<Scene>& pScene)
 
 ref<RenderPass> RenderGraph::createPass(const std::string& passName, const std::string& passType, const Properties& props)
 {
+    // Programs created by the passes belong to the graph, so that they are compiled ahead of time when compiling the graph.
+    ProgramManager::ProgramOwnerScope programOwnerScope(mpDevice->getProgramManager(), this);
     ref<RenderPass> pPass = RenderPass::create(passType, mpDevice, props);
     if (pPass)
         addPass(pPass, passName);
@@ -143,7 +149,10 @@ uint32_t RenderGraph::addPass(const ref<RenderPass>& pPass, const std::string& p
     pPass->mName = passName;
 
     if (mpScene)
+    {
+        ProgramManager::ProgramOwnerScope programOwnerScope(mpDevice->getProgramManager(), this);
         pPass->setScene(mpDevice->getRenderContext(), mpScene);
+    }
     mNodeData[passIndex] = {passName, pPass};
     mRecompile = true;
     return passIndex;
@@ -185,6 +194,7 @@ void RenderGraph::updatePass(const std::string& passName, const Properties& prop
     // Recreate pass without changing graph using new dictionary
     auto pOldPass = pPassIt->second.pPass;
     std::string passTypeName = pOldPass->getType();
+    ProgramManager::ProgramOwnerScope programOwnerScope(mpDevice->getProgramManager(), this);
     auto pPass = RenderPass::create(passTypeName, mpDevice, props);
     pPassIt->second.pPass = pPass;
     pPass->mPassChangedCB = [this]() { mRecompile = true; };
@@ -429,8 +439,20 @@ bool RenderGraph::compile(RenderContext* pRenderContext, std::string& log)
 
     try
     {
+        ProgramManager::ProgramOwnerScope programOwnerScope(mpDevice->getProgramManager(), this);
         mpExe = RenderGraphCompiler::compile(*this, pRenderContext, mCompilerDeps);
         mRecompile = false;
+
+        const auto& stats = mpExe->getResourceMemoryStats();
+        logInfo(
+            "Render graph '{}' allocated {} resources for {} fields: {} (peak {}, saved {} by resource aliasing).",
+            mName,
+            stats.resourceCount,
+            stats.fieldCount,
+            formatByteSize(stats.allocatedMemory),
+            formatByteSize(stats.peakMemory),
+            formatByteSize(stats.getSavedMemory())
+        );
         return true;
     }
     catch (const std::exception& e)
@@ -440,6 +462,19 @@ bool RenderGraph::compile(RenderContext* pRenderContext, std::string& log)
     }
 }
 
+void RenderGraph::setResourceAliasingEnabled(bool enabled)
+{
+    if (mCompilerDeps.enableResourceAliasing == enabled)
+        return;
+    mCompilerDeps.enableResourceAliasing = enabled;
+    mRecompile = true;
+}
+
+ResourceCache::MemoryStats RenderGraph::getResourceMemoryStats() const
+{
+    return mpExe ? mpExe->getResourceMemoryStats() : ResourceCache::MemoryStats{};
+}
+
 void RenderGraph::execute(RenderContext* pRenderContext)
 {
     std::string log;
@@ -734,6 +769,7 @@ FALCOR_SCRIPT_BINDING(RenderGraph)
     // RenderGraph
     pybind11::class_<RenderGraph, ref<RenderGraph>> renderGraph(m, "RenderGraph");
     renderGraph.def_property("name", &RenderGraph::getName, &RenderGraph::setName);
+    renderGraph.def_property("resource_aliasing", &RenderGraph::isResourceAliasingEnabled, &RenderGraph::setResourceAliasingEnabled);
 
     renderGraph.def(
         "create_pass",
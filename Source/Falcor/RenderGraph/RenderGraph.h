@@ -311,6 +311,25 @@ public:
         return compile(pRenderContext, s);
     }
 
+    /**
+     * Enable/disable sharing of resources between transient fields with non-overlapping lifetimes.
+     * This is disabled by default. Only enable it if all passes in the graph mark fields whose contents
+     * are used across frames as persistent.
+     * Changing this triggers a recompilation of the graph.
+     */
+    void setResourceAliasingEnabled(bool enabled);
+
+    /**
+     * Check if resource aliasing is enabled.
+     */
+    bool isResourceAliasingEnabled() const { return mCompilerDeps.enableResourceAliasing; }
+
+    /**
+     * Get the memory statistics of the resources allocated by the last compilation.
+     * Returns empty statistics if the graph has not been compiled.
+     */
+    ResourceCache::MemoryStats getResourceMemoryStats() const;
+
 private:
     struct EdgeData
     {
@@ -29,6 +29,8 @@
 #include "RenderGraph.h"
 #include "RenderPasses/ResolvePass.h"
 #include "Core/Error.h"
+#include "Core/API/Device.h"
+#include "Core/Program/ProgramManager.h"
 #include "Utils/Algorithm/DirectedGraphTraversal.h"
 #include "Utils/StringUtils.h"
 
@@ -58,6 +60,7 @@ std::unique_ptr<RenderGraphExe> RenderGraphCompiler::compile(
     auto pResourcesCache = std::make_unique<ResourceCache>();
     for (const auto& [name, pRes] : dependencies.externalResources)
         pResourcesCache->registerExternalResource(name, pRes);
+    pResourcesCache->setAliasingEnabled(dependencies.enableResourceAliasing);
 
     c.resolveExecutionOrder();
     c.compilePasses(pRenderContext);
@@ -66,6 +69,9 @@ std::unique_ptr<RenderGraphExe> RenderGraphCompiler::compile(
     c.validateGraph();
     c.allocateResources(pRenderContext->getDevice(), pResourcesCache.get());
 
+    // Compile the programs created by the passes in parallel, instead of serially on first use.
+    pRenderContext->getDevice()->getProgramManager()->compilePendingPrograms(&graph);
+
     auto pExe = std::make_unique<RenderGraphExe>();
     pExe->mExecutionList.reserve(c.mExecutionList.size());
 
@@ -263,13 +269,6 @@ bool RenderGraphCompiler::insertAutoPasses()
 
 void RenderGraphCompiler::allocateResources(ref<Device> pDevice, ResourceCache* pResourceCache)
 {
-    // Build list to look up execution order index from the pass
-    std::unordered_map<RenderPass*, uint32_t> passToIndex;
-    for (size_t i = 0; i < mExecutionList.size(); i++)
-    {
-        passToIndex.emplace(mExecutionList[i].pPass.get(), uint32_t(i));
-    }
-
     for (size_t i = 0; i < mExecutionList.size(); i++)
     {
         uint32_t nodeIndex = mExecutionList[i].index;
@@ -336,9 +335,8 @@ void RenderGraphCompiler::allocateResources(ref<Device> pDevice, ResourceCache*
             std::string srcFieldName = mGraph.mNodeData[pEdge->getSourceNode()].name + '.' + edgeData.srcField;
             std::string dstFieldName = mGraph.mNodeData[nodeIndex].name + '.' + dstField.getName();
 
-            const auto& pSrcPass = mGraph.mNodeData[pEdge->getSourceNode()].pPass.get();
-            const auto& srcReflection = mExecutionList[passToIndex.at(pSrcPass)].reflector;
-            pResourceCache->registerField(dstFieldName, dstField, passToIndex[pSrcPass], srcFieldName);
+            // The resource is used until the current pass, which extends its lifetime.
+            pResourceCache->registerField(dstFieldName, dstField, uint32_t(i), srcFieldName);
         }
     }
 
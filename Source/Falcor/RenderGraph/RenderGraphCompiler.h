@@ -46,6 +46,7 @@ public:
     {
         ResourceCache::DefaultProperties defaultResourceProps;
         ResourceCache::ResourcesMap externalResources;
+        bool enableResourceAliasing = false;
     };
     static std::unique_ptr<RenderGraphExe> compile(RenderGraph& graph, RenderContext* pRenderContext, const Dependencies& dependencies);
 
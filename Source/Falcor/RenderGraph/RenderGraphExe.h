@@ -99,6 +99,11 @@ public:
      */
     void setInput(const std::string& name, const ref<Resource>& pResource);
 
+    /**
+     * Get the memory statistics of the resources allocated by the cache
+     */
+    const ResourceCache::MemoryStats& getResourceMemoryStats() const { return mpResourceCache->getMemoryStats(); }
+
 private:
     friend class RenderGraphCompiler;
 
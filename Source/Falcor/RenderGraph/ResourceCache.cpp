@@ -30,6 +30,7 @@
 #include "Core/API/Texture.h"
 #include "Core/API/Buffer.h"
 #include "Utils/Logger.h"
+#include <algorithm>
 
 namespace Falcor
 {
@@ -37,6 +38,7 @@ void ResourceCache::reset()
 {
     mNameToIndex.clear();
     mResourceData.clear();
+    mMemoryStats = {};
 }
 
 const ref<Resource>& ResourceCache::getResource(const std::string& name) const
@@ -119,27 +121,53 @@ void ResourceCache::registerField(
     }
 }
 
-inline ref<Resource> createResourceForPass(
+namespace
+{
+/**
+ * Fully resolved properties of a resource created for a field.
+ * Fields with equal descriptions can share a resource if their lifetimes don't overlap.
+ */
+struct ResourceDesc
+{
+    RenderPassReflection::Field::Type type;
+    uint32_t width;
+    uint32_t height;
+    uint32_t depth;
+    uint32_t sampleCount;
+    uint32_t arraySize;
+    uint32_t mipLevels;
+    ResourceFormat format;
+    ResourceBindFlags bindFlags;
+
+    bool operator==(const ResourceDesc& other) const
+    {
+        return type == other.type && width == other.width && height == other.height && depth == other.depth &&
+               sampleCount == other.sampleCount && arraySize == other.arraySize && mipLevels == other.mipLevels && format == other.format &&
+               bindFlags == other.bindFlags;
+    }
+};
+
+ResourceDesc resolveResourceDesc(
     ref<Device> pDevice,
     const ResourceCache::DefaultProperties& params,
     const RenderPassReflection::Field& field,
-    bool resolveBindFlags,
-    const std::string& resourceName
+    bool resolveBindFlags
 )
 {
-    uint32_t width = field.getWidth() ? field.getWidth() : params.dims.x;
-    uint32_t height = field.getHeight() ? field.getHeight() : params.dims.y;
-    uint32_t depth = field.getDepth() ? field.getDepth() : 1;
-    uint32_t sampleCount = field.getSampleCount() ? field.getSampleCount() : 1;
-    auto bindFlags = field.getBindFlags();
-    auto arraySize = field.getArraySize();
-    auto mipLevels = field.getMipCount();
-
-    ResourceFormat format = ResourceFormat::Unknown;
+    ResourceDesc desc;
+    desc.type = field.getType();
+    desc.width = field.getWidth() ? field.getWidth() : params.dims.x;
+    desc.height = field.getHeight() ? field.getHeight() : params.dims.y;
+    desc.depth = field.getDepth() ? field.getDepth() : 1;
+    desc.sampleCount = field.getSampleCount() ? field.getSampleCount() : 1;
+    desc.arraySize = field.getArraySize();
+    desc.mipLevels = field.getMipCount();
+    desc.format = ResourceFormat::Unknown;
+    desc.bindFlags = field.getBindFlags();
 
     if (field.getType() != RenderPassReflection::Field::Type::RawBuffer)
     {
-        format = field.getFormat() == ResourceFormat::Unknown ? params.format : field.getFormat();
+        desc.format = field.getFormat() == ResourceFormat::Unknown ? params.format : field.getFormat();
         if (resolveBindFlags)
         {
             ResourceBindFlags mask = ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource;
@@ -147,41 +175,47 @@ inline ref<Resource> createResourceForPass(
             bool isInternal = is_set(field.getVisibility(), RenderPassReflection::Field::Visibility::Internal);
             if (isOutput || isInternal)
                 mask |= ResourceBindFlags::DepthStencil | ResourceBindFlags::RenderTarget;
-            auto supported = pDevice->getFormatBindFlags(format);
+            auto supported = pDevice->getFormatBindFlags(desc.format);
             mask &= supported;
-            bindFlags |= mask;
+            desc.bindFlags |= mask;
         }
     }
     else // RawBuffer
     {
         if (resolveBindFlags)
-            bindFlags = ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource;
+            desc.bindFlags = ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource;
     }
+    return desc;
+}
+
+ref<Resource> createResourceForPass(ref<Device> pDevice, const ResourceDesc& desc, const std::string& resourceName)
+{
     ref<Resource> pResource;
 
-    switch (field.getType())
+    switch (desc.type)
     {
     case RenderPassReflection::Field::Type::RawBuffer:
-        pResource = pDevice->createBuffer(width, bindFlags, MemoryType::DeviceLocal);
+        pResource = pDevice->createBuffer(desc.width, desc.bindFlags, MemoryType::DeviceLocal);
         break;
     case RenderPassReflection::Field::Type::Texture1D:
-        pResource = pDevice->createTexture1D(width, format, arraySize, mipLevels, nullptr, bindFlags);
+        pResource = pDevice->createTexture1D(desc.width, desc.format, desc.arraySize, desc.mipLevels, nullptr, desc.bindFlags);
         break;
     case RenderPassReflection::Field::Type::Texture2D:
-        if (sampleCount > 1)
+        if (desc.sampleCount > 1)
         {
-            pResource = pDevice->createTexture2DMS(width, height, format, sampleCount, arraySize, bindFlags);
+            pResource = pDevice->createTexture2DMS(desc.width, desc.height, desc.format, desc.sampleCount, desc.arraySize, desc.bindFlags);
         }
         else
         {
-            pResource = pDevice->createTexture2D(width, height, format, arraySize, mipLevels, nullptr, bindFlags);
+            pResource =
+                pDevice->createTexture2D(desc.width, desc.height, desc.format, desc.arraySize, desc.mipLevels, nullptr, desc.bindFlags);
         }
         break;
     case RenderPassReflection::Field::Type::Texture3D:
-        pResource = pDevice->createTexture3D(width, height, depth, format, mipLevels, nullptr, bindFlags);
+        pResource = pDevice->createTexture3D(desc.width, desc.height, desc.depth, desc.format, desc.mipLevels, nullptr, desc.bindFlags);
         break;
     case RenderPassReflection::Field::Type::TextureCube:
-        pResource = pDevice->createTextureCube(width, height, format, arraySize, mipLevels, nullptr, bindFlags);
+        pResource = pDevice->createTextureCube(desc.width, desc.height, desc.format, desc.arraySize, desc.mipLevels, nullptr, desc.bindFlags);
         break;
     default:
         FALCOR_UNREACHABLE();
@@ -191,14 +225,116 @@ inline ref<Resource> createResourceForPass(
     return pResource;
 }
 
+uint64_t getResourceMemorySize(const ref<Resource>& pResource)
+{
+    if (pResource->getType() == Resource::Type::Buffer)
+        return pResource->asBuffer()->getSize();
+    return pResource->asTexture()->getTextureSizeInBytes();
+}
+} // namespace
+
+bool ResourceCache::isTransient(const ResourceData& data) const
+{
+    // Graph outputs are registered with a lifetime extending to the end of the graph execution.
+    // Internal and persistent fields are expected to keep their content between executions.
+    return data.lifetime.second != uint32_t(-1) &&
+           !is_set(data.field.getFlags(), RenderPassReflection::Field::Flags::Persistent) &&
+           !is_set(data.field.getVisibility(), RenderPassReflection::Field::Visibility::Internal);
+}
+
 void ResourceCache::allocateResources(ref<Device> pDevice, const DefaultProperties& params)
 {
-    for (auto& data : mResourceData)
+    // Place the fields in order of their first use. A transient field reuses the first resource with a matching
+    // description that is no longer used by any other field at that point (first-fit interval packing).
+    std::vector<uint32_t> order;
+    for (uint32_t i = 0; i < (uint32_t)mResourceData.size(); i++)
+    {
+        if ((mResourceData[i].pResource == nullptr) && (mResourceData[i].field.isValid()))
+            order.push_back(i);
+    }
+    std::stable_sort(
+        order.begin(),
+        order.end(),
+        [this](uint32_t lhs, uint32_t rhs) { return mResourceData[lhs].lifetime.first < mResourceData[rhs].lifetime.first; }
+    );
+
+    struct Allocation
+    {
+        ResourceDesc desc;
+        bool shared;               // Whether the resource can be shared with other transient fields
+        uint32_t lastUse;          // Last time point at which the resource is used
+        std::vector<uint32_t> fields;
+    };
+    std::vector<Allocation> allocations;
+
+    for (uint32_t i : order)
     {
-        if ((data.pResource == nullptr) && (data.field.isValid()))
+        const auto& data = mResourceData[i];
+        ResourceDesc desc = resolveResourceDesc(pDevice, params, data.field, data.resolveBindFlags);
+        bool shared = mAliasingEnabled && isTransient(data);
+
+        auto it = allocations.end();
+        if (shared)
         {
-            data.pResource = createResourceForPass(pDevice, params, data.field, data.resolveBindFlags, data.name);
+            it = std::find_if(
+                allocations.begin(),
+                allocations.end(),
+                [&](const Allocation& a) { return a.shared && a.lastUse < data.lifetime.first && a.desc == desc; }
+            );
         }
+        if (it == allocations.end())
+        {
+            allocations.push_back({desc, shared, 0, {}});
+            it = std::prev(allocations.end());
+        }
+
+        it->lastUse = std::max(it->lastUse, data.lifetime.second);
+        it->fields.push_back(i);
+    }
+
+    for (const auto& allocation : allocations)
+    {
+        std::string name = mResourceData[allocation.fields[0]].name;
+        for (size_t f = 1; f < allocation.fields.size(); f++)
+            name += ", " + mResourceData[allocation.fields[f]].name;
+
+        ref<Resource> pResource = createResourceForPass(pDevice, allocation.desc, name);
+        for (uint32_t i : allocation.fields)
+            mResourceData[i].pResource = pResource;
+    }
+
+    // Compute memory statistics over all allocated fields.
+    // The peak memory is found by sweeping over the lifetime intervals of the fields.
+    mMemoryStats = {};
+    std::unordered_map<const Resource*, uint64_t> resourceSizes;
+    std::vector<std::pair<uint64_t, int64_t>> events;
+    for (const auto& data : mResourceData)
+    {
+        if (data.pResource == nullptr)
+            continue;
+        auto [it, inserted] = resourceSizes.try_emplace(data.pResource.get(), 0);
+        if (inserted)
+            it->second = getResourceMemorySize(data.pResource);
+        uint64_t size = it->second;
+
+        mMemoryStats.fieldCount++;
+        mMemoryStats.unaliasedMemory += size;
+        // Non-transient fields hold their content between executions and are always alive.
+        bool transient = isTransient(data);
+        events.push_back({transient ? uint64_t(data.lifetime.first) : 0, int64_t(size)});
+        events.push_back({transient ? uint64_t(data.lifetime.second) + 1 : uint64_t(-1), -int64_t(size)});
+    }
+    mMemoryStats.resourceCount = (uint32_t)resourceSizes.size();
+    for (const auto& [pResource, size] : resourceSizes)
+        mMemoryStats.allocatedMemory += size;
+
+    // Sort by time point, processing releases before allocations at the same time point.
+    std::sort(events.begin(), events.end());
+    int64_t currentMemory = 0;
+    for (const auto& [time, size] : events)
+    {
+        currentMemory += size;
+        mMemoryStats.peakMemory = std::max(mMemoryStats.peakMemory, uint64_t(currentMemory));
     }
 }
 } // namespace Falcor
@@ -51,6 +51,34 @@ public:
         ResourceFormat format = ResourceFormat::Unknown; ///< Format to use for texture creation
     };
 
+    /**
+     * Memory statistics of the resources allocated by the cache.
+     */
+    struct MemoryStats
+    {
+        uint32_t fieldCount = 0;      ///< Number of allocated fields (excluding aliases of the same field).
+        uint32_t resourceCount = 0;   ///< Number of resources allocated for these fields.
+        uint64_t unaliasedMemory = 0; ///< Memory in bytes needed with a dedicated resource per field.
+        uint64_t allocatedMemory = 0; ///< Memory in bytes of the allocated resources.
+        uint64_t peakMemory = 0;      ///< Peak memory in bytes of the fields alive at the same time point.
+
+        uint64_t getSavedMemory() const { return unaliasedMemory - allocatedMemory; }
+    };
+
+    /**
+     * Enable/disable sharing of resources between transient fields with non-overlapping lifetimes.
+     * Fields that are persistent, internal to a pass or graph outputs are never shared.
+     * Aliasing is disabled by default. It is only safe if all passes that keep a field's contents across frames
+     * (e.g. history buffers or outputs read back in the next frame) mark it as persistent.
+     * Takes effect on the next call to allocateResources().
+     */
+    void setAliasingEnabled(bool enabled) { mAliasingEnabled = enabled; }
+
+    /**
+     * Check if resource aliasing is enabled.
+     */
+    bool isAliasingEnabled() const { return mAliasingEnabled; }
+
     /**
      * Add/Remove reference to a graph input resource not owned by the cache
      * @param[in] name The resource's name
@@ -89,6 +117,11 @@ public:
      */
     void allocateResources(ref<Device> pDevice, const DefaultProperties& params);
 
+    /**
+     * Get the memory statistics of the last allocateResources() call.
+     */
+    const MemoryStats& getMemoryStats() const { return mMemoryStats; }
+
     /**
      * Clears all registered field/resource properties and allocated resources.
      */
@@ -104,12 +137,17 @@ private:
         std::string name;                       // Full name of the resource, including the pass name
     };
 
+    bool isTransient(const ResourceData& data) const;
+
     // Resources and properties for fields within (and therefore owned by) a render graph
     std::unordered_map<std::string, uint32_t> mNameToIndex;
     std::vector<ResourceData> mResourceData;
 
     // References to output resources not to be allocated by the render graph
     ResourcesMap mExternalResources;
+
+    bool mAliasingEnabled = false;
+    MemoryStats mMemoryStats;
 };
 
 } // namespace Falcor
@@ -26,8 +26,12 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "EmissivePowerSampler.h"
+#include "Scene/InstanceDescUpdate.h"
+#include "Utils/NumericRange.h"
+#include "Utils/Sampling/AliasTableBuilder.h"
 #include "Utils/Timing/Profiler.h"
 #include <algorithm>
+#include <execution>
 
 namespace Falcor
 {
@@ -59,12 +63,20 @@ namespace Falcor
 
             const size_t numTris = triangles.size();
             std::vector<float> weights(numTris);
-            for (size_t i = 0; i < numTris; i++) weights[i] = triangles[i].flux;
+            auto range = NumericRange<size_t>(0, numTris);
+            std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t i) { weights[i] = triangles[i].flux; });
 
-            mTriangleTable = generateAliasTable(std::move(weights));
+            // The light collection also signals changes that don't affect the flux (e.g. transforms).
+            // Only rebuild the table if any triangle weight actually changed.
+            if (!mTriangleTable.fullTable || weights.size() != mWeights.size() ||
+                !std::equal(std::execution::par, weights.begin(), weights.end(), mWeights.begin()))
+            {
+                mWeights = std::move(weights);
+                updateAliasTable(mWeights);
+                samplerChanged = true;
+            }
 
             mNeedsRebuild = false;
-            samplerChanged = true;
         }
 
         return samplerChanged;
@@ -83,95 +95,46 @@ namespace Falcor
     {
     }
 
-    EmissivePowerSampler::AliasTable EmissivePowerSampler::generateAliasTable(std::vector<float> weights)
+    void EmissivePowerSampler::updateAliasTable(const std::vector<float>& weights)
     {
-        uint32_t N = uint32_t(weights.size());
-        std::uniform_int_distribution<uint32_t> rngDist;
+        const uint32_t N = uint32_t(weights.size());
 
-        double sum = 0.0f;
-        for (float f : weights)
-        {
-            sum += f;
-        }
-        for (float& f : weights)
-        {
-            f *= N / float(sum);
-        }
+        std::vector<AliasTableEntry> entries;
+        double sum = buildAliasTable(weights, entries);
 
-        std::vector<uint32_t> permutation(N);
-        for (uint32_t i = 0; i < N; ++i)
-        {
-            permutation[i] = i;
-        }
-        std::sort(permutation.begin(), permutation.end(), [&](uint32_t a, uint32_t b) { return weights[a] < weights[b]; });
-
-        std::vector<float> thresholds(N);
-        std::vector<uint32_t> redirect(N);
-        std::vector<uint2> merged(N);
+        // Pack 16-bit threshold (i.e., a half float) plus 2x 24-bit table entries.
+        // Each entry is located at the index of the item it picks below the threshold.
         std::vector<uint2> fullTable(N);
-
-        uint32_t head = 0;
-        uint32_t tail = N - 1;
-
-        while (head != tail)
+        auto range = NumericRange<uint32_t>(0, N);
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t i)
         {
-            int i = permutation[head];
-            int j = permutation[tail];
-
-            thresholds[i] = weights[i];
-            redirect[i] = j;
-            weights[j] -= 1.0f - weights[i];
-
-            if (head == tail - 1)
-            {
-                thresholds[j] = 1.0f;
-                redirect[j] = j;
-                break;
-            }
-            else if (weights[j] < 1.0f)
-            {
-                std::swap(permutation[head], permutation[tail]);
-                tail--;
-            }
-            else
-            {
-                head++;
-            }
-        }
+            uint32_t prob = (uint32_t(f32tof16(entries[i].threshold)) << 16u);
+            uint2 lowPrec = uint2(entries[i].alias & 0xFFFFFFu, i & 0xFFFFFFu);
+            fullTable[i] = uint2(prob | ((lowPrec.x >> 8u) & 0xFFFFu), ((lowPrec.x & 0xFFu) << 24u) | lowPrec.y);
+        });
 
-        for (uint32_t i = 0; i < N; ++i)
-        {
-            permutation[i] = i;
-        }
+        mTriangleTable.weightSum = float(sum);
 
-        for (uint32_t i = 0; i < N; ++i)
+        if (!mTriangleTable.fullTable || mTriangleTable.N != N)
         {
-            uint32_t dst = i + (rngDist(mAliasTableRng) % (N - i));
-            std::swap(thresholds[i], thresholds[dst]);
-            std::swap(redirect[i], redirect[dst]);
-            std::swap(permutation[i], permutation[dst]);
+            mTriangleTable.N = N;
+            mTriangleTable.fullTable = mpDevice->createTypedBuffer<uint2>(N);
+            if (N > 0) mTriangleTable.fullTable->setBlob(fullTable.data(), 0, N * sizeof(uint2));
         }
-
-        for (uint32_t i = 0; i < N; ++i)
+        else
         {
-            merged[i] = uint2(redirect[i], permutation[i]);
-
-            // Pack 16-bit threshold (i.e., a half float) plus 2x 24-bit table entries
-            uint32_t prob = (uint32_t(f32tof16(thresholds[i])) << 16u);
-            uint2 lowPrec = uint2(redirect[i] & 0xFFFFFFu, permutation[i] & 0xFFFFFFu);
-            uint2 mergedEntry = uint2(prob | ((lowPrec.x >> 8u) & 0xFFFFu), ((lowPrec.x & 0xFFu) << 24u) | lowPrec.y);
-            fullTable[i] = mergedEntry;
+            // Upload only the ranges of entries that differ from the previous table.
+            std::vector<uint32_t> changedEntries;
+            for (uint32_t i = 0; i < N; i++)
+            {
+                if (any(fullTable[i] != mPackedTable[i])) changedEntries.push_back(i);
+            }
+            InstanceDescUpdate::forEachIndexRange(changedEntries, [&](uint32_t offset, uint32_t count)
+            {
+                mTriangleTable.fullTable->setBlob(&fullTable[offset], offset * sizeof(uint2), count * sizeof(uint2));
+            });
         }
 
-        AliasTable result
-        {
-            float(sum),
-            N,
-            mpDevice->createTypedBuffer<uint2>(N),
-        };
-
-        result.fullTable->setBlob(&fullTable[0], 0, N * sizeof(uint2));
-
-        return result;
+        mPackedTable = std::move(fullTable);
     }
 }
@@ -29,7 +29,6 @@
 #include "EmissiveLightSampler.h"
 #include "Core/Macros.h"
 #include "Scene/Lights/LightCollection.h"
-#include <random>
 #include <vector>
 
 namespace Falcor
@@ -70,16 +69,17 @@ namespace Falcor
         virtual void bindShaderData(const ShaderVar& var) const override;
 
     protected:
-        /** Generate an alias table
-            \param[in] weights  The weights we'd like to sample each entry proportional to
-            \returns The alias table
+        /** Build the alias table for the given weights and upload it.
+            If the table size is unchanged, only the entries that differ from the previous table are uploaded.
+            \param[in] weights The weights we'd like to sample each entry proportional to
         */
-        AliasTable generateAliasTable(std::vector<float> weights);
+        void updateAliasTable(const std::vector<float>& weights);
 
         // Internal state
         bool                            mNeedsRebuild = true;   ///< Trigger rebuild on the next call to update(). We should always build on the first call, so the initial value is true.
 
-        std::mt19937                    mAliasTableRng;
         AliasTable                      mTriangleTable;
+        std::vector<float>              mWeights;               ///< Triangle weights the alias table was built from.
+        std::vector<uint2>              mPackedTable;           ///< CPU copy of the packed alias table, used to upload only changed entries.
     };
 }
@@ -28,9 +28,15 @@
 #include "LightBVHBuilder.h"
 #include "Core/Error.h"
 #include "Utils/Logger.h"
+#include "Utils/NumericRange.h"
+#include "Utils/TaskManager.h"
+#include "Utils/Threading.h"
 #include "Utils/Timing/Profiler.h"
+#include "Utils/Math/BatchMath.h"
+#include "Utils/Math/Common.h"
 #include "Utils/Math/MathConstants.slangh"
 #include <algorithm>
+#include <execution>
 
 namespace
 {
@@ -44,6 +50,65 @@ namespace
     const uint32_t kMaxLeafTriangleCount = 1 << PackedNode::kTriangleCountBits;
     const uint32_t kMaxLeafTriangleOffset = 1 << PackedNode::kTriangleOffsetBits;
 
+    // Large triangle ranges are processed in chunks of this size when computing node bounds and binning.
+    // The chunking only depends on the range, so single- and multi-threaded builds give identical results.
+    const uint32_t kChunkTriangleCount = 1 << 14;
+
+    // Minimum number of triangles for using the multi-threaded build.
+    const uint32_t kMinParallelBuildTriangleCount = 1 << 12;
+
+    /** Evaluates a function over a range in fixed size chunks.
+        \param[in] parallel Evaluate the chunks concurrently.
+        \param[in] func Function taking the begin and end of a chunk and returning a result of type T.
+        \return Results for all chunks in order.
+    */
+    template<typename T, typename Func>
+    std::vector<T> mapChunks(uint32_t begin, uint32_t end, bool parallel, const Func& func)
+    {
+        const uint32_t chunkCount = std::max(1u, div_round_up(end - begin, kChunkTriangleCount));
+        std::vector<T> results(chunkCount);
+        auto evalChunk = [&](uint32_t chunkIndex)
+        {
+            uint32_t chunkBegin = begin + chunkIndex * kChunkTriangleCount;
+            results[chunkIndex] = func(chunkBegin, std::min(chunkBegin + kChunkTriangleCount, end));
+        };
+
+        if (parallel && chunkCount > 1)
+        {
+            NumericRange<uint32_t> range(0, chunkCount);
+            std::for_each(std::execution::par, range.begin(), range.end(), evalChunk);
+        }
+        else
+        {
+            for (uint32_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex) evalChunk(chunkIndex);
+        }
+        return results;
+    }
+
+    /** Computes the bounds and total flux of a range of triangles.
+    */
+    template<typename TriangleData>
+    void computeBoundsAndFlux(const std::vector<TriangleData>& trianglesData, uint32_t begin, uint32_t end, bool parallel, AABB& bounds, float& flux)
+    {
+        auto chunks = mapChunks<std::pair<AABB, float>>(begin, end, parallel, [&](uint32_t chunkBegin, uint32_t chunkEnd)
+        {
+            std::pair<AABB, float> result = { math::computeBounds(&trianglesData.data()[chunkBegin].bounds, chunkEnd - chunkBegin, sizeof(TriangleData)), 0.f };
+            for (uint32_t dataIndex = chunkBegin; dataIndex < chunkEnd; ++dataIndex)
+            {
+                result.second += trianglesData[dataIndex].flux;
+            }
+            return result;
+        });
+
+        bounds = AABB();
+        flux = 0.f;
+        for (const auto& chunk : chunks)
+        {
+            bounds |= chunk.first;
+            flux += chunk.second;
+        }
+    }
+
     inline float safeACos(float v)
     {
         return std::acos(std::clamp(v, -1.0f, 1.0f));
@@ -287,7 +352,14 @@ namespace Falcor
 
         // Build the tree.
         SplitHeuristicFunction splitFunc = getSplitFunction(mOptions.splitHeuristicSelection);
-        buildInternal(mOptions, splitFunc, 0ull, 0, Range(0, static_cast<uint32_t>(data.trianglesData.size())), data);
+        if (mOptions.useParallelBuild && data.trianglesData.size() >= kMinParallelBuildTriangleCount)
+        {
+            buildParallel(mOptions, splitFunc, data);
+        }
+        else
+        {
+            buildInternal(mOptions, splitFunc, 0ull, 0, Range(0, static_cast<uint32_t>(data.trianglesData.size())), data, data.nodes, data.triangleIndices);
+        }
         FALCOR_ASSERT(!data.nodes.empty());
 
         size_t numValid = 0;
@@ -321,6 +393,7 @@ namespace Falcor
         optionsChanged |= widget.checkbox("Allow refitting", options.allowRefitting);
         optionsChanged |= widget.var("Max triangle count per leaf", options.maxTriangleCountPerLeaf, 1u, kMaxLeafTriangleCount);
         optionsChanged |= widget.dropdown("Split heuristic", options.splitHeuristicSelection);
+        optionsChanged |= widget.checkbox("Parallel build", options.useParallelBuild);
 
         if (auto splitGroup = widget.group("Split Options", true))
         {
@@ -349,24 +422,18 @@ namespace Falcor
         return optionsChanged;
     }
 
-    uint32_t LightBVHBuilder::buildInternal(const Options& options, const SplitHeuristicFunction& splitHeuristic, uint64_t bitmask, uint32_t depth, const Range& triangleRange, BuildingData& data)
+    uint32_t LightBVHBuilder::buildInternal(const Options& options, const SplitHeuristicFunction& splitHeuristic, uint64_t bitmask, uint32_t depth, const Range& triangleRange, BuildingData& data, std::vector<PackedNode>& nodes, std::vector<uint32_t>& triangleIndices)
     {
         FALCOR_ASSERT(triangleRange.begin < triangleRange.end);
 
         // Compute the AABB and total flux of the node.
         float nodeFlux = 0.f;
         AABB nodeBounds;
-        for (uint32_t dataIndex = triangleRange.begin; dataIndex < triangleRange.end; ++dataIndex)
-        {
-            nodeBounds |= data.trianglesData[dataIndex].bounds;
-            nodeFlux += data.trianglesData[dataIndex].flux;
-        }
+        computeBoundsAndFlux(data.trianglesData, triangleRange.begin, triangleRange.end, options.useParallelBuild, nodeBounds, nodeFlux);
         FALCOR_ASSERT(nodeBounds.valid());
 
-        data.currentNodeFlux = nodeFlux;
-
         bool trySplitting = triangleRange.length() > (options.createLeavesASAP ? options.maxTriangleCountPerLeaf : 1);
-        const SplitResult splitResult = trySplitting ? splitHeuristic(data, triangleRange, nodeBounds, options) : SplitResult();
+        const SplitResult splitResult = trySplitting ? splitHeuristic(data, triangleRange, nodeBounds, nodeFlux, options) : SplitResult();
 
         // If we should split, then create an internal node and split.
         if (splitResult.isValid())
@@ -378,9 +445,9 @@ namespace Falcor
             std::nth_element(std::begin(data.trianglesData) + triangleRange.begin, std::begin(data.trianglesData) + splitResult.triangleIndex, std::begin(data.trianglesData) + triangleRange.end, comp);
 
             // Allocate internal node.
-            FALCOR_ASSERT(data.nodes.size() < std::numeric_limits<uint32_t>::max());
-            const uint32_t nodeIndex = (uint32_t)data.nodes.size();
-            data.nodes.push_back({});
+            FALCOR_ASSERT(nodes.size() < std::numeric_limits<uint32_t>::max());
+            const uint32_t nodeIndex = (uint32_t)nodes.size();
+            nodes.push_back({});
 
             InternalNode node = {};
             node.attribs.setAABB(nodeBounds.minPoint, nodeBounds.maxPoint);
@@ -394,13 +461,13 @@ namespace Falcor
                 FALCOR_THROW("BVH depth of {} reached. Maximum of {} allowed.", depth + 1, kMaxBVHDepth);
             }
 
-            uint32_t leftIndex = buildInternal(options, splitHeuristic, bitmask | (0ull << depth), depth + 1, Range(triangleRange.begin, splitResult.triangleIndex), data);
-            uint32_t rightIndex = buildInternal(options, splitHeuristic, bitmask | (1ull << depth), depth + 1, Range(splitResult.triangleIndex, triangleRange.end), data);
+            uint32_t leftIndex = buildInternal(options, splitHeuristic, bitmask | (0ull << depth), depth + 1, Range(triangleRange.begin, splitResult.triangleIndex), data, nodes, triangleIndices);
+            uint32_t rightIndex = buildInternal(options, splitHeuristic, bitmask | (1ull << depth), depth + 1, Range(splitResult.triangleIndex, triangleRange.end), data, nodes, triangleIndices);
 
             FALCOR_ASSERT(leftIndex == nodeIndex + 1); // The left node should always be placed immediately after the current node.
             node.rightChildIdx = rightIndex;
 
-            data.nodes[nodeIndex].setInternalNode(node);
+            nodes[nodeIndex].setInternalNode(node);
             return nodeIndex;
         }
         else // No split => create leaf node
@@ -408,9 +475,9 @@ namespace Falcor
             FALCOR_ASSERT(triangleRange.length() <= options.maxTriangleCountPerLeaf);
 
             // Allocate leaf node.
-            FALCOR_ASSERT(data.nodes.size() < std::numeric_limits<uint32_t>::max());
-            const uint32_t nodeIndex = (uint32_t)data.nodes.size();
-            data.nodes.push_back({});
+            FALCOR_ASSERT(nodes.size() < std::numeric_limits<uint32_t>::max());
+            const uint32_t nodeIndex = (uint32_t)nodes.size();
+            nodes.push_back({});
 
             LeafNode node = {};
             node.attribs.setAABB(nodeBounds.minPoint, nodeBounds.maxPoint);
@@ -420,21 +487,140 @@ namespace Falcor
             node.attribs.cosConeAngle = cosTheta;
 
             node.triangleCount = triangleRange.length();
-            node.triangleOffset = (uint32_t)data.triangleIndices.size();
+            node.triangleOffset = (uint32_t)triangleIndices.size();
             FALCOR_ASSERT(node.triangleCount < kMaxLeafTriangleCount);
             FALCOR_ASSERT(node.triangleOffset < kMaxLeafTriangleOffset);
 
             for (uint32_t triangleIdx = triangleRange.begin, index = 0; triangleIdx < triangleRange.end; ++triangleIdx, ++index)
             {
                 uint32_t globalTriangleIndex = data.trianglesData[triangleIdx].triangleIndex;
-                data.triangleIndices.push_back(globalTriangleIndex);
+                triangleIndices.push_back(globalTriangleIndex);
                 data.triangleBitmasks[globalTriangleIndex] = bitmask;
             }
-            FALCOR_ASSERT(data.triangleIndices.size() == node.triangleOffset + node.triangleCount);
+            FALCOR_ASSERT(triangleIndices.size() == node.triangleOffset + node.triangleCount);
+
+            nodes[nodeIndex].setLeafNode(node);
+            return nodeIndex;
+        }
+    }
+
+    void LightBVHBuilder::buildParallel(const Options& options, const SplitHeuristicFunction& splitHeuristic, BuildingData& data)
+    {
+        const uint32_t triangleCount = static_cast<uint32_t>(data.trianglesData.size());
+
+        // Aim for a few subtrees per thread to balance the load.
+        const uint32_t maxSubtreeTriangleCount = std::max({ triangleCount / (4 * std::max(1u, Threading::getLogicalThreadCount())), options.maxTriangleCountPerLeaf, 1u });
+
+        std::vector<TopLevelNode> topLevelNodes;
+        std::vector<Subtree> subtrees;
+        buildTopLevels(options, splitHeuristic, 0ull, 0, Range(0, triangleCount), maxSubtreeTriangleCount, data, topLevelNodes, subtrees);
+
+        // Build the subtrees. They operate on disjoint triangle ranges and write to their own node lists.
+        // The task manager forwards errors (e.g. exceeding the maximum depth) to the calling thread.
+        TaskManager taskManager(true);
+        for (Subtree& subtree : subtrees)
+        {
+            taskManager.addTask([this, &options, &splitHeuristic, &data, &subtree]()
+            {
+                buildInternal(options, splitHeuristic, subtree.bitmask, subtree.depth, subtree.triangleRange, data, subtree.nodes, subtree.triangleIndices);
+            });
+        }
+        taskManager.finish(nullptr);
+
+        stitchSubtrees(0, topLevelNodes, subtrees, data);
+    }
+
+    uint32_t LightBVHBuilder::buildTopLevels(const Options& options, const SplitHeuristicFunction& splitHeuristic, uint64_t bitmask, uint32_t depth, const Range& triangleRange, uint32_t maxSubtreeTriangleCount, BuildingData& data, std::vector<TopLevelNode>& topLevelNodes, std::vector<Subtree>& subtrees)
+    {
+        FALCOR_ASSERT(triangleRange.begin < triangleRange.end);
+
+        // This follows buildInternal() for the internal nodes. Nodes that may become leaves are always deferred to a subtree.
+        if (triangleRange.length() > maxSubtreeTriangleCount)
+        {
+            float nodeFlux = 0.f;
+            AABB nodeBounds;
+            computeBoundsAndFlux(data.trianglesData, triangleRange.begin, triangleRange.end, options.useParallelBuild, nodeBounds, nodeFlux);
+            FALCOR_ASSERT(nodeBounds.valid());
+
+            FALCOR_ASSERT(triangleRange.length() > (options.createLeavesASAP ? options.maxTriangleCountPerLeaf : 1));
+            const SplitResult splitResult = splitHeuristic(data, triangleRange, nodeBounds, nodeFlux, options);
+
+            if (splitResult.isValid())
+            {
+                FALCOR_ASSERT(triangleRange.begin < splitResult.triangleIndex && splitResult.triangleIndex < triangleRange.end);
+
+                auto comp = [dim = splitResult.axis](const TriangleSortData& d1, const TriangleSortData& d2) { return d1.bounds.center()[dim] < d2.bounds.center()[dim]; };
+                std::nth_element(std::begin(data.trianglesData) + triangleRange.begin, std::begin(data.trianglesData) + splitResult.triangleIndex, std::begin(data.trianglesData) + triangleRange.end, comp);
+
+                if (depth >= kMaxBVHDepth)
+                {
+                    FALCOR_THROW("BVH depth of {} reached. Maximum of {} allowed.", depth + 1, kMaxBVHDepth);
+                }
+
+                const uint32_t topLevelIndex = (uint32_t)topLevelNodes.size();
+                topLevelNodes.push_back({});
+
+                InternalNode node = {};
+                node.attribs.setAABB(nodeBounds.minPoint, nodeBounds.maxPoint);
+                node.attribs.flux = nodeFlux;
+
+                uint32_t leftChild = buildTopLevels(options, splitHeuristic, bitmask | (0ull << depth), depth + 1, Range(triangleRange.begin, splitResult.triangleIndex), maxSubtreeTriangleCount, data, topLevelNodes, subtrees);
+                uint32_t rightChild = buildTopLevels(options, splitHeuristic, bitmask | (1ull << depth), depth + 1, Range(splitResult.triangleIndex, triangleRange.end), maxSubtreeTriangleCount, data, topLevelNodes, subtrees);
+
+                topLevelNodes[topLevelIndex].node = node;
+                topLevelNodes[topLevelIndex].leftChild = leftChild;
+                topLevelNodes[topLevelIndex].rightChild = rightChild;
+                return topLevelIndex;
+            }
+        }
+
+        // Defer the node to a subtree.
+        TopLevelNode topLevelNode;
+        topLevelNode.subtreeIndex = (uint32_t)subtrees.size();
+        subtrees.push_back(Subtree{ bitmask, depth, triangleRange, {}, {} });
+        topLevelNodes.push_back(topLevelNode);
+        return (uint32_t)topLevelNodes.size() - 1;
+    }
 
-            data.nodes[nodeIndex].setLeafNode(node);
+    uint32_t LightBVHBuilder::stitchSubtrees(uint32_t topLevelIndex, const std::vector<TopLevelNode>& topLevelNodes, const std::vector<Subtree>& subtrees, BuildingData& data)
+    {
+        const TopLevelNode& topLevelNode = topLevelNodes[topLevelIndex];
+        FALCOR_ASSERT(data.nodes.size() < std::numeric_limits<uint32_t>::max());
+        const uint32_t nodeIndex = (uint32_t)data.nodes.size();
+
+        if (topLevelNode.subtreeIndex != std::numeric_limits<uint32_t>::max())
+        {
+            const Subtree& subtree = subtrees[topLevelNode.subtreeIndex];
+            const uint32_t triangleOffset = (uint32_t)data.triangleIndices.size();
+
+            // Relocate the node references. These are stored in the first dword of the packed node.
+            // The node attributes are left untouched as unpacking and repacking them is lossy.
+            for (PackedNode packedNode : subtree.nodes)
+            {
+                if (packedNode.isLeaf())
+                {
+                    FALCOR_ASSERT(packedNode.getLeafNode().triangleOffset + triangleOffset < kMaxLeafTriangleOffset);
+                    packedNode.data[0].x += triangleOffset;
+                }
+                else
+                {
+                    packedNode.data[0].x += nodeIndex;
+                }
+                data.nodes.push_back(packedNode);
+            }
+            data.triangleIndices.insert(data.triangleIndices.end(), subtree.triangleIndices.begin(), subtree.triangleIndices.end());
             return nodeIndex;
         }
+
+        data.nodes.push_back({});
+
+        InternalNode node = topLevelNode.node;
+        uint32_t leftIndex = stitchSubtrees(topLevelNode.leftChild, topLevelNodes, subtrees, data);
+        FALCOR_ASSERT(leftIndex == nodeIndex + 1);
+        node.rightChildIdx = stitchSubtrees(topLevelNode.rightChild, topLevelNodes, subtrees, data);
+
+        data.nodes[nodeIndex].setInternalNode(node);
+        return nodeIndex;
     }
 
     float3 LightBVHBuilder::computeLightingConesInternal(const uint32_t nodeIndex, BuildingData& data, float& cosConeAngle)
@@ -497,7 +683,7 @@ namespace Falcor
         return coneDirection;
     }
 
-    LightBVHBuilder::SplitResult LightBVHBuilder::computeSplitWithEqual(const BuildingData& /*data*/, const Range& triangleRange, const AABB& nodeBounds, const Options& /*parameters*/)
+    LightBVHBuilder::SplitResult LightBVHBuilder::computeSplitWithEqual(const BuildingData& /*data*/, const Range& triangleRange, const AABB& nodeBounds, float /*nodeFlux*/, const Options& /*parameters*/)
     {
         // Find the largest dimension.
         float3 dimensions = nodeBounds.extent();
@@ -524,7 +710,7 @@ namespace Falcor
         return cost;
     }
 
-    LightBVHBuilder::SplitResult LightBVHBuilder::computeSplitWithBinnedSAH(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, const Options& parameters)
+    LightBVHBuilder::SplitResult LightBVHBuilder::computeSplitWithBinnedSAH(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, float nodeFlux, const Options& parameters)
     {
         std::pair<float, SplitResult> overallBestSplit = std::make_pair(std::numeric_limits<float>::infinity(), SplitResult());
         FALCOR_ASSERT(!overallBestSplit.second.isValid());
@@ -568,11 +754,20 @@ namespace Falcor
             // Reset the bins.
             for (Bin& bin : bins) bin = Bin();
 
-            // Fill the bins with all triangles.
-            for (uint32_t i = triangleRange.begin; i < triangleRange.end; ++i)
+            // Fill the bins with all triangles. Large ranges are binned in chunks that are merged in order.
+            auto chunkBins = mapChunks<std::vector<Bin>>(triangleRange.begin, triangleRange.end, parameters.useParallelBuild, [&](uint32_t chunkBegin, uint32_t chunkEnd)
+            {
+                std::vector<Bin> chunk(bins.size());
+                for (uint32_t i = chunkBegin; i < chunkEnd; ++i)
+                {
+                    const auto& td = data.trianglesData[i];
+                    chunk[getBinId(td)] |= td;
+                }
+                return chunk;
+            });
+            for (const auto& chunk : chunkBins)
             {
-                const auto& td = data.trianglesData[i];
-                bins[getBinId(td)] |= td;
+                for (std::size_t i = 0; i < bins.size(); ++i) bins[i] |= chunk[i];
             }
 
             // First, compute A_j(L) * N_j(L) by sweeping over the bins from left to right.
@@ -637,7 +832,7 @@ namespace Falcor
         {
             if (triangleRange.length() <= parameters.maxTriangleCountPerLeaf) return SplitResult();
             logWarning("LightBVHBuilder::computeSplitWithBinnedSAH() was not able to compute a proper split: reverting to LightBVHBuilder::computeSplitWithEqual()");
-            return computeSplitWithEqual(data, triangleRange, nodeBounds, parameters);
+            return computeSplitWithEqual(data, triangleRange, nodeBounds, nodeFlux, parameters);
         }
 
         // If the best split we found is more expensive than the cost of a leaf node (and we can create one), then create a leaf node.
@@ -679,7 +874,7 @@ namespace Falcor
         return cost;
     }
 
-    LightBVHBuilder::SplitResult LightBVHBuilder::computeSplitWithBinnedSAOH(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, const Options& parameters)
+    LightBVHBuilder::SplitResult LightBVHBuilder::computeSplitWithBinnedSAOH(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, float nodeFlux, const Options& parameters)
     {
         std::pair<float, SplitResult> overallBestSplit = std::make_pair(std::numeric_limits<float>::infinity(), SplitResult());
         FALCOR_ASSERT(!overallBestSplit.second.isValid());
@@ -738,11 +933,20 @@ namespace Falcor
             // Reset the bins.
             for (Bin& bin : bins) bin = Bin();
 
-            // Fill the bins with all triangles.
-            for (uint32_t i = triangleRange.begin; i < triangleRange.end; ++i)
+            // Fill the bins with all triangles. Large ranges are binned in chunks that are merged in order.
+            auto chunkBins = mapChunks<std::vector<Bin>>(triangleRange.begin, triangleRange.end, parameters.useParallelBuild, [&](uint32_t chunkBegin, uint32_t chunkEnd)
             {
-                const auto& td = data.trianglesData[i];
-                bins[getBinId(td)] |= td;
+                std::vector<Bin> chunk(bins.size());
+                for (uint32_t i = chunkBegin; i < chunkEnd; ++i)
+                {
+                    const auto& td = data.trianglesData[i];
+                    chunk[getBinId(td)] |= td;
+                }
+                return chunk;
+            });
+            for (const auto& chunk : chunkBins)
+            {
+                for (std::size_t i = 0; i < bins.size(); ++i) bins[i] |= chunk[i];
             }
 
             // Compute the lighting cones for each bin.
@@ -754,11 +958,22 @@ namespace Falcor
                 bin.cosConeAngle = length(bin.coneDirection) < FLT_MIN ? kInvalidCosConeAngle : 1.0f;
                 bin.coneDirection = normalize(bin.coneDirection);
             }
-            for (uint32_t i = triangleRange.begin; i < triangleRange.end; ++i)
+            // The cone angle only shrinks as triangles are added, so the chunk results are merged by taking the minimum.
+            auto chunkCosConeAngles = mapChunks<std::vector<float>>(triangleRange.begin, triangleRange.end, parameters.useParallelBuild, [&](uint32_t chunkBegin, uint32_t chunkEnd)
+            {
+                std::vector<float> cosConeAngles(bins.size());
+                for (std::size_t i = 0; i < bins.size(); ++i) cosConeAngles[i] = bins[i].cosConeAngle;
+                for (uint32_t i = chunkBegin; i < chunkEnd; ++i)
+                {
+                    const auto& td = data.trianglesData[i];
+                    uint32_t binId = getBinId(td);
+                    cosConeAngles[binId] = computeCosConeAngle(bins[binId].coneDirection, cosConeAngles[binId], td.coneDirection, td.cosConeAngle);
+                }
+                return cosConeAngles;
+            });
+            for (const auto& chunk : chunkCosConeAngles)
             {
-                const auto& td = data.trianglesData[i];
-                Bin& bin = bins[getBinId(td)];
-                bin.cosConeAngle = computeCosConeAngle(bin.coneDirection, bin.cosConeAngle, td.coneDirection, td.cosConeAngle);
+                for (std::size_t i = 0; i < bins.size(); ++i) bins[i].cosConeAngle = std::min(bins[i].cosConeAngle, chunk[i]);
             }
 
             // First, compute A_j(L) * N_j(L) by sweeping over the bins from left to right.
@@ -848,7 +1063,7 @@ namespace Falcor
         {
             if (triangleRange.length() <= parameters.maxTriangleCountPerLeaf) return SplitResult();
             logWarning("LightBVHBuilder::computeSplitWithBinnedSAOH() was not able to compute a proper split: reverting to LightBVHBuilder::computeSplitWithEqual()");
-            return computeSplitWithEqual(data, triangleRange, nodeBounds, parameters);
+            return computeSplitWithEqual(data, triangleRange, nodeBounds, nodeFlux, parameters);
         }
 
         // If the best split we found is more expensive than the cost of a leaf node (and we can create one), then create a leaf node.
@@ -858,7 +1073,7 @@ namespace Falcor
             // Evaluate the cost metric for the node. This requires us to first compute the cone angle.
             float cosTheta = kInvalidCosConeAngle;
             computeLightingCone(triangleRange, data, cosTheta);
-            float leafCost = evalSAOH(nodeBounds, data.currentNodeFlux, cosTheta, parameters);
+            float leafCost = evalSAOH(nodeBounds, nodeFlux, cosTheta, parameters);
             if (leafCost <= overallBestSplit.first) return SplitResult();
         }
 
@@ -78,6 +78,7 @@ namespace Falcor
             bool           allowRefitting = true;                                ///< Rather than always rebuilding the BVH from scratch, keep the hierarchy but update the bounds and lighting cones.
             bool           usePreintegration = true;                             ///< Use pre-integration for culling out emissive triangles and use their flux when computing the splits. Only valid when using the BinnedSAOH split heuristic.
             bool           useLightingCones = true;                              ///< Use lighting cones when computing the splits. Only valid when using the BinnedSAOH split heuristic.
+            bool           useParallelBuild = true;                              ///< Build the BVH using multiple threads. The resulting BVH is identical to a single-threaded build.
 
             template<typename Archive>
             void serialize(Archive& ar)
@@ -93,6 +94,7 @@ namespace Falcor
                 ar("allowRefitting", allowRefitting);
                 ar("usePreintegration", usePreintegration);
                 ar("useLightingCones", useLightingCones);
+                ar("useParallelBuild", useParallelBuild);
             }
         };
 
@@ -149,32 +151,77 @@ namespace Falcor
             std::vector<TriangleSortData> trianglesData;    ///< Compact list of triangles to include in build.
             std::vector<uint32_t> triangleIndices;          ///< Triangle indices sorted by leaf node. Each leaf node refers to a contiguous array of triangle indices.
             std::vector<uint64_t> triangleBitmasks;         ///< Array containing the per triangle bit pattern retracing the tree traversal to reach the triangle: 0=left child, 1=right child; this array gets filled in during the build process. Indexed by global triangle index.
-            float currentNodeFlux = 0.f;                    ///< Used by computeSAOHSplit() as the leaf creation cost.
 
             BuildingData(std::vector<PackedNode>& bvhNodes) : nodes(bvhNodes) {}
         };
 
+        /** Node in the top levels of the tree in a parallel build.
+            The subtrees below the top levels are built independently and stitched together afterwards.
+        */
+        struct TopLevelNode
+        {
+            InternalNode node = {};                         ///< Internal node. The child index is assigned when stitching.
+            uint32_t leftChild = std::numeric_limits<uint32_t>::max();      ///< Index of the left child top level node.
+            uint32_t rightChild = std::numeric_limits<uint32_t>::max();     ///< Index of the right child top level node.
+            uint32_t subtreeIndex = std::numeric_limits<uint32_t>::max();   ///< Index of the subtree built at this node, or invalid for internal nodes.
+        };
+
+        /** Subtree built independently in a parallel build.
+        */
+        struct Subtree
+        {
+            uint64_t bitmask;                               ///< Bit pattern retracing the tree traversal to reach the subtree root.
+            uint32_t depth;                                 ///< Depth of the subtree root.
+            Range triangleRange;                            ///< Range of triangles in the subtree.
+            std::vector<PackedNode> nodes;                  ///< Nodes of the subtree. Node indices are relative to the subtree root.
+            std::vector<uint32_t> triangleIndices;          ///< Triangle indices of the subtree. Leaf offsets are relative to the first triangle index.
+        };
+
         /** Compute the split according to a specified heuristic.
             \param[in] data Prepared light data.
             \param[in] triangleRange Range of triangles to process.
             \param[in] nodeBounds Bounds for the node to be splitted.
+            \param[in] nodeFlux Total flux of the node to be splitted.
             \param[in] parameters Various parameters defining how the building should occur.
         */
-        using SplitHeuristicFunction = std::function<SplitResult(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, const Options& parameters)>;
+        using SplitHeuristicFunction = std::function<SplitResult(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, float nodeFlux, const Options& parameters)>;
 
         /** Renders the UI with builder options.
         */
         bool renderOptions(Gui::Widgets& widget, Options& options) const;
 
         /** Recursive BVH build.
+            This function may be called concurrently for disjoint triangle ranges.
             \param[in] splitHeuristic The splitting heuristic to be used.
             \param[in] bitmask Bit pattern retracing the tree traversal to reach the node to be built: 0=left child, 1=right child.
             \param[in] depth Depth of the node to be built
             \param[in] triangleRange Range of triangles to process.
             \param[in,out] data Prepared light data.
+            \param[in,out] nodes List of nodes to append the allocated nodes to.
+            \param[in,out] triangleIndices List of triangle indices to append the leaf triangles to.
             \return Index of the allocated node.
         */
-        uint32_t buildInternal(const Options& options, const SplitHeuristicFunction& splitHeuristic, uint64_t bitmask, uint32_t depth, const Range& triangleRange, BuildingData& data);
+        uint32_t buildInternal(const Options& options, const SplitHeuristicFunction& splitHeuristic, uint64_t bitmask, uint32_t depth, const Range& triangleRange, BuildingData& data, std::vector<PackedNode>& nodes, std::vector<uint32_t>& triangleIndices);
+
+        /** Multi-threaded BVH build.
+            The top levels of the tree are built first, using multiple threads for the binning of large nodes.
+            The remaining subtrees are built concurrently and stitched together in depth-first order,
+            which produces the same node layout as buildInternal().
+            \param[in] splitHeuristic The splitting heuristic to be used.
+            \param[in,out] data Prepared light data.
+        */
+        void buildParallel(const Options& options, const SplitHeuristicFunction& splitHeuristic, BuildingData& data);
+
+        /** Recursive build of the top levels of the tree in a parallel build.
+            Nodes with at most maxSubtreeTriangleCount triangles are deferred as subtrees.
+            \return Index of the allocated top level node.
+        */
+        uint32_t buildTopLevels(const Options& options, const SplitHeuristicFunction& splitHeuristic, uint64_t bitmask, uint32_t depth, const Range& triangleRange, uint32_t maxSubtreeTriangleCount, BuildingData& data, std::vector<TopLevelNode>& topLevelNodes, std::vector<Subtree>& subtrees);
+
+        /** Recursively append the top level nodes and subtrees to the final node list in depth-first order.
+            \return Index of the node in the final node list.
+        */
+        uint32_t stitchSubtrees(uint32_t topLevelIndex, const std::vector<TopLevelNode>& topLevelNodes, const std::vector<Subtree>& subtrees, BuildingData& data);
 
         /** Recursive computation of lighting cones for all internal nodes.
             \param[in] nodeIndex Index of the current node.
@@ -193,9 +240,9 @@ namespace Falcor
         static float3 computeLightingCone(const Range& triangleRange, const BuildingData& data, float& cosTheta);
 
         // See the documentation of SplitHeuristicFunction.
-        static SplitResult computeSplitWithEqual(const BuildingData& /*data*/, const Range& triangleRange, const AABB& nodeBounds, const Options& /*parameters*/);
-        static SplitResult computeSplitWithBinnedSAH(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, const Options& parameters);
-        static SplitResult computeSplitWithBinnedSAOH(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, const Options& parameters);
+        static SplitResult computeSplitWithEqual(const BuildingData& /*data*/, const Range& triangleRange, const AABB& nodeBounds, float /*nodeFlux*/, const Options& /*parameters*/);
+        static SplitResult computeSplitWithBinnedSAH(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, float /*nodeFlux*/, const Options& parameters);
+        static SplitResult computeSplitWithBinnedSAOH(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, float nodeFlux, const Options& parameters);
 
         static SplitHeuristicFunction getSplitFunction(SplitHeuristic heuristic);
 
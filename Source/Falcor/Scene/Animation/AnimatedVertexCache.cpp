@@ -39,6 +39,10 @@ namespace Falcor
         const std::string kUpdateCurveAABBsFilename = "Scene/Animation/UpdateCurveAABBs.slang";
         const std::string kUpdateCurvePolyTubeVerticesFilename = "Scene/Animation/UpdateCurvePolyTubeVertices.slang";
 
+        // Keyframe streaming settings. Two slots hold the interpolated keyframes and the remaining slots the prefetched ones.
+        const uint32_t kStreamingSlotCount = 4;
+        const uint32_t kStreamingPrefetchCount = 2;
+
         InterpolationInfo calculateInterpolation(double time, const std::vector<double>& timeSamples, Animation::Behavior preInfinityBehavior, Animation::Behavior postInfinityBehavior)
         {
             if (!std::isfinite(time))
@@ -94,15 +98,24 @@ namespace Falcor
         }
     }
 
-    AnimatedVertexCache::AnimatedVertexCache(ref<Device> pDevice, Scene* pScene, const ref<Buffer>& pPrevVertexData, std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes)
+    AnimatedVertexCache::AnimatedVertexCache(ref<Device> pDevice, Scene* pScene, const ref<Buffer>& pPrevVertexData, std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes, bool streamKeyframes)
         : mpDevice(pDevice)
         , mpScene(pScene)
         , mpPrevVertexData(pPrevVertexData)
-        , mCachedCurves(cachedCurves)
-        , mCachedMeshes(cachedMeshes)
+        , mCachedCurves(std::move(cachedCurves))
+        , mCachedMeshes(std::move(cachedMeshes))
     {
         if (mCachedCurves.empty() && mCachedMeshes.empty()) return;
 
+        if (streamKeyframes)
+        {
+            auto upload = [this](uint32_t clipID, uint32_t slot, const void* pData, size_t byteSize)
+            {
+                mStreamingSlotBuffers[clipID][slot]->setBlob(pData, 0, byteSize);
+            };
+            mpStreamer = std::make_unique<VertexCacheStreamer>(kStreamingSlotCount, kStreamingPrefetchCount, upload);
+        }
+
         if (!mCachedCurves.empty())
         {
             for (auto& cache : mCachedCurves)
@@ -136,6 +149,13 @@ namespace Falcor
 
             createMeshVertexUpdatePass();
         }
+
+        // The streamer holds compressed copies of the keyframes, release the uncompressed data.
+        if (mpStreamer)
+        {
+            for (auto& cache : mCachedCurves) cache.vertexData = {};
+            for (auto& cache : mCachedMeshes) cache.vertexData = {};
+        }
     }
 
     bool AnimatedVertexCache::animate(RenderContext* pRenderContext, double time)
@@ -149,13 +169,13 @@ namespace Falcor
 
             if (mCurveLSSCount > 0)
             {
-                executeCurveLSSVertexUpdatePass(pRenderContext, interpolationInfo);
+                executeCurveLSSVertexUpdatePass(pRenderContext, requestCurveKeyframes(mCurveLSSClipID, interpolationInfo));
                 executeCurveLSSAABBUpdatePass(pRenderContext);
             }
 
             if (mCurvePolyTubeCount > 0)
             {
-                executeCurvePolyTubeVertexUpdatePass(pRenderContext, interpolationInfo);
+                executeCurvePolyTubeVertexUpdatePass(pRenderContext, requestCurveKeyframes(mCurvePolyTubeClipID, interpolationInfo));
             }
 
 
@@ -211,6 +231,75 @@ namespace Falcor
         mGlobalCurveAnimationLength = mCurveKeyframeTimes.empty() ? 0 : mCurveKeyframeTimes.back();
     }
 
+    void AnimatedVertexCache::gatherCurveKeyframe(CurveTessellationMode mode, uint32_t keyframe, std::vector<DynamicCurveVertexData>& vertices) const
+    {
+        // Concatenate the vertices of all curves with the given tessellation mode at the merged keyframe time.
+        vertices.clear();
+        const double time = mCurveKeyframeTimes[keyframe];
+        for (const auto& cache : mCachedCurves)
+        {
+            if (cache.tessellationMode != mode) continue;
+
+            const auto& timeSamples = cache.timeSamples;
+            size_t k = std::min(size_t(std::lower_bound(timeSamples.begin(), timeSamples.end(), time) - timeSamples.begin()), timeSamples.size() - 1);
+
+            if (timeSamples[k] == time || k == 0)
+            {
+                vertices.insert(vertices.end(), cache.vertexData[k].begin(), cache.vertexData[k].end());
+            }
+            else
+            {
+                // Linearly interpolate at the missing keyframe.
+                float t = float((time - timeSamples[k - 1]) / (timeSamples[k] - timeSamples[k - 1]));
+                for (size_t p = 0; p < cache.vertexData[k].size(); p++)
+                {
+                    vertices.push_back({ lerp(cache.vertexData[k - 1][p].position, cache.vertexData[k][p].position, t) });
+                }
+            }
+        }
+    }
+
+    std::vector<ref<Buffer>> AnimatedVertexCache::createCurveKeyframeBuffers(CurveTessellationMode mode, uint32_t vertexCount, const std::string& name)
+    {
+        // Create buffers for vertex positions in curve vertex caches.
+        // When streaming, the buffers are slots that are filled on demand, otherwise there is one buffer per keyframe.
+        ResourceBindFlags vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
+        uint32_t bufferCount = mpStreamer ? mpStreamer->getSlotCount() : (uint32_t)mCurveKeyframeTimes.size();
+        std::vector<ref<Buffer>> buffers(bufferCount);
+        for (uint32_t i = 0; i < bufferCount; i++)
+        {
+            buffers[i] = mpDevice->createStructuredBuffer(sizeof(DynamicCurveVertexData), vertexCount, vbBindFlags, MemoryType::DeviceLocal, nullptr, false);
+            buffers[i]->setName("AnimatedVertexCache::" + name + "[" + std::to_string(i) + "]");
+        }
+
+        // Initialize vertex buffers with cached positions, or hand them to the streamer.
+        std::vector<DynamicCurveVertexData> vertices;
+        uint32_t clipID = mpStreamer ? mpStreamer->addCurveClip(vertexCount) : 0;
+        for (uint32_t j = 0; j < mCurveKeyframeTimes.size(); j++)
+        {
+            gatherCurveKeyframe(mode, j, vertices);
+            FALCOR_ASSERT(vertices.size() == vertexCount);
+            if (mpStreamer) mpStreamer->addKeyframe(clipID, vertices);
+            else buffers[j]->setBlob(vertices.data(), 0, vertices.size() * sizeof(DynamicCurveVertexData));
+        }
+
+        if (mpStreamer)
+        {
+            FALCOR_ASSERT(clipID == mStreamingSlotBuffers.size());
+            mStreamingSlotBuffers.push_back(buffers);
+            if (mode == CurveTessellationMode::LinearSweptSphere) mCurveLSSClipID = clipID;
+            else mCurvePolyTubeClipID = clipID;
+        }
+
+        return buffers;
+    }
+
+    InterpolationInfo AnimatedVertexCache::requestCurveKeyframes(uint32_t clipID, const InterpolationInfo& info)
+    {
+        if (!mpStreamer) return info;
+        return InterpolationInfo{ mpStreamer->request(clipID, info.keyframeIndices), info.t };
+    }
+
     void AnimatedVertexCache::bindCurveLSSBuffers()
     {
         // Compute curve vertex and index (segment) count.
@@ -224,20 +313,14 @@ namespace Falcor
             mCurveIndexCount += (uint32_t)mCachedCurves[i].indexData.size();
         }
 
-        // Create buffers for vertex positions in curve vertex caches.
-        ResourceBindFlags vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
-        mpCurveVertexBuffers.resize(mCurveKeyframeTimes.size());
-        for (uint32_t i = 0; i < mCurveKeyframeTimes.size(); i++)
-        {
-            mpCurveVertexBuffers[i] = mpDevice->createStructuredBuffer(sizeof(DynamicCurveVertexData), mCurveVertexCount, vbBindFlags, MemoryType::DeviceLocal, nullptr, false);
-            mpCurveVertexBuffers[i]->setName("AnimatedVertexCache::mpCurveVertexBuffers[" + std::to_string(i) + "]");
-        }
+        mpCurveVertexBuffers = createCurveKeyframeBuffers(CurveTessellationMode::LinearSweptSphere, mCurveVertexCount, "mpCurveVertexBuffers");
 
         // Create buffers for previous vertex positions.
+        ResourceBindFlags vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
         mpPrevCurveVertexBuffer = mpDevice->createStructuredBuffer(sizeof(DynamicCurveVertexData), mCurveVertexCount, vbBindFlags, MemoryType::DeviceLocal, nullptr, false);
         mpPrevCurveVertexBuffer->setName("AnimatedVertexCache::mpPrevCurveVertexBuffer");
 
-        // Initialize vertex buffers with cached positions.
+        // Initialize previous vertex positions with positions at the first keyframe.
         uint32_t offset = 0;
         for (size_t i = 0; i < mCachedCurves.size(); i++)
         {
@@ -245,31 +328,7 @@ namespace Falcor
 
             size_t vertexCount = mCachedCurves[i].vertexData[0].size();
             uint32_t bufSize = uint32_t(vertexCount * sizeof(DynamicCurveVertexData));
-            uint32_t k = 0;
-            const auto& timeSamples = mCachedCurves[i].timeSamples;
-
-            for (uint32_t j = 0; j < mCurveKeyframeTimes.size(); j++)
-            {
-                while (k + 1 < timeSamples.size() && timeSamples[k] < mCurveKeyframeTimes[j]) k++;
 
-                if (timeSamples[k] == mCurveKeyframeTimes[j])
-                {
-                    mpCurveVertexBuffers[j]->setBlob(mCachedCurves[i].vertexData[k].data(), offset, bufSize);
-                }
-                else
-                {
-                    // Linearly interpolate at the missing keyframe.
-                    float t = float((mCurveKeyframeTimes[j] - timeSamples[k - 1]) / (timeSamples[k] - timeSamples[k - 1]));
-                    std::vector<DynamicCurveVertexData> interpVertices(vertexCount);
-                    for (size_t p = 0; p < vertexCount; p++)
-                    {
-                        interpVertices[p].position = lerp(mCachedCurves[i].vertexData[k - 1][p].position, mCachedCurves[i].vertexData[k][p].position, t);
-                    }
-                    mpCurveVertexBuffers[j]->setBlob(interpVertices.data(), offset, bufSize);
-                }
-            }
-
-            // Initialize it with positions at the first keyframe.
             mpPrevCurveVertexBuffer->setBlob(mCachedCurves[i].vertexData[0].data(), offset, bufSize);
 
             offset += bufSize;
@@ -337,57 +396,15 @@ namespace Falcor
         mpCurvePolyTubeMeshMetadataBuffer = mpDevice->createStructuredBuffer(sizeof(PerMeshMetadata), (uint32_t)meshMetadata.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, meshMetadata.data(), false);
         mpCurvePolyTubeMeshMetadataBuffer->setName("AnimatedVertexCache::mpCurvePolyTubeMeshMetadataBuffer");
 
-        // Create buffers for vertex positions in curve vertex caches.
-        ResourceBindFlags vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
-        mpCurvePolyTubeVertexBuffers.resize(mCurveKeyframeTimes.size());
-        for (uint32_t i = 0; i < mCurveKeyframeTimes.size(); i++)
-        {
-            mpCurvePolyTubeVertexBuffers[i] = mpDevice->createStructuredBuffer(sizeof(DynamicCurveVertexData), mCurvePolyTubeVertexCount, vbBindFlags, MemoryType::DeviceLocal, nullptr, false);
-            mpCurvePolyTubeVertexBuffers[i]->setName("AnimatedVertexCache::mpCurvePolyTubeVertexBuffers[" + std::to_string(i) + "]");
-        }
-
-        // Initialize vertex buffers with cached positions.
-        uint32_t offset = 0;
-        for (size_t i = 0; i < mCachedCurves.size(); i++)
-        {
-            if (mCachedCurves[i].tessellationMode != CurveTessellationMode::PolyTube) continue;
-
-            size_t vertexCount = mCachedCurves[i].vertexData[0].size();
-            uint32_t bufSize = uint32_t(vertexCount * sizeof(DynamicCurveVertexData));
-            uint32_t k = 0;
-            const auto& timeSamples = mCachedCurves[i].timeSamples;
-
-            for (uint32_t j = 0; j < mCurveKeyframeTimes.size(); j++)
-            {
-                while (k + 1 < timeSamples.size() && timeSamples[k] < mCurveKeyframeTimes[j]) k++;
-
-                if (timeSamples[k] == mCurveKeyframeTimes[j])
-                {
-                    mpCurvePolyTubeVertexBuffers[j]->setBlob(mCachedCurves[i].vertexData[k].data(), offset, bufSize);
-                }
-                else
-                {
-                    // Linearly interpolate at the missing keyframe.
-                    float t = float((mCurveKeyframeTimes[j] - timeSamples[k - 1]) / (timeSamples[k] - timeSamples[k - 1]));
-                    std::vector<DynamicCurveVertexData> interpVertices(vertexCount);
-                    for (size_t p = 0; p < vertexCount; p++)
-                    {
-                        interpVertices[p].position = lerp(mCachedCurves[i].vertexData[k - 1][p].position, mCachedCurves[i].vertexData[k][p].position, t);
-                    }
-                    mpCurvePolyTubeVertexBuffers[j]->setBlob(interpVertices.data(), offset, bufSize);
-                }
-            }
-
-            offset += bufSize;
-        }
+        mpCurvePolyTubeVertexBuffers = createCurveKeyframeBuffers(CurveTessellationMode::PolyTube, mCurvePolyTubeVertexCount, "mpCurvePolyTubeVertexBuffers");
 
         // Create curve strand index buffer.
-        vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
+        ResourceBindFlags vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
         mpCurvePolyTubeStrandIndexBuffer = mpDevice->createBuffer(sizeof(uint32_t) * mCurvePolyTubeVertexCount, vbBindFlags);
         mpCurvePolyTubeStrandIndexBuffer->setName("AnimatedVertexCache::mpCurvePolyTubeStrandIndexBuffer");
 
         // Initialize strand index buffer.
-        offset = 0;
+        uint32_t offset = 0;
         const uint32_t strandLastVertexIndex = 0xffffffff;
         std::vector<uint32_t> strandIndexData(mCurvePolyTubeVertexCount);
         for (uint32_t i = 0; i < (uint32_t)mCachedCurves.size(); i++)
@@ -435,7 +452,8 @@ namespace Falcor
 
     void AnimatedVertexCache::initMeshBuffers()
     {
-        mpMeshVertexBuffers.resize(mMeshKeyframeCount);
+        const uint32_t slotCount = mpStreamer ? mpStreamer->getSlotCount() : 0;
+        mpMeshVertexBuffers.resize(mpStreamer ? (uint32_t)mCachedMeshes.size() * slotCount : mMeshKeyframeCount);
         std::vector<PerMeshMetadata> meshMetadata;
         meshMetadata.reserve(mCachedMeshes.size());
 
@@ -451,6 +469,28 @@ namespace Falcor
             meta.prevVbOffset = mpScene->getMesh(cache.meshID).prevVbOffset;
             meshMetadata.push_back(meta);
 
+            if (mpStreamer)
+            {
+                // Create vertex buffer for each streaming slot on this mesh, the keyframes are uploaded on demand.
+                uint32_t clipID = mpStreamer->addMeshClip(meta.vertexCount);
+                for (const auto& data : cache.vertexData) mpStreamer->addKeyframe(clipID, data);
+
+                std::vector<ref<Buffer>> slotBuffers(slotCount);
+                for (uint32_t slot = 0; slot < slotCount; slot++)
+                {
+                    size_t index = keyframeOffset + slot;
+                    mpMeshVertexBuffers[index] = mpDevice->createStructuredBuffer(sizeof(PackedStaticVertexData), meta.vertexCount, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, nullptr, false);
+                    mpMeshVertexBuffers[index]->setName("AnimatedVertexCache::mpMeshVertexBuffers[" + std::to_string(index) + "]");
+                    slotBuffers[slot] = mpMeshVertexBuffers[index];
+                }
+
+                FALCOR_ASSERT(clipID == mStreamingSlotBuffers.size());
+                mStreamingSlotBuffers.push_back(std::move(slotBuffers));
+                mMeshClipIDs.push_back(clipID);
+                keyframeOffset += slotCount;
+                continue;
+            }
+
             // Create vertex buffer for each keyframe on this mesh
             for (size_t i = 0; i < cache.vertexData.size(); i++)
             {
@@ -476,7 +516,7 @@ namespace Falcor
         FALCOR_ASSERT(!mCachedMeshes.empty());
 
         DefineList defines;
-        defines.add("MESH_KEYFRAME_COUNT", std::to_string(mMeshKeyframeCount));
+        defines.add("MESH_KEYFRAME_COUNT", std::to_string(mpMeshVertexBuffers.size()));
         mpScene->getMeshStaticData().getShaderDefines(defines);
         mpMeshVertexUpdatePass = ComputePass::create(mpDevice, "Scene/Animation/UpdateMeshVertices.slang", "main", defines);
 
@@ -495,7 +535,7 @@ namespace Falcor
         FALCOR_ASSERT(mCurveLSSCount > 0);
 
         DefineList defines;
-        defines.add("CURVE_KEYFRAME_COUNT", std::to_string(mCurveKeyframeTimes.size()));
+        defines.add("CURVE_KEYFRAME_COUNT", std::to_string(mpCurveVertexBuffers.size()));
         mpScene->getMeshStaticData().getShaderDefines(defines);
         mpCurveVertexUpdatePass = ComputePass::create(mpDevice, kUpdateCurveVerticesFilename, "main", defines);
 
@@ -503,7 +543,7 @@ namespace Falcor
         auto var = block["curvePerKeyframe"];
 
         // Bind curve vertex data.
-        for (uint32_t i = 0; i < mCurveKeyframeTimes.size(); i++) var[i]["vertexData"] = mpCurveVertexBuffers[i];
+        for (uint32_t i = 0; i < mpCurveVertexBuffers.size(); i++) var[i]["vertexData"] = mpCurveVertexBuffers[i];
     }
 
     void AnimatedVertexCache::createCurveLSSAABBUpdatePass()
@@ -521,7 +561,7 @@ namespace Falcor
         FALCOR_ASSERT(mCurvePolyTubeCount > 0);
 
         DefineList defines;
-        defines.add("CURVE_KEYFRAME_COUNT", std::to_string(mCurveKeyframeTimes.size()));
+        defines.add("CURVE_KEYFRAME_COUNT", std::to_string(mpCurvePolyTubeVertexBuffers.size()));
         mpScene->getMeshStaticData().getShaderDefines(defines);
         mpCurvePolyTubeVertexUpdatePass = ComputePass::create(mpDevice, kUpdateCurvePolyTubeVerticesFilename, "main", defines);
 
@@ -532,7 +572,7 @@ namespace Falcor
         auto var = block["curvePerKeyframe"];
 
         // Bind curve vertex data.
-        for (uint32_t i = 0; i < mCurveKeyframeTimes.size(); i++) var[i]["vertexData"] = mpCurvePolyTubeVertexBuffers[i];
+        for (uint32_t i = 0; i < mpCurvePolyTubeVertexBuffers.size(); i++) var[i]["vertexData"] = mpCurvePolyTubeVertexBuffers[i];
     }
 
 
@@ -547,6 +587,9 @@ namespace Falcor
         {
             auto postInfinityBehavior = mLoopAnimations ? Animation::Behavior::Cycle : Animation::Behavior::Constant;
             mMeshInterpolationInfo[i] = calculateInterpolation(t, mCachedMeshes[i].timeSamples, mPreInfinityBehavior, postInfinityBehavior);
+
+            // Map keyframe indices to the slots holding the keyframes.
+            if (mpStreamer && !copyPrev) mMeshInterpolationInfo[i].keyframeIndices = mpStreamer->request(mMeshClipIDs[i], mMeshInterpolationInfo[i].keyframeIndices);
         }
 
         mpMeshInterpolationBuffer->setBlob(mMeshInterpolationInfo.data(), 0, mpMeshInterpolationBuffer->getSize());
@@ -28,6 +28,7 @@
 #pragma once
 #include "Animation.h"
 #include "SharedTypes.slang"
+#include "VertexCacheStreamer.h"
 #include "Core/API/Buffer.h"
 #include "Core/Pass/ComputePass.h"
 #include "Scene/Curves/CurveConfig.h"
@@ -37,6 +38,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <memory>
 #include <vector>
 
 namespace Falcor
@@ -73,7 +75,11 @@ namespace Falcor
     class FALCOR_API AnimatedVertexCache
     {
     public:
-        AnimatedVertexCache(ref<Device> pDevice, Scene* pScene, const ref<Buffer>& pPrevVertexData, std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes);
+        /** Constructor.
+            \param[in] streamKeyframes If true, keyframes are kept compressed on the CPU and streamed into a small window of GPU buffers
+                        instead of creating one GPU buffer per keyframe. This bounds GPU memory for caches with many keyframes.
+        */
+        AnimatedVertexCache(ref<Device> pDevice, Scene* pScene, const ref<Buffer>& pPrevVertexData, std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes, bool streamKeyframes = false);
         ~AnimatedVertexCache() = default;
 
         void setIsLooped(bool looped) { mLoopAnimations = looped; }
@@ -98,8 +104,17 @@ namespace Falcor
 
         uint64_t getMemoryUsageInBytes() const;
 
+        bool isStreamingKeyframes() const { return mpStreamer != nullptr; }
+
+        /** Get keyframe streaming statistics. Only valid if keyframes are streamed.
+        */
+        const VertexCacheStreamer::Stats& getStreamingStats() const { FALCOR_ASSERT(mpStreamer); return mpStreamer->getStats(); }
+
     private:
         void initCurveKeyframes();
+        void gatherCurveKeyframe(CurveTessellationMode mode, uint32_t keyframe, std::vector<DynamicCurveVertexData>& vertices) const;
+        std::vector<ref<Buffer>> createCurveKeyframeBuffers(CurveTessellationMode mode, uint32_t vertexCount, const std::string& name);
+        InterpolationInfo requestCurveKeyframes(uint32_t clipID, const InterpolationInfo& info);
         void bindCurveLSSBuffers();
         void bindCurvePolyTubeBuffers();
 
@@ -174,5 +189,12 @@ namespace Falcor
         std::vector<ref<Buffer>> mpMeshVertexBuffers;
         ref<Buffer> mpMeshInterpolationBuffer;
         ref<Buffer> mpMeshMetadataBuffer;
+
+        // Keyframe streaming. When enabled, the keyframe buffers above hold a window of slots per clip.
+        std::unique_ptr<VertexCacheStreamer> mpStreamer;
+        std::vector<std::vector<ref<Buffer>>> mStreamingSlotBuffers;    ///< Slot buffers for each streamer clip.
+        uint32_t mCurveLSSClipID = 0;
+        uint32_t mCurvePolyTubeClipID = 0;
+        std::vector<uint32_t> mMeshClipIDs;
     };
 }
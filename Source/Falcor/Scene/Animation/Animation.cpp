@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "Animation.h"
 #include "AnimationController.h"
+#include "KeyframeInterpolation.h"
 #include "Utils/ObjectIDPython.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Scripting/ScriptBindings.h"
@@ -36,8 +37,6 @@ namespace Falcor
 {
     namespace
     {
-        const double kEpsilonTime = 1e-5f;
-
         const Gui::DropdownList kChannelLoopModeDropdown =
         {
             { (uint32_t)Animation::Behavior::Constant, "Constant" },
@@ -46,63 +45,21 @@ namespace Falcor
             { (uint32_t)Animation::Behavior::Oscillate, "Oscillate" },
         };
 
-        // Bezier form hermite spline
-        float3 interpolateHermite(const float3& p0, const float3& p1, const float3& p2, const float3& p3, float t)
-        {
-            float3 b0 = p1;
-            float3 b1 = p1 + (p2 - p0) * 0.5f / 3.f;
-            float3 b2 = p2 - (p3 - p1) * 0.5f / 3.f;
-            float3 b3 = p2;
-
-            float3 q0 = lerp(b0, b1, t);
-            float3 q1 = lerp(b1, b2, t);
-            float3 q2 = lerp(b2, b3, t);
-
-            float3 qq0 = lerp(q0, q1, t);
-            float3 qq1 = lerp(q1, q2, t);
-
-            return lerp(qq0, qq1, t);
-        }
-
-        // Bezier hermite slerp
-        quatf interpolateHermite(const quatf& r0, const quatf& r1, const quatf& r2, const quatf& r3, float t)
-        {
-            quatf b0 = r1;
-            quatf b1 = r1 + (r2 - r0) * 0.5f / 3.0f;
-            quatf b2 = r2 - (r3 - r1) * 0.5f / 3.0f;
-            quatf b3 = r2;
-
-            quatf q0 = slerp(b0, b1, t);
-            quatf q1 = slerp(b1, b2, t);
-            quatf q2 = slerp(b2, b3, t);
-
-            quatf qq0 = slerp(q0, q1, t);
-            quatf qq1 = slerp(q1, q2, t);
-
-            return slerp(qq0, qq1, t);
-        }
-
-        // This function performs linear extrapolation when either t < 0 or t > 1
-        Animation::Keyframe interpolateLinear(const Animation::Keyframe& k0, const Animation::Keyframe& k1, float t)
+        /// Keyframe track of an Animation, see KeyframeInterpolation.h.
+        struct AnimationTrack
         {
-            Animation::Keyframe result;
-            result.translation = lerp(k0.translation, k1.translation, t);
-            result.scaling = lerp(k0.scaling, k1.scaling, t);
-            result.rotation = slerp(k0.rotation, k1.rotation, t);
-            result.time = math::lerp(k0.time, k1.time, (double)t);
-            return result;
-        }
+            const Animation& animation;
+            fstd::span<const Animation::Keyframe> keyframes;
 
-        Animation::Keyframe interpolateHermite(const Animation::Keyframe& k0, const Animation::Keyframe& k1, const Animation::Keyframe& k2, const Animation::Keyframe& k3, float t)
-        {
-            FALCOR_ASSERT(t >= 0.f && t <= 1.f);
-            Animation::Keyframe result;
-            result.translation = interpolateHermite(k0.translation, k1.translation, k2.translation, k3.translation, t);
-            result.scaling = lerp(k1.scaling, k2.scaling, t);
-            result.rotation = interpolateHermite(k0.rotation, k1.rotation, k2.rotation, k3.rotation, t);
-            result.time = math::lerp(k1.time, k2.time, (double)t);
-            return result;
-        }
+            size_t size() const { return keyframes.size(); }
+            double getTime(size_t i) const { return keyframes[i].time; }
+            const Animation::Keyframe& getKeyframe(size_t i) const { return keyframes[i]; }
+            double getDuration() const { return animation.getDuration(); }
+            Animation::Behavior getPreInfinityBehavior() const { return animation.getPreInfinityBehavior(); }
+            Animation::Behavior getPostInfinityBehavior() const { return animation.getPostInfinityBehavior(); }
+            Animation::InterpolationMode getInterpolationMode() const { return animation.getInterpolationMode(); }
+            bool isWarpingEnabled() const { return animation.isWarpingEnabled(); }
+        };
     }
 
     Animation::Animation(std::string_view name, NodeID nodeID, double duration)
@@ -113,149 +70,13 @@ namespace Falcor
 
     float4x4 Animation::animate(double currentTime)
     {
-        // Calculate the sample time.
-        double time = currentTime;
-        if (time < mKeyframes.front().time || time > mKeyframes.back().time)
-        {
-            time = calcSampleTime(currentTime);
-        }
-
-        // Determine if the animation behaves linearly outside of defined keyframes.
-        bool isLinearPostInfinity = time > mKeyframes.back().time && this->getPostInfinityBehavior() == Behavior::Linear;
-        bool isLinearPreInfinity = time < mKeyframes.front().time && this->getPreInfinityBehavior() == Behavior::Linear;
-
-        Keyframe interpolated;
-
-        if (isLinearPreInfinity && mKeyframes.size() > 1)
-        {
-            const auto& k0 = mKeyframes.front();
-            auto k1 = interpolate(mInterpolationMode, k0.time + kEpsilonTime);
-            double segmentDuration = k1.time - k0.time;
-            float t = (float)((time - k0.time) / segmentDuration);
-            interpolated = interpolateLinear(k0, k1, t);
-        }
-        else if (isLinearPostInfinity && mKeyframes.size() > 1)
-        {
-            const auto& k1 = mKeyframes.back();
-            auto k0 = interpolate(mInterpolationMode, k1.time - kEpsilonTime);
-            double segmentDuration = k1.time - k0.time;
-            float t = (float)((time - k0.time) / segmentDuration);
-            interpolated = interpolateLinear(k0, k1, t);
-        }
-        else
-        {
-            interpolated = interpolate(mInterpolationMode, time);
-        }
-
-        float4x4 T = math::matrixFromTranslation(interpolated.translation);
-        float4x4 R = math::matrixFromQuat(interpolated.rotation);
-        float4x4 S = math::matrixFromScaling(interpolated.scaling);
-        float4x4 transform = mul(mul(T, R), S);
-
-        return transform;
-    }
-
-    Animation::Keyframe Animation::interpolate(InterpolationMode mode, double time) const
-    {
-        FALCOR_ASSERT(!mKeyframes.empty());
-
-        // Validate cached frame index.
-        size_t frameIndex = std::clamp(mCachedFrameIndex, (size_t)0, mKeyframes.size() - 1);
-        if (time < mKeyframes[frameIndex].time) frameIndex = 0;
-
-        // Find frame index.
-        while (frameIndex < mKeyframes.size() - 1)
-        {
-            if (mKeyframes[frameIndex + 1].time > time) break;
-            frameIndex++;
-        }
-
-        // Cache frame index;
-        mCachedFrameIndex = frameIndex;
-
-        // Compute index of adjacent frame including optional warping.
-        auto adjacentFrame = [this] (size_t frame, int32_t offset = 1)
-        {
-            size_t count = mKeyframes.size();
-            return mEnableWarping ? (frame + count + offset) % count : std::clamp(frame + offset, (size_t)0, count - 1);
-        };
-
-        if (mode == InterpolationMode::Linear || mKeyframes.size() < 4)
-        {
-            size_t i0 = frameIndex;
-            size_t i1 = adjacentFrame(i0);
-
-            const Keyframe& k0 = mKeyframes[i0];
-            const Keyframe& k1 = mKeyframes[i1];
-
-            double segmentDuration = k1.time - k0.time;
-            if (mEnableWarping && segmentDuration < 0.0) segmentDuration += mDuration;
-            float t = (float)std::clamp((segmentDuration > 0.0 ? (time - k0.time) / segmentDuration : 1.0), 0.0, 1.0);
-
-            return interpolateLinear(k0, k1, t);
-        }
-        else if (mode == InterpolationMode::Hermite)
-        {
-            size_t i1 = frameIndex;
-            size_t i0 = adjacentFrame(i1, -1);
-            size_t i2 = adjacentFrame(i1, 1);
-            size_t i3 = adjacentFrame(i1, 2);
-
-            const Keyframe& k0 = mKeyframes[i0];
-            const Keyframe& k1 = mKeyframes[i1];
-            const Keyframe& k2 = mKeyframes[i2];
-            const Keyframe& k3 = mKeyframes[i3];
-
-            double segmentDuration = k2.time - k1.time;
-            if (mEnableWarping && segmentDuration < 0.0) segmentDuration += mDuration;
-            float t = (float)std::clamp(segmentDuration > 0.0 ? (time - k1.time) / segmentDuration : 1.0, 0.0, 1.0);
-
-            return interpolateHermite(k0, k1, k2, k3, t);
-        }
-        else
-        {
-            FALCOR_THROW("'mode' is unknown interpolation mode");
-        }
-    }
-
-    // Calculates the sample time within the keyframe range if the current time lies outside and
-    // the animation does not behave linearly. If the animation behaves linearly, then the
-    // current time is returned. This function should not be used if the current time lies
-    // within the range of defined keyframe times.
-    double Animation::calcSampleTime(double currentTime)
-    {
-        double modifiedTime = currentTime;
-        double firstKeyframeTime = mKeyframes.front().time;
-        double lastKeyframeTime = mKeyframes.back().time;
-        double duration = lastKeyframeTime - firstKeyframeTime;
-
-        FALCOR_ASSERT(currentTime < firstKeyframeTime || currentTime > lastKeyframeTime);
-
-        Behavior behavior = (currentTime < firstKeyframeTime) ? mPreInfinityBehavior : mPostInfinityBehavior;
-        switch (behavior)
-        {
-        case Behavior::Constant:
-            modifiedTime = std::clamp(currentTime, firstKeyframeTime, lastKeyframeTime);
-            break;
-        case Behavior::Cycle:
-            // Calculate the relative time
-            modifiedTime = firstKeyframeTime + std::fmod(currentTime - firstKeyframeTime, duration);
-            if (modifiedTime < firstKeyframeTime) modifiedTime += duration;
-            break;
-        case Behavior::Oscillate:
-            // Calculate the relative time
-            double offset = std::fmod(currentTime - firstKeyframeTime, 2 * duration);
-            if (offset < 0) offset += 2 * duration;
-            if (offset > duration) offset = 2 * duration - offset;
-            modifiedTime = firstKeyframeTime + offset;
-        }
-
-        return modifiedTime;
+        return detail::animate(AnimationTrack{ *this, mKeyframes }, currentTime, mCachedFrameIndex);
     }
 
     void Animation::addKeyframe(const Keyframe& keyframe)
     {
         FALCOR_ASSERT(keyframe.time <= mDuration);
+        mKeyframesVersion++;
 
         if (mKeyframes.size() == 0 || mKeyframes[0].time > keyframe.time)
         {
@@ -143,6 +143,10 @@ namespace Falcor
         */
         fstd::span<const Keyframe> getKeyframes() const { return mKeyframes; }
 
+        /** Get a counter that is incremented whenever a keyframe is added or replaced.
+        */
+        uint32_t getKeyframesVersion() const { return mKeyframesVersion; }
+
         /** Check if a keyframe exists at the specified time.
             \param[in] time Time of the keyframe.
             \return Returns true if keyframe exists.
@@ -160,9 +164,6 @@ namespace Falcor
         void renderUI(Gui::Widgets& widget);
 
     private:
-        Keyframe interpolate(InterpolationMode mode, double time) const;
-        double calcSampleTime(double currentTime);
-
         std::string mName;
         NodeID mNodeID;
         double mDuration; // Includes any time before the first keyframe. May be Assimp or FBX specific.
@@ -175,6 +176,7 @@ namespace Falcor
 
         std::vector<Keyframe> mKeyframes;
         mutable size_t mCachedFrameIndex = 0;
+        uint32_t mKeyframesVersion = 0;
 
         friend class SceneCache;
     };
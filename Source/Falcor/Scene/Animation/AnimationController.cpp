@@ -51,6 +51,14 @@ namespace Falcor
         , mMatricesChanged(pScene->mSceneGraph.size())
         , mpScene(pScene)
     {
+        std::vector<uint32_t> parents(pScene->mSceneGraph.size());
+        for (size_t i = 0; i < parents.size(); i++)
+        {
+            NodeID parent = pScene->mSceneGraph[i].parent;
+            parents[i] = parent.isValid() ? parent.get() : TransformHierarchy::kInvalidNode;
+        }
+        mTransformHierarchy = TransformHierarchy(parents);
+
         // Create GPU resources.
         FALCOR_ASSERT(mLocalMatrices.size() <= std::numeric_limits<uint32_t>::max());
 
@@ -93,7 +101,7 @@ namespace Falcor
         }
     }
 
-    void AnimationController::addAnimatedVertexCaches(std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes)
+    void AnimationController::addAnimatedVertexCaches(std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes, bool streamKeyframes)
     {
         size_t totalAnimatedMeshVertexCount = 0;
 
@@ -158,7 +166,7 @@ namespace Falcor
             mpPrevVertexData->setBlob(prevVertexData.data(), byteOffset, prevVertexData.size() * sizeof(PrevVertexData));
         }
 
-        mpVertexCache = std::make_unique<AnimatedVertexCache>(mpDevice, mpScene, mpPrevVertexData, std::move(cachedCurves), std::move(cachedMeshes));
+        mpVertexCache = std::make_unique<AnimatedVertexCache>(mpDevice, mpScene, mpPrevVertexData, std::move(cachedCurves), std::move(cachedMeshes), streamKeyframes);
 
         // Note: It is a workaround to have two pre-infinity behaviors for the cached animation.
         // We need `Cycle` behavior when the length of cached animation is smaller than the length of mesh animation (e.g., tiger forest).
@@ -197,6 +205,7 @@ namespace Falcor
         FALCOR_PROFILE(pRenderContext, "animate");
 
         std::fill(mMatricesChanged.begin(), mMatricesChanged.end(), false);
+        mChangedMatrixRanges.clear();
 
         // Check for edited scene nodes and update local matrices.
         const auto& sceneGraph = mpScene->mSceneGraph;
@@ -291,44 +300,32 @@ namespace Falcor
 
     void AnimationController::updateLocalMatrices(double time)
     {
-        for (auto& pAnimation : mAnimations)
+        mAnimationEvaluator.evaluate(mAnimations, time);
+        const auto& transforms = mAnimationEvaluator.getTransforms();
+
+        for (size_t i = 0; i < mAnimations.size(); i++)
         {
-            NodeID nodeID = pAnimation->getNodeID();
+            NodeID nodeID = mAnimations[i]->getNodeID();
             FALCOR_ASSERT(nodeID.get() < mLocalMatrices.size());
-            mLocalMatrices[nodeID.get()] = pAnimation->animate(time);
+            mLocalMatrices[nodeID.get()] = transforms[i];
             mMatricesChanged[nodeID.get()] = true;
         }
     }
 
     void AnimationController::updateWorldMatrices(bool updateAll)
     {
-        const auto& sceneGraph = mpScene->mSceneGraph;
-
-        for (size_t i = 0; i < mGlobalMatrices.size(); i++)
+        TransformHierarchy::Matrices matrices;
+        matrices.pLocal = mLocalMatrices.data();
+        matrices.pGlobal = mGlobalMatrices.data();
+        matrices.pInvTransposeGlobal = mInvTransposeGlobalMatrices.data();
+        if (mpSkinningPass)
         {
-            // Propagate matrix change flag to children.
-            if (sceneGraph[i].parent != NodeID::Invalid())
-            {
-                mMatricesChanged[i] = mMatricesChanged[i] || mMatricesChanged[sceneGraph[i].parent.get()];
-            }
-
-            if (!mMatricesChanged[i] && !updateAll) continue;
-
-            mGlobalMatrices[i] = mLocalMatrices[i];
-
-            if (mpScene->mSceneGraph[i].parent != NodeID::Invalid())
-            {
-                mGlobalMatrices[i] = mul(mGlobalMatrices[sceneGraph[i].parent.get()], mGlobalMatrices[i]);
-            }
-
-            mInvTransposeGlobalMatrices[i] = transpose(inverse(mGlobalMatrices[i]));
-
-            if (mpSkinningPass)
-            {
-                mSkinningMatrices[i] = mul(mGlobalMatrices[i], sceneGraph[i].localToBindSpace);
-                mInvTransposeSkinningMatrices[i] = transpose(inverse(mSkinningMatrices[i]));
-            }
+            matrices.pLocalToBind = mLocalToBindMatrices.data();
+            matrices.pSkinning = mSkinningMatrices.data();
+            matrices.pInvTransposeSkinning = mInvTransposeSkinningMatrices.data();
         }
+        mTransformHierarchy.update(matrices, mMatricesChanged.data(), updateAll);
+        mChangedMatrixRanges = mTransformHierarchy.getChangedRanges();
     }
 
     void AnimationController::uploadWorldMatrices(bool uploadAll)
@@ -346,21 +343,11 @@ namespace Falcor
         }
         else
         {
-            // Upload changed matrices only.
-            for (size_t i = 0; i < mGlobalMatrices.size();)
+            // Upload the ranges of changed matrices only.
+            for (const auto& range : mChangedMatrixRanges)
             {
-                // Detect ranges of consecutive matrices that have all changed or not.
-                size_t offset = i;
-                bool changed = mMatricesChanged[i];
-                while (i < mGlobalMatrices.size() && mMatricesChanged[i] == changed) ++i;
-
-                // Upload range of changed matrices.
-                if (changed)
-                {
-                    size_t count = i - offset;
-                    mpWorldMatricesBuffer->setBlob(&mGlobalMatrices[offset], offset * sizeof(float4x4), count * sizeof(float4x4));
-                    mpInvTransposeWorldMatricesBuffer->setBlob(&mInvTransposeGlobalMatrices[offset], offset * sizeof(float4x4), count * sizeof(float4x4));
-                }
+                mpWorldMatricesBuffer->setBlob(&mGlobalMatrices[range.offset], range.offset * sizeof(float4x4), range.count * sizeof(float4x4));
+                mpInvTransposeWorldMatricesBuffer->setBlob(&mInvTransposeGlobalMatrices[range.offset], range.offset * sizeof(float4x4), range.count * sizeof(float4x4));
             }
         }
     }
@@ -398,6 +385,8 @@ namespace Falcor
         {
             const SplitVertexBuffer& staticVertexData = mpScene->getMeshStaticData();
 
+            mLocalToBindMatrices.resize(mpScene->mSceneGraph.size());
+            for (size_t i = 0; i < mLocalToBindMatrices.size(); i++) mLocalToBindMatrices[i] = mpScene->mSceneGraph[i].localToBindSpace;
             mSkinningMatrices.resize(mpScene->mSceneGraph.size());
             mInvTransposeSkinningMatrices.resize(mSkinningMatrices.size());
             mMeshBindMatrices.resize(mpScene->mSceneGraph.size());
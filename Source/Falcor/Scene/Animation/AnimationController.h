@@ -27,7 +27,9 @@
  **************************************************************************/
 #pragma once
 #include "Animation.h"
+#include "AnimationEvaluator.h"
 #include "AnimatedVertexCache.h"
+#include "TransformHierarchy.h"
 #include "Core/Macros.h"
 #include "Core/API/Buffer.h"
 #include "Core/Pass/ComputePass.h"
@@ -55,8 +57,9 @@ namespace Falcor
         AnimationController(ref<Device> pDevice, Scene* pScene, const SkinningVertexVector& skinningVertexData, uint32_t prevVertexCount, const std::vector<ref<Animation>>& animations);
 
         /** Add animated vertex caches (curves and meshes) to the controller.
+            \param[in] streamKeyframes Stream keyframes to the GPU on demand instead of uploading all of them.
         */
-        void addAnimatedVertexCaches(std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes);
+        void addAnimatedVertexCaches(std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes, bool streamKeyframes = false);
 
         /** Returns true if controller contains animations.
         */
@@ -110,7 +113,12 @@ namespace Falcor
 
         /** Check if a matrix changed since last frame.
         */
-        bool isMatrixChanged(NodeID matrixID) const { return mMatricesChanged[matrixID.get()]; }
+        bool isMatrixChanged(NodeID matrixID) const { return mMatricesChanged[matrixID.get()] != 0; }
+
+        /** Get the ranges of consecutive matrices that changed since last frame.
+            The ranges cover exactly the matrices for which isMatrixChanged() returns true.
+        */
+        const std::vector<TransformHierarchy::Range>& getChangedMatrixRanges() const { return mChangedMatrixRanges; }
 
         /** Get the local matrices.
             These represent the current local transform for each scene graph node.
@@ -162,11 +170,14 @@ namespace Falcor
 
         // Animation
         std::vector<ref<Animation>> mAnimations;
+        AnimationEvaluator mAnimationEvaluator;
         std::vector<bool> mNodesEdited;
         std::vector<float4x4> mLocalMatrices;
         std::vector<float4x4> mGlobalMatrices;
         std::vector<float4x4> mInvTransposeGlobalMatrices;
-        std::vector<bool> mMatricesChanged;         ///< Flag per matrix, true if matrix changed since last frame.
+        std::vector<uint8_t> mMatricesChanged;      ///< Flag per matrix, non-zero if matrix changed since last frame. Bytes rather than bits so that nodes can be updated concurrently.
+        TransformHierarchy mTransformHierarchy;     ///< Scene graph levels used to update the global matrices.
+        std::vector<TransformHierarchy::Range> mChangedMatrixRanges; ///< Ranges of matrices changed since last frame.
 
         bool mFirstUpdate = true;       ///< True if this is the first update.
         bool mEnabled = true;           ///< True if animations are enabled.
@@ -186,6 +197,7 @@ namespace Falcor
         // Skinning
         ref<ComputePass> mpSkinningPass;
         std::vector<float4x4> mMeshBindMatrices; // Optimization TODO: These are only needed per mesh
+        std::vector<float4x4> mLocalToBindMatrices;
         std::vector<float4x4> mSkinningMatrices;
         std::vector<float4x4> mInvTransposeSkinningMatrices;
         uint32_t mSkinningDispatchSize = 0;
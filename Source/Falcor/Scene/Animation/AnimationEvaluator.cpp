@@ -0,0 +1,140 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AnimationEvaluator.h"
+#include "KeyframeInterpolation.h"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <execution>
+#include <limits>
+
+namespace Falcor
+{
+    namespace
+    {
+        /// Number of animations evaluated per task.
+        const uint32_t kTaskSize = 256;
+
+        /// Keyframe track stored in the packed buffers, see KeyframeInterpolation.h.
+        struct PackedTrack
+        {
+            const Animation& animation;
+            const double* pTimes;
+            const float3* pTranslations;
+            const float3* pScalings;
+            const quatf* pRotations;
+            size_t count;
+
+            size_t size() const { return count; }
+            double getTime(size_t i) const { return pTimes[i]; }
+            Animation::Keyframe getKeyframe(size_t i) const { return { pTimes[i], pTranslations[i], pScalings[i], pRotations[i] }; }
+            double getDuration() const { return animation.getDuration(); }
+            Animation::Behavior getPreInfinityBehavior() const { return animation.getPreInfinityBehavior(); }
+            Animation::Behavior getPostInfinityBehavior() const { return animation.getPostInfinityBehavior(); }
+            Animation::InterpolationMode getInterpolationMode() const { return animation.getInterpolationMode(); }
+            bool isWarpingEnabled() const { return animation.isWarpingEnabled(); }
+        };
+    }
+
+    void AnimationEvaluator::evaluate(const std::vector<ref<Animation>>& animations, double time, bool parallel)
+    {
+        if (needsRepack(animations)) packKeyframes(animations);
+
+        auto evalTask = [&](uint32_t task)
+        {
+            // Interpolate the keyframes of the task's tracks first and then compute all transforms with the batch math kernels.
+            Animation::Keyframe keyframes[kTaskSize];
+            const uint32_t begin = task * kTaskSize;
+            const uint32_t end = std::min((uint32_t)mTracks.size(), begin + kTaskSize);
+            for (uint32_t i = begin; i < end; i++)
+            {
+                Track& track = mTracks[i];
+                const uint32_t offset = track.keyframeOffset;
+                PackedTrack packed{ *track.pAnimation, &mTimes[offset], &mTranslations[offset], &mScalings[offset], &mRotations[offset], track.keyframeCount };
+                keyframes[i - begin] = detail::interpolateTrack(packed, time, track.cachedFrameIndex);
+            }
+            detail::composeTransforms(keyframes, &mTransforms[begin], end - begin);
+        };
+
+        NumericRange<uint32_t> range(0, ((uint32_t)mTracks.size() + kTaskSize - 1) / kTaskSize);
+        if (parallel)
+            std::for_each(std::execution::par, range.begin(), range.end(), evalTask);
+        else
+            std::for_each(range.begin(), range.end(), evalTask);
+    }
+
+    bool AnimationEvaluator::needsRepack(const std::vector<ref<Animation>>& animations) const
+    {
+        if (animations.size() != mTracks.size()) return true;
+        for (size_t i = 0; i < animations.size(); i++)
+        {
+            if (animations[i].get() != mTracks[i].pAnimation || animations[i]->getKeyframesVersion() != mTracks[i].keyframesVersion) return true;
+        }
+        return false;
+    }
+
+    void AnimationEvaluator::packKeyframes(const std::vector<ref<Animation>>& animations)
+    {
+        size_t keyframeCount = 0;
+        for (const auto& pAnimation : animations)
+        {
+            FALCOR_CHECK(!pAnimation->getKeyframes().empty(), "Animation '{}' has no keyframes.", pAnimation->getName());
+            keyframeCount += pAnimation->getKeyframes().size();
+        }
+        FALCOR_CHECK(keyframeCount <= std::numeric_limits<uint32_t>::max(), "Too many keyframes.");
+
+        mTimes.clear();
+        mTranslations.clear();
+        mScalings.clear();
+        mRotations.clear();
+        mTimes.reserve(keyframeCount);
+        mTranslations.reserve(keyframeCount);
+        mScalings.reserve(keyframeCount);
+        mRotations.reserve(keyframeCount);
+
+        mTracks.resize(animations.size());
+        for (size_t i = 0; i < animations.size(); i++)
+        {
+            Track& track = mTracks[i];
+            track.pAnimation = animations[i].get();
+            track.keyframesVersion = track.pAnimation->getKeyframesVersion();
+            track.keyframeOffset = (uint32_t)mTimes.size();
+            track.keyframeCount = (uint32_t)track.pAnimation->getKeyframes().size();
+            track.cachedFrameIndex = 0;
+
+            for (const auto& keyframe : track.pAnimation->getKeyframes())
+            {
+                mTimes.push_back(keyframe.time);
+                mTranslations.push_back(keyframe.translation);
+                mScalings.push_back(keyframe.scaling);
+                mRotations.push_back(keyframe.rotation);
+            }
+        }
+
+        mTransforms.resize(animations.size());
+    }
+}
@@ -0,0 +1,80 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Animation.h"
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include "Utils/Math/Matrix.h"
+#include "Utils/Math/Quaternion.h"
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+    /** Evaluates a set of animations in one pass.
+
+        The keyframes of all animations are packed into contiguous structure-of-arrays buffers,
+        and the animations are evaluated in parallel. The results are identical to calling
+        Animation::animate() on each animation, including the pre/post-infinity behaviors and warping.
+        The keyframes are repacked automatically when the list of animations or their keyframes change.
+    */
+    class FALCOR_API AnimationEvaluator
+    {
+    public:
+        /** Evaluate the animations.
+            \param[in] animations List of animations.
+            \param[in] time The current time in seconds.
+            \param[in] parallel Evaluate the animations on multiple threads.
+        */
+        void evaluate(const std::vector<ref<Animation>>& animations, double time, bool parallel = true);
+
+        /** Get the transforms computed by the last call to evaluate(), one per animation.
+        */
+        const std::vector<float4x4>& getTransforms() const { return mTransforms; }
+
+    private:
+        struct Track
+        {
+            const Animation* pAnimation = nullptr;
+            uint32_t keyframesVersion = 0;
+            uint32_t keyframeOffset = 0;
+            uint32_t keyframeCount = 0;
+            size_t cachedFrameIndex = 0;
+        };
+
+        bool needsRepack(const std::vector<ref<Animation>>& animations) const;
+        void packKeyframes(const std::vector<ref<Animation>>& animations);
+
+        std::vector<Track> mTracks;
+        std::vector<double> mTimes;
+        std::vector<float3> mTranslations;
+        std::vector<float3> mScalings;
+        std::vector<quatf> mRotations;
+        std::vector<float4x4> mTransforms;
+    };
+}
@@ -0,0 +1,300 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Animation.h"
+#include "Core/Error.h"
+#include "Utils/Math/BatchMath.h"
+#include "Utils/Math/Common.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Falcor
+{
+    /** Keyframe interpolation shared by Animation and AnimationEvaluator.
+        The functions are templated on a track type that provides access to the keyframes and settings of one animation:
+
+            size_t size() const;                                    // Number of keyframes.
+            double getTime(size_t i) const;                         // Time of keyframe i.
+            Animation::Keyframe getKeyframe(size_t i) const;        // Keyframe i.
+            double getDuration() const;
+            Animation::Behavior getPreInfinityBehavior() const;
+            Animation::Behavior getPostInfinityBehavior() const;
+            Animation::InterpolationMode getInterpolationMode() const;
+            bool isWarpingEnabled() const;
+    */
+    namespace detail
+    {
+        const double kEpsilonTime = 1e-5f;
+
+        // Bezier form hermite spline
+        inline float3 interpolateHermite(const float3& p0, const float3& p1, const float3& p2, const float3& p3, float t)
+        {
+            float3 b0 = p1;
+            float3 b1 = p1 + (p2 - p0) * 0.5f / 3.f;
+            float3 b2 = p2 - (p3 - p1) * 0.5f / 3.f;
+            float3 b3 = p2;
+
+            float3 q0 = lerp(b0, b1, t);
+            float3 q1 = lerp(b1, b2, t);
+            float3 q2 = lerp(b2, b3, t);
+
+            float3 qq0 = lerp(q0, q1, t);
+            float3 qq1 = lerp(q1, q2, t);
+
+            return lerp(qq0, qq1, t);
+        }
+
+        // Bezier hermite slerp
+        inline quatf interpolateHermite(const quatf& r0, const quatf& r1, const quatf& r2, const quatf& r3, float t)
+        {
+            quatf b0 = r1;
+            quatf b1 = r1 + (r2 - r0) * 0.5f / 3.0f;
+            quatf b2 = r2 - (r3 - r1) * 0.5f / 3.0f;
+            quatf b3 = r2;
+
+            quatf q0 = slerp(b0, b1, t);
+            quatf q1 = slerp(b1, b2, t);
+            quatf q2 = slerp(b2, b3, t);
+
+            quatf qq0 = slerp(q0, q1, t);
+            quatf qq1 = slerp(q1, q2, t);
+
+            return slerp(qq0, qq1, t);
+        }
+
+        // This function performs linear extrapolation when either t < 0 or t > 1
+        inline Animation::Keyframe interpolateLinear(const Animation::Keyframe& k0, const Animation::Keyframe& k1, float t)
+        {
+            Animation::Keyframe result;
+            result.translation = lerp(k0.translation, k1.translation, t);
+            result.scaling = lerp(k0.scaling, k1.scaling, t);
+            result.rotation = slerp(k0.rotation, k1.rotation, t);
+            result.time = math::lerp(k0.time, k1.time, (double)t);
+            return result;
+        }
+
+        inline Animation::Keyframe interpolateHermite(const Animation::Keyframe& k0, const Animation::Keyframe& k1, const Animation::Keyframe& k2, const Animation::Keyframe& k3, float t)
+        {
+            FALCOR_ASSERT(t >= 0.f && t <= 1.f);
+            Animation::Keyframe result;
+            result.translation = interpolateHermite(k0.translation, k1.translation, k2.translation, k3.translation, t);
+            result.scaling = lerp(k1.scaling, k2.scaling, t);
+            result.rotation = interpolateHermite(k0.rotation, k1.rotation, k2.rotation, k3.rotation, t);
+            result.time = math::lerp(k1.time, k2.time, (double)t);
+            return result;
+        }
+
+        /** Interpolate the keyframes of a track.
+            \param[in] track Keyframe track.
+            \param[in] mode Interpolation mode.
+            \param[in] time Sample time.
+            \param[in,out] cachedFrameIndex Index of the keyframe found by the previous call. Used as the start of the search.
+        */
+        template<typename Track>
+        Animation::Keyframe interpolate(const Track& track, Animation::InterpolationMode mode, double time, size_t& cachedFrameIndex)
+        {
+            const size_t count = track.size();
+            FALCOR_ASSERT(count > 0);
+
+            // Validate cached frame index.
+            size_t frameIndex = std::clamp(cachedFrameIndex, (size_t)0, count - 1);
+            if (time < track.getTime(frameIndex)) frameIndex = 0;
+
+            // Find frame index.
+            while (frameIndex < count - 1)
+            {
+                if (track.getTime(frameIndex + 1) > time) break;
+                frameIndex++;
+            }
+
+            // Cache frame index;
+            cachedFrameIndex = frameIndex;
+
+            // Compute index of adjacent frame including optional warping.
+            const bool enableWarping = track.isWarpingEnabled();
+            auto adjacentFrame = [count, enableWarping] (size_t frame, int32_t offset = 1)
+            {
+                return enableWarping ? (frame + count + offset) % count : std::clamp(frame + offset, (size_t)0, count - 1);
+            };
+
+            if (mode == Animation::InterpolationMode::Linear || count < 4)
+            {
+                size_t i0 = frameIndex;
+                size_t i1 = adjacentFrame(i0);
+
+                const Animation::Keyframe k0 = track.getKeyframe(i0);
+                const Animation::Keyframe k1 = track.getKeyframe(i1);
+
+                double segmentDuration = k1.time - k0.time;
+                if (enableWarping && segmentDuration < 0.0) segmentDuration += track.getDuration();
+                float t = (float)std::clamp((segmentDuration > 0.0 ? (time - k0.time) / segmentDuration : 1.0), 0.0, 1.0);
+
+                return interpolateLinear(k0, k1, t);
+            }
+            else if (mode == Animation::InterpolationMode::Hermite)
+            {
+                size_t i1 = frameIndex;
+                size_t i0 = adjacentFrame(i1, -1);
+                size_t i2 = adjacentFrame(i1, 1);
+                size_t i3 = adjacentFrame(i1, 2);
+
+                const Animation::Keyframe k0 = track.getKeyframe(i0);
+                const Animation::Keyframe k1 = track.getKeyframe(i1);
+                const Animation::Keyframe k2 = track.getKeyframe(i2);
+                const Animation::Keyframe k3 = track.getKeyframe(i3);
+
+                double segmentDuration = k2.time - k1.time;
+                if (enableWarping && segmentDuration < 0.0) segmentDuration += track.getDuration();
+                float t = (float)std::clamp(segmentDuration > 0.0 ? (time - k1.time) / segmentDuration : 1.0, 0.0, 1.0);
+
+                return interpolateHermite(k0, k1, k2, k3, t);
+            }
+            else
+            {
+                FALCOR_THROW("'mode' is unknown interpolation mode");
+            }
+        }
+
+        // Calculates the sample time within the keyframe range if the current time lies outside and
+        // the animation does not behave linearly. If the animation behaves linearly, then the
+        // current time is returned. This function should not be used if the current time lies
+        // within the range of defined keyframe times.
+        template<typename Track>
+        double calcSampleTime(const Track& track, double currentTime)
+        {
+            double modifiedTime = currentTime;
+            double firstKeyframeTime = track.getTime(0);
+            double lastKeyframeTime = track.getTime(track.size() - 1);
+            double duration = lastKeyframeTime - firstKeyframeTime;
+
+            FALCOR_ASSERT(currentTime < firstKeyframeTime || currentTime > lastKeyframeTime);
+
+            Animation::Behavior behavior = (currentTime < firstKeyframeTime) ? track.getPreInfinityBehavior() : track.getPostInfinityBehavior();
+            switch (behavior)
+            {
+            case Animation::Behavior::Constant:
+                modifiedTime = std::clamp(currentTime, firstKeyframeTime, lastKeyframeTime);
+                break;
+            case Animation::Behavior::Cycle:
+                // Calculate the relative time
+                modifiedTime = firstKeyframeTime + std::fmod(currentTime - firstKeyframeTime, duration);
+                if (modifiedTime < firstKeyframeTime) modifiedTime += duration;
+                break;
+            case Animation::Behavior::Oscillate:
+            {
+                // Calculate the relative time
+                double offset = std::fmod(currentTime - firstKeyframeTime, 2 * duration);
+                if (offset < 0) offset += 2 * duration;
+                if (offset > duration) offset = 2 * duration - offset;
+                modifiedTime = firstKeyframeTime + offset;
+                break;
+            }
+            default:
+                break;
+            }
+
+            return modifiedTime;
+        }
+
+        /** Compute the interpolated keyframe of a track at the specified time.
+            \param[in] track Keyframe track.
+            \param[in] currentTime The current time in seconds.
+            \param[in,out] cachedFrameIndex Index of the keyframe found by the previous call.
+            \return The animation's keyframe for the specified time.
+        */
+        template<typename Track>
+        Animation::Keyframe interpolateTrack(const Track& track, double currentTime, size_t& cachedFrameIndex)
+        {
+            const double firstTime = track.getTime(0);
+            const double lastTime = track.getTime(track.size() - 1);
+            const Animation::InterpolationMode mode = track.getInterpolationMode();
+
+            // Calculate the sample time.
+            double time = currentTime;
+            if (time < firstTime || time > lastTime)
+            {
+                time = calcSampleTime(track, currentTime);
+            }
+
+            // Determine if the animation behaves linearly outside of defined keyframes.
+            bool isLinearPostInfinity = time > lastTime && track.getPostInfinityBehavior() == Animation::Behavior::Linear;
+            bool isLinearPreInfinity = time < firstTime && track.getPreInfinityBehavior() == Animation::Behavior::Linear;
+
+            Animation::Keyframe interpolated;
+
+            if (isLinearPreInfinity && track.size() > 1)
+            {
+                const auto k0 = track.getKeyframe(0);
+                auto k1 = interpolate(track, mode, k0.time + kEpsilonTime, cachedFrameIndex);
+                double segmentDuration = k1.time - k0.time;
+                float t = (float)((time - k0.time) / segmentDuration);
+                interpolated = interpolateLinear(k0, k1, t);
+            }
+            else if (isLinearPostInfinity && track.size() > 1)
+            {
+                const auto k1 = track.getKeyframe(track.size() - 1);
+                auto k0 = interpolate(track, mode, k1.time - kEpsilonTime, cachedFrameIndex);
+                double segmentDuration = k1.time - k0.time;
+                float t = (float)((time - k0.time) / segmentDuration);
+                interpolated = interpolateLinear(k0, k1, t);
+            }
+            else
+            {
+                interpolated = interpolate(track, mode, time, cachedFrameIndex);
+            }
+
+            return interpolated;
+        }
+
+        /** Compute the transforms of interpolated keyframes.
+            Translation * rotation * scaling is composed directly instead of multiplying the 4x4 matrices.
+            \param[in] pKeyframes Keyframes.
+            \param[out] pTransforms Transform matrices.
+            \param[in] count Number of keyframes.
+        */
+        inline void composeTransforms(const Animation::Keyframe* pKeyframes, float4x4* pTransforms, size_t count)
+        {
+            math::composeTransforms(&pKeyframes->translation, &pKeyframes->rotation, &pKeyframes->scaling, sizeof(Animation::Keyframe), pTransforms, count);
+        }
+
+        /** Compute the transform of a track at the specified time.
+            \param[in] track Keyframe track.
+            \param[in] currentTime The current time in seconds.
+            \param[in,out] cachedFrameIndex Index of the keyframe found by the previous call.
+            \return The animation's transform matrix for the specified time.
+        */
+        template<typename Track>
+        float4x4 animate(const Track& track, double currentTime, size_t& cachedFrameIndex)
+        {
+            const Animation::Keyframe interpolated = interpolateTrack(track, currentTime, cachedFrameIndex);
+            float4x4 transform;
+            composeTransforms(&interpolated, &transform, 1);
+            return transform;
+        }
+    }
+}
@@ -0,0 +1,203 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TransformHierarchy.h"
+#include "Core/Error.h"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <execution>
+
+namespace Falcor
+{
+    namespace
+    {
+        /// Number of consecutive nodes per segment. A node is in the same level as its parent if both are in the same segment and the parent comes first.
+        const uint32_t kSegmentSize = 1024;
+        /// Minimum number of nodes per task.
+        const uint32_t kTaskSize = 1024;
+
+        bool isAffine(const float4x4& m)
+        {
+            return m[3][0] == 0.f && m[3][1] == 0.f && m[3][2] == 0.f && m[3][3] == 1.f;
+        }
+
+        /** Multiply two affine matrices. Only the upper 3x4 part is computed, one float4 row at a time.
+        */
+        float4x4 mulAffine(const float4x4& a, const float4x4& b)
+        {
+            float4x4 r;
+            for (int i = 0; i < 3; i++)
+            {
+                r[i] = a[i][0] * b[0] + a[i][1] * b[1] + a[i][2] * b[2] + float4(0.f, 0.f, 0.f, a[i][3]);
+            }
+            return r;
+        }
+
+        /** Compute the inverse transpose of an affine matrix.
+            The rows of the inverse transpose of the 3x3 part are the cross products of the rows of the 3x3 part divided by the determinant.
+            The translation of the inverse ends up in the last row.
+        */
+        float4x4 inverseTransposeAffine(const float4x4& m)
+        {
+            const float3 r0 = m[0].xyz();
+            const float3 r1 = m[1].xyz();
+            const float3 r2 = m[2].xyz();
+            float3 c0 = cross(r1, r2);
+            float3 c1 = cross(r2, r0);
+            float3 c2 = cross(r0, r1);
+            const float invDet = 1.f / dot(r0, c0);
+            c0 *= invDet;
+            c1 *= invDet;
+            c2 *= invDet;
+            const float3 t = -(c0 * m[0][3] + c1 * m[1][3] + c2 * m[2][3]);
+
+            float4x4 r;
+            r[0] = float4(c0, 0.f);
+            r[1] = float4(c1, 0.f);
+            r[2] = float4(c2, 0.f);
+            r[3] = float4(t, 1.f);
+            return r;
+        }
+
+        float4x4 mulTransform(const float4x4& a, const float4x4& b)
+        {
+            return isAffine(a) && isAffine(b) ? mulAffine(a, b) : mul(a, b);
+        }
+
+        float4x4 inverseTransposeTransform(const float4x4& m)
+        {
+            return isAffine(m) ? inverseTransposeAffine(m) : transpose(inverse(m));
+        }
+    }
+
+    TransformHierarchy::TransformHierarchy(const std::vector<uint32_t>& parents)
+        : mParents(parents)
+    {
+        FALCOR_CHECK(parents.size() < kInvalidNode, "Too many scene graph nodes.");
+        const uint32_t nodeCount = (uint32_t)parents.size();
+
+        // Compute the level of each node. This is the depth of the node in the hierarchy, except that edges to a parent
+        // earlier in the same segment do not count. Such nodes are processed right after their parent by the same task,
+        // which keeps the memory accesses sequential for the common case of hierarchies stored in depth-first order.
+        // Parents are usually stored before their children, but walk up the hierarchy to handle any order.
+        auto isLocal = [](uint32_t node, uint32_t parent) { return parent < node && parent / kSegmentSize == node / kSegmentSize; };
+        std::vector<uint32_t> levels(nodeCount, kInvalidNode);
+        std::vector<uint32_t> stack;
+        uint32_t levelCount = 0;
+        for (uint32_t i = 0; i < nodeCount; i++)
+        {
+            uint32_t node = i;
+            while (levels[node] == kInvalidNode)
+            {
+                FALCOR_CHECK(stack.size() < nodeCount, "Scene graph contains a cycle.");
+                stack.push_back(node);
+                const uint32_t parent = parents[node];
+                if (parent == kInvalidNode) break;
+                FALCOR_CHECK(parent < nodeCount, "Scene graph node {} has invalid parent {}.", node, parent);
+                node = parent;
+            }
+            while (!stack.empty())
+            {
+                const uint32_t n = stack.back();
+                stack.pop_back();
+                const uint32_t parent = parents[n];
+                levels[n] = parent == kInvalidNode ? 0 : levels[parent] + (isLocal(n, parent) ? 0 : 1);
+            }
+            levelCount = std::max(levelCount, levels[i] + 1);
+        }
+
+        // Sort the nodes by level with a counting sort. Nodes keep their index order within a level.
+        std::vector<uint32_t> levelOffsets(levelCount + 1, 0);
+        for (uint32_t l : levels) levelOffsets[l + 1]++;
+        for (uint32_t l = 0; l < levelCount; l++) levelOffsets[l + 1] += levelOffsets[l];
+        mLevelNodes.resize(nodeCount);
+        std::vector<uint32_t> cursor(levelOffsets.begin(), levelOffsets.end() - 1);
+        for (uint32_t i = 0; i < nodeCount; i++) mLevelNodes[cursor[levels[i]]++] = i;
+
+        // Split the levels into tasks. Tasks start at segment boundaries so that nodes depending on a node in the same level stay in its task.
+        mLevelTaskOffsets.push_back(0);
+        for (uint32_t l = 0; l < levelCount; l++)
+        {
+            for (uint32_t j = levelOffsets[l]; j < levelOffsets[l + 1]; j++)
+            {
+                const bool levelStart = j == levelOffsets[l];
+                const bool segmentStart = levelStart || mLevelNodes[j] / kSegmentSize != mLevelNodes[j - 1] / kSegmentSize;
+                if (levelStart || (segmentStart && j - mTaskOffsets.back() >= kTaskSize)) mTaskOffsets.push_back(j);
+            }
+            mLevelTaskOffsets.push_back((uint32_t)mTaskOffsets.size());
+        }
+        mTaskOffsets.push_back(nodeCount);
+    }
+
+    void TransformHierarchy::update(const Matrices& matrices, uint8_t* changed, bool updateAll, bool parallel)
+    {
+        FALCOR_ASSERT(matrices.pLocal && matrices.pGlobal && matrices.pInvTransposeGlobal && changed);
+        const bool skinning = matrices.pSkinning != nullptr;
+        FALCOR_ASSERT(!skinning || (matrices.pLocalToBind && matrices.pInvTransposeSkinning));
+
+        auto updateTask = [&](uint32_t task)
+        {
+            for (uint32_t j = mTaskOffsets[task]; j < mTaskOffsets[task + 1]; j++)
+            {
+                const uint32_t i = mLevelNodes[j];
+                const uint32_t parent = mParents[i];
+                if (parent != kInvalidNode) changed[i] |= changed[parent];
+                if (!changed[i] && !updateAll) continue;
+
+                const float4x4& global = parent != kInvalidNode ? (matrices.pGlobal[i] = mulTransform(matrices.pGlobal[parent], matrices.pLocal[i]))
+                                                                : (matrices.pGlobal[i] = matrices.pLocal[i]);
+                matrices.pInvTransposeGlobal[i] = inverseTransposeTransform(global);
+
+                if (skinning)
+                {
+                    matrices.pSkinning[i] = mulTransform(global, matrices.pLocalToBind[i]);
+                    matrices.pInvTransposeSkinning[i] = inverseTransposeTransform(matrices.pSkinning[i]);
+                }
+            }
+        };
+
+        for (uint32_t l = 0; l < getLevelCount(); l++)
+        {
+            NumericRange<uint32_t> range(mLevelTaskOffsets[l], mLevelTaskOffsets[l + 1]);
+            if (parallel && mLevelTaskOffsets[l + 1] - mLevelTaskOffsets[l] > 1)
+                std::for_each(std::execution::par, range.begin(), range.end(), updateTask);
+            else
+                std::for_each(range.begin(), range.end(), updateTask);
+        }
+
+        // Detect ranges of consecutive changed nodes.
+        mChangedRanges.clear();
+        const uint32_t nodeCount = getNodeCount();
+        for (uint32_t i = 0; i < nodeCount;)
+        {
+            while (i < nodeCount && !changed[i]) ++i;
+            const uint32_t offset = i;
+            while (i < nodeCount && changed[i]) ++i;
+            if (i > offset) mChangedRanges.push_back({ offset, i - offset });
+        }
+    }
+}
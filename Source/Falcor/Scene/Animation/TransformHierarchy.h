@@ -0,0 +1,105 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Matrix.h"
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+    /** Computes the global transforms of a scene graph.
+
+        Nodes are grouped into levels by their depth in the hierarchy. The levels are processed in order,
+        and the nodes within a level are processed in parallel. To keep the memory accesses coherent, a node
+        whose parent is stored shortly before it is placed in the same level as its parent and processed
+        after it by the same task.
+        Nodes whose local (and parent) transforms are affine use a 3x4 row-wise matrix product
+        and an analytic inverse of the 3x3 part instead of a general 4x4 inverse.
+        Non-affine transforms fall back to the general 4x4 math.
+    */
+    class FALCOR_API TransformHierarchy
+    {
+    public:
+        static constexpr uint32_t kInvalidNode = uint32_t(-1);
+
+        /// Contiguous range of node indices.
+        struct Range
+        {
+            uint32_t offset = 0;
+            uint32_t count = 0;
+        };
+
+        /// Matrices read and written by update(). All arrays have one element per node.
+        struct Matrices
+        {
+            const float4x4* pLocal = nullptr;               ///< Local transform per node (input).
+            const float4x4* pLocalToBind = nullptr;         ///< Local to bind space transform per node (input). Optional, only used if skinning matrices are requested.
+            float4x4* pGlobal = nullptr;                    ///< Global transform per node (output).
+            float4x4* pInvTransposeGlobal = nullptr;        ///< Inverse transpose of the global transform per node (output).
+            float4x4* pSkinning = nullptr;                  ///< Skinning transform per node (output). Optional.
+            float4x4* pInvTransposeSkinning = nullptr;      ///< Inverse transpose of the skinning transform per node (output). Optional.
+        };
+
+        TransformHierarchy() = default;
+
+        /** Constructor.
+            \param[in] parents Parent index per node, or kInvalidNode for root nodes.
+        */
+        explicit TransformHierarchy(const std::vector<uint32_t>& parents);
+
+        /** Update the global transforms.
+            The changed flag of every node is or'ed with the flag of its parent. Only nodes with the flag set are updated unless updateAll is true.
+            \param[in] matrices Input and output matrices.
+            \param[in,out] changed Changed flag per node.
+            \param[in] updateAll Update all nodes regardless of the changed flags.
+            \param[in] parallel Process the nodes within each level on multiple threads.
+        */
+        void update(const Matrices& matrices, uint8_t* changed, bool updateAll, bool parallel = true);
+
+        /** Get the ranges of consecutive changed nodes after the last call to update().
+            These are the ranges that need to be uploaded to the GPU.
+        */
+        const std::vector<Range>& getChangedRanges() const { return mChangedRanges; }
+
+        /** Get the number of nodes.
+        */
+        uint32_t getNodeCount() const { return (uint32_t)mParents.size(); }
+
+        /** Get the number of levels.
+        */
+        uint32_t getLevelCount() const { return mLevelTaskOffsets.empty() ? 0 : (uint32_t)mLevelTaskOffsets.size() - 1; }
+
+    private:
+        std::vector<uint32_t> mParents;         ///< Parent index per node.
+        std::vector<uint32_t> mLevelNodes;      ///< Node indices sorted by level, and by index within each level.
+        std::vector<uint32_t> mTaskOffsets;     ///< Offset of each task in mLevelNodes, plus the total node count.
+        std::vector<uint32_t> mLevelTaskOffsets;///< Index of the first task of each level, plus the total task count.
+        std::vector<Range> mChangedRanges;      ///< Ranges of changed nodes after the last update.
+    };
+}
@@ -0,0 +1,353 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "VertexCacheStreamer.h"
+#include "Core/Error.h"
+#include "Utils/Math/PackedFormats.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <algorithm>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint64_t kNoKey = uint64_t(-1);
+
+        bool contains(const std::vector<uint32_t>& keyframes, uint32_t keyframe)
+        {
+            return std::find(keyframes.begin(), keyframes.end(), keyframe) != keyframes.end();
+        }
+    }
+
+    VertexCacheStreamer::VertexCacheStreamer(uint32_t slotCount, uint32_t prefetchCount, UploadCallback upload)
+        : mSlotCount(slotCount)
+        , mPrefetchCount(prefetchCount)
+        , mUpload(std::move(upload))
+        , mDecoder(1, {
+            [this](DecodeJob& job) { decodeKeyframe(uint32_t(job.key >> 32), uint32_t(job.key), job.data); },
+            [this](DecodeJob& job, bool success) { if (success) mDecoded[job.key] = std::move(job.data); },
+            [](const DecodeJob& job) { return fmt::format("decode keyframe {} of clip {}", uint32_t(job.key), uint32_t(job.key >> 32)); } })
+    {
+        FALCOR_CHECK(slotCount >= 2, "VertexCacheStreamer requires at least two slots per clip.");
+        FALCOR_CHECK(mUpload != nullptr, "VertexCacheStreamer requires an upload callback.");
+    }
+
+    uint32_t VertexCacheStreamer::addMeshClip(uint32_t vertexCount)
+    {
+        return addClip(true, vertexCount);
+    }
+
+    uint32_t VertexCacheStreamer::addCurveClip(uint32_t vertexCount)
+    {
+        return addClip(false, vertexCount);
+    }
+
+    uint32_t VertexCacheStreamer::addClip(bool isMesh, uint32_t vertexCount)
+    {
+        Clip clip;
+        clip.isMesh = isMesh;
+        clip.vertexCount = vertexCount;
+        clip.slotKeyframes.resize(mSlotCount, kInvalidKeyframe);
+        clip.slotLastUse.resize(mSlotCount, 0);
+        mClips.push_back(std::move(clip));
+        return (uint32_t)mClips.size() - 1;
+    }
+
+    void VertexCacheStreamer::compressPositions(CompressedKeyframe& keyframe, uint32_t vertexCount, const float3* pPositions, size_t stride)
+    {
+        auto position = [&](uint32_t i) { return *reinterpret_cast<const float3*>(reinterpret_cast<const uint8_t*>(pPositions) + i * stride); };
+
+        float3 minPos(std::numeric_limits<float>::max());
+        float3 maxPos(-std::numeric_limits<float>::max());
+        for (uint32_t i = 0; i < vertexCount; i++)
+        {
+            minPos = min(minPos, position(i));
+            maxPos = max(maxPos, position(i));
+        }
+        if (vertexCount == 0) minPos = maxPos = float3(0.f);
+
+        keyframe.positionOrigin = minPos;
+        keyframe.positionScale = max((maxPos - minPos) / 65535.f, float3(std::numeric_limits<float>::min()));
+
+        keyframe.positions.resize(3 * size_t(vertexCount));
+        for (uint32_t i = 0; i < vertexCount; i++)
+        {
+            float3 q = round((position(i) - minPos) / keyframe.positionScale);
+            q = clamp(q, float3(0.f), float3(65535.f));
+            keyframe.positions[3 * i + 0] = (uint16_t)q.x;
+            keyframe.positions[3 * i + 1] = (uint16_t)q.y;
+            keyframe.positions[3 * i + 2] = (uint16_t)q.z;
+        }
+    }
+
+    void VertexCacheStreamer::addKeyframe(uint32_t clipID, fstd::span<const PackedStaticVertexData> vertices)
+    {
+        FALCOR_CHECK(clipID < mClips.size(), "Invalid clip ID {}.", clipID);
+        Clip& clip = mClips[clipID];
+        FALCOR_CHECK(clip.isMesh, "Clip {} is not a mesh clip.", clipID);
+        FALCOR_CHECK(vertices.size() == clip.vertexCount, "Keyframe vertex count does not match clip {}.", clipID);
+
+        CompressedKeyframe keyframe;
+        compressPositions(keyframe, clip.vertexCount, vertices.empty() ? nullptr : &vertices[0].position, sizeof(PackedStaticVertexData));
+
+        keyframe.normals.resize(clip.vertexCount);
+        keyframe.tangents.resize(clip.vertexCount);
+        keyframe.tangentSigns.resize(clip.vertexCount);
+        for (uint32_t i = 0; i < clip.vertexCount; i++)
+        {
+            const float3& packed = vertices[i].packedNormalTangentCurveRadius;
+            uint32_t nxy = math::asuint(packed.x);
+            uint32_t nzw = math::asuint(packed.y);
+            float3 normal = f16tof32(uint3(nxy & 0xffff, nxy >> 16, nzw & 0xffff));
+            float length = math::length(normal);
+            keyframe.normals[i] = encodeNormal2x16(length > 0.f ? normal / length : float3(0.f, 0.f, 1.f));
+            keyframe.tangents[i] = math::asuint(packed.z);
+            keyframe.tangentSigns[i] = uint16_t(nzw >> 16);
+        }
+
+        clip.keyframes.push_back(std::move(keyframe));
+    }
+
+    void VertexCacheStreamer::addKeyframe(uint32_t clipID, fstd::span<const DynamicCurveVertexData> vertices)
+    {
+        FALCOR_CHECK(clipID < mClips.size(), "Invalid clip ID {}.", clipID);
+        Clip& clip = mClips[clipID];
+        FALCOR_CHECK(!clip.isMesh, "Clip {} is not a curve clip.", clipID);
+        FALCOR_CHECK(vertices.size() == clip.vertexCount, "Keyframe vertex count does not match clip {}.", clipID);
+
+        CompressedKeyframe keyframe;
+        compressPositions(keyframe, clip.vertexCount, vertices.empty() ? nullptr : &vertices[0].position, sizeof(DynamicCurveVertexData));
+        clip.keyframes.push_back(std::move(keyframe));
+    }
+
+    size_t VertexCacheStreamer::getKeyframeByteSize(uint32_t clipID) const
+    {
+        const Clip& clip = mClips[clipID];
+        return size_t(clip.vertexCount) * (clip.isMesh ? sizeof(PackedStaticVertexData) : sizeof(DynamicCurveVertexData));
+    }
+
+    uint64_t VertexCacheStreamer::getCompressedByteSize() const
+    {
+        uint64_t byteSize = 0;
+        for (const auto& clip : mClips)
+        {
+            for (const auto& keyframe : clip.keyframes)
+            {
+                byteSize += sizeof(CompressedKeyframe);
+                byteSize += keyframe.positions.size() * sizeof(uint16_t);
+                byteSize += keyframe.normals.size() * sizeof(uint32_t);
+                byteSize += keyframe.tangents.size() * sizeof(uint32_t);
+                byteSize += keyframe.tangentSigns.size() * sizeof(uint16_t);
+            }
+        }
+        return byteSize;
+    }
+
+    void VertexCacheStreamer::decodeKeyframe(uint32_t clipID, uint32_t keyframe, std::vector<uint8_t>& data) const
+    {
+        FALCOR_CHECK(clipID < mClips.size(), "Invalid clip ID {}.", clipID);
+        const Clip& clip = mClips[clipID];
+        FALCOR_CHECK(keyframe < clip.keyframes.size(), "Invalid keyframe {} for clip {}.", keyframe, clipID);
+        const CompressedKeyframe& src = clip.keyframes[keyframe];
+
+        data.resize(getKeyframeByteSize(clipID));
+
+        auto decodePosition = [&](uint32_t i)
+        {
+            float3 q(src.positions[3 * i + 0], src.positions[3 * i + 1], src.positions[3 * i + 2]);
+            return src.positionOrigin + q * src.positionScale;
+        };
+
+        if (clip.isMesh)
+        {
+            PackedStaticVertexData* pDst = reinterpret_cast<PackedStaticVertexData*>(data.data());
+            for (uint32_t i = 0; i < clip.vertexCount; i++)
+            {
+                uint3 n = f32tof16(decodeNormal2x16(src.normals[i]));
+                pDst[i].position = decodePosition(i);
+                pDst[i].packedNormalTangentCurveRadius.x = math::asfloat((n.y << 16) | n.x);
+                pDst[i].packedNormalTangentCurveRadius.y = math::asfloat((uint32_t(src.tangentSigns[i]) << 16) | n.z);
+                pDst[i].packedNormalTangentCurveRadius.z = math::asfloat(src.tangents[i]);
+                pDst[i].texCrd = float2(0.f);
+            }
+        }
+        else
+        {
+            DynamicCurveVertexData* pDst = reinterpret_cast<DynamicCurveVertexData*>(data.data());
+            for (uint32_t i = 0; i < clip.vertexCount; i++) pDst[i].position = decodePosition(i);
+        }
+    }
+
+    uint32_t VertexCacheStreamer::findSlot(const Clip& clip, uint32_t keyframe) const
+    {
+        for (uint32_t slot = 0; slot < mSlotCount; slot++)
+        {
+            if (clip.slotKeyframes[slot] == keyframe) return slot;
+        }
+        return kInvalidKeyframe;
+    }
+
+    uint32_t VertexCacheStreamer::allocateSlot(Clip& clip, const std::vector<uint32_t>& keep) const
+    {
+        // Pick an empty slot, or else the least recently used slot that does not hold a keyframe to keep.
+        uint32_t bestSlot = kInvalidKeyframe;
+        for (uint32_t slot = 0; slot < mSlotCount; slot++)
+        {
+            uint32_t keyframe = clip.slotKeyframes[slot];
+            if (keyframe == kInvalidKeyframe) return slot;
+            if (contains(keep, keyframe)) continue;
+            if (bestSlot == kInvalidKeyframe || clip.slotLastUse[slot] < clip.slotLastUse[bestSlot]) bestSlot = slot;
+        }
+        return bestSlot;
+    }
+
+    std::vector<uint8_t> VertexCacheStreamer::acquireKeyframe(uint32_t clipID, uint32_t keyframe)
+    {
+        const Key key = makeKey(clipID, keyframe);
+        auto isKey = [key](const DecodeJob& job) { return job.key == key; };
+        std::vector<uint8_t> data;
+
+        auto lock = mDecoder.lock();
+        if (auto it = mDecoded.find(key); it != mDecoded.end())
+        {
+            data = std::move(it->second);
+            mDecoded.erase(it);
+            mStats.prefetchHitCount++;
+            return data;
+        }
+
+        // The keyframe was not prefetched in time. Wait for it if the worker is decoding it, otherwise decode it here.
+        // It is also decoded here if decoding failed on the worker, so that the error is reported to the caller.
+        auto startTime = CpuTimer::getCurrentTimePoint();
+        mStats.stallCount++;
+        mDecoder.cancelIf(lock, isKey);
+        mDecoder.wait(lock, [&]() { return !mDecoder.isRunning(lock, isKey); });
+        if (auto it = mDecoded.find(key); it != mDecoded.end())
+        {
+            data = std::move(it->second);
+            mDecoded.erase(it);
+        }
+        else
+        {
+            lock.unlock();
+            decodeKeyframe(clipID, keyframe, data);
+        }
+        mStats.stallTimeMs += CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint());
+        return data;
+    }
+
+    void VertexCacheStreamer::uploadKeyframe(uint32_t clipID, uint32_t slot, uint32_t keyframe, const std::vector<uint8_t>& data)
+    {
+        Clip& clip = mClips[clipID];
+        mUpload(clipID, slot, data.data(), data.size());
+        clip.slotKeyframes[slot] = keyframe;
+        clip.slotLastUse[slot] = mRequestCounter;
+        mStats.uploadCount++;
+    }
+
+    uint2 VertexCacheStreamer::request(uint32_t clipID, uint2 keyframes)
+    {
+        FALCOR_CHECK(clipID < mClips.size(), "Invalid clip ID {}.", clipID);
+        Clip& clip = mClips[clipID];
+        const uint32_t keyframeCount = (uint32_t)clip.keyframes.size();
+        FALCOR_CHECK(keyframes.x < keyframeCount && keyframes.y < keyframeCount, "Invalid keyframes ({}, {}) for clip {}.", keyframes.x, keyframes.y, clipID);
+
+        mRequestCounter++;
+
+        // Keyframes following the requested ones, wrapping around for looped playback.
+        std::vector<uint32_t> upcoming;
+        for (uint32_t i = 1; i <= mPrefetchCount && i < keyframeCount; i++)
+        {
+            uint32_t keyframe = (keyframes.y + i) % keyframeCount;
+            if (keyframe != keyframes.x && keyframe != keyframes.y && !contains(upcoming, keyframe)) upcoming.push_back(keyframe);
+        }
+
+        // Make the requested keyframes resident. Upcoming keyframes are only evicted if there are no other slots.
+        uint2 slots;
+        const std::vector<uint32_t> needed = { keyframes.x, keyframes.y };
+        std::vector<uint32_t> keep = needed;
+        keep.insert(keep.end(), upcoming.begin(), upcoming.end());
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            uint32_t keyframe = keyframes[i];
+            uint32_t slot = findSlot(clip, keyframe);
+            if (slot == kInvalidKeyframe)
+            {
+                slot = allocateSlot(clip, keep);
+                if (slot == kInvalidKeyframe) slot = allocateSlot(clip, needed);
+                FALCOR_ASSERT(slot != kInvalidKeyframe);
+                uploadKeyframe(clipID, slot, keyframe, acquireKeyframe(clipID, keyframe));
+            }
+            clip.slotLastUse[slot] = mRequestCounter;
+            slots[i] = slot;
+        }
+
+        std::vector<std::pair<uint32_t, std::vector<uint8_t>>> ready;
+        {
+            auto lock = mDecoder.lock();
+            auto isStale = [&](Key key) { return uint32_t(key >> 32) == clipID && !contains(upcoming, uint32_t(key)); };
+
+            // Drop decoded and queued keyframes of this clip that are no longer upcoming, e.g. after a seek.
+            for (auto it = mDecoded.begin(); it != mDecoded.end();)
+            {
+                if (isStale(it->first)) it = mDecoded.erase(it);
+                else ++it;
+            }
+            mDecoder.cancelIf(lock, [&](const DecodeJob& job) { return isStale(job.key); });
+
+            // Collect upcoming keyframes that are ready and queue the missing ones.
+            for (uint32_t keyframe : upcoming)
+            {
+                if (findSlot(clip, keyframe) != kInvalidKeyframe) continue;
+                const Key key = makeKey(clipID, keyframe);
+                auto isKey = [key](const DecodeJob& job) { return job.key == key; };
+                if (auto it = mDecoded.find(key); it != mDecoded.end())
+                {
+                    ready.emplace_back(keyframe, std::move(it->second));
+                    mDecoded.erase(it);
+                }
+                else if (!mDecoder.isQueued(lock, isKey) && !mDecoder.isRunning(lock, isKey))
+                {
+                    mDecoder.push(lock, DecodeJob{ key, {} });
+                }
+            }
+        }
+
+        // Upload ready keyframes into slots that are not needed.
+        for (auto& [keyframe, data] : ready)
+        {
+            uint32_t slot = allocateSlot(clip, keep);
+            if (slot == kInvalidKeyframe) break;
+            uploadKeyframe(clipID, slot, keyframe, data);
+            // Keep recently requested slots ahead of prefetched ones in the eviction order.
+            clip.slotLastUse[slot] = mRequestCounter - 1;
+            mStats.prefetchHitCount++;
+        }
+
+        return slots;
+    }
+}
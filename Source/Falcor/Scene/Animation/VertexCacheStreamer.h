@@ -0,0 +1,182 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Scene/SceneTypes.slang"
+#include "Utils/WorkerQueue.h"
+#include "Utils/Math/Vector.h"
+#include <fstd/span.h>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Falcor
+{
+    /** Streams the keyframes of vertex caches into a fixed number of GPU slots per clip.
+
+        A clip is the sequence of keyframes of one cached mesh or of a set of cached curves.
+        The keyframes are stored compressed on the CPU: positions are quantized to 16 bits per component
+        relative to the bounds of the keyframe, and normals are stored in the 2x16-bit octahedral encoding.
+        Texture coordinates are not stored since the vertex update passes take them from the scene.
+
+        request() makes a pair of keyframes resident in the slots of a clip and returns their slot indices.
+        Keyframes following the requested ones are decoded ahead of time on a background thread,
+        and uploaded into free slots on the next request.
+    */
+    class FALCOR_API VertexCacheStreamer
+    {
+    public:
+        static constexpr uint32_t kInvalidKeyframe = uint32_t(-1);
+
+        /** Callback to copy a decoded keyframe into a slot. Called on the thread calling request().
+            The data is an array of PackedStaticVertexData for mesh clips, or DynamicCurveVertexData for curve clips.
+        */
+        using UploadCallback = std::function<void(uint32_t clipID, uint32_t slot, const void* pData, size_t byteSize)>;
+
+        struct Stats
+        {
+            uint64_t uploadCount = 0;       ///< Number of keyframes uploaded to slots.
+            uint64_t prefetchHitCount = 0;  ///< Number of keyframes decoded by the background thread before they were uploaded.
+            uint64_t stallCount = 0;        ///< Number of requested keyframes that were not decoded in time.
+            double stallTimeMs = 0.0;       ///< Total time spent waiting for or decoding requested keyframes.
+        };
+
+        /** Constructor.
+            \param[in] slotCount Number of resident keyframes per clip. Must be at least two.
+            \param[in] prefetchCount Number of keyframes after the requested ones to decode ahead of time.
+            \param[in] upload Callback to copy keyframe data into a slot.
+        */
+        VertexCacheStreamer(uint32_t slotCount, uint32_t prefetchCount, UploadCallback upload);
+
+        /** Destructor. Blocks until the background thread has terminated.
+        */
+        ~VertexCacheStreamer() = default;
+
+        /** Add a clip of mesh keyframes.
+            \param[in] vertexCount Number of vertices per keyframe.
+            \return Clip ID.
+        */
+        uint32_t addMeshClip(uint32_t vertexCount);
+
+        /** Add a clip of curve keyframes.
+            \param[in] vertexCount Number of vertices per keyframe.
+            \return Clip ID.
+        */
+        uint32_t addCurveClip(uint32_t vertexCount);
+
+        /** Compress and append a keyframe to a mesh clip.
+            Keyframes must be added before the first call to request().
+        */
+        void addKeyframe(uint32_t clipID, fstd::span<const PackedStaticVertexData> vertices);
+
+        /** Compress and append a keyframe to a curve clip.
+            Keyframes must be added before the first call to request().
+        */
+        void addKeyframe(uint32_t clipID, fstd::span<const DynamicCurveVertexData> vertices);
+
+        /** Make two keyframes of a clip resident.
+            \param[in] clipID Clip ID.
+            \param[in] keyframes Keyframe indices.
+            \return Slot indices holding the keyframes.
+        */
+        uint2 request(uint32_t clipID, uint2 keyframes);
+
+        /** Decode a keyframe.
+            \param[in] clipID Clip ID.
+            \param[in] keyframe Keyframe index.
+            \param[out] data Decoded vertex data.
+        */
+        void decodeKeyframe(uint32_t clipID, uint32_t keyframe, std::vector<uint8_t>& data) const;
+
+        uint32_t getClipCount() const { return (uint32_t)mClips.size(); }
+        uint32_t getKeyframeCount(uint32_t clipID) const { return (uint32_t)mClips[clipID].keyframes.size(); }
+        uint32_t getSlotCount() const { return mSlotCount; }
+
+        /** Get the keyframe resident in a slot, or kInvalidKeyframe if the slot is empty.
+        */
+        uint32_t getSlotKeyframe(uint32_t clipID, uint32_t slot) const { return mClips[clipID].slotKeyframes[slot]; }
+
+        /** Get the size of one decoded keyframe in bytes.
+        */
+        size_t getKeyframeByteSize(uint32_t clipID) const;
+
+        /** Get the total size of the compressed keyframes in bytes.
+        */
+        uint64_t getCompressedByteSize() const;
+
+        const Stats& getStats() const { return mStats; }
+
+    private:
+        struct CompressedKeyframe
+        {
+            float3 positionOrigin;
+            float3 positionScale;
+            std::vector<uint16_t> positions;        ///< Quantized positions, three per vertex.
+            std::vector<uint32_t> normals;          ///< Octahedral normals (meshes only).
+            std::vector<uint32_t> tangents;         ///< Octahedral tangents as stored in PackedStaticVertexData (meshes only).
+            std::vector<uint16_t> tangentSigns;     ///< Half-precision tangent sign times curve radius (meshes only).
+        };
+
+        struct Clip
+        {
+            bool isMesh = true;
+            uint32_t vertexCount = 0;
+            std::vector<CompressedKeyframe> keyframes;
+            std::vector<uint32_t> slotKeyframes;    ///< Keyframe resident in each slot.
+            std::vector<uint64_t> slotLastUse;      ///< Request counter at the last use of each slot.
+        };
+
+        using Key = uint64_t;
+        static Key makeKey(uint32_t clipID, uint32_t keyframe) { return (uint64_t(clipID) << 32) | keyframe; }
+
+        struct DecodeJob
+        {
+            Key key;
+            std::vector<uint8_t> data;
+        };
+
+        uint32_t addClip(bool isMesh, uint32_t vertexCount);
+        void compressPositions(CompressedKeyframe& keyframe, uint32_t vertexCount, const float3* pPositions, size_t stride);
+        uint32_t findSlot(const Clip& clip, uint32_t keyframe) const;
+        uint32_t allocateSlot(Clip& clip, const std::vector<uint32_t>& keep) const;
+        std::vector<uint8_t> acquireKeyframe(uint32_t clipID, uint32_t keyframe);
+        void uploadKeyframe(uint32_t clipID, uint32_t slot, uint32_t keyframe, const std::vector<uint8_t>& data);
+
+        uint32_t mSlotCount;
+        uint32_t mPrefetchCount;
+        UploadCallback mUpload;
+        std::vector<Clip> mClips;
+        uint64_t mRequestCounter = 0;
+        Stats mStats;
+
+        // Background decoding.
+        std::unordered_map<Key, std::vector<uint8_t>> mDecoded;         ///< Decoded keyframes waiting to be uploaded. Guarded by the decoder mutex.
+        WorkerQueue<DecodeJob> mDecoder;                                ///< Decodes the upcoming keyframes. Declared last to be destroyed first.
+    };
+}
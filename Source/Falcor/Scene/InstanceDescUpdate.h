@@ -0,0 +1,105 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Error.h"
+#include "Core/API/RtAccelerationStructure.h"
+#include "Utils/Math/Matrix.h"
+#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <limits>
+#include <vector>
+
+namespace Falcor
+{
+    /** Helpers for the incremental update of TLAS instance descs and other per-instance GPU data.
+        The data is kept between frames and only the elements whose transform changed are patched and uploaded.
+    */
+    namespace InstanceDescUpdate
+    {
+        /// Max number of unchanged elements allowed between two changed ones for them to be uploaded as one range.
+        /// Merging nearby ranges trades a little extra bandwidth for fewer setBlob() calls.
+        constexpr uint32_t kMaxUploadRangeGap = 16;
+
+        /// Matrix ID of instance descs with a fixed identity transform.
+        constexpr uint32_t kInvalidMatrixID = std::numeric_limits<uint32_t>::max();
+
+        /** Calls func(offset, count) for each range of consecutive indices in a sorted list of unique indices.
+            Indices separated by at most kMaxUploadRangeGap are merged into the same range.
+        */
+        template<typename Func>
+        void forEachIndexRange(const std::vector<uint32_t>& sortedIndices, Func func)
+        {
+            size_t i = 0;
+            while (i < sortedIndices.size())
+            {
+                uint32_t first = sortedIndices[i];
+                uint32_t last = first;
+                while (++i < sortedIndices.size() && sortedIndices[i] - last <= kMaxUploadRangeGap + 1) last = sortedIndices[i];
+                func(first, last - first + 1);
+            }
+        }
+
+        /** Append the instance descs referenced by the moved geometry instances to a list of dirty descs.
+            Descs with an identity transform (static mesh groups, custom primitives) are never affected.
+            The list is sorted and duplicates are removed, as several geometry instances can map to the same desc.
+            \param[in] movedInstances IDs of the geometry instances that moved.
+            \param[in] getDescIndex Function returning the instance desc index of a geometry instance.
+            \param[in] descMatrixIDs Global matrix ID of each instance desc.
+            \param[in,out] dirtyDescs Sorted list of dirty instance descs.
+        */
+        template<typename GetDescIndex>
+        void collectDirtyDescs(const std::vector<uint32_t>& movedInstances, GetDescIndex getDescIndex, const std::vector<uint32_t>& descMatrixIDs, std::vector<uint32_t>& dirtyDescs)
+        {
+            for (uint32_t instanceID : movedInstances)
+            {
+                uint32_t descIndex = getDescIndex(instanceID);
+                FALCOR_ASSERT(descIndex < descMatrixIDs.size());
+                if (descMatrixIDs[descIndex] != kInvalidMatrixID) dirtyDescs.push_back(descIndex);
+            }
+
+            std::sort(dirtyDescs.begin(), dirtyDescs.end());
+            dirtyDescs.erase(std::unique(dirtyDescs.begin(), dirtyDescs.end()), dirtyDescs.end());
+        }
+
+        /** Update the transforms of the dirty instance descs from the global matrices.
+            \param[in,out] descs Instance descs.
+            \param[in] descMatrixIDs Global matrix ID of each instance desc.
+            \param[in] dirtyDescs Indices of the descs to update.
+            \param[in] globalMatrices Global matrices of the scene.
+        */
+        inline void updateTransforms(std::vector<RtInstanceDesc>& descs, const std::vector<uint32_t>& descMatrixIDs, const std::vector<uint32_t>& dirtyDescs, const std::vector<float4x4>& globalMatrices)
+        {
+            std::for_each(std::execution::par, dirtyDescs.begin(), dirtyDescs.end(), [&](uint32_t descIndex)
+            {
+                FALCOR_ASSERT(descMatrixIDs[descIndex] < globalMatrices.size());
+                descs[descIndex].setTransform(globalMatrices[descMatrixIDs[descIndex]]);
+            });
+        }
+    }
+}
@@ -0,0 +1,486 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+
+// The implementation mirrors pbrt's pointer-based Loop subdivision:
+// pbrt is Copyright(c) 1998-2020 Matt Pharr, Wenzel Jakob, and Greg Humphreys.
+// The pbrt source code is licensed under the Apache License, Version 2.0.
+// SPDX: Apache-2.0
+
+#include "LoopSubdivision.h"
+#include "Core/Error.h"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <execution>
+#include <cmath>
+
+namespace Falcor
+{
+    namespace
+    {
+        inline float beta(uint32_t valence)
+        {
+            if (valence == 3)
+                return 3.f / 16.f;
+            else
+                return 3.f / (8.f * valence);
+        }
+
+        inline float loopGamma(uint32_t valence)
+        {
+            return 1.f / (valence + 3.f / (8.f * beta(valence)));
+        }
+
+        const uint32_t kInvalidIndex = 0xffffffff;
+
+        // Levels with fewer elements than this are processed on a single thread.
+        const uint32_t kMinParallelCount = 4096;
+
+        const uint8_t kVertexBoundary = 0x1;
+        const uint8_t kVertexRegular = 0x2;
+
+        inline uint32_t next(uint32_t i) { return (i + 1) % 3; }
+        inline uint32_t prev(uint32_t i) { return (i + 2) % 3; }
+
+        template<typename Func>
+        void forEachIndex(bool parallel, uint32_t count, const Func& func)
+        {
+            if (parallel && count >= kMinParallelCount)
+            {
+                NumericRange<uint32_t> range(0, count);
+                std::for_each(std::execution::par, range.begin(), range.end(), func);
+            }
+            else
+            {
+                for (uint32_t i = 0; i < count; ++i) func(i);
+            }
+        }
+
+        /** Subdivision mesh stored in flat arrays.
+            Face f has vertices faceVertices[3 * f + k] and the neighbor across edge (k, next(k)) is faceNeighbors[3 * f + k].
+            Half-edge h = 3 * f + k denotes edge k of face f. The accessors mirror pbrt's SDVertex and SDFace.
+        */
+        struct FlatMesh
+        {
+            std::vector<float3> positions;
+            std::vector<uint32_t> startFaces;
+            std::vector<uint8_t> vertexFlags;
+            std::vector<uint32_t> faceVertices;
+            std::vector<uint32_t> faceNeighbors;
+
+            uint32_t getVertexCount() const { return (uint32_t)positions.size(); }
+            uint32_t getFaceCount() const { return (uint32_t)(faceVertices.size() / 3); }
+
+            bool isBoundary(uint32_t v) const { return (vertexFlags[v] & kVertexBoundary) != 0; }
+            bool isRegular(uint32_t v) const { return (vertexFlags[v] & kVertexRegular) != 0; }
+
+            uint32_t vnum(uint32_t f, uint32_t v) const
+            {
+                for (uint32_t i = 0; i < 3; ++i)
+                {
+                    if (faceVertices[3 * f + i] == v) return i;
+                }
+                FALCOR_THROW("Basic logic error in vnum().");
+            }
+
+            uint32_t nextFace(uint32_t f, uint32_t v) const { return faceNeighbors[3 * f + vnum(f, v)]; }
+            uint32_t prevFace(uint32_t f, uint32_t v) const { return faceNeighbors[3 * f + prev(vnum(f, v))]; }
+            uint32_t nextVert(uint32_t f, uint32_t v) const { return faceVertices[3 * f + next(vnum(f, v))]; }
+            uint32_t prevVert(uint32_t f, uint32_t v) const { return faceVertices[3 * f + prev(vnum(f, v))]; }
+            uint32_t otherVert(uint32_t f, uint32_t v0, uint32_t v1) const
+            {
+                for (uint32_t i = 0; i < 3; ++i)
+                {
+                    uint32_t v = faceVertices[3 * f + i];
+                    if (v != v0 && v != v1) return v;
+                }
+                FALCOR_THROW("Basic logic error in otherVert().");
+            }
+
+            /// Step to the next or previous face around v. Throws if a walk does not terminate, which happens for broken topology.
+            uint32_t step(uint32_t f, uint32_t v, uint32_t& steps, bool forward) const
+            {
+                if (++steps > getFaceCount()) FALCOR_THROW("Invalid mesh topology around vertex {}.", v);
+                return forward ? nextFace(f, v) : prevFace(f, v);
+            }
+
+            uint32_t valence(uint32_t v) const
+            {
+                uint32_t f = startFaces[v];
+                uint32_t steps = 0;
+                if (!isBoundary(v))
+                {
+                    uint32_t nf = 1;
+                    while ((f = step(f, v, steps, true)) != startFaces[v]) ++nf;
+                    return nf;
+                }
+                else
+                {
+                    uint32_t nf = 1;
+                    while ((f = step(f, v, steps, true)) != kInvalidIndex) ++nf;
+                    f = startFaces[v];
+                    steps = 0;
+                    while ((f = step(f, v, steps, false)) != kInvalidIndex) ++nf;
+                    return nf + 1;
+                }
+            }
+
+            /// Call func(i, p) for the one-ring vertex positions of v in the same order as pbrt's SDVertex::oneRing().
+            template<typename Func>
+            void forEachRingVertex(uint32_t v, const Func& func) const
+            {
+                uint32_t i = 0;
+                uint32_t steps = 0;
+                uint32_t f = startFaces[v];
+                if (!isBoundary(v))
+                {
+                    do
+                    {
+                        func(i++, positions[nextVert(f, v)]);
+                        f = step(f, v, steps, true);
+                    } while (f != startFaces[v]);
+                }
+                else
+                {
+                    uint32_t f2;
+                    while ((f2 = step(f, v, steps, true)) != kInvalidIndex) f = f2;
+                    func(i++, positions[nextVert(f, v)]);
+                    steps = 0;
+                    do
+                    {
+                        func(i++, positions[prevVert(f, v)]);
+                        f = step(f, v, steps, false);
+                    } while (f != kInvalidIndex);
+                }
+            }
+
+            float3 weightOneRing(uint32_t v, float beta) const
+            {
+                uint32_t valence = this->valence(v);
+                float3 p = (1 - valence * beta) * positions[v];
+                forEachRingVertex(v, [&](uint32_t, const float3& ringP) { p += beta * ringP; });
+                return p;
+            }
+
+            float3 weightBoundary(uint32_t v, float beta) const
+            {
+                uint32_t valence = this->valence(v);
+                float3 first(0.f);
+                float3 last(0.f);
+                forEachRingVertex(v, [&](uint32_t i, const float3& ringP)
+                {
+                    if (i == 0) first = ringP;
+                    if (i == valence - 1) last = ringP;
+                });
+                float3 p = (1 - 2 * beta) * positions[v];
+                p += beta * first;
+                p += beta * last;
+                return p;
+            }
+        };
+
+        /** Identify the edges of a mesh by sorting its half-edges by their (unordered) vertex pair.
+            \param[in] mesh Mesh.
+            \param[in] parallel Sort and process the half-edges on multiple threads.
+            \param[out] owners For each half-edge, the first half-edge (in face order) with the same vertex pair.
+            \param[out] pPairs If not nullptr, the half-edge each half-edge is paired with as a neighbor, or kInvalidIndex.
+                Half-edges with the same vertex pair are paired consecutively in face order, as in pbrt.
+        */
+        void findEdges(const FlatMesh& mesh, bool parallel, std::vector<uint32_t>& owners, std::vector<uint32_t>* pPairs)
+        {
+            struct HalfEdge
+            {
+                uint64_t key;
+                uint32_t index;
+                bool operator<(const HalfEdge& other) const { return key != other.key ? key < other.key : index < other.index; }
+            };
+
+            const uint32_t halfEdgeCount = (uint32_t)mesh.faceVertices.size();
+            std::vector<HalfEdge> halfEdges(halfEdgeCount);
+            forEachIndex(parallel, halfEdgeCount, [&](uint32_t h)
+            {
+                uint32_t v0 = mesh.faceVertices[h];
+                uint32_t v1 = mesh.faceVertices[h - h % 3 + next(h % 3)];
+                halfEdges[h] = { ((uint64_t)std::min(v0, v1) << 32) | std::max(v0, v1), h };
+            });
+
+            if (parallel && halfEdgeCount >= kMinParallelCount) std::sort(std::execution::par, halfEdges.begin(), halfEdges.end());
+            else std::sort(halfEdges.begin(), halfEdges.end());
+
+            owners.resize(halfEdgeCount);
+            if (pPairs) pPairs->assign(halfEdgeCount, kInvalidIndex);
+
+            forEachIndex(parallel, halfEdgeCount, [&](uint32_t s)
+            {
+                // Each group of half-edges with the same key is processed by the thread handling its first element.
+                if (s > 0 && halfEdges[s - 1].key == halfEdges[s].key) return;
+                uint32_t end = s + 1;
+                while (end < halfEdgeCount && halfEdges[end].key == halfEdges[s].key) ++end;
+
+                for (uint32_t i = s; i < end; ++i) owners[halfEdges[i].index] = halfEdges[s].index;
+                if (pPairs)
+                {
+                    for (uint32_t i = s; i + 1 < end; i += 2)
+                    {
+                        (*pPairs)[halfEdges[i].index] = halfEdges[i + 1].index;
+                        (*pPairs)[halfEdges[i + 1].index] = halfEdges[i].index;
+                    }
+                }
+            });
+        }
+    }
+
+
+    LoopSubdivision::Result LoopSubdivision::subdivideFlat(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> indices, bool parallel)
+    {
+        FALCOR_CHECK(positions.size() < kInvalidIndex, "Too many vertices ({}).", positions.size());
+        const uint32_t vertexCount = (uint32_t)positions.size();
+        const uint32_t faceCount = (uint32_t)(indices.size() / 3);
+
+        FlatMesh mesh;
+        mesh.positions.assign(positions.begin(), positions.end());
+        mesh.faceVertices.assign(indices.begin(), indices.begin() + 3 * faceCount);
+
+        // Each vertex starts at the last face referencing it, as in pbrt.
+        mesh.startFaces.assign(vertexCount, kInvalidIndex);
+        for (uint32_t f = 0; f < faceCount; ++f)
+        {
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                uint32_t v = mesh.faceVertices[3 * f + k];
+                FALCOR_CHECK(v < vertexCount, "Vertex index {} is out of range.", v);
+                mesh.startFaces[v] = f;
+            }
+        }
+        for (uint32_t v = 0; v < vertexCount; ++v)
+        {
+            FALCOR_CHECK(mesh.startFaces[v] != kInvalidIndex, "Vertex {} is not referenced by any triangle.", v);
+        }
+
+        // Set face neighbors from the paired half-edges.
+        std::vector<uint32_t> owners;
+        {
+            std::vector<uint32_t> pairs;
+            findEdges(mesh, parallel, owners, &pairs);
+            mesh.faceNeighbors.resize(pairs.size());
+            forEachIndex(parallel, (uint32_t)pairs.size(), [&](uint32_t h)
+            {
+                mesh.faceNeighbors[h] = pairs[h] != kInvalidIndex ? pairs[h] / 3 : kInvalidIndex;
+            });
+        }
+
+        // Classify vertices as boundary and/or regular.
+        mesh.vertexFlags.resize(vertexCount);
+        forEachIndex(parallel, vertexCount, [&](uint32_t v)
+        {
+            uint32_t f = mesh.startFaces[v];
+            uint32_t steps = 0;
+            do
+            {
+                f = mesh.step(f, v, steps, true);
+            } while (f != kInvalidIndex && f != mesh.startFaces[v]);
+            const bool boundary = f == kInvalidIndex;
+            mesh.vertexFlags[v] = boundary ? kVertexBoundary : 0;
+            if (mesh.valence(v) == (boundary ? 4u : 6u)) mesh.vertexFlags[v] |= kVertexRegular;
+        });
+
+        std::vector<uint32_t> edgeIndices;
+        for (uint32_t level = 0; level < levels; ++level)
+        {
+            const uint32_t levelVertexCount = mesh.getVertexCount();
+            const uint32_t levelFaceCount = mesh.getFaceCount();
+            const uint32_t halfEdgeCount = 3 * levelFaceCount;
+            FALCOR_CHECK((uint64_t)levelFaceCount * 12 < kInvalidIndex, "Subdivided mesh is too large.");
+
+            // Number the edges in order of their first half-edge. The odd vertex of each edge follows the even vertices.
+            if (level > 0) findEdges(mesh, parallel, owners, nullptr);
+            edgeIndices.resize(halfEdgeCount);
+            uint32_t edgeCount = 0;
+            for (uint32_t h = 0; h < halfEdgeCount; ++h)
+            {
+                if (owners[h] == h) edgeIndices[h] = edgeCount++;
+            }
+            auto getOddVertex = [&](uint32_t h) { return levelVertexCount + edgeIndices[owners[h]]; };
+
+            FlatMesh child;
+            child.positions.resize(levelVertexCount + edgeCount);
+            child.startFaces.resize(levelVertexCount + edgeCount);
+            child.vertexFlags.resize(levelVertexCount + edgeCount);
+            child.faceVertices.resize(12 * levelFaceCount);
+            child.faceNeighbors.resize(12 * levelFaceCount);
+
+            // Update vertex positions for even vertices.
+            forEachIndex(parallel, levelVertexCount, [&](uint32_t v)
+            {
+                if (!mesh.isBoundary(v))
+                {
+                    // Apply one-ring rule for even vertex.
+                    if (mesh.isRegular(v)) child.positions[v] = mesh.weightOneRing(v, 1.f / 16.f);
+                    else child.positions[v] = mesh.weightOneRing(v, beta(mesh.valence(v)));
+                }
+                else
+                {
+                    // Apply boundary rule for even vertex.
+                    child.positions[v] = mesh.weightBoundary(v, 1.f / 8.f);
+                }
+                child.vertexFlags[v] = mesh.vertexFlags[v];
+                const uint32_t f = mesh.startFaces[v];
+                child.startFaces[v] = 4 * f + mesh.vnum(f, v);
+            });
+
+            // Compute new odd edge vertices.
+            forEachIndex(parallel, halfEdgeCount, [&](uint32_t h)
+            {
+                if (owners[h] != h) return;
+
+                const uint32_t f = h / 3;
+                const uint32_t k = h % 3;
+                const uint32_t v0 = std::min(mesh.faceVertices[h], mesh.faceVertices[3 * f + next(k)]);
+                const uint32_t v1 = std::max(mesh.faceVertices[h], mesh.faceVertices[3 * f + next(k)]);
+                const uint32_t neighbor = mesh.faceNeighbors[h];
+                const bool boundary = neighbor == kInvalidIndex;
+
+                const uint32_t vert = levelVertexCount + edgeIndices[h];
+                child.vertexFlags[vert] = kVertexRegular | (boundary ? kVertexBoundary : 0);
+                child.startFaces[vert] = 4 * f + 3;
+
+                // Apply edge rules to compute new vertex position.
+                float3 p;
+                if (boundary)
+                {
+                    p = 0.5f * mesh.positions[v0];
+                    p += 0.5f * mesh.positions[v1];
+                }
+                else
+                {
+                    p = 3.f / 8.f * mesh.positions[v0];
+                    p += 3.f / 8.f * mesh.positions[v1];
+                    p += 1.f / 8.f * mesh.positions[mesh.otherVert(f, v0, v1)];
+                    p += 1.f / 8.f * mesh.positions[mesh.otherVert(neighbor, v0, v1)];
+                }
+                child.positions[vert] = p;
+            });
+
+            // Update new mesh topology. Face f is split into faces 4 * f + j (at vertex j) and 4 * f + 3 (center).
+            forEachIndex(parallel, levelFaceCount, [&](uint32_t f)
+            {
+                const uint32_t center = 4 * f + 3;
+                for (uint32_t j = 0; j < 3; ++j)
+                {
+                    const uint32_t c = 4 * f + j;
+                    const uint32_t v = mesh.faceVertices[3 * f + j];
+
+                    // Update children neighbors for siblings.
+                    child.faceNeighbors[3 * center + j] = 4 * f + next(j);
+                    child.faceNeighbors[3 * c + next(j)] = center;
+
+                    // Update children neighbors for neighbor children.
+                    uint32_t f2 = mesh.faceNeighbors[3 * f + j];
+                    child.faceNeighbors[3 * c + j] = f2 != kInvalidIndex ? 4 * f2 + mesh.vnum(f2, v) : kInvalidIndex;
+                    f2 = mesh.faceNeighbors[3 * f + prev(j)];
+                    child.faceNeighbors[3 * c + prev(j)] = f2 != kInvalidIndex ? 4 * f2 + mesh.vnum(f2, v) : kInvalidIndex;
+
+                    // Update child vertices to the new even and odd vertices.
+                    const uint32_t odd = getOddVertex(3 * f + j);
+                    child.faceVertices[3 * c + j] = v;
+                    child.faceVertices[3 * c + next(j)] = odd;
+                    child.faceVertices[3 * (4 * f + next(j)) + j] = odd;
+                    child.faceVertices[3 * center + j] = odd;
+                }
+            });
+
+            mesh = std::move(child);
+        }
+
+        // Push vertices to limit surface.
+        const uint32_t finalVertexCount = mesh.getVertexCount();
+        std::vector<float3> limitPositions(finalVertexCount);
+        forEachIndex(parallel, finalVertexCount, [&](uint32_t v)
+        {
+            if (mesh.isBoundary(v)) limitPositions[v] = mesh.weightBoundary(v, 1.f / 5.f);
+            else limitPositions[v] = mesh.weightOneRing(v, loopGamma(mesh.valence(v)));
+        });
+        mesh.positions = std::move(limitPositions);
+
+        // Compute vertex tangents on limit surface.
+        Result result;
+        result.normals.resize(finalVertexCount);
+        forEachIndex(parallel, finalVertexCount, [&](uint32_t v)
+        {
+            thread_local std::vector<float3> pRing;
+            const uint32_t valence = mesh.valence(v);
+            pRing.resize(valence);
+            mesh.forEachRingVertex(v, [&](uint32_t i, const float3& p) { pRing[i] = p; });
+            const float3& p = mesh.positions[v];
+
+            float3 S(0.f);
+            float3 T(0.f);
+            if (!mesh.isBoundary(v))
+            {
+                // Compute tangents of interior face.
+                for (uint32_t j = 0; j < valence; ++j)
+                {
+                    S += std::cos(2.f * float(M_PI) * j / valence) * float3(pRing[j]);
+                    T += std::sin(2.f * float(M_PI) * j / valence) * float3(pRing[j]);
+                }
+            }
+            else
+            {
+                // Compute tangents of boundary face.
+                S = pRing[valence - 1] - pRing[0];
+                if (valence == 2)
+                {
+                    T = float3(pRing[0] + pRing[1] - 2.f * p);
+                }
+                else if (valence == 3)
+                {
+                    T = pRing[1] - p;
+                }
+                else if (valence == 4) // regular
+                {
+                    T = float3(-1.f * pRing[0] + 2.f * pRing[1] + 2.f * pRing[2] + -1.f * pRing[3] + -2.f * p);
+                }
+                else
+                {
+                    float theta = float(M_PI) / float(valence - 1);
+                    T = float3(std::sin(theta) * (pRing[0] + pRing[valence - 1]));
+                    for (uint32_t k = 1; k < valence - 1; ++k)
+                    {
+                        float wt = (2 * std::cos(theta) - 2) * std::sin((k)*theta);
+                        T += float3(wt * pRing[k]);
+                    }
+                    T = -T;
+                }
+            }
+            result.normals[v] = cross(S, T);
+        });
+
+        result.positions = std::move(mesh.positions);
+        result.indices = std::move(mesh.faceVertices);
+        return result;
+    }
+}
@@ -0,0 +1,66 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <fstd/span.h> // TODO C++20: Replace with <span>
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+    /** Loop subdivision of triangle meshes, as used by pbrt's 'loopsubdiv' shape.
+
+        The mesh is subdivided the given number of levels and the vertices are then pushed to the limit surface.
+        Normals are computed from the limit surface tangents (they are not normalized).
+        Vertices are numbered per level by keeping the vertices of the previous level, followed by one new vertex
+        per edge in order of the edge's first occurrence. Each triangle is split into four in place.
+    */
+    class FALCOR_API LoopSubdivision
+    {
+    public:
+        struct Result
+        {
+            std::vector<float3> positions;  ///< Vertex positions on the limit surface.
+            std::vector<float3> normals;    ///< Vertex normals on the limit surface.
+            std::vector<uint32_t> indices;  ///< Triangle vertex indices.
+        };
+
+        /** Subdivide a mesh using flat arrays of face vertices and face neighbors.
+            The edges of each level are identified by sorting the half-edges by their vertex pair, and the
+            vertex and face rules of each level are evaluated concurrently. The result is identical to pbrt's pointer-based implementation.
+            Throws an exception if the control mesh has out of range indices or vertices not referenced by any triangle.
+            \param[in] levels Number of subdivision levels.
+            \param[in] positions Vertex positions of the control mesh.
+            \param[in] indices Triangle vertex indices of the control mesh.
+            \param[in] parallel Evaluate the subdivision rules on multiple threads.
+            \return The subdivided mesh.
+        */
+        static Result subdivideFlat(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> indices, bool parallel = true);
+    };
+}
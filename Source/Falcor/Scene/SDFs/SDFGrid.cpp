@@ -40,6 +40,7 @@
 #include "Utils/Math/MatrixJson.h"
 #include "Utils/Math/VectorJson.h"
 #include "Utils/Scripting/ScriptBindings.h"
+#include "Scene/TriangleMesh.h"
 #include "GlobalState.h"
 #include <nlohmann/json.hpp>
 #include <random>
@@ -268,6 +269,29 @@ namespace Falcor
         setValuesInternal(cornerValues);
     }
 
+    void SDFGrid::setValuesFromMesh(fstd::span<const float3> positions, fstd::span<const uint32_t> indices, uint32_t gridWidth, SDFMeshBaker::SignMode signMode)
+    {
+        // All types except SBS need to have a gridWidth that is a power of 2.
+        Type type = getType();
+        if (type != Type::SparseBrickSet)
+        {
+            FALCOR_CHECK(isPowerOf2(gridWidth), "'gridWidth' ({}) must be a power of 2 for SDFGrid type of {}", gridWidth, getTypeName(type));
+        }
+
+        SDFMeshBaker baker(positions, indices);
+        SDFMeshBaker::Options options;
+        options.signMode = signMode;
+
+        mGridWidth = gridWidth;
+
+        setValuesFromMeshInternal(baker, options);
+    }
+
+    void SDFGrid::setValuesFromMeshInternal(const SDFMeshBaker& baker, const SDFMeshBaker::Options& options)
+    {
+        setValuesInternal(baker.bakeValues(mGridWidth, options));
+    }
+
     bool SDFGrid::loadValuesFromFile(const std::filesystem::path& path)
     {
         std::ifstream file(path, std::ios::in | std::ios::binary);
@@ -497,6 +521,16 @@ namespace Falcor
             "path"_a, "gridWidth"_a
         ); // PYTHONDEPRECATED
         sdfGrid.def("generateCheeseValues", &SDFGrid::generateCheeseValues, "gridWidth"_a, "seed"_a);
+        sdfGrid.def("setValuesFromMesh",
+            [](SDFGrid& self, const ref<TriangleMesh>& pMesh, uint32_t gridWidth, bool useRayParity)
+            {
+                std::vector<float3> positions;
+                positions.reserve(pMesh->getVertices().size());
+                for (const auto& vertex : pMesh->getVertices()) positions.push_back(vertex.position);
+                self.setValuesFromMesh(positions, pMesh->getIndices(), gridWidth, useRayParity ? SDFMeshBaker::SignMode::RayParity : SDFMeshBaker::SignMode::WindingNumber);
+            },
+            "mesh"_a, "gridWidth"_a, "useRayParity"_a = false
+        );
         sdfGrid.def_property("name", &SDFGrid::getName, &SDFGrid::setName);
     }
 
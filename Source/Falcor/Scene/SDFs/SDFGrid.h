@@ -32,6 +32,8 @@
 #include "Core/API/Texture.h"
 #include "Core/Pass/ComputePass.h"
 #include "Scene/SDFs/SDF3DPrimitiveCommon.slang"
+#include "Scene/SDFs/SDFMeshBaker.h"
+#include <fstd/span.h> // TODO C++20: Replace with <span>
 #include <memory>
 #include <vector>
 #include <utility>
@@ -123,6 +125,15 @@ namespace Falcor
         */
         void setValues(const std::vector<float>& cornerValues, uint32_t gridWidth);
 
+        /** Set the signed distance values of the SDF grid by baking a triangle mesh on the CPU.
+            The SDFSBS only evaluates the narrow band around the surface and creates its bricks directly, other grid types are baked into a dense grid of values.
+            \param[in] positions The vertex positions in the local space of the SDF grid, i.e., [-0.5, 0.5]^3.
+            \param[in] indices The triangle vertex indices.
+            \param[in] gridWidth The grid width in voxels.
+            \param[in] signMode Selects how to determine if grid corners are inside the mesh.
+        */
+        void setValuesFromMesh(fstd::span<const float3> positions, fstd::span<const uint32_t> indices, uint32_t gridWidth, SDFMeshBaker::SignMode signMode = SDFMeshBaker::SignMode::WindingNumber);
+
         /** Set the signed distance values of the SDF grid from a file.
             \param[in] path The path of a .sdfg file.
             \return true if the values could be set, otherwise false.
@@ -236,6 +247,10 @@ namespace Falcor
     protected:
         virtual void setValuesInternal(const std::vector<float>& cornerValues) = 0;
 
+        /** Set the values of the SDF grid from a mesh. The default implementation bakes a dense grid of values and calls setValuesInternal().
+        */
+        virtual void setValuesFromMeshInternal(const SDFMeshBaker& baker, const SDFMeshBaker::Options& options);
+
         void createEvaluatePrimitivesPass(bool writeToTexture3D, bool mergeWithSDField);
 
         void updatePrimitivesBuffer();
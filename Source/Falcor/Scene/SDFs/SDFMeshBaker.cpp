@@ -0,0 +1,686 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SDFMeshBaker.h"
+#include "Core/Error.h"
+#include "Utils/Math/Common.h"
+#include "Utils/Math/MathConstants.slangh"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <execution>
+#include <cmath>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kMaxLeafSize = 4;
+        const uint32_t kMaxStackDepth = 64;
+
+        // Directions of the rays used for the ray parity test. They are chosen to not be aligned with the
+        // grid axes, as meshes often have edges and faces aligned with those and rays hitting them are ambiguous.
+        const float3 kParityRayDirs[3] =
+        {
+            float3(0.8017837f, 0.5345225f, 0.2672612f),
+            float3(-0.3015113f, 0.9045340f, -0.3015113f),
+            float3(0.1825742f, -0.3651484f, 0.9128709f),
+        };
+
+        template<typename Func>
+        void forEachIndex(bool parallel, uint32_t count, const Func& func)
+        {
+            if (parallel)
+            {
+                NumericRange<uint32_t> range(0, count);
+                std::for_each(std::execution::par, range.begin(), range.end(), func);
+            }
+            else
+            {
+                for (uint32_t i = 0; i < count; ++i) func(i);
+            }
+        }
+
+        float distanceSquared(const AABB& b, const float3& p)
+        {
+            float3 d = max(max(b.minPoint - p, p - b.maxPoint), float3(0.f));
+            return dot(d, d);
+        }
+
+        /** Closest point on a triangle, see Ericson, "Real-Time Collision Detection", section 5.1.5.
+        */
+        float3 closestPointOnTriangle(const float3& p, const float3& a, const float3& ab, const float3& ac)
+        {
+            float3 ap = p - a;
+            float d1 = dot(ab, ap);
+            float d2 = dot(ac, ap);
+            if (d1 <= 0.f && d2 <= 0.f) return a;
+
+            float3 bp = ap - ab;
+            float d3 = dot(ab, bp);
+            float d4 = dot(ac, bp);
+            if (d3 >= 0.f && d4 <= d3) return a + ab;
+
+            float vc = d1 * d4 - d3 * d2;
+            if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f) return a + ab * (d1 / (d1 - d3));
+
+            float3 cp = ap - ac;
+            float d5 = dot(ab, cp);
+            float d6 = dot(ac, cp);
+            if (d6 >= 0.f && d5 <= d6) return a + ac;
+
+            float vb = d5 * d2 - d1 * d6;
+            if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f) return a + ac * (d2 / (d2 - d6));
+
+            float va = d3 * d6 - d5 * d4;
+            if (va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f) return a + ab + (ac - ab) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+            float denom = 1.f / (va + vb + vc);
+            return a + ab * (vb * denom) + ac * (vc * denom);
+        }
+
+        /** Solid angle of a triangle as seen from the origin, see Van Oosterom and Strackee, "The Solid Angle of a Plane Triangle", 1983.
+            The solid angle is positive if the triangle is counter-clockwise when seen from the origin.
+        */
+        float solidAngle(const float3& a, const float3& b, const float3& c)
+        {
+            float la = length(a);
+            float lb = length(b);
+            float lc = length(c);
+            float numerator = dot(a, cross(b, c));
+            float denominator = la * lb * lc + dot(a, b) * lc + dot(a, c) * lb + dot(b, c) * la;
+            return 2.f * std::atan2(numerator, denominator);
+        }
+
+        bool intersectRayAABB(const float3& origin, const float3& invDir, const AABB& b, float tMax)
+        {
+            float3 t0 = (b.minPoint - origin) * invDir;
+            float3 t1 = (b.maxPoint - origin) * invDir;
+            float3 tNear = min(t0, t1);
+            float3 tFar = max(t0, t1);
+            float tEnter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.f));
+            float tExit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, tMax));
+            return tEnter <= tExit;
+        }
+
+        /** Ray/triangle intersection test, see Moeller and Trumbore, "Fast, Minimum Storage Ray/Triangle Intersection", 1997.
+        */
+        bool intersectRayTriangle(const float3& origin, const float3& dir, const float3& v0, const float3& e1, const float3& e2)
+        {
+            float3 s1 = cross(dir, e2);
+            float det = dot(s1, e1);
+            if (det == 0.f) return false;
+            float invDet = 1.f / det;
+
+            float3 d = origin - v0;
+            float b1 = dot(d, s1) * invDet;
+            if (b1 < 0.f || b1 > 1.f) return false;
+
+            float3 s2 = cross(d, e1);
+            float b2 = dot(dir, s2) * invDet;
+            if (b2 < 0.f || b1 + b2 > 1.f) return false;
+
+            return dot(e2, s2) * invDet > 0.f;
+        }
+
+        bool containsSurface(const int8_t values[8])
+        {
+            bool anyInside = false;
+            bool anyOutside = false;
+            for (uint32_t i = 0; i < 8; i++)
+            {
+                anyInside |= values[i] <= 0;
+                anyOutside |= values[i] >= 0;
+            }
+            return anyInside && anyOutside;
+        }
+
+        float3 getCornerPosition(const uint3& corner, uint32_t gridWidth)
+        {
+            return float3(corner) / float(gridWidth) - 0.5f;
+        }
+    }
+
+    std::vector<int8_t> SDFMeshBaker::Bricks::expand() const
+    {
+        uint32_t gridWidthInValues = gridWidth + 1;
+        uint32_t brickWidthInValues = brickWidth + 1;
+        uint32_t brickValueCount = brickWidthInValues * brickWidthInValues * brickWidthInValues;
+        std::vector<int8_t> sdField(size_t(gridWidthInValues) * gridWidthInValues * gridWidthInValues);
+
+        forEachIndex(true, gridWidthInValues, [&](uint32_t z)
+        {
+            for (uint32_t y = 0; y < gridWidthInValues; y++)
+            {
+                for (uint32_t x = 0; x < gridWidthInValues; x++)
+                {
+                    // Corners on brick boundaries are shared by up to eight bricks, take the value from any of them that holds a brick.
+                    uint3 corner(x, y, z);
+                    uint3 maxBrick = min(corner / brickWidth, uint3(virtualBricksPerAxis - 1));
+                    uint3 minBrick = maxBrick;
+                    for (uint32_t axis = 0; axis < 3; axis++)
+                    {
+                        if (corner[axis] > 0 && corner[axis] % brickWidth == 0) minBrick[axis] = std::min(minBrick[axis], corner[axis] / brickWidth - 1);
+                    }
+                    uint3 firstBrick = maxBrick;
+
+                    int8_t value = 0;
+                    bool found = false;
+                    for (uint32_t bz = minBrick.z; bz <= maxBrick.z && !found; bz++)
+                    {
+                        for (uint32_t by = minBrick.y; by <= maxBrick.y && !found; by++)
+                        {
+                            for (uint32_t bx = minBrick.x; bx <= maxBrick.x && !found; bx++)
+                            {
+                                uint32_t brickID = indirection[bx + virtualBricksPerAxis * (by + virtualBricksPerAxis * bz)];
+                                if (brickID == kInvalidBrick) continue;
+
+                                uint3 local = corner - uint3(bx, by, bz) * brickWidth;
+                                value = values[size_t(brickID) * brickValueCount + local.x + brickWidthInValues * (local.y + brickWidthInValues * local.z)];
+                                found = true;
+                            }
+                        }
+                    }
+
+                    if (!found)
+                    {
+                        value = fillValues[firstBrick.x + virtualBricksPerAxis * (firstBrick.y + virtualBricksPerAxis * firstBrick.z)];
+                    }
+
+                    sdField[x + gridWidthInValues * (y + size_t(gridWidthInValues) * z)] = value;
+                }
+            }
+        });
+
+        return sdField;
+    }
+
+    SDFMeshBaker::SDFMeshBaker(fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
+    {
+        FALCOR_CHECK(indices.size() % 3 == 0, "Index count ({}) must be a multiple of 3.", indices.size());
+
+        uint32_t triangleCount = uint32_t(indices.size() / 3);
+        mTriangles.resize(triangleCount);
+        std::vector<float3> centroids(triangleCount);
+        for (uint32_t i = 0; i < triangleCount; i++)
+        {
+            for (uint32_t j = 0; j < 3; j++)
+            {
+                FALCOR_CHECK(indices[3 * i + j] < positions.size(), "Vertex index {} is out of range.", indices[3 * i + j]);
+            }
+
+            const float3& v0 = positions[indices[3 * i + 0]];
+            const float3& v1 = positions[indices[3 * i + 1]];
+            const float3& v2 = positions[indices[3 * i + 2]];
+            mTriangles[i] = { v0, v1 - v0, v2 - v0 };
+            centroids[i] = (v0 + v1 + v2) / 3.f;
+        }
+
+        if (triangleCount > 0)
+        {
+            mNodes.reserve(2 * div_round_up(triangleCount, kMaxLeafSize));
+            buildNode(0, triangleCount, centroids);
+        }
+    }
+
+    uint32_t SDFMeshBaker::buildNode(uint32_t begin, uint32_t end, std::vector<float3>& centroids)
+    {
+        uint32_t nodeIndex = (uint32_t)mNodes.size();
+        mNodes.emplace_back();
+
+        // Compute the bounds and the dipole of the triangles in the node.
+        AABB bounds;
+        AABB centroidBounds;
+        float3 dipoleNormal(0.f);
+        float3 weightedCenter(0.f);
+        float areaSum = 0.f;
+        for (uint32_t i = begin; i < end; i++)
+        {
+            const Triangle& t = mTriangles[i];
+            bounds.include(t.v0).include(t.v0 + t.e1).include(t.v0 + t.e2);
+            centroidBounds.include(centroids[i]);
+
+            float3 areaNormal = 0.5f * cross(t.e1, t.e2);
+            float area = length(areaNormal);
+            dipoleNormal += areaNormal;
+            weightedCenter += area * centroids[i];
+            areaSum += area;
+        }
+
+        {
+            Node& node = mNodes[nodeIndex];
+            node.bounds = bounds;
+            node.dipoleNormal = dipoleNormal;
+            node.dipoleCenter = areaSum > 0.f ? weightedCenter / areaSum : bounds.center();
+            node.dipoleRadius = length(max(abs(bounds.minPoint - node.dipoleCenter), abs(bounds.maxPoint - node.dipoleCenter)));
+        }
+
+        float3 extent = centroidBounds.extent();
+        if (end - begin <= kMaxLeafSize || std::max(std::max(extent.x, extent.y), extent.z) <= 0.f)
+        {
+            mNodes[nodeIndex].offset = begin;
+            mNodes[nodeIndex].count = end - begin;
+            return nodeIndex;
+        }
+
+        // Split at the median centroid along the largest axis.
+        uint32_t axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+        uint32_t mid = begin + (end - begin) / 2;
+        std::vector<uint32_t> order(end - begin);
+        for (uint32_t i = 0; i < order.size(); i++) order[i] = begin + i;
+        std::nth_element(order.begin(), order.begin() + (mid - begin), order.end(), [&](uint32_t a, uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+
+        std::vector<Triangle> triangles(order.size());
+        std::vector<float3> sortedCentroids(order.size());
+        for (uint32_t i = 0; i < order.size(); i++)
+        {
+            triangles[i] = mTriangles[order[i]];
+            sortedCentroids[i] = centroids[order[i]];
+        }
+        std::copy(triangles.begin(), triangles.end(), mTriangles.begin() + begin);
+        std::copy(sortedCentroids.begin(), sortedCentroids.end(), centroids.begin() + begin);
+
+        buildNode(begin, mid, centroids);
+        uint32_t secondChild = buildNode(mid, end, centroids);
+        mNodes[nodeIndex].offset = secondChild;
+        return nodeIndex;
+    }
+
+    float SDFMeshBaker::distance(const float3& p, float maxDistance) const
+    {
+        if (mNodes.empty()) return std::numeric_limits<float>::infinity();
+
+        float bestDistanceSq = maxDistance * maxDistance;
+        bool found = false;
+
+        uint32_t stack[kMaxStackDepth];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = 0;
+
+        while (stackSize > 0)
+        {
+            const Node& node = mNodes[stack[--stackSize]];
+            if (distanceSquared(node.bounds, p) > bestDistanceSq) continue;
+
+            if (node.count > 0)
+            {
+                for (uint32_t i = node.offset; i < node.offset + node.count; i++)
+                {
+                    const Triangle& t = mTriangles[i];
+                    float3 d = closestPointOnTriangle(p, t.v0, t.e1, t.e2) - p;
+                    float distanceSq = dot(d, d);
+                    if (distanceSq <= bestDistanceSq)
+                    {
+                        bestDistanceSq = distanceSq;
+                        found = true;
+                    }
+                }
+            }
+            else
+            {
+                // Visit the closer child first.
+                uint32_t first = uint32_t(&node - mNodes.data()) + 1;
+                uint32_t second = node.offset;
+                if (distanceSquared(mNodes[first].bounds, p) < distanceSquared(mNodes[second].bounds, p)) std::swap(first, second);
+                FALCOR_ASSERT(stackSize + 2 <= kMaxStackDepth);
+                stack[stackSize++] = first;
+                stack[stackSize++] = second;
+            }
+        }
+
+        return found ? std::sqrt(bestDistanceSq) : std::numeric_limits<float>::infinity();
+    }
+
+    float SDFMeshBaker::windingNumber(const float3& p, float accuracy) const
+    {
+        if (mNodes.empty()) return 0.f;
+
+        float solidAngleSum = 0.f;
+
+        uint32_t stack[kMaxStackDepth];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = 0;
+
+        while (stackSize > 0)
+        {
+            uint32_t nodeIndex = stack[--stackSize];
+            const Node& node = mNodes[nodeIndex];
+
+            // Approximate distant nodes by a dipole at their center.
+            float3 d = node.dipoleCenter - p;
+            float distanceSq = dot(d, d);
+            if (accuracy > 0.f && distanceSq > (accuracy * node.dipoleRadius) * (accuracy * node.dipoleRadius))
+            {
+                solidAngleSum += dot(d, node.dipoleNormal) / (distanceSq * std::sqrt(distanceSq));
+                continue;
+            }
+
+            if (node.count > 0)
+            {
+                for (uint32_t i = node.offset; i < node.offset + node.count; i++)
+                {
+                    const Triangle& t = mTriangles[i];
+                    float3 a = t.v0 - p;
+                    solidAngleSum += solidAngle(a, a + t.e1, a + t.e2);
+                }
+            }
+            else
+            {
+                FALCOR_ASSERT(stackSize + 2 <= kMaxStackDepth);
+                stack[stackSize++] = nodeIndex + 1;
+                stack[stackSize++] = node.offset;
+            }
+        }
+
+        return solidAngleSum / (4.f * float(M_PI));
+    }
+
+    uint32_t SDFMeshBaker::countRayIntersections(const float3& origin, const float3& dir) const
+    {
+        if (mNodes.empty()) return 0;
+
+        float3 invDir = 1.f / dir;
+        uint32_t count = 0;
+
+        uint32_t stack[kMaxStackDepth];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = 0;
+
+        while (stackSize > 0)
+        {
+            uint32_t nodeIndex = stack[--stackSize];
+            const Node& node = mNodes[nodeIndex];
+            if (!intersectRayAABB(origin, invDir, node.bounds, std::numeric_limits<float>::infinity())) continue;
+
+            if (node.count > 0)
+            {
+                for (uint32_t i = node.offset; i < node.offset + node.count; i++)
+                {
+                    const Triangle& t = mTriangles[i];
+                    if (intersectRayTriangle(origin, dir, t.v0, t.e1, t.e2)) count++;
+                }
+            }
+            else
+            {
+                FALCOR_ASSERT(stackSize + 2 <= kMaxStackDepth);
+                stack[stackSize++] = nodeIndex + 1;
+                stack[stackSize++] = node.offset;
+            }
+        }
+
+        return count;
+    }
+
+    bool SDFMeshBaker::isInside(const float3& p, SignMode signMode) const
+    {
+        switch (signMode)
+        {
+        case SignMode::WindingNumber:
+            return std::abs(windingNumber(p)) > 0.5f;
+        case SignMode::RayParity:
+        {
+            uint32_t oddCount = 0;
+            for (const float3& dir : kParityRayDirs) oddCount += countRayIntersections(p, dir) & 1;
+            return oddCount >= 2;
+        }
+        default:
+            FALCOR_UNREACHABLE();
+            return false;
+        }
+    }
+
+    float SDFMeshBaker::signedDistance(const float3& p, SignMode signMode) const
+    {
+        float d = distance(p);
+        return isInside(p, signMode) ? -d : d;
+    }
+
+    std::vector<float> SDFMeshBaker::bakeValues(uint32_t gridWidth, const Options& options) const
+    {
+        FALCOR_CHECK(gridWidth > 0, "'gridWidth' must be larger than 0.");
+
+        uint32_t gridWidthInValues = gridWidth + 1;
+        std::vector<float> values(size_t(gridWidthInValues) * gridWidthInValues * gridWidthInValues);
+
+        const float maxDistance = float(M_SQRT3);
+        const float voxelWidth = 1.f / gridWidth;
+
+        forEachIndex(options.parallel, gridWidthInValues * gridWidthInValues, [&](uint32_t row)
+        {
+            uint32_t y = row % gridWidthInValues;
+            uint32_t z = row / gridWidthInValues;
+            float* pRow = values.data() + size_t(row) * gridWidthInValues;
+
+            // The sign can only change between two neighboring corners if the surface passes between them,
+            // which is not possible if the distance at the first corner is larger than the voxel width.
+            float prevDistance = 0.f;
+            bool prevInside = false;
+            for (uint32_t x = 0; x < gridWidthInValues; x++)
+            {
+                float3 p = getCornerPosition(uint3(x, y, z), gridWidth);
+                float d = std::min(distance(p, maxDistance), maxDistance);
+                bool inside = (x > 0 && prevDistance > voxelWidth) ? prevInside : isInside(p, options.signMode);
+                pRow[x] = inside ? -d : d;
+                prevDistance = d;
+                prevInside = inside;
+            }
+        });
+
+        return values;
+    }
+
+    void SDFMeshBaker::bakeBrick(uint32_t gridWidth, uint32_t brickWidth, const uint3& brickCoords, SignMode signMode, std::vector<float>& distances, std::vector<int8_t>& signs, int8_t* pValues) const
+    {
+        const uint32_t brickWidthInValues = brickWidth + 1;
+        const uint32_t valueCount = brickWidthInValues * brickWidthInValues * brickWidthInValues;
+        const float voxelWidth = 1.f / gridWidth;
+        const uint3 brickGridCoords = brickCoords * brickWidth;
+
+        auto getCorner = [&](uint32_t i)
+        {
+            return uint3(i % brickWidthInValues, (i / brickWidthInValues) % brickWidthInValues, i / (brickWidthInValues * brickWidthInValues));
+        };
+
+        // Compute unsigned distances. Values further away than a voxel width saturate and are only needed for their sign.
+        // Corners outside of the grid are set to positive values, the same way as the GPU builder does.
+        distances.resize(valueCount);
+        signs.assign(valueCount, 0);
+        for (uint32_t i = 0; i < valueCount; i++)
+        {
+            uint3 corner = brickGridCoords + getCorner(i);
+            if (any(corner > uint3(gridWidth)))
+            {
+                distances[i] = -1.f;
+                signs[i] = 1;
+                continue;
+            }
+            distances[i] = distance(getCornerPosition(corner, gridWidth), voxelWidth);
+        }
+
+        // Compute the signs. A corner further away from the surface than the voxel width has the same sign as all its neighbors,
+        // so the sign of each region connected through such corners only needs to be evaluated once.
+        std::vector<uint32_t> stack;
+        for (uint32_t i = 0; i < valueCount; i++)
+        {
+            if (signs[i] != 0) continue;
+
+            int8_t sign = isInside(getCornerPosition(brickGridCoords + getCorner(i), gridWidth), signMode) ? -1 : 1;
+            signs[i] = sign;
+            if (distances[i] <= voxelWidth) continue;
+
+            stack.push_back(i);
+            while (!stack.empty())
+            {
+                uint3 corner = getCorner(stack.back());
+                stack.pop_back();
+
+                for (uint32_t axis = 0; axis < 3; axis++)
+                {
+                    for (int step : { -1, 1 })
+                    {
+                        int3 neighbor = int3(corner);
+                        neighbor[axis] += step;
+                        if (any(neighbor < int3(0)) || any(neighbor >= int3(brickWidthInValues))) continue;
+
+                        uint32_t j = neighbor.x + brickWidthInValues * (neighbor.y + brickWidthInValues * neighbor.z);
+                        if (signs[j] != 0) continue;
+                        signs[j] = sign;
+                        if (distances[j] > voxelWidth) stack.push_back(j);
+                    }
+                }
+            }
+        }
+
+        for (uint32_t i = 0; i < valueCount; i++)
+        {
+            pValues[i] = distances[i] < 0.f ? INT8_MAX : quantize(signs[i] * distances[i], gridWidth);
+        }
+    }
+
+    SDFMeshBaker::Bricks SDFMeshBaker::bakeBricks(uint32_t gridWidth, const Options& options) const
+    {
+        FALCOR_CHECK(gridWidth > 0, "'gridWidth' must be larger than 0.");
+        FALCOR_CHECK(options.brickWidth > 0, "'brickWidth' must be larger than 0.");
+
+        Bricks bricks;
+        bricks.gridWidth = gridWidth;
+        bricks.brickWidth = options.brickWidth;
+        bricks.virtualBricksPerAxis = div_round_up(gridWidth, options.brickWidth);
+
+        const uint32_t brickWidth = options.brickWidth;
+        const uint32_t brickWidthInValues = brickWidth + 1;
+        const uint32_t brickValueCount = brickWidthInValues * brickWidthInValues * brickWidthInValues;
+        const uint32_t virtualBricksPerAxis = bricks.virtualBricksPerAxis;
+        const uint32_t virtualBrickCount = virtualBricksPerAxis * virtualBricksPerAxis * virtualBricksPerAxis;
+        const float halfVoxelDiagonal = 0.5f * float(M_SQRT3) / gridWidth;
+
+        auto getBrickCoords = [&](uint32_t virtualBrickID)
+        {
+            return uint3(virtualBrickID % virtualBricksPerAxis, (virtualBrickID / virtualBricksPerAxis) % virtualBricksPerAxis, virtualBrickID / (virtualBricksPerAxis * virtualBricksPerAxis));
+        };
+
+        // Find the bricks that may contain the surface. Bricks without any triangle closer than half the brick diagonal to their center
+        // cannot contain the surface, so their corners all have the same sign. The query is extended by half a voxel diagonal
+        // to also catch corners that quantize to zero.
+        bricks.indirection.assign(virtualBrickCount, Bricks::kInvalidBrick);
+        bricks.fillValues.assign(virtualBrickCount, INT8_MAX);
+        std::vector<uint8_t> isCandidate(virtualBrickCount, 0);
+
+        forEachIndex(options.parallel, virtualBrickCount, [&](uint32_t virtualBrickID)
+        {
+            uint3 brickCoords = getBrickCoords(virtualBrickID);
+            uint3 minCorner = brickCoords * brickWidth;
+            uint3 maxCorner = min(minCorner + brickWidth, uint3(gridWidth));
+            float3 pMin = getCornerPosition(minCorner, gridWidth);
+            float3 pMax = getCornerPosition(maxCorner, gridWidth);
+            float3 center = 0.5f * (pMin + pMax);
+            float radius = 0.5f * length(pMax - pMin) + halfVoxelDiagonal;
+
+            if (distance(center, radius) <= radius)
+            {
+                isCandidate[virtualBrickID] = 1;
+            }
+            else
+            {
+                bricks.fillValues[virtualBrickID] = isInside(center, options.signMode) ? -INT8_MAX : INT8_MAX;
+            }
+        });
+
+        std::vector<uint32_t> candidates;
+        for (uint32_t virtualBrickID = 0; virtualBrickID < virtualBrickCount; virtualBrickID++)
+        {
+            if (isCandidate[virtualBrickID]) candidates.push_back(virtualBrickID);
+        }
+
+        // Evaluate the candidate bricks and check if they contain a voxel with the surface in it.
+        std::vector<int8_t> candidateValues(candidates.size() * brickValueCount);
+        std::vector<uint8_t> isValid(candidates.size(), 0);
+
+        forEachIndex(options.parallel, (uint32_t)candidates.size(), [&](uint32_t candidateIndex)
+        {
+            thread_local std::vector<float> distances;
+            thread_local std::vector<int8_t> signs;
+
+            uint32_t virtualBrickID = candidates[candidateIndex];
+            uint3 brickCoords = getBrickCoords(virtualBrickID);
+            int8_t* pValues = candidateValues.data() + size_t(candidateIndex) * brickValueCount;
+            bakeBrick(gridWidth, brickWidth, brickCoords, options.signMode, distances, signs, pValues);
+
+            uint3 voxelCount = min(uint3(brickWidth), uint3(gridWidth) - brickCoords * brickWidth);
+            auto getValue = [&](uint32_t x, uint32_t y, uint32_t z) { return pValues[x + brickWidthInValues * (y + brickWidthInValues * z)]; };
+
+            for (uint32_t z = 0; z < voxelCount.z && !isValid[candidateIndex]; z++)
+            {
+                for (uint32_t y = 0; y < voxelCount.y && !isValid[candidateIndex]; y++)
+                {
+                    for (uint32_t x = 0; x < voxelCount.x; x++)
+                    {
+                        int8_t values[8] =
+                        {
+                            getValue(x, y, z), getValue(x + 1, y, z), getValue(x, y + 1, z), getValue(x + 1, y + 1, z),
+                            getValue(x, y, z + 1), getValue(x + 1, y, z + 1), getValue(x, y + 1, z + 1), getValue(x + 1, y + 1, z + 1),
+                        };
+                        if (containsSurface(values))
+                        {
+                            isValid[candidateIndex] = 1;
+                            break;
+                        }
+                    }
+                }
+            }
+
+            // All corners of a brick without surface have the same sign.
+            if (!isValid[candidateIndex]) bricks.fillValues[virtualBrickID] = pValues[0] < 0 ? -INT8_MAX : INT8_MAX;
+        });
+
+        // Assign brick IDs in virtual brick order and compact the values.
+        uint32_t brickCount = 0;
+        for (uint32_t candidateIndex = 0; candidateIndex < candidates.size(); candidateIndex++)
+        {
+            if (!isValid[candidateIndex]) continue;
+
+            if (brickCount != candidateIndex)
+            {
+                std::copy_n(candidateValues.begin() + size_t(candidateIndex) * brickValueCount, brickValueCount, candidateValues.begin() + size_t(brickCount) * brickValueCount);
+            }
+            bricks.indirection[candidates[candidateIndex]] = brickCount++;
+        }
+        candidateValues.resize(size_t(brickCount) * brickValueCount);
+        candidateValues.shrink_to_fit();
+        bricks.values = std::move(candidateValues);
+
+        return bricks;
+    }
+
+    int8_t SDFMeshBaker::quantize(float distance, uint32_t gridWidth)
+    {
+        // Same normalization as SDFSBS::setValuesInternal(), a value of 1 represents half a voxel diagonal.
+        float normalizationFactor = 2.0f * gridWidth / float(M_SQRT3);
+        float normalizedValue = std::clamp(distance * normalizationFactor, -1.0f, 1.0f);
+        float integerScale = normalizedValue * float(INT8_MAX);
+        return integerScale >= 0.0f ? int8_t(integerScale + 0.5f) : int8_t(integerScale - 0.5f);
+    }
+}
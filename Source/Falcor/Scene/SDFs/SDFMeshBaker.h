@@ -0,0 +1,165 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/AABB.h"
+#include "Utils/Math/Vector.h"
+#include <fstd/span.h> // TODO C++20: Replace with <span>
+#include <limits>
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+    /** Multithreaded CPU baker that converts triangle meshes into SDF grid values.
+
+        The mesh is expected to be in the local space of the SDF grid, i.e., [-0.5, 0.5]^3.
+        Unsigned distances are found using a BVH over the triangles, and the inside/outside sign is
+        computed either from the generalized winding number or from ray parity. The winding number is
+        robust to small holes and self-intersections. It is evaluated hierarchically using a dipole
+        approximation for distant BVH nodes.
+
+        The SDF grids store distances normalized so that 1 represents half a voxel diagonal, so the
+        distance field only needs to be resolved in a narrow band around the surface. bakeBricks() makes use
+        of this and only evaluates bricks that intersect the surface. It produces the sparse brick layout
+        used by SDFSBS without allocating a dense grid.
+    */
+    class FALCOR_API SDFMeshBaker
+    {
+    public:
+        enum class SignMode
+        {
+            WindingNumber,  ///< Inside if the generalized winding number is larger than 0.5 in magnitude.
+            RayParity,      ///< Inside if the majority of three rays has an odd number of intersections.
+        };
+
+        struct Options
+        {
+            SignMode signMode = SignMode::WindingNumber;
+            uint32_t brickWidth = 7;    ///< Width of a brick in voxels (bakeBricks() only).
+            bool parallel = true;       ///< Evaluate the grid on multiple threads.
+        };
+
+        /** Sparse set of bricks in the layout used by SDFSBS.
+            Each virtual brick covers brickWidth^3 voxels and stores (brickWidth + 1)^3 corner values.
+            Only bricks containing at least one voxel with a surface in it are stored.
+        */
+        struct Bricks
+        {
+            static constexpr uint32_t kInvalidBrick = std::numeric_limits<uint32_t>::max();
+
+            uint32_t gridWidth = 0;
+            uint32_t brickWidth = 0;
+            uint32_t virtualBricksPerAxis = 0;
+            std::vector<uint32_t> indirection;  ///< Brick ID for each virtual brick, or kInvalidBrick. Virtual bricks are ordered x fastest, then y, then z.
+            std::vector<int8_t> fillValues;     ///< Value of all corners of each virtual brick without a brick, -127 if inside and 127 if outside.
+            std::vector<int8_t> values;         ///< Normalized snorm corner values of all bricks. Values within a brick are ordered x fastest, then y, then z.
+
+            uint32_t getBrickCount() const { return brickWidth == 0 ? 0 : uint32_t(values.size() / ((brickWidth + 1) * (brickWidth + 1) * (brickWidth + 1))); }
+            bool empty() const { return indirection.empty(); }
+
+            /** Expand the bricks into a dense grid of (gridWidth + 1)^3 normalized snorm corner values.
+            */
+            std::vector<int8_t> expand() const;
+        };
+
+        /** Build the BVH over a triangle mesh.
+            Throws an exception if the mesh has out of range indices.
+            \param[in] positions Vertex positions in the local space of the SDF grid.
+            \param[in] indices Triangle vertex indices.
+        */
+        SDFMeshBaker(fstd::span<const float3> positions, fstd::span<const uint32_t> indices);
+
+        /** Compute the unsigned distance to the closest triangle.
+            \param[in] p Query position.
+            \param[in] maxDistance Triangles further away than this are ignored.
+            \return The distance to the closest triangle, or infinity if no triangle is within maxDistance.
+        */
+        float distance(const float3& p, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+        /** Compute the generalized winding number of the mesh at a point.
+            \param[in] p Query position.
+            \param[in] accuracy BVH nodes whose distance is larger than accuracy times their radius are approximated. Use 0 for the exact winding number.
+        */
+        float windingNumber(const float3& p, float accuracy = 2.f) const;
+
+        /** Check if a point is inside the mesh.
+        */
+        bool isInside(const float3& p, SignMode signMode) const;
+
+        /** Compute the signed distance to the mesh, negative inside.
+        */
+        float signedDistance(const float3& p, SignMode signMode) const;
+
+        /** Bake the mesh into a dense grid of corner values.
+            \param[in] gridWidth The grid width in voxels, the result has (gridWidth + 1)^3 values.
+            \param[in] options Baking options.
+            \return Signed distances in the local space of the grid, clamped to [-sqrt(3), sqrt(3)]. Values are ordered x fastest, then y, then z.
+        */
+        std::vector<float> bakeValues(uint32_t gridWidth, const Options& options) const;
+
+        /** Bake the narrow band around the mesh into a sparse set of bricks.
+            \param[in] gridWidth The grid width in voxels.
+            \param[in] options Baking options.
+            \return The bricks, the values are quantized the same way as SDFSBS quantizes values set with SDFGrid::setValues().
+        */
+        Bricks bakeBricks(uint32_t gridWidth, const Options& options) const;
+
+        /** Quantize a distance to the normalized snorm representation used by SDF grids with the given width.
+        */
+        static int8_t quantize(float distance, uint32_t gridWidth);
+
+        uint32_t getTriangleCount() const { return (uint32_t)mTriangles.size(); }
+        AABB getBounds() const { return mNodes.empty() ? AABB() : mNodes[0].bounds; }
+
+    private:
+        struct Triangle
+        {
+            float3 v0;
+            float3 e1;
+            float3 e2;
+        };
+
+        struct Node
+        {
+            AABB bounds;
+            float3 dipoleCenter;        ///< Area weighted centroid of the triangles in the node.
+            float3 dipoleNormal;        ///< Sum of the area weighted normals of the triangles in the node.
+            float dipoleRadius = 0.f;   ///< Distance from the dipole center to the farthest corner of the bounds.
+            uint32_t offset = 0;        ///< Index of the first triangle for leaves, index of the second child for interior nodes (the first child follows the node).
+            uint32_t count = 0;         ///< Number of triangles for leaves, 0 for interior nodes.
+        };
+
+        uint32_t buildNode(uint32_t begin, uint32_t end, std::vector<float3>& centroids);
+        uint32_t countRayIntersections(const float3& origin, const float3& dir) const;
+        void bakeBrick(uint32_t gridWidth, uint32_t brickWidth, const uint3& brickCoords, SignMode signMode, std::vector<float>& distances, std::vector<int8_t>& signs, int8_t* pValues) const;
+
+        std::vector<Triangle> mTriangles;
+        std::vector<Node> mNodes;
+    };
+}
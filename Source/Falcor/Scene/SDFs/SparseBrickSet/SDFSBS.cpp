@@ -31,6 +31,7 @@
 #include "Core/API/IndirectCommands.h"
 #include "Utils/Math/MathHelpers.h"
 #include "Utils/Math/MathConstants.slangh"
+#include "Utils/Logger.h"
 #include "Utils/SharedCache.h"
 #include "Scene/SDFs/SDFVoxelTypes.slang"
 
@@ -100,9 +101,11 @@ namespace Falcor
     SDFGrid::UpdateFlags SDFSBS::update(RenderContext* pRenderContext)
     {
         // No update is performed if the SDF grid isn't dirty or isn't constructed from primitives and should not be created as an empty grid.
-        bool isEmpty = mPrimitives.empty() && !mpSDFGridTexture && !mWasEmpty;
+        bool isEmpty = mPrimitives.empty() && !mpSDFGridTexture && mBricks.empty() && !mWasEmpty;
         if ((!mPrimitivesDirty || (mPrimitives.empty() && !mHasGridRepresentation)) && !isEmpty) return UpdateFlags::None;
 
+        if (!mBricks.empty() && !mPrimitives.empty()) expandBricksToSDField();
+
         // Update grid texture, if user loads an sdf-file.
         if (!mSDField.empty())
         {
@@ -116,6 +119,8 @@ namespace Falcor
     {
         FALCOR_ASSERT(pRenderContext);
 
+        if (!mBricks.empty() && !mPrimitives.empty()) expandBricksToSDField();
+
         // Update grid texture, if user loads an sdf-file.
         if (!mSDField.empty())
         {
@@ -127,6 +132,10 @@ namespace Falcor
         {
             createResourcesFromPrimitivesAndSDField(pRenderContext, deleteScratchData);
         }
+        else if (!mBricks.empty())
+        {
+            createResourcesFromBricks(pRenderContext);
+        }
         else if (mPrimitives.empty() && mpSDFGridTexture != nullptr)
         {
             createResourcesFromSDField(pRenderContext, deleteScratchData);
@@ -354,6 +363,85 @@ namespace Falcor
         mWasEmpty = false;
     }
 
+    void SDFSBS::createResourcesFromBricks(RenderContext* pRenderContext)
+    {
+        FALCOR_ASSERT(mBricks.gridWidth == mGridWidth && mBricks.brickWidth == mBrickWidth);
+
+        mVirtualBricksPerAxis = mBricks.virtualBricksPerAxis;
+        mBrickCount = mBricks.getBrickCount();
+
+        // Create the indirection texture.
+        {
+            if (mpIndirectionTexture && mpIndirectionTexture->getWidth() == mVirtualBricksPerAxis)
+            {
+                pRenderContext->updateTextureData(mpIndirectionTexture.get(), mBricks.indirection.data());
+            }
+            else
+            {
+                mpIndirectionTexture = mpDevice->createTexture3D(mVirtualBricksPerAxis, mVirtualBricksPerAxis, mVirtualBricksPerAxis, ResourceFormat::R32Uint, 1, mBricks.indirection.data(), ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess);
+                mpIndirectionTexture->setName("SDFSBS::IndirectionTextureValues");
+            }
+        }
+
+        // Create the brick texture using the same layout as createResourcesFromSDField().
+        {
+            uint32_t brickWidthInValues = mBrickWidth + 1;
+            uint32_t bricksAlongX = (uint32_t)std::ceil(std::sqrt((float)mBrickCount / brickWidthInValues));
+            uint32_t bricksAlongY = (uint32_t)std::ceil((float)mBrickCount / bricksAlongX);
+            uint32_t textureWidth = brickWidthInValues * brickWidthInValues * bricksAlongX;
+            uint32_t textureHeight = brickWidthInValues * bricksAlongY;
+
+            std::vector<int8_t> textureData(size_t(textureWidth) * textureHeight, INT8_MAX);
+            for (uint32_t brickID = 0; brickID < mBrickCount; brickID++)
+            {
+                uint2 brickTextureCoords = uint2(brickID % bricksAlongX, brickID / bricksAlongX) * uint2(brickWidthInValues * brickWidthInValues, brickWidthInValues);
+                const int8_t* pBrickValues = mBricks.values.data() + size_t(brickID) * brickWidthInValues * brickWidthInValues * brickWidthInValues;
+
+                for (uint32_t z = 0; z < brickWidthInValues; z++)
+                {
+                    for (uint32_t y = 0; y < brickWidthInValues; y++)
+                    {
+                        int8_t* pDst = textureData.data() + size_t(brickTextureCoords.y + y) * textureWidth + brickTextureCoords.x + z * brickWidthInValues;
+                        std::copy_n(pBrickValues + brickWidthInValues * (y + brickWidthInValues * z), brickWidthInValues, pDst);
+                    }
+                }
+            }
+
+            if (mpBrickTexture && all(mBrickTextureDimensions == uint2(textureWidth, textureHeight)) && mpBrickTexture->getFormat() == ResourceFormat::R8Snorm)
+            {
+                pRenderContext->updateTextureData(mpBrickTexture.get(), textureData.data());
+            }
+            else
+            {
+                mpBrickTexture = mpDevice->createTexture2D(textureWidth, textureHeight, ResourceFormat::R8Snorm, 1, 1, textureData.data(), ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource);
+            }
+
+            mBricksPerAxis = uint2(bricksAlongX, bricksAlongY);
+            mBrickTextureDimensions = uint2(textureWidth, textureHeight);
+        }
+
+        // Create brick AABBs, matching the ones created on the GPU.
+        {
+            std::vector<AABB> brickAABBs(mBrickCount);
+            const float oneOverGridWidth = 1.0f / float(mGridWidth);
+            uint32_t virtualBrickCount = mVirtualBricksPerAxis * mVirtualBricksPerAxis * mVirtualBricksPerAxis;
+            for (uint32_t virtualBrickID = 0; virtualBrickID < virtualBrickCount; virtualBrickID++)
+            {
+                uint32_t brickID = mBricks.indirection[virtualBrickID];
+                if (brickID == SDFMeshBaker::Bricks::kInvalidBrick) continue;
+
+                uint3 virtualBrickCoords(virtualBrickID % mVirtualBricksPerAxis, (virtualBrickID / mVirtualBricksPerAxis) % mVirtualBricksPerAxis, virtualBrickID / (mVirtualBricksPerAxis * mVirtualBricksPerAxis));
+                float3 brickAABBMin = -0.5f + float3(virtualBrickCoords * mBrickWidth) * oneOverGridWidth;
+                float3 brickAABBMax = min(brickAABBMin + float(mBrickWidth) * oneOverGridWidth, float3(0.5f));
+                brickAABBs[brickID] = AABB(brickAABBMin, brickAABBMax);
+            }
+
+            mpBrickAABBsBuffer = mpDevice->createStructuredBuffer(sizeof(AABB), mBrickCount, ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, brickAABBs.data(), false);
+        }
+
+        mWasEmpty = false;
+    }
+
     SDFGrid::UpdateFlags SDFSBS::createResourcesFromPrimitivesAndSDField(RenderContext* pRenderContext, bool deleteScratchData)
     {
         // Assume AABBs will change.
@@ -974,6 +1062,8 @@ namespace Falcor
 
     void SDFSBS::setValuesInternal(const std::vector<float>& cornerValues)
     {
+        mBricks = {};
+
         uint32_t gridWidthInValues = mGridWidth + 1;
         uint32_t valueCount = gridWidthInValues * gridWidthInValues * gridWidthInValues;
         mSDField.resize(valueCount);
@@ -988,6 +1078,32 @@ namespace Falcor
         }
     }
 
+    void SDFSBS::setValuesFromMeshInternal(const SDFMeshBaker& baker, const SDFMeshBaker::Options& options)
+    {
+        SDFMeshBaker::Options brickOptions = options;
+        brickOptions.brickWidth = mBrickWidth;
+        mBricks = baker.bakeBricks(mGridWidth, brickOptions);
+        mSDField.clear();
+
+        // The mesh does not intersect the grid, create an empty grid.
+        if (mBricks.getBrickCount() == 0)
+        {
+            logWarning("SDFSBS::setValuesFromMesh() mesh does not intersect the grid.");
+            mBricks = {};
+            return;
+        }
+
+        // Compressed bricks are encoded on the GPU, which is only done when creating bricks from an SD field.
+        if (mCompressed) expandBricksToSDField();
+    }
+
+    void SDFSBS::expandBricksToSDField()
+    {
+        FALCOR_ASSERT(!mBricks.empty());
+        mSDField = mBricks.expand();
+        mBricks = {};
+    }
+
     void SDFSBS::createSDFGridTexture(RenderContext* pRenderContext, const std::vector<int8_t>& sdField)
     {
         FALCOR_CHECK(!sdField.empty(), "Cannot create SDF grid texture from empty values vector");
@@ -71,6 +71,7 @@ namespace Falcor
 
     protected:
         void createResourcesFromSDField(RenderContext* pRenderContext, bool deleteScratchData);
+        void createResourcesFromBricks(RenderContext* pRenderContext);
         SDFGrid::UpdateFlags createResourcesFromPrimitivesAndSDField(RenderContext* pRenderContext, bool deleteScratchData);
 
         void expandSDFGridTexture(RenderContext* pRenderContext, bool deleteScratchData, uint32_t oldGridWidthInSDField, uint32_t gridWidthInSDField);
@@ -79,6 +80,12 @@ namespace Falcor
         void allocatePrimitiveBits();
 
         virtual void setValuesInternal(const std::vector<float>& cornerValues) override;
+        virtual void setValuesFromMeshInternal(const SDFMeshBaker& baker, const SDFMeshBaker::Options& options) override;
+
+        /** Expand the bricks baked from a mesh into the SD field.
+            Primitives are applied on the GPU to the values in the SD field, so this is needed before a baked grid can be combined with primitives.
+        */
+        void expandBricksToSDField();
 
         void createSDFGridTexture(RenderContext* pRenderContext, const std::vector<int8_t>& sdField);
 
@@ -89,6 +96,7 @@ namespace Falcor
     private:
         // CPU data.
         std::vector<int8_t> mSDField;
+        SDFMeshBaker::Bricks mBricks;                   ///< Bricks baked from a mesh. Kept after upload, as they need to be expanded to an SD field if primitives are added.
 
         // Specs.
         uint32_t mDefaultGridWidth = 0;                 ///< The grid width used if the grid was not loaded from a file (it is empty).
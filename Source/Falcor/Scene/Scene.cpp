@@ -29,6 +29,7 @@
 #include "SceneDefines.slangh"
 #include "SceneBuilder.h"
 #include "Importer.h"
+#include "InstanceDescUpdate.h"
 #include "Scene/Material/SerializedMaterialParams.h"
 #include "Curves/CurveConfig.h"
 #include "SDFs/SDFGrid.h"
@@ -143,6 +144,9 @@ namespace Falcor
         {
             return determinant(float3x3(m)) < 0.f;
         }
+
+        // Mesh groups with at least this many instances have their instance descs generated in parallel.
+        const size_t kMinParallelInstanceDescCount = 1024;
     }
 
     const FileDialogFilterVec& Scene::getFileExtensionFilters()
@@ -185,6 +189,23 @@ namespace Falcor
         mGeometryInstanceData.insert(std::end(mGeometryInstanceData), std::begin(sceneData.curveInstanceData), std::end(sceneData.curveInstanceData));
         mGeometryInstanceData.insert(std::end(mGeometryInstanceData), std::begin(sceneData.sdfGridInstances), std::end(sceneData.sdfGridInstances));
 
+        // Build the global matrix -> geometry instances map (CSR layout) used to find the instances affected by animation.
+        {
+            uint32_t matrixCount = (uint32_t)mSceneGraph.size();
+            for (const auto& inst : mGeometryInstanceData) matrixCount = std::max(matrixCount, inst.globalMatrixID + 1);
+
+            mMatrixInstanceOffsets.assign(matrixCount + 1, 0);
+            for (const auto& inst : mGeometryInstanceData) mMatrixInstanceOffsets[inst.globalMatrixID + 1]++;
+            std::partial_sum(mMatrixInstanceOffsets.begin(), mMatrixInstanceOffsets.end(), mMatrixInstanceOffsets.begin());
+
+            std::vector<uint32_t> cursor(mMatrixInstanceOffsets.begin(), mMatrixInstanceOffsets.end() - 1);
+            mMatrixInstanceIDs.resize(mGeometryInstanceData.size());
+            for (uint32_t i = 0; i < (uint32_t)mGeometryInstanceData.size(); i++)
+            {
+                mMatrixInstanceIDs[cursor[mGeometryInstanceData[i].globalMatrixID]++] = i;
+            }
+        }
+
         mMeshDesc = std::move(sceneData.meshDesc);
         mMeshNames = std::move(sceneData.meshNames);
         mMeshBBs = std::move(sceneData.meshBBs);
@@ -226,6 +247,18 @@ namespace Falcor
         // Setup volume grid -> id map.
         for (size_t i = 0; i < mGrids.size(); ++i) mGridIDs.emplace(mGrids[i], (uint32_t)i);
 
+        // Reserve a grid binding for each streamed grid sequence. The bound grid changes with the selected frame.
+        mStreamedGridIDs.resize(mGridVolumes.size());
+        for (size_t i = 0; i < mGridVolumes.size(); ++i)
+        {
+            for (uint32_t slotIndex = 0; slotIndex < (uint32_t)GridVolume::GridSlot::Count; ++slotIndex)
+            {
+                if (!mGridVolumes[i]->getGridSequenceStreamer((GridVolume::GridSlot)slotIndex)) continue;
+                mStreamedGridIDs[i][slotIndex] = SdfGridID(mGrids.size());
+                mGrids.push_back(mGridVolumes[i]->getGrid((GridVolume::GridSlot)slotIndex));
+            }
+        }
+
         // Set default SDF grid config.
         setSDFGridConfig();
 
@@ -263,7 +296,7 @@ namespace Falcor
         }
 
         // Must be placed after curve data/AABB creation.
-        mpAnimationController->addAnimatedVertexCaches(std::move(sceneData.cachedCurves), std::move(sceneData.cachedMeshes));
+        mpAnimationController->addAnimatedVertexCaches(std::move(sceneData.cachedCurves), std::move(sceneData.cachedMeshes), sceneData.streamVertexCaches);
 
         // Finalize scene.
         finalize();
@@ -906,39 +939,63 @@ namespace Falcor
     {
         if (mGeometryInstanceData.empty()) return;
 
-        bool dataChanged = false;
         const auto& globalMatrices = mpAnimationController->getGlobalMatrices();
 
-        for (auto& inst : mGeometryInstanceData)
+        // Updates the instance flags that depend on the global transform. Returns true if the flags changed.
+        auto updateInstanceFlags = [&](GeometryInstanceData& inst)
         {
-            if (inst.getType() == GeometryType::TriangleMesh || inst.getType() == GeometryType::DisplacedTriangleMesh)
-            {
-                uint32_t prevFlags = inst.flags;
+            if (inst.getType() != GeometryType::TriangleMesh && inst.getType() != GeometryType::DisplacedTriangleMesh) return false;
 
-                FALCOR_ASSERT(inst.globalMatrixID < globalMatrices.size());
-                const float4x4& transform = globalMatrices[inst.globalMatrixID];
-                bool isTransformFlipped = doesTransformFlip(transform);
-                bool isObjectFrontFaceCW = getMesh(MeshID::fromSlang(inst.geometryID)).isFrontFaceCW();
-                bool isWorldFrontFaceCW = isObjectFrontFaceCW ^ isTransformFlipped;
+            uint32_t prevFlags = inst.flags;
 
-                if (isTransformFlipped) inst.flags |= (uint32_t)GeometryInstanceFlags::TransformFlipped;
-                else inst.flags &= ~(uint32_t)GeometryInstanceFlags::TransformFlipped;
+            FALCOR_ASSERT(inst.globalMatrixID < globalMatrices.size());
+            const float4x4& transform = globalMatrices[inst.globalMatrixID];
+            bool isTransformFlipped = doesTransformFlip(transform);
+            bool isObjectFrontFaceCW = getMesh(MeshID::fromSlang(inst.geometryID)).isFrontFaceCW();
+            bool isWorldFrontFaceCW = isObjectFrontFaceCW ^ isTransformFlipped;
 
-                if (isObjectFrontFaceCW) inst.flags |= (uint32_t)GeometryInstanceFlags::IsObjectFrontFaceCW;
-                else inst.flags &= ~(uint32_t)GeometryInstanceFlags::IsObjectFrontFaceCW;
+            if (isTransformFlipped) inst.flags |= (uint32_t)GeometryInstanceFlags::TransformFlipped;
+            else inst.flags &= ~(uint32_t)GeometryInstanceFlags::TransformFlipped;
 
-                if (isWorldFrontFaceCW) inst.flags |= (uint32_t)GeometryInstanceFlags::IsWorldFrontFaceCW;
-                else inst.flags &= ~(uint32_t)GeometryInstanceFlags::IsWorldFrontFaceCW;
+            if (isObjectFrontFaceCW) inst.flags |= (uint32_t)GeometryInstanceFlags::IsObjectFrontFaceCW;
+            else inst.flags &= ~(uint32_t)GeometryInstanceFlags::IsObjectFrontFaceCW;
 
-                dataChanged |= (inst.flags != prevFlags);
-            }
-        }
+            if (isWorldFrontFaceCW) inst.flags |= (uint32_t)GeometryInstanceFlags::IsWorldFrontFaceCW;
+            else inst.flags &= ~(uint32_t)GeometryInstanceFlags::IsWorldFrontFaceCW;
+
+            return inst.flags != prevFlags;
+        };
 
-        if (forceUpdate || dataChanged)
+        if (forceUpdate)
         {
+            // Update all instances and upload the whole buffer.
+            std::for_each(std::execution::par, mGeometryInstanceData.begin(), mGeometryInstanceData.end(), [&](GeometryInstanceData& inst) { updateInstanceFlags(inst); });
+
             uint32_t byteSize = (uint32_t)(mGeometryInstanceData.size() * sizeof(GeometryInstanceData));
             mpGeometryInstancesBuffer->setBlob(mGeometryInstanceData.data(), 0, byteSize);
+            return;
+        }
+
+        // Only instances whose global matrix changed this frame can have their flags changed.
+        // Each instance is written by one thread only, so they can be updated concurrently.
+        std::vector<uint8_t> flagsChanged(mChangedGeometryInstances.size(), 0);
+        auto range = NumericRange<size_t>(0, mChangedGeometryInstances.size());
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t i)
+        {
+            flagsChanged[i] = updateInstanceFlags(mGeometryInstanceData[mChangedGeometryInstances[i]]) ? 1 : 0;
+        });
+
+        std::vector<uint32_t> modifiedInstances;
+        for (size_t i = 0; i < mChangedGeometryInstances.size(); i++)
+        {
+            if (flagsChanged[i]) modifiedInstances.push_back(mChangedGeometryInstances[i]);
         }
+
+        // Upload the modified instances in compact ranges.
+        InstanceDescUpdate::forEachIndexRange(modifiedInstances, [&](uint32_t offset, uint32_t count)
+        {
+            mpGeometryInstancesBuffer->setBlob(&mGeometryInstanceData[offset], offset * sizeof(GeometryInstanceData), count * sizeof(GeometryInstanceData));
+        });
     }
 
     IScene::UpdateFlags Scene::updateRaytracingAABBData(bool forceUpdate)
@@ -1537,6 +1594,7 @@ namespace Falcor
 
         for (const auto& pGrid : mGrids)
         {
+            if (!pGrid) continue;
             s.gridVoxelCount += pGrid->getVoxelCount();
             s.gridMemoryInBytes += pGrid->getGridSizeInBytes();
         }
@@ -1677,16 +1735,35 @@ namespace Falcor
             bindGridVolumes();
         }
 
+        auto getGridID = [&](uint32_t volumeIndex, GridVolume::GridSlot slot)
+        {
+            const auto& pGrid = mGridVolumes[volumeIndex]->getGrid(slot);
+            if (!pGrid) return SdfGridID::Invalid();
+            SdfGridID streamedGridID = mStreamedGridIDs[volumeIndex][(size_t)slot];
+            return streamedGridID.isValid() ? streamedGridID : mGridIDs.at(pGrid);
+        };
+
         // Upload volumes and clear updates.
+        auto gridsVar = mpSceneBlock->getRootVar()["grids"];
         uint32_t volumeIndex = 0;
         for (const auto& pGridVolume : mGridVolumes)
         {
             if (forceUpdate || pGridVolume->getUpdates() != GridVolume::UpdateFlags::None)
             {
+                // Rebind streamed grids if the selected frame changed.
+                for (uint32_t slotIndex = 0; slotIndex < (uint32_t)GridVolume::GridSlot::Count; ++slotIndex)
+                {
+                    SdfGridID streamedGridID = mStreamedGridIDs[volumeIndex][slotIndex];
+                    const auto& pGrid = pGridVolume->getGrid((GridVolume::GridSlot)slotIndex);
+                    if (!streamedGridID.isValid() || mGrids[streamedGridID.get()] == pGrid) continue;
+                    mGrids[streamedGridID.get()] = pGrid;
+                    if (pGrid) pGrid->bindShaderData(gridsVar[streamedGridID.get()]);
+                }
+
                 // Fetch copy of volume data.
                 auto data = pGridVolume->getData();
-                data.densityGrid = (pGridVolume->getDensityGrid() ? mGridIDs.at(pGridVolume->getDensityGrid()) : SdfGridID::Invalid()).getSlang();
-                data.emissionGrid = (pGridVolume->getEmissionGrid() ? mGridIDs.at(pGridVolume->getEmissionGrid()) : SdfGridID::Invalid()).getSlang();
+                data.densityGrid = getGridID(volumeIndex, GridVolume::GridSlot::Density).getSlang();
+                data.emissionGrid = getGridID(volumeIndex, GridVolume::GridSlot::Emission).getSlang();
                 // Merge grid and volume transforms.
                 const auto& densityGrid = pGridVolume->getDensityGrid();
                 if (densityGrid)
@@ -1718,7 +1795,8 @@ namespace Falcor
         auto gridsVar = var["grids"];
         for (size_t i = 0; i < mGrids.size(); ++i)
         {
-            mGrids[i]->bindShaderData(gridsVar[i]);
+            // Grids of streamed sequences can be empty for frames that failed to load.
+            if (mGrids[i]) mGrids[i]->bindShaderData(gridsVar[i]);
         }
     }
 
@@ -1828,7 +1906,8 @@ namespace Falcor
         bool blasUpdateRequired = is_set(mUpdates, IScene::UpdateFlags::MeshesChanged);
         if (mBlasDataValid && blasUpdateRequired)
         {
-            invalidateTlasCache();
+            // A BLAS refit keeps the BLAS addresses, so the instance descs stay valid unless the BLASes are rebuilt.
+            invalidateTlasCache(mRebuildBlas);
             buildBlas(pRenderContext);
         }
 
@@ -1864,18 +1943,27 @@ namespace Falcor
             bindParameterBlock();
         }
 
+        mChangedGeometryInstances.clear();
         if (mpAnimationController->animate(pRenderContext, currentTime))
         {
             mUpdates |= IScene::UpdateFlags::SceneGraphChanged;
             if (mpAnimationController->hasSkinnedMeshes()) mUpdates |= IScene::UpdateFlags::MeshesChanged;
 
-            for (const auto& inst : mGeometryInstanceData)
+            // Find the geometry instances affected by the changed matrices.
+            for (const auto& range : mpAnimationController->getChangedMatrixRanges())
             {
-                if (mpAnimationController->isMatrixChanged(NodeID{ inst.globalMatrixID }))
+                uint32_t end = std::min(range.offset + range.count, (uint32_t)mMatrixInstanceOffsets.size() - 1);
+                for (uint32_t matrixID = range.offset; matrixID < end; matrixID++)
                 {
-                    mUpdates |= IScene::UpdateFlags::GeometryMoved;
+                    for (uint32_t i = mMatrixInstanceOffsets[matrixID]; i < mMatrixInstanceOffsets[matrixID + 1]; i++)
+                    {
+                        mChangedGeometryInstances.push_back(mMatrixInstanceIDs[i]);
+                    }
                 }
             }
+            std::sort(mChangedGeometryInstances.begin(), mChangedGeometryInstances.end());
+
+            if (!mChangedGeometryInstances.empty()) mUpdates |= IScene::UpdateFlags::GeometryMoved;
 
             // We might end up setting the flag even if curves haven't changed (if looping is disabled for example).
             if (mpAnimationController->hasAnimatedCurveCaches()) mUpdates |= IScene::UpdateFlags::CurvesMoved;
@@ -1897,7 +1985,9 @@ namespace Falcor
 
         if (is_set(mUpdates, IScene::UpdateFlags::GeometryMoved))
         {
-            invalidateTlasCache();
+            // The TLAS must be rebuilt, but the instance descs are still valid apart from the transforms of the moved instances.
+            invalidateTlasCache(false);
+            markMovedInstanceDescs();
             updateGeometryInstances(false);
         }
 
@@ -1907,7 +1997,8 @@ namespace Falcor
 
         if (mBlasDataValid && blasUpdateRequired)
         {
-            invalidateTlasCache();
+            // A BLAS refit keeps the BLAS addresses, so the instance descs stay valid unless the BLASes are rebuilt.
+            invalidateTlasCache(mRebuildBlas);
             buildBlas(pRenderContext);
         }
 
@@ -3502,9 +3593,10 @@ namespace Falcor
         }
     }
 
-    void Scene::fillInstanceDesc(std::vector<RtInstanceDesc>& instanceDescs, uint32_t rayTypeCount, bool perMeshHitEntry) const
+    void Scene::fillInstanceDesc(std::vector<RtInstanceDesc>& instanceDescs, std::vector<uint32_t>& instanceDescMatrixIDs, uint32_t rayTypeCount, bool perMeshHitEntry) const
     {
         instanceDescs.clear();
+        instanceDescMatrixIDs.clear();
         uint32_t instanceContributionToHitGroupIndex = 0;
         uint32_t instanceID = 0;
 
@@ -3551,47 +3643,59 @@ namespace Falcor
             //
             FALCOR_ASSERT(!meshList.empty());
             size_t instanceCount = mMeshIdToInstanceIds[meshList[0].get()].size();
-
             FALCOR_ASSERT(instanceCount > 0);
-            for (size_t instanceIdx = 0; instanceIdx < instanceCount; instanceIdx++)
+
+            // The instance descs of a group are independent, so large groups are filled in parallel.
+            const size_t firstDescIndex = instanceDescs.size();
+            const uint32_t firstInstanceID = instanceID;
+            instanceDescs.resize(firstDescIndex + instanceCount);
+            instanceDescMatrixIDs.resize(firstDescIndex + instanceCount, InstanceDescUpdate::kInvalidMatrixID);
+            instanceID += (uint32_t)(instanceCount * meshList.size());
+
+            auto fillDesc = [&](size_t instanceIdx)
             {
+                RtInstanceDesc instanceDesc = desc;
+                instanceDesc.instanceID = firstInstanceID + (uint32_t)(instanceIdx * meshList.size());
+
                 // Validate that the ordering is matching our expectations:
                 // InstanceID() + GeometryIndex() should look up the correct mesh instance.
                 for (uint32_t geometryIndex = 0; geometryIndex < (uint32_t)meshList.size(); geometryIndex++)
                 {
                     const auto& instances = mMeshIdToInstanceIds[meshList[geometryIndex].get()];
                     FALCOR_ASSERT(instances.size() == instanceCount);
-                    FALCOR_ASSERT(instances[instanceIdx] == instanceID + geometryIndex);
+                    FALCOR_ASSERT(instances[instanceIdx] == instanceDesc.instanceID + geometryIndex);
                 }
 
-                desc.instanceID = instanceID;
-                instanceID += (uint32_t)meshList.size();
-
                 float4x4 transform4x4 = float4x4::identity();
                 if (!isStatic)
                 {
                     // For non-static meshes, the matrices for all meshes in an instance are guaranteed to be the same.
                     // Just pick the matrix from the first mesh.
-                    const uint32_t matrixId = mGeometryInstanceData[desc.instanceID].globalMatrixID;
+                    const uint32_t matrixId = mGeometryInstanceData[instanceDesc.instanceID].globalMatrixID;
                     transform4x4 = mpAnimationController->getGlobalMatrices()[matrixId];
+                    instanceDescMatrixIDs[firstDescIndex + instanceIdx] = matrixId;
 
                     // Verify that all meshes have matching tranforms.
                     for (uint32_t geometryIndex = 0; geometryIndex < (uint32_t)meshList.size(); geometryIndex++)
                     {
-                        FALCOR_ASSERT(matrixId == mGeometryInstanceData[desc.instanceID + geometryIndex].globalMatrixID);
+                        FALCOR_ASSERT(matrixId == mGeometryInstanceData[instanceDesc.instanceID + geometryIndex].globalMatrixID);
                     }
                 }
-                std::memcpy(desc.transform, &transform4x4, sizeof(desc.transform));
+                std::memcpy(instanceDesc.transform, &transform4x4, sizeof(instanceDesc.transform));
 
                 // Verify that instance data has the correct instanceIndex and geometryIndex.
                 for (uint32_t geometryIndex = 0; geometryIndex < (uint32_t)meshList.size(); geometryIndex++)
                 {
-                    FALCOR_ASSERT((uint32_t)instanceDescs.size() == mGeometryInstanceData[desc.instanceID + geometryIndex].instanceIndex);
-                    FALCOR_ASSERT(geometryIndex == mGeometryInstanceData[desc.instanceID + geometryIndex].geometryIndex);
+                    FALCOR_ASSERT((uint32_t)(firstDescIndex + instanceIdx) == mGeometryInstanceData[instanceDesc.instanceID + geometryIndex].instanceIndex);
+                    FALCOR_ASSERT(geometryIndex == mGeometryInstanceData[instanceDesc.instanceID + geometryIndex].geometryIndex);
                 }
 
-                instanceDescs.push_back(desc);
-            }
+                instanceDescs[firstDescIndex + instanceIdx] = instanceDesc;
+            };
+
+            auto range = NumericRange<size_t>(0, instanceCount);
+            if (instanceCount >= kMinParallelInstanceDescCount) std::for_each(std::execution::par, range.begin(), range.end(), fillDesc);
+            else std::for_each(range.begin(), range.end(), fillDesc);
         }
 
         uint32_t totalBlasCount = (uint32_t)mMeshGroups.size() + (mCurveDesc.empty() ? 0 : 1) + getSDFGridGeometryCount() + (mCustomPrimitiveDesc.empty() ? 0 : 1);
@@ -3632,6 +3736,7 @@ namespace Falcor
             }
 
             instanceDescs.push_back(desc);
+            instanceDescMatrixIDs.push_back(matrixId);
         }
 
         // One instance per SDF grid instance.
@@ -3675,6 +3780,7 @@ namespace Falcor
                 FALCOR_ASSERT(0 == instance.geometryIndex);
 
                 instanceDescs.push_back(desc);
+                instanceDescMatrixIDs.push_back(instance.globalMatrixID);
             }
 
             blasDataIndex += (sdfGridInstancesHaveUniqueBLASes ? mSDFGrids.size() : 1);
@@ -3702,16 +3808,31 @@ namespace Falcor
             float4x4 identityMat = float4x4::identity();
             std::memcpy(desc.transform, &identityMat, sizeof(desc.transform));
             instanceDescs.push_back(desc);
+            instanceDescMatrixIDs.push_back(InstanceDescUpdate::kInvalidMatrixID);
         }
     }
 
-    void Scene::invalidateTlasCache()
+    void Scene::invalidateTlasCache(bool invalidateInstanceDescs)
     {
         for (auto& tlas : mTlasCache)
         {
             tlas.second.pTlasObject = nullptr;
         }
         mTlasLastBuiltRayCount = 0;
+
+        if (invalidateInstanceDescs)
+        {
+            mInstanceDescsValid = false;
+            mDirtyInstanceDescs.clear();
+        }
+    }
+
+    void Scene::markMovedInstanceDescs()
+    {
+        if (!mInstanceDescsValid) return;
+
+        InstanceDescUpdate::collectDirtyDescs(mChangedGeometryInstances, [&](uint32_t instanceID) { return mGeometryInstanceData[instanceID].instanceIndex; },
+            mInstanceDescMatrixIDs, mDirtyInstanceDescs);
     }
 
     void Scene::buildTlas(RenderContext* pRenderContext, uint32_t rayTypeCount, bool perMeshHitEntry)
@@ -3724,7 +3845,20 @@ namespace Falcor
 
         // Prepare instance descs.
         // Note if there are no instances, we'll build an empty TLAS.
-        fillInstanceDesc(mInstanceDescs, rayTypeCount, perMeshHitEntry);
+        // The descs are kept between builds. If only instance transforms changed, only the moved descs are updated.
+        bool refillInstanceDescs = !mInstanceDescsValid || mInstanceDescsRayTypeCount != rayTypeCount || mInstanceDescsPerMeshHitEntry != perMeshHitEntry;
+        if (refillInstanceDescs)
+        {
+            fillInstanceDesc(mInstanceDescs, mInstanceDescMatrixIDs, rayTypeCount, perMeshHitEntry);
+            mInstanceDescsValid = true;
+            mInstanceDescsRayTypeCount = rayTypeCount;
+            mInstanceDescsPerMeshHitEntry = perMeshHitEntry;
+            mDirtyInstanceDescs.clear();
+        }
+        else
+        {
+            InstanceDescUpdate::updateTransforms(mInstanceDescs, mInstanceDescMatrixIDs, mDirtyInstanceDescs, mpAnimationController->getGlobalMatrices());
+        }
 
         RtAccelerationStructureBuildInputs inputs = {};
         inputs.kind = RtAccelerationStructureKind::TopLevel;
@@ -3786,14 +3920,35 @@ namespace Falcor
 
         FALCOR_ASSERT(tlas.pTlasBuffer && tlas.pTlasBuffer->getGfxResource() && mpTlasScratch->getGfxResource());
 
-        // Upload instance data
+        // Upload instance data.
+        // The descs live in a persistent GPU buffer, so after a full upload only the moved descs need to be re-uploaded.
         if (inputs.descCount > 0)
         {
-            GpuMemoryHeap::Allocation allocation = mpDevice->getUploadHeap()->allocate(inputs.descCount * sizeof(RtInstanceDesc), sizeof(RtInstanceDesc));
-            std::memcpy(allocation.pData, mInstanceDescs.data(), inputs.descCount * sizeof(RtInstanceDesc));
-            asDesc.inputs.instanceDescs = allocation.getGpuAddress();
-            mpDevice->getUploadHeap()->release(allocation);
+            size_t byteSize = inputs.descCount * sizeof(RtInstanceDesc);
+            if (!mpTlasInstanceDescs || mpTlasInstanceDescs->getSize() < byteSize)
+            {
+                mpTlasInstanceDescs = mpDevice->createBuffer(byteSize, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal);
+                mpTlasInstanceDescs->setName("Scene::mpTlasInstanceDescs");
+                refillInstanceDescs = true;
+            }
+
+            if (refillInstanceDescs)
+            {
+                mpTlasInstanceDescs->setBlob(mInstanceDescs.data(), 0, byteSize);
+            }
+            else
+            {
+                InstanceDescUpdate::forEachIndexRange(mDirtyInstanceDescs, [&](uint32_t offset, uint32_t count)
+                {
+                    mpTlasInstanceDescs->setBlob(&mInstanceDescs[offset], offset * sizeof(RtInstanceDesc), count * sizeof(RtInstanceDesc));
+                });
+            }
+
+            // Transition the resource to non-pixel shader state as expected by DXR.
+            pRenderContext->resourceBarrier(mpTlasInstanceDescs.get(), Resource::State::NonPixelShader);
+            asDesc.inputs.instanceDescs = mpTlasInstanceDescs->getGpuAddress();
         }
+        mDirtyInstanceDescs.clear();
         asDesc.scratchData = mpTlasScratch->getGpuAddress();
         asDesc.dest = tlas.pTlasObject.get();
 
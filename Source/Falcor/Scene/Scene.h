@@ -266,6 +266,7 @@ namespace Falcor
             std::vector<std::vector<uint32_t>> meshIdToInstanceIds; ///< Mapping of what instances belong to which mesh.
             std::vector<MeshGroup> meshGroups;                      ///< List of mesh groups. Each group maps to a BLAS for ray tracing.
             std::vector<CachedMesh> cachedMeshes;                   ///< Cached data for vertex-animated meshes.
+            bool streamVertexCaches = false;                        ///< True if keyframes of cached curves and meshes should be streamed to the GPU on demand.
             uint32_t prevVertexCount = 0;                           ///< Number of vertices that the AnimationController needs to allocate to store previous frame vertices.
 
             bool useCompressedHitInfo = false;                      ///< True if scene should used compressed HitInfo (on scenes with triangles meshes only).
@@ -1134,6 +1135,7 @@ namespace Falcor
         void updateBounds();
 
         /** Update geometry instances.
+            \param[in] forceUpdate Update and upload all instances. Otherwise only the instances listed in mChangedGeometryInstances are updated.
         */
         void updateGeometryInstances(bool forceUpdate);
 
@@ -1167,8 +1169,10 @@ namespace Falcor
 
         /** Generate data for creating a TLAS.
             #SCENE TODO: Add argument to build descs based off a draw list.
+            \param[out] instanceDescs Instance descs.
+            \param[out] instanceDescMatrixIDs Global matrix ID used for the transform of each instance desc, or an invalid ID for descs with identity transform.
         */
-        void fillInstanceDesc(std::vector<RtInstanceDesc>& instanceDescs, uint32_t rayTypeCount, bool perMeshHitEntry) const;
+        void fillInstanceDesc(std::vector<RtInstanceDesc>& instanceDescs, std::vector<uint32_t>& instanceDescMatrixIDs, uint32_t rayTypeCount, bool perMeshHitEntry) const;
 
         /** Generate top level acceleration structure for the scene. Automatically determines whether to build or refit.
             \param[in] rayCount Number of ray types in the shader. Required to setup how instances index into the Shader Table.
@@ -1176,8 +1180,14 @@ namespace Falcor
         void buildTlas(RenderContext* pRenderContext, uint32_t rayTypeCount, bool perMeshHitEntry);
 
         /** Invalidates the TLAS cache.
+            \param[in] invalidateInstanceDescs Also invalidate the instance descs. Pass false if only instance transforms changed.
         */
-        void invalidateTlasCache();
+        void invalidateTlasCache(bool invalidateInstanceDescs = true);
+
+        /** Mark the instance descs of the geometry instances in mChangedGeometryInstances as dirty.
+            Their transforms are updated and uploaded on the next TLAS build.
+        */
+        void markMovedInstanceDescs();
 
         /** Check whether scene has an index buffer.
         */
@@ -1238,6 +1248,9 @@ namespace Falcor
         GeometryTypeFlags mGeometryTypes;                           ///< Set of geometry types that exist in the scene.
 
         std::vector<GeometryInstanceData> mGeometryInstanceData;    ///< Geometry instance data (for all types of geometry).
+        std::vector<uint32_t> mMatrixInstanceOffsets;               ///< Offsets into mMatrixInstanceIDs per global matrix. Has one more entry than there are matrices.
+        std::vector<uint32_t> mMatrixInstanceIDs;                   ///< Geometry instance IDs grouped by global matrix ID.
+        std::vector<uint32_t> mChangedGeometryInstances;            ///< Sorted list of geometry instances whose global matrix changed in the current update.
 
         bool mUseCompressedHitInfo = false;                         ///< True if scene should used compressed HitInfo (on scenes with triangles meshes only).
         bool mHas16BitIndices = false;                              ///< True if any meshes use 16-bit indices.
@@ -1303,6 +1316,7 @@ namespace Falcor
         std::vector<ref<GridVolume>> mGridVolumes;                  ///< All loaded grid volumes.
         std::vector<ref<Grid>> mGrids;                              ///< All loaded grids.
         std::unordered_map<ref<Grid>, SdfGridID> mGridIDs;          ///< Lookup table for grid IDs.
+        std::vector<std::array<SdfGridID, (size_t)GridVolume::GridSlot::Count>> mStreamedGridIDs; ///< Per volume and grid slot, ID of the grid binding reserved for a streamed grid sequence.
         ref<LightCollection> mpLightCollection;                     ///< Class for managing emissive geometry. This is created lazily upon first use.
         ref<EnvMap> mpEnvMap;                                       ///< Environment map or nullptr if not loaded.
         bool mEnvMapChanged = false;                                ///< Flag indicating that the environment map has changed since last frame.
@@ -1366,6 +1380,12 @@ namespace Falcor
         UpdateMode mBlasUpdateMode = UpdateMode::Refit;     ///< How the BLAS should be updated when there are changes to meshes.
 
         std::vector<RtInstanceDesc> mInstanceDescs;         ///< Shared between TLAS builds to avoid reallocating CPU memory.
+        std::vector<uint32_t> mInstanceDescMatrixIDs;       ///< Global matrix ID per instance desc, see fillInstanceDesc().
+        std::vector<uint32_t> mDirtyInstanceDescs;          ///< Sorted list of instance descs whose transform changed since the last TLAS build.
+        bool mInstanceDescsValid = false;                   ///< True if mInstanceDescs are valid apart from the transforms of the dirty descs.
+        uint32_t mInstanceDescsRayTypeCount = 0;            ///< Ray type count the instance descs were generated with.
+        bool mInstanceDescsPerMeshHitEntry = false;         ///< Per mesh hit entry setting the instance descs were generated with.
+        ref<Buffer> mpTlasInstanceDescs;                    ///< Instance descs on the GPU. Persistent so that only dirty descs need to be uploaded.
 
         struct TlasData
         {
@@ -27,21 +27,32 @@
  **************************************************************************/
 #include "SceneBuilder.h"
 #include "SceneCache.h"
+#include "TangentGenerator.h"
+#include "VertexDeduplication.h"
 #include "Importer.h"
+#include "Core/Platform/OS.h"
 #include "Curves/CurveConfig.h"
 #include "Material/StandardMaterial.h"
 #include "Utils/Logger.h"
+#include "Utils/Math/BatchMath.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Image/TextureAnalyzer.h"
 #include "Utils/Timing/TimeReport.h"
+#include "Utils/Timing/CpuTimer.h"
+#include "Utils/Timing/Profiler.h"
+#include "Utils/Threading.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "Utils/Math/MathHelpers.h"
 #include "Utils/ObjectIDPython.h"
 #include "Utils/NumericRange.h"
-#include <mikktspace.h>
+#include "Utils/StringUtils.h"
+#include <BS_thread_pool/BS_thread_pool.hpp>
 #include <filesystem>
 #include <cmath>
 #include <execution>
+#include <atomic>
+#include <mutex>
+#include <exception>
 
 namespace Falcor
 {
@@ -51,6 +62,17 @@ namespace Falcor
         // The target is max 16M triangles per BLAS (= approx 0.5GB post-compaction). Note that this is not a strict limit.
         const size_t kMaxTrianglesPerBLAS = 1ull << 24;
 
+        // Number of vertices transformed at a time when pre-transforming static meshes.
+        const size_t kVertexTransformBlockSize = 1024;
+
+        // Texture cache directory (subdirectory in the application data directory).
+        const std::string kTextureCacheDirectory = "NVIDIA/Falcor/TextureCache";
+
+        std::filesystem::path getTextureCacheDirectory()
+        {
+            return getAppDataDirectory() / kTextureCacheDirectory;
+        }
+
         // Texture coordinates for textured emissive materials are quantized for performance reasons.
         // We'll log a warning if the maximum quantization error exceeds this value.
         const float kMaxTexelError = 0.5f;
@@ -62,92 +84,47 @@ namespace Falcor
             else return 2;
         }
 
-        class MikkTSpaceWrapper
+        /** Mesh description of a triangle mesh, along with the vertex attribute arrays it references.
+        */
+        struct TriangleMeshData
         {
-        public:
-            static std::vector<float4> generateTangents(const SceneBuilder::Mesh& mesh)
-            {
-                if (!mesh.normals.pData || !mesh.positions.pData || !mesh.texCrds.pData || !mesh.pIndices)
-                {
-                    logWarning("Can't generate tangent space. The mesh '{}' doesn't have positions/normals/texCrd/indices.", mesh.name);
-                    return {};
-                }
+            SceneBuilder::Mesh mesh;
+            std::vector<float3> positions;
+            std::vector<float3> normals;
+            std::vector<float2> texCoords;
+        };
 
-                // Generate new tangent space.
-                SMikkTSpaceInterface mikktspace = {};
-                mikktspace.m_getNumFaces = [](const SMikkTSpaceContext* pContext) { return ((MikkTSpaceWrapper*)(pContext->m_pUserData))->getFaceCount(); };
-                mikktspace.m_getNumVerticesOfFace = [](const SMikkTSpaceContext* pContext, int32_t face) { return 3; };
-                mikktspace.m_getPosition = [](const SMikkTSpaceContext* pContext, float position[], int32_t face, int32_t vert) { ((MikkTSpaceWrapper*)(pContext->m_pUserData))->getPosition(position, face, vert); };
-                mikktspace.m_getNormal = [](const SMikkTSpaceContext* pContext, float normal[], int32_t face, int32_t vert) { ((MikkTSpaceWrapper*)(pContext->m_pUserData))->getNormal(normal, face, vert); };
-                mikktspace.m_getTexCoord = [](const SMikkTSpaceContext* pContext, float texCrd[], int32_t face, int32_t vert) { ((MikkTSpaceWrapper*)(pContext->m_pUserData))->getTexCrd(texCrd, face, vert); };
-                mikktspace.m_setTSpaceBasic = [](const SMikkTSpaceContext* pContext, const float tangent[], float sign, int32_t face, int32_t vert) { ((MikkTSpaceWrapper*)(pContext->m_pUserData))->setTangent(tangent, sign, face, vert); };
-
-                MikkTSpaceWrapper wrapper(mesh);
-                SMikkTSpaceContext context = {};
-                context.m_pInterface = &mikktspace;
-                context.m_pUserData = &wrapper;
-
-                if (genTangSpaceDefault(&context) == false)
-                {
-                    FALCOR_THROW("MikkTSpace failed to generate tangents for the mesh '{}'.", mesh.name);
-                }
+        void createTriangleMeshData(const ref<TriangleMesh>& pTriangleMesh, const ref<Material>& pMaterial, bool isAnimated, TriangleMeshData& data)
+        {
+            FALCOR_CHECK(pTriangleMesh != nullptr, "'pTriangleMesh' is missing");
+            FALCOR_CHECK(pMaterial != nullptr, "'pMaterial' is missing");
 
-                return wrapper.mTangents;
-            }
+            SceneBuilder::Mesh& mesh = data.mesh;
 
-        private:
-            MikkTSpaceWrapper(const SceneBuilder::Mesh& mesh)
-                : mMesh(mesh)
-            {
-                FALCOR_ASSERT(mesh.indexCount > 0);
-                mTangents.resize(mesh.indexCount, float4(0));
+            const auto& indices = pTriangleMesh->getIndices();
+            const auto& vertices = pTriangleMesh->getVertices();
 
-                FALCOR_ASSERT_EQ(mesh.indexCount, mMesh.faceCount * 3);
-                mPositions.resize(mMesh.faceCount * 3);
-                switch (mMesh.positions.frequency)
-                {
-                case SceneBuilder::Mesh::AttributeFrequency::Constant:
-                {
-                    std::fill_n(mPositions.begin(), mPositions.size(), mMesh.positions.pData[0]);
-                    break;
-                }
-                case SceneBuilder::Mesh::AttributeFrequency::Uniform:
-                {
-                    for (uint32_t i = 0; i < mMesh.faceCount; ++i)
-                        std::fill_n(mPositions.begin() + i * 3, 3, mMesh.positions.pData[i]);
-                    break;
-                }
-                case SceneBuilder::Mesh::AttributeFrequency::Vertex:
-                {
-                    FALCOR_ASSERT_EQ(mesh.indexCount, mPositions.size());
-                    for (size_t fvarIdx = 0; fvarIdx < mPositions.size(); ++fvarIdx)
-                        mPositions[fvarIdx] = mMesh.positions.pData[mMesh.pIndices[fvarIdx]];
-                    break;
-                }
-                case SceneBuilder::Mesh::AttributeFrequency::FaceVarying:
-                {
-                    memcpy(mPositions.data(), mMesh.positions.pData, mPositions.size() * sizeof(float3));
-                    break;
-                }
-                default:
-                    FALCOR_UNREACHABLE();
-                }
+            mesh.name = pTriangleMesh->getName();
+            mesh.faceCount = (uint32_t)(indices.size() / 3);
+            mesh.vertexCount = (uint32_t)vertices.size();
+            mesh.indexCount = (uint32_t)indices.size();
+            mesh.pIndices = indices.data();
+            mesh.topology = Vao::Topology::TriangleList;
+            mesh.isFrontFaceCW = pTriangleMesh->getFrontFaceCW();
+            mesh.pMaterial = pMaterial;
+            mesh.isAnimated = isAnimated;
 
-            }
-            const SceneBuilder::Mesh& mMesh;
-            std::vector<float4> mTangents;
-            std::vector<float3> mPositions;
-            int32_t getFaceCount() const { return (int32_t)mMesh.faceCount; }
-            void getPosition(float position[], int32_t face, int32_t vert) const { FALCOR_ASSERT_LT(size_t(face) * 3 + vert, mPositions.size()); memcpy(position, mPositions.data() + (face * 3 + vert), sizeof(float3)); }
-            void getNormal(float normal[], int32_t face, int32_t vert) { *reinterpret_cast<float3*>(normal) = mMesh.getNormal(face, vert); }
-            void getTexCrd(float texCrd[], int32_t face, int32_t vert) { *reinterpret_cast<float2*>(texCrd) = mMesh.getTexCrd(face, vert); }
-
-            void setTangent(const float tangent[], float sign, int32_t face, int32_t vert)
-            {
-                float3 T = *reinterpret_cast<const float3*>(tangent);
-                mTangents[face * 3 + vert] = float4(normalize(T), sign);
-            }
-        };
+            data.positions.resize(vertices.size());
+            data.normals.resize(vertices.size());
+            data.texCoords.resize(vertices.size());
+            std::transform(vertices.begin(), vertices.end(), data.positions.begin(), [] (const auto& v) { return v.position; });
+            std::transform(vertices.begin(), vertices.end(), data.normals.begin(), [] (const auto& v) { return v.normal; });
+            std::transform(vertices.begin(), vertices.end(), data.texCoords.begin(), [] (const auto& v) { return v.texCoord; });
+
+            mesh.positions = { data.positions.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex };
+            mesh.normals = { data.normals.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex };
+            mesh.texCrds = { data.texCoords.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex };
+        }
 
         void validateVertex(const SceneBuilder::Mesh::Vertex& v, size_t& invalidCount, size_t& zeroCount)
         {
@@ -164,19 +141,6 @@ namespace Falcor
             if (isZero(v.normal) || isZero(v.tangent.xyz())) zeroCount++;
         }
 
-        bool compareVertices(const SceneBuilder::Mesh::Vertex& lhs, const SceneBuilder::Mesh::Vertex& rhs, float threshold = 1e-6f)
-        {
-            if (any(lhs.position != rhs.position)) return false; // Position need to be exact to avoid cracks
-            if (lhs.tangent.w != rhs.tangent.w) return false;
-            if (lhs.curveRadius != rhs.curveRadius) return false;
-            if (any(lhs.boneIDs != rhs.boneIDs)) return false;
-            if (any(abs(lhs.normal - rhs.normal) > float3(threshold))) return false;
-            if (any(abs(lhs.tangent.xyz() - rhs.tangent.xyz()) > float3(threshold))) return false;
-            if (any(abs(lhs.texCrd - rhs.texCrd) > float2(threshold))) return false;
-            if (any(abs(lhs.boneWeights - rhs.boneWeights) > float4(threshold))) return false;
-            return true;
-        }
-
         std::vector<uint32_t> compact16BitIndices(const std::vector<uint32_t>& indices)
         {
             if (indices.empty()) return {};
@@ -191,9 +155,88 @@ namespace Falcor
             return indexData;
         }
 
+        /** Returns the thread pool used by forEachIndex().
+            The pool is created on first use and shared by all scene builds. It is intentionally never destroyed,
+            as joining its threads during static destruction can dead-lock when the library is unloaded.
+        */
+        BS::thread_pool& getThreadPool()
+        {
+            static BS::thread_pool* pThreadPool = new BS::thread_pool(Threading::getLogicalThreadCount());
+            return *pThreadPool;
+        }
+
+        /// Set on threads of the pool returned by getThreadPool(). The pool only runs forEachIndex() chunks, so the flag is never cleared.
+        thread_local bool tIsThreadPoolWorker = false;
+
+        /** Calls func(i) for all i in [0, count).
+            If parallel is set, the range is split into chunks that are executed on the shared thread pool.
+            Nested calls from within a chunk are executed serially, as waiting on the pool from one of its own threads can dead-lock.
+            Exceptions thrown by func are rethrown on the calling thread.
+            Note that func must only write data owned by index i.
+        */
+        template<typename Func>
+        void forEachIndex(bool parallel, size_t count, const Func& func)
+        {
+            if (!parallel || count <= 1 || tIsThreadPoolWorker)
+            {
+                for (size_t i = 0; i < count; ++i) func(i);
+                return;
+            }
+
+            const size_t chunkCount = std::min<size_t>(count, 4 * Threading::getLogicalThreadCount());
+            auto futures = getThreadPool().parallelize_loop(count, [&func](size_t first, size_t last)
+            {
+                tIsThreadPoolWorker = true;
+                for (size_t i = first; i < last; ++i) func(i);
+            }, chunkCount);
+
+            // Wait for all chunks before rethrowing, as the chunks reference func.
+            futures.wait();
+            futures.get();
+        }
+
+        /** Records the wall-clock time of each scene build stage.
+            Stages may be run concurrently from multiple threads.
+        */
+        class StageTimings
+        {
+        public:
+            template<typename Func>
+            void run(const std::string& name, const Func& func)
+            {
+                ScopedCpuProfilerEvent profilerEvent(name);
+                auto startTime = CpuTimer::getCurrentTimePoint();
+                func();
+                double duration = CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint()) * 1e-3;
+
+                std::lock_guard<std::mutex> lock(mMutex);
+                mTimings.push_back({ name, duration });
+            }
+
+            /** Print the timings to the log.
+                The timings are only printed if the logger verbosity is set to Logger::Level::Debug.
+            */
+            void printToLog() const
+            {
+                if (Logger::getVerbosity() < Logger::Level::Debug) return;
+
+                std::lock_guard<std::mutex> lock(mMutex);
+                logDebug("Scene build stage timings:");
+                for (const auto& [name, duration] : mTimings)
+                {
+                    logDebug("  " + padStringToLength(name + ":", 30) + " " + std::to_string(duration) + " s");
+                }
+            }
+
+        private:
+            mutable std::mutex mMutex;
+            std::vector<std::pair<std::string, double>> mTimings;
+        };
+
         SceneCache::Key computeSceneCacheKey(const std::filesystem::path& path, SceneBuilder::Flags buildFlags)
         {
-            SceneBuilder::Flags cacheFlags = buildFlags & (~(SceneBuilder::Flags::UseCache | SceneBuilder::Flags::RebuildCache));
+            // The parallel build and the texture loading options produce identical results, so they do not affect the cache key.
+            SceneBuilder::Flags cacheFlags = buildFlags & (~(SceneBuilder::Flags::UseCache | SceneBuilder::Flags::RebuildCache | SceneBuilder::Flags::ParallelBuild | SceneBuilder::Flags::UseTextureCache | SceneBuilder::Flags::DontDeduplicateTextures));
             SHA1 sha1;
             auto pathStr = path.string();
             sha1.update(pathStr.data(), pathStr.size());
@@ -210,6 +253,14 @@ namespace Falcor
     {
         mAssetResolver = AssetResolver::getDefaultResolver();
         mSceneData.pMaterials = std::make_unique<MaterialSystem>(mpDevice);
+        if (is_set(flags, Flags::UseTextureCache))
+        {
+            mSceneData.pMaterials->getTextureManager().setDiskCacheDirectory(getTextureCacheDirectory());
+        }
+        if (is_set(flags, Flags::DontDeduplicateTextures))
+        {
+            mSceneData.pMaterials->getTextureManager().setContentDeduplication(false);
+        }
     }
 
     SceneBuilder::SceneBuilder(ref<Device> pDevice, const std::filesystem::path& path, const Settings& settings, Flags flags)
@@ -234,7 +285,9 @@ namespace Falcor
         {
             try
             {
-                mpScene = Scene::create(pDevice, SceneCache::readCache(pDevice, mSceneCacheKey));
+                auto textureCacheDirectory = is_set(flags, Flags::UseTextureCache) ? getTextureCacheDirectory() : std::filesystem::path();
+                bool deduplicateTextures = !is_set(flags, Flags::DontDeduplicateTextures);
+                mpScene = Scene::create(pDevice, SceneCache::readCache(pDevice, mSceneCacheKey, textureCacheDirectory, deduplicateTextures));
                 return;
             }
             catch (const std::exception& e)
@@ -345,42 +398,84 @@ namespace Falcor
         }
 
         // Post-process the scene data.
+        // The stages below form a chain where each stage depends on the results of the previous one,
+        // except where noted. With Flags::ParallelBuild, the per-mesh work within a stage and
+        // the independent stages are executed concurrently. Both paths produce identical results.
+        const bool parallel = is_set(mFlags, Flags::ParallelBuild);
         TimeReport timeReport;
+        StageTimings stageTimings;
 
         // Prepare displacement maps. This either removes them (if requested in build flags)
         // or makes sure that normal maps are removed if displacement is in use.
-        prepareDisplacementMaps();
-
-        prepareSceneGraph();
-        prepareMeshes();
-        removeUnusedMeshes();
-        flattenStaticMeshInstances();
-        pretransformStaticMeshes();
-        unifyTriangleWinding();
-        optimizeSceneGraph();
-        calculateMeshBoundingBoxes();
-        createMeshGroups();
-        optimizeGeometry();
-        sortMeshes();
-        createGlobalBuffers();
-        createCurveGlobalBuffers();
-        collectVolumeGrids();
-        removeDuplicateSDFGrids();
+        stageTimings.run("prepareDisplacementMaps", [&]() { prepareDisplacementMaps(); });
+
+        stageTimings.run("prepareSceneGraph", [&]() { prepareSceneGraph(); });
+        stageTimings.run("prepareMeshes", [&]() { prepareMeshes(); });
+        stageTimings.run("removeUnusedMeshes", [&]() { removeUnusedMeshes(); });
+        stageTimings.run("flattenStaticMeshInstances", [&]() { flattenStaticMeshInstances(); });
+        stageTimings.run("pretransformStaticMeshes", [&]() { pretransformStaticMeshes(); });
+        stageTimings.run("unifyTriangleWinding", [&]() { unifyTriangleWinding(); });
+        stageTimings.run("optimizeSceneGraph", [&]() { optimizeSceneGraph(); });
+        stageTimings.run("calculateMeshBoundingBoxes", [&]() { calculateMeshBoundingBoxes(); });
+        stageTimings.run("createMeshGroups", [&]() { createMeshGroups(); });
+        stageTimings.run("optimizeGeometry", [&]() { optimizeGeometry(); });
+        stageTimings.run("sortMeshes", [&]() { sortMeshes(); });
+
+        // The following stages operate on disjoint data (meshes, curves, volumes and SDF grids).
+        {
+            const std::pair<std::string, std::function<void()>> independentStages[] = {
+                { "createGlobalBuffers", [this]() { createGlobalBuffers(); } },
+                { "createCurveGlobalBuffers", [this]() { createCurveGlobalBuffers(); } },
+                { "collectVolumeGrids", [this]() { collectVolumeGrids(); } },
+                { "removeDuplicateSDFGrids", [this]() { removeDuplicateSDFGrids(); } },
+            };
+
+            if (parallel)
+            {
+                // The remaining stages run on the shared thread pool. The first stage runs on the calling thread,
+                // so that its per-mesh work can still be split up on the pool by forEachIndex().
+                const size_t stageCount = std::size(independentStages);
+                auto futures = getThreadPool().parallelize_loop(size_t(1), stageCount, [&](size_t first, size_t last)
+                {
+                    tIsThreadPoolWorker = true;
+                    for (size_t i = first; i < last; ++i) stageTimings.run(independentStages[i].first, independentStages[i].second);
+                }, stageCount - 1);
+
+                std::exception_ptr pException;
+                try
+                {
+                    stageTimings.run(independentStages[0].first, independentStages[0].second);
+                }
+                catch (...)
+                {
+                    pException = std::current_exception();
+                }
+
+                // Wait for all stages before rethrowing, as the stages reference local state.
+                futures.wait();
+                if (pException) std::rethrow_exception(pException);
+                futures.get();
+            }
+            else
+            {
+                for (const auto& stage : independentStages) stageTimings.run(stage.first, stage.second);
+            }
+        }
 
         timeReport.measure("Post processing geometry");
 
-        optimizeMaterials();
-        removeDuplicateMaterials();
-        quantizeTexCoords();
+        stageTimings.run("optimizeMaterials", [&]() { optimizeMaterials(); });
+        stageTimings.run("removeDuplicateMaterials", [&]() { removeDuplicateMaterials(); });
+        stageTimings.run("quantizeTexCoords", [&]() { quantizeTexCoords(); });
 
         timeReport.measure("Optimizing materials");
 
         // Prepare scene resources.
-        createSceneGraph();
-        createMeshData();
-        createMeshBoundingBoxes();
-        createCurveData();
-        calculateCurveBoundingBoxes();
+        stageTimings.run("createSceneGraph", [&]() { createSceneGraph(); });
+        stageTimings.run("createMeshData", [&]() { createMeshData(); });
+        stageTimings.run("createMeshBoundingBoxes", [&]() { createMeshBoundingBoxes(); });
+        stageTimings.run("createCurveData", [&]() { createCurveData(); });
+        stageTimings.run("calculateCurveBoundingBoxes", [&]() { calculateCurveBoundingBoxes(); });
 
         // Create instance data.
         uint32_t tlasInstanceIndex = 0;
@@ -390,6 +485,7 @@ namespace Falcor
         for (auto& sdfInstanceData : mSceneData.sdfGridInstances) sdfInstanceData.instanceIndex = tlasInstanceIndex++;
 
         mSceneData.useCompressedHitInfo = is_set(mFlags, Flags::UseCompressedHitInfo);
+        mSceneData.streamVertexCaches = is_set(mFlags, Flags::StreamVertexCaches);
 
         // Write scene cache if requested.
         if (mWriteSceneCache)
@@ -404,6 +500,17 @@ namespace Falcor
 
         timeReport.measure("Creating resources");
         timeReport.printToLog();
+        stageTimings.printToLog();
+
+        if (is_set(mFlags, Flags::OptimizeVertexOrder) && mVertexCacheStatsBefore.triangleCount > 0)
+        {
+            logInfo(
+                "Vertex order optimization: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f} ({} triangles, cache size {}).",
+                mVertexCacheStatsBefore.getACMR(), mVertexCacheStatsAfter.getACMR(),
+                mVertexCacheStatsBefore.getATVR(), mVertexCacheStatsAfter.getATVR(),
+                mVertexCacheStatsBefore.triangleCount, VertexOrderOptimizer::kDefaultCacheSize
+            );
+        }
 
         return mpScene;
     }
@@ -417,36 +524,27 @@ namespace Falcor
 
     MeshID SceneBuilder::addTriangleMesh(const ref<TriangleMesh>& pTriangleMesh, const ref<Material>& pMaterial, bool isAnimated)
     {
-        FALCOR_CHECK(pTriangleMesh != nullptr, "'pTriangleMesh' is missing");
-        FALCOR_CHECK(pMaterial != nullptr, "'pMaterial' is missing");
-
-        Mesh mesh;
-
-        const auto& indices = pTriangleMesh->getIndices();
-        const auto& vertices = pTriangleMesh->getVertices();
-
-        mesh.name = pTriangleMesh->getName();
-        mesh.faceCount = (uint32_t)(indices.size() / 3);
-        mesh.vertexCount = (uint32_t)vertices.size();
-        mesh.indexCount = (uint32_t)indices.size();
-        mesh.pIndices = indices.data();
-        mesh.topology = Vao::Topology::TriangleList;
-        mesh.isFrontFaceCW = pTriangleMesh->getFrontFaceCW();
-        mesh.pMaterial = pMaterial;
-        mesh.isAnimated = isAnimated;
-
-        std::vector<float3> positions(vertices.size());
-        std::vector<float3> normals(vertices.size());
-        std::vector<float2> texCoords(vertices.size());
-        std::transform(vertices.begin(), vertices.end(), positions.begin(), [] (const auto& v) { return v.position; });
-        std::transform(vertices.begin(), vertices.end(), normals.begin(), [] (const auto& v) { return v.normal; });
-        std::transform(vertices.begin(), vertices.end(), texCoords.begin(), [] (const auto& v) { return v.texCoord; });
+        TriangleMeshData data;
+        createTriangleMeshData(pTriangleMesh, pMaterial, isAnimated, data);
+        return addMesh(data.mesh);
+    }
 
-        mesh.positions = { positions.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex };
-        mesh.normals = { normals.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex };
-        mesh.texCrds = { texCoords.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex };
+    std::vector<MeshID> SceneBuilder::addTriangleMeshes(const std::vector<std::pair<ref<TriangleMesh>, ref<Material>>>& triangleMeshes, bool isAnimated)
+    {
+        // Pre-process the meshes, which includes generating their tangents. With Flags::ParallelBuild, this is done concurrently.
+        // The meshes are then added sequentially to retain a deterministic order in the global scene buffers.
+        std::vector<ProcessedMesh> processedMeshes(triangleMeshes.size());
+        forEachIndex(is_set(mFlags, Flags::ParallelBuild), triangleMeshes.size(), [&](size_t i)
+        {
+            TriangleMeshData data;
+            createTriangleMeshData(triangleMeshes[i].first, triangleMeshes[i].second, isAnimated, data);
+            processedMeshes[i] = processMesh(data.mesh);
+        });
 
-        return addMesh(mesh);
+        std::vector<MeshID> meshIDs;
+        meshIDs.reserve(processedMeshes.size());
+        for (const auto& processedMesh : processedMeshes) meshIDs.push_back(addProcessedMesh(processedMesh));
+        return meshIDs;
     }
 
     SceneBuilder::ProcessedMesh SceneBuilder::processMesh(const Mesh& mesh_, MeshAttributeIndices* pAttributeIndices, std::vector<float4>* pTangents) const
@@ -457,6 +555,7 @@ namespace Falcor
         //  - Compute tangent space if needed
         //  - Merge identical vertices, compute new indices (optional)
         //  - Validate final vertex data
+        //  - Reorder triangles and vertices for the vertex cache (optional)
         //  - Compact vertices/indices into runtime format
 
         // Copy the mesh desc so we can update it. The caller retains the ownership of the data.
@@ -537,74 +636,37 @@ namespace Falcor
 
         // Build new vertex/index buffers by merging identical vertices.
         // The search is based on the topology defined by the original index buffer.
-        //
-        // A linked-list of vertices is built for each original vertex index.
-        // We iterate over all vertices and first check if a vertex is identical to any of the other vertices
-        // using the same original vertex index. If not, a new vertex is inserted and added to the list.
-        // The 'heads' array point to the first vertex in each list, and each vertex has an associated next-pointer.
-        // This ensures that adding to the linked lists do not require any dynamic memory allocation.
-        //
-        const uint32_t invalidIndex = 0xffffffff;
-        std::vector<std::pair<Mesh::Vertex, uint32_t>> vertices;
-        std::vector<uint32_t> indices(mesh.indexCount);
-
-        if (pAttributeIndices)
-        {
-            pAttributeIndices->reserve(mesh.vertexCount);
-        }
+        // See VertexDeduplication for details.
+        std::vector<Mesh::Vertex> vertices;
+        std::vector<uint32_t> indices;
 
         if (mesh.mergeDuplicateVertices)
         {
-            vertices.reserve(mesh.vertexCount);
-
-            std::vector<uint32_t> heads(mesh.vertexCount, invalidIndex);
+            auto merged = VertexDeduplication::mergeHashed(mesh);
+            indices = std::move(merged.indices);
 
-            for (uint32_t face = 0; face < mesh.faceCount; face++)
+            vertices.resize(merged.uniqueCorners.size());
+            for (size_t i = 0; i < vertices.size(); i++)
             {
-                for (uint32_t vert = 0; vert < 3; vert++)
-                {
-                    const Mesh::Vertex v = mesh.getVertex(face, vert);
-                    const uint32_t origIndex = mesh.pIndices[face * 3 + vert];
-
-                    // Iterate over vertex list to check if it already exists.
-                    FALCOR_ASSERT(origIndex < heads.size());
-                    uint32_t index = heads[origIndex];
-                    bool found = false;
-
-                    while (index != invalidIndex)
-                    {
-                        if (compareVertices(v, vertices[index].first))
-                        {
-                            found = true;
-                            break;
-                        }
-                        index = vertices[index].second;
-                    }
-
-                    // Insert new vertex if we couldn't find it.
-                    if (!found)
-                    {
-                        FALCOR_ASSERT(vertices.size() < std::numeric_limits<uint32_t>::max());
-                        index = (uint32_t)vertices.size();
-                        vertices.push_back({ v, heads[origIndex] });
-
-                        if (pAttributeIndices)
-                        {
-                            pAttributeIndices->push_back(mesh.getAttributeIndices(face, vert));
-                            FALCOR_ASSERT(vertices.size() == pAttributeIndices->size());
-                        }
-
-                        heads[origIndex] = index;
-                    }
+                const uint32_t corner = merged.uniqueCorners[i];
+                vertices[i] = mesh.getVertex(corner / 3, corner % 3);
+            }
 
-                    // Store new vertex index.
-                    indices[face * 3 + vert] = index;
-                }
+            if (pAttributeIndices)
+            {
+                pAttributeIndices->reserve(merged.uniqueCorners.size());
+                for (uint32_t corner : merged.uniqueCorners) pAttributeIndices->push_back(mesh.getAttributeIndices(corner / 3, corner % 3));
+                FALCOR_ASSERT(vertices.size() == pAttributeIndices->size());
             }
         }
         else
         {
-            vertices = { mesh.vertexCount, std::make_pair(Mesh::Vertex{}, invalidIndex) };
+            vertices.resize(mesh.vertexCount);
+
+            if (pAttributeIndices)
+            {
+                pAttributeIndices->reserve(mesh.vertexCount);
+            }
 
             for (uint32_t face = 0; face < mesh.faceCount; face++)
             {
@@ -614,7 +676,7 @@ namespace Falcor
                     const uint32_t index = mesh.getAttributeIndex(mesh.positions, face, vert);
 
                     FALCOR_ASSERT(index < vertices.size());
-                    vertices[index].first = v;
+                    vertices[index] = v;
 
                     if (pAttributeIndices)
                     {
@@ -643,7 +705,7 @@ namespace Falcor
         size_t zeroCount = 0;
         for (const auto& v : vertices)
         {
-            validateVertex(v.first, invalidCount, zeroCount);
+            validateVertex(v, invalidCount, zeroCount);
         }
         if (invalidCount > 0) logWarning("The mesh '{}' has inf/nan vertex attributes at {} vertices. Please fix the asset.", mesh.name, invalidCount);
         if (zeroCount > 0) logWarning("The mesh '{}' has zero-length normals/tangents at {} vertices. Please fix the asset.", mesh.name, zeroCount);
@@ -652,6 +714,34 @@ namespace Falcor
         const bool isIndexed = !is_set(mFlags, Flags::NonIndexedVertices);
         const uint32_t vertexCount = isIndexed ? (uint32_t)vertices.size() : mesh.indexCount;
 
+        // Optimize triangle and vertex order. The vertex reordering is also applied to the attribute indices
+        // so that importers can map the processed vertices back to their source attributes.
+        if (isIndexed && is_set(mFlags, Flags::OptimizeVertexOrder))
+        {
+            processedMesh.vertexCacheStatsBefore = VertexOrderOptimizer::analyzeVertexCache(indices, (uint32_t)vertices.size());
+
+            std::vector<uint32_t> clusters;
+            VertexOrderOptimizer::optimizeVertexCache(indices, (uint32_t)vertices.size(), VertexOrderOptimizer::kDefaultCacheSize, &clusters);
+
+            std::vector<float3> positions(vertices.size());
+            for (size_t i = 0; i < vertices.size(); i++) positions[i] = vertices[i].position;
+            VertexOrderOptimizer::optimizeOverdraw(indices, positions, clusters);
+
+            auto remap = VertexOrderOptimizer::optimizeVertexFetch(indices, (uint32_t)vertices.size());
+            std::vector<Mesh::Vertex> reorderedVertices(vertices.size());
+            for (size_t i = 0; i < remap.size(); i++) reorderedVertices[i] = vertices[remap[i]];
+            vertices = std::move(reorderedVertices);
+
+            if (pAttributeIndices)
+            {
+                MeshAttributeIndices reorderedAttributeIndices(pAttributeIndices->size());
+                for (size_t i = 0; i < remap.size(); i++) reorderedAttributeIndices[i] = (*pAttributeIndices)[remap[i]];
+                *pAttributeIndices = std::move(reorderedAttributeIndices);
+            }
+
+            processedMesh.vertexCacheStatsAfter = VertexOrderOptimizer::analyzeVertexCache(indices, (uint32_t)vertices.size());
+        }
+
         // Copy indices into processed mesh.
         if (isIndexed)
         {
@@ -670,7 +760,7 @@ namespace Falcor
         {
             uint32_t index = isIndexed ? i : indices[i];
             FALCOR_ASSERT(index < vertices.size());
-            const Mesh::Vertex& v = vertices[index].first;
+            const Mesh::Vertex& v = vertices[index];
 
             {
                 StaticVertexData s;
@@ -699,7 +789,7 @@ namespace Falcor
 
     void SceneBuilder::generateTangents(Mesh& mesh, std::vector<float4>& tangents)
     {
-        tangents = MikkTSpaceWrapper::generateTangents(mesh);
+        tangents = TangentGenerator::generateChunked(mesh);
         if (!tangents.empty())
         {
             FALCOR_ASSERT(tangents.size() == mesh.indexCount);
@@ -749,6 +839,9 @@ namespace Falcor
         spec.staticVertexCount = (uint32_t)mesh.staticData.size();
         spec.skinningVertexCount = (uint32_t)mesh.skinningData.size();
 
+        mVertexCacheStatsBefore += mesh.vertexCacheStatsBefore;
+        mVertexCacheStatsAfter += mesh.vertexCacheStatsAfter;
+
         spec.indexData = std::move(mesh.indexData);
         spec.staticData = std::move(mesh.staticData);
         spec.skinningData = std::move(mesh.skinningData);
@@ -1662,7 +1755,7 @@ namespace Falcor
         NodeID identityNodeID = addNode(Node{ "Identity", float4x4::identity(), float4x4::identity() });
         auto& identityNode = mSceneGraph[identityNodeID.get()];
 
-        size_t transformedMeshCount = 0;
+        std::vector<std::pair<MeshID, float4x4>> transformedMeshes;
         for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)mMeshes.size(); ++meshID)
         {
             auto& mesh = mMeshes[meshID.get()];
@@ -1692,26 +1785,12 @@ namespace Falcor
             if (flippedWinding) mesh.isFrontFaceCW = !mesh.isFrontFaceCW;
 
             // Transform vertices to world space if not already identity transform.
+            // The vertex transforms are deferred so that they can run in parallel after the scene graph is updated.
             if (transform != float4x4::identity())
             {
                 FALCOR_ASSERT(!mesh.staticData.empty());
                 FALCOR_ASSERT((size_t)mesh.vertexCount == mesh.staticData.size());
-
-                float3x3 invTranspose3x3 = float3x3(transpose(inverse(transform)));
-                float3x3 transform3x3 = float3x3(transform);
-
-                for (auto& v : mesh.staticData)
-                {
-                    v.position = transformPoint(transform, v.position);
-                    v.normal = normalize(transformVector(invTranspose3x3, v.normal));
-                    v.tangent = float4(normalize(transformVector(transform3x3, v.tangent.xyz())), v.tangent.w);
-                    // TODO: We should flip the sign of v.tangent.w if flippedWinding is true.
-                    // Leaving that out for now for consistency with the shader code that needs the same fix.
-
-                    v.curveRadius = length(transformVector(transform3x3, float3(v.curveRadius, 0.f, 0.f)));
-                }
-
-                transformedMeshCount++;
+                transformedMeshes.push_back({ meshID, transform });
             }
 
             // Unlink mesh from its previous transform node.
@@ -1728,7 +1807,37 @@ namespace Falcor
             mesh.instances.insert(identityNodeID);
         }
 
-        if (transformedMeshCount > 0) logInfo("Pre-transformed {} static meshes to world space.", transformedMeshCount);
+        forEachIndex(is_set(mFlags, Flags::ParallelBuild), transformedMeshes.size(), [&](size_t i)
+        {
+            const auto& [meshID, transform] = transformedMeshes[i];
+            auto& mesh = mMeshes[meshID.get()];
+
+            float3x3 invTranspose3x3 = float3x3(transpose(inverse(transform)));
+            float3x3 transform3x3 = float3x3(transform);
+            // The curve radius is scaled by the length of the transformed x-axis.
+            float curveRadiusScale = length(transformVector(transform3x3, float3(1.f, 0.f, 0.f)));
+
+            // Transform the vertex attributes in place with the strided batch transforms.
+            // The vertices are processed in blocks so that each block stays in cache for all attributes.
+            const size_t stride = sizeof(StaticVertexData);
+            for (size_t offset = 0; offset < mesh.staticData.size(); offset += kVertexTransformBlockSize)
+            {
+                StaticVertexData* pVertices = mesh.staticData.data() + offset;
+                const size_t count = std::min(kVertexTransformBlockSize, mesh.staticData.size() - offset);
+
+                math::transformPoints(transform, &pVertices->position, &pVertices->position, count, stride, stride);
+                math::transformNormals(invTranspose3x3, &pVertices->normal, &pVertices->normal, count, stride, stride);
+                // Only the xyz components of the tangent are transformed, the sign in w is left unchanged.
+                // TODO: We should flip the sign of v.tangent.w if flippedWinding is true.
+                // Leaving that out for now for consistency with the shader code that needs the same fix.
+                float3* pTangents = reinterpret_cast<float3*>(&pVertices->tangent);
+                math::transformNormals(transform3x3, pTangents, pTangents, count, stride, stride);
+
+                for (size_t j = 0; j < count; j++) pVertices[j].curveRadius = std::abs(pVertices[j].curveRadius) * curveRadiusScale;
+            }
+        });
+
+        if (!transformedMeshes.empty()) logInfo("Pre-transformed {} static meshes to world space.", transformedMeshes.size());
     }
 
     void SceneBuilder::flipTriangleWinding(MeshSpec& mesh)
@@ -1796,38 +1905,33 @@ namespace Falcor
         // Note that this pass needs to run *after* pre-transformation of static meshes to world space,
         // as those transforms may flip the winding.
 
-        size_t flippedMeshCount = 0;
-        for (uint32_t meshID = 0; meshID < (uint32_t)mMeshes.size(); meshID++)
+        std::atomic<size_t> flippedMeshCount = 0;
+        forEachIndex(is_set(mFlags, Flags::ParallelBuild), mMeshes.size(), [&](size_t meshID)
         {
             auto& mesh = mMeshes[meshID];
 
             // Skip meshes that are already front face counter-clockwise.
-            if (mesh.isFrontFaceCW == false) continue;
+            if (mesh.isFrontFaceCW == false) return;
 
             flipTriangleWinding(mesh);
             FALCOR_ASSERT(!mesh.isFrontFaceCW);
 
             flippedMeshCount++;
-        }
+        });
 
-        if (flippedMeshCount > 0) logInfo("Flipped triangle winding for {} out of {} meshes.", flippedMeshCount, mMeshes.size());
+        if (flippedMeshCount > 0) logInfo("Flipped triangle winding for {} out of {} meshes.", flippedMeshCount.load(), mMeshes.size());
     }
 
     void SceneBuilder::calculateMeshBoundingBoxes()
     {
-        for (auto& mesh : mMeshes)
+        forEachIndex(is_set(mFlags, Flags::ParallelBuild), mMeshes.size(), [&](size_t meshID)
         {
+            auto& mesh = mMeshes[meshID];
             FALCOR_ASSERT(!mesh.staticData.empty());
             FALCOR_ASSERT((size_t)mesh.vertexCount == mesh.staticData.size());
 
-            AABB meshBB;
-            for (auto& v : mesh.staticData)
-            {
-                meshBB.include(v.position);
-            }
-
-            mesh.boundingBox = meshBB;
-        }
+            mesh.boundingBox = math::computeBounds(&mesh.staticData.data()->position, mesh.staticData.size(), sizeof(StaticVertexData));
+        });
     }
 
     void SceneBuilder::createMeshGroups()
@@ -2439,39 +2543,93 @@ namespace Falcor
         mSceneData.meshIndexData.setName("mMeshIndexData");
         mSceneData.meshStaticData.setName("meshStaticData");
 
-        mSceneData.meshSkinningData.reserve(totalSkinningVertexCount);
-
-        // Copy all vertex and index data into the global buffers.
-        for (auto& mesh : mMeshes)
+        if (is_set(mFlags, Flags::ParallelBuild))
         {
-            mesh.skinningVertexOffset = (uint32_t)mSceneData.meshSkinningData.size();
-            mesh.prevVertexOffset = mesh.skinningVertexOffset;
-
-            // Insert the static vertex data in the global array.
-            // The vertices are automatically converted to their packed format in this step.
-            mesh.staticVertexOffset = mSceneData.meshStaticData.insert(mesh.staticData.begin(), mesh.staticData.end());
+            // Allocate the ranges in the global buffers first, in the same order as the serial path below.
+            // This gives identical offsets, after which the per-mesh data can be copied in parallel.
+            mSceneData.meshSkinningData.resize(totalSkinningVertexCount);
 
-            if (isIndexed)
+            uint32_t skinningVertexOffset = 0;
+            for (auto& mesh : mMeshes)
             {
-                mesh.indexOffset = mSceneData.meshIndexData.insert(mesh.indexData.begin(), mesh.indexData.end());
+                mesh.skinningVertexOffset = skinningVertexOffset;
+                mesh.prevVertexOffset = mesh.skinningVertexOffset;
+                mesh.staticVertexOffset = mSceneData.meshStaticData.insertEmpty(mesh.staticData.size());
+                if (isIndexed) mesh.indexOffset = mSceneData.meshIndexData.insertEmpty(mesh.indexData.size());
+                if (mesh.isSkinned()) skinningVertexOffset += (uint32_t)mesh.skinningData.size();
             }
 
-            if (mesh.isSkinned())
+            forEachIndex(true, mMeshes.size(), [&](size_t meshID)
             {
-                FALCOR_ASSERT(!mesh.skinningData.empty());
-                mSceneData.meshSkinningData.insert(mSceneData.meshSkinningData.end(), mesh.skinningData.begin(), mesh.skinningData.end());
+                auto& mesh = mMeshes[meshID];
 
-                // Patch vertex index references.
-                for (uint32_t i = 0; i < mesh.skinningData.size(); ++i)
+                // The vertices are converted to their packed format in this step.
+                for (uint32_t i = 0; i < mesh.staticData.size(); ++i)
                 {
-                    mSceneData.meshSkinningData[mesh.skinningVertexOffset + i].staticIndex += mesh.staticVertexOffset;
+                    mSceneData.meshStaticData[mesh.staticVertexOffset + i] = PackedStaticVertexData(mesh.staticData[i]);
+                }
+
+                if (isIndexed)
+                {
+                    for (uint32_t i = 0; i < mesh.indexData.size(); ++i)
+                    {
+                        mSceneData.meshIndexData[mesh.indexOffset + i] = mesh.indexData[i];
+                    }
                 }
-            }
 
-            // Free the mesh local data.
-            mesh.indexData.clear();
-            mesh.staticData.clear();
-            mesh.skinningData.clear();
+                if (mesh.isSkinned())
+                {
+                    FALCOR_ASSERT(!mesh.skinningData.empty());
+                    for (uint32_t i = 0; i < mesh.skinningData.size(); ++i)
+                    {
+                        auto& s = mSceneData.meshSkinningData[mesh.skinningVertexOffset + i];
+                        s = mesh.skinningData[i];
+                        s.staticIndex += mesh.staticVertexOffset; // Patch vertex index references.
+                    }
+                }
+
+                // Free the mesh local data.
+                mesh.indexData.clear();
+                mesh.staticData.clear();
+                mesh.skinningData.clear();
+            });
+        }
+        else
+        {
+            mSceneData.meshSkinningData.reserve(totalSkinningVertexCount);
+
+            // Copy all vertex and index data into the global buffers.
+            for (auto& mesh : mMeshes)
+            {
+                mesh.skinningVertexOffset = (uint32_t)mSceneData.meshSkinningData.size();
+                mesh.prevVertexOffset = mesh.skinningVertexOffset;
+
+                // Insert the static vertex data in the global array.
+                // The vertices are automatically converted to their packed format in this step.
+                mesh.staticVertexOffset = mSceneData.meshStaticData.insert(mesh.staticData.begin(), mesh.staticData.end());
+
+                if (isIndexed)
+                {
+                    mesh.indexOffset = mSceneData.meshIndexData.insert(mesh.indexData.begin(), mesh.indexData.end());
+                }
+
+                if (mesh.isSkinned())
+                {
+                    FALCOR_ASSERT(!mesh.skinningData.empty());
+                    mSceneData.meshSkinningData.insert(mSceneData.meshSkinningData.end(), mesh.skinningData.begin(), mesh.skinningData.end());
+
+                    // Patch vertex index references.
+                    for (uint32_t i = 0; i < mesh.skinningData.size(); ++i)
+                    {
+                        mSceneData.meshSkinningData[mesh.skinningVertexOffset + i].staticIndex += mesh.staticVertexOffset;
+                    }
+                }
+
+                // Free the mesh local data.
+                mesh.indexData.clear();
+                mesh.staticData.clear();
+                mesh.skinningData.clear();
+            }
         }
 
         // Initialize offsets for prev vertex data for vertex-animated meshes
@@ -2593,8 +2751,9 @@ namespace Falcor
         // Match texture coordinate quantization for textured emissives to format of PackedEmissiveTriangle.
         // This is to avoid mismatch when sampling and evaluating emissive triangles.
         // Note that non-emissive meshes are unmodified and use full precision texcoords.
-        for (auto& mesh : mMeshes)
+        forEachIndex(is_set(mFlags, Flags::ParallelBuild), mMeshes.size(), [&](size_t meshID)
         {
+            const auto& mesh = mMeshes[meshID];
             const auto& pMaterial = mSceneData.pMaterials->getMaterial(mesh.materialId)->toBasicMaterial();
             if (pMaterial && pMaterial->getEmissiveTexture() != nullptr)
             {
@@ -2638,7 +2797,7 @@ namespace Falcor
                     }
                 }
             }
-        }
+        });
     }
 
     void SceneBuilder::removeDuplicateSDFGrids()
@@ -2962,6 +3121,11 @@ namespace Falcor
         flags.value("DontUseDisplacement", SceneBuilder::Flags::DontUseDisplacement);
         flags.value("UseCompressedHitInfo", SceneBuilder::Flags::UseCompressedHitInfo);
         flags.value("TessellateCurvesIntoPolyTubes", SceneBuilder::Flags::TessellateCurvesIntoPolyTubes);
+        flags.value("ParallelBuild", SceneBuilder::Flags::ParallelBuild);
+        flags.value("OptimizeVertexOrder", SceneBuilder::Flags::OptimizeVertexOrder);
+        flags.value("StreamVertexCaches", SceneBuilder::Flags::StreamVertexCaches);
+        flags.value("UseTextureCache", SceneBuilder::Flags::UseTextureCache);
+        flags.value("DontDeduplicateTextures", SceneBuilder::Flags::DontDeduplicateTextures);
         flags.value("UseCache", SceneBuilder::Flags::UseCache);
         flags.value("RebuildCache", SceneBuilder::Flags::RebuildCache);
         ScriptBindings::addEnumBinaryOperators(flags);
@@ -31,6 +31,7 @@
 #include "SceneIDs.h"
 #include "Transform.h"
 #include "TriangleMesh.h"
+#include "VertexOrderOptimizer.h"
 #include "VertexAttrib.slangh"
 #include "SceneTypes.slang"
 #include "Material/MaterialTextureLoader.h"
@@ -48,6 +49,7 @@
 #include <filesystem>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace Falcor
@@ -77,6 +79,11 @@ namespace Falcor
             DontUseDisplacement             = 0x4000,   ///< Don't use displacement mapping.
             UseCompressedHitInfo            = 0x8000,   ///< Use compressed hit info (on scenes with triangle meshes only).
             TessellateCurvesIntoPolyTubes   = 0x10000,  ///< Tessellate curves into poly-tubes (the default is linear swept spheres).
+            ParallelBuild                   = 0x20000,  ///< Run independent build stages and per-mesh work concurrently on a thread pool. The resulting scene is identical to the serial build.
+            OptimizeVertexOrder             = 0x40000,  ///< Reorder triangles and vertices of indexed meshes for vertex cache efficiency, reduced overdraw and vertex fetch locality.
+            StreamVertexCaches              = 0x80000,  ///< Keep keyframes of cached curve and mesh animations compressed on the CPU and stream them into a fixed number of GPU buffers.
+            UseTextureCache                 = 0x100000, ///< Cache decoded material textures including mips on disk, keyed by file content. This reduces texture load time on subsequent loads.
+            DontDeduplicateTextures         = 0x200000, ///< Don't deduplicate material textures by file content. By default, texture files with identical content are loaded only once.
 
             UseCache                        = 0x10000000, ///< Enable scene caching. This caches the runtime scene representation on disk to reduce load time.
             RebuildCache                    = 0x20000000, ///< Rebuild scene cache.
@@ -278,6 +285,9 @@ namespace Falcor
             std::vector<uint32_t> indexData;    ///< Vertex indices in either 32-bit or 16-bit format packed tightly, or empty if non-indexed.
             std::vector<StaticVertexData> staticData;
             std::vector<SkinningVertexData> skinningData;
+
+            VertexOrderOptimizer::Statistics vertexCacheStatsBefore; ///< Vertex cache statistics before vertex order optimization. Only valid with Flags::OptimizeVertexOrder.
+            VertexOrderOptimizer::Statistics vertexCacheStatsAfter;  ///< Vertex cache statistics after vertex order optimization. Only valid with Flags::OptimizeVertexOrder.
         };
 
         using MeshAttributeIndices = std::vector<Mesh::VertexAttributeIndices>;
@@ -423,6 +433,15 @@ namespace Falcor
         */
         MeshID addTriangleMesh(const ref<TriangleMesh>& pTriangleMesh, const ref<Material>& pMaterial, bool isAnimated = false);
 
+        /** Add a batch of triangle meshes.
+            The meshes are pre-processed (including tangent generation) and added in order.
+            With Flags::ParallelBuild, the meshes are pre-processed concurrently.
+            \param triangleMeshes List of triangle meshes and the materials to use for them.
+            \param isAnimated True if the mesh vertices can be modified during rendering (e.g., skinning or inverse rendering).
+            \return The IDs of the meshes in the scene, in the order of the input list.
+        */
+        std::vector<MeshID> addTriangleMeshes(const std::vector<std::pair<ref<TriangleMesh>, ref<Material>>>& triangleMeshes, bool isAnimated = false);
+
         /** Pre-process a mesh into the data format that is used in the global scene buffers.
             Throws an exception if something went wrong.
             \param mesh The mesh to pre-process.
@@ -433,6 +452,7 @@ namespace Falcor
         ProcessedMesh processMesh(const Mesh& mesh, MeshAttributeIndices* pAttributeIndices = nullptr, std::vector<float4>* pTangents = nullptr) const;
 
         /** Generate tangents for a mesh.
+            Large meshes are split into chunks that are processed concurrently, see TangentGenerator::generateChunked().
             \param mesh The mesh to generate tangents for. If successful, the tangent attribute on the mesh will be set to the output vector.
             \param tangents Output for generated tangents.
         */
@@ -785,6 +805,9 @@ namespace Falcor
 
         CurveList mCurves;
 
+        VertexOrderOptimizer::Statistics mVertexCacheStatsBefore;   ///< Accumulated vertex cache statistics of all added meshes before optimization.
+        VertexOrderOptimizer::Statistics mVertexCacheStatsAfter;    ///< Accumulated vertex cache statistics of all added meshes after optimization.
+
         std::unique_ptr<MaterialTextureLoader> mpMaterialTextureLoader;
 
         // Helpers
@@ -30,11 +30,20 @@
 #include "Material/HairMaterial.h"
 #include "Material/ClothMaterial.h"
 #include "Material/MaterialTextureLoader.h"
+#include "Core/Platform/MemoryMappedFile.h"
 #include "Utils/Logger.h"
+#include "Utils/NumericRange.h"
+#include "Utils/TaskManager.h"
+#include "Utils/Math/Common.h"
+#include "Utils/Timing/CpuTimer.h"
 
-#include <lz4_stream/lz4_stream.h>
+#include <lz4.h>
 
+#include <algorithm>
+#include <execution>
 #include <fstream>
+#include <functional>
+#include <sstream>
 
 namespace Falcor
 {
@@ -43,25 +52,76 @@ namespace Falcor
         /** Specfies the current cache file version.
             This needs to be incremented every time the file format changes!
         */
-        const uint32_t kVersion = 25;
+        const uint32_t kVersion = 29;
 
         /** Scene cache directory (subdirectory in the application data directory).
         */
         const std::string kDirectory = "NVIDIA/Falcor/SceneCache";
 
-        const size_t kBlockSize = 1 * 1024 * 1024;
+        /** Alignment of the chunk data in the file.
+            Raw chunks are copied directly from the memory mapped file, so we align them to cache lines.
+        */
+        const uint64_t kChunkAlignment = 64;
 
         const char* kMagic = "FalcorS$";
         struct Header
         {
             uint8_t magic[8]{};
             uint32_t version{};
+            uint32_t chunkCount{};
 
             bool isValid() const
             {
                 return std::memcmp(magic, kMagic, sizeof(Header::magic)) == 0 && version == kVersion;
             }
         };
+
+        /** Chunk types. Each chunk holds an independently serialized part of the scene data.
+        */
+        enum class ChunkType : uint32_t
+        {
+            Scene,              ///< Import paths, render settings, cameras, lights, scene graph, metadata and custom primitives.
+            Grids,              ///< Grids, grid volumes and environment map.
+            Materials,          ///< Materials.
+            Animations,         ///< Animations.
+            Meshes,             ///< Mesh descriptors, instances, groups and vertex caches.
+            Curves,             ///< Curve descriptors, instances, vertex data and vertex caches.
+            MeshIndexData,      ///< Raw mesh index data. There is one chunk per split buffer.
+            MeshStaticData,     ///< Raw mesh vertex data. There is one chunk per split buffer.
+            MeshSkinningData,   ///< Raw mesh skinning data.
+        };
+
+        enum class ChunkCompression : uint32_t
+        {
+            None,
+            LZ4,
+        };
+
+        /** Entry in the chunk table, which directly follows the header.
+        */
+        struct ChunkInfo
+        {
+            ChunkType type = ChunkType::Scene;
+            uint32_t index = 0;                                 ///< Index among chunks of the same type.
+            ChunkCompression compression = ChunkCompression::None;
+            uint32_t reserved = 0;
+            uint64_t offset = 0;                                ///< Offset of the chunk data in the file.
+            uint64_t storedSize = 0;                            ///< Size of the chunk data in the file.
+            uint64_t size = 0;                                  ///< Size of the uncompressed chunk data.
+        };
+        static_assert(sizeof(ChunkInfo) == 40);
+
+        /** Stream buffer for reading from a block of memory without copying it.
+        */
+        class MemoryStreamBuffer : public std::streambuf
+        {
+        public:
+            MemoryStreamBuffer(const void* data, size_t size)
+            {
+                char* begin = const_cast<char*>(static_cast<const char*>(data));
+                setg(begin, begin, begin + size);
+            }
+        };
     }
 
     /** Wrapper around std::ostream to ease serialization of basic types.
@@ -215,9 +275,294 @@ namespace Falcor
         std::istream& mStream;
     };
 
+
+    /** Helper for writing the cache file as a list of chunks.
+        Chunks are serialized in the order they are added and compressed in parallel when the file is written.
+    */
+    class SceneCache::ChunkWriter
+    {
+    public:
+        /** Add a chunk that is serialized by a function and compressed.
+        */
+        template<typename Func>
+        void addChunk(ChunkType type, const Func& func)
+        {
+            std::ostringstream ss(std::ios_base::out | std::ios_base::binary);
+            OutputStream stream(ss);
+            func(stream);
+
+            Chunk chunk;
+            chunk.info = createInfo(type, ChunkCompression::LZ4);
+            chunk.serializedData = ss.str();
+            chunk.pData = chunk.serializedData.data();
+            chunk.info.size = chunk.serializedData.size();
+            mChunks.push_back(std::move(chunk));
+        }
+
+        /** Add a chunk holding raw data, which is stored uncompressed.
+            The data is not copied and needs to stay valid until the file is written.
+        */
+        void addRawChunk(ChunkType type, const void* pData, size_t size)
+        {
+            Chunk chunk;
+            chunk.info = createInfo(type, ChunkCompression::None);
+            chunk.pData = pData;
+            chunk.info.size = size;
+            mChunks.push_back(std::move(chunk));
+        }
+
+        /** Compress the chunks and write the file.
+        */
+        void write(std::ostream& fs)
+        {
+            NumericRange<size_t> range(0, mChunks.size());
+            std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t i) { compress(mChunks[i]); });
+
+            // Lay out the chunks after the chunk table.
+            uint64_t offset = align_to(kChunkAlignment, uint64_t(sizeof(Header) + mChunks.size() * sizeof(ChunkInfo)));
+            for (auto& chunk : mChunks)
+            {
+                chunk.info.offset = offset;
+                offset = align_to(kChunkAlignment, offset + chunk.info.storedSize);
+            }
+
+            Header header;
+            std::memcpy(header.magic, kMagic, sizeof(Header::magic));
+            header.version = kVersion;
+            header.chunkCount = (uint32_t)mChunks.size();
+            fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            for (const auto& chunk : mChunks) fs.write(reinterpret_cast<const char*>(&chunk.info), sizeof(ChunkInfo));
+
+            uint64_t position = sizeof(Header) + mChunks.size() * sizeof(ChunkInfo);
+            const char padding[kChunkAlignment] = {};
+            for (const auto& chunk : mChunks)
+            {
+                FALCOR_ASSERT(chunk.info.offset >= position && chunk.info.offset - position < kChunkAlignment);
+                fs.write(padding, chunk.info.offset - position);
+                const void* pStoredData = chunk.compressedData.empty() ? chunk.pData : chunk.compressedData.data();
+                fs.write(static_cast<const char*>(pStoredData), chunk.info.storedSize);
+                position = chunk.info.offset + chunk.info.storedSize;
+            }
+        }
+
+    private:
+        struct Chunk
+        {
+            ChunkInfo info;
+            const void* pData = nullptr;        ///< Uncompressed data.
+            std::string serializedData;         ///< Storage of the uncompressed data for serialized chunks.
+            std::vector<char> compressedData;   ///< Compressed data, or empty if stored uncompressed.
+        };
+
+        ChunkInfo createInfo(ChunkType type, ChunkCompression compression) const
+        {
+            ChunkInfo info;
+            info.type = type;
+            info.index = (uint32_t)std::count_if(mChunks.begin(), mChunks.end(), [type](const Chunk& chunk) { return chunk.info.type == type; });
+            info.compression = compression;
+            return info;
+        }
+
+        static void compress(Chunk& chunk)
+        {
+            // Fall back to storing the data uncompressed if it is too large for LZ4 or does not compress.
+            if (chunk.info.compression == ChunkCompression::LZ4 && chunk.info.size > 0 && chunk.info.size <= LZ4_MAX_INPUT_SIZE)
+            {
+                chunk.compressedData.resize(LZ4_compressBound((int)chunk.info.size));
+                int compressedSize = LZ4_compress_default(static_cast<const char*>(chunk.pData), chunk.compressedData.data(), (int)chunk.info.size, (int)chunk.compressedData.size());
+                if (compressedSize > 0 && (uint64_t)compressedSize < chunk.info.size)
+                {
+                    chunk.compressedData.resize(compressedSize);
+                    chunk.info.storedSize = compressedSize;
+                    return;
+                }
+            }
+
+            chunk.compressedData = {};
+            chunk.info.compression = ChunkCompression::None;
+            chunk.info.storedSize = chunk.info.size;
+        }
+
+        std::vector<Chunk> mChunks;
+    };
+
+    /** Helper for reading the chunks of a memory mapped cache file.
+        Chunks with a registered raw data target or parser are decoded in parallel by decode().
+        The remaining chunks are parsed on the calling thread by parse().
+    */
+    class SceneCache::ChunkReader
+    {
+    public:
+        using Parser = std::function<void(InputStream& stream)>;
+
+        ChunkReader(const std::filesystem::path& path)
+            : mPath(path)
+        {
+            if (!mFile.open(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan))
+                FALCOR_THROW("Failed to open scene cache file '{}'.", path);
+
+            const uint8_t* pFileData = static_cast<const uint8_t*>(mFile.getData());
+            const size_t fileSize = mFile.getMappedSize();
+
+            Header header;
+            if (fileSize < sizeof(Header)) FALCOR_THROW("Invalid header in scene cache file '{}'.", path);
+            std::memcpy(&header, pFileData, sizeof(Header));
+            if (!header.isValid()) FALCOR_THROW("Invalid header in scene cache file '{}'.", path);
+
+            if (fileSize < sizeof(Header) + header.chunkCount * sizeof(ChunkInfo)) FALCOR_THROW("Invalid chunk table in scene cache file '{}'.", path);
+            mChunks.resize(header.chunkCount);
+            for (uint32_t i = 0; i < header.chunkCount; ++i)
+            {
+                ChunkInfo& info = mChunks[i].info;
+                std::memcpy(&info, pFileData + sizeof(Header) + i * sizeof(ChunkInfo), sizeof(ChunkInfo));
+                if (info.offset > fileSize || info.storedSize > fileSize - info.offset) FALCOR_THROW("Invalid chunk {} in scene cache file '{}'.", i, path);
+                if (info.compression == ChunkCompression::None && info.storedSize != info.size) FALCOR_THROW("Invalid chunk {} in scene cache file '{}'.", i, path);
+            }
+        }
+
+        /** Set the target for raw chunks of a given type. There is one target vector per chunk.
+        */
+        template<typename T>
+        void setRawTarget(ChunkType type, std::vector<std::vector<T>>& targets)
+        {
+            targets.resize(countChunks(type));
+            for (auto& chunk : mChunks)
+            {
+                if (chunk.info.type != type) continue;
+                if (chunk.info.index >= targets.size()) FALCOR_THROW("Invalid chunk index in scene cache file '{}'.", mPath);
+                chunk.rawTarget = [&target = targets[chunk.info.index]](const uint8_t* pData, size_t size) { copyRaw(pData, size, target); };
+            }
+        }
+
+        /** Set the target for a single raw chunk of a given type.
+        */
+        template<typename T>
+        void setRawTarget(ChunkType type, std::vector<T>& target)
+        {
+            Chunk& chunk = getChunk(type);
+            chunk.rawTarget = [&target](const uint8_t* pData, size_t size) { copyRaw(pData, size, target); };
+        }
+
+        /** Set a parser that is run on a worker thread in decode().
+            The parser must only access data not touched by other parsers.
+        */
+        void setParser(ChunkType type, Parser parser)
+        {
+            getChunk(type).parser = std::move(parser);
+        }
+
+        /** Decompress all chunks and run the raw data copies and parsers in parallel.
+        */
+        void decode()
+        {
+            TaskManager taskManager(true);
+            for (auto& chunk : mChunks)
+            {
+                taskManager.addTask([this, &chunk]()
+                {
+                    decompress(chunk);
+                    const uint8_t* pData = getData(chunk);
+                    if (chunk.rawTarget)
+                    {
+                        chunk.rawTarget(pData, chunk.info.size);
+                    }
+                    else if (chunk.parser)
+                    {
+                        MemoryStreamBuffer buffer(pData, chunk.info.size);
+                        std::istream is(&buffer);
+                        InputStream stream(is);
+                        chunk.parser(stream);
+                        if (is.fail()) FALCOR_THROW("Failed to read scene cache file '{}'.", mPath);
+                    }
+                });
+            }
+            taskManager.finish(nullptr);
+        }
+
+        /** Parse a decoded chunk on the calling thread.
+        */
+        void parse(ChunkType type, const Parser& parser)
+        {
+            Chunk& chunk = getChunk(type);
+            MemoryStreamBuffer buffer(getData(chunk), chunk.info.size);
+            std::istream is(&buffer);
+            InputStream stream(is);
+            parser(stream);
+            if (is.fail()) FALCOR_THROW("Failed to read scene cache file '{}'.", mPath);
+        }
+
+        size_t getFileSize() const { return mFile.getSize(); }
+        size_t getChunkCount() const { return mChunks.size(); }
+
+    private:
+        struct Chunk
+        {
+            ChunkInfo info;
+            std::vector<uint8_t> decompressedData;
+            std::function<void(const uint8_t* pData, size_t size)> rawTarget;
+            Parser parser;
+        };
+
+        template<typename T>
+        static void copyRaw(const uint8_t* pData, size_t size, std::vector<T>& target)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            if (size % sizeof(T) != 0) FALCOR_THROW("Invalid raw chunk size in scene cache file.");
+            target.resize(size / sizeof(T));
+            std::memcpy(target.data(), pData, size);
+        }
+
+        uint32_t countChunks(ChunkType type) const
+        {
+            return (uint32_t)std::count_if(mChunks.begin(), mChunks.end(), [type](const Chunk& chunk) { return chunk.info.type == type; });
+        }
+
+        Chunk& getChunk(ChunkType type)
+        {
+            auto it = std::find_if(mChunks.begin(), mChunks.end(), [type](const Chunk& chunk) { return chunk.info.type == type; });
+            if (it == mChunks.end()) FALCOR_THROW("Missing chunk {} in scene cache file '{}'.", (uint32_t)type, mPath);
+            return *it;
+        }
+
+        void decompress(Chunk& chunk)
+        {
+            if (chunk.info.compression == ChunkCompression::None) return;
+            if (chunk.info.compression != ChunkCompression::LZ4 || chunk.info.size > LZ4_MAX_INPUT_SIZE) FALCOR_THROW("Invalid chunk compression in scene cache file '{}'.", mPath);
+
+            chunk.decompressedData.resize(chunk.info.size);
+            const char* pSrc = static_cast<const char*>(mFile.getData()) + chunk.info.offset;
+            int size = LZ4_decompress_safe(pSrc, reinterpret_cast<char*>(chunk.decompressedData.data()), (int)chunk.info.storedSize, (int)chunk.info.size);
+            if (size < 0 || (uint64_t)size != chunk.info.size) FALCOR_THROW("Failed to decompress chunk in scene cache file '{}'.", mPath);
+        }
+
+        const uint8_t* getData(const Chunk& chunk) const
+        {
+            if (chunk.info.compression == ChunkCompression::None) return static_cast<const uint8_t*>(mFile.getData()) + chunk.info.offset;
+            return chunk.decompressedData.data();
+        }
+
+        std::filesystem::path mPath;
+        MemoryMappedFile mFile;
+        std::vector<Chunk> mChunks;
+    };
+
     bool SceneCache::hasValidCache(const Key& key)
     {
-        auto cachePath = getCachePath(key);
+        return hasValidCache(getCachePath(key));
+    }
+
+    void SceneCache::writeCache(const Scene::SceneData& sceneData, const Key& key)
+    {
+        writeCache(sceneData, getCachePath(key));
+    }
+
+    Scene::SceneData SceneCache::readCache(ref<Device> pDevice, const Key& key, const std::filesystem::path& textureCacheDirectory, bool deduplicateTextures)
+    {
+        return readCache(pDevice, getCachePath(key), textureCacheDirectory, deduplicateTextures);
+    }
+
+    bool SceneCache::hasValidCache(const std::filesystem::path& cachePath)
+    {
         if (!std::filesystem::exists(cachePath)) return false;
 
         // Open file.
@@ -230,10 +575,8 @@ namespace Falcor
         return !fs.eof() && header.isValid();
     }
 
-    void SceneCache::writeCache(const Scene::SceneData& sceneData, const Key& key)
+    void SceneCache::writeCache(const Scene::SceneData& sceneData, const std::filesystem::path& cachePath)
     {
-        auto cachePath = getCachePath(key);
-
         logInfo("Writing scene cache to '{}'.", cachePath);
 
         // Create directories if not existing.
@@ -243,39 +586,23 @@ namespace Falcor
         std::ofstream fs(cachePath.c_str(), std::ios_base::binary);
         if (fs.bad()) FALCOR_THROW("Failed to create scene cache file '{}'.", cachePath);
 
-        // Write header (uncompressed).
-        Header header;
-        std::memcpy(header.magic, kMagic, sizeof(Header::magic));
-        header.version = kVersion;
-        fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
-
-        // Write cache (compressed).
-        lz4_stream::basic_ostream<kBlockSize> zs(fs);
-        OutputStream stream(zs);
-        writeSceneData(stream, sceneData);
+        // Write cache.
+        ChunkWriter writer;
+        writeSceneData(writer, sceneData);
+        writer.write(fs);
         if (fs.bad()) FALCOR_THROW("Failed to write scene cache file to '{}'.", cachePath);
     }
 
-    Scene::SceneData SceneCache::readCache(ref<Device> pDevice, const Key& key)
+    Scene::SceneData SceneCache::readCache(ref<Device> pDevice, const std::filesystem::path& cachePath, const std::filesystem::path& textureCacheDirectory, bool deduplicateTextures)
     {
-        auto cachePath = getCachePath(key);
-
         logInfo("Loading scene cache from '{}'.", cachePath);
 
-        // Open file.
-        std::ifstream fs(cachePath.c_str(), std::ios_base::binary);
-        if (fs.bad()) FALCOR_THROW("Failed to open scene cache file '{}'.", cachePath);
-
-        // Read header (uncompressed).
-        Header header;
-        fs.read(reinterpret_cast<char*>(&header), sizeof(header));
-        if (!header.isValid()) FALCOR_THROW("Invalid header in scene cache file '{}'.", cachePath);
+        auto startTime = CpuTimer::getCurrentTimePoint();
+        ChunkReader reader(cachePath);
+        auto sceneData = readSceneData(reader, pDevice, textureCacheDirectory, deduplicateTextures);
+        double duration = CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint());
+        logInfo("Loaded scene cache with {} chunks ({:.1f} MB) in {:.1f} ms.", reader.getChunkCount(), reader.getFileSize() / (1024.0 * 1024.0), duration);
 
-        // Read cache (compressed).
-        lz4_stream::basic_istream<kBlockSize, kBlockSize> zs(fs);
-        InputStream stream(zs);
-        auto sceneData = readSceneData(stream, pDevice);
-        if (fs.bad()) FALCOR_THROW("Failed to read scene cache file from '{}'.", cachePath);
         return sceneData;
     }
 
@@ -286,66 +613,209 @@ namespace Falcor
 
     // SceneData
 
-    void SceneCache::writeSceneData(OutputStream& stream, const Scene::SceneData& sceneData)
+    void SceneCache::writeSceneData(ChunkWriter& writer, const Scene::SceneData& sceneData)
     {
-        writeMarker(stream, "Paths");
-        stream.write((uint32_t)sceneData.importPaths.size());
-        for (const auto& pPath: sceneData.importPaths) stream.write(pPath);
+        writer.addChunk(ChunkType::Scene, [&](OutputStream& stream)
+        {
+            writeMarker(stream, "Paths");
+            stream.write((uint32_t)sceneData.importPaths.size());
+            for (const auto& pPath: sceneData.importPaths) stream.write(pPath);
+
+            writeMarker(stream, "Dicts");
+            stream.write((uint32_t)sceneData.importDicts.size());
+            for (const auto& pDict: sceneData.importDicts) stream.write(pDict);
+
+            writeMarker(stream, "RenderSettings");
+            stream.write(sceneData.renderSettings);
+
+            writeMarker(stream, "Cameras");
+            stream.write((uint32_t)sceneData.cameras.size());
+            for (const auto& pCamera : sceneData.cameras) writeCamera(stream, pCamera);
+            stream.write(sceneData.selectedCamera);
+            stream.write(sceneData.cameraSpeed);
+
+            writeMarker(stream, "Lights");
+            stream.write((uint32_t)sceneData.lights.size());
+            for (const auto& pLight : sceneData.lights) writeLight(stream, pLight);
+
+            writeMarker(stream, "SceneGraph");
+            stream.write((uint32_t)sceneData.sceneGraph.size());
+            for (const auto& node : sceneData.sceneGraph)
+            {
+                stream.write(node.name);
+                stream.write(node.parent);
+                stream.write(node.transform);
+                stream.write(node.meshBind);
+                stream.write(node.localToBindSpace);
+            }
 
-        writeMarker(stream, "Dicts");
-        stream.write((uint32_t)sceneData.importDicts.size());
-        for (const auto& pDict: sceneData.importDicts) stream.write(pDict);
+            writeMarker(stream, "Metadata");
+            writeMetadata(stream, sceneData.metadata);
 
-        writeMarker(stream, "RenderSettings");
-        stream.write(sceneData.renderSettings);
+            writeMarker(stream, "CustomPrimitives");
+            stream.write(sceneData.customPrimitiveDesc);
+            stream.write(sceneData.customPrimitiveAABBs);
 
-        writeMarker(stream, "Cameras");
-        stream.write((uint32_t)sceneData.cameras.size());
-        for (const auto& pCamera : sceneData.cameras) writeCamera(stream, pCamera);
-        stream.write(sceneData.selectedCamera);
-        stream.write(sceneData.cameraSpeed);
+            writeMarker(stream, "End");
+        });
 
-        writeMarker(stream, "Lights");
-        stream.write((uint32_t)sceneData.lights.size());
-        for (const auto& pLight : sceneData.lights) writeLight(stream, pLight);
+        writer.addChunk(ChunkType::Grids, [&](OutputStream& stream)
+        {
+            writeMarker(stream, "Grids");
+            stream.write((uint32_t)sceneData.grids.size());
+            for (const auto& pGrid : sceneData.grids) writeGrid(stream, pGrid);
 
-        writeMarker(stream, "Grids");
-        stream.write((uint32_t)sceneData.grids.size());
-        for (const auto& pGrid : sceneData.grids) writeGrid(stream, pGrid);
+            writeMarker(stream, "GridVolumes");
+            stream.write((uint32_t)sceneData.gridVolumes.size());
+            for (const auto& pGridVolume : sceneData.gridVolumes) writeGridVolume(stream, pGridVolume, sceneData.grids);
 
-        writeMarker(stream, "GridVolumes");
-        stream.write((uint32_t)sceneData.gridVolumes.size());
-        for (const auto& pGridVolume : sceneData.gridVolumes) writeGridVolume(stream, pGridVolume, sceneData.grids);
+            writeMarker(stream, "EnvMap");
+            bool hasEnvMap = sceneData.pEnvMap != nullptr;
+            stream.write(hasEnvMap);
+            if (hasEnvMap) writeEnvMap(stream, sceneData.pEnvMap);
 
-        writeMarker(stream, "EnvMap");
-        bool hasEnvMap = sceneData.pEnvMap != nullptr;
-        stream.write(hasEnvMap);
-        if (hasEnvMap) writeEnvMap(stream, sceneData.pEnvMap);
+            writeMarker(stream, "End");
+        });
 
-        writeMarker(stream, "Materials");
-        writeMaterials(stream, *sceneData.pMaterials);
+        writer.addChunk(ChunkType::Materials, [&](OutputStream& stream)
+        {
+            writeMarker(stream, "Materials");
+            writeMaterials(stream, *sceneData.pMaterials);
+            writeMarker(stream, "End");
+        });
 
-        writeMarker(stream, "SceneGraph");
-        stream.write((uint32_t)sceneData.sceneGraph.size());
-        for (const auto& node : sceneData.sceneGraph)
+        writer.addChunk(ChunkType::Animations, [&](OutputStream& stream)
         {
-            stream.write(node.name);
-            stream.write(node.parent);
-            stream.write(node.transform);
-            stream.write(node.meshBind);
-            stream.write(node.localToBindSpace);
-        }
+            writeMarker(stream, "Animations");
+            stream.write((uint32_t)sceneData.animations.size());
+            for (const auto& pAnimation : sceneData.animations) writeAnimation(stream, pAnimation);
+            writeMarker(stream, "End");
+        });
 
-        writeMarker(stream, "Animations");
-        stream.write((uint32_t)sceneData.animations.size());
-        for (const auto& pAnimation : sceneData.animations)
+        writer.addChunk(ChunkType::Meshes, [&](OutputStream& stream) { writeMeshes(stream, sceneData); });
+        writer.addChunk(ChunkType::Curves, [&](OutputStream& stream) { writeCurves(stream, sceneData); });
+
+        // Large buffers are stored as raw chunks.
+        for (const auto& buffer : sceneData.meshIndexData.mCpuBuffers)
+        {
+            writer.addRawChunk(ChunkType::MeshIndexData, buffer.data(), buffer.size() * sizeof(buffer[0]));
+        }
+        for (const auto& buffer : sceneData.meshStaticData.mCpuBuffers)
         {
-            writeAnimation(stream, pAnimation);
+            writer.addRawChunk(ChunkType::MeshStaticData, buffer.data(), buffer.size() * sizeof(buffer[0]));
         }
+        writer.addRawChunk(ChunkType::MeshSkinningData, sceneData.meshSkinningData.data(), sceneData.meshSkinningData.size() * sizeof(SkinningVertexData));
+    }
+
+    Scene::SceneData SceneCache::readSceneData(ChunkReader& reader, ref<Device> pDevice, const std::filesystem::path& textureCacheDirectory, bool deduplicateTextures)
+    {
+        Scene::SceneData sceneData;
+        sceneData.pMaterials = std::make_unique<MaterialSystem>(pDevice);
+        if (!textureCacheDirectory.empty()) sceneData.pMaterials->getTextureManager().setDiskCacheDirectory(textureCacheDirectory);
+        sceneData.pMaterials->getTextureManager().setContentDeduplication(deduplicateTextures);
+
+        // Decode the chunks that don't create GPU resources in parallel.
+        // Each of these writes to a disjoint part of the scene data.
+        reader.setRawTarget(ChunkType::MeshIndexData, sceneData.meshIndexData.mCpuBuffers);
+        reader.setRawTarget(ChunkType::MeshStaticData, sceneData.meshStaticData.mCpuBuffers);
+        reader.setRawTarget(ChunkType::MeshSkinningData, sceneData.meshSkinningData);
+        reader.setParser(ChunkType::Meshes, [&](InputStream& stream) { readMeshes(stream, sceneData); });
+        reader.setParser(ChunkType::Curves, [&](InputStream& stream) { readCurves(stream, sceneData); });
+        reader.setParser(ChunkType::Animations, [&](InputStream& stream)
+        {
+            readMarker(stream, "Animations");
+            sceneData.animations.resize(stream.read<uint32_t>());
+            for (auto& pAnimation : sceneData.animations) pAnimation = readAnimation(stream);
+            readMarker(stream, "End");
+        });
+        reader.decode();
+
+        reader.parse(ChunkType::Scene, [&](InputStream& stream)
+        {
+            readMarker(stream, "Paths");
+            sceneData.importPaths.resize(stream.read<uint32_t>());
+            for (auto& pPath : sceneData.importPaths) stream.read(pPath);
+
+            readMarker(stream, "Dicts");
+            sceneData.importDicts.resize(stream.read<uint32_t>());
+            for (auto& pDict : sceneData.importDicts) stream.read(pDict);
+
+            readMarker(stream, "RenderSettings");
+            stream.read(sceneData.renderSettings);
+
+            readMarker(stream, "Cameras");
+            sceneData.cameras.resize(stream.read<uint32_t>());
+            for (auto& pCamera : sceneData.cameras) pCamera = readCamera(stream);
+            stream.read(sceneData.selectedCamera);
+            stream.read(sceneData.cameraSpeed);
+
+            readMarker(stream, "Lights");
+            sceneData.lights.resize(stream.read<uint32_t>());
+            for (auto& pLight : sceneData.lights) pLight = readLight(stream);
+
+            readMarker(stream, "SceneGraph");
+            sceneData.sceneGraph.resize(stream.read<uint32_t>());
+            for (auto &node : sceneData.sceneGraph)
+            {
+                stream.read(node.name);
+                stream.read(node.parent);
+                stream.read(node.transform);
+                stream.read(node.meshBind);
+                stream.read(node.localToBindSpace);
+            }
+
+            readMarker(stream, "Metadata");
+            sceneData.metadata = readMetadata(stream);
+
+            readMarker(stream, "CustomPrimitives");
+            stream.read(sceneData.customPrimitiveDesc);
+            stream.read(sceneData.customPrimitiveAABBs);
+
+            readMarker(stream, "End");
+        });
+
+        reader.parse(ChunkType::Grids, [&](InputStream& stream)
+        {
+            readMarker(stream, "Grids");
+            sceneData.grids.resize(stream.read<uint32_t>());
+            for (auto& pGrid : sceneData.grids) pGrid = readGrid(stream, pDevice);
+
+            readMarker(stream, "GridVolumes");
+            sceneData.gridVolumes.resize(stream.read<uint32_t>());
+            for (auto& pGridVolume : sceneData.gridVolumes) pGridVolume = readGridVolume(stream, sceneData.grids, pDevice);
+
+            readMarker(stream, "EnvMap");
+            auto hasEnvMap = stream.read<bool>();
+            if (hasEnvMap) sceneData.pEnvMap = readEnvMap(stream, pDevice);
+
+            readMarker(stream, "End");
+        });
+
+        // Material textures are loaded asynchronously to allow loading other data
+        // in parallel while loading textures from files and uploading them to the GPU.
+        // Due to the current implementation, we need to make sure no other GPU operations (transfers)
+        // are executed while loading material textures. Due to this, we load volume grids and the envmap
+        // before material textures, as they upload buffers to the GPU when created.
+        // Make sure no other GPU operations are executed until calling pMaterialTextureLoader.reset()
+        // further down which blocks until all textures are loaded.
+        auto pMaterialTextureLoader = std::make_unique<MaterialTextureLoader>(sceneData.pMaterials->getTextureManager(), true);
 
-        writeMarker(stream, "Metadata");
-        writeMetadata(stream, sceneData.metadata);
+        reader.parse(ChunkType::Materials, [&](InputStream& stream)
+        {
+            readMarker(stream, "Materials");
+            readMaterials(stream, *sceneData.pMaterials, *pMaterialTextureLoader, pDevice);
+            readMarker(stream, "End");
+        });
 
+        pMaterialTextureLoader.reset();
+
+        return sceneData;
+    }
+
+    // Meshes
+
+    void SceneCache::writeMeshes(OutputStream& stream, const Scene::SceneData& sceneData)
+    {
         writeMarker(stream, "Meshes");
         stream.write(sceneData.meshDesc);
         stream.write(sceneData.meshNames);
@@ -371,107 +841,19 @@ namespace Falcor
             stream.write((uint32_t)cachedMesh.vertexData.size());
             for (const auto& data : cachedMesh.vertexData) stream.write(data);
         }
+        stream.write(sceneData.streamVertexCaches);
         stream.write(sceneData.useCompressedHitInfo);
         stream.write(sceneData.has16BitIndices);
         stream.write(sceneData.has32BitIndices);
         stream.write(sceneData.meshDrawCount);
-        writeSplitBuffer(stream, sceneData.meshIndexData);
-        writeSplitBuffer(stream, sceneData.meshStaticData);
-        stream.write(sceneData.meshSkinningData);
-
-        writeMarker(stream, "Curves");
-        stream.write(sceneData.curveDesc);
-        stream.write(sceneData.curveBBs);
-        stream.write(sceneData.curveInstanceData);
-        stream.write(sceneData.curveIndexData);
-        stream.write(sceneData.curveStaticData);
-
-        stream.write((uint32_t)sceneData.cachedCurves.size());
-        for (const auto& cachedCurve : sceneData.cachedCurves)
-        {
-            stream.write(cachedCurve.tessellationMode);
-            stream.write(cachedCurve.geometryID);
-            stream.write(cachedCurve.timeSamples);
-            stream.write(cachedCurve.indexData);
-            stream.write((uint32_t)cachedCurve.vertexData.size());
-            for (const auto& data : cachedCurve.vertexData) stream.write(data);
-        }
-
-        writeMarker(stream, "CustomPrimitives");
-        stream.write(sceneData.customPrimitiveDesc);
-        stream.write(sceneData.customPrimitiveAABBs);
-
+        // The buffer contents are stored in separate raw chunks.
+        writeSplitBufferInfo(stream, sceneData.meshIndexData);
+        writeSplitBufferInfo(stream, sceneData.meshStaticData);
         writeMarker(stream, "End");
     }
 
-    Scene::SceneData SceneCache::readSceneData(InputStream& stream, ref<Device> pDevice)
+    void SceneCache::readMeshes(InputStream& stream, Scene::SceneData& sceneData)
     {
-        Scene::SceneData sceneData;
-        sceneData.pMaterials = std::make_unique<MaterialSystem>(pDevice);
-
-        readMarker(stream, "Paths");
-        sceneData.importPaths.resize(stream.read<uint32_t>());
-        for (auto& pPath : sceneData.importPaths) stream.read(pPath);
-
-        readMarker(stream, "Dicts");
-        sceneData.importDicts.resize(stream.read<uint32_t>());
-        for (auto& pDict : sceneData.importDicts) stream.read(pDict);
-
-        readMarker(stream, "RenderSettings");
-        stream.read(sceneData.renderSettings);
-
-        readMarker(stream, "Cameras");
-        sceneData.cameras.resize(stream.read<uint32_t>());
-        for (auto& pCamera : sceneData.cameras) pCamera = readCamera(stream);
-        stream.read(sceneData.selectedCamera);
-        stream.read(sceneData.cameraSpeed);
-
-        readMarker(stream, "Lights");
-        sceneData.lights.resize(stream.read<uint32_t>());
-        for (auto& pLight : sceneData.lights) pLight = readLight(stream);
-
-        readMarker(stream, "Grids");
-        sceneData.grids.resize(stream.read<uint32_t>());
-        for (auto& pGrid : sceneData.grids) pGrid = readGrid(stream, pDevice);
-
-        readMarker(stream, "GridVolumes");
-        sceneData.gridVolumes.resize(stream.read<uint32_t>());
-        for (auto& pGridVolume : sceneData.gridVolumes) pGridVolume = readGridVolume(stream, sceneData.grids, pDevice);
-
-        readMarker(stream, "EnvMap");
-        auto hasEnvMap = stream.read<bool>();
-        if (hasEnvMap) sceneData.pEnvMap = readEnvMap(stream, pDevice);
-
-        // Material textures are loaded asynchronously to allow loading other data
-        // in parallel while loading textures from files and uploading them to the GPU.
-        // Due to the current implementation, we need to make sure no other GPU operations (transfers)
-        // are executed while loading material textures. Due to this, we load volume grids and the envmap
-        // before material textures, as they upload buffers to the GPU when created.
-        // Make sure no other GPU operations are executed until calling pMaterialTextureLoader.reset()
-        // further down which blocks until all textures are loaded.
-        auto pMaterialTextureLoader = std::make_unique<MaterialTextureLoader>(sceneData.pMaterials->getTextureManager(), true);
-
-        readMarker(stream, "Materials");
-        readMaterials(stream, *sceneData.pMaterials, *pMaterialTextureLoader, pDevice);
-
-        readMarker(stream, "SceneGraph");
-        sceneData.sceneGraph.resize(stream.read<uint32_t>());
-        for (auto &node : sceneData.sceneGraph)
-        {
-            stream.read(node.name);
-            stream.read(node.parent);
-            stream.read(node.transform);
-            stream.read(node.meshBind);
-            stream.read(node.localToBindSpace);
-        }
-
-        readMarker(stream, "Animations");
-        sceneData.animations.resize(stream.read<uint32_t>());
-        for (auto& pAnimation : sceneData.animations) pAnimation = readAnimation(stream);
-
-        readMarker(stream, "Metadata");
-        sceneData.metadata = readMetadata(stream);
-
         readMarker(stream, "Meshes");
         stream.read(sceneData.meshDesc);
         stream.read(sceneData.meshNames);
@@ -497,14 +879,42 @@ namespace Falcor
             cachedMesh.vertexData.resize(stream.read<uint32_t>());
             for (auto& data : cachedMesh.vertexData) stream.read(data);
         }
+        stream.read(sceneData.streamVertexCaches);
         stream.read(sceneData.useCompressedHitInfo);
         stream.read(sceneData.has16BitIndices);
         stream.read(sceneData.has32BitIndices);
         stream.read(sceneData.meshDrawCount);
-        readSplitBuffer(stream, sceneData.meshIndexData);
-        readSplitBuffer(stream, sceneData.meshStaticData);
-        stream.read(sceneData.meshSkinningData);
+        readSplitBufferInfo(stream, sceneData.meshIndexData);
+        readSplitBufferInfo(stream, sceneData.meshStaticData);
+        readMarker(stream, "End");
+    }
+
+    // Curves
+
+    void SceneCache::writeCurves(OutputStream& stream, const Scene::SceneData& sceneData)
+    {
+        writeMarker(stream, "Curves");
+        stream.write(sceneData.curveDesc);
+        stream.write(sceneData.curveBBs);
+        stream.write(sceneData.curveInstanceData);
+        stream.write(sceneData.curveIndexData);
+        stream.write(sceneData.curveStaticData);
 
+        stream.write((uint32_t)sceneData.cachedCurves.size());
+        for (const auto& cachedCurve : sceneData.cachedCurves)
+        {
+            stream.write(cachedCurve.tessellationMode);
+            stream.write(cachedCurve.geometryID);
+            stream.write(cachedCurve.timeSamples);
+            stream.write(cachedCurve.indexData);
+            stream.write((uint32_t)cachedCurve.vertexData.size());
+            for (const auto& data : cachedCurve.vertexData) stream.write(data);
+        }
+        writeMarker(stream, "End");
+    }
+
+    void SceneCache::readCurves(InputStream& stream, Scene::SceneData& sceneData)
+    {
         readMarker(stream, "Curves");
         stream.read(sceneData.curveDesc);
         stream.read(sceneData.curveBBs);
@@ -522,16 +932,7 @@ namespace Falcor
             cachedCurve.vertexData.resize(stream.read<uint32_t>());
             for (auto& data : cachedCurve.vertexData) stream.read(data);
         }
-
-        readMarker(stream, "CustomPrimitives");
-        stream.read(sceneData.customPrimitiveDesc);
-        stream.read(sceneData.customPrimitiveAABBs);
-
         readMarker(stream, "End");
-
-        pMaterialTextureLoader.reset();
-
-        return sceneData;
     }
 
     // Metadata
@@ -853,6 +1254,17 @@ namespace Falcor
                 stream.write(id);
             }
         }
+        // Streamed sequences are stored as file paths and loaded on demand again.
+        for (const auto& streamed : pGridVolume->mStreamedGrids)
+        {
+            stream.write((uint32_t)(streamed.pStreamer ? streamed.paths.size() : 0));
+            if (!streamed.pStreamer) continue;
+            for (const auto& path : streamed.paths) stream.write(path);
+            stream.write(streamed.gridname);
+            stream.write(streamed.options.maxResidentFrames);
+            stream.write(streamed.options.memoryBudget);
+            stream.write(streamed.options.prefetchCount);
+        }
         stream.write(pGridVolume->mGridFrame);
         stream.write(pGridVolume->mGridFrameCount);
         stream.write(pGridVolume->mBounds);
@@ -877,11 +1289,30 @@ namespace Falcor
                 pGrid = id == uint32_t(-1) ? nullptr : grids[id];
             }
         }
+        std::array<GridVolume::StreamedSequence, (size_t)GridVolume::GridSlot::Count> streamedGrids;
+        for (auto& streamed : streamedGrids)
+        {
+            streamed.paths.resize(stream.read<uint32_t>());
+            if (streamed.paths.empty()) continue;
+            for (auto& path : streamed.paths) stream.read(path);
+            stream.read(streamed.gridname);
+            stream.read(streamed.options.maxResidentFrames);
+            stream.read(streamed.options.memoryBudget);
+            stream.read(streamed.options.prefetchCount);
+        }
         stream.read(pGridVolume->mGridFrame);
         stream.read(pGridVolume->mGridFrameCount);
         stream.read(pGridVolume->mBounds);
         stream.read(pGridVolume->mData);
 
+        // Restart streaming at the cached frame.
+        for (uint32_t slotIndex = 0; slotIndex < (uint32_t)GridVolume::GridSlot::Count; ++slotIndex)
+        {
+            const auto& streamed = streamedGrids[slotIndex];
+            if (!streamed.paths.empty()) pGridVolume->streamGridSequence((GridVolume::GridSlot)slotIndex, streamed.paths, streamed.gridname, streamed.options);
+        }
+        pGridVolume->clearUpdates();
+
         return pGridVolume;
     }
 
@@ -983,19 +1414,17 @@ namespace Falcor
 
     // SplitBuffer
     template<typename T, bool TUseByteAddressBuffer>
-    void SceneCache::writeSplitBuffer(OutputStream& stream, const SplitBuffer<T, TUseByteAddressBuffer>& buffer)
+    void SceneCache::writeSplitBufferInfo(OutputStream& stream, const SplitBuffer<T, TUseByteAddressBuffer>& buffer)
     {
         stream.write(buffer.mBufferName);
         stream.write(buffer.mBufferCountDefinePrefix);
-        stream.write(buffer.mCpuBuffers);
     }
 
     template<typename T, bool TUseByteAddressBuffer>
-    void SceneCache::readSplitBuffer(InputStream& stream, SplitBuffer<T, TUseByteAddressBuffer>& buffer)
+    void SceneCache::readSplitBufferInfo(InputStream& stream, SplitBuffer<T, TUseByteAddressBuffer>& buffer)
     {
         stream.read(buffer.mBufferName);
         stream.read(buffer.mBufferCountDefinePrefix);
-        stream.read(buffer.mCpuBuffers);
     }
 
 }
@@ -53,6 +53,11 @@ namespace Falcor
     /** Helper class for reading and writing scene cache files.
         The scene cache is used to heavily reduce load times of more complex assets.
         The cache stores a binary representation of `Scene::SceneData` which contains everything to re-create a `Scene`.
+
+        The file consists of a header, a table of chunks and the chunk data. Each chunk holds one part of the
+        scene data (e.g. materials or animations) and is compressed independently, so that chunks can be
+        decompressed in parallel. Large vertex and index buffers are stored uncompressed and are copied
+        directly from the memory mapped file.
     */
     class FALCOR_API SceneCache
     {
@@ -74,18 +79,49 @@ namespace Falcor
         /** Read a scene cache.
             \param[in] pDevice GPU device.
             \param[in] key Cache key.
+            \param[in] textureCacheDirectory Disk cache directory for material textures (optional).
+            \param[in] deduplicateTextures Deduplicate material textures by file content.
+            \return Returns the loaded scene data.
+        */
+        static Scene::SceneData readCache(ref<Device> pDevice, const Key& key, const std::filesystem::path& textureCacheDirectory = {}, bool deduplicateTextures = true);
+
+        /** Check if a file is a valid scene cache.
+            \param[in] path Cache file path.
+            \return Returns true if the file is a valid cache.
+        */
+        static bool hasValidCache(const std::filesystem::path& path);
+
+        /** Write a scene cache to a file.
+            \param[in] sceneData Scene data.
+            \param[in] path Cache file path. Parent directories are created if not existing.
+        */
+        static void writeCache(const Scene::SceneData& sceneData, const std::filesystem::path& path);
+
+        /** Read a scene cache from a file.
+            \param[in] pDevice GPU device.
+            \param[in] path Cache file path.
+            \param[in] textureCacheDirectory Disk cache directory for material textures (optional).
+            \param[in] deduplicateTextures Deduplicate material textures by file content.
             \return Returns the loaded scene data.
         */
-        static Scene::SceneData readCache(ref<Device> pDevice, const Key& key);
+        static Scene::SceneData readCache(ref<Device> pDevice, const std::filesystem::path& path, const std::filesystem::path& textureCacheDirectory = {}, bool deduplicateTextures = true);
 
     private:
         class OutputStream;
         class InputStream;
+        class ChunkWriter;
+        class ChunkReader;
 
         static std::filesystem::path getCachePath(const Key& key);
 
-        static void writeSceneData(OutputStream& stream, const Scene::SceneData& sceneData);
-        static Scene::SceneData readSceneData(InputStream& stream, ref<Device> pDevice);
+        static void writeSceneData(ChunkWriter& writer, const Scene::SceneData& sceneData);
+        static Scene::SceneData readSceneData(ChunkReader& reader, ref<Device> pDevice, const std::filesystem::path& textureCacheDirectory, bool deduplicateTextures);
+
+        static void writeMeshes(OutputStream& stream, const Scene::SceneData& sceneData);
+        static void readMeshes(InputStream& stream, Scene::SceneData& sceneData);
+
+        static void writeCurves(OutputStream& stream, const Scene::SceneData& sceneData);
+        static void readCurves(InputStream& stream, Scene::SceneData& sceneData);
 
         static void writeMetadata(OutputStream& stream, const Scene::Metadata& metadata);
         static Scene::Metadata readMetadata(InputStream& stream);
@@ -125,8 +161,8 @@ namespace Falcor
         static void readMarker(InputStream& stream, const std::string& id);
 
         template<typename T, bool TUseByteAddressBuffer>
-        static void writeSplitBuffer(OutputStream& stream, const SplitBuffer<T, TUseByteAddressBuffer>& buffer);
+        static void writeSplitBufferInfo(OutputStream& stream, const SplitBuffer<T, TUseByteAddressBuffer>& buffer);
         template<typename T, bool TUseByteAddressBuffer>
-        static void readSplitBuffer(InputStream& stream, SplitBuffer<T, TUseByteAddressBuffer>& buffer);
+        static void readSplitBufferInfo(InputStream& stream, SplitBuffer<T, TUseByteAddressBuffer>& buffer);
     };
 }
@@ -0,0 +1,405 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TangentGenerator.h"
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+#include "Utils/Math/Common.h"
+#include "Utils/NumericRange.h"
+#include <mikktspace.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <execution>
+#include <limits>
+#include <numeric>
+#include <unordered_set>
+
+namespace Falcor
+{
+    namespace
+    {
+        // Chunks are abandoned if their extended face set grows beyond this fraction of the mesh.
+        const uint32_t kMaxChunkFaceFraction = 4;
+
+        /** Face-vertex attributes of a list of faces, in the layout consumed by MikkTSpaceWrapper.
+        */
+        struct CornerData
+        {
+            std::vector<float3> positions;
+            std::vector<float3> normals;
+            std::vector<float2> texCrds;
+
+            explicit CornerData(size_t faceCount)
+                : positions(faceCount * 3)
+                , normals(faceCount * 3)
+                , texCrds(faceCount * 3)
+            {}
+
+            void setFace(const SceneBuilder::Mesh& mesh, uint32_t srcFace, uint32_t dstFace)
+            {
+                for (uint32_t vert = 0; vert < 3; vert++)
+                {
+                    positions[dstFace * 3 + vert] = mesh.getPosition(srcFace, vert);
+                    normals[dstFace * 3 + vert] = mesh.getNormal(srcFace, vert);
+                    texCrds[dstFace * 3 + vert] = mesh.getTexCrd(srcFace, vert);
+                }
+            }
+        };
+
+        class MikkTSpaceWrapper
+        {
+        public:
+            /** Run MikkTSpace on all faces of 'data'.
+                \param[in] data Face-vertex attributes.
+                \param[out] pTangents Tangent per face-vertex.
+                \return True if successful.
+            */
+            static bool generateTangents(const CornerData& data, float4* pTangents)
+            {
+                SMikkTSpaceInterface mikktspace = {};
+                mikktspace.m_getNumFaces = [](const SMikkTSpaceContext* pContext) { return ((MikkTSpaceWrapper*)(pContext->m_pUserData))->getFaceCount(); };
+                mikktspace.m_getNumVerticesOfFace = [](const SMikkTSpaceContext* pContext, int32_t face) { return 3; };
+                mikktspace.m_getPosition = [](const SMikkTSpaceContext* pContext, float position[], int32_t face, int32_t vert) { ((MikkTSpaceWrapper*)(pContext->m_pUserData))->getPosition(position, face, vert); };
+                mikktspace.m_getNormal = [](const SMikkTSpaceContext* pContext, float normal[], int32_t face, int32_t vert) { ((MikkTSpaceWrapper*)(pContext->m_pUserData))->getNormal(normal, face, vert); };
+                mikktspace.m_getTexCoord = [](const SMikkTSpaceContext* pContext, float texCrd[], int32_t face, int32_t vert) { ((MikkTSpaceWrapper*)(pContext->m_pUserData))->getTexCrd(texCrd, face, vert); };
+                mikktspace.m_setTSpaceBasic = [](const SMikkTSpaceContext* pContext, const float tangent[], float sign, int32_t face, int32_t vert) { ((MikkTSpaceWrapper*)(pContext->m_pUserData))->setTangent(tangent, sign, face, vert); };
+
+                MikkTSpaceWrapper wrapper(data, pTangents);
+                SMikkTSpaceContext context = {};
+                context.m_pInterface = &mikktspace;
+                context.m_pUserData = &wrapper;
+
+                return genTangSpaceDefault(&context) != 0;
+            }
+
+        private:
+            MikkTSpaceWrapper(const CornerData& data, float4* pTangents)
+                : mData(data)
+                , mpTangents(pTangents)
+            {}
+
+            const CornerData& mData;
+            float4* mpTangents;
+
+            int32_t getFaceCount() const { return (int32_t)(mData.positions.size() / 3); }
+            void getPosition(float position[], int32_t face, int32_t vert) const { *reinterpret_cast<float3*>(position) = mData.positions[face * 3 + vert]; }
+            void getNormal(float normal[], int32_t face, int32_t vert) const { *reinterpret_cast<float3*>(normal) = mData.normals[face * 3 + vert]; }
+            void getTexCrd(float texCrd[], int32_t face, int32_t vert) const { *reinterpret_cast<float2*>(texCrd) = mData.texCrds[face * 3 + vert]; }
+
+            void setTangent(const float tangent[], float sign, int32_t face, int32_t vert)
+            {
+                float3 T = *reinterpret_cast<const float3*>(tangent);
+                mpTangents[face * 3 + vert] = float4(normalize(T), sign);
+            }
+        };
+
+        bool hasRequiredAttributes(const SceneBuilder::Mesh& mesh)
+        {
+            if (!mesh.normals.pData || !mesh.positions.pData || !mesh.texCrds.pData || !mesh.pIndices)
+            {
+                logWarning("Can't generate tangent space. The mesh '{}' doesn't have positions/normals/texCrd/indices.", mesh.name);
+                return false;
+            }
+            FALCOR_ASSERT(mesh.indexCount > 0);
+            FALCOR_ASSERT_EQ(mesh.indexCount, mesh.faceCount * 3);
+            return true;
+        }
+
+        /** Returns true if MikkTSpace may flag the triangle as having no usable texture derivatives (GROUP_WITH_ANY).
+            The orientation of such triangles is decided by the first vertex group that reaches them,
+            which is the only dependency of MikkTSpace on faces outside of the immediate vertex neighborhoods.
+            The test is conservative, it accepts all triangles within a generous margin of MikkTSpace's own threshold.
+        */
+        bool mayHaveZeroTexArea(const float3 p[3], const float2 t[3])
+        {
+            const float2 t21 = t[1] - t[0];
+            const float2 t31 = t[2] - t[0];
+            const float3 d1 = p[1] - p[0];
+            const float3 d2 = p[2] - p[0];
+
+            // The margins cover rounding differences, MikkTSpace itself compares against FLT_MIN.
+            const double kRelEps = 1e-4;
+            const double area = std::abs(double(t21.x) * t31.y - double(t21.y) * t31.x);
+            const double areaScale = std::abs(double(t21.x) * t31.y) + std::abs(double(t21.y) * t31.x);
+            if (!(area > kRelEps * areaScale + FLT_MIN)) return true;
+
+            auto lengthOf = [](const float3& a, float sa, const float3& b, float sb, double& scale)
+            {
+                double len2 = 0.0;
+                scale = 0.0;
+                for (int i = 0; i < 3; i++)
+                {
+                    const double v = double(sa) * a[i] - double(sb) * b[i];
+                    len2 += v * v;
+                    scale += std::abs(double(sa) * a[i]) + std::abs(double(sb) * b[i]);
+                }
+                return std::sqrt(len2);
+            };
+            double scaleS, scaleT;
+            const double lenS = lengthOf(d1, t31.y, d2, t21.y, scaleS);
+            const double lenT = lengthOf(d2, t21.x, d1, t31.x, scaleT);
+            if (!(lenS > kRelEps * scaleS + FLT_MIN * (1.0 + area))) return true;
+            if (!(lenT > kRelEps * scaleT + FLT_MIN * (1.0 + area))) return true;
+            return false;
+        }
+
+        uint32_t expandBits(uint32_t v)
+        {
+            v = (v * 0x00010001u) & 0xFF0000FFu;
+            v = (v * 0x00000101u) & 0x0F00F00Fu;
+            v = (v * 0x00000011u) & 0xC30C30C3u;
+            v = (v * 0x00000005u) & 0x49249249u;
+            return v;
+        }
+
+        /** Returns the 30-bit Morton code of a point in the unit cube.
+        */
+        uint32_t mortonCode(float3 p)
+        {
+            uint32_t code = 0;
+            for (int i = 0; i < 3; i++)
+            {
+                const float x = std::isfinite(p[i]) ? std::clamp(p[i] * 1024.f, 0.f, 1023.f) : 0.f;
+                code |= expandBits((uint32_t)x) << (2 - i);
+            }
+            return code;
+        }
+
+        template<typename Func>
+        void forEach(bool parallel, uint32_t count, Func func)
+        {
+            NumericRange<uint32_t> range(0, count);
+            if (parallel)
+                std::for_each(std::execution::par, range.begin(), range.end(), func);
+            else
+                std::for_each(range.begin(), range.end(), func);
+        }
+    }
+
+    std::vector<float4> TangentGenerator::generate(const SceneBuilder::Mesh& mesh)
+    {
+        if (!hasRequiredAttributes(mesh)) return {};
+
+        CornerData data(mesh.faceCount);
+        for (uint32_t face = 0; face < mesh.faceCount; face++) data.setFace(mesh, face, face);
+
+        std::vector<float4> tangents(mesh.indexCount, float4(0));
+        if (!MikkTSpaceWrapper::generateTangents(data, tangents.data()))
+        {
+            FALCOR_THROW("MikkTSpace failed to generate tangents for the mesh '{}'.", mesh.name);
+        }
+
+        return tangents;
+    }
+
+    std::vector<float4> TangentGenerator::generateChunked(const SceneBuilder::Mesh& mesh, bool parallel, uint32_t chunkFaceCount)
+    {
+        // MikkTSpace computes the tangent of a face-vertex from the group of faces around the vertex that it is welded
+        // into. Welding compares positions exactly, so these faces all share the vertex position. Faces are paired
+        // across edges and assigned to groups in face order, and the orientation of triangles without texture
+        // derivatives is taken from the first group reaching them. Therefore, running MikkTSpace on a subset of the
+        // faces, in their original order, gives the same tangents for a face if the subset contains all faces sharing
+        // a position with it, and recursively all faces around the positions of such triangles without derivatives.
+        //
+        // We sort the faces along a Morton curve and cut them into chunks. Each chunk is extended to the face set
+        // described above, MikkTSpace is run on it, and the tangents of the chunk's own faces are kept.
+
+        if (!hasRequiredAttributes(mesh)) return {};
+        FALCOR_CHECK(chunkFaceCount > 0, "'chunkFaceCount' must be greater than zero.");
+
+        const uint32_t faceCount = mesh.faceCount;
+        const uint32_t cornerCount = mesh.indexCount;
+        const uint32_t chunkCount = div_round_up(faceCount, chunkFaceCount);
+        if (chunkCount < 2) return generate(mesh);
+
+        // Fetch positions and find the faces without reliable texture derivatives.
+        std::vector<float3> positions(cornerCount);
+        std::vector<uint8_t> isZeroTexArea(faceCount);
+        forEach(parallel, faceCount, [&](uint32_t face)
+        {
+            float3 p[3];
+            float2 t[3];
+            for (uint32_t vert = 0; vert < 3; vert++)
+            {
+                p[vert] = positions[face * 3 + vert] = mesh.getPosition(face, vert);
+                t[vert] = mesh.getTexCrd(face, vert);
+            }
+            isZeroTexArea[face] = mayHaveZeroTexArea(p, t) ? 1 : 0;
+        });
+
+        // Number the unique positions. Negative zero is mapped to positive zero as they compare equal.
+        std::vector<std::array<uint32_t, 3>> positionKeys(cornerCount);
+        forEach(parallel, cornerCount, [&](uint32_t corner)
+        {
+            for (int i = 0; i < 3; i++) positionKeys[corner][i] = math::asuint(positions[corner][i] + 0.f);
+        });
+
+        std::vector<uint32_t> sortedCorners(cornerCount);
+        std::iota(sortedCorners.begin(), sortedCorners.end(), 0u);
+        auto compareKeys = [&](uint32_t a, uint32_t b) { return positionKeys[a] < positionKeys[b]; };
+        if (parallel)
+            std::sort(std::execution::par, sortedCorners.begin(), sortedCorners.end(), compareKeys);
+        else
+            std::sort(sortedCorners.begin(), sortedCorners.end(), compareKeys);
+
+        std::vector<uint32_t> cornerPositions(cornerCount);
+        uint32_t positionCount = 0;
+        for (uint32_t i = 0; i < cornerCount; i++)
+        {
+            if (i > 0 && positionKeys[sortedCorners[i]] != positionKeys[sortedCorners[i - 1]]) positionCount++;
+            cornerPositions[sortedCorners[i]] = positionCount;
+        }
+        positionCount++;
+        positionKeys = {};
+
+        // Build the list of faces around each position, in increasing face order.
+        std::vector<uint32_t> positionFaceOffsets(positionCount + 1, 0);
+        for (uint32_t corner = 0; corner < cornerCount; corner++) positionFaceOffsets[cornerPositions[corner] + 1]++;
+        for (uint32_t i = 0; i < positionCount; i++) positionFaceOffsets[i + 1] += positionFaceOffsets[i];
+        std::vector<uint32_t> positionFaces(cornerCount);
+        {
+            std::vector<uint32_t> insertPos(positionFaceOffsets.begin(), positionFaceOffsets.end() - 1);
+            for (uint32_t corner = 0; corner < cornerCount; corner++) positionFaces[insertPos[cornerPositions[corner]]++] = corner / 3;
+        }
+
+        // Sort the faces by the Morton code of their centroid and assign them to chunks.
+        float3 minPos(std::numeric_limits<float>::max());
+        float3 maxPos(-std::numeric_limits<float>::max());
+        for (const float3& p : positions)
+        {
+            if (!all(isfinite(p))) continue;
+            minPos = min(minPos, p);
+            maxPos = max(maxPos, p);
+        }
+        // Use the same scale on all axes, so that flat meshes are not split along their thin axis.
+        const float3 extent = maxPos - minPos;
+        const float scale = std::max(std::max(extent.x, extent.y), std::max(extent.z, FLT_MIN));
+
+        std::vector<uint64_t> faceKeys(faceCount);
+        forEach(parallel, faceCount, [&](uint32_t face)
+        {
+            const float3 centroid = (positions[face * 3] + positions[face * 3 + 1] + positions[face * 3 + 2]) / 3.f;
+            faceKeys[face] = (uint64_t(mortonCode((centroid - minPos) / scale)) << 32) | face;
+        });
+        if (parallel)
+            std::sort(std::execution::par, faceKeys.begin(), faceKeys.end());
+        else
+            std::sort(faceKeys.begin(), faceKeys.end());
+
+        std::vector<uint32_t> chunkFaces(faceCount);
+        std::vector<uint32_t> faceChunks(faceCount);
+        for (uint32_t i = 0; i < faceCount; i++)
+        {
+            chunkFaces[i] = (uint32_t)faceKeys[i];
+            faceChunks[chunkFaces[i]] = i / chunkFaceCount;
+        }
+        faceKeys = {};
+
+        // Process the chunks.
+        std::vector<float4> tangents(cornerCount, float4(0));
+        std::atomic<bool> fallback = false;
+        const size_t maxChunkFaces = std::max<size_t>(faceCount / kMaxChunkFaceFraction, chunkFaceCount);
+
+        forEach(parallel, chunkCount, [&](uint32_t chunk)
+        {
+            if (fallback) return;
+
+            // Gather the faces around the positions of the chunk.
+            std::vector<uint32_t> faces;
+            std::vector<uint32_t> pendingPositions;
+            std::unordered_set<uint32_t> visitedPositions;
+            auto visitFace = [&](uint32_t face)
+            {
+                for (uint32_t vert = 0; vert < 3; vert++)
+                {
+                    uint32_t position = cornerPositions[face * 3 + vert];
+                    if (visitedPositions.insert(position).second) pendingPositions.push_back(position);
+                }
+            };
+
+            const uint32_t chunkBegin = chunk * chunkFaceCount;
+            const uint32_t chunkEnd = std::min(chunkBegin + chunkFaceCount, faceCount);
+            for (uint32_t i = chunkBegin; i < chunkEnd; i++) visitFace(chunkFaces[i]);
+
+            while (!pendingPositions.empty())
+            {
+                const uint32_t position = pendingPositions.back();
+                pendingPositions.pop_back();
+                for (uint32_t i = positionFaceOffsets[position]; i < positionFaceOffsets[position + 1]; i++)
+                {
+                    const uint32_t face = positionFaces[i];
+                    faces.push_back(face);
+                    if (isZeroTexArea[face]) visitFace(face);
+                }
+
+                // Give up if the neighborhoods are not local, e.g., if most of the mesh has no texture derivatives.
+                if (faces.size() > 3 * maxChunkFaces || fallback)
+                {
+                    fallback = true;
+                    return;
+                }
+            }
+
+            std::sort(faces.begin(), faces.end());
+            faces.erase(std::unique(faces.begin(), faces.end()), faces.end());
+            if (faces.size() > maxChunkFaces)
+            {
+                fallback = true;
+                return;
+            }
+
+            // Run MikkTSpace on the faces in their original order and keep the tangents of the chunk's faces.
+            CornerData data(faces.size());
+            for (uint32_t i = 0; i < (uint32_t)faces.size(); i++) data.setFace(mesh, faces[i], i);
+
+            std::vector<float4> chunkTangents(faces.size() * 3, float4(0));
+            if (!MikkTSpaceWrapper::generateTangents(data, chunkTangents.data()))
+            {
+                fallback = true;
+                return;
+            }
+
+            for (uint32_t i = 0; i < (uint32_t)faces.size(); i++)
+            {
+                const uint32_t face = faces[i];
+                if (faceChunks[face] != chunk) continue;
+                for (uint32_t vert = 0; vert < 3; vert++) tangents[face * 3 + vert] = chunkTangents[i * 3 + vert];
+            }
+        });
+
+        if (fallback)
+        {
+            logDebug("Tangents for the mesh '{}' can't be generated in chunks, falling back to a single pass.", mesh.name);
+            return generate(mesh);
+        }
+
+        return tangents;
+    }
+}
@@ -0,0 +1,71 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "SceneBuilder.h"
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+    /** Utility functions for generating MikkTSpace tangents for a SceneBuilder::Mesh.
+
+        The tangents are stored per face-vertex (face * 3 + vert) with the bitangent sign in the w component.
+        MikkTSpace can produce NaN tangents for degenerate triangles, these are returned as is.
+    */
+    class FALCOR_API TangentGenerator
+    {
+    public:
+        /// Default number of faces per chunk for generateChunked().
+        static constexpr uint32_t kDefaultChunkFaceCount = 1u << 15;
+
+        /** Generate tangents by running MikkTSpace on the whole mesh.
+            This is the reference implementation. It is single-threaded.
+            The vendored MikkTSpace fixes an edge pairing bug of upstream, see external/mikktspace/README.md.
+            Throws an exception if MikkTSpace fails.
+            \param[in] mesh Mesh description.
+            \return Tangent per face-vertex, or an empty vector if the mesh is missing positions, normals, texture coordinates or indices.
+        */
+        static std::vector<float4> generate(const SceneBuilder::Mesh& mesh);
+
+        /** Generate tangents by splitting the mesh into spatially coherent chunks of faces that are processed concurrently.
+            Each chunk is extended with the faces sharing a vertex position with it (and with the faces around any
+            triangle with zero texture area in that set), so that MikkTSpace sees the complete vertex neighborhoods
+            of the chunk's faces in the original face order. The result is identical to generate(),
+            up to the sign of zero tangent components.
+            Meshes with fewer than two chunks, or where the neighborhoods do not stay local, are processed by generate().
+            Throws an exception if MikkTSpace fails.
+            \param[in] mesh Mesh description.
+            \param[in] parallel Process the chunks on multiple threads.
+            \param[in] chunkFaceCount Number of faces per chunk.
+            \return Tangent per face-vertex, or an empty vector if the mesh is missing positions, normals, texture coordinates or indices.
+        */
+        static std::vector<float4> generateChunked(const SceneBuilder::Mesh& mesh, bool parallel = true, uint32_t chunkFaceCount = kDefaultChunkFaceCount);
+    };
+}
@@ -30,6 +30,7 @@
 #include "Core/Error.h"
 #include "Core/Platform/OS.h"
 #include "Utils/Logger.h"
+#include "Utils/Math/BatchMath.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -43,16 +44,16 @@ namespace Falcor
         return ref<TriangleMesh>(new TriangleMesh());
     }
 
-    ref<TriangleMesh> TriangleMesh::create(const VertexList& vertices, const IndexList& indices, bool frontFaceCW)
+    ref<TriangleMesh> TriangleMesh::create(VertexList vertices, IndexList indices, bool frontFaceCW)
     {
-        return ref<TriangleMesh>(new TriangleMesh(vertices, indices, frontFaceCW));
+        return ref<TriangleMesh>(new TriangleMesh(std::move(vertices), std::move(indices), frontFaceCW));
     }
 
     ref<TriangleMesh> TriangleMesh::createDummy()
     {
         VertexList vertices = {{{0.f, 0.f, 0.f}, {0.f, 1.f, 0.f}, {0.f, 0.f}}};
         IndexList indices = {0, 0, 0};
-        return create(vertices, indices);
+        return create(std::move(vertices), std::move(indices));
     }
 
     ref<TriangleMesh> TriangleMesh::createQuad(float2 size)
@@ -73,7 +74,7 @@ namespace Falcor
             1, 2, 3,
         };
 
-        return create(vertices, indices, frontFaceCW);
+        return create(std::move(vertices), std::move(indices), frontFaceCW);
     }
 
     ref<TriangleMesh> TriangleMesh::createDisk(float radius, uint32_t segments)
@@ -96,7 +97,7 @@ namespace Falcor
             indices[i * 3 + 2] = ((i + 1) % segments) + 1;
         }
 
-        return create(vertices, indices, false);
+        return create(std::move(vertices), std::move(indices), false);
     }
 
     ref<TriangleMesh> TriangleMesh::createCube(float3 size)
@@ -145,7 +146,7 @@ namespace Falcor
             }
         }
 
-        return create(vertices, indices, frontFaceCW);
+        return create(std::move(vertices), std::move(indices), frontFaceCW);
     }
 
     ref<TriangleMesh> TriangleMesh::createSphere(float radius, uint32_t segmentsU, uint32_t segmentsV)
@@ -190,7 +191,7 @@ namespace Falcor
             }
         }
 
-        return create(vertices, indices);
+        return create(std::move(vertices), std::move(indices));
     }
 
     ref<TriangleMesh> TriangleMesh::createFromFile(const std::filesystem::path& path, ImportFlags importFlags)
@@ -270,7 +271,7 @@ namespace Falcor
             }
         }
 
-        return create(vertices, indices);
+        return create(std::move(vertices), std::move(indices));
     }
 
     ref<TriangleMesh> TriangleMesh::createFromFile(const std::filesystem::path& path, bool smoothNormals)
@@ -302,11 +303,9 @@ namespace Falcor
     {
         auto invTranspose = float3x3(transpose(inverse(transform)));
 
-        for (auto& vertex : mVertices)
-        {
-            vertex.position = transformPoint(transform, vertex.position);
-            vertex.normal = normalize(transformVector(invTranspose, vertex.normal));
-        }
+        const size_t stride = sizeof(Vertex);
+        math::transformPoints(transform, &mVertices.data()->position, &mVertices.data()->position, mVertices.size(), stride, stride);
+        math::transformNormals(invTranspose, &mVertices.data()->normal, &mVertices.data()->normal, mVertices.size(), stride, stride);
 
         // Check if triangle winding has flipped and adjust winding order accordingly.
         bool flippedWinding = determinant(float3x3(transform)) < 0.f;
@@ -316,9 +315,9 @@ namespace Falcor
     TriangleMesh::TriangleMesh()
     {}
 
-    TriangleMesh::TriangleMesh(const VertexList& vertices, const IndexList& indices, bool frontFaceCW)
-        : mVertices(vertices)
-        , mIndices(indices)
+    TriangleMesh::TriangleMesh(VertexList vertices, IndexList indices, bool frontFaceCW)
+        : mVertices(std::move(vertices))
+        , mIndices(std::move(indices))
         , mFrontFaceCW(frontFaceCW)
     {}
 
@@ -76,7 +76,7 @@ namespace Falcor
             \param[in] frontFaceCW Triangle winding.
             \return Returns the triangle mesh.
         */
-        static ref<TriangleMesh> create(const VertexList& vertices, const IndexList& indices, bool frontFaceCW = false);
+        static ref<TriangleMesh> create(VertexList vertices, IndexList indices, bool frontFaceCW = false);
 
         /** Creates a dummy mesh (single degenerate triangle).
             \return Returns the triangle mesh.
@@ -188,7 +188,7 @@ namespace Falcor
 
     private:
         TriangleMesh();
-        TriangleMesh(const VertexList& vertices, const IndexList& indices, bool frontFaceCW);
+        TriangleMesh(VertexList vertices, IndexList indices, bool frontFaceCW);
 
         std::string mName;
         std::vector<Vertex> mVertices;
@@ -0,0 +1,297 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "VertexDeduplication.h"
+#include "Core/Error.h"
+#include "Utils/Math/FNVHash.h"
+#include "Utils/Math/Common.h"
+#include "Utils/NumericRange.h"
+#include "Utils/Threading.h"
+#include <algorithm>
+#include <cstring>
+#include <execution>
+#include <limits>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kInvalidIndex = 0xffffffff;
+
+        // Meshes with fewer face-vertices than this are processed as a single partition.
+        const uint32_t kMinCornersPerPartition = 1u << 14;
+
+        /** Key of all vertex attributes that are compared exactly by compareVertices().
+            Floats are stored as their bit patterns with negative zero mapped to positive zero,
+            so that keys are equal whenever the attributes compare equal.
+        */
+        struct VertexKey
+        {
+            uint32_t origIndex;
+            uint32_t position[3];
+            uint32_t tangentSign;
+            uint32_t curveRadius;
+            uint32_t boneIDs[4];
+
+            bool operator==(const VertexKey& other) const { return std::memcmp(this, &other, sizeof(VertexKey)) == 0; }
+        };
+        static_assert(sizeof(VertexKey) == 10 * sizeof(uint32_t));
+
+        uint32_t canonicalBits(float f)
+        {
+            return math::asuint(f + 0.f); // Maps -0 to +0.
+        }
+
+        VertexKey makeKey(uint32_t origIndex, const SceneBuilder::Mesh::Vertex& v)
+        {
+            VertexKey key;
+            key.origIndex = origIndex;
+            for (int i = 0; i < 3; i++) key.position[i] = canonicalBits(v.position[i]);
+            key.tangentSign = canonicalBits(v.tangent.w);
+            key.curveRadius = canonicalBits(v.curveRadius);
+            for (int i = 0; i < 4; i++) key.boneIDs[i] = v.boneIDs[i];
+            return key;
+        }
+
+        uint64_t hashKey(const VertexKey& key)
+        {
+            FNVHash64 hash;
+            hash.insert(key);
+            return hash.get();
+        }
+
+        /** Deduplicates the face-vertices of one partition.
+            The partition holds all corners referencing a range of original vertex indices, in increasing corner order.
+            For each corner, the corner of the first occurrence of its vertex is written to 'firstCorner'.
+        */
+        void mergePartition(const SceneBuilder::Mesh& mesh, const uint32_t* corners, uint32_t cornerCount, uint32_t* firstCorner)
+        {
+            if (cornerCount == 0) return;
+
+            // Open-addressing hash table mapping a key to the most recently added unique vertex with that key.
+            struct Slot
+            {
+                uint64_t hash;
+                uint32_t head;
+            };
+            size_t tableSize = 16;
+            while (tableSize < size_t(cornerCount) * 2) tableSize *= 2;
+            const size_t mask = tableSize - 1;
+            std::vector<Slot> table(tableSize, Slot{ 0, kInvalidIndex });
+
+            // Unique vertices of this partition. Each vertex links to the previous unique vertex with the same key.
+            std::vector<SceneBuilder::Mesh::Vertex> uniqueVertices;
+            std::vector<uint32_t> uniqueOrigIndex;
+            std::vector<uint32_t> uniqueCorner;
+            std::vector<uint32_t> uniqueNext;
+
+            for (uint32_t i = 0; i < cornerCount; i++)
+            {
+                const uint32_t corner = corners[i];
+                const uint32_t origIndex = mesh.pIndices[corner];
+                const SceneBuilder::Mesh::Vertex v = mesh.getVertex(corner / 3, corner % 3);
+                const VertexKey key = makeKey(origIndex, v);
+                const uint64_t hash = hashKey(key);
+
+                // Find the slot for this key.
+                size_t slot = hash & mask;
+                while (table[slot].head != kInvalidIndex)
+                {
+                    const uint32_t head = table[slot].head;
+                    if (table[slot].hash == hash && makeKey(uniqueOrigIndex[head], uniqueVertices[head]) == key) break;
+                    slot = (slot + 1) & mask;
+                }
+
+                // Search the vertices with the same key, starting with the most recently added.
+                // Vertices with a different key can never compare equal, so this visits the matching candidates
+                // in the same order as the linked list search in mergeLinkedList().
+                uint32_t index = table[slot].head;
+                while (index != kInvalidIndex)
+                {
+                    if (VertexDeduplication::compareVertices(v, uniqueVertices[index])) break;
+                    index = uniqueNext[index];
+                }
+
+                if (index == kInvalidIndex)
+                {
+                    index = (uint32_t)uniqueVertices.size();
+                    uniqueVertices.push_back(v);
+                    uniqueOrigIndex.push_back(origIndex);
+                    uniqueCorner.push_back(corner);
+                    uniqueNext.push_back(table[slot].head);
+                    table[slot] = Slot{ hash, index };
+                }
+
+                firstCorner[corner] = uniqueCorner[index];
+            }
+        }
+    }
+
+    bool VertexDeduplication::compareVertices(const SceneBuilder::Mesh::Vertex& lhs, const SceneBuilder::Mesh::Vertex& rhs, float threshold)
+    {
+        if (any(lhs.position != rhs.position)) return false; // Position need to be exact to avoid cracks
+        if (lhs.tangent.w != rhs.tangent.w) return false;
+        if (lhs.curveRadius != rhs.curveRadius) return false;
+        if (any(lhs.boneIDs != rhs.boneIDs)) return false;
+        if (any(abs(lhs.normal - rhs.normal) > float3(threshold))) return false;
+        if (any(abs(lhs.tangent.xyz() - rhs.tangent.xyz()) > float3(threshold))) return false;
+        if (any(abs(lhs.texCrd - rhs.texCrd) > float2(threshold))) return false;
+        if (any(abs(lhs.boneWeights - rhs.boneWeights) > float4(threshold))) return false;
+        return true;
+    }
+
+    VertexDeduplication::Result VertexDeduplication::mergeLinkedList(const SceneBuilder::Mesh& mesh)
+    {
+        // A linked-list of vertices is built for each original vertex index.
+        // We iterate over all vertices and first check if a vertex is identical to any of the other vertices
+        // using the same original vertex index. If not, a new vertex is inserted and added to the list.
+        // The 'heads' array point to the first vertex in each list, and each vertex has an associated next-pointer.
+        // This ensures that adding to the linked lists do not require any dynamic memory allocation.
+
+        Result result;
+        result.indices.resize(mesh.indexCount);
+        result.uniqueCorners.reserve(mesh.vertexCount);
+
+        std::vector<std::pair<SceneBuilder::Mesh::Vertex, uint32_t>> vertices;
+        vertices.reserve(mesh.vertexCount);
+
+        std::vector<uint32_t> heads(mesh.vertexCount, kInvalidIndex);
+
+        for (uint32_t face = 0; face < mesh.faceCount; face++)
+        {
+            for (uint32_t vert = 0; vert < 3; vert++)
+            {
+                const SceneBuilder::Mesh::Vertex v = mesh.getVertex(face, vert);
+                const uint32_t origIndex = mesh.pIndices[face * 3 + vert];
+
+                // Iterate over vertex list to check if it already exists.
+                FALCOR_ASSERT(origIndex < heads.size());
+                uint32_t index = heads[origIndex];
+                bool found = false;
+
+                while (index != kInvalidIndex)
+                {
+                    if (compareVertices(v, vertices[index].first))
+                    {
+                        found = true;
+                        break;
+                    }
+                    index = vertices[index].second;
+                }
+
+                // Insert new vertex if we couldn't find it.
+                if (!found)
+                {
+                    FALCOR_ASSERT(vertices.size() < std::numeric_limits<uint32_t>::max());
+                    index = (uint32_t)vertices.size();
+                    vertices.push_back({ v, heads[origIndex] });
+                    result.uniqueCorners.push_back(face * 3 + vert);
+                    heads[origIndex] = index;
+                }
+
+                // Store new vertex index.
+                result.indices[face * 3 + vert] = index;
+            }
+        }
+
+        return result;
+    }
+
+    VertexDeduplication::Result VertexDeduplication::mergeHashed(const SceneBuilder::Mesh& mesh, bool parallel)
+    {
+        // Corners can only be merged if they reference the same original vertex index.
+        // We partition the corners by ranges of original vertex indices, keeping them in increasing order
+        // within each partition. Each partition is then deduplicated independently using a hash table.
+        // Finally, the unique vertices are numbered in order of their first occurrence, which matches
+        // the numbering of the sequential linked list search.
+
+        FALCOR_ASSERT(mesh.indexCount == mesh.faceCount * 3);
+        const uint32_t cornerCount = mesh.indexCount;
+
+        uint32_t partitionCount = 1;
+        if (parallel)
+        {
+            const uint32_t maxPartitions = 4 * std::max(1u, Threading::getLogicalThreadCount());
+            partitionCount = std::clamp(cornerCount / kMinCornersPerPartition, 1u, maxPartitions);
+        }
+        auto getPartition = [&](uint32_t origIndex)
+        {
+            FALCOR_ASSERT(origIndex < mesh.vertexCount);
+            return (uint32_t)((uint64_t)origIndex * partitionCount / mesh.vertexCount);
+        };
+
+        // Sort the corners by partition using a counting sort. This preserves the corner order within each partition.
+        std::vector<uint32_t> partitionOffsets(partitionCount + 1, 0);
+        for (uint32_t corner = 0; corner < cornerCount; corner++) partitionOffsets[getPartition(mesh.pIndices[corner]) + 1]++;
+        for (uint32_t p = 0; p < partitionCount; p++) partitionOffsets[p + 1] += partitionOffsets[p];
+
+        std::vector<uint32_t> sortedCorners(cornerCount);
+        {
+            std::vector<uint32_t> insertPos(partitionOffsets.begin(), partitionOffsets.end() - 1);
+            for (uint32_t corner = 0; corner < cornerCount; corner++) sortedCorners[insertPos[getPartition(mesh.pIndices[corner])]++] = corner;
+        }
+
+        // Find the first corner of the matching vertex for all corners.
+        std::vector<uint32_t> firstCorner(cornerCount, kInvalidIndex);
+        auto processPartition = [&](uint32_t p)
+        {
+            const uint32_t offset = partitionOffsets[p];
+            mergePartition(mesh, sortedCorners.data() + offset, partitionOffsets[p + 1] - offset, firstCorner.data());
+        };
+
+        if (partitionCount > 1)
+        {
+            NumericRange<uint32_t> range(0, partitionCount);
+            std::for_each(std::execution::par, range.begin(), range.end(), processPartition);
+        }
+        else
+        {
+            processPartition(0);
+        }
+
+        // Number the unique vertices in order of first occurrence.
+        // A corner is the first occurrence of its vertex if it maps to itself. All other corners map to an earlier corner.
+        Result result;
+        result.indices.resize(cornerCount);
+        for (uint32_t corner = 0; corner < cornerCount; corner++)
+        {
+            const uint32_t first = firstCorner[corner];
+            FALCOR_ASSERT(first <= corner);
+            if (first == corner)
+            {
+                result.indices[corner] = (uint32_t)result.uniqueCorners.size();
+                result.uniqueCorners.push_back(corner);
+            }
+            else
+            {
+                result.indices[corner] = result.indices[first];
+            }
+        }
+
+        return result;
+    }
+}
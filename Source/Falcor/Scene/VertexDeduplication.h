@@ -0,0 +1,73 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "SceneBuilder.h"
+#include "Core/Macros.h"
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+    /** Utility functions for merging duplicate vertices of a SceneBuilder::Mesh.
+
+        Two face-vertices (corners) are merged if they reference the same original vertex index
+        and their attributes are identical. Positions, tangent sign, curve radius and bone IDs must match exactly,
+        while normals, tangents, texture coordinates and bone weights are compared with a small threshold.
+
+        Vertices are numbered in order of their first occurrence in the index buffer.
+    */
+    class FALCOR_API VertexDeduplication
+    {
+    public:
+        struct Result
+        {
+            std::vector<uint32_t> indices;          ///< New vertex index for each face-vertex (face * 3 + vert).
+            std::vector<uint32_t> uniqueCorners;    ///< Face-vertex index of the first occurrence of each new vertex.
+        };
+
+        /** Merge duplicate vertices by searching a linked list of vertices per original vertex index.
+            This is the reference implementation. It is single-threaded and stores a full copy of each unique vertex.
+            \param[in] mesh Mesh description.
+            \return Vertex indices and the corner index of each unique vertex.
+        */
+        static Result mergeLinkedList(const SceneBuilder::Mesh& mesh);
+
+        /** Merge duplicate vertices using open-addressing hash tables keyed on the exactly compared vertex attributes.
+            The face-vertices are partitioned by original vertex index, and the partitions are processed concurrently.
+            The result is identical to mergeLinkedList().
+            \param[in] mesh Mesh description.
+            \param[in] parallel Process the partitions on multiple threads.
+            \return Vertex indices and the corner index of each unique vertex.
+        */
+        static Result mergeHashed(const SceneBuilder::Mesh& mesh, bool parallel = true);
+
+        /** Compare two vertices using the merge criteria described above.
+        */
+        static bool compareVertices(const SceneBuilder::Mesh::Vertex& lhs, const SceneBuilder::Mesh::Vertex& rhs, float threshold = 1e-6f);
+    };
+}
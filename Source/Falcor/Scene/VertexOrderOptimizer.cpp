@@ -0,0 +1,290 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "VertexOrderOptimizer.h"
+#include "Core/Error.h"
+#include "Utils/Math/VectorMath.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+        /** Vertex to triangle adjacency in compressed form.
+        */
+        struct TriangleAdjacency
+        {
+            std::vector<uint32_t> offsets;      ///< Offset into triangles for each vertex. Size is vertexCount + 1.
+            std::vector<uint32_t> triangles;    ///< Triangles using each vertex.
+
+            TriangleAdjacency(const std::vector<uint32_t>& indices, uint32_t vertexCount)
+            {
+                offsets.assign(vertexCount + 1, 0);
+                for (uint32_t index : indices) offsets[index + 1]++;
+                for (uint32_t i = 0; i < vertexCount; i++) offsets[i + 1] += offsets[i];
+
+                triangles.resize(indices.size());
+                std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+                for (size_t i = 0; i < indices.size(); i++) triangles[cursor[indices[i]]++] = uint32_t(i / 3);
+            }
+        };
+    }
+
+    VertexOrderOptimizer::Statistics VertexOrderOptimizer::analyzeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize)
+    {
+        FALCOR_CHECK(indices.size() % 3 == 0, "Index count must be a multiple of 3.");
+        FALCOR_CHECK(cacheSize > 0, "Cache size must be non-zero.");
+
+        Statistics stats;
+        stats.triangleCount = indices.size() / 3;
+
+        // The cache is represented by the time each vertex was inserted. A vertex is
+        // in the FIFO cache if fewer than cacheSize vertices were inserted after it.
+        std::vector<uint64_t> insertTime(vertexCount, 0);
+        std::vector<bool> referenced(vertexCount, false);
+        uint64_t time = cacheSize + 1;
+
+        for (uint32_t index : indices)
+        {
+            FALCOR_CHECK(index < vertexCount, "Vertex index {} is out of range.", index);
+            if (!referenced[index])
+            {
+                referenced[index] = true;
+                stats.vertexCount++;
+            }
+            if (time - insertTime[index] > cacheSize)
+            {
+                insertTime[index] = time++;
+                stats.cacheMissCount++;
+            }
+        }
+
+        return stats;
+    }
+
+    void VertexOrderOptimizer::optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize, std::vector<uint32_t>* pClusters)
+    {
+        FALCOR_CHECK(indices.size() % 3 == 0, "Index count must be a multiple of 3.");
+        FALCOR_CHECK(cacheSize > 0, "Cache size must be non-zero.");
+
+        if (pClusters) pClusters->clear();
+        const uint32_t triangleCount = uint32_t(indices.size() / 3);
+        if (triangleCount == 0) return;
+
+        for (uint32_t index : indices) FALCOR_CHECK(index < vertexCount, "Vertex index {} is out of range.", index);
+
+        TriangleAdjacency adjacency(indices, vertexCount);
+
+        // Number of not yet emitted triangles using each vertex.
+        std::vector<uint32_t> liveTriangles(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; v++) liveTriangles[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+
+        std::vector<uint32_t> cacheTime(vertexCount, 0);
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32_t> deadEndStack;
+        std::vector<uint32_t> candidates;
+        std::vector<uint32_t> output;
+        output.reserve(indices.size());
+
+        uint32_t time = cacheSize + 1;
+        uint32_t cursor = 0;
+        uint32_t emittedCount = 0;
+
+        // Find the next fanning vertex when the current one has no suitable neighbors.
+        // Recently referenced vertices are tried first, then the input order.
+        auto skipDeadEnd = [&]()
+        {
+            while (!deadEndStack.empty())
+            {
+                uint32_t v = deadEndStack.back();
+                deadEndStack.pop_back();
+                if (liveTriangles[v] > 0) return v;
+            }
+            while (cursor < vertexCount)
+            {
+                if (liveTriangles[cursor] > 0) return cursor;
+                cursor++;
+            }
+            return kInvalidIndex;
+        };
+
+        uint32_t fanningVertex = skipDeadEnd();
+        bool isJump = true;
+
+        while (fanningVertex != kInvalidIndex)
+        {
+            candidates.clear();
+
+            // Emit all remaining triangles around the fanning vertex.
+            for (uint32_t i = adjacency.offsets[fanningVertex]; i < adjacency.offsets[fanningVertex + 1]; i++)
+            {
+                uint32_t t = adjacency.triangles[i];
+                if (emitted[t]) continue;
+
+                if (isJump && pClusters) pClusters->push_back(emittedCount);
+                isJump = false;
+
+                for (uint32_t j = 0; j < 3; j++)
+                {
+                    uint32_t v = indices[t * 3 + j];
+                    output.push_back(v);
+                    deadEndStack.push_back(v);
+                    candidates.push_back(v);
+                    liveTriangles[v]--;
+                    if (time - cacheTime[v] > cacheSize) cacheTime[v] = time++;
+                }
+                emitted[t] = true;
+                emittedCount++;
+            }
+
+            // Pick the candidate that will still be in the cache after fanning around it and is the oldest.
+            uint32_t bestVertex = kInvalidIndex;
+            int64_t bestPriority = -1;
+            for (uint32_t v : candidates)
+            {
+                if (liveTriangles[v] == 0) continue;
+                int64_t priority = 0;
+                if (int64_t(time) - cacheTime[v] + 2 * int64_t(liveTriangles[v]) <= int64_t(cacheSize))
+                {
+                    priority = int64_t(time) - cacheTime[v];
+                }
+                if (priority > bestPriority)
+                {
+                    bestPriority = priority;
+                    bestVertex = v;
+                }
+            }
+
+            if (bestVertex == kInvalidIndex)
+            {
+                bestVertex = skipDeadEnd();
+                isJump = true;
+            }
+            fanningVertex = bestVertex;
+        }
+
+        FALCOR_ASSERT(output.size() == indices.size());
+        indices = std::move(output);
+    }
+
+    void VertexOrderOptimizer::optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<float3>& positions, const std::vector<uint32_t>& clusters)
+    {
+        FALCOR_CHECK(indices.size() % 3 == 0, "Index count must be a multiple of 3.");
+
+        const uint32_t triangleCount = uint32_t(indices.size() / 3);
+        if (clusters.size() <= 1) return;
+
+        // Compute the area weighted centroid of the mesh.
+        std::vector<float3> triangleCentroids(triangleCount);
+        std::vector<float3> triangleNormals(triangleCount); // Scaled by twice the triangle area.
+        float3 meshCentroid = float3(0.f);
+        float meshArea = 0.f;
+        for (uint32_t t = 0; t < triangleCount; t++)
+        {
+            const float3& p0 = positions[indices[t * 3 + 0]];
+            const float3& p1 = positions[indices[t * 3 + 1]];
+            const float3& p2 = positions[indices[t * 3 + 2]];
+            triangleCentroids[t] = (p0 + p1 + p2) / 3.f;
+            triangleNormals[t] = cross(p1 - p0, p2 - p0);
+            float area = length(triangleNormals[t]);
+            meshCentroid += triangleCentroids[t] * area;
+            meshArea += area;
+        }
+        if (meshArea > 0.f) meshCentroid /= meshArea;
+
+        // Clusters facing away from the mesh centroid are more likely to occlude the rest of the mesh.
+        struct ClusterInfo
+        {
+            uint32_t begin;
+            uint32_t end;
+            float sortKey;
+        };
+        std::vector<ClusterInfo> clusterInfos(clusters.size());
+
+        for (size_t i = 0; i < clusters.size(); i++)
+        {
+            ClusterInfo& info = clusterInfos[i];
+            info.begin = clusters[i];
+            info.end = i + 1 < clusters.size() ? clusters[i + 1] : triangleCount;
+            FALCOR_CHECK(info.begin < info.end && info.end <= triangleCount, "Invalid cluster list.");
+
+            float3 centroid = float3(0.f);
+            float3 normal = float3(0.f);
+            float area = 0.f;
+            for (uint32_t t = info.begin; t < info.end; t++)
+            {
+                float triangleArea = length(triangleNormals[t]);
+                centroid += triangleCentroids[t] * triangleArea;
+                normal += triangleNormals[t];
+                area += triangleArea;
+            }
+            if (area > 0.f) centroid /= area;
+            float normalLength = length(normal);
+            info.sortKey = normalLength > 0.f ? dot(centroid - meshCentroid, normal / normalLength) : 0.f;
+        }
+
+        std::stable_sort(clusterInfos.begin(), clusterInfos.end(), [](const ClusterInfo& lhs, const ClusterInfo& rhs) { return lhs.sortKey > rhs.sortKey; });
+
+        std::vector<uint32_t> output;
+        output.reserve(indices.size());
+        for (const auto& info : clusterInfos)
+        {
+            output.insert(output.end(), indices.begin() + info.begin * 3, indices.begin() + info.end * 3);
+        }
+        indices = std::move(output);
+    }
+
+    std::vector<uint32_t> VertexOrderOptimizer::optimizeVertexFetch(std::vector<uint32_t>& indices, uint32_t vertexCount)
+    {
+        std::vector<uint32_t> oldToNew(vertexCount, kInvalidIndex);
+        std::vector<uint32_t> newToOld;
+        newToOld.reserve(vertexCount);
+
+        for (uint32_t& index : indices)
+        {
+            FALCOR_CHECK(index < vertexCount, "Vertex index {} is out of range.", index);
+            if (oldToNew[index] == kInvalidIndex)
+            {
+                oldToNew[index] = uint32_t(newToOld.size());
+                newToOld.push_back(index);
+            }
+            index = oldToNew[index];
+        }
+
+        for (uint32_t v = 0; v < vertexCount; v++)
+        {
+            if (oldToNew[v] == kInvalidIndex) newToOld.push_back(v);
+        }
+
+        FALCOR_ASSERT(newToOld.size() == vertexCount);
+        return newToOld;
+    }
+}
@@ -0,0 +1,106 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+    /** Reorders indexed triangle meshes for GPU efficiency.
+
+        The optimizations are applied in the following order:
+         - Post-transform vertex cache: Triangles are reordered using the Tipsify algorithm
+           [Sander et al. 2007, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"].
+         - Overdraw: The clusters produced by Tipsify are sorted so that clusters facing away from the
+           mesh center are drawn first, which tends to reduce overdraw from outside viewpoints.
+         - Vertex fetch: Vertices are renumbered in order of first use by the index buffer.
+    */
+    class FALCOR_API VertexOrderOptimizer
+    {
+    public:
+        static constexpr uint32_t kDefaultCacheSize = 16;
+
+        /** Post-transform vertex cache statistics, simulated with a FIFO cache.
+        */
+        struct Statistics
+        {
+            uint64_t triangleCount = 0;     ///< Number of triangles.
+            uint64_t vertexCount = 0;       ///< Number of unique vertices referenced by the index buffer.
+            uint64_t cacheMissCount = 0;    ///< Number of vertex shader invocations.
+
+            /** Average cache miss ratio, i.e., vertex shader invocations per triangle. The optimal value is 0.5.
+            */
+            float getACMR() const { return triangleCount > 0 ? float(cacheMissCount) / triangleCount : 0.f; }
+
+            /** Average transformed vertex ratio, i.e., vertex shader invocations per vertex. The optimal value is 1.0.
+            */
+            float getATVR() const { return vertexCount > 0 ? float(cacheMissCount) / vertexCount : 0.f; }
+
+            Statistics& operator+=(const Statistics& other)
+            {
+                triangleCount += other.triangleCount;
+                vertexCount += other.vertexCount;
+                cacheMissCount += other.cacheMissCount;
+                return *this;
+            }
+        };
+
+        /** Simulate a FIFO post-transform vertex cache for a triangle list.
+            \param[in] indices Triangle list indices.
+            \param[in] vertexCount Number of vertices.
+            \param[in] cacheSize Number of vertices in the simulated cache.
+            \return Cache statistics.
+        */
+        static Statistics analyzeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = kDefaultCacheSize);
+
+        /** Reorder triangles for post-transform vertex cache efficiency using Tipsify.
+            \param[in,out] indices Triangle list indices.
+            \param[in] vertexCount Number of vertices.
+            \param[in] cacheSize Target cache size.
+            \param[out] pClusters Optional. Index of the first triangle of each cluster, i.e., triangle sequences separated by non-local jumps.
+        */
+        static void optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = kDefaultCacheSize, std::vector<uint32_t>* pClusters = nullptr);
+
+        /** Sort triangle clusters to reduce overdraw. The triangle order within each cluster is retained.
+            \param[in,out] indices Triangle list indices.
+            \param[in] positions Vertex positions.
+            \param[in] clusters Index of the first triangle of each cluster, as produced by optimizeVertexCache().
+        */
+        static void optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<float3>& positions, const std::vector<uint32_t>& clusters);
+
+        /** Compute a vertex order where vertices appear in order of first use and update the indices accordingly.
+            Vertices not referenced by the indices are placed last, in their original order.
+            \param[in,out] indices Triangle list indices.
+            \param[in] vertexCount Number of vertices.
+            \return Vertex remapping table, where element i holds the old index of new vertex i.
+        */
+        static std::vector<uint32_t> optimizeVertexFetch(std::vector<uint32_t>& indices, uint32_t vertexCount);
+    };
+}
@@ -0,0 +1,373 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Error.h"
+#include "Utils/WorkerQueue.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace Falcor
+{
+    /** Streams the frames of a sequence with a bounded cache of resident frames and read-ahead.
+
+        Frames go through three stages: they are loaded (e.g. read from a file) and converted on the CPU,
+        then created (e.g. uploaded to the GPU) when requested. The first two stages run on a background
+        thread for frames that are expected to be requested next, based on the direction and rate of the
+        previous requests. Resident frames are evicted in least recently used order to stay within the
+        frame count and memory limits. If loading a frame fails in the background, the frame is loaded again
+        when it is requested, so that the error is reported to the caller of getFrame().
+
+        \tparam HostFrame Frame data produced by the load and convert stages. Must be default constructible and movable.
+        \tparam Frame Resident frame. Must be copyable.
+    */
+    template<typename HostFrame, typename Frame>
+    class FrameSequenceStreamer
+    {
+    public:
+        struct Callbacks
+        {
+            std::function<HostFrame(uint32_t frame)> load;      ///< Load a frame. Called on the background thread or the requesting thread.
+            std::function<void(HostFrame&)> convert;            ///< Convert a loaded frame on the CPU (optional). Called on the same thread as load.
+            std::function<Frame(HostFrame&&)> create;           ///< Create a resident frame. Called on the requesting thread.
+            std::function<uint64_t(const Frame&)> getByteSize;  ///< Size of a resident frame in bytes (optional).
+        };
+
+        struct Options
+        {
+            uint32_t maxResidentFrames = 8;     ///< Maximum number of resident frames. The requested frame is always resident.
+            uint64_t memoryBudget = 0;          ///< Maximum total size of resident frames in bytes, or zero for no limit.
+            uint32_t prefetchCount = 4;         ///< Number of frames to read ahead in the playback direction.
+        };
+
+        /** Latencies measured for one frame, in milliseconds. The times are those of the last load of the frame.
+        */
+        struct FrameStats
+        {
+            double loadTimeMs = 0.0;
+            double convertTimeMs = 0.0;
+            double createTimeMs = 0.0;
+            uint32_t loadCount = 0;             ///< Number of times the frame was loaded.
+        };
+
+        struct Stats
+        {
+            uint64_t requestCount = 0;          ///< Number of frame requests.
+            uint64_t hitCount = 0;              ///< Requests for resident frames.
+            uint64_t prefetchHitCount = 0;      ///< Requests for frames that were loaded ahead of time.
+            uint64_t missCount = 0;             ///< Requests for frames that were not loaded in time.
+            uint64_t evictionCount = 0;         ///< Number of evicted frames.
+            double stallTimeMs = 0.0;           ///< Total time spent waiting for or loading missed frames.
+        };
+
+        /** Constructor. Starts the background thread.
+            \param[in] frameCount Number of frames in the sequence.
+            \param[in] callbacks Callbacks to load, convert and create frames.
+            \param[in] options Streaming options.
+        */
+        FrameSequenceStreamer(uint32_t frameCount, Callbacks callbacks, const Options& options)
+            : mFrameCount(frameCount)
+            , mCallbacks(std::move(callbacks))
+            , mOptions(options)
+            , mFrameStats(frameCount)
+            , mLoader(1, {
+                [this](LoadJob& job) { loadHostFrame(job.frame, job.hostFrame, job.stats); },
+                [this](LoadJob& job, bool success) { if (success) publishHostFrame(job); },
+                [](const LoadJob& job) { return fmt::format("load frame {}", job.frame); } })
+        {
+            FALCOR_CHECK(mCallbacks.load && mCallbacks.create, "FrameSequenceStreamer requires load and create callbacks.");
+            mOptions.maxResidentFrames = std::max(mOptions.maxResidentFrames, 1u);
+        }
+
+        /** Destructor. Blocks until the frame being loaded in the background is done.
+        */
+        ~FrameSequenceStreamer() = default;
+
+        FrameSequenceStreamer(const FrameSequenceStreamer&) = delete;
+        FrameSequenceStreamer& operator=(const FrameSequenceStreamer&) = delete;
+
+        /** Get a frame, loading it if it is not resident, and schedule loading the frames expected next.
+            \param[in] frame Frame index.
+            \return The resident frame.
+        */
+        Frame getFrame(uint32_t frame)
+        {
+            FALCOR_CHECK(frame < mFrameCount, "Frame {} is out of range (frame count is {}).", frame, mFrameCount);
+
+            mRequestCounter++;
+            mStats.requestCount++;
+            updatePlaybackStep(frame);
+
+            if (auto it = mResident.find(frame); it != mResident.end())
+            {
+                mStats.hitCount++;
+                it->second.lastUse = mRequestCounter;
+            }
+            else
+            {
+                HostFrame hostFrame = acquireHostFrame(frame);
+
+                auto startTime = CpuTimer::getCurrentTimePoint();
+                Resident resident;
+                resident.frame = mCallbacks.create(std::move(hostFrame));
+                resident.byteSize = mCallbacks.getByteSize ? mCallbacks.getByteSize(resident.frame) : 0;
+                resident.lastUse = mRequestCounter;
+                double createTimeMs = CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint());
+                {
+                    auto lock = mLoader.lock();
+                    mFrameStats[frame].createTimeMs = createTimeMs;
+                }
+
+                mResidentByteSize += resident.byteSize;
+                mResident.emplace(frame, std::move(resident));
+                evict(frame);
+            }
+
+            schedulePrefetch(frame);
+
+            return mResident.at(frame).frame;
+        }
+
+        /** Check if a frame is resident.
+        */
+        bool isResident(uint32_t frame) const { return mResident.count(frame) != 0; }
+
+        uint32_t getFrameCount() const { return mFrameCount; }
+        uint32_t getResidentFrameCount() const { return (uint32_t)mResident.size(); }
+        uint64_t getResidentByteSize() const { return mResidentByteSize; }
+        const Options& getOptions() const { return mOptions; }
+        const Stats& getStats() const { return mStats; }
+
+        /** Get the latencies measured for a frame.
+        */
+        FrameStats getFrameStats(uint32_t frame) const
+        {
+            FALCOR_CHECK(frame < mFrameCount, "Frame {} is out of range (frame count is {}).", frame, mFrameCount);
+            auto lock = mLoader.lock();
+            return mFrameStats[frame];
+        }
+
+        /** Get the average latencies over all frames that were loaded.
+        */
+        FrameStats getAverageFrameStats() const
+        {
+            auto lock = mLoader.lock();
+            FrameStats average;
+            uint32_t count = 0;
+            for (const auto& stats : mFrameStats)
+            {
+                if (stats.loadCount == 0) continue;
+                average.loadTimeMs += stats.loadTimeMs;
+                average.convertTimeMs += stats.convertTimeMs;
+                average.createTimeMs += stats.createTimeMs;
+                average.loadCount += stats.loadCount;
+                count++;
+            }
+            if (count > 0)
+            {
+                average.loadTimeMs /= count;
+                average.convertTimeMs /= count;
+                average.createTimeMs /= count;
+            }
+            return average;
+        }
+
+    private:
+        static constexpr uint32_t kNoFrame = uint32_t(-1);
+        static constexpr int32_t kMaxPlaybackStep = 8;  ///< Larger jumps between requests are treated as seeks.
+
+        struct Resident
+        {
+            Frame frame;
+            uint64_t byteSize = 0;
+            uint64_t lastUse = 0;
+        };
+
+        struct LoadJob
+        {
+            uint32_t frame = kNoFrame;
+            HostFrame hostFrame;
+            FrameStats stats;
+        };
+
+        static auto isFrame(uint32_t frame)
+        {
+            return [frame](const LoadJob& job) { return job.frame == frame; };
+        }
+
+        void updatePlaybackStep(uint32_t frame)
+        {
+            if (mLastFrame != kNoFrame && mFrameCount > 1)
+            {
+                // Use the shorter way around the sequence to follow looped playback in both directions.
+                int32_t delta = int32_t(frame) - int32_t(mLastFrame);
+                if (delta > int32_t(mFrameCount / 2)) delta -= int32_t(mFrameCount);
+                else if (delta < -int32_t(mFrameCount / 2)) delta += int32_t(mFrameCount);
+
+                if (delta != 0 && std::abs(delta) <= kMaxPlaybackStep) mPlaybackStep = delta;
+            }
+            mLastFrame = frame;
+        }
+
+        uint32_t predictFrame(uint32_t frame, uint32_t i) const
+        {
+            int64_t predicted = int64_t(frame) + int64_t(mPlaybackStep) * i;
+            predicted %= int64_t(mFrameCount);
+            if (predicted < 0) predicted += mFrameCount;
+            return uint32_t(predicted);
+        }
+
+        void loadHostFrame(uint32_t frame, HostFrame& hostFrame, FrameStats& stats)
+        {
+            auto startTime = CpuTimer::getCurrentTimePoint();
+            hostFrame = mCallbacks.load(frame);
+            auto loadTime = CpuTimer::getCurrentTimePoint();
+            if (mCallbacks.convert) mCallbacks.convert(hostFrame);
+            stats.loadTimeMs = CpuTimer::calcDuration(startTime, loadTime);
+            stats.convertTimeMs = CpuTimer::calcDuration(loadTime, CpuTimer::getCurrentTimePoint());
+        }
+
+        void recordHostFrameStats(uint32_t frame, const FrameStats& stats)
+        {
+            mFrameStats[frame].loadTimeMs = stats.loadTimeMs;
+            mFrameStats[frame].convertTimeMs = stats.convertTimeMs;
+            mFrameStats[frame].loadCount++;
+        }
+
+        void publishHostFrame(LoadJob& job)
+        {
+            recordHostFrameStats(job.frame, job.stats);
+            mReady[job.frame] = std::move(job.hostFrame);
+        }
+
+        HostFrame acquireHostFrame(uint32_t frame)
+        {
+            HostFrame hostFrame;
+            auto lock = mLoader.lock();
+
+            if (auto it = mReady.find(frame); it != mReady.end())
+            {
+                hostFrame = std::move(it->second);
+                mReady.erase(it);
+                mStats.prefetchHitCount++;
+                return hostFrame;
+            }
+
+            // The frame was not loaded in time. Wait for it if it is being loaded, otherwise load it here.
+            // It is also loaded here if loading failed in the background, so that the error is reported to the caller.
+            mStats.missCount++;
+            auto startTime = CpuTimer::getCurrentTimePoint();
+            mLoader.cancelIf(lock, isFrame(frame));
+            mLoader.wait(lock, [&]() { return !mLoader.isRunning(lock, isFrame(frame)); });
+            if (auto it = mReady.find(frame); it != mReady.end())
+            {
+                hostFrame = std::move(it->second);
+                mReady.erase(it);
+            }
+            else
+            {
+                lock.unlock();
+                FrameStats stats;
+                loadHostFrame(frame, hostFrame, stats);
+                lock.lock();
+                recordHostFrameStats(frame, stats);
+            }
+            mStats.stallTimeMs += CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint());
+            return hostFrame;
+        }
+
+        void evict(uint32_t currentFrame)
+        {
+            auto overLimit = [&]()
+            {
+                return mResident.size() > mOptions.maxResidentFrames || (mOptions.memoryBudget > 0 && mResidentByteSize > mOptions.memoryBudget);
+            };
+
+            while (overLimit())
+            {
+                auto lru = mResident.end();
+                for (auto it = mResident.begin(); it != mResident.end(); ++it)
+                {
+                    if (it->first == currentFrame) continue;
+                    if (lru == mResident.end() || it->second.lastUse < lru->second.lastUse) lru = it;
+                }
+                if (lru == mResident.end()) break;
+
+                mResidentByteSize -= lru->second.byteSize;
+                mResident.erase(lru);
+                mStats.evictionCount++;
+            }
+        }
+
+        void schedulePrefetch(uint32_t frame)
+        {
+            std::vector<uint32_t> predicted;
+            for (uint32_t i = 1; i <= mOptions.prefetchCount && i < mFrameCount; i++)
+            {
+                uint32_t next = predictFrame(frame, i);
+                if (next != frame && !isResident(next) && std::find(predicted.begin(), predicted.end(), next) == predicted.end()) predicted.push_back(next);
+            }
+            auto isPredicted = [&](uint32_t f) { return std::find(predicted.begin(), predicted.end(), f) != predicted.end(); };
+
+            auto lock = mLoader.lock();
+
+            // Drop loaded and queued frames that are no longer expected, e.g. after a seek or a change of direction.
+            for (auto it = mReady.begin(); it != mReady.end();)
+            {
+                if (!isPredicted(it->first)) it = mReady.erase(it);
+                else ++it;
+            }
+            mLoader.cancelIf(lock, [](const LoadJob&) { return true; });
+
+            for (uint32_t next : predicted)
+            {
+                if (mReady.count(next) == 0 && !mLoader.isRunning(lock, isFrame(next))) mLoader.push(lock, LoadJob{ next });
+            }
+        }
+
+        const uint32_t mFrameCount;
+        Callbacks mCallbacks;
+        Options mOptions;
+
+        // State accessed by the requesting thread only.
+        std::unordered_map<uint32_t, Resident> mResident;
+        uint64_t mResidentByteSize = 0;
+        uint64_t mRequestCounter = 0;
+        uint32_t mLastFrame = kNoFrame;
+        int32_t mPlaybackStep = 1;
+        Stats mStats;
+
+        // Background loading. Guarded by the loader mutex.
+        std::unordered_map<uint32_t, HostFrame> mReady;     ///< Loaded frames waiting to be requested.
+        std::vector<FrameStats> mFrameStats;
+        WorkerQueue<LoadJob> mLoader;                       ///< Loads the frames expected next, in order of expected use. Declared last to be destroyed first.
+    };
+}
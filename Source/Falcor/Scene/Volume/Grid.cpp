@@ -75,8 +75,28 @@ namespace Falcor
         {
             return int3(c[0], c[1], c[2]);
         }
+
+        using NanoVDBGridConverter = NanoVDBConverterBC4;
+
+        std::unique_ptr<NanoVDBGridConverter> convertGridOnHost(nanovdb::FloatGrid* pFloatGrid)
+        {
+            if (!pFloatGrid->hasMinMax())
+            {
+                nanovdb::gridStats(*pFloatGrid);
+            }
+
+            auto pConverter = std::make_unique<NanoVDBGridConverter>(pFloatGrid);
+            pConverter->convertOnHost();
+            return pConverter;
+        }
     }
 
+    struct Grid::HostData
+    {
+        nanovdb::GridHandle<nanovdb::HostBuffer> gridHandle;
+        std::unique_ptr<NanoVDBGridConverter> pConverter;   ///< Bricks converted on the CPU, or nullptr if not converted yet.
+    };
+
     ref<Grid> Grid::createSphere(ref<Device> pDevice, float radius, float voxelSize, float blendRange)
     {
         auto handle = nanovdb::createFogVolumeSphere<float>(radius, nanovdb::Vec3f(0.f), voxelSize, blendRange);
@@ -90,6 +110,11 @@ namespace Falcor
     }
 
     ref<Grid> Grid::createFromFile(ref<Device> pDevice, const std::filesystem::path& path, const std::string& gridname)
+    {
+        return createFromHostData(pDevice, readFile(path, gridname));
+    }
+
+    std::shared_ptr<Grid::HostData> Grid::readFile(const std::filesystem::path& path, const std::string& gridname)
     {
         if (!std::filesystem::exists(path))
         {
@@ -97,19 +122,38 @@ namespace Falcor
             return nullptr;
         }
 
+        nanovdb::GridHandle<nanovdb::HostBuffer> handle;
         if (hasExtension(path, "nvdb"))
         {
-            return createFromNanoVDBFile(pDevice, path, gridname);
+            handle = readNanoVDBFile(path, gridname);
         }
         else if (hasExtension(path, "vdb"))
         {
-            return createFromOpenVDBFile(pDevice, path, gridname);
+            handle = readOpenVDBFile(path, gridname);
         }
         else
         {
             logWarning("Error when loading grid. Unsupported grid file '{}'.", path);
-            return nullptr;
         }
+
+        if (!handle) return nullptr;
+
+        auto pHostData = std::make_shared<HostData>();
+        pHostData->gridHandle = std::move(handle);
+        return pHostData;
+    }
+
+    void Grid::convertToBricks(HostData& hostData)
+    {
+        if (!hostData.pConverter) hostData.pConverter = convertGridOnHost(hostData.gridHandle.grid<float>());
+    }
+
+    ref<Grid> Grid::createFromHostData(ref<Device> pDevice, const std::shared_ptr<HostData>& pHostData)
+    {
+        if (!pHostData) return nullptr;
+
+        convertToBricks(*pHostData);
+        return ref<Grid>(new Grid(pDevice, std::move(*pHostData)));
     }
 
     void Grid::renderUI(Gui::Widgets& widget)
@@ -203,15 +247,17 @@ namespace Falcor
     }
 
     Grid::Grid(ref<Device> pDevice, nanovdb::GridHandle<nanovdb::HostBuffer> gridHandle)
+        : Grid(pDevice, HostData{ std::move(gridHandle), nullptr })
+    {}
+
+    Grid::Grid(ref<Device> pDevice, HostData&& hostData)
         : mpDevice(pDevice)
-        , mGridHandle(std::move(gridHandle))
+        , mGridHandle(std::move(hostData.gridHandle))
         , mpFloatGrid(mGridHandle.grid<float>())
         , mAccessor(mpFloatGrid->getAccessor())
     {
-        if (!mpFloatGrid->hasMinMax())
-        {
-            nanovdb::gridStats(*mpFloatGrid);
-        }
+        // Moving the handle keeps the grid in place, so bricks converted before remain valid.
+        if (!hostData.pConverter) hostData.pConverter = convertGridOnHost(mpFloatGrid);
 
         // Keep both NanoVDB and brick textures resident in GPU memory for simplicity for now (~15% increased footprint).
         mpBuffer = mpDevice->createStructuredBuffer(
@@ -221,42 +267,41 @@ namespace Falcor
             MemoryType::DeviceLocal,
             mGridHandle.data()
         );
-        using NanoVDBGridConverter = NanoVDBConverterBC4;
-        mBrickedGrid = NanoVDBGridConverter(mpFloatGrid).convert(mpDevice);
+        mBrickedGrid = hostData.pConverter->createTextures(mpDevice);
     }
 
-    ref<Grid> Grid::createFromNanoVDBFile(ref<Device> pDevice, const std::filesystem::path& path, const std::string& gridname)
+    nanovdb::GridHandle<nanovdb::HostBuffer> Grid::readNanoVDBFile(const std::filesystem::path& path, const std::string& gridname)
     {
         if (!nanovdb::io::hasGrid(path.string(), gridname))
         {
             logWarning("Error when loading grid. Can't find grid '{}' in '{}'.", gridname, path);
-            return nullptr;
+            return {};
         }
 
         auto handle = nanovdb::io::readGrid(path.string(), gridname);
         if (!handle)
         {
             logWarning("Error when loading grid.");
-            return nullptr;
+            return {};
         }
 
         auto floatGrid = handle.grid<float>();
         if (!floatGrid || floatGrid->gridType() != nanovdb::GridType::Float)
         {
             logWarning("Error when loading grid. Grid '{}' in '{}' is not of type float.", gridname, path);
-            return nullptr;
+            return {};
         }
 
         if (floatGrid->isEmpty())
         {
             logWarning("Grid '{}' in '{}' is empty.", gridname, path);
-            return nullptr;
+            return {};
         }
 
-        return ref<Grid>(new Grid(pDevice, std::move(handle)));
+        return handle;
     }
 
-    ref<Grid> Grid::createFromOpenVDBFile(ref<Device> pDevice, const std::filesystem::path& path, const std::string& gridname)
+    nanovdb::GridHandle<nanovdb::HostBuffer> Grid::readOpenVDBFile(const std::filesystem::path& path, const std::string& gridname)
     {
         openvdb::initialize();
 
@@ -278,25 +323,23 @@ namespace Falcor
         if (!baseGrid)
         {
             logWarning("Error when loading grid. Can't find grid '{}' in '{}'.", gridname, path);
-            return nullptr;
+            return {};
         }
 
         if (!baseGrid->isType<openvdb::FloatGrid>())
         {
             logWarning("Error when loading grid. Grid '{}' in '{}' is not of type float.", gridname, path);
-            return nullptr;
+            return {};
         }
 
         if (baseGrid->empty())
         {
             logWarning("Grid '{}' in '{}' is empty.", gridname, path);
-            return nullptr;
+            return {};
         }
 
         openvdb::FloatGrid::Ptr floatGrid = openvdb::gridPtrCast<openvdb::FloatGrid>(baseGrid);
-        auto handle = nanovdb::openToNanoVDB(floatGrid);
-
-        return ref<Grid>(new Grid(pDevice, std::move(handle)));
+        return nanovdb::openToNanoVDB(floatGrid);
     }
 
 
@@ -60,6 +60,11 @@ namespace Falcor
     {
         FALCOR_OBJECT(Grid)
     public:
+        /** Grid data on the CPU, read from a file and optionally converted to bricks.
+            Preparing it does not access the GPU, which allows grids to be loaded on worker threads.
+        */
+        struct HostData;
+
         /** Create a sphere voxel grid.
             \param[in] pDevice GPU device.
             \param[in] radius Radius of the sphere in world units.
@@ -89,6 +94,26 @@ namespace Falcor
         */
         static ref<Grid> createFromFile(ref<Device> pDevice, const std::filesystem::path& path, const std::string& gridname);
 
+        /** Read a grid from a file without accessing the GPU. This is safe to call from any thread.
+            Currently only OpenVDB and NanoVDB grids of type float are supported.
+            \param[in] path File path of the grid (absolute or relative to working directory).
+            \param[in] gridname Name of the grid to load.
+            \return Host data of the grid, or nullptr if the grid failed to load.
+        */
+        static std::shared_ptr<HostData> readFile(const std::filesystem::path& path, const std::string& gridname);
+
+        /** Convert grid host data to bricks without accessing the GPU. This is safe to call from any thread.
+            Does nothing if the host data is already converted.
+        */
+        static void convertToBricks(HostData& hostData);
+
+        /** Create a grid from host data. The host data is converted to bricks first if needed.
+            \param[in] pDevice GPU device.
+            \param[in] pHostData Host data of the grid. The data is moved into the grid.
+            \return A new grid, or nullptr if pHostData is nullptr.
+        */
+        static ref<Grid> createFromHostData(ref<Device> pDevice, const std::shared_ptr<HostData>& pHostData);
+
         /** Render the UI.
         */
         void renderUI(Gui::Widgets& widget);
@@ -146,9 +171,10 @@ namespace Falcor
 
     private:
         Grid(ref<Device> pDevice, nanovdb::GridHandle<nanovdb::HostBuffer> gridHandle);
+        Grid(ref<Device> pDevice, HostData&& hostData);
 
-        static ref<Grid> createFromNanoVDBFile(ref<Device>, const std::filesystem::path& path, const std::string& gridname);
-        static ref<Grid> createFromOpenVDBFile(ref<Device>, const std::filesystem::path& path, const std::string& gridname);
+        static nanovdb::GridHandle<nanovdb::HostBuffer> readNanoVDBFile(const std::filesystem::path& path, const std::string& gridname);
+        static nanovdb::GridHandle<nanovdb::HostBuffer> readOpenVDBFile(const std::filesystem::path& path, const std::string& gridname);
 
         ref<Device> mpDevice;
 
@@ -29,10 +29,12 @@
 #include "Grid.h"
 #include "Core/API/Device.h"
 #include "Utils/Logger.h"
+#include "Utils/StringUtils.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "GlobalState.h"
 #include <set>
 #include <filesystem>
+#include <sstream>
 
 namespace Falcor
 {
@@ -49,6 +51,37 @@ namespace Falcor
         const float kMaxAnisotropy = 0.99f;
         const double kMinFrameRate = 1.0;
         const double kMaxFrameRate = 1000.0;
+
+        bool findGridFiles(const std::filesystem::path& path, std::vector<std::filesystem::path>& paths)
+        {
+            if (!std::filesystem::exists(path))
+            {
+                logWarning("'{}' does not exist.", path);
+                return false;
+            }
+            if (!std::filesystem::is_directory(path))
+            {
+                logWarning("'{}' is not a directory.", path);
+                return false;
+            }
+
+            // Enumerate grid files.
+            paths.clear();
+            for (auto it : std::filesystem::directory_iterator(path))
+            {
+                if (hasExtension(it.path(), "nvdb") || hasExtension(it.path(), "vdb")) paths.push_back(it.path());
+            }
+
+            // Sort by length first, then alpha-numerically.
+            auto cmp = [](const std::filesystem::path& a, const std::filesystem::path& b) {
+                auto sa = a.string();
+                auto sb = b.string();
+                return sa.length() != sb.length() ? sa.length() < sb.length() : sa < sb;
+            };
+            std::sort(paths.begin(), paths.end(), cmp);
+
+            return true;
+        }
     }
 
     static_assert(sizeof(GridVolumeData) % 16 == 0, "GridVolumeData size should be a multiple of 16");
@@ -78,6 +111,25 @@ namespace Falcor
 
             bool playback = isPlaybackEnabled();
             if (widget.checkbox("Playback", playback)) setPlaybackEnabled(playback);
+
+            for (uint32_t slotIndex = 0; slotIndex < (uint32_t)GridSlot::Count; ++slotIndex)
+            {
+                const auto* pStreamer = getGridSequenceStreamer((GridSlot)slotIndex);
+                if (!pStreamer) continue;
+
+                if (auto group = widget.group(slotIndex == (uint32_t)GridSlot::Density ? "Density Streaming" : "Emission Streaming"))
+                {
+                    const auto& stats = pStreamer->getStats();
+                    const auto average = pStreamer->getAverageFrameStats();
+                    std::ostringstream oss;
+                    oss << "Resident frames: " << pStreamer->getResidentFrameCount() << " / " << pStreamer->getOptions().maxResidentFrames << std::endl
+                        << "Resident memory: " << formatByteSize(pStreamer->getResidentByteSize()) << std::endl
+                        << "Hits / prefetched / missed: " << stats.hitCount << " / " << stats.prefetchHitCount << " / " << stats.missCount << std::endl
+                        << "Stall time: " << stats.stallTimeMs << " ms" << std::endl
+                        << "Average load / convert / upload: " << average.loadTimeMs << " / " << average.convertTimeMs << " / " << average.createTimeMs << " ms" << std::endl;
+                    group.text(oss.str());
+                }
+            }
         }
 
         if (const auto& densityGrid = getDensityGrid())
@@ -146,33 +198,58 @@ namespace Falcor
 
     uint32_t GridVolume::loadGridSequence(GridSlot slot, const std::filesystem::path& path, const std::string& gridname, bool keepEmpty)
     {
-        if (!std::filesystem::exists(path))
-        {
-            logWarning("'{}' does not exist.", path);
-            return 0;
-        }
-        if (!std::filesystem::is_directory(path))
+        std::vector<std::filesystem::path> paths;
+        if (!findGridFiles(path, paths)) return 0;
+        return loadGridSequence(slot, paths, gridname, keepEmpty);
+    }
+
+    uint32_t GridVolume::streamGridSequence(GridSlot slot, const std::vector<std::filesystem::path>& paths, const std::string& gridname, const GridSequenceStreamer::Options& options)
+    {
+        uint32_t slotIndex = (uint32_t)slot;
+        FALCOR_ASSERT(slotIndex >= 0 && slotIndex < (uint32_t)GridSlot::Count);
+
+        if (paths.empty())
         {
-            logWarning("'{}' is not a directory.", path);
+            setGridSequence(slot, {});
             return 0;
         }
 
-        // Enumerate grid files.
+        // Grids are read and converted to bricks on the streamer's thread, only the upload happens on the calling thread.
+        GridSequenceStreamer::Callbacks callbacks;
+        callbacks.load = [paths, gridname](uint32_t frame) { return Grid::readFile(paths[frame], gridname); };
+        callbacks.convert = [](std::shared_ptr<Grid::HostData>& pHostData) { if (pHostData) Grid::convertToBricks(*pHostData); };
+        callbacks.create = [pDevice = mpDevice](std::shared_ptr<Grid::HostData>&& pHostData) { return Grid::createFromHostData(pDevice, pHostData); };
+        callbacks.getByteSize = [](const ref<Grid>& pGrid) { return pGrid ? pGrid->getGridSizeInBytes() : uint64_t(0); };
+
+        auto& streamed = mStreamedGrids[slotIndex];
+        streamed.paths = paths;
+        streamed.gridname = gridname;
+        streamed.options = options;
+        streamed.pStreamer = std::make_unique<GridSequenceStreamer>((uint32_t)paths.size(), std::move(callbacks), options);
+        streamed.pGrid = nullptr;
+        mGrids[slotIndex].clear();
+
+        updateSequence();
+        updateStreamedGrids();
+        updateBounds();
+        markUpdates(UpdateFlags::GridsChanged);
+
+        return (uint32_t)paths.size();
+    }
+
+    uint32_t GridVolume::streamGridSequence(GridSlot slot, const std::filesystem::path& path, const std::string& gridname, const GridSequenceStreamer::Options& options)
+    {
         std::vector<std::filesystem::path> paths;
-        for (auto it : std::filesystem::directory_iterator(path))
-        {
-            if (hasExtension(it.path(), "nvdb") || hasExtension(it.path(), "vdb")) paths.push_back(it.path());
-        }
+        if (!findGridFiles(path, paths)) return 0;
+        return streamGridSequence(slot, paths, gridname, options);
+    }
 
-        // Sort by length first, then alpha-numerically.
-        auto cmp = [](const std::filesystem::path& a, const std::filesystem::path& b) {
-            auto sa = a.string();
-            auto sb = b.string();
-            return sa.length() != sb.length() ? sa.length() < sb.length() : sa < sb;
-        };
-        std::sort(paths.begin(), paths.end(), cmp);
+    const GridVolume::GridSequenceStreamer* GridVolume::getGridSequenceStreamer(GridSlot slot) const
+    {
+        uint32_t slotIndex = (uint32_t)slot;
+        FALCOR_ASSERT(slotIndex >= 0 && slotIndex < (uint32_t)GridSlot::Count);
 
-        return loadGridSequence(slot, paths, gridname, keepEmpty);
+        return mStreamedGrids[slotIndex].pStreamer.get();
     }
 
     void GridVolume::setGridSequence(GridSlot slot, const GridSequence& grids)
@@ -180,8 +257,9 @@ namespace Falcor
         uint32_t slotIndex = (uint32_t)slot;
         FALCOR_ASSERT(slotIndex >= 0 && slotIndex < (uint32_t)GridSlot::Count);
 
-        if (mGrids[slotIndex] != grids)
+        if (mGrids[slotIndex] != grids || mStreamedGrids[slotIndex].pStreamer)
         {
+            mStreamedGrids[slotIndex] = {};
             mGrids[slotIndex] = grids;
             updateSequence();
             updateBounds();
@@ -209,6 +287,8 @@ namespace Falcor
         uint32_t slotIndex = (uint32_t)slot;
         FALCOR_ASSERT(slotIndex >= 0 && slotIndex < (uint32_t)GridSlot::Count);
 
+        if (mStreamedGrids[slotIndex].pStreamer) return mStreamedGrids[slotIndex].pGrid;
+
         const auto& gridSequence = mGrids[slotIndex];
         uint32_t gridIndex = std::min(mGridFrame, (uint32_t)gridSequence.size() - 1);
         return gridSequence.empty() ? kNullGrid : gridSequence[gridIndex];
@@ -229,6 +309,7 @@ namespace Falcor
         if (mGridFrame != gridFrame)
         {
             mGridFrame = gridFrame;
+            updateStreamedGrids();
             markUpdates(UpdateFlags::GridsChanged);
             updateBounds();
         }
@@ -329,9 +410,22 @@ namespace Falcor
     {
         mGridFrameCount = 1;
         for (const auto& grids : mGrids) mGridFrameCount = std::max(mGridFrameCount, (uint32_t)grids.size());
+        for (const auto& streamed : mStreamedGrids)
+        {
+            if (streamed.pStreamer) mGridFrameCount = std::max(mGridFrameCount, streamed.pStreamer->getFrameCount());
+        }
         setGridFrame(std::min(mGridFrame, mGridFrameCount - 1));
     }
 
+    void GridVolume::updateStreamedGrids()
+    {
+        for (auto& streamed : mStreamedGrids)
+        {
+            if (!streamed.pStreamer) continue;
+            streamed.pGrid = streamed.pStreamer->getFrame(std::min(mGridFrame, streamed.pStreamer->getFrameCount() - 1));
+        }
+    }
+
     void GridVolume::updateBounds()
     {
         AABB bounds;
@@ -421,6 +515,32 @@ namespace Falcor
             { return self.loadGridSequence(slot, getActiveAssetResolver().resolvePath(path), gridname, keepEmpty); },
             "slot"_a, "path"_a, "gridnames"_a, "keepEmpty"_a = true
         ); // PYTHONDEPRECATED
+        auto createStreamingOptions = [](uint32_t maxResidentFrames, uint64_t memoryBudget, uint32_t prefetchCount)
+        {
+            GridVolume::GridSequenceStreamer::Options options;
+            options.maxResidentFrames = maxResidentFrames;
+            options.memoryBudget = memoryBudget;
+            options.prefetchCount = prefetchCount;
+            return options;
+        };
+        const GridVolume::GridSequenceStreamer::Options kDefaultStreamingOptions;
+        volume.def("streamGridSequence",
+            [createStreamingOptions](GridVolume& self, GridVolume::GridSlot slot, const std::vector<std::filesystem::path>& paths, const std::string& gridname, uint32_t maxResidentFrames, uint64_t memoryBudget, uint32_t prefetchCount)
+            {
+                std::vector<std::filesystem::path> resolvedPaths;
+                for (const auto& path : paths)
+                    resolvedPaths.push_back(getActiveAssetResolver().resolvePath(path));
+                return self.streamGridSequence(slot, resolvedPaths, gridname, createStreamingOptions(maxResidentFrames, memoryBudget, prefetchCount));
+            },
+            "slot"_a, "paths"_a, "gridname"_a, "maxResidentFrames"_a = kDefaultStreamingOptions.maxResidentFrames,
+            "memoryBudget"_a = kDefaultStreamingOptions.memoryBudget, "prefetchCount"_a = kDefaultStreamingOptions.prefetchCount
+        );
+        volume.def("streamGridSequence",
+            [createStreamingOptions](GridVolume& self, GridVolume::GridSlot slot, const std::filesystem::path& path, const std::string& gridname, uint32_t maxResidentFrames, uint64_t memoryBudget, uint32_t prefetchCount)
+            { return self.streamGridSequence(slot, getActiveAssetResolver().resolvePath(path), gridname, createStreamingOptions(maxResidentFrames, memoryBudget, prefetchCount)); },
+            "slot"_a, "path"_a, "gridname"_a, "maxResidentFrames"_a = kDefaultStreamingOptions.maxResidentFrames,
+            "memoryBudget"_a = kDefaultStreamingOptions.memoryBudget, "prefetchCount"_a = kDefaultStreamingOptions.prefetchCount
+        );
 
         m.attr("Volume") = m.attr("GridVolume"); // PYTHONDEPRECATED
     }
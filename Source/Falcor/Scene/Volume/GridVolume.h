@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "Grid.h"
+#include "FrameSequenceStreamer.h"
 #include "GridVolumeData.slang"
 #include "Core/Macros.h"
 #include "Utils/Math/AABB.h"
@@ -46,13 +47,15 @@ namespace Falcor
         The absorbing/scattering medium is defined by a density voxel grid and additional parameters.
         The emission is defined by an emission voxel grid and additional parameters.
         Grids are stored in grid slots (density, emission) and can either be static, using one grid per slot,
-        or dynamic, using a sequence of grids per slot.
+        or dynamic, using a sequence of grids per slot. Sequences can be streamed from files, keeping only a few
+        grids resident at a time.
     */
     class FALCOR_API GridVolume : public Animatable
     {
         FALCOR_OBJECT(GridVolume)
     public:
         using GridSequence = std::vector<ref<Grid>>;
+        using GridSequenceStreamer = FrameSequenceStreamer<std::shared_ptr<Grid::HostData>, ref<Grid>>;
 
         /** Flags indicating if and what was updated in the volume.
         */
@@ -146,6 +149,34 @@ namespace Falcor
         */
         uint32_t loadGridSequence(GridSlot slot, const std::filesystem::path& path, const std::string& gridname, bool keepEmpty = true);
 
+        /** Stream a sequence of grids from files to a grid slot.
+            Grids are loaded when their frame is selected and a bounded number of them is kept resident.
+            During playback, the grids of the next frames are read and converted in the background.
+            Frames whose grid cannot be loaded are empty.
+            Note: This will replace any existing grid sequence for that slot.
+            \param[in] slot Grid slot.
+            \param[in] paths File paths of the grids. Can also include a full path or relative path from a data directory.
+            \param[in] gridname Name of the grid to load.
+            \param[in] options Streaming options.
+            \return Returns the length of the sequence.
+        */
+        uint32_t streamGridSequence(GridSlot slot, const std::vector<std::filesystem::path>& paths, const std::string& gridname, const GridSequenceStreamer::Options& options = {});
+
+        /** Stream a sequence of grids from a directory to a grid slot.
+            Note: This will replace any existing grid sequence for that slot.
+            \param[in] slot Grid slot.
+            \param[in] path Directory containing grid files. Can also include a full path or relative path from a data directory.
+            \param[in] gridname Name of the grid to load.
+            \param[in] options Streaming options.
+            \return Returns the length of the sequence.
+        */
+        uint32_t streamGridSequence(GridSlot slot, const std::filesystem::path& path, const std::string& gridname, const GridSequenceStreamer::Options& options = {});
+
+        /** Get the streamer of a grid slot.
+            \return The streamer, or nullptr if the grid sequence of the slot is not streamed.
+        */
+        const GridSequenceStreamer* getGridSequenceStreamer(GridSlot slot) const;
+
         /** Set the grid sequence for the specified slot.
         */
         void setGridSequence(GridSlot slot, const GridSequence& grids);
@@ -164,6 +195,7 @@ namespace Falcor
         const ref<Grid>& getGrid(GridSlot slot) const;
 
         /** Get a list of all grids used for this volume.
+            Grids of streamed sequences are not included as they are loaded on demand.
         */
         std::vector<ref<Grid>> getAllGrids() const;
 
@@ -283,7 +315,17 @@ namespace Falcor
         void updateFromAnimation(const float4x4& transform) override;
 
     private:
+        struct StreamedSequence
+        {
+            std::vector<std::filesystem::path> paths;
+            std::string gridname;
+            GridSequenceStreamer::Options options;
+            std::unique_ptr<GridSequenceStreamer> pStreamer;
+            ref<Grid> pGrid;    ///< Grid of the current frame.
+        };
+
         void updateSequence();
+        void updateStreamedGrids();
         void updateBounds();
 
         void markUpdates(UpdateFlags updates);
@@ -292,6 +334,7 @@ namespace Falcor
         ref<Device> mpDevice;
         std::string mName;
         std::array<GridSequence, (size_t)GridSlot::Count> mGrids;
+        std::array<StreamedSequence, (size_t)GridSlot::Count> mStreamedGrids;
         uint32_t mGridFrame = 0;
         uint32_t mGridFrameCount = 1;
         double mFrameRate = 30.f;
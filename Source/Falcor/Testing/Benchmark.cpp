@@ -0,0 +1,256 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Benchmark.h"
+#include "Core/Error.h"
+#include "Utils/StringFormatters.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+#include <unordered_map>
+
+namespace Falcor
+{
+namespace unittest
+{
+namespace
+{
+const uint32_t kReportVersion = 1;
+
+std::string getKey(const std::string& suiteName, const std::string& name)
+{
+    return suiteName + ":" + name;
+}
+
+std::string getKey(const BenchmarkResult& result, const BenchmarkMeasurement& measurement)
+{
+    return getKey(result.suiteName, result.name) + "/" + measurement.name;
+}
+
+nlohmann::json statsToJson(const BenchmarkStats& stats)
+{
+    return {
+        {"samples", stats.sampleCount},
+        {"minMS", stats.minMS},
+        {"medianMS", stats.medianMS},
+        {"p95MS", stats.p95MS},
+        {"maxMS", stats.maxMS},
+        {"meanMS", stats.meanMS},
+        {"stdDevMS", stats.stdDevMS},
+    };
+}
+} // namespace
+
+BenchmarkStats BenchmarkStats::compute(std::vector<double> samplesMS)
+{
+    BenchmarkStats stats;
+    if (samplesMS.empty())
+        return stats;
+
+    std::sort(samplesMS.begin(), samplesMS.end());
+    size_t n = samplesMS.size();
+
+    stats.sampleCount = (uint32_t)n;
+    stats.minMS = samplesMS.front();
+    stats.maxMS = samplesMS.back();
+    stats.medianMS = n % 2 == 1 ? samplesMS[n / 2] : 0.5 * (samplesMS[n / 2 - 1] + samplesMS[n / 2]);
+    stats.p95MS = samplesMS[(size_t)std::ceil(0.95 * n) - 1];
+    stats.meanMS = std::accumulate(samplesMS.begin(), samplesMS.end(), 0.0) / n;
+
+    double variance = 0.0;
+    for (double sample : samplesMS)
+        variance += (sample - stats.meanMS) * (sample - stats.meanMS);
+    stats.stdDevMS = n > 1 ? std::sqrt(variance / (n - 1)) : 0.0;
+
+    return stats;
+}
+
+std::map<std::string, double> BenchmarkMeasurement::getThroughput() const
+{
+    std::map<std::string, double> throughput;
+    double medianMS = BenchmarkStats::compute(samplesMS).medianMS;
+    if (medianMS <= 0.0)
+        return throughput;
+    for (const auto& [unit, count] : counters)
+        throughput[unit + "/s"] = count * 1000.0 / medianMS;
+    return throughput;
+}
+
+void BenchmarkReport::add(const BenchmarkResult& result)
+{
+    auto it = std::find_if(
+        results.begin(),
+        results.end(),
+        [&](const BenchmarkResult& r) { return r.suiteName == result.suiteName && r.name == result.name; }
+    );
+    if (it == results.end())
+    {
+        results.push_back(result);
+        return;
+    }
+
+    for (const auto& measurement : result.measurements)
+    {
+        auto m = std::find_if(
+            it->measurements.begin(),
+            it->measurements.end(),
+            [&](const BenchmarkMeasurement& m) { return m.name == measurement.name; }
+        );
+        if (m == it->measurements.end())
+        {
+            it->measurements.push_back(measurement);
+            continue;
+        }
+        m->samplesMS.insert(m->samplesMS.end(), measurement.samplesMS.begin(), measurement.samplesMS.end());
+        m->gpuSamplesMS.insert(m->gpuSamplesMS.end(), measurement.gpuSamplesMS.begin(), measurement.gpuSamplesMS.end());
+    }
+}
+
+void BenchmarkReport::writeToFile(const std::filesystem::path& path) const
+{
+    nlohmann::json benchmarks = nlohmann::json::array();
+    for (const auto& result : results)
+    {
+        nlohmann::json measurements = nlohmann::json::array();
+        for (const auto& measurement : result.measurements)
+        {
+            nlohmann::json jm = {
+                {"name", measurement.name},
+                {"time", statsToJson(BenchmarkStats::compute(measurement.samplesMS))},
+                {"samplesMS", measurement.samplesMS},
+            };
+            if (!measurement.gpuSamplesMS.empty())
+            {
+                jm["gpuTime"] = statsToJson(BenchmarkStats::compute(measurement.gpuSamplesMS));
+                jm["gpuSamplesMS"] = measurement.gpuSamplesMS;
+            }
+            if (!measurement.counters.empty())
+            {
+                jm["counters"] = measurement.counters;
+                jm["throughput"] = measurement.getThroughput();
+            }
+            measurements.push_back(std::move(jm));
+        }
+        benchmarks.push_back({{"suite", result.suiteName}, {"name", result.name}, {"measurements", std::move(measurements)}});
+    }
+
+    nlohmann::json report = {
+        {"version", kReportVersion},
+        {"metadata", metadata},
+        {"benchmarks", std::move(benchmarks)},
+    };
+
+    std::ofstream ofs(path);
+    if (!ofs)
+        FALCOR_THROW("Failed to open benchmark report '{}' for writing.", path);
+    ofs << report.dump(2) << std::endl;
+}
+
+BenchmarkReport BenchmarkReport::readFromFile(const std::filesystem::path& path)
+{
+    std::ifstream ifs(path);
+    if (!ifs)
+        FALCOR_THROW("Failed to open benchmark report '{}'.", path);
+
+    BenchmarkReport report;
+    try
+    {
+        nlohmann::json json = nlohmann::json::parse(ifs);
+        if (json.at("version").get<uint32_t>() != kReportVersion)
+            FALCOR_THROW("Unsupported benchmark report version.");
+
+        report.metadata = json.value("metadata", std::map<std::string, std::string>());
+        for (const auto& jb : json.at("benchmarks"))
+        {
+            BenchmarkResult result;
+            result.suiteName = jb.at("suite").get<std::string>();
+            result.name = jb.at("name").get<std::string>();
+            for (const auto& jm : jb.at("measurements"))
+            {
+                BenchmarkMeasurement measurement;
+                measurement.name = jm.at("name").get<std::string>();
+                measurement.samplesMS = jm.at("samplesMS").get<std::vector<double>>();
+                measurement.gpuSamplesMS = jm.value("gpuSamplesMS", std::vector<double>());
+                measurement.counters = jm.value("counters", BenchmarkCounters());
+                result.measurements.push_back(std::move(measurement));
+            }
+            report.results.push_back(std::move(result));
+        }
+    }
+    catch (const nlohmann::json::exception& e)
+    {
+        FALCOR_THROW("Failed to parse benchmark report '{}': {}", path, e.what());
+    }
+
+    return report;
+}
+
+std::vector<BenchmarkComparison> compareBenchmarks(
+    const BenchmarkReport& current,
+    const BenchmarkReport& baseline,
+    const BenchmarkCompareOptions& options
+)
+{
+    std::unordered_map<std::string, double> baselineMedians;
+    for (const auto& result : baseline.results)
+        for (const auto& measurement : result.measurements)
+            baselineMedians[getKey(result, measurement)] = BenchmarkStats::compute(measurement.samplesMS).medianMS;
+
+    std::vector<BenchmarkComparison> comparisons;
+    for (const auto& result : current.results)
+    {
+        for (const auto& measurement : result.measurements)
+        {
+            BenchmarkComparison comparison;
+            comparison.key = getKey(result, measurement);
+
+            auto it = baselineMedians.find(comparison.key);
+            if (it == baselineMedians.end() || measurement.samplesMS.empty())
+                continue;
+
+            comparison.baselineMS = it->second;
+            comparison.currentMS = BenchmarkStats::compute(measurement.samplesMS).medianMS;
+            double deltaMS = comparison.currentMS - comparison.baselineMS;
+            comparison.regressed = deltaMS > options.minDeltaMS && deltaMS > options.threshold * comparison.baselineMS;
+            comparisons.push_back(std::move(comparison));
+        }
+    }
+
+    return comparisons;
+}
+
+void BenchmarkRecorder::add(BenchmarkMeasurement measurement)
+{
+    for (const auto& m : mMeasurements)
+        FALCOR_CHECK(m.name != measurement.name, "Benchmark measurement '{}' already exists.", measurement.name);
+    mMeasurements.push_back(std::move(measurement));
+}
+
+} // namespace unittest
+} // namespace Falcor
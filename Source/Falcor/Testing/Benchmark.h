@@ -0,0 +1,164 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * This file defines the data types used for benchmarking in the unit testing framework:
+ * timing statistics, machine-readable reports and comparison against a baseline report.
+ * See CPU_BENCHMARK/GPU_BENCHMARK in UnitTest.h for the user-facing API.
+ */
+
+namespace Falcor
+{
+namespace unittest
+{
+
+/// Number of work units processed per iteration (e.g. {"triangles", 1e6}), reported as throughput per second.
+using BenchmarkCounters = std::map<std::string, double>;
+
+/// Settings for running benchmarks.
+struct BenchmarkOptions
+{
+    uint32_t warmup = 1;       ///< Number of untimed iterations before measuring.
+    uint32_t repetitions = 10; ///< Number of timed iterations.
+};
+
+/// Statistics of a series of timing samples.
+struct BenchmarkStats
+{
+    uint32_t sampleCount = 0;
+    double minMS = 0.0;
+    double medianMS = 0.0;
+    double p95MS = 0.0; ///< 95th percentile (nearest rank).
+    double maxMS = 0.0;
+    double meanMS = 0.0;
+    double stdDevMS = 0.0;
+
+    /// Compute statistics of a list of samples in milliseconds.
+    static BenchmarkStats compute(std::vector<double> samplesMS);
+};
+
+/// A single timed operation of a benchmark.
+struct BenchmarkMeasurement
+{
+    std::string name;                  ///< Name, unique within the benchmark.
+    std::vector<double> samplesMS;     ///< Wall-clock time of each iteration.
+    std::vector<double> gpuSamplesMS;  ///< GPU time of each iteration (GPU benchmarks only).
+    BenchmarkCounters counters;        ///< Work units processed per iteration.
+
+    /// Throughput in units per second based on the median iteration time.
+    std::map<std::string, double> getThroughput() const;
+};
+
+/// Measurements of a single benchmark.
+struct BenchmarkResult
+{
+    std::string suiteName;
+    std::string name;
+    std::vector<BenchmarkMeasurement> measurements;
+};
+
+/// A set of benchmark results.
+struct BenchmarkReport
+{
+    std::map<std::string, std::string> metadata; ///< Information about the run (version, settings, ...).
+    std::vector<BenchmarkResult> results;
+
+    /// Add the measurements of a benchmark. Measurements of repeated runs of the same benchmark are merged.
+    void add(const BenchmarkResult& result);
+
+    /// Write the report as JSON.
+    void writeToFile(const std::filesystem::path& path) const;
+
+    /// Read a report written by writeToFile(). Throws on error.
+    static BenchmarkReport readFromFile(const std::filesystem::path& path);
+};
+
+/// Comparison of a measurement against the baseline.
+struct BenchmarkComparison
+{
+    std::string key; ///< "suite:benchmark/measurement".
+    double baselineMS = 0.0;
+    double currentMS = 0.0;
+    bool regressed = false;
+
+    /// Relative change of the median time, positive values are slower.
+    double getChange() const { return baselineMS > 0.0 ? currentMS / baselineMS - 1.0 : 0.0; }
+};
+
+/// Settings for comparing benchmarks against a baseline.
+struct BenchmarkCompareOptions
+{
+    double threshold = 0.1;   ///< Relative increase of the median time that is considered a regression.
+    double minDeltaMS = 0.05; ///< Absolute increase below which a change is considered noise.
+};
+
+/**
+ * Compare the median times of a report against a baseline report.
+ * Measurements that are not present in both reports are ignored.
+ * @param[in] current The current results.
+ * @param[in] baseline The baseline results.
+ * @param[in] options Comparison settings.
+ * @return List of comparisons, in the order of the current report.
+ */
+FALCOR_API std::vector<BenchmarkComparison> compareBenchmarks(
+    const BenchmarkReport& current,
+    const BenchmarkReport& baseline,
+    const BenchmarkCompareOptions& options
+);
+
+/**
+ * Records the measurements of a benchmark.
+ * The benchmark contexts time the iterations and add the samples here.
+ */
+class FALCOR_API BenchmarkRecorder
+{
+public:
+    BenchmarkRecorder(const BenchmarkOptions& options) : mOptions(options) {}
+
+    const BenchmarkOptions& getOptions() const { return mOptions; }
+
+    /// Add a measurement. Throws if a measurement with the same name exists.
+    void add(BenchmarkMeasurement measurement);
+
+    const std::vector<BenchmarkMeasurement>& getMeasurements() const { return mMeasurements; }
+
+private:
+    BenchmarkOptions mOptions;
+    std::vector<BenchmarkMeasurement> mMeasurements;
+};
+
+} // namespace unittest
+} // namespace Falcor
@@ -30,6 +30,7 @@
 #include "Core/Platform/OS.h"
 #include "Core/API/Device.h"
 #include "Core/API/RenderContext.h"
+#include "Core/API/GpuTimer.h"
 #include "Core/Program/ProgramManager.h"
 #include "Utils/Scripting/Scripting.h"
 #include "Utils/Threading.h"
@@ -38,6 +39,7 @@
 #include "Utils/Logger.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Math/Vector.h"
+#include "Utils/Timing/CpuTimer.h"
 
 #include <fmt/format.h>
 #include <fmt/color.h>
@@ -61,6 +63,8 @@ struct TestDesc
     unittest::Options options;
     CPUTestFunc cpuFunc;
     GPUTestFunc gpuFunc;
+    CPUBenchmarkFunc cpuBenchmarkFunc;
+    GPUBenchmarkFunc gpuBenchmarkFunc;
 };
 
 struct TestResult
@@ -76,6 +80,7 @@ struct TestResult
     std::vector<std::string> messages;
     std::string extraMessage;
     uint64_t elapsedMS = 0;
+    std::vector<BenchmarkMeasurement> measurements; ///< Benchmark measurements (benchmarks only).
 };
 
 static std::vector<TestDesc>& getTestRegistry()
@@ -143,6 +148,26 @@ void registerGPUTest(std::filesystem::path path, std::string name, unittest::Opt
     getTestRegistry().push_back(desc);
 }
 
+void registerCPUBenchmark(std::filesystem::path path, std::string name, unittest::Options options, CPUBenchmarkFunc func)
+{
+    TestDesc desc;
+    desc.path = std::move(path);
+    desc.name = std::move(name);
+    desc.options = std::move(options);
+    desc.cpuBenchmarkFunc = std::move(func);
+    getTestRegistry().push_back(desc);
+}
+
+void registerGPUBenchmark(std::filesystem::path path, std::string name, unittest::Options options, GPUBenchmarkFunc func)
+{
+    TestDesc desc;
+    desc.path = std::move(path);
+    desc.name = std::move(name);
+    desc.options = std::move(options);
+    desc.gpuBenchmarkFunc = std::move(func);
+    getTestRegistry().push_back(desc);
+}
+
 /// Prints the UnitTest report line, making sure it is always printed to the console once.
 template<typename... Args>
 void reportLine(const std::string_view format, Args&&... args)
@@ -211,7 +236,7 @@ inline void writeXmlReport(const std::filesystem::path& path, const std::vector<
     doc.save_file(path.native().c_str());
 }
 
-inline TestResult runTest(const Test& test, DevicePool& devicePool)
+inline TestResult runTest(const Test& test, DevicePool& devicePool, const BenchmarkOptions& benchmarkOptions)
 {
     if (!test.skipMessage.empty())
         return {TestResult::Status::Skipped, {test.skipMessage}};
@@ -228,16 +253,31 @@ inline TestResult runTest(const Test& test, DevicePool& devicePool)
             test.cpuFunc(cpuCtx);
             result.messages = cpuCtx.getFailureMessages();
         }
-        else if (test.gpuFunc)
+        else if (test.cpuBenchmarkFunc)
+        {
+            CPUBenchmarkContext cpuCtx(benchmarkOptions);
+            test.cpuBenchmarkFunc(cpuCtx);
+            result.messages = cpuCtx.getFailureMessages();
+            result.measurements = cpuCtx.getRecorder().getMeasurements();
+        }
+        else if (test.isGPU())
         {
             ref<Device> pDevice;
             pDevice = devicePool.acquireDevice(test.deviceType);
 
+            if (test.gpuFunc)
             {
                 GPUUnitTestContext gpuCtx(pDevice);
                 test.gpuFunc(gpuCtx);
                 result.messages = gpuCtx.getFailureMessages();
             }
+            else
+            {
+                GPUBenchmarkContext gpuCtx(pDevice, benchmarkOptions);
+                test.gpuBenchmarkFunc(gpuCtx);
+                result.messages = gpuCtx.getFailureMessages();
+                result.measurements = gpuCtx.getRecorder().getMeasurements();
+            }
 
             pDevice->endFrame();
             pDevice->wait();
@@ -282,6 +322,92 @@ inline TestResult runTest(const Test& test, DevicePool& devicePool)
     return result;
 }
 
+inline BenchmarkOptions getBenchmarkOptions(const RunOptions& options)
+{
+    if (options.benchmark)
+        return options.benchmarkOptions;
+
+    // Run a single iteration to check that the benchmarks work.
+    BenchmarkOptions smokeOptions;
+    smokeOptions.warmup = 0;
+    smokeOptions.repetitions = 1;
+    return smokeOptions;
+}
+
+inline void reportBenchmarkMeasurements(const Test& test, const TestResult& result)
+{
+    for (const auto& measurement : result.measurements)
+    {
+        BenchmarkStats stats = BenchmarkStats::compute(measurement.samplesMS);
+        std::string line = fmt::format(
+            "[  BENCH   ] {}:{} / {}: median {:.3f} ms, min {:.3f} ms, p95 {:.3f} ms ({} sample{})",
+            test.suiteName,
+            test.name,
+            measurement.name,
+            stats.medianMS,
+            stats.minMS,
+            stats.p95MS,
+            stats.sampleCount,
+            plural(stats.sampleCount, "s")
+        );
+        if (!measurement.gpuSamplesMS.empty())
+            line += fmt::format(", GPU median {:.3f} ms", BenchmarkStats::compute(measurement.gpuSamplesMS).medianMS);
+        for (const auto& [unit, value] : measurement.getThroughput())
+            line += fmt::format(", {:.4g} {}", value, unit);
+        reportLine("{}", line);
+    }
+}
+
+/**
+ * Write the benchmark report and compare against the baseline.
+ * @return Number of regressed measurements.
+ */
+inline int32_t finishBenchmarks(const RunOptions& options, const std::vector<std::pair<Test, TestResult>>& report)
+{
+    if (!options.benchmark)
+        return 0;
+
+    BenchmarkReport benchmarkReport;
+    benchmarkReport.metadata["falcorVersion"] = getLongVersionString();
+    benchmarkReport.metadata["warmup"] = std::to_string(options.benchmarkOptions.warmup);
+    benchmarkReport.metadata["repetitions"] = std::to_string(options.benchmarkOptions.repetitions);
+    benchmarkReport.metadata["parallel"] = std::to_string(options.parallel);
+
+    for (const auto& [test, result] : report)
+    {
+        if (test.isBenchmark() && result.status == TestResult::Status::Passed)
+            benchmarkReport.add({test.suiteName, test.name, result.measurements});
+    }
+
+    if (!options.benchmarkReportPath.empty())
+        benchmarkReport.writeToFile(options.benchmarkReportPath);
+
+    if (options.benchmarkBaselinePath.empty())
+        return 0;
+
+    BenchmarkReport baseline = BenchmarkReport::readFromFile(options.benchmarkBaselinePath);
+    std::vector<BenchmarkComparison> comparisons = compareBenchmarks(benchmarkReport, baseline, options.benchmarkCompareOptions);
+
+    int32_t regressionCount = 0;
+    reportLine("[----------] Comparing {} benchmark measurement{} against baseline", comparisons.size(), plural(comparisons.size(), "s"));
+    for (const auto& comparison : comparisons)
+    {
+        reportLine(
+            "{} {}: {:.3f} ms (baseline {:.3f} ms, {:+.1f}%)",
+            comparison.regressed ? "[ REGRESS  ]" : "[       OK ]",
+            comparison.key,
+            comparison.currentMS,
+            comparison.baselineMS,
+            comparison.getChange() * 100.0
+        );
+        regressionCount += comparison.regressed ? 1 : 0;
+    }
+    if (regressionCount > 0)
+        reportLine("{} BENCHMARK REGRESSION{}", regressionCount, plural(regressionCount, "S"));
+
+    return regressionCount;
+}
+
 inline int32_t runTestsParallel(const RunOptions& options)
 {
     // Abort on Ctrl-C.
@@ -305,13 +431,16 @@ inline int32_t runTestsParallel(const RunOptions& options)
     std::vector<TestResult> results(tests.size());
 
     BS::thread_pool_light threadPool(options.parallel);
+    BenchmarkOptions benchmarkOptions = getBenchmarkOptions(options);
 
     reportLine("[==========] Running {} test{}.", tests.size(), plural(tests.size(), "s"));
+    if (options.benchmark)
+        reportLine("[ WARNING  ] Benchmarks run concurrently with other tests, timings may be unreliable.");
 
     for (size_t testIndex = 0; testIndex < tests.size(); ++testIndex)
     {
         threadPool.push_task(
-            [&abort, &tests, &results, &devicePool, testIndex]()
+            [&abort, &tests, &results, &devicePool, &benchmarkOptions, testIndex]()
             {
                 if (abort)
                     return;
@@ -322,7 +451,7 @@ inline int32_t runTestsParallel(const RunOptions& options)
 
                 reportLine("[ RUN      ] {}:{}{}", test.suiteName, test.name, repeats);
 
-                result = runTest(test, devicePool);
+                result = runTest(test, devicePool, benchmarkOptions);
 
                 std::string statusTag;
                 switch (result.status)
@@ -339,6 +468,7 @@ inline int32_t runTestsParallel(const RunOptions& options)
                 }
                 if (!result.extraMessage.empty())
                     reportLine("{}", result.extraMessage);
+                reportBenchmarkMeasurements(test, result);
                 reportLine("{} {}:{}{} ({} ms)", statusTag, test.suiteName, test.name, repeats, result.elapsedMS);
             }
         );
@@ -359,6 +489,11 @@ inline int32_t runTestsParallel(const RunOptions& options)
     for (const auto& result : results)
         failureCount += result.status == TestResult::Status::Failed ? 1 : 0;
 
+    std::vector<std::pair<Test, TestResult>> report;
+    for (size_t i = 0; i < tests.size(); ++i)
+        report.emplace_back(tests[i], results[i]);
+    int32_t regressionCount = finishBenchmarks(options, report);
+
     reportLine("[==========] {} test{} ran. ({} ms total)", tests.size(), plural(tests.size(), "s"), totalMS);
     reportLine("[  PASSED  ] {} test{}.", tests.size() - failureCount, plural(tests.size() - failureCount, "s"));
     if (failureCount > 0)
@@ -371,7 +506,7 @@ inline int32_t runTestsParallel(const RunOptions& options)
         reportLine("{} FAILED TEST{}", failureCount, plural(failureCount, "S"));
     }
 
-    return failureCount;
+    return failureCount + regressionCount;
 }
 
 inline int32_t runTestsSerial(const RunOptions& options)
@@ -401,6 +536,7 @@ inline int32_t runTestsSerial(const RunOptions& options)
 
     std::map<std::string, std::vector<Test>> failedTests;
     std::vector<std::pair<Test, TestResult>> report;
+    BenchmarkOptions benchmarkOptions = getBenchmarkOptions(options);
 
     size_t suiteCount = suites.size();
     size_t testCount = tests.size();
@@ -430,7 +566,7 @@ inline int32_t runTestsSerial(const RunOptions& options)
                 if (options.repeat > 1)
                     repeats = fmt::format("[{}/{}]", repeatIndex + 1, options.repeat);
                 reportLine("[ RUN      ] {}:{}{}", suiteName, test.name, repeats);
-                TestResult result = runTest(test, devicePool);
+                TestResult result = runTest(test, devicePool, benchmarkOptions);
                 report.emplace_back(test, result);
 
                 std::string statusTag;
@@ -448,6 +584,7 @@ inline int32_t runTestsSerial(const RunOptions& options)
                 }
                 if (!result.extraMessage.empty())
                     reportLine("{}", result.extraMessage);
+                reportBenchmarkMeasurements(test, result);
                 reportLine("{} {}:{}{} ({} ms)", statusTag, suiteName, test.name, repeats, result.elapsedMS);
                 suiteMS += result.elapsedMS;
                 if (success && result.status == TestResult::Status::Failed)
@@ -474,6 +611,8 @@ inline int32_t runTestsSerial(const RunOptions& options)
     if (!options.xmlReportPath.empty())
         writeXmlReport(options.xmlReportPath, report);
 
+    int32_t regressionCount = finishBenchmarks(options, report);
+
     reportLine(
         "[==========] {} test{} from {} test suite{} ran. ({} ms total)",
         testCount,
@@ -493,7 +632,7 @@ inline int32_t runTestsSerial(const RunOptions& options)
         reportLine("{} FAILED TEST{}", failureCount, plural(failureCount, "S"));
     }
 
-    return failureCount;
+    return failureCount + regressionCount;
 }
 
 int32_t runTests(const RunOptions& options)
@@ -531,12 +670,14 @@ std::vector<Test> enumerateTests()
         test.deviceType = Device::Type::Default;
         test.cpuFunc = desc.cpuFunc;
         test.gpuFunc = desc.gpuFunc;
+        test.cpuBenchmarkFunc = desc.cpuBenchmarkFunc;
+        test.gpuBenchmarkFunc = desc.gpuBenchmarkFunc;
 
-        if (test.cpuFunc)
+        if (!test.isGPU())
         {
             tests.push_back(test);
         }
-        else if (test.gpuFunc)
+        else
         {
 #if FALCOR_HAS_D3D12
             if (desc.options.deviceTypes.empty() || desc.options.deviceTypes.count(Device::Type::D3D12))
@@ -645,6 +786,62 @@ void UnitTestContext::reportFailure(const std::string& message)
 
 ///////////////////////////////////////////////////////////////////////////
 
+void CPUBenchmarkContext::measure(const std::string& name, const std::function<void()>& func, const BenchmarkCounters& counters)
+{
+    const BenchmarkOptions& options = mRecorder.getOptions();
+
+    BenchmarkMeasurement measurement;
+    measurement.name = name;
+    measurement.counters = counters;
+
+    for (uint32_t i = 0; i < options.warmup; ++i)
+        func();
+
+    for (uint32_t i = 0; i < options.repetitions; ++i)
+    {
+        auto startTime = CpuTimer::getCurrentTimePoint();
+        func();
+        measurement.samplesMS.push_back(CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint()));
+    }
+
+    mRecorder.add(std::move(measurement));
+}
+
+void GPUBenchmarkContext::measure(const std::string& name, const std::function<void()>& func, const BenchmarkCounters& counters)
+{
+    const BenchmarkOptions& options = mRecorder.getOptions();
+    RenderContext* pRenderContext = getRenderContext();
+    ref<GpuTimer> pTimer = GpuTimer::create(getDevice());
+
+    BenchmarkMeasurement measurement;
+    measurement.name = name;
+    measurement.counters = counters;
+
+    // Finish pending work so it is not included in the first iteration.
+    pRenderContext->submit(true);
+
+    for (uint32_t i = 0; i < options.warmup + options.repetitions; ++i)
+    {
+        auto startTime = CpuTimer::getCurrentTimePoint();
+        pTimer->begin();
+        func();
+        pTimer->end();
+        pTimer->resolve();
+        pRenderContext->submit(true);
+        double elapsedMS = CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint());
+
+        if (i >= options.warmup)
+        {
+            measurement.samplesMS.push_back(elapsedMS);
+            measurement.gpuSamplesMS.push_back(pTimer->getElapsedTime());
+        }
+    }
+
+    mRecorder.add(std::move(measurement));
+}
+
+///////////////////////////////////////////////////////////////////////////
+
 void GPUUnitTestContext::createProgram(
     const std::filesystem::path& path,
     const std::string& entry,
@@ -798,4 +995,77 @@ CPU_TEST(TestTags, TAGS("tag1", "tag2", "tag3"))
     EXPECT(true);
 }
 
+CPU_TEST(TestBenchmarkStats)
+{
+    unittest::BenchmarkStats stats = unittest::BenchmarkStats::compute({5.0, 1.0, 3.0, 2.0, 4.0});
+    EXPECT_EQ(stats.sampleCount, 5u);
+    EXPECT_EQ(stats.minMS, 1.0);
+    EXPECT_EQ(stats.maxMS, 5.0);
+    EXPECT_EQ(stats.medianMS, 3.0);
+    EXPECT_EQ(stats.p95MS, 5.0);
+    EXPECT_EQ(stats.meanMS, 3.0);
+
+    stats = unittest::BenchmarkStats::compute({4.0, 1.0, 2.0, 3.0});
+    EXPECT_EQ(stats.medianMS, 2.5);
+
+    std::vector<double> samples(100);
+    for (size_t i = 0; i < samples.size(); ++i)
+        samples[i] = double(100 - i);
+    EXPECT_EQ(unittest::BenchmarkStats::compute(samples).p95MS, 95.0);
+
+    EXPECT_EQ(unittest::BenchmarkStats::compute({}).sampleCount, 0u);
+}
+
+CPU_TEST(TestBenchmarkCompare)
+{
+    auto createReport = [](double fastMS, double slowMS)
+    {
+        unittest::BenchmarkReport report;
+        unittest::BenchmarkResult result{"Suite", "Bench", {}};
+        result.measurements.push_back({"fast", {fastMS, fastMS, fastMS}, {}, {}});
+        result.measurements.push_back({"slow", {slowMS, slowMS, slowMS}, {}, {{"items", 1000.0}}});
+        report.add(result);
+        return report;
+    };
+
+    unittest::BenchmarkReport baseline = createReport(0.01, 100.0);
+    unittest::BenchmarkCompareOptions options;
+    options.threshold = 0.1;
+    options.minDeltaMS = 0.05;
+
+    // Within threshold.
+    auto comparisons = compareBenchmarks(createReport(0.01, 105.0), baseline, options);
+    ASSERT_EQ(comparisons.size(), 2u);
+    EXPECT(!comparisons[0].regressed);
+    EXPECT(!comparisons[1].regressed);
+    EXPECT_EQ(comparisons[1].key, "Suite:Bench/slow");
+
+    // Relative regression, the small absolute change of the fast measurement is considered noise.
+    comparisons = compareBenchmarks(createReport(0.02, 120.0), baseline, options);
+    EXPECT(!comparisons[0].regressed);
+    EXPECT(comparisons[1].regressed);
+    EXPECT_GT(comparisons[1].getChange(), 0.19);
+
+    // Repeated results are merged.
+    unittest::BenchmarkReport merged = createReport(1.0, 2.0);
+    merged.add(createReport(3.0, 4.0).results[0]);
+    ASSERT_EQ(merged.results.size(), 1u);
+    EXPECT_EQ(merged.results[0].measurements[0].samplesMS.size(), 6u);
+
+    // Throughput is based on the median time.
+    auto throughput = baseline.results[0].measurements[1].getThroughput();
+    EXPECT_EQ(throughput["items/s"], 10000.0);
+}
+
+CPU_BENCHMARK(TestCPUBenchmark)
+{
+    uint32_t count = 0;
+    ctx.measure("increment", [&]() { ++count; }, {{"increments", 1.0}});
+    const auto& measurements = ctx.getRecorder().getMeasurements();
+    ASSERT_EQ(measurements.size(), 1u);
+    EXPECT_EQ(measurements[0].samplesMS.size(), ctx.getRecorder().getOptions().repetitions);
+    EXPECT_EQ(count, ctx.getRecorder().getOptions().warmup + ctx.getRecorder().getOptions().repetitions);
+    EXPECT_THROW(ctx.measure("increment", [&]() {}));
+}
+
 } // namespace Falcor
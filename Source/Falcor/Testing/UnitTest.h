@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #pragma once
+#include "Benchmark.h"
 #include "Core/Error.h"
 #include "Core/State/ComputeState.h"
 #include "Core/Program/Program.h"
@@ -93,15 +94,26 @@ struct RunOptions
     std::filesystem::path xmlReportPath;
     uint32_t parallel = 1;
     uint32_t repeat = 1;
+
+    /// Run benchmarks with full warm-up and repetitions. Otherwise each benchmark runs a single iteration to check it works.
+    bool benchmark = false;
+    BenchmarkOptions benchmarkOptions;
+    BenchmarkCompareOptions benchmarkCompareOptions;
+    std::filesystem::path benchmarkReportPath;   ///< Benchmark JSON report output file.
+    std::filesystem::path benchmarkBaselinePath; ///< Benchmark JSON report to compare against.
 };
 
 FALCOR_API int32_t runTests(const RunOptions& options);
 
 class CPUUnitTestContext;
 class GPUUnitTestContext;
+class CPUBenchmarkContext;
+class GPUBenchmarkContext;
 
 using CPUTestFunc = std::function<void(CPUUnitTestContext& ctx)>;
 using GPUTestFunc = std::function<void(GPUUnitTestContext& ctx)>;
+using CPUBenchmarkFunc = std::function<void(CPUBenchmarkContext& ctx)>;
+using GPUBenchmarkFunc = std::function<void(GPUBenchmarkContext& ctx)>;
 
 struct Test
 {
@@ -113,6 +125,11 @@ struct Test
 
     CPUTestFunc cpuFunc;
     GPUTestFunc gpuFunc;
+    CPUBenchmarkFunc cpuBenchmarkFunc;
+    GPUBenchmarkFunc gpuBenchmarkFunc;
+
+    bool isBenchmark() const { return cpuBenchmarkFunc || gpuBenchmarkFunc; }
+    bool isGPU() const { return gpuFunc || gpuBenchmarkFunc; }
 };
 
 /// Enumerate all tests.
@@ -279,6 +296,55 @@ private:
     std::map<std::string, ref<Buffer>> mStructuredBuffers;
 };
 
+/**
+ * Context for CPU benchmarks.
+ * The benchmark sets up its data and calls measure() for each operation to time.
+ * The test macros can be used to validate the results.
+ */
+class FALCOR_API CPUBenchmarkContext : public CPUUnitTestContext
+{
+public:
+    CPUBenchmarkContext(const BenchmarkOptions& options) : mRecorder(options) {}
+
+    /**
+     * Measure the wall-clock time of a function.
+     * The function is called for the warm-up iterations followed by the timed iterations.
+     * @param[in] name Measurement name, unique within the benchmark.
+     * @param[in] func Function to measure.
+     * @param[in] counters Work units processed per call, reported as throughput.
+     */
+    void measure(const std::string& name, const std::function<void()>& func, const BenchmarkCounters& counters = {});
+
+    const BenchmarkRecorder& getRecorder() const { return mRecorder; }
+
+private:
+    BenchmarkRecorder mRecorder;
+};
+
+/**
+ * Context for GPU benchmarks.
+ * In addition to the wall-clock time, the GPU time of the work recorded on the render context is measured.
+ */
+class FALCOR_API GPUBenchmarkContext : public GPUUnitTestContext
+{
+public:
+    GPUBenchmarkContext(ref<Device> pDevice, const BenchmarkOptions& options) : GPUUnitTestContext(pDevice), mRecorder(options) {}
+
+    /**
+     * Measure the wall-clock and GPU time of a function.
+     * Each iteration is submitted and waited for, so the wall-clock time includes the GPU execution.
+     * @param[in] name Measurement name, unique within the benchmark.
+     * @param[in] func Function to measure, recording GPU work on the render context.
+     * @param[in] counters Work units processed per call, reported as throughput.
+     */
+    void measure(const std::string& name, const std::function<void()>& func, const BenchmarkCounters& counters = {});
+
+    const BenchmarkRecorder& getRecorder() const { return mRecorder; }
+
+private:
+    BenchmarkRecorder mRecorder;
+};
+
 struct Tags
 {
     Tags(std::string tag) { tags.push_back(std::move(tag)); }
@@ -351,6 +417,8 @@ void applyArgs(Options& options, Args&&... args)
 
 FALCOR_API void registerCPUTest(std::filesystem::path path, std::string name, unittest::Options options, CPUTestFunc func);
 FALCOR_API void registerGPUTest(std::filesystem::path path, std::string name, unittest::Options options, GPUTestFunc func);
+FALCOR_API void registerCPUBenchmark(std::filesystem::path path, std::string name, unittest::Options options, CPUBenchmarkFunc func);
+FALCOR_API void registerGPUBenchmark(std::filesystem::path path, std::string name, unittest::Options options, GPUBenchmarkFunc func);
 
 /**
  * StreamSink is a utility class used by the testing framework that either
@@ -533,6 +601,9 @@ inline std::optional<std::string> createBinaryMessage(std::string_view lhsStr, s
 using UnitTestContext = unittest::UnitTestContext;
 using CPUUnitTestContext = unittest::CPUUnitTestContext;
 using GPUUnitTestContext = unittest::GPUUnitTestContext;
+using CPUBenchmarkContext = unittest::CPUBenchmarkContext;
+using GPUBenchmarkContext = unittest::GPUBenchmarkContext;
+using BenchmarkCounters = unittest::BenchmarkCounters;
 
 /**
  * Macro to define a CPU unit test. The optional arguments include:
@@ -609,6 +680,57 @@ using GPUUnitTestContext = unittest::GPUUnitTestContext;
     } RegisterGPUTest##name;                                                    \
     static void GPUUnitTest##name(GPUUnitTestContext& ctx) /* over to the user for the braces */
 
+/**
+ * Macro to define a CPU benchmark. Takes the same optional arguments as CPU_TEST.
+ * The body sets up the benchmark and calls ctx.measure() for each operation to time:
+ *
+ * CPU_BENCHMARK(Bench1)
+ * {
+ *     std::vector<float> data = createData();
+ *     ctx.measure("sort", [&]() { sortData(data); }, {{"elements", double(data.size())}});
+ * }
+ *
+ * Benchmarks are regular tests and can use the test macros to validate their results.
+ * Unless FalcorTest is run with --benchmark, each measurement runs a single iteration.
+ *
+ * Note: All CPU benchmarks are implicitly tagged with "cpu" and "benchmark".
+ */
+#define CPU_BENCHMARK(name, ...)                                                      \
+    static void CPUBenchmark##name(CPUBenchmarkContext& ctx);                         \
+    struct CPUBenchmarkRegisterer##name                                               \
+    {                                                                                 \
+        CPUBenchmarkRegisterer##name()                                                \
+        {                                                                             \
+            std::filesystem::path path = __FILE__;                                    \
+            unittest::Options options;                                                \
+            applyArgs(options, ##__VA_ARGS__);                                        \
+            options.tags.insert({"cpu", "benchmark"});                                \
+            unittest::registerCPUBenchmark(path, #name, options, CPUBenchmark##name); \
+        }                                                                             \
+    } RegisterCPUBenchmark##name;                                                     \
+    static void CPUBenchmark##name(CPUBenchmarkContext& ctx) /* over to the user for the braces */
+
+/**
+ * Macro to define a GPU benchmark. Takes the same optional arguments as GPU_TEST.
+ * Work recorded on the render context inside ctx.measure() is submitted and timed on the GPU.
+ *
+ * Note: All GPU benchmarks are implicitly tagged with "gpu" and "benchmark".
+ */
+#define GPU_BENCHMARK(name, ...)                                                      \
+    static void GPUBenchmark##name(GPUBenchmarkContext& ctx);                         \
+    struct GPUBenchmarkRegisterer##name                                               \
+    {                                                                                 \
+        GPUBenchmarkRegisterer##name()                                                \
+        {                                                                             \
+            std::filesystem::path path = __FILE__;                                    \
+            unittest::Options options;                                                \
+            applyArgs(options, ##__VA_ARGS__);                                        \
+            options.tags.insert({"gpu", "benchmark"});                                \
+            unittest::registerGPUBenchmark(path, #name, options, GPUBenchmark##name); \
+        }                                                                             \
+    } RegisterGPUBenchmark##name;                                                     \
+    static void GPUBenchmark##name(GPUBenchmarkContext& ctx) /* over to the user for the braces */
+
 // clang-format off
 
 /// Used as an argument of CPU_TEST/GPU_TEST to tag a test with a set of strings.
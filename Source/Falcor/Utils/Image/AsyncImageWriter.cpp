@@ -0,0 +1,113 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AsyncImageWriter.h"
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing/CpuTimer.h"
+
+namespace Falcor
+{
+AsyncImageWriter::AsyncImageWriter(const Options& options, WriteFunc writeFunc)
+    : mOptions(options)
+    , mWriteFunc(std::move(writeFunc))
+    , mWriter(
+          std::max(options.threadCount, 1u),
+          {
+              [this](Image& image) { mWriteFunc(image); },
+              [this](Image&, bool success)
+              {
+                  if (success)
+                      mWrittenCount++;
+                  else
+                      mFailedCount++;
+              },
+              [](const Image& image) { return fmt::format("write image '{}'", image.path); },
+          }
+      )
+{
+    FALCOR_CHECK(options.threadCount > 0, "Image writer requires at least one worker thread.");
+    FALCOR_CHECK(options.maxPendingImages > 0, "Image writer requires at least one pending image.");
+
+    if (!mWriteFunc)
+    {
+        mWriteFunc = [](const Image& image)
+        {
+            Bitmap::saveImage(
+                image.path,
+                image.width,
+                image.height,
+                image.fileFormat,
+                image.exportFlags,
+                image.resourceFormat,
+                true,
+                const_cast<uint8_t*>(image.data.data())
+            );
+        };
+    }
+}
+
+AsyncImageWriter::~AsyncImageWriter()
+{
+    flush();
+}
+
+void AsyncImageWriter::write(Image image)
+{
+    auto lock = mWriter.lock();
+    if (mWriter.getPendingCount(lock) >= mOptions.maxPendingImages)
+    {
+        auto startTime = CpuTimer::getCurrentTimePoint();
+        mWriter.wait(lock, [&]() { return mWriter.getPendingCount(lock) < mOptions.maxPendingImages; });
+        mStallTime += CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint());
+    }
+    mWriter.push(lock, std::move(image));
+}
+
+void AsyncImageWriter::flush()
+{
+    mWriter.flush();
+}
+
+uint32_t AsyncImageWriter::getPendingCount() const
+{
+    auto lock = mWriter.lock();
+    return mWriter.getPendingCount(lock);
+}
+
+uint64_t AsyncImageWriter::getWrittenCount() const
+{
+    auto lock = mWriter.lock();
+    return mWrittenCount;
+}
+
+uint64_t AsyncImageWriter::getFailedCount() const
+{
+    auto lock = mWriter.lock();
+    return mFailedCount;
+}
+} // namespace Falcor
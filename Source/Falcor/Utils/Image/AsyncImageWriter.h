@@ -0,0 +1,118 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Bitmap.h"
+#include "Core/Macros.h"
+#include "Core/API/Formats.h"
+#include "Utils/WorkerQueue.h"
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Encodes and writes images on a pool of worker threads.
+ *
+ * The number of pending images (queued or being encoded) is bounded. When the limit is reached,
+ * write() blocks until a worker has finished an image. This applies back-pressure to the producer,
+ * which keeps memory usage bounded when images are produced faster than they can be encoded.
+ *
+ * Errors while writing an image are logged and counted, they do not stop the writer.
+ * All functions must be called from the same thread.
+ */
+class FALCOR_API AsyncImageWriter
+{
+public:
+    struct Options
+    {
+        uint32_t threadCount = 4;      ///< Number of worker threads.
+        uint32_t maxPendingImages = 8; ///< Maximum number of images that are queued or being written.
+    };
+
+    /// Image to write, see Bitmap::saveImage() for a description of the fields.
+    struct Image
+    {
+        std::filesystem::path path;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        Bitmap::FileFormat fileFormat = Bitmap::FileFormat::PngFile;
+        Bitmap::ExportFlags exportFlags = Bitmap::ExportFlags::None;
+        ResourceFormat resourceFormat = ResourceFormat::Unknown;
+        std::vector<uint8_t> data; ///< Image data, top row first.
+    };
+
+    /// Function writing an image. Throws an exception on failure.
+    using WriteFunc = std::function<void(const Image&)>;
+
+    /**
+     * Constructor.
+     * @param[in] options Writer options.
+     * @param[in] writeFunc Function used to write images, defaults to Bitmap::saveImage().
+     */
+    AsyncImageWriter(const Options& options, WriteFunc writeFunc = {});
+
+    /// Waits for all pending images to be written.
+    ~AsyncImageWriter();
+
+    AsyncImageWriter(const AsyncImageWriter&) = delete;
+    AsyncImageWriter& operator=(const AsyncImageWriter&) = delete;
+
+    /**
+     * Queue an image for writing.
+     * Blocks while the maximum number of images is pending.
+     */
+    void write(Image image);
+
+    /// Wait for all pending images to be written.
+    void flush();
+
+    /// Number of images that are queued or being written.
+    uint32_t getPendingCount() const;
+
+    /// Number of images written successfully.
+    uint64_t getWrittenCount() const;
+
+    /// Number of images that failed to write.
+    uint64_t getFailedCount() const;
+
+    /// Total time in milliseconds write() spent waiting for workers.
+    double getStallTime() const { return mStallTime; }
+
+private:
+    Options mOptions;
+    WriteFunc mWriteFunc;
+    double mStallTime = 0.0;
+
+    // Guarded by the writer mutex.
+    uint64_t mWrittenCount = 0;
+    uint64_t mFailedCount = 0;
+    WorkerQueue<Image> mWriter; ///< Writes the images on the worker threads. Declared last to be destroyed first.
+};
+} // namespace Falcor
@@ -28,6 +28,7 @@
 #include "AsyncTextureLoader.h"
 #include "Core/API/Device.h"
 #include "Utils/Threading.h"
+#include "Utils/Timing/Profiler.h"
 
 namespace Falcor
 {
@@ -134,15 +135,19 @@ void AsyncTextureLoader::runWorker()
 
         // Load the textures (this part is running in parallel).
         ref<Texture> pTexture;
-        if (request.paths.size() == 1)
         {
-            pTexture = Texture::createFromFile(
-                mpDevice, request.paths[0], request.generateMipLevels, request.loadAsSRGB, request.bindFlags, request.importFlags
-            );
-        }
-        else
-        {
-            pTexture = Texture::createMippedFromFiles(mpDevice, request.paths, request.loadAsSRGB, request.bindFlags, request.importFlags);
+            FALCOR_PROFILE_CPU("AsyncTextureLoader::loadTexture");
+            if (request.paths.size() == 1)
+            {
+                pTexture = Texture::createFromFile(
+                    mpDevice, request.paths[0], request.generateMipLevels, request.loadAsSRGB, request.bindFlags, request.importFlags
+                );
+            }
+            else
+            {
+                pTexture =
+                    Texture::createMippedFromFiles(mpDevice, request.paths, request.loadAsSRGB, request.bindFlags, request.importFlags);
+            }
         }
 
         request.promise.set_value(pTexture);
@@ -28,10 +28,14 @@
 #include "TextureManager.h"
 #include "Core/AssetResolver.h"
 #include "Core/API/Device.h"
+#include "Core/API/RenderContext.h"
+#include "Core/Platform/OS.h"
 #include "Utils/Logger.h"
 #include "Utils/NumericRange.h"
 
 #include <execution>
+#include <fstream>
+#include <random>
 
 // Temporarily disable asynchronous texture loader until Falcor supports parallel GPU work submission.
 // Until then `TextureManager` should only called from the main thread.
@@ -43,6 +47,58 @@ namespace
 {
 const size_t kMaxTextureHandleCount = std::numeric_limits<uint32_t>::max();
 static_assert(TextureManager::CpuTextureHandle::kInvalidID >= kMaxTextureHandleCount);
+
+/// Version of the disk cache entries. Increment when the layout of cached textures changes.
+const uint32_t kDiskCacheVersion = 1;
+
+/// Size of the chunks read when hashing files.
+const size_t kFileHashChunkSize = 1 << 20;
+
+bool computeFileHash(const std::filesystem::path& path, SHA1::MD& hash)
+{
+    std::ifstream fs(path, std::ios_base::binary);
+    if (!fs)
+        return false;
+
+    SHA1 sha1;
+    std::vector<char> buffer(kFileHashChunkSize);
+    while (fs)
+    {
+        fs.read(buffer.data(), buffer.size());
+        sha1.update(buffer.data(), (size_t)fs.gcount());
+    }
+    if (fs.bad())
+        return false;
+
+    hash = sha1.finalize();
+    return true;
+}
+
+/**
+ * Returns the compression mode to use for caching a texture.
+ * Textures that can't be represented by the requested mode are cached without compression.
+ */
+ImageIO::CompressionMode getDiskCacheCompressionMode(const Texture* pTexture, ImageIO::CompressionMode mode)
+{
+    ResourceFormat format = pTexture->getFormat();
+    if (mode == ImageIO::CompressionMode::None || isCompressedFormat(format))
+        return ImageIO::CompressionMode::None;
+
+    // Block compression requires the base resolution to be a multiple of the block size.
+    if (pTexture->getWidth() % 4 != 0 || pTexture->getHeight() % 4 != 0)
+        return ImageIO::CompressionMode::None;
+
+    uint32_t channelCount = getFormatChannelCount(format);
+    bool isFloat = getFormatType(format) == FormatType::Float;
+    if (isFloat != (mode == ImageIO::CompressionMode::BC6))
+        return ImageIO::CompressionMode::None;
+    if ((channelCount == 2) != (mode == ImageIO::CompressionMode::BC5))
+        return ImageIO::CompressionMode::None;
+    if (mode == ImageIO::CompressionMode::BC4 && channelCount != 1)
+        return ImageIO::CompressionMode::None;
+
+    return mode;
+}
 } // namespace
 
 TextureManager::TextureManager(ref<Device> pDevice, size_t maxTextureCount, size_t threadCount)
@@ -51,6 +107,25 @@ TextureManager::TextureManager(ref<Device> pDevice, size_t maxTextureCount, size
 
 TextureManager::~TextureManager() {}
 
+void TextureManager::setContentDeduplication(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mUseContentDeduplication = enabled;
+}
+
+void TextureManager::setDiskCacheDirectory(const std::filesystem::path& path, ImageIO::CompressionMode compressionMode)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mDiskCacheDirectory = path;
+    mDiskCacheCompressionMode = compressionMode;
+}
+
+std::filesystem::path TextureManager::getDiskCacheDirectory() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mDiskCacheDirectory;
+}
+
 TextureManager::CpuTextureHandle TextureManager::addTexture(const ref<Texture>& pTexture)
 {
     FALCOR_ASSERT(pTexture);
@@ -259,14 +334,38 @@ TextureManager::CpuTextureHandle TextureManager::loadTexture(
         return handle;
     }
 
-    std::unique_lock<std::mutex> lock(mMutex);
     const TextureKey textureKey(paths, generateMipLevels, loadAsSRGB, bindFlags, importFlags);
 
+    // Hash the file contents to find identical textures loaded from other paths and to locate the disk cache entry.
+    // This reads the files, so it is done outside the critical section and only for textures that are not yet managed.
+    // With deferred loading, the files are hashed in parallel in endDeferredLoading() instead.
+    std::vector<ContentHash> fileHashes;
+    bool useFileHashes = false;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        useFileHashes = !mUseDeferredLoading && (mUseContentDeduplication || !mDiskCacheDirectory.empty()) &&
+                        mKeyToHandle.find(textureKey) == mKeyToHandle.end();
+    }
+    if (useFileHashes)
+        fileHashes = getFileHashes(paths);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    const bool useContentHash = mUseContentDeduplication && !fileHashes.empty();
+    const ContentHash contentHash = useContentHash ? getContentHash(textureKey, fileHashes) : ContentHash{};
+
     if (auto it = mKeyToHandle.find(textureKey); it != mKeyToHandle.end())
     {
         // Texture is already managed. Return its handle.
         handle = it->second;
     }
+    else if (auto contentIt = useContentHash ? mContentToHandle.find(contentHash) : mContentToHandle.end();
+             contentIt != mContentToHandle.end())
+    {
+        // Texture with identical content is already managed. Return its handle and add the key for subsequent loads.
+        handle = contentIt->second;
+        mKeyToHandle[textureKey] = handle;
+        mDeduplicatedCount++;
+    }
     else
     {
         if (mUseDeferredLoading)
@@ -290,8 +389,10 @@ TextureManager::CpuTextureHandle TextureManager::loadTexture(
         TextureDesc desc = {TextureState::Referenced, nullptr};
         handle = addDesc(desc);
 
-        // Add to key-to-handle map.
+        // Add to key-to-handle and content-to-handle maps.
         mKeyToHandle[textureKey] = handle;
+        if (useContentHash)
+            mContentToHandle[contentHash] = handle;
 
         // Function called by the async texture loader when loading finishes.
         // It's called by a worker thread so needs to acquire the mutex before changing any state.
@@ -313,6 +414,7 @@ TextureManager::CpuTextureHandle TextureManager::loadTexture(
         };
 
         // Issue load request to texture loader.
+        // Note: The disk cache is not used here, as writing cache entries requires the immediate render context.
         if (paths.size() > 1)
         {
             mAsyncTextureLoader.loadMippedFromFiles(paths, loadAsSRGB, bindFlags, importFlags, callback);
@@ -323,22 +425,20 @@ TextureManager::CpuTextureHandle TextureManager::loadTexture(
         }
 #else
         // Load texture from main thread.
-        ref<Texture> pTexture;
-        if (paths.size() > 1)
-        {
-            pTexture = Texture::createMippedFromFiles(mpDevice, paths, loadAsSRGB, bindFlags, importFlags);
-        }
-        else
-        {
-            pTexture = Texture::createFromFile(mpDevice, paths[0], generateMipLevels, loadAsSRGB, bindFlags, importFlags);
-        }
+        std::filesystem::path cachePath = getDiskCachePath(textureKey, fileHashes);
+        bool writeCache = false;
+        ref<Texture> pTexture = loadTextureFromFiles(textureKey, cachePath, writeCache);
+        if (writeCache)
+            writeDiskCache(pTexture, cachePath);
 
         // Add new texture desc.
         TextureDesc desc = {TextureState::Loaded, pTexture};
         handle = addDesc(desc);
 
-        // Add to key-to-handle map.
+        // Add to key-to-handle and content-to-handle maps.
         mKeyToHandle[textureKey] = handle;
+        if (useContentHash)
+            mContentToHandle[contentHash] = handle;
 
         // Add to texture-to-handle map.
         if (pTexture)
@@ -391,14 +491,17 @@ void TextureManager::endDeferredLoading()
     {
         TextureKey key;
         CpuTextureHandle handle;
+        std::vector<ContentHash> fileHashes;
     };
 
     // Get a list of textures to load.
+    // Textures deduplicated by content have multiple keys, these are loaded only once.
     std::vector<Job> jobs;
+    Handles jobHandles;
     for (auto& [key, handle] : mKeyToHandle)
     {
         auto& desc = getDesc(handle);
-        if (desc.state == TextureState::Referenced)
+        if (desc.state == TextureState::Referenced && jobHandles.insert(handle).second)
             jobs.push_back(Job{key, handle});
     }
 
@@ -407,8 +510,48 @@ void TextureManager::endDeferredLoading()
     if (jobs.empty())
         return;
 
+    // Hash the source files in parallel to find textures with identical content and to locate the disk cache entries.
+    const bool useDiskCache = !mDiskCacheDirectory.empty();
+    if (mUseContentDeduplication || useDiskCache)
+    {
+        NumericRange<size_t> jobRange(0, jobs.size());
+        std::for_each(
+            std::execution::par_unseq,
+            jobRange.begin(),
+            jobRange.end(),
+            [&](size_t i) { jobs[i].fileHashes = getFileHashes(jobs[i].key.fullPaths); }
+        );
+    }
+
+    // Resolve textures with identical content to an already managed texture or to an earlier job.
+    // Their handles have already been returned, so they are kept and share the texture of the other handle.
+    // Each entry holds the duplicate handle and the source handle.
+    std::vector<std::pair<CpuTextureHandle, CpuTextureHandle>> duplicates;
+    if (mUseContentDeduplication)
+    {
+        std::vector<Job> uniqueJobs;
+        for (auto& job : jobs)
+        {
+            if (!job.fileHashes.empty())
+            {
+                auto [it, inserted] = mContentToHandle.emplace(getContentHash(job.key, job.fileHashes), job.handle);
+                if (!inserted)
+                {
+                    duplicates.emplace_back(job.handle, it->second);
+                    mKeyToHandle[job.key] = it->second;
+                    mDeduplicatedCount++;
+                    continue;
+                }
+            }
+            uniqueJobs.push_back(std::move(job));
+        }
+        jobs = std::move(uniqueJobs);
+    }
+
     // Load textures in parallel.
+    // Textures missing in the disk cache are written to the cache afterwards, as this requires reading them back on the main thread.
     std::atomic<size_t> texturesLoaded;
+    std::vector<std::filesystem::path> cacheWritePaths(jobs.size());
     NumericRange<size_t> jobRange(0, jobs.size());
     std::for_each(
         std::execution::par_unseq,
@@ -418,19 +561,12 @@ void TextureManager::endDeferredLoading()
         {
             const auto& job = jobs[i];
             auto& desc = getDesc(job.handle);
-            if (job.key.fullPaths.size() == 1)
-            {
-                desc.pTexture = Texture::createFromFile(
-                    mpDevice, job.key.fullPaths[0], job.key.generateMipLevels, job.key.loadAsSRGB, job.key.bindFlags, job.key.importFlags
-                );
-                logDebug("Loading texture from '{}'", job.key.fullPaths[0]);
-            }
-            else
-            {
-                desc.pTexture =
-                    Texture::createMippedFromFiles(mpDevice, job.key.fullPaths, job.key.loadAsSRGB, job.key.bindFlags, job.key.importFlags);
-                logDebug("Loading mipped texture from '{}'", job.key.fullPaths[0]);
-            }
+            std::filesystem::path cachePath = getDiskCachePath(job.key, job.fileHashes);
+            bool writeCache = false;
+            desc.pTexture = loadTextureFromFiles(job.key, cachePath, writeCache);
+            if (writeCache)
+                cacheWritePaths[i] = cachePath;
+            logDebug("Loading {}texture from '{}'", job.key.fullPaths.size() > 1 ? "mipped " : "", job.key.fullPaths[0]);
             if (texturesLoaded.fetch_add(1) % 10 == 9)
             {
                 logDebug("Flush");
@@ -441,6 +577,12 @@ void TextureManager::endDeferredLoading()
     );
     mpDevice->wait();
 
+    for (size_t i = 0; i < jobs.size(); i++)
+    {
+        if (!cacheWritePaths[i].empty())
+            writeDiskCache(getDesc(jobs[i].handle).pTexture, cacheWritePaths[i]);
+    }
+
     // Mark loaded textures and add them to lookup table.
     for (const auto& job : jobs)
     {
@@ -448,6 +590,15 @@ void TextureManager::endDeferredLoading()
         desc.state = desc.pTexture ? TextureState::Loaded : TextureState::Invalid;
         mTextureToHandle[desc.pTexture.get()] = job.handle;
     }
+
+    // Share the textures with the duplicate handles. The texture-to-handle map refers to the source handle.
+    for (const auto& [handle, sourceHandle] : duplicates)
+    {
+        const auto& sourceDesc = getDesc(sourceHandle);
+        auto& desc = getDesc(handle);
+        desc.pTexture = sourceDesc.pTexture;
+        desc.state = sourceDesc.state;
+    }
 }
 
 void TextureManager::removeTexture(const CpuTextureHandle& handle)
@@ -488,15 +639,15 @@ void TextureManager::removeNonUdimTexture(const CpuTextureHandle& handle)
 
     // Remove handle from maps.
     // Note not all handles exist in key-to-handle map so search for it. This can be optimized if needed.
-    auto it = std::find_if(mKeyToHandle.begin(), mKeyToHandle.end(), [handle](const auto& keyVal) { return keyVal.second == handle; });
-    if (it != mKeyToHandle.end())
-        mKeyToHandle.erase(it);
+    // A handle can have multiple keys if textures were deduplicated by content.
+    for (auto it = mKeyToHandle.begin(); it != mKeyToHandle.end();)
+        it = it->second == handle ? mKeyToHandle.erase(it) : std::next(it);
+    for (auto it = mContentToHandle.begin(); it != mContentToHandle.end();)
+        it = it->second == handle ? mContentToHandle.erase(it) : std::next(it);
 
-    if (desc.pTexture)
-    {
-        FALCOR_ASSERT(mTextureToHandle.find(desc.pTexture.get()) != mTextureToHandle.end());
-        mTextureToHandle.erase(desc.pTexture.get());
-    }
+    // Textures deduplicated in deferred loading are shared by multiple handles, the map only refers to one of them.
+    if (auto it = mTextureToHandle.find(desc.pTexture.get()); desc.pTexture && it != mTextureToHandle.end() && it->second == handle)
+        mTextureToHandle.erase(it);
 
     // Clear texture desc.
     desc = {};
@@ -629,9 +780,11 @@ TextureManager::Stats TextureManager::getStats() const
 {
     std::lock_guard<std::mutex> lock(mMutex);
     TextureManager::Stats s;
+    std::set<const Texture*> textures;
     for (const auto& t : mTextureDescs)
     {
-        if (!t.pTexture)
+        // Skip textures shared by multiple handles after deduplication in deferred loading.
+        if (!t.pTexture || !textures.insert(t.pTexture.get()).second)
             continue;
         uint64_t texelCount = t.pTexture->getTexelCount();
         uint32_t channelCount = getFormatChannelCount(t.pTexture->getFormat());
@@ -642,9 +795,136 @@ TextureManager::Stats TextureManager::getStats() const
         if (isCompressedFormat(t.pTexture->getFormat()))
             s.textureCompressedCount++;
     }
+    s.textureDeduplicatedCount = mDeduplicatedCount;
+    s.diskCacheHitCount = mDiskCacheHitCount;
+    s.diskCacheWriteCount = mDiskCacheWriteCount;
     return s;
 }
 
+std::vector<TextureManager::ContentHash> TextureManager::getFileHashes(const std::vector<std::filesystem::path>& paths)
+{
+    // Returns an empty list if any of the files can't be hashed.
+    std::vector<ContentHash> hashes;
+    hashes.reserve(paths.size());
+    for (const auto& path : paths)
+    {
+        FileHash fileHash;
+        std::error_code ec;
+        fileHash.fileSize = std::filesystem::file_size(path, ec);
+        if (!ec)
+            fileHash.lastWriteTime = std::filesystem::last_write_time(path, ec);
+        if (ec)
+            return {};
+
+        {
+            std::lock_guard<std::mutex> lock(mFileHashMutex);
+            if (auto it = mFileHashes.find(path); it != mFileHashes.end() && it->second.fileSize == fileHash.fileSize &&
+                                                  it->second.lastWriteTime == fileHash.lastWriteTime)
+            {
+                hashes.push_back(it->second.hash);
+                continue;
+            }
+        }
+
+        if (!computeFileHash(path, fileHash.hash))
+            return {};
+
+        std::lock_guard<std::mutex> lock(mFileHashMutex);
+        mFileHashes[path] = fileHash;
+        hashes.push_back(fileHash.hash);
+    }
+    return hashes;
+}
+
+TextureManager::ContentHash TextureManager::getContentHash(const TextureKey& key, const std::vector<ContentHash>& fileHashes) const
+{
+    SHA1 sha1;
+    for (const auto& hash : fileHashes)
+        sha1.update(hash.data(), hash.size());
+    sha1.update(key.generateMipLevels);
+    sha1.update(key.loadAsSRGB);
+    sha1.update(&key.bindFlags, sizeof(key.bindFlags));
+    sha1.update(&key.importFlags, sizeof(key.importFlags));
+    return sha1.finalize();
+}
+
+std::filesystem::path TextureManager::getDiskCachePath(const TextureKey& key, const std::vector<ContentHash>& fileHashes) const
+{
+    // Cached textures are loaded with the default bind flags, so other textures bypass the cache.
+    // DDS files are loaded without conversion and are not cached.
+    if (mDiskCacheDirectory.empty() || fileHashes.empty() || key.bindFlags != ResourceBindFlags::ShaderResource)
+        return {};
+    if (key.fullPaths.size() == 1 && hasExtension(key.fullPaths[0], "dds"))
+        return {};
+
+    SHA1 sha1;
+    sha1.update(kDiskCacheVersion);
+    for (const auto& hash : fileHashes)
+        sha1.update(hash.data(), hash.size());
+    sha1.update(key.generateMipLevels);
+    sha1.update(key.loadAsSRGB);
+    sha1.update(&key.importFlags, sizeof(key.importFlags));
+    sha1.update(&mDiskCacheCompressionMode, sizeof(mDiskCacheCompressionMode));
+    return mDiskCacheDirectory / (SHA1::toString(sha1.finalize()) + ".dds");
+}
+
+ref<Texture> TextureManager::loadTextureFromFiles(const TextureKey& key, const std::filesystem::path& cachePath, bool& writeCache)
+{
+    writeCache = false;
+
+    if (!cachePath.empty() && std::filesystem::exists(cachePath))
+    {
+        ref<Texture> pTexture = ImageIO::loadTextureFromDDS(mpDevice, cachePath, key.loadAsSRGB);
+        if (pTexture)
+        {
+            pTexture->setSourcePath(key.fullPaths[0]);
+            pTexture->setImportFlags(key.importFlags);
+            mDiskCacheHitCount++;
+            logDebug("Loaded texture '{}' from disk cache '{}'.", key.fullPaths[0], cachePath);
+            return pTexture;
+        }
+        logWarning("Failed to load texture '{}' from disk cache. Loading from source.", key.fullPaths[0]);
+    }
+
+    ref<Texture> pTexture;
+    if (key.fullPaths.size() > 1)
+    {
+        pTexture = Texture::createMippedFromFiles(mpDevice, key.fullPaths, key.loadAsSRGB, key.bindFlags, key.importFlags);
+    }
+    else
+    {
+        pTexture =
+            Texture::createFromFile(mpDevice, key.fullPaths[0], key.generateMipLevels, key.loadAsSRGB, key.bindFlags, key.importFlags);
+    }
+
+    writeCache = pTexture && !cachePath.empty();
+    return pTexture;
+}
+
+void TextureManager::writeDiskCache(const ref<Texture>& pTexture, const std::filesystem::path& cachePath)
+{
+    FALCOR_ASSERT(pTexture);
+
+    // Write to a temporary file first, so that other processes sharing the cache never read partially written entries.
+    std::filesystem::path tempPath =
+        cachePath.parent_path() / fmt::format("{}-{:08x}.tmp.dds", cachePath.stem().string(), std::random_device()());
+    try
+    {
+        std::filesystem::create_directories(cachePath.parent_path());
+        ImageIO::saveToDDS(
+            mpDevice->getRenderContext(), tempPath, pTexture, getDiskCacheCompressionMode(pTexture.get(), mDiskCacheCompressionMode)
+        );
+        std::filesystem::rename(tempPath, cachePath);
+        mDiskCacheWriteCount++;
+    }
+    catch (const std::exception& e)
+    {
+        logWarning("Failed to write texture '{}' to disk cache: {}", pTexture->getSourcePath(), e.what());
+        std::error_code ec;
+        std::filesystem::remove(tempPath, ec);
+    }
+}
+
 TextureManager::CpuTextureHandle TextureManager::addDesc(const TextureDesc& desc)
 {
     CpuTextureHandle handle;
@@ -27,12 +27,15 @@
  **************************************************************************/
 #pragma once
 #include "AsyncTextureLoader.h"
+#include "ImageIO.h"
 #include "Core/Macros.h"
 #include "Core/API/fwd.h"
 #include "Core/API/Resource.h"
 #include "Core/API/Texture.h"
 #include "Core/Program/ShaderVar.h"
 #include "Scene/Material/TextureHandle.slang"
+#include "Utils/CryptoUtils.h"
+#include <atomic>
 #include <condition_variable>
 #include <limits>
 #include <map>
@@ -73,6 +76,9 @@ public:
         uint64_t textureTexelCount = 0;        ///< Total number of texels in all textures.
         uint64_t textureTexelChannelCount = 0; ///< Total number of texel channels in all textures.
         uint64_t textureMemoryInBytes = 0;     ///< Total memory in bytes used by the textures.
+        uint64_t textureDeduplicatedCount = 0; ///< Number of texture files resolved to an already loaded texture with identical content.
+        uint64_t diskCacheHitCount = 0;        ///< Number of textures loaded from the disk cache.
+        uint64_t diskCacheWriteCount = 0;      ///< Number of textures written to the disk cache.
     };
 
     /**
@@ -183,6 +189,34 @@ public:
         const Object* owner = nullptr
     );
 
+    /**
+     * Enable or disable deduplication of textures by content.
+     * When enabled (default), loading texture files that are byte-identical to an already managed texture
+     * loaded with the same flags returns the handle of the existing texture, regardless of the file path.
+     * With deferred loading, the files are hashed in parallel in endDeferredLoading(). The handles returned for
+     * duplicates are then distinct, but refer to the same texture, which is loaded only once.
+     * @param[in] enabled True to enable deduplication by content.
+     */
+    void setContentDeduplication(bool enabled);
+
+    /**
+     * Set the directory of the disk cache for converted textures.
+     * Textures loaded from (non-DDS) files are stored in the cache as DDS files including the full mip-chain.
+     * Cached files are keyed by the content hash of the source files and the load flags, so later loads of the
+     * same content skip image decoding and mip generation. The cache is only used for shader resource textures.
+     * @param[in] path Cache directory, or an empty path to disable the disk cache.
+     * @param[in] compressionMode Block compression applied to cached textures where the format allows it.
+     */
+    void setDiskCacheDirectory(
+        const std::filesystem::path& path,
+        ImageIO::CompressionMode compressionMode = ImageIO::CompressionMode::None
+    );
+
+    /**
+     * Get the directory of the disk cache, or an empty path if the disk cache is disabled.
+     */
+    std::filesystem::path getDiskCacheDirectory() const;
+
     /**
      * Wait for a requested texture to load.
      * If the handle is valid, the call blocks until the texture is loaded (or failed to load).
@@ -339,6 +373,22 @@ private:
         }
     };
 
+    using ContentHash = SHA1::MD;
+
+    /// Hash of a source file. Reused as long as the file size and modification time don't change.
+    struct FileHash
+    {
+        uintmax_t fileSize = 0;
+        std::filesystem::file_time_type lastWriteTime;
+        ContentHash hash;
+    };
+
+    std::vector<ContentHash> getFileHashes(const std::vector<std::filesystem::path>& paths);
+    ContentHash getContentHash(const TextureKey& key, const std::vector<ContentHash>& fileHashes) const;
+    std::filesystem::path getDiskCachePath(const TextureKey& key, const std::vector<ContentHash>& fileHashes) const;
+    ref<Texture> loadTextureFromFiles(const TextureKey& key, const std::filesystem::path& cachePath, bool& writeCache);
+    void writeDiskCache(const ref<Texture>& pTexture, const std::filesystem::path& cachePath);
+
     CpuTextureHandle addDesc(const TextureDesc& desc);
     TextureDesc& getDesc(const CpuTextureHandle& handle);
     void registerOwner(const CpuTextureHandle& handle, const Object* owner);
@@ -353,6 +403,7 @@ private:
     std::vector<CpuTextureHandle> mFreeList;                     ///< List of unused handles.
     std::map<TextureKey, CpuTextureHandle> mKeyToHandle;         ///< Map from texture key to handle.
     std::map<const Texture*, CpuTextureHandle> mTextureToHandle; ///< Map from texture ptr to handle.
+    std::map<ContentHash, CpuTextureHandle> mContentToHandle;    ///< Map from hash of the file contents and load flags to handle.
     /// Map from UDIM-1001 to an actual textureID, -1 if the texture does not exist (e.g., there is 1001 and 1003, so 1002 [1] == -1)
     std::vector<int32_t> mUdimIndirection;
     /// For each udim indirection range, writes (at the first element), how long that range is (there is 0 everywhere else)
@@ -370,6 +421,16 @@ private:
 
     bool mUseDeferredLoading = false;
 
+    bool mUseContentDeduplication = true;                                                 ///< Deduplicate textures by file content.
+    std::filesystem::path mDiskCacheDirectory;                                            ///< Disk cache directory, empty if disabled.
+    ImageIO::CompressionMode mDiskCacheCompressionMode = ImageIO::CompressionMode::None; ///< Compression of cached textures.
+    uint64_t mDeduplicatedCount = 0;                                                      ///< Number of texture loads resolved by content.
+    std::atomic<uint64_t> mDiskCacheHitCount{0};                                          ///< Number of textures loaded from the disk cache.
+    std::atomic<uint64_t> mDiskCacheWriteCount{0};                                        ///< Number of textures written to the disk cache.
+
+    std::mutex mFileHashMutex;                             ///< Mutex for synchronizing access to the file hashes.
+    std::map<std::filesystem::path, FileHash> mFileHashes; ///< Hashes of source files, indexed by full path.
+
     AsyncTextureLoader mAsyncTextureLoader; ///< Utility for asynchronous texture loading.
     size_t mLoadRequestsInProgress = 0;     ///< Number of load requests currently in progress.
 
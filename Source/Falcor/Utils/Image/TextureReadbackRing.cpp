@@ -0,0 +1,101 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TextureReadbackRing.h"
+#include "Core/Error.h"
+#include "Core/API/Device.h"
+#include "Core/API/RenderContext.h"
+#include <algorithm>
+
+namespace Falcor
+{
+TextureReadbackRing::TextureReadbackRing(ref<Device> pDevice, uint32_t frameCount) : mpDevice(std::move(pDevice)), mFrameCount(frameCount)
+{
+    FALCOR_CHECK(mFrameCount > 0, "Readback ring requires at least one frame.");
+}
+
+TextureReadbackRing::~TextureReadbackRing()
+{
+    flush();
+}
+
+void TextureReadbackRing::read(const Texture* pTexture, uint32_t subresourceIndex, Callback callback)
+{
+    FALCOR_CHECK(pTexture, "Missing texture.");
+
+    // Reuse the largest free buffer, the read task allocates a new one if it is too small.
+    ref<Buffer> pStagingBuffer;
+    if (!mFreeBuffers.empty())
+    {
+        auto it = std::max_element(
+            mFreeBuffers.begin(), mFreeBuffers.end(), [](const ref<Buffer>& a, const ref<Buffer>& b) { return a->getSize() < b->getSize(); }
+        );
+        pStagingBuffer = std::move(*it);
+        mFreeBuffers.erase(it);
+    }
+
+    auto pTask = mpDevice->getRenderContext()->asyncReadTextureSubresource(pTexture, subresourceIndex, pStagingBuffer);
+    mPending.push_back({std::move(pTask), std::move(callback), mFrame});
+    mFrameReadCount++;
+    mMaxFrameReadCount = std::max(mMaxFrameReadCount, mFrameReadCount);
+}
+
+void TextureReadbackRing::endFrame()
+{
+    mFrame++;
+    mFrameReadCount = 0;
+
+    // Keep the reads of at most mFrameCount frames in flight, the new frame included.
+    while (!mPending.empty() && mFrame - mPending.front().frame >= mFrameCount)
+        retireOldest();
+}
+
+void TextureReadbackRing::poll()
+{
+    while (!mPending.empty() && mPending.front().pTask->isComplete())
+        retireOldest();
+}
+
+void TextureReadbackRing::flush()
+{
+    while (!mPending.empty())
+        retireOldest();
+}
+
+void TextureReadbackRing::retireOldest()
+{
+    FALCOR_ASSERT(!mPending.empty());
+    PendingRead read = std::move(mPending.front());
+    mPending.pop_front();
+
+    std::vector<uint8_t> data = read.pTask->getData();
+    if (mFreeBuffers.size() < size_t(mFrameCount) * mMaxFrameReadCount)
+        mFreeBuffers.push_back(read.pTask->getStagingBuffer());
+
+    read.callback(std::move(data));
+}
+} // namespace Falcor
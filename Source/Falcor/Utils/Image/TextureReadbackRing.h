@@ -0,0 +1,106 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/CopyContext.h"
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Ring of asynchronous texture readbacks.
+ *
+ * read() records a copy of a texture subresource into a readback buffer and returns without waiting for the GPU.
+ * The data is passed to a callback once the copy has completed, which is checked in poll(), and is waited for when
+ * the ring is full or in flush(). This lets the copy of one frame overlap the rendering of the following frames.
+ * The ring holds the reads of a fixed number of frames, independent of the number of reads per frame, so reading
+ * many textures in a frame never waits for the reads of the same frame. Readback buffers of completed reads are
+ * reused for later reads.
+ *
+ * Callbacks are invoked in the order of the reads. All functions must be called from the render thread.
+ */
+class FALCOR_API TextureReadbackRing
+{
+public:
+    using Callback = std::function<void(std::vector<uint8_t> data)>;
+
+    /**
+     * Constructor.
+     * @param[in] pDevice GPU device.
+     * @param[in] frameCount Maximum number of frames with reads in flight.
+     */
+    TextureReadbackRing(ref<Device> pDevice, uint32_t frameCount);
+
+    /// Waits for all reads and invokes their callbacks.
+    ~TextureReadbackRing();
+
+    /**
+     * Read a texture subresource as part of the current frame. Does not wait for the GPU.
+     * @param[in] pTexture The texture to read.
+     * @param[in] subresourceIndex The subresource to read.
+     * @param[in] callback Called with the data when the read has completed, rows are tightly packed.
+     */
+    void read(const Texture* pTexture, uint32_t subresourceIndex, Callback callback);
+
+    /// End the current frame. If the ring is full, waits for the reads of the oldest frame.
+    void endFrame();
+
+    /// Invoke the callbacks of reads that have completed, without waiting.
+    void poll();
+
+    /// Wait for all reads and invoke their callbacks.
+    void flush();
+
+    /// Number of reads in flight.
+    uint32_t getPendingCount() const { return (uint32_t)mPending.size(); }
+
+    /// Number of frames with reads in flight.
+    uint32_t getPendingFrameCount() const { return mPending.empty() ? 0 : (uint32_t)(mPending.back().frame - mPending.front().frame + 1); }
+
+private:
+    struct PendingRead
+    {
+        CopyContext::ReadTextureTask::SharedPtr pTask;
+        Callback callback;
+        uint64_t frame;
+    };
+
+    void retireOldest();
+
+    ref<Device> mpDevice;
+    uint32_t mFrameCount;
+    uint64_t mFrame = 0;              ///< Index of the current frame.
+    uint32_t mFrameReadCount = 0;     ///< Number of reads in the current frame.
+    uint32_t mMaxFrameReadCount = 1;  ///< Maximum number of reads in a frame so far.
+    std::deque<PendingRead> mPending;
+    std::vector<ref<Buffer>> mFreeBuffers; ///< Readback buffers of completed reads.
+};
+} // namespace Falcor
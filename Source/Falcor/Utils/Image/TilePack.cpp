@@ -0,0 +1,340 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TilePack.h"
+#include "ImageIO.h"
+#include "Core/Error.h"
+#include "Utils/Math/Common.h"
+#include "Utils/Math/Float16.h"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+uint32_t getTileCount1D(uint32_t size, uint32_t tileSize)
+{
+    return (size + tileSize - 1) / tileSize;
+}
+
+float srgbToLinear(float v)
+{
+    return v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+}
+
+float linearToSrgb(float v)
+{
+    return v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1.f / 2.4f) - 0.055f;
+}
+
+/**
+ * Reads and writes texels of formats supported for mip generation as floats.
+ */
+class TexelCodec
+{
+public:
+    TexelCodec(ResourceFormat format) : mFormat(format)
+    {
+        FormatType type = getFormatType(format);
+        mChannelCount = getFormatChannelCount(format);
+        mChannelBits = getNumChannelBits(format, 0);
+        for (uint32_t c = 1; c < mChannelCount; c++)
+        {
+            if (getNumChannelBits(format, c) != mChannelBits)
+                mChannelBits = 0;
+        }
+
+        bool isUnorm8 = (type == FormatType::Unorm || type == FormatType::UnormSrgb) && mChannelBits == 8;
+        bool isFloat = type == FormatType::Float && (mChannelBits == 16 || mChannelBits == 32);
+        FALCOR_CHECK(!isCompressedFormat(format) && (isUnorm8 || isFloat), "Mip generation is not supported for format {}.", to_string(format));
+        mIsSrgb = type == FormatType::UnormSrgb;
+        mIsFloat = isFloat;
+    }
+
+    uint32_t getChannelCount() const { return mChannelCount; }
+    uint32_t getBytesPerTexel() const { return mChannelCount * mChannelBits / 8; }
+
+    float read(const uint8_t* pTexel, uint32_t channel) const
+    {
+        if (!mIsFloat)
+        {
+            float v = pTexel[channel] / 255.f;
+            // Alpha is always stored linearly.
+            return mIsSrgb && channel < 3 ? srgbToLinear(v) : v;
+        }
+        if (mChannelBits == 16)
+        {
+            uint16_t bits;
+            std::memcpy(&bits, pTexel + channel * 2, sizeof(bits));
+            return math::float16ToFloat32(bits);
+        }
+        float v;
+        std::memcpy(&v, pTexel + channel * 4, sizeof(v));
+        return v;
+    }
+
+    void write(uint8_t* pTexel, uint32_t channel, float v) const
+    {
+        if (!mIsFloat)
+        {
+            if (mIsSrgb && channel < 3)
+                v = linearToSrgb(v);
+            pTexel[channel] = (uint8_t)std::lround(std::clamp(v, 0.f, 1.f) * 255.f);
+        }
+        else if (mChannelBits == 16)
+        {
+            uint16_t bits = math::float32ToFloat16(v);
+            std::memcpy(pTexel + channel * 2, &bits, sizeof(bits));
+        }
+        else
+        {
+            std::memcpy(pTexel + channel * 4, &v, sizeof(v));
+        }
+    }
+
+private:
+    ResourceFormat mFormat;
+    uint32_t mChannelCount = 0;
+    uint32_t mChannelBits = 0;
+    bool mIsSrgb = false;
+    bool mIsFloat = false;
+};
+} // namespace
+
+std::vector<std::vector<uint8_t>> TilePack::generateMips(ResourceFormat format, const MipData& mip0)
+{
+    TexelCodec codec(format);
+    const uint32_t bytesPerTexel = codec.getBytesPerTexel();
+    const uint32_t channelCount = codec.getChannelCount();
+
+    std::vector<std::vector<uint8_t>> mips;
+    MipData src = mip0;
+    while (src.width > 1 || src.height > 1)
+    {
+        uint32_t width = std::max(src.width / 2, 1u);
+        uint32_t height = std::max(src.height / 2, 1u);
+        std::vector<uint8_t> data(size_t(width) * height * bytesPerTexel);
+
+        // Average the 2x2 footprint of each texel. Odd source sizes drop the last row/column.
+        for (uint32_t y = 0; y < height; y++)
+        {
+            for (uint32_t x = 0; x < width; x++)
+            {
+                uint32_t x0 = std::min(2 * x, src.width - 1), x1 = std::min(2 * x + 1, src.width - 1);
+                uint32_t y0 = std::min(2 * y, src.height - 1), y1 = std::min(2 * y + 1, src.height - 1);
+                const uint8_t* p[4] = {
+                    src.pData + (size_t(y0) * src.width + x0) * bytesPerTexel,
+                    src.pData + (size_t(y0) * src.width + x1) * bytesPerTexel,
+                    src.pData + (size_t(y1) * src.width + x0) * bytesPerTexel,
+                    src.pData + (size_t(y1) * src.width + x1) * bytesPerTexel,
+                };
+                uint8_t* pDst = data.data() + (size_t(y) * width + x) * bytesPerTexel;
+                for (uint32_t c = 0; c < channelCount; c++)
+                {
+                    float sum = 0.f;
+                    for (uint32_t i = 0; i < 4; i++)
+                        sum += codec.read(p[i], c);
+                    codec.write(pDst, c, 0.25f * sum);
+                }
+            }
+        }
+
+        mips.push_back(std::move(data));
+        src = MipData{width, height, mips.back().data()};
+    }
+
+    return mips;
+}
+
+void TilePack::write(
+    const std::filesystem::path& path,
+    ResourceFormat format,
+    fstd::span<const MipData> mips,
+    uint32_t tileSize,
+    uint32_t borderSize
+)
+{
+    FALCOR_CHECK(!mips.empty(), "Tile pack requires at least one mip level.");
+    FALCOR_CHECK(tileSize > 0 && borderSize < tileSize, "Invalid tile size {} with border size {}.", tileSize, borderSize);
+    FALCOR_CHECK(!isCompressedFormat(format), "Tile packs do not support compressed format {}.", to_string(format));
+    for (size_t i = 1; i < mips.size(); i++)
+    {
+        FALCOR_CHECK(
+            mips[i].width == std::max(mips[i - 1].width / 2, 1u) && mips[i].height == std::max(mips[i - 1].height / 2, 1u),
+            "Resolution of mip {} must be half of the previous mip level.",
+            i
+        );
+    }
+
+    const uint32_t bytesPerTexel = getFormatBytesPerBlock(format);
+    const uint32_t paddedTileSize = tileSize + 2 * borderSize;
+    const size_t tileByteSize = size_t(paddedTileSize) * paddedTileSize * bytesPerTexel;
+
+    Header header;
+    header.format = format;
+    header.width = mips[0].width;
+    header.height = mips[0].height;
+    header.mipCount = (uint32_t)mips.size();
+    header.tileSize = tileSize;
+    header.borderSize = borderSize;
+    for (const auto& mip : mips)
+        header.tileCount += getTileCount1D(mip.width, tileSize) * getTileCount1D(mip.height, tileSize);
+
+    // Tile data starts after the tile offset table, aligned to 16 bytes.
+    uint64_t dataOffset = align_to<uint64_t>(16, sizeof(Header) + header.tileCount * sizeof(uint64_t));
+    std::vector<uint64_t> tileOffsets(header.tileCount);
+    for (uint32_t i = 0; i < header.tileCount; i++)
+        tileOffsets[i] = dataOffset + i * tileByteSize;
+
+    std::ofstream fs(path, std::ios_base::binary);
+    if (!fs)
+        FALCOR_THROW("Failed to create tile pack file '{}'.", path);
+
+    fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    fs.write(reinterpret_cast<const char*>(tileOffsets.data()), tileOffsets.size() * sizeof(uint64_t));
+    std::vector<char> padding(dataOffset - sizeof(Header) - tileOffsets.size() * sizeof(uint64_t), 0);
+    fs.write(padding.data(), padding.size());
+
+    std::vector<uint8_t> tileData(tileByteSize);
+    for (const auto& mip : mips)
+    {
+        uint32_t tileCountX = getTileCount1D(mip.width, tileSize);
+        uint32_t tileCountY = getTileCount1D(mip.height, tileSize);
+        for (uint32_t ty = 0; ty < tileCountY; ty++)
+        {
+            for (uint32_t tx = 0; tx < tileCountX; tx++)
+            {
+                // Copy the tile including its border, clamping to the edges of the mip level.
+                for (uint32_t y = 0; y < paddedTileSize; y++)
+                {
+                    int64_t srcY = std::clamp<int64_t>(int64_t(ty) * tileSize + y - borderSize, 0, mip.height - 1);
+                    for (uint32_t x = 0; x < paddedTileSize; x++)
+                    {
+                        int64_t srcX = std::clamp<int64_t>(int64_t(tx) * tileSize + x - borderSize, 0, mip.width - 1);
+                        std::memcpy(
+                            tileData.data() + (size_t(y) * paddedTileSize + x) * bytesPerTexel,
+                            mip.pData + (size_t(srcY) * mip.width + srcX) * bytesPerTexel,
+                            bytesPerTexel
+                        );
+                    }
+                }
+                fs.write(reinterpret_cast<const char*>(tileData.data()), tileData.size());
+            }
+        }
+    }
+
+    if (!fs)
+        FALCOR_THROW("Failed to write tile pack file '{}'.", path);
+}
+
+void TilePack::write(const std::filesystem::path& path, const Bitmap& bitmap, uint32_t tileSize, uint32_t borderSize)
+{
+    // Bitmaps are tightly packed, which is verified here as the tile pack writer relies on it.
+    FALCOR_CHECK(
+        bitmap.getRowPitch() == bitmap.getWidth() * getFormatBytesPerBlock(bitmap.getFormat()), "Bitmap rows must be tightly packed."
+    );
+
+    MipData mip0{bitmap.getWidth(), bitmap.getHeight(), bitmap.getData()};
+    auto mipData = generateMips(bitmap.getFormat(), mip0);
+
+    std::vector<MipData> mips{mip0};
+    for (const auto& data : mipData)
+    {
+        const auto& prev = mips.back();
+        mips.push_back(MipData{std::max(prev.width / 2, 1u), std::max(prev.height / 2, 1u), data.data()});
+    }
+
+    write(path, bitmap.getFormat(), mips, tileSize, borderSize);
+}
+
+void TilePack::convertImage(
+    const std::filesystem::path& srcPath,
+    const std::filesystem::path& dstPath,
+    uint32_t tileSize,
+    uint32_t borderSize,
+    Bitmap::ImportFlags importFlags
+)
+{
+    Bitmap::UniqueConstPtr pBitmap;
+    if (hasExtension(srcPath, "dds"))
+        pBitmap = ImageIO::loadBitmapFromDDS(srcPath);
+    else
+        pBitmap = Bitmap::createFromFile(srcPath, true, importFlags);
+
+    if (!pBitmap)
+        FALCOR_THROW("Failed to load image '{}'.", srcPath);
+
+    write(dstPath, *pBitmap, tileSize, borderSize);
+}
+
+TilePack::TilePack(const std::filesystem::path& path) : mPath(path)
+{
+    if (!mFile.open(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::RandomAccess))
+        FALCOR_THROW("Failed to open tile pack file '{}'.", path);
+
+    FALCOR_CHECK(mFile.getSize() >= sizeof(Header), "Tile pack file '{}' is truncated.", path);
+    std::memcpy(&mHeader, mFile.getData(), sizeof(Header));
+    FALCOR_CHECK(mHeader.magic == kMagic, "File '{}' is not a tile pack.", path);
+    FALCOR_CHECK(mHeader.version == kVersion, "Tile pack file '{}' has unsupported version {}.", path, mHeader.version);
+    FALCOR_CHECK(mHeader.tileSize > 0 && mHeader.mipCount > 0, "Tile pack file '{}' is invalid.", path);
+
+    const uint32_t paddedTileSize = getPaddedTileSize();
+    mTileByteSize = size_t(paddedTileSize) * paddedTileSize * getFormatBytesPerBlock(mHeader.format);
+
+    uint32_t tileCount = 0;
+    for (uint32_t mip = 0; mip < mHeader.mipCount; mip++)
+    {
+        mMipTileOffsets.push_back(tileCount);
+        uint2 count = getTileCount(mip);
+        tileCount += count.x * count.y;
+    }
+    FALCOR_CHECK(tileCount == mHeader.tileCount, "Tile pack file '{}' has an invalid tile count.", path);
+
+    FALCOR_CHECK(mFile.getSize() >= sizeof(Header) + tileCount * sizeof(uint64_t), "Tile pack file '{}' is truncated.", path);
+    mTileOffsets = reinterpret_cast<const uint64_t*>(static_cast<const uint8_t*>(mFile.getData()) + sizeof(Header));
+    for (uint32_t i = 0; i < tileCount; i++)
+        FALCOR_CHECK(mTileOffsets[i] + mTileByteSize <= mFile.getSize(), "Tile pack file '{}' is truncated.", path);
+}
+
+uint2 TilePack::getTileCount(uint32_t mip) const
+{
+    FALCOR_ASSERT(mip < mHeader.mipCount);
+    uint32_t width = std::max(mHeader.width >> mip, 1u);
+    uint32_t height = std::max(mHeader.height >> mip, 1u);
+    return uint2(getTileCount1D(width, mHeader.tileSize), getTileCount1D(height, mHeader.tileSize));
+}
+
+const uint8_t* TilePack::getTileData(uint32_t mip, uint2 tile) const
+{
+    uint2 count = getTileCount(mip);
+    FALCOR_CHECK(tile.x < count.x && tile.y < count.y, "Tile ({}, {}) is out of range for mip {}.", tile.x, tile.y, mip);
+    uint32_t index = mMipTileOffsets[mip] + tile.y * count.x + tile.x;
+    return static_cast<const uint8_t*>(mFile.getData()) + mTileOffsets[index];
+}
+} // namespace Falcor
@@ -0,0 +1,182 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Bitmap.h"
+#include "Core/Macros.h"
+#include "Core/API/Formats.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Utils/Math/Vector.h"
+#include <filesystem>
+#include <memory>
+#include <vector>
+#include <fstd/span.h>
+
+namespace Falcor
+{
+/**
+ * Tile pack file.
+ *
+ * A tile pack stores a texture including its full mip-chain split into square tiles of fixed size.
+ * It is the source format for tiled texture streaming, where individual tiles are loaded on demand.
+ *
+ * Each tile stores tileSize x tileSize texels plus a border of borderSize texels on each side,
+ * which is replicated from the neighboring tiles (or clamped at the texture edges) to allow
+ * filtering across tile boundaries. All tiles have the same size in bytes, tiles at the right and
+ * bottom edges of a mip level are padded by clamping. Only uncompressed formats are supported.
+ *
+ * The file starts with a header, followed by a table with the file offset of each tile and the tile data.
+ * Tiles are ordered by mip level, then in row-major order within each mip level.
+ * Files are memory mapped when opened, tile data can be read from multiple threads concurrently.
+ */
+class FALCOR_API TilePack
+{
+public:
+    static constexpr uint32_t kMagic = 0x4b505446; ///< 'FTPK'
+    static constexpr uint32_t kVersion = 1;
+
+    struct Header
+    {
+        uint32_t magic = kMagic;
+        uint32_t version = kVersion;
+        ResourceFormat format = ResourceFormat::Unknown;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t mipCount = 0;
+        uint32_t tileSize = 0;
+        uint32_t borderSize = 0;
+        uint32_t tileCount = 0;
+        uint32_t reserved = 0;
+    };
+    static_assert(sizeof(Header) == 40);
+
+    /// Image data of a single mip level. Rows are tightly packed.
+    struct MipData
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        const uint8_t* pData = nullptr;
+    };
+
+    /**
+     * Write a tile pack from a list of mip levels.
+     * Throws an exception if the mip levels are invalid or the file can't be written.
+     * @param[in] path File path to write to.
+     * @param[in] format Texel format of all mip levels.
+     * @param[in] mips List of mip levels, starting from mip 0. The resolution of each level must be half of the previous one.
+     * @param[in] tileSize Tile size in texels (excluding the border).
+     * @param[in] borderSize Border size in texels.
+     */
+    static void write(
+        const std::filesystem::path& path,
+        ResourceFormat format,
+        fstd::span<const MipData> mips,
+        uint32_t tileSize,
+        uint32_t borderSize = 1
+    );
+
+    /**
+     * Write a tile pack from a bitmap.
+     * The full mip-chain is generated with a box filter. Supported are formats with 8-bit normalized channels and float formats.
+     * Throws an exception if the format is not supported or the file can't be written.
+     * @param[in] path File path to write to.
+     * @param[in] bitmap Source bitmap.
+     * @param[in] tileSize Tile size in texels (excluding the border).
+     * @param[in] borderSize Border size in texels.
+     */
+    static void write(const std::filesystem::path& path, const Bitmap& bitmap, uint32_t tileSize, uint32_t borderSize = 1);
+
+    /**
+     * Convert an image file to a tile pack.
+     * DDS files are loaded using ImageIO (only the first image is used), all other formats are loaded as a Bitmap.
+     * Throws an exception if the image can't be loaded or the tile pack can't be written.
+     * @param[in] srcPath Image file to load.
+     * @param[in] dstPath File path to write to.
+     * @param[in] tileSize Tile size in texels (excluding the border).
+     * @param[in] borderSize Border size in texels.
+     * @param[in] importFlags Flags for the image import.
+     */
+    static void convertImage(
+        const std::filesystem::path& srcPath,
+        const std::filesystem::path& dstPath,
+        uint32_t tileSize,
+        uint32_t borderSize = 1,
+        Bitmap::ImportFlags importFlags = Bitmap::ImportFlags::None
+    );
+
+    /**
+     * Generate the full mip-chain of an image with a box filter.
+     * sRGB formats are filtered in linear space.
+     * Throws an exception if the format is not supported.
+     * @param[in] format Texel format.
+     * @param[in] mip0 Image data of mip 0.
+     * @return Image data of all mip levels below mip 0, starting from mip 1.
+     */
+    static std::vector<std::vector<uint8_t>> generateMips(ResourceFormat format, const MipData& mip0);
+
+    /**
+     * Open a tile pack.
+     * Throws an exception if the file can't be opened or is invalid.
+     * @param[in] path File path.
+     */
+    TilePack(const std::filesystem::path& path);
+
+    const std::filesystem::path& getPath() const { return mPath; }
+    ResourceFormat getFormat() const { return mHeader.format; }
+    uint32_t getWidth() const { return mHeader.width; }
+    uint32_t getHeight() const { return mHeader.height; }
+    uint32_t getMipCount() const { return mHeader.mipCount; }
+    uint32_t getTileSize() const { return mHeader.tileSize; }
+    uint32_t getBorderSize() const { return mHeader.borderSize; }
+    uint32_t getTileCount() const { return mHeader.tileCount; }
+
+    /// Get the tile size in texels including the border.
+    uint32_t getPaddedTileSize() const { return mHeader.tileSize + 2 * mHeader.borderSize; }
+
+    /// Get the size of a tile in bytes.
+    size_t getTileByteSize() const { return mTileByteSize; }
+
+    /// Get the number of tiles in each dimension of a mip level.
+    uint2 getTileCount(uint32_t mip) const;
+
+    /**
+     * Get the data of a tile.
+     * @param[in] mip Mip level.
+     * @param[in] tile Tile coordinate within the mip level.
+     * @return Pointer to the tile data of getTileByteSize() bytes. The data remains valid for the lifetime of the tile pack.
+     */
+    const uint8_t* getTileData(uint32_t mip, uint2 tile) const;
+
+private:
+    std::filesystem::path mPath;
+    MemoryMappedFile mFile;
+    Header mHeader;
+    size_t mTileByteSize = 0;
+    std::vector<uint32_t> mMipTileOffsets; ///< Index of the first tile of each mip level.
+    const uint64_t* mTileOffsets = nullptr;
+};
+} // namespace Falcor
@@ -0,0 +1,223 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TilePageTable.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <unordered_set>
+
+namespace Falcor
+{
+TilePageTable::TilePageTable(uint32_t slotCount)
+{
+    FALCOR_CHECK(slotCount > 0, "Tile page table requires at least one slot.");
+    mSlotTiles.resize(slotCount, kNoTile);
+    mSlotLastUsedFrame.resize(slotCount, 0);
+    mSlotLruIterators.resize(slotCount);
+    mFreeSlots.resize(slotCount);
+    // Hand out low slots first.
+    for (uint32_t i = 0; i < slotCount; i++)
+        mFreeSlots[i] = slotCount - 1 - i;
+}
+
+uint32_t TilePageTable::addTexture(std::vector<uint2> mipTileCounts)
+{
+    FALCOR_CHECK(!mipTileCounts.empty() && mipTileCounts.size() <= 256, "Invalid mip count {}.", mipTileCounts.size());
+    for (const auto& count : mipTileCounts)
+        FALCOR_CHECK(count.x > 0 && count.y > 0 && count.x <= 0x10000 && count.y <= 0x10000, "Invalid tile count ({}, {}).", count.x, count.y);
+    FALCOR_CHECK(mTextures.size() < (1 << 24), "Too many streamed textures.");
+
+    mTextures.push_back(std::move(mipTileCounts));
+    return (uint32_t)mTextures.size() - 1;
+}
+
+bool TilePageTable::isValidTile(const TileID& tile) const
+{
+    if (tile.textureID >= mTextures.size())
+        return false;
+    const auto& mips = mTextures[tile.textureID];
+    return tile.mip < mips.size() && tile.x < mips[tile.mip].x && tile.y < mips[tile.mip].y;
+}
+
+std::vector<TileID> TilePageTable::processFeedback(fstd::span<const TileID> requests, uint32_t maxLoads)
+{
+    // Remove invalid and duplicate requests.
+    std::vector<uint64_t> requested;
+    requested.reserve(requests.size());
+    for (const auto& tile : requests)
+    {
+        if (isValidTile(tile))
+            requested.push_back(tile.pack());
+    }
+    std::sort(requested.begin(), requested.end());
+    requested.erase(std::unique(requested.begin(), requested.end()), requested.end());
+
+    mStats.requestCount += requested.size();
+    for (uint64_t packed : requested)
+    {
+        if (auto it = mEntries.find(packed); it != mEntries.end() && it->second.slot != kInvalidSlot)
+            mStats.hitCount++;
+    }
+
+    // Mark the requested tiles and their ancestors as used and collect the tiles that are missing.
+    // Ancestors are kept resident as fallbacks while finer tiles are loading.
+    std::vector<TileID> missing;
+    std::unordered_set<uint64_t> visited;
+    for (uint64_t packed : requested)
+    {
+        TileID tile = TileID::unpack(packed);
+        const uint32_t mipCount = (uint32_t)mTextures[tile.textureID].size();
+        while (visited.insert(tile.pack()).second)
+        {
+            if (auto it = mEntries.find(tile.pack()); it != mEntries.end())
+            {
+                it->second.lastUsedFrame = mFrame;
+                if (it->second.slot != kInvalidSlot)
+                    touchSlot(it->second.slot);
+            }
+            else
+            {
+                missing.push_back(tile);
+            }
+
+            if (tile.mip + 1 >= mipCount)
+                break;
+            tile = tile.getParent();
+        }
+    }
+
+    // Schedule coarse tiles first.
+    std::stable_sort(missing.begin(), missing.end(), [](const TileID& a, const TileID& b) { return a.mip > b.mip; });
+    if (missing.size() > maxLoads)
+        missing.resize(maxLoads);
+
+    for (const auto& tile : missing)
+        mEntries[tile.pack()] = Entry{kInvalidSlot, true, mFrame};
+    mLoadingCount += (uint32_t)missing.size();
+    mStats.scheduleCount += missing.size();
+
+    return missing;
+}
+
+TilePageTable::Allocation TilePageTable::completeLoad(const TileID& tile)
+{
+    const uint64_t packed = tile.pack();
+    auto it = mEntries.find(packed);
+    FALCOR_CHECK(it != mEntries.end() && it->second.loading, "Tile is not loading.");
+    Entry& entry = it->second;
+    entry.loading = false;
+    mLoadingCount--;
+
+    Allocation allocation;
+    uint32_t slot = kInvalidSlot;
+    if (!mFreeSlots.empty())
+    {
+        slot = mFreeSlots.back();
+        mFreeSlots.pop_back();
+    }
+    else
+    {
+        // Evict the least recently used tile, unless it is in use by the current frame.
+        uint32_t lruSlot = mLruSlots.front();
+        if (mSlotLastUsedFrame[lruSlot] >= mFrame)
+        {
+            mEntries.erase(it);
+            mStats.dropCount++;
+            return allocation;
+        }
+
+        allocation.hasEvictedTile = true;
+        allocation.evictedTile = TileID::unpack(mSlotTiles[lruSlot]);
+        mEntries.erase(mSlotTiles[lruSlot]);
+        mLruSlots.erase(mSlotLruIterators[lruSlot]);
+        mStats.evictionCount++;
+        slot = lruSlot;
+    }
+
+    entry.slot = slot;
+    mSlotTiles[slot] = packed;
+    mSlotLastUsedFrame[slot] = entry.lastUsedFrame;
+    mSlotLruIterators[slot] = mLruSlots.insert(mLruSlots.end(), slot);
+    mStats.loadCount++;
+
+    allocation.slot = slot;
+    return allocation;
+}
+
+void TilePageTable::cancelLoad(const TileID& tile)
+{
+    auto it = mEntries.find(tile.pack());
+    FALCOR_CHECK(it != mEntries.end() && it->second.loading, "Tile is not loading.");
+    mEntries.erase(it);
+    mLoadingCount--;
+}
+
+uint32_t TilePageTable::getSlot(const TileID& tile) const
+{
+    auto it = mEntries.find(tile.pack());
+    return it != mEntries.end() ? it->second.slot : kInvalidSlot;
+}
+
+bool TilePageTable::isLoading(const TileID& tile) const
+{
+    auto it = mEntries.find(tile.pack());
+    return it != mEntries.end() && it->second.loading;
+}
+
+uint32_t TilePageTable::findResidentTile(const TileID& tile, TileID& residentTile) const
+{
+    if (!isValidTile(tile))
+        return kInvalidSlot;
+
+    const uint32_t mipCount = (uint32_t)mTextures[tile.textureID].size();
+    for (TileID t = tile; t.mip < mipCount; t = t.getParent())
+    {
+        uint32_t slot = getSlot(t);
+        if (slot != kInvalidSlot)
+        {
+            residentTile = t;
+            return slot;
+        }
+    }
+    return kInvalidSlot;
+}
+
+bool TilePageTable::getSlotTile(uint32_t slot, TileID& tile) const
+{
+    FALCOR_CHECK(slot < mSlotTiles.size(), "Slot {} is out of range.", slot);
+    if (mSlotTiles[slot] == kNoTile)
+        return false;
+    tile = TileID::unpack(mSlotTiles[slot]);
+    return true;
+}
+
+void TilePageTable::touchSlot(uint32_t slot)
+{
+    mLruSlots.splice(mLruSlots.end(), mLruSlots, mSlotLruIterators[slot]);
+    mSlotLastUsedFrame[slot] = mFrame;
+}
+} // namespace Falcor
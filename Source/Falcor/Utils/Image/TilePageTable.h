@@ -0,0 +1,197 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <fstd/span.h>
+
+namespace Falcor
+{
+/**
+ * Identifies a tile of a streamed texture.
+ */
+struct TileID
+{
+    uint32_t textureID = 0;
+    uint32_t mip = 0;
+    uint32_t x = 0;
+    uint32_t y = 0;
+
+    /// Pack into 64 bits (24 bits texture ID, 8 bits mip level, 16 bits per tile coordinate).
+    uint64_t pack() const { return (uint64_t(textureID) << 40) | (uint64_t(mip) << 32) | (uint64_t(y) << 16) | uint64_t(x); }
+
+    static TileID unpack(uint64_t packed)
+    {
+        return TileID{uint32_t(packed >> 40), uint32_t(packed >> 32) & 0xff, uint32_t(packed) & 0xffff, uint32_t(packed >> 16) & 0xffff};
+    }
+
+    /// Get the tile covering this tile in the next coarser mip level.
+    TileID getParent() const { return TileID{textureID, mip + 1, x / 2, y / 2}; }
+
+    bool operator==(const TileID& other) const { return pack() == other.pack(); }
+    bool operator!=(const TileID& other) const { return pack() != other.pack(); }
+    bool operator<(const TileID& other) const { return pack() < other.pack(); }
+};
+
+/**
+ * CPU-side page table for tiled texture streaming.
+ *
+ * Maps tiles of streamed textures to slots of a fixed-size physical tile pool. The number of slots
+ * is determined by the memory budget. Tiles are made resident in least-recently-used order:
+ * when all slots are occupied, the tile that has been requested least recently is evicted.
+ * Tiles requested in the current frame are never evicted.
+ *
+ * The page table only manages residency, it does not own any tile data. It is driven by
+ * feedback (lists of requested tiles per frame) and by notifications of finished tile loads.
+ * This makes it independent of the GPU and of the tile source, so it can be tested using recorded feedback.
+ */
+class FALCOR_API TilePageTable
+{
+public:
+    static constexpr uint32_t kInvalidSlot = std::numeric_limits<uint32_t>::max();
+
+    struct Stats
+    {
+        uint64_t requestCount = 0;  ///< Number of requested tiles (after removing duplicates within a frame).
+        uint64_t hitCount = 0;      ///< Number of requested tiles that were resident.
+        uint64_t scheduleCount = 0; ///< Number of tiles scheduled for loading.
+        uint64_t loadCount = 0;     ///< Number of loaded tiles that were made resident.
+        uint64_t evictionCount = 0; ///< Number of evicted tiles.
+        uint64_t dropCount = 0;     ///< Number of loaded tiles dropped because all slots were in use in the current frame.
+    };
+
+    /// Result of making a tile resident.
+    struct Allocation
+    {
+        uint32_t slot = kInvalidSlot; ///< Slot of the tile, or kInvalidSlot if the tile was dropped.
+        bool hasEvictedTile = false;  ///< True if a tile was evicted to free the slot.
+        TileID evictedTile;           ///< Evicted tile that previously occupied the slot.
+    };
+
+    /**
+     * Constructor.
+     * @param[in] slotCount Number of slots in the physical tile pool.
+     */
+    TilePageTable(uint32_t slotCount);
+
+    /**
+     * Register a streamed texture.
+     * @param[in] mipTileCounts Number of tiles in each dimension per mip level, starting from mip 0.
+     * @return Texture ID used in tile IDs.
+     */
+    uint32_t addTexture(std::vector<uint2> mipTileCounts);
+
+    /// Get the number of registered textures.
+    uint32_t getTextureCount() const { return (uint32_t)mTextures.size(); }
+
+    /// Check if a tile ID refers to a valid tile of a registered texture.
+    bool isValidTile(const TileID& tile) const;
+
+    /**
+     * Begin a new frame. Tiles requested in the previous frames become candidates for eviction.
+     */
+    void beginFrame() { mFrame++; }
+
+    /**
+     * Process feedback of the current frame.
+     * Requested tiles and all their ancestors are marked as used. Tiles that are neither resident nor loading
+     * are marked as loading and returned, ordered from coarse to fine mip levels so that coarser fallbacks become
+     * resident first. Tiles that don't refer to a registered texture are ignored.
+     * @param[in] requests Requested tiles. The list may contain duplicates.
+     * @param[in] maxLoads Maximum number of tiles to schedule for loading.
+     * @return List of tiles to load. Each of these must later be passed to completeLoad() or cancelLoad().
+     */
+    std::vector<TileID> processFeedback(fstd::span<const TileID> requests, uint32_t maxLoads = std::numeric_limits<uint32_t>::max());
+
+    /**
+     * Make a loaded tile resident.
+     * The tile is assigned a free slot, or the slot of the least recently used tile, which is evicted.
+     * If all slots are occupied by tiles used in the current frame, the tile is dropped.
+     * @param[in] tile Tile that finished loading.
+     * @return Slot assignment.
+     */
+    Allocation completeLoad(const TileID& tile);
+
+    /**
+     * Cancel loading a tile, e.g. if loading failed. The tile can be scheduled again later.
+     * @param[in] tile Tile that was scheduled for loading.
+     */
+    void cancelLoad(const TileID& tile);
+
+    /// Get the slot of a resident tile, or kInvalidSlot if not resident.
+    uint32_t getSlot(const TileID& tile) const;
+
+    bool isResident(const TileID& tile) const { return getSlot(tile) != kInvalidSlot; }
+    bool isLoading(const TileID& tile) const;
+
+    /**
+     * Find the finest resident tile covering a tile, i.e., the tile itself or its closest resident ancestor.
+     * @param[in] tile Tile to look up.
+     * @param[out] residentTile The resident tile, if found.
+     * @return Slot of the resident tile, or kInvalidSlot if neither the tile nor any ancestor is resident.
+     */
+    uint32_t findResidentTile(const TileID& tile, TileID& residentTile) const;
+
+    /// Get the tile occupying a slot. Returns false if the slot is free.
+    bool getSlotTile(uint32_t slot, TileID& tile) const;
+
+    uint32_t getSlotCount() const { return (uint32_t)mSlotTiles.size(); }
+    uint32_t getResidentCount() const { return getSlotCount() - (uint32_t)mFreeSlots.size(); }
+    uint32_t getLoadingCount() const { return mLoadingCount; }
+    uint64_t getFrame() const { return mFrame; }
+    const Stats& getStats() const { return mStats; }
+
+private:
+    static constexpr uint64_t kNoTile = std::numeric_limits<uint64_t>::max();
+
+    struct Entry
+    {
+        uint32_t slot = kInvalidSlot; ///< Slot if resident.
+        bool loading = false;         ///< True if the tile is scheduled for loading.
+        uint64_t lastUsedFrame = 0;   ///< Frame in which the tile was last requested.
+    };
+
+    void touchSlot(uint32_t slot);
+
+    std::vector<std::vector<uint2>> mTextures;     ///< Tile counts per mip level for each texture.
+    std::unordered_map<uint64_t, Entry> mEntries;  ///< Resident and loading tiles, indexed by packed tile ID.
+    std::vector<uint64_t> mSlotTiles;              ///< Packed tile ID per slot, or kNoTile if free.
+    std::vector<uint64_t> mSlotLastUsedFrame;      ///< Frame in which the tile in each slot was last requested.
+    std::vector<uint32_t> mFreeSlots;              ///< List of free slots.
+    std::list<uint32_t> mLruSlots;                 ///< Occupied slots, least recently used first.
+    std::vector<std::list<uint32_t>::iterator> mSlotLruIterators; ///< Position of each occupied slot in the LRU list.
+    uint32_t mLoadingCount = 0;
+    uint64_t mFrame = 0;
+    Stats mStats;
+};
+} // namespace Falcor
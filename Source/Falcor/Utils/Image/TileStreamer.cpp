@@ -0,0 +1,228 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TileStreamer.h"
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kTraceMagic = 0x52544654; ///< 'FTTR'
+const uint32_t kTraceVersion = 1;
+} // namespace
+
+void TileFeedbackTrace::write(const std::filesystem::path& path) const
+{
+    std::ofstream fs(path, std::ios_base::binary);
+    if (!fs)
+        FALCOR_THROW("Failed to create tile feedback trace '{}'.", path);
+
+    uint32_t header[3] = {kTraceMagic, kTraceVersion, (uint32_t)frames.size()};
+    fs.write(reinterpret_cast<const char*>(header), sizeof(header));
+    std::vector<uint64_t> packed;
+    for (const auto& frame : frames)
+    {
+        uint32_t count = (uint32_t)frame.size();
+        packed.resize(count);
+        std::transform(frame.begin(), frame.end(), packed.begin(), [](const TileID& tile) { return tile.pack(); });
+        fs.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        fs.write(reinterpret_cast<const char*>(packed.data()), packed.size() * sizeof(uint64_t));
+    }
+
+    if (!fs)
+        FALCOR_THROW("Failed to write tile feedback trace '{}'.", path);
+}
+
+TileFeedbackTrace TileFeedbackTrace::read(const std::filesystem::path& path)
+{
+    std::ifstream fs(path, std::ios_base::binary);
+    if (!fs)
+        FALCOR_THROW("Failed to open tile feedback trace '{}'.", path);
+
+    uint32_t header[3] = {};
+    fs.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!fs || header[0] != kTraceMagic || header[1] != kTraceVersion)
+        FALCOR_THROW("File '{}' is not a valid tile feedback trace.", path);
+
+    TileFeedbackTrace trace;
+    trace.frames.resize(header[2]);
+    std::vector<uint64_t> packed;
+    for (auto& frame : trace.frames)
+    {
+        uint32_t count = 0;
+        fs.read(reinterpret_cast<char*>(&count), sizeof(count));
+        packed.resize(count);
+        fs.read(reinterpret_cast<char*>(packed.data()), packed.size() * sizeof(uint64_t));
+        if (!fs)
+            FALCOR_THROW("Tile feedback trace '{}' is truncated.", path);
+        frame.resize(count);
+        std::transform(packed.begin(), packed.end(), frame.begin(), TileID::unpack);
+    }
+
+    return trace;
+}
+
+TileStreamer::TileStreamer(ResourceFormat format, uint32_t paddedTileSize, const Options& options, UploadCallback upload, EvictCallback evict)
+    : mFormat(format)
+    , mPaddedTileSize(paddedTileSize)
+    , mTileByteSize(size_t(paddedTileSize) * paddedTileSize * getFormatBytesPerBlock(format))
+    , mOptions(options)
+    , mUpload(std::move(upload))
+    , mEvict(std::move(evict))
+    , mPageTable((uint32_t)std::clamp<uint64_t>(options.memoryBudget / mTileByteSize, 1, std::numeric_limits<uint32_t>::max() - 1))
+    , mLoader(
+          std::max(options.threadCount, 1u),
+          {
+              [](LoadJob& job) { loadTile(job); },
+              [this](LoadJob& job, bool success) { completeLoad(job, success); },
+              [](const LoadJob& job)
+              {
+                  return fmt::format(
+                      "load tile ({}, {}) of mip {} from '{}'", job.tile.x, job.tile.y, job.tile.mip, job.pTilePack->getPath()
+                  );
+              },
+          }
+      )
+{
+    FALCOR_CHECK(mUpload, "Missing upload callback.");
+    FALCOR_CHECK(options.threadCount > 0, "Tile streamer requires at least one worker thread.");
+}
+
+TileStreamer::~TileStreamer() = default;
+
+uint32_t TileStreamer::addTexture(std::shared_ptr<const TilePack> pTilePack)
+{
+    FALCOR_CHECK(pTilePack, "Missing tile pack.");
+    FALCOR_CHECK(
+        pTilePack->getFormat() == mFormat && pTilePack->getPaddedTileSize() == mPaddedTileSize,
+        "Tile pack '{}' doesn't match the format or tile size of the tile streamer.",
+        pTilePack->getPath()
+    );
+
+    std::vector<uint2> mipTileCounts(pTilePack->getMipCount());
+    for (uint32_t mip = 0; mip < pTilePack->getMipCount(); mip++)
+        mipTileCounts[mip] = pTilePack->getTileCount(mip);
+
+    uint32_t textureID = mPageTable.addTexture(std::move(mipTileCounts));
+
+    mTilePacks.push_back(std::move(pTilePack));
+    FALCOR_ASSERT(textureID + 1 == mTilePacks.size());
+    return textureID;
+}
+
+uint32_t TileStreamer::addTexture(const std::filesystem::path& path)
+{
+    return addTexture(std::make_shared<const TilePack>(path));
+}
+
+void TileStreamer::submitFeedback(fstd::span<const TileID> requests)
+{
+    if (mRecordTrace)
+        mTrace.frames.emplace_back(requests.begin(), requests.end());
+
+    mPageTable.beginFrame();
+    std::vector<TileID> loads = mPageTable.processFeedback(requests, mOptions.maxLoadsPerFrame);
+    if (loads.empty())
+        return;
+
+    auto lock = mLoader.lock();
+    for (const TileID& tile : loads)
+        mLoader.push(lock, LoadJob{tile, mTilePacks[tile.textureID], {}});
+}
+
+uint32_t TileStreamer::update()
+{
+    std::vector<LoadedTile> loadedTiles;
+    {
+        auto lock = mLoader.lock();
+        std::swap(loadedTiles, mLoadedTiles);
+        mStats.loadedByteCount = mLoadedByteCount;
+    }
+
+    uint32_t residentCount = 0;
+    for (auto& loaded : loadedTiles)
+    {
+        if (loaded.data.empty())
+        {
+            mPageTable.cancelLoad(loaded.tile);
+            continue;
+        }
+        mStats.loadedTileCount++;
+
+        auto allocation = mPageTable.completeLoad(loaded.tile);
+        if (allocation.slot == TilePageTable::kInvalidSlot)
+            continue;
+
+        if (allocation.hasEvictedTile && mEvict)
+            mEvict(allocation.evictedTile, allocation.slot);
+        mUpload(loaded.tile, allocation.slot, loaded.data.data(), loaded.data.size());
+        mStats.uploadedTileCount++;
+        residentCount++;
+    }
+
+    return residentCount;
+}
+
+uint32_t TileStreamer::flush()
+{
+    mLoader.flush();
+    return update();
+}
+
+void TileStreamer::startTraceRecording()
+{
+    mRecordTrace = true;
+    mTrace = {};
+}
+
+TileFeedbackTrace TileStreamer::stopTraceRecording()
+{
+    mRecordTrace = false;
+    return std::move(mTrace);
+}
+
+void TileStreamer::loadTile(LoadJob& job)
+{
+    // Copy the tile data out of the memory mapped file. This is where the file is actually read.
+    const uint8_t* pData = job.pTilePack->getTileData(job.tile.mip, uint2(job.tile.x, job.tile.y));
+    job.data.assign(pData, pData + job.pTilePack->getTileByteSize());
+}
+
+void TileStreamer::completeLoad(LoadJob& job, bool success)
+{
+    // Failed loads are passed on with empty data, so that update() cancels them in the page table.
+    if (!success)
+        job.data.clear();
+    mLoadedByteCount += job.data.size();
+    mLoadedTiles.push_back(LoadedTile{job.tile, std::move(job.data)});
+}
+} // namespace Falcor
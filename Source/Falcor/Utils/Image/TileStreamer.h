@@ -0,0 +1,198 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "TilePack.h"
+#include "TilePageTable.h"
+#include "Core/Macros.h"
+#include "Utils/WorkerQueue.h"
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <fstd/span.h>
+
+namespace Falcor
+{
+/**
+ * Recorded tile feedback, i.e., the list of requested tiles for a sequence of frames.
+ * Traces allow replaying the streaming behavior of a session without a GPU.
+ */
+struct FALCOR_API TileFeedbackTrace
+{
+    std::vector<std::vector<TileID>> frames; ///< Requested tiles per frame.
+
+    /**
+     * Write the trace to a binary file.
+     * Throws an exception if the file can't be written.
+     */
+    void write(const std::filesystem::path& path) const;
+
+    /**
+     * Read a trace from a binary file.
+     * Throws an exception if the file can't be read or is invalid.
+     */
+    static TileFeedbackTrace read(const std::filesystem::path& path);
+};
+
+/**
+ * Tiled texture streamer.
+ *
+ * Streams tiles of textures stored as tile packs into a fixed-size physical tile pool.
+ * Each frame, the renderer submits feedback (the tiles requested by the frame). The streamer
+ * updates residency in its page table and schedules loads of missing tiles on worker threads.
+ * Finished loads are applied on the calling thread in update(), which assigns slots and
+ * invokes the upload and evict callbacks. The callbacks are where the owner of the physical
+ * tile pool (e.g. a GPU texture atlas and indirection texture) is updated.
+ *
+ * All textures of a streamer share the physical tile pool, so they must use the same format and tile size.
+ * All functions must be called from the same thread.
+ */
+class FALCOR_API TileStreamer
+{
+public:
+    /// Called when a tile was made resident in a slot.
+    using UploadCallback = std::function<void(const TileID& tile, uint32_t slot, const uint8_t* pData, size_t size)>;
+    /// Called when a tile was evicted from a slot.
+    using EvictCallback = std::function<void(const TileID& tile, uint32_t slot)>;
+
+    struct Options
+    {
+        uint64_t memoryBudget = 256ull << 20; ///< Size of the physical tile pool in bytes.
+        uint32_t maxLoadsPerFrame = 64;       ///< Maximum number of tile loads scheduled per frame.
+        uint32_t threadCount = 2;             ///< Number of worker threads loading tiles.
+    };
+
+    struct Stats
+    {
+        uint64_t loadedTileCount = 0;  ///< Number of tiles loaded by the workers.
+        uint64_t loadedByteCount = 0;  ///< Number of bytes loaded by the workers.
+        uint64_t uploadedTileCount = 0; ///< Number of tiles passed to the upload callback.
+    };
+
+    /**
+     * Constructor.
+     * @param[in] format Texel format of the streamed textures.
+     * @param[in] paddedTileSize Tile size in texels including the border.
+     * @param[in] options Streaming options.
+     * @param[in] upload Callback invoked when a tile was made resident.
+     * @param[in] evict Callback invoked when a tile was evicted (optional).
+     */
+    TileStreamer(ResourceFormat format, uint32_t paddedTileSize, const Options& options, UploadCallback upload, EvictCallback evict = {});
+
+    /**
+     * Destructor. Blocks until all worker threads have terminated.
+     */
+    ~TileStreamer();
+
+    TileStreamer(const TileStreamer&) = delete;
+    TileStreamer& operator=(const TileStreamer&) = delete;
+
+    /**
+     * Add a texture to stream.
+     * Throws an exception if the format or tile size doesn't match the streamer.
+     * @param[in] pTilePack Tile pack holding the texture.
+     * @return Texture ID used in tile IDs.
+     */
+    uint32_t addTexture(std::shared_ptr<const TilePack> pTilePack);
+
+    /**
+     * Add a texture to stream from a tile pack file.
+     * Throws an exception if the file can't be opened, or the format or tile size doesn't match the streamer.
+     * @param[in] path Tile pack file.
+     * @return Texture ID used in tile IDs.
+     */
+    uint32_t addTexture(const std::filesystem::path& path);
+
+    /**
+     * Submit the feedback of a frame.
+     * This begins a new frame in the page table and schedules loads of the requested tiles that are not resident.
+     * @param[in] requests Tiles requested by the frame.
+     */
+    void submitFeedback(fstd::span<const TileID> requests);
+
+    /**
+     * Apply finished tile loads. Invokes the upload and evict callbacks.
+     * @return Number of tiles made resident.
+     */
+    uint32_t update();
+
+    /**
+     * Wait for all scheduled tile loads to finish and apply them.
+     * @return Number of tiles made resident.
+     */
+    uint32_t flush();
+
+    /// Start recording submitted feedback. Clears a previously recorded trace.
+    void startTraceRecording();
+
+    /// Stop recording submitted feedback and return the recorded trace.
+    TileFeedbackTrace stopTraceRecording();
+
+    const TilePageTable& getPageTable() const { return mPageTable; }
+    const std::shared_ptr<const TilePack>& getTilePack(uint32_t textureID) const { return mTilePacks.at(textureID); }
+    size_t getTileByteSize() const { return mTileByteSize; }
+    const Options& getOptions() const { return mOptions; }
+    const Stats& getStats() const { return mStats; }
+
+private:
+    struct LoadedTile
+    {
+        TileID tile;
+        std::vector<uint8_t> data; ///< Tile data, empty if loading failed.
+    };
+
+    struct LoadJob
+    {
+        TileID tile;
+        std::shared_ptr<const TilePack> pTilePack;
+        std::vector<uint8_t> data;
+    };
+
+    static void loadTile(LoadJob& job);
+    void completeLoad(LoadJob& job, bool success);
+
+    ResourceFormat mFormat;
+    uint32_t mPaddedTileSize;
+    size_t mTileByteSize;
+    Options mOptions;
+    UploadCallback mUpload;
+    EvictCallback mEvict;
+
+    TilePageTable mPageTable;
+    std::vector<std::shared_ptr<const TilePack>> mTilePacks; ///< Tile packs indexed by texture ID.
+
+    bool mRecordTrace = false;
+    TileFeedbackTrace mTrace;
+    Stats mStats;
+
+    // Tile loading. Guarded by the loader mutex.
+    std::vector<LoadedTile> mLoadedTiles; ///< Tiles that finished loading.
+    uint64_t mLoadedByteCount = 0;        ///< Number of bytes loaded by the workers.
+    WorkerQueue<LoadJob> mLoader;         ///< Loads tiles on the worker threads. Declared last to be destroyed first.
+};
+} // namespace Falcor
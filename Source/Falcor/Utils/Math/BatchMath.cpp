@@ -0,0 +1,769 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BatchMath.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define FALCOR_BATCH_MATH_X64 1
+#include <immintrin.h>
+#if FALCOR_MSVC
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define FALCOR_BATCH_MATH_NEON 1
+#include <arm_neon.h>
+#endif
+
+// The AVX2 kernels are compiled for AVX2 with a function attribute and are only called if the CPU supports it.
+// FMA is deliberately not enabled, so the compiler can't contract the multiplies and adds of the kernels.
+// MSVC allows using the intrinsics without changing the target of the function.
+#if FALCOR_MSVC
+#define FALCOR_TARGET_AVX2
+#else
+#define FALCOR_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace Falcor
+{
+namespace math
+{
+namespace
+{
+/// Access element i of a strided array.
+template<typename T>
+T& element(T* p, size_t i, size_t stride)
+{
+    using Byte = std::conditional_t<std::is_const_v<T>, const uint8_t, uint8_t>;
+    return *reinterpret_cast<T*>(reinterpret_cast<Byte*>(p) + i * stride);
+}
+
+/// Kernel functions for one SIMD level.
+struct Kernels
+{
+    void (*transformPoints)(const float4x4&, const float3*, float3*, size_t, size_t, size_t);
+    void (*transformVectors)(const float3x3&, const float3*, float3*, size_t, size_t, size_t);
+    void (*transformNormals)(const float3x3&, const float3*, float3*, size_t, size_t, size_t);
+    AABB (*computePointBounds)(const float3*, size_t, size_t);
+    AABB (*computeBoxBounds)(const AABB*, size_t, size_t);
+    void (*mulAffine)(const float4x4*, const float4x4*, float4x4*, size_t);
+    void (*inverseAffine)(const float4x4*, float4x4*, size_t);
+    void (*inverseTransposeAffine)(const float4x4*, float4x4*, size_t);
+    void (*composeTransforms)(const float3*, const quatf*, const float3*, size_t, float4x4*, size_t);
+};
+
+/// Reference kernels using the regular math library.
+namespace scalar
+{
+void transformPoints(const float4x4& m, const float3* pIn, float3* pOut, size_t count, size_t inStride, size_t outStride)
+{
+    for (size_t i = 0; i < count; i++)
+        element(pOut, i, outStride) = transformPoint(m, element(pIn, i, inStride));
+}
+
+void transformVectors(const float3x3& m, const float3* pIn, float3* pOut, size_t count, size_t inStride, size_t outStride)
+{
+    for (size_t i = 0; i < count; i++)
+        element(pOut, i, outStride) = transformVector(m, element(pIn, i, inStride));
+}
+
+void transformNormals(const float3x3& m, const float3* pIn, float3* pOut, size_t count, size_t inStride, size_t outStride)
+{
+    for (size_t i = 0; i < count; i++)
+        element(pOut, i, outStride) = normalize(transformVector(m, element(pIn, i, inStride)));
+}
+
+AABB computePointBounds(const float3* pPoints, size_t count, size_t stride)
+{
+    AABB bounds;
+    for (size_t i = 0; i < count; i++)
+        bounds.include(element(pPoints, i, stride));
+    return bounds;
+}
+
+AABB computeBoxBounds(const AABB* pBoxes, size_t count, size_t stride)
+{
+    AABB bounds;
+    for (size_t i = 0; i < count; i++)
+        bounds.include(element(pBoxes, i, stride));
+    return bounds;
+}
+
+void mulAffine(const float4x4* pA, const float4x4* pB, float4x4* pOut, size_t count)
+{
+    for (size_t n = 0; n < count; n++)
+    {
+        const float4x4 a = pA[n];
+        const float4x4 b = pB[n];
+        float4x4& r = pOut[n];
+        for (int i = 0; i < 3; i++)
+            r[i] = a[i][0] * b[0] + a[i][1] * b[1] + a[i][2] * b[2] + float4(0.f, 0.f, 0.f, a[i][3]);
+        r[3] = float4(0.f, 0.f, 0.f, 1.f);
+    }
+}
+
+/// The rows of the inverse transpose of the 3x3 part are the cross products of its rows divided by the determinant.
+float4x4 inverseTransposeAffine(const float4x4& m)
+{
+    const float3 r0 = m[0].xyz();
+    const float3 r1 = m[1].xyz();
+    const float3 r2 = m[2].xyz();
+    float3 c0 = cross(r1, r2);
+    float3 c1 = cross(r2, r0);
+    float3 c2 = cross(r0, r1);
+    const float invDet = 1.f / dot(r0, c0);
+    c0 *= invDet;
+    c1 *= invDet;
+    c2 *= invDet;
+    const float3 t = -(c0 * m[0][3] + c1 * m[1][3] + c2 * m[2][3]);
+
+    float4x4 r;
+    r[0] = float4(c0, 0.f);
+    r[1] = float4(c1, 0.f);
+    r[2] = float4(c2, 0.f);
+    r[3] = float4(t, 1.f);
+    return r;
+}
+
+void inverseAffine(const float4x4* pIn, float4x4* pOut, size_t count)
+{
+    for (size_t n = 0; n < count; n++)
+        pOut[n] = transpose(inverseTransposeAffine(pIn[n]));
+}
+
+void inverseTransposeAffine(const float4x4* pIn, float4x4* pOut, size_t count)
+{
+    for (size_t n = 0; n < count; n++)
+        pOut[n] = inverseTransposeAffine(pIn[n]);
+}
+
+void composeTransforms(
+    const float3* pTranslations,
+    const quatf* pRotations,
+    const float3* pScalings,
+    size_t inStride,
+    float4x4* pOut,
+    size_t count
+)
+{
+    for (size_t n = 0; n < count; n++)
+    {
+        const float3& translation = element(pTranslations, n, inStride);
+        const float3& scaling = element(pScalings, n, inStride);
+        float4x4 transform = matrixFromQuat(element(pRotations, n, inStride));
+        for (int r = 0; r < 3; r++)
+            transform[r] = float4(transform[r].xyz() * scaling, translation[r]);
+        pOut[n] = transform;
+    }
+}
+} // namespace scalar
+
+/**
+ * SIMD kernels operating on one vector or matrix row per register.
+ * This suits the strided layouts and gives the same results as the scalar kernels, as the operations are done in the
+ * same order. The kernels are templated on a type S wrapping the 4-wide float vector operations of an instruction set.
+ */
+template<typename S>
+struct SIMDKernels
+{
+    using V = typename S::V;
+
+    template<bool Translate, bool Normalize>
+    static void transform(const float* pColumns, const float3* pIn, float3* pOut, size_t count, size_t inStride, size_t outStride)
+    {
+        const V c0 = S::load(pColumns);
+        const V c1 = S::load(pColumns + 4);
+        const V c2 = S::load(pColumns + 8);
+        const V c3 = S::load(pColumns + 12);
+        for (size_t i = 0; i < count; i++)
+        {
+            const V p = S::load3(&element(pIn, i, inStride).x);
+            V r = S::add(S::add(S::mul(c0, S::template lane<0>(p)), S::mul(c1, S::template lane<1>(p))), S::mul(c2, S::template lane<2>(p)));
+            if constexpr (Translate)
+                r = S::add(r, c3);
+            if constexpr (Normalize)
+            {
+                const V sq = S::mul(r, r);
+                const V lengthSq = S::add(S::add(S::template lane<0>(sq), S::template lane<1>(sq)), S::template lane<2>(sq));
+                r = S::mul(r, S::div(S::splat(1.f), S::sqrt(lengthSq)));
+            }
+            S::store3(&element(pOut, i, outStride).x, r);
+        }
+    }
+
+    static void transformPoints(const float4x4& m, const float3* pIn, float3* pOut, size_t count, size_t inStride, size_t outStride)
+    {
+        const float4x4 columns = transpose(m);
+        transform<true, false>(columns.data(), pIn, pOut, count, inStride, outStride);
+    }
+
+    static void transformVectors(const float3x3& m, const float3* pIn, float3* pOut, size_t count, size_t inStride, size_t outStride)
+    {
+        const float4x4 columns = transpose(float4x4(m));
+        transform<false, false>(columns.data(), pIn, pOut, count, inStride, outStride);
+    }
+
+    static void transformNormals(const float3x3& m, const float3* pIn, float3* pOut, size_t count, size_t inStride, size_t outStride)
+    {
+        const float4x4 columns = transpose(float4x4(m));
+        transform<false, true>(columns.data(), pIn, pOut, count, inStride, outStride);
+    }
+
+    static AABB toAABB(V minPoint, V maxPoint)
+    {
+        float minValues[4], maxValues[4];
+        S::store(minValues, minPoint);
+        S::store(maxValues, maxPoint);
+        return AABB(float3(minValues[0], minValues[1], minValues[2]), float3(maxValues[0], maxValues[1], maxValues[2]));
+    }
+
+    static AABB computePointBounds(const float3* pPoints, size_t count, size_t stride)
+    {
+        V minPoint = S::splat(std::numeric_limits<float>::infinity());
+        V maxPoint = S::splat(-std::numeric_limits<float>::infinity());
+        for (size_t i = 0; i < count; i++)
+        {
+            const V p = S::load3(&element(pPoints, i, stride).x);
+            minPoint = S::min(p, minPoint);
+            maxPoint = S::max(p, maxPoint);
+        }
+        return toAABB(minPoint, maxPoint);
+    }
+
+    static AABB computeBoxBounds(const AABB* pBoxes, size_t count, size_t stride)
+    {
+        V minPoint = S::splat(std::numeric_limits<float>::infinity());
+        V maxPoint = S::splat(-std::numeric_limits<float>::infinity());
+        for (size_t i = 0; i < count; i++)
+        {
+            const AABB& box = element(pBoxes, i, stride);
+            minPoint = S::min(S::load3(&box.minPoint.x), minPoint);
+            maxPoint = S::max(S::load3(&box.maxPoint.x), maxPoint);
+        }
+        return toAABB(minPoint, maxPoint);
+    }
+
+    static void mulAffine(const float4x4* pA, const float4x4* pB, float4x4* pOut, size_t count)
+    {
+        for (size_t n = 0; n < count; n++)
+        {
+            const float* a = pA[n].data();
+            const float* b = pB[n].data();
+            const V b0 = S::load(b);
+            const V b1 = S::load(b + 4);
+            const V b2 = S::load(b + 8);
+            V r[3];
+            for (int i = 0; i < 3; i++)
+            {
+                const V ai = S::load(a + 4 * i);
+                const V t = S::set(0.f, 0.f, 0.f, a[4 * i + 3]);
+                r[i] = S::add(
+                    S::add(S::add(S::mul(S::template lane<0>(ai), b0), S::mul(S::template lane<1>(ai), b1)), S::mul(S::template lane<2>(ai), b2)),
+                    t
+                );
+            }
+            float* out = pOut[n].data();
+            S::store(out, r[0]);
+            S::store(out + 4, r[1]);
+            S::store(out + 8, r[2]);
+            S::store(out + 12, S::set(0.f, 0.f, 0.f, 1.f));
+        }
+    }
+
+    static V cross(V a, V b)
+    {
+        return S::sub(
+            S::mul(S::template permute<1, 2, 0, 3>(a), S::template permute<2, 0, 1, 3>(b)),
+            S::mul(S::template permute<2, 0, 1, 3>(a), S::template permute<1, 2, 0, 3>(b))
+        );
+    }
+
+    /// Computes the rows of the inverse transpose, see scalar::inverseTransposeAffine().
+    static void inverseTransposeRows(const float4x4& m, V& c0, V& c1, V& c2, V& t)
+    {
+        const V r0 = S::load3(&m[0].x);
+        const V r1 = S::load3(&m[1].x);
+        const V r2 = S::load3(&m[2].x);
+        c0 = cross(r1, r2);
+        c1 = cross(r2, r0);
+        c2 = cross(r0, r1);
+        const V d = S::mul(r0, c0);
+        const V invDet = S::div(S::splat(1.f), S::add(S::add(S::template lane<0>(d), S::template lane<1>(d)), S::template lane<2>(d)));
+        c0 = S::maskXYZ(S::mul(c0, invDet));
+        c1 = S::maskXYZ(S::mul(c1, invDet));
+        c2 = S::maskXYZ(S::mul(c2, invDet));
+        t = S::neg(S::add(S::add(S::mul(c0, S::splat(m[0][3])), S::mul(c1, S::splat(m[1][3]))), S::mul(c2, S::splat(m[2][3]))));
+        t = S::add(S::maskXYZ(t), S::set(0.f, 0.f, 0.f, 1.f));
+    }
+
+    static void inverseAffine(const float4x4* pIn, float4x4* pOut, size_t count)
+    {
+        for (size_t n = 0; n < count; n++)
+        {
+            V c0, c1, c2, t;
+            inverseTransposeRows(pIn[n], c0, c1, c2, t);
+            S::transpose(c0, c1, c2, t);
+            float* out = pOut[n].data();
+            S::store(out, c0);
+            S::store(out + 4, c1);
+            S::store(out + 8, c2);
+            S::store(out + 12, t);
+        }
+    }
+
+    static void inverseTransposeAffine(const float4x4* pIn, float4x4* pOut, size_t count)
+    {
+        for (size_t n = 0; n < count; n++)
+        {
+            V c0, c1, c2, t;
+            inverseTransposeRows(pIn[n], c0, c1, c2, t);
+            float* out = pOut[n].data();
+            S::store(out, c0);
+            S::store(out + 4, c1);
+            S::store(out + 8, c2);
+            S::store(out + 12, t);
+        }
+    }
+
+    /**
+     * Computes a row of the rotation matrix as e + k * (u * v + s * w * x), where u, v, w, x are permutations of the
+     * quaternion components. This evaluates the same expressions as matrixFromQuat() for all three components at once.
+     */
+    template<int U0, int U1, int U2, int V0, int V1, int V2, int W0, int W1, int W2, int X0, int X1, int X2>
+    static V rotationRow(V q, V e, V k, V s)
+    {
+        const V u = S::template permute<U0, U1, U2, 3>(q);
+        const V v = S::template permute<V0, V1, V2, 3>(q);
+        const V w = S::template permute<W0, W1, W2, 3>(q);
+        const V x = S::template permute<X0, X1, X2, 3>(q);
+        return S::add(e, S::mul(k, S::add(S::mul(u, v), S::mul(s, S::mul(w, x)))));
+    }
+
+    static void composeTransforms(
+        const float3* pTranslations,
+        const quatf* pRotations,
+        const float3* pScalings,
+        size_t inStride,
+        float4x4* pOut,
+        size_t count
+    )
+    {
+        // Quaternion components are stored as (x, y, z, w) = (0, 1, 2, 3).
+        const V e0 = S::set(1.f, 0.f, 0.f, 0.f), k0 = S::set(-2.f, 2.f, 2.f, 0.f), s0 = S::set(1.f, -1.f, 1.f, 0.f);
+        const V e1 = S::set(0.f, 1.f, 0.f, 0.f), k1 = S::set(2.f, -2.f, 2.f, 0.f), s1 = S::set(1.f, 1.f, -1.f, 0.f);
+        const V e2 = S::set(0.f, 0.f, 1.f, 0.f), k2 = S::set(2.f, 2.f, -2.f, 0.f), s2 = S::set(-1.f, 1.f, 1.f, 0.f);
+        for (size_t n = 0; n < count; n++)
+        {
+            const float3& translation = element(pTranslations, n, inStride);
+            const V q = S::load(&element(pRotations, n, inStride).x);
+            const V scaling = S::load3(&element(pScalings, n, inStride).x);
+
+            // Row 0: (1 - 2(yy + zz), 2(xy - wz), 2(xz + wy))
+            // Row 1: (2(xy + wz), 1 - 2(xx + zz), 2(yz - wx))
+            // Row 2: (2(xz - wy), 2(yz + wx), 1 - 2(xx + yy))
+            const V r0 = rotationRow<1, 0, 0, 1, 1, 2, 2, 3, 3, 2, 2, 1>(q, e0, k0, s0);
+            const V r1 = rotationRow<0, 0, 1, 1, 0, 2, 3, 2, 3, 2, 2, 0>(q, e1, k1, s1);
+            const V r2 = rotationRow<0, 1, 0, 2, 2, 0, 3, 3, 1, 1, 0, 1>(q, e2, k2, s2);
+
+            float* out = pOut[n].data();
+            S::store(out, S::add(S::maskXYZ(S::mul(r0, scaling)), S::set(0.f, 0.f, 0.f, translation.x)));
+            S::store(out + 4, S::add(S::maskXYZ(S::mul(r1, scaling)), S::set(0.f, 0.f, 0.f, translation.y)));
+            S::store(out + 8, S::add(S::maskXYZ(S::mul(r2, scaling)), S::set(0.f, 0.f, 0.f, translation.z)));
+            S::store(out + 12, S::set(0.f, 0.f, 0.f, 1.f));
+        }
+    }
+
+    static constexpr Kernels kKernels = {
+        &transformPoints,
+        &transformVectors,
+        &transformNormals,
+        &computePointBounds,
+        &computeBoxBounds,
+        &mulAffine,
+        &inverseAffine,
+        &inverseTransposeAffine,
+        &composeTransforms,
+    };
+};
+
+#if FALCOR_BATCH_MATH_X64
+struct SSE
+{
+    using V = __m128;
+
+    static V load(const float* p) { return _mm_loadu_ps(p); }
+    /// Loads three floats and sets the last component to zero, without reading past the end.
+    static V load3(const float* p)
+    {
+        return _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(p))), _mm_load_ss(p + 2));
+    }
+    static void store(float* p, V v) { _mm_storeu_ps(p, v); }
+    static void store3(float* p, V v)
+    {
+        _mm_store_sd(reinterpret_cast<double*>(p), _mm_castps_pd(v));
+        _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+    }
+    static V set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+    static V splat(float s) { return _mm_set1_ps(s); }
+    template<int I>
+    static V lane(V v)
+    {
+        return _mm_shuffle_ps(v, v, _MM_SHUFFLE(I, I, I, I));
+    }
+    template<int X, int Y, int Z, int W>
+    static V permute(V v)
+    {
+        return _mm_shuffle_ps(v, v, _MM_SHUFFLE(W, Z, Y, X));
+    }
+    static V add(V a, V b) { return _mm_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm_div_ps(a, b); }
+    /// Returns a if a < b and b otherwise, matching std::min(b, a).
+    static V min(V a, V b) { return _mm_min_ps(a, b); }
+    static V max(V a, V b) { return _mm_max_ps(a, b); }
+    static V sqrt(V v) { return _mm_sqrt_ps(v); }
+    static V neg(V v) { return _mm_xor_ps(v, _mm_set1_ps(-0.f)); }
+    static V maskXYZ(V v) { return _mm_and_ps(v, _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0))); }
+    static void transpose(V& a, V& b, V& c, V& d) { _MM_TRANSPOSE4_PS(a, b, c, d); }
+};
+
+/**
+ * AVX2 kernels for the most common operations. They process two vectors or matrix rows per register.
+ * They don't use FMA and evaluate the same operations in the same order as the scalar kernels, so the results are
+ * bit-identical and baked scene data doesn't depend on the CPU. The remaining operations use the SSE kernels.
+ */
+namespace avx2
+{
+FALCOR_TARGET_AVX2 inline __m256 load3x2(const float* p0, const float* p1)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(SSE::load3(p0)), SSE::load3(p1), 1);
+}
+
+template<bool Translate, bool Normalize>
+FALCOR_TARGET_AVX2 void transform(const float* pColumns, const float3* pIn, float3* pOut, size_t count, size_t inStride, size_t outStride)
+{
+    const __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pColumns));
+    const __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pColumns + 4));
+    const __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pColumns + 8));
+    const __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(pColumns + 12));
+    const __m256 one = _mm256_set1_ps(1.f);
+    for (size_t i = 0; i < count; i += 2)
+    {
+        // An odd last element is processed twice in the same register and only stored once.
+        const size_t j = std::min(i + 1, count - 1);
+        const __m256 p = load3x2(&element(pIn, i, inStride).x, &element(pIn, j, inStride).x);
+        __m256 r = _mm256_mul_ps(c0, _mm256_permute_ps(p, 0x00));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c1, _mm256_permute_ps(p, 0x55)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c2, _mm256_permute_ps(p, 0xaa)));
+        if constexpr (Translate)
+            r = _mm256_add_ps(r, c3);
+        if constexpr (Normalize)
+        {
+            const __m256 sq = _mm256_mul_ps(r, r);
+            const __m256 lengthSq = _mm256_add_ps(_mm256_add_ps(_mm256_permute_ps(sq, 0x00), _mm256_permute_ps(sq, 0x55)), _mm256_permute_ps(sq, 0xaa));
+            r = _mm256_mul_ps(r, _mm256_div_ps(one, _mm256_sqrt_ps(lengthSq)));
+        }
+        SSE::store3(&element(pOut, i, outStride).x, _mm256_castps256_ps128(r));
+        if (j > i)
+            SSE::store3(&element(pOut, j, outStride).x, _mm256_extractf128_ps(r, 1));
+    }
+}
+
+FALCOR_TARGET_AVX2 void transformPoints(const float4x4& m, const float3* pIn, float3* pOut, size_t count, size_t inStride, size_t outStride)
+{
+    const float4x4 columns = transpose(m);
+    transform<true, false>(columns.data(), pIn, pOut, count, inStride, outStride);
+}
+
+FALCOR_TARGET_AVX2 void transformVectors(const float3x3& m, const float3* pIn, float3* pOut, size_t count, size_t inStride, size_t outStride)
+{
+    const float4x4 columns = transpose(float4x4(m));
+    transform<false, false>(columns.data(), pIn, pOut, count, inStride, outStride);
+}
+
+FALCOR_TARGET_AVX2 void transformNormals(const float3x3& m, const float3* pIn, float3* pOut, size_t count, size_t inStride, size_t outStride)
+{
+    const float4x4 columns = transpose(float4x4(m));
+    transform<false, true>(columns.data(), pIn, pOut, count, inStride, outStride);
+}
+
+FALCOR_TARGET_AVX2 void mulAffine(const float4x4* pA, const float4x4* pB, float4x4* pOut, size_t count)
+{
+    const __m256 translationMask = _mm256_castsi256_ps(_mm256_setr_epi32(0, 0, 0, -1, 0, 0, 0, -1));
+    const __m128 lastRow = _mm_setr_ps(0.f, 0.f, 0.f, 1.f);
+    for (size_t n = 0; n < count; n++)
+    {
+        // Rows 0-1 and 2-3 of the left-hand side are processed together, row 3 of the result is overwritten.
+        const float* a = pA[n].data();
+        const float* b = pB[n].data();
+        const __m256 a01 = _mm256_loadu_ps(a);
+        const __m256 a23 = _mm256_loadu_ps(a + 8);
+        const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b));
+        const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 4));
+        const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 8));
+
+        __m256 r01 = _mm256_mul_ps(_mm256_permute_ps(a01, 0x00), b0);
+        __m256 r23 = _mm256_mul_ps(_mm256_permute_ps(a23, 0x00), b0);
+        r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_permute_ps(a01, 0x55), b1));
+        r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_permute_ps(a23, 0x55), b1));
+        r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_permute_ps(a01, 0xaa), b2));
+        r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_permute_ps(a23, 0xaa), b2));
+        r01 = _mm256_add_ps(r01, _mm256_and_ps(a01, translationMask));
+        r23 = _mm256_add_ps(r23, _mm256_and_ps(a23, translationMask));
+        r23 = _mm256_insertf128_ps(r23, lastRow, 1);
+
+        float* out = pOut[n].data();
+        _mm256_storeu_ps(out, r01);
+        _mm256_storeu_ps(out + 8, r23);
+    }
+}
+
+// The bounds use the SSE kernels. Combining two lanes of partial bounds could pick a different one of two equal values
+// (e.g. -0 and +0) than the sequential scalar loop.
+constexpr Kernels kKernels = {
+    &transformPoints,
+    &transformVectors,
+    &transformNormals,
+    SIMDKernels<SSE>::kKernels.computePointBounds,
+    SIMDKernels<SSE>::kKernels.computeBoxBounds,
+    &mulAffine,
+    SIMDKernels<SSE>::kKernels.inverseAffine,
+    SIMDKernels<SSE>::kKernels.inverseTransposeAffine,
+    SIMDKernels<SSE>::kKernels.composeTransforms,
+};
+} // namespace avx2
+
+bool isAVX2Supported()
+{
+#if FALCOR_MSVC
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    // Check for AVX and OS support for saving the YMM registers.
+    __cpuid(info, 1);
+    const int kOSXSAVE = 1 << 27, kAVX = 1 << 28;
+    if ((info[2] & (kOSXSAVE | kAVX)) != (kOSXSAVE | kAVX) || (_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif // FALCOR_BATCH_MATH_X64
+
+#if FALCOR_BATCH_MATH_NEON
+struct NEON
+{
+    using V = float32x4_t;
+
+    static V load(const float* p) { return vld1q_f32(p); }
+    static V load3(const float* p) { return vcombine_f32(vld1_f32(p), vld1_lane_f32(p + 2, vdup_n_f32(0.f), 0)); }
+    static void store(float* p, V v) { vst1q_f32(p, v); }
+    static void store3(float* p, V v)
+    {
+        vst1_f32(p, vget_low_f32(v));
+        vst1q_lane_f32(p + 2, v, 2);
+    }
+    static V set(float x, float y, float z, float w)
+    {
+        const float values[4] = {x, y, z, w};
+        return vld1q_f32(values);
+    }
+    static V splat(float s) { return vdupq_n_f32(s); }
+    template<int I>
+    static V lane(V v)
+    {
+        return vdupq_laneq_f32(v, I);
+    }
+    template<int X, int Y, int Z, int W>
+    static V permute(V v)
+    {
+        V r = vdupq_laneq_f32(v, X);
+        r = vcopyq_laneq_f32(r, 1, v, Y);
+        r = vcopyq_laneq_f32(r, 2, v, Z);
+        return vcopyq_laneq_f32(r, 3, v, W);
+    }
+    static V add(V a, V b) { return vaddq_f32(a, b); }
+    static V sub(V a, V b) { return vsubq_f32(a, b); }
+    static V mul(V a, V b) { return vmulq_f32(a, b); }
+    static V div(V a, V b) { return vdivq_f32(a, b); }
+    static V min(V a, V b) { return vminq_f32(a, b); }
+    static V max(V a, V b) { return vmaxq_f32(a, b); }
+    static V sqrt(V v) { return vsqrtq_f32(v); }
+    static V neg(V v) { return vnegq_f32(v); }
+    static V maskXYZ(V v) { return vsetq_lane_f32(0.f, v, 3); }
+    static void transpose(V& a, V& b, V& c, V& d)
+    {
+        const float32x4x2_t ac = vzipq_f32(a, c);
+        const float32x4x2_t bd = vzipq_f32(b, d);
+        const float32x4x2_t r01 = vzipq_f32(ac.val[0], bd.val[0]);
+        const float32x4x2_t r23 = vzipq_f32(ac.val[1], bd.val[1]);
+        a = r01.val[0];
+        b = r01.val[1];
+        c = r23.val[0];
+        d = r23.val[1];
+    }
+};
+#endif // FALCOR_BATCH_MATH_NEON
+
+/// Returns the kernels for a level, or nullptr if they are not available on this CPU.
+const Kernels* getKernels(SIMDLevel level)
+{
+    switch (level)
+    {
+    case SIMDLevel::Scalar:
+    {
+        static constexpr Kernels kScalarKernels = {
+            &scalar::transformPoints,
+            &scalar::transformVectors,
+            &scalar::transformNormals,
+            &scalar::computePointBounds,
+            &scalar::computeBoxBounds,
+            &scalar::mulAffine,
+            &scalar::inverseAffine,
+            &scalar::inverseTransposeAffine,
+            &scalar::composeTransforms,
+        };
+        return &kScalarKernels;
+    }
+#if FALCOR_BATCH_MATH_X64
+    case SIMDLevel::SSE:
+        return &SIMDKernels<SSE>::kKernels;
+    case SIMDLevel::AVX2:
+    {
+        static const bool kSupported = isAVX2Supported();
+        return kSupported ? &avx2::kKernels : nullptr;
+    }
+#endif
+#if FALCOR_BATCH_MATH_NEON
+    case SIMDLevel::NEON:
+        return &SIMDKernels<NEON>::kKernels;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+SIMDLevel getBestSIMDLevel()
+{
+    for (SIMDLevel level : {SIMDLevel::AVX2, SIMDLevel::SSE, SIMDLevel::NEON})
+    {
+        if (getKernels(level))
+            return level;
+    }
+    return SIMDLevel::Scalar;
+}
+
+std::atomic<SIMDLevel>& currentLevel()
+{
+    static std::atomic<SIMDLevel> level{getBestSIMDLevel()};
+    return level;
+}
+
+const Kernels& kernels()
+{
+    return *getKernels(currentLevel().load(std::memory_order_relaxed));
+}
+} // namespace
+
+bool isSIMDLevelSupported(SIMDLevel level)
+{
+    return getKernels(level) != nullptr;
+}
+
+SIMDLevel getSIMDLevel()
+{
+    return currentLevel().load();
+}
+
+void setSIMDLevel(SIMDLevel level)
+{
+    FALCOR_CHECK(isSIMDLevelSupported(level), "SIMD level {} is not supported on this CPU.", (int)level);
+    currentLevel().store(level);
+}
+
+void transformPoints(const float4x4& m, const float3* pIn, float3* pOut, size_t count, size_t inStride, size_t outStride)
+{
+    kernels().transformPoints(m, pIn, pOut, count, inStride, outStride);
+}
+
+void transformVectors(const float3x3& m, const float3* pIn, float3* pOut, size_t count, size_t inStride, size_t outStride)
+{
+    kernels().transformVectors(m, pIn, pOut, count, inStride, outStride);
+}
+
+void transformNormals(const float3x3& m, const float3* pIn, float3* pOut, size_t count, size_t inStride, size_t outStride)
+{
+    kernels().transformNormals(m, pIn, pOut, count, inStride, outStride);
+}
+
+AABB computeBounds(const float3* pPoints, size_t count, size_t stride)
+{
+    return kernels().computePointBounds(pPoints, count, stride);
+}
+
+AABB computeBounds(const AABB* pBoxes, size_t count, size_t stride)
+{
+    return kernels().computeBoxBounds(pBoxes, count, stride);
+}
+
+void mulAffine(const float4x4* pA, const float4x4* pB, float4x4* pOut, size_t count)
+{
+    kernels().mulAffine(pA, pB, pOut, count);
+}
+
+void inverseAffine(const float4x4* pIn, float4x4* pOut, size_t count)
+{
+    kernels().inverseAffine(pIn, pOut, count);
+}
+
+void inverseTransposeAffine(const float4x4* pIn, float4x4* pOut, size_t count)
+{
+    kernels().inverseTransposeAffine(pIn, pOut, count);
+}
+
+void composeTransforms(
+    const float3* pTranslations,
+    const quatf* pRotations,
+    const float3* pScalings,
+    size_t inStride,
+    float4x4* pOut,
+    size_t count
+)
+{
+    kernels().composeTransforms(pTranslations, pRotations, pScalings, inStride, pOut, count);
+}
+} // namespace math
+} // namespace Falcor
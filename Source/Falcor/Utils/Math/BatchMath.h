@@ -0,0 +1,179 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/AABB.h"
+#include "Utils/Math/Matrix.h"
+#include "Utils/Math/Quaternion.h"
+#include "Utils/Math/Vector.h"
+#include <cstddef>
+
+/**
+ * Batch math over arrays of vectors and matrices.
+ *
+ * The functions operate on whole arrays and dispatch to SIMD kernels for the instruction set detected at runtime
+ * (SSE or AVX2 on x86-64, NEON on ARM64), with a scalar fallback built on the regular math library.
+ * Vector arrays can be strided to operate directly on interleaved (array-of-structs) data, for example the
+ * positions in an array of vertices. Strides are given in bytes. Input and output arrays may be the same array
+ * (with the same stride) but must not partially overlap.
+ *
+ * The x86-64 kernels don't use FMA and give bit-identical results to the scalar kernels, so data baked with them
+ * (e.g. pre-transformed vertices in the scene cache) doesn't depend on the CPU.
+ */
+namespace Falcor
+{
+namespace math
+{
+/// Instruction sets used by the batch math kernels.
+enum class SIMDLevel
+{
+    Scalar,
+    SSE,
+    AVX2,
+    NEON,
+};
+
+/// Returns true if the kernels for the given level are available on this CPU.
+FALCOR_API bool isSIMDLevelSupported(SIMDLevel level);
+
+/// Returns the level currently used by the batch math functions. This defaults to the best supported level.
+FALCOR_API SIMDLevel getSIMDLevel();
+
+/**
+ * Set the level used by the batch math functions. This is mainly useful for testing and benchmarking.
+ * @param[in] level SIMD level. Throws if the level is not supported on this CPU.
+ */
+FALCOR_API void setSIMDLevel(SIMDLevel level);
+
+/**
+ * Transform points by an affine or projective matrix, see transformPoint().
+ * @param[in] m Transform matrix.
+ * @param[in] pIn Input points.
+ * @param[out] pOut Output points.
+ * @param[in] count Number of points.
+ * @param[in] inStride Byte stride between input points.
+ * @param[in] outStride Byte stride between output points.
+ */
+FALCOR_API void transformPoints(
+    const float4x4& m,
+    const float3* pIn,
+    float3* pOut,
+    size_t count,
+    size_t inStride = sizeof(float3),
+    size_t outStride = sizeof(float3)
+);
+
+/**
+ * Transform vectors by a 3x3 matrix, see transformVector(). Arguments as for transformPoints().
+ */
+FALCOR_API void transformVectors(
+    const float3x3& m,
+    const float3* pIn,
+    float3* pOut,
+    size_t count,
+    size_t inStride = sizeof(float3),
+    size_t outStride = sizeof(float3)
+);
+
+/**
+ * Transform vectors by a 3x3 matrix and normalize the results.
+ * For transforming normals, pass the inverse transpose of the transform. Arguments as for transformPoints().
+ */
+FALCOR_API void transformNormals(
+    const float3x3& m,
+    const float3* pIn,
+    float3* pOut,
+    size_t count,
+    size_t inStride = sizeof(float3),
+    size_t outStride = sizeof(float3)
+);
+
+/**
+ * Compute the bounding box of an array of points.
+ * @param[in] pPoints Points.
+ * @param[in] count Number of points.
+ * @param[in] stride Byte stride between points.
+ * @return Bounding box, invalid if count is zero.
+ */
+FALCOR_API AABB computeBounds(const float3* pPoints, size_t count, size_t stride = sizeof(float3));
+
+/**
+ * Compute the union of an array of bounding boxes.
+ * @param[in] pBoxes Bounding boxes.
+ * @param[in] count Number of bounding boxes.
+ * @param[in] stride Byte stride between bounding boxes.
+ * @return Bounding box, invalid if count is zero.
+ */
+FALCOR_API AABB computeBounds(const AABB* pBoxes, size_t count, size_t stride = sizeof(AABB));
+
+/**
+ * Multiply pairs of affine matrices, pOut[i] = mul(pA[i], pB[i]).
+ * Only the upper 3x4 part is computed, the last row of the results is set to (0, 0, 0, 1).
+ * The output may be the same array as either of the inputs.
+ * @param[in] pA Left-hand side matrices.
+ * @param[in] pB Right-hand side matrices.
+ * @param[out] pOut Products.
+ * @param[in] count Number of matrices.
+ */
+FALCOR_API void mulAffine(const float4x4* pA, const float4x4* pB, float4x4* pOut, size_t count);
+
+/**
+ * Invert affine matrices. The 3x3 part is inverted analytically and the translation is transformed accordingly.
+ * The output may be the same array as the input.
+ * @param[in] pIn Affine matrices.
+ * @param[out] pOut Inverse matrices.
+ * @param[in] count Number of matrices.
+ */
+FALCOR_API void inverseAffine(const float4x4* pIn, float4x4* pOut, size_t count);
+
+/**
+ * Compute the inverse transpose of affine matrices, as used for transforming normals.
+ * The translation of the inverse ends up in the last row. Arguments as for inverseAffine().
+ */
+FALCOR_API void inverseTransposeAffine(const float4x4* pIn, float4x4* pOut, size_t count);
+
+/**
+ * Convert quaternions to rotation matrices and compose them with a translation and scaling.
+ * The result is translation * rotation * scaling, see matrixFromQuat().
+ * @param[in] pTranslations Translations.
+ * @param[in] pRotations Rotations as normalized quaternions.
+ * @param[in] pScalings Scalings.
+ * @param[in] inStride Byte stride between the elements of each of the input arrays.
+ * @param[out] pOut Transform matrices, stored contiguously.
+ * @param[in] count Number of matrices.
+ */
+FALCOR_API void composeTransforms(
+    const float3* pTranslations,
+    const quatf* pRotations,
+    const float3* pScalings,
+    size_t inStride,
+    float4x4* pOut,
+    size_t count
+);
+} // namespace math
+} // namespace Falcor
@@ -30,7 +30,7 @@
 #include "Core/API/Buffer.h"
 #include "Core/Program/ShaderVar.h"
 #include <memory>
-#include <random>
+#include <vector>
 
 namespace Falcor
 {
@@ -43,11 +43,11 @@ public:
     /**
      * Create an alias table.
      * The weights don't need to be normalized to sum up to 1.
+     * The table is built deterministically, see buildAliasTable().
      * @param[in] pDevice GPU device.
      * @param[in] weights The weights we'd like to sample each entry proportional to.
-     * @param[in] rng The random number generator to use when creating the table.
      */
-    AliasTable(ref<Device> pDevice, std::vector<float> weights, std::mt19937& rng);
+    AliasTable(ref<Device> pDevice, std::vector<float> weights);
 
     /**
      * Bind the alias table data to a given shader var.
@@ -0,0 +1,254 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AliasTableBuilder.h"
+#include "Core/Error.h"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <execution>
+#include <limits>
+
+namespace Falcor
+{
+namespace
+{
+/// Items are processed in chunks of fixed size, so that the result does not depend on the number of threads.
+const size_t kChunkSize = 1 << 14;
+
+size_t getChunkCount(size_t count)
+{
+    return (count + kChunkSize - 1) / kChunkSize;
+}
+
+/// Calls func(chunk, begin, end) for each chunk of [0, count) in parallel.
+template<typename Func>
+void forEachChunk(size_t count, Func func)
+{
+    auto range = NumericRange<size_t>(0, getChunkCount(count));
+    std::for_each(
+        std::execution::par,
+        range.begin(),
+        range.end(),
+        [&](size_t chunk) { func(chunk, chunk * kChunkSize, std::min(count, (chunk + 1) * kChunkSize)); }
+    );
+}
+
+struct ChunkSums
+{
+    double weightSum = 0.0;
+    size_t lightCount = 0;
+    double deficitSum = 0.0; ///< Sum of (1 - w) over the light items.
+    double excessSum = 0.0;  ///< Sum of (w - 1) over the heavy items.
+};
+
+void buildUniformTable(std::vector<AliasTableEntry>& entries)
+{
+    forEachChunk(
+        entries.size(),
+        [&](size_t, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                entries[i] = {1.f, (uint32_t)i};
+        }
+    );
+}
+} // namespace
+
+// The sequential alias table construction (Vose 1991) repeatedly pairs an underweighted (light) item with an
+// overweighted (heavy) item. We use the sweeping variant described by Hübschle-Schneider and Sanders 2019,
+// "Parallel Weighted Random Sampling": lights and heavies are kept in index order and the current heavy item
+// fills the buckets of consecutive lights until its residual weight drops to one or below. It then becomes a
+// bucket itself, filled up by the next heavy item.
+//
+// With weights normalized to an average of one, let D(i) be the summed deficit (1 - w) of the first i lights
+// and X(j) the summed excess (w - 1) of the first j heavies. The residual of heavy j after serving the first i
+// lights is X(j + 1) - D(i) + 1, so heavy j serves light i exactly if X(j) <= D(i) < X(j + 1). Both sequences
+// are monotonic, which turns the sweep into a merge that each chunk of lights and heavies can start at its own
+// position found by binary search.
+double buildAliasTable(const std::vector<float>& weights, std::vector<AliasTableEntry>& entries)
+{
+    FALCOR_CHECK(weights.size() < std::numeric_limits<uint32_t>::max(), "Too many entries for alias table.");
+
+    const size_t count = weights.size();
+    entries.resize(count);
+    if (count == 0)
+        return 0.0;
+
+    // Sum the weights per chunk, then across chunks in a fixed order. Use double to minimize precision issues.
+    std::vector<ChunkSums> chunkSums(getChunkCount(count));
+    forEachChunk(
+        count,
+        [&](size_t chunk, size_t begin, size_t end)
+        {
+            double sum = 0.0;
+            for (size_t i = begin; i < end; ++i)
+                sum += weights[i];
+            chunkSums[chunk].weightSum = sum;
+        }
+    );
+
+    double weightSum = 0.0;
+    for (const auto& sums : chunkSums)
+        weightSum += sums.weightSum;
+
+    if (!(weightSum > 0.0))
+    {
+        buildUniformTable(entries);
+        return weightSum;
+    }
+
+    // Normalize the weights to an average of one and sum up the deficits and excesses per chunk.
+    const double scale = double(count) / weightSum;
+    auto getWeight = [&](size_t i) { return double(weights[i]) * scale; };
+
+    forEachChunk(
+        count,
+        [&](size_t chunk, size_t begin, size_t end)
+        {
+            ChunkSums& sums = chunkSums[chunk];
+            for (size_t i = begin; i < end; ++i)
+            {
+                double w = getWeight(i);
+                if (w < 1.0)
+                {
+                    sums.lightCount++;
+                    sums.deficitSum += 1.0 - w;
+                }
+                else
+                {
+                    sums.excessSum += w - 1.0;
+                }
+            }
+        }
+    );
+
+    // Compute the chunk offsets into the light and heavy lists and their prefix sums.
+    std::vector<ChunkSums> chunkOffsets(chunkSums.size());
+    ChunkSums total;
+    for (size_t chunk = 0; chunk < chunkSums.size(); ++chunk)
+    {
+        chunkOffsets[chunk] = total;
+        total.lightCount += chunkSums[chunk].lightCount;
+        total.deficitSum += chunkSums[chunk].deficitSum;
+        total.excessSum += chunkSums[chunk].excessSum;
+    }
+
+    const size_t lightCount = total.lightCount;
+    const size_t heavyCount = count - lightCount;
+
+    // All weights are equal to the average within numerical precision.
+    if (heavyCount == 0)
+    {
+        buildUniformTable(entries);
+        return weightSum;
+    }
+
+    // Partition the items into lights and heavies, keeping their order.
+    // deficits[i] holds D(i) and has one extra element for the total. excesses[j] holds X(j + 1).
+    // The running sums start at zero within each chunk and are offset afterwards. This matches the
+    // summation order above, so the sequences stay monotonic across chunk boundaries.
+    std::vector<uint32_t> lights(lightCount);
+    std::vector<uint32_t> heavies(heavyCount);
+    std::vector<double> deficits(lightCount + 1);
+    std::vector<double> excesses(heavyCount);
+    deficits[lightCount] = total.deficitSum;
+
+    forEachChunk(
+        count,
+        [&](size_t chunk, size_t begin, size_t end)
+        {
+            const ChunkSums& offsets = chunkOffsets[chunk];
+            size_t lightIndex = offsets.lightCount;
+            size_t heavyIndex = (begin - offsets.lightCount);
+            double deficitSum = 0.0;
+            double excessSum = 0.0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                double w = getWeight(i);
+                if (w < 1.0)
+                {
+                    lights[lightIndex] = (uint32_t)i;
+                    deficits[lightIndex] = offsets.deficitSum + deficitSum;
+                    deficitSum += 1.0 - w;
+                    lightIndex++;
+                }
+                else
+                {
+                    excessSum += w - 1.0;
+                    heavies[heavyIndex] = (uint32_t)i;
+                    excesses[heavyIndex] = offsets.excessSum + excessSum;
+                    heavyIndex++;
+                }
+            }
+        }
+    );
+
+    // Fill the light buckets. Light i is served by the first heavy j with X(j + 1) > D(i).
+    // Due to numerical precision the last lights may not find one, they are served by the last heavy.
+    forEachChunk(
+        lightCount,
+        [&](size_t, size_t begin, size_t end)
+        {
+            size_t j = std::upper_bound(excesses.begin(), excesses.end(), deficits[begin]) - excesses.begin();
+            for (size_t i = begin; i < end; ++i)
+            {
+                while (j < heavyCount && excesses[j] <= deficits[i])
+                    j++;
+                uint32_t item = lights[i];
+                entries[item] = {(float)getWeight(item), heavies[std::min(j, heavyCount - 1)]};
+            }
+        }
+    );
+
+    // Fill the heavy buckets. Heavy j has served all lights i with D(i) < X(j + 1) when its residual drops
+    // to one or below. The remainder of its bucket is filled by the next heavy. The last heavy fills its own bucket.
+    forEachChunk(
+        heavyCount,
+        [&](size_t, size_t begin, size_t end)
+        {
+            size_t i = std::lower_bound(deficits.begin(), deficits.begin() + lightCount, excesses[begin]) - deficits.begin();
+            for (size_t j = begin; j < end; ++j)
+            {
+                while (i < lightCount && deficits[i] < excesses[j])
+                    i++;
+                uint32_t item = heavies[j];
+                if (j + 1 < heavyCount)
+                {
+                    double residual = excesses[j] + 1.0 - deficits[i];
+                    entries[item] = {(float)std::clamp(residual, 0.0, 1.0), heavies[j + 1]};
+                }
+                else
+                {
+                    entries[item] = {1.f, item};
+                }
+            }
+        }
+    );
+
+    return weightSum;
+}
+} // namespace Falcor
@@ -0,0 +1,59 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Entry of an alias table.
+ * Sampling picks an entry i uniformly, then returns i with probability 'threshold' and 'alias' otherwise.
+ */
+struct AliasTableEntry
+{
+    float threshold; ///< Probability of picking the entry's own index.
+    uint32_t alias;  ///< Index picked if the entry's own index is not.
+};
+
+/**
+ * Build an alias table for sampling proportional to the given weights.
+ *
+ * The table is built in parallel: items are split into below-average (light) and above-average (heavy) weights
+ * and the sweep that pairs light items with heavy ones is expressed through prefix sums of their deficits and
+ * excesses. This lets each chunk of items find its partners independently. The result is deterministic and
+ * independent of the number of threads.
+ *
+ * The weights don't need to be normalized. If all weights are zero, the table samples all items uniformly.
+ * @param[in] weights The weights we'd like to sample each entry proportional to. Must be non-negative.
+ * @param[out] entries The alias table entries, one per weight.
+ * @return Sum of all weights.
+ */
+FALCOR_API double buildAliasTable(const std::vector<float>& weights, std::vector<AliasTableEntry>& entries);
+} // namespace Falcor
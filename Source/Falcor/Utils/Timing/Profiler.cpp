@@ -31,7 +31,16 @@
 #include "Utils/Logger.h"
 #include "Utils/Scripting/ScriptBindings.h"
 
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <fstream>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
 
 namespace Falcor
 {
@@ -46,6 +55,163 @@ const float kSigma = 0.98f;
 // for computing statistics (min, max, mean, stddev) over the recent history.
 const size_t kMaxHistorySize = 512;
 
+// Capacity of the per-thread CPU event ring buffers. Buffers are drained once per frame while capturing.
+const size_t kCpuEventBufferCapacity = 1 << 14;
+
+/**
+ * Process-wide table of interned event names.
+ * Names are stored in a deque so that references to them stay valid when new names are added.
+ */
+class EventNameTable
+{
+public:
+    Profiler::EventId intern(std::string_view name)
+    {
+        {
+            std::shared_lock<std::shared_mutex> lock(mMutex);
+            auto it = mIds.find(name);
+            if (it != mIds.end())
+                return it->second;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mMutex);
+        auto it = mIds.find(name);
+        if (it != mIds.end())
+            return it->second;
+        Profiler::EventId id = (Profiler::EventId)mNames.size();
+        const std::string& storedName = mNames.emplace_back(name);
+        mIds.emplace(std::string_view(storedName), id);
+        return id;
+    }
+
+    const std::string& getName(Profiler::EventId id)
+    {
+        std::shared_lock<std::shared_mutex> lock(mMutex);
+        FALCOR_CHECK(id < mNames.size(), "Invalid profiler event ID {}.", id);
+        return mNames[id];
+    }
+
+private:
+    std::shared_mutex mMutex;
+    std::deque<std::string> mNames;
+    std::unordered_map<std::string_view, Profiler::EventId> mIds;
+};
+
+EventNameTable& getEventNameTable()
+{
+    static EventNameTable table;
+    return table;
+}
+
+int64_t toNanoseconds(CpuTimer::TimePoint timePoint)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(timePoint.time_since_epoch()).count();
+}
+
+struct CpuEventRecord
+{
+    Profiler::EventId id;
+    int64_t startTime; ///< Start time in ns.
+    int64_t endTime;   ///< End time in ns.
+};
+
+/**
+ * Single-producer single-consumer ring buffer of CPU events.
+ * The producer is the thread owning the buffer, the consumer is the profiler draining the buffers (serialized by a mutex).
+ * Events are dropped when the buffer is full.
+ */
+class CpuEventRingBuffer
+{
+public:
+    CpuEventRingBuffer(uint32_t threadIndex) : mThreadIndex(threadIndex), mRecords(kCpuEventBufferCapacity) {}
+
+    uint32_t getThreadIndex() const { return mThreadIndex; }
+
+    void push(const CpuEventRecord& record)
+    {
+        uint64_t writeIndex = mWriteIndex.load(std::memory_order_relaxed);
+        if (writeIndex - mReadIndex.load(std::memory_order_acquire) >= kCpuEventBufferCapacity)
+        {
+            mDroppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        mRecords[writeIndex % kCpuEventBufferCapacity] = record;
+        mWriteIndex.store(writeIndex + 1, std::memory_order_release);
+    }
+
+    template<typename Func>
+    void drain(const Func& func)
+    {
+        uint64_t readIndex = mReadIndex.load(std::memory_order_relaxed);
+        uint64_t writeIndex = mWriteIndex.load(std::memory_order_acquire);
+        for (; readIndex < writeIndex; ++readIndex)
+            func(mRecords[readIndex % kCpuEventBufferCapacity]);
+        mReadIndex.store(readIndex, std::memory_order_release);
+    }
+
+    uint64_t takeDroppedCount() { return mDroppedCount.exchange(0, std::memory_order_relaxed); }
+
+private:
+    uint32_t mThreadIndex;
+    std::vector<CpuEventRecord> mRecords;
+    std::atomic<uint64_t> mWriteIndex{0};
+    std::atomic<uint64_t> mReadIndex{0};
+    std::atomic<uint64_t> mDroppedCount{0};
+};
+
+/**
+ * Registry of the per-thread CPU event ring buffers.
+ * A thread's buffer is created on the first recorded event and kept alive until it has been drained after the thread exited.
+ */
+class CpuEventRegistry
+{
+public:
+    CpuEventRingBuffer& getThreadBuffer()
+    {
+        thread_local std::shared_ptr<CpuEventRingBuffer> pBuffer = registerThread();
+        return *pBuffer;
+    }
+
+    template<typename Func>
+    uint64_t drain(const Func& func)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        uint64_t droppedCount = 0;
+        for (auto& pBuffer : mBuffers)
+        {
+            uint32_t threadIndex = pBuffer->getThreadIndex();
+            pBuffer->drain([&](const CpuEventRecord& record) { func(threadIndex, record); });
+            droppedCount += pBuffer->takeDroppedCount();
+        }
+        // Release buffers of threads that have exited. Their events have been drained above.
+        mBuffers.erase(
+            std::remove_if(mBuffers.begin(), mBuffers.end(), [](const auto& pBuffer) { return pBuffer.use_count() == 1; }), mBuffers.end()
+        );
+        return droppedCount;
+    }
+
+    std::atomic<uint32_t> captureCount{0};
+
+private:
+    std::shared_ptr<CpuEventRingBuffer> registerThread()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto pBuffer = std::make_shared<CpuEventRingBuffer>(mNextThreadIndex++);
+        mBuffers.push_back(pBuffer);
+        return pBuffer;
+    }
+
+    std::mutex mMutex;
+    std::vector<std::shared_ptr<CpuEventRingBuffer>> mBuffers;
+    uint32_t mNextThreadIndex = 0;
+};
+
+CpuEventRegistry& getCpuEventRegistry()
+{
+    static CpuEventRegistry registry;
+    return registry;
+}
+
 pybind11::dict toPython(const Profiler::Stats& stats)
 {
     pybind11::dict d;
@@ -131,7 +297,8 @@ Profiler::Stats Profiler::Stats::compute(const float* data, size_t len)
 
 // Profiler::Event
 
-Profiler::Event::Event(const std::string& name) : mName(name), mCpuTimeHistory(kMaxHistorySize, 0.f), mGpuTimeHistory(kMaxHistorySize, 0.f)
+Profiler::Event::Event(const std::string& name, EventId nameId, Event* pParent)
+    : mName(name), mNameId(nameId), mpParent(pParent), mCpuTimeHistory(kMaxHistorySize, 0.f), mGpuTimeHistory(kMaxHistorySize, 0.f)
 {}
 
 Profiler::Stats Profiler::Event::computeCpuTimeStats() const
@@ -257,12 +424,59 @@ void Profiler::Capture::writeToFile(const std::filesystem::path& path) const
     ofs.write(json.data(), json.size());
 }
 
-Profiler::Capture::Capture(size_t reservedEvents, size_t reservedFrames) : mReservedFrames(reservedFrames)
+std::string Profiler::Capture::toChromeTraceJsonString() const
+{
+    nlohmann::json traceEvents = nlohmann::json::array();
+    std::set<uint32_t> threadIndices;
+    for (const auto& event : mTraceEvents)
+    {
+        traceEvents.push_back({
+            {"name", getEventName(event.id)},
+            {"ph", "X"},
+            {"pid", 0},
+            {"tid", event.threadIndex},
+            {"ts", event.startTime * 1e3},
+            {"dur", event.duration * 1e3},
+        });
+        threadIndices.insert(event.threadIndex);
+    }
+    for (uint32_t threadIndex : threadIndices)
+    {
+        traceEvents.push_back({
+            {"name", "thread_name"},
+            {"ph", "M"},
+            {"pid", 0},
+            {"tid", threadIndex},
+            {"args", {{"name", fmt::format("Thread {}", threadIndex)}}},
+        });
+    }
+
+    nlohmann::json trace = {{"traceEvents", traceEvents}, {"displayTimeUnit", "ms"}};
+    return trace.dump();
+}
+
+void Profiler::Capture::writeChromeTraceToFile(const std::filesystem::path& path) const
+{
+    auto json = toChromeTraceJsonString();
+    std::ofstream ofs(path);
+    ofs.write(json.data(), json.size());
+}
+
+Profiler::Capture::Capture(size_t reservedEvents, size_t reservedFrames)
+    : mReservedFrames(reservedFrames), mStartTime(CpuTimer::getCurrentTimePoint())
 {
     // Speculativly allocate event record storage.
     mLanes.resize(reservedEvents * 2);
     for (auto& lane : mLanes)
         lane.records.reserve(reservedFrames);
+
+    getCpuEventRegistry().captureCount.fetch_add(1);
+}
+
+Profiler::Capture::~Capture()
+{
+    if (!mFinalized)
+        getCpuEventRegistry().captureCount.fetch_sub(1);
 }
 
 void Profiler::Capture::captureEvents(const std::vector<Event*>& events)
@@ -297,15 +511,44 @@ void Profiler::Capture::captureEvents(const std::vector<Event*>& events)
     ++mFrameCount;
 }
 
+void Profiler::Capture::captureTraceEvents()
+{
+    // Events that started before this capture may have been recorded for another capture.
+    int64_t startTime = toNanoseconds(mStartTime);
+    mDroppedTraceEventCount += getCpuEventRegistry().drain(
+        [&](uint32_t threadIndex, const CpuEventRecord& record)
+        {
+            if (record.startTime < startTime)
+                return;
+            mTraceEvents.push_back(
+                {record.id, threadIndex, (record.startTime - startTime) * 1e-6, (record.endTime - record.startTime) * 1e-6}
+            );
+        }
+    );
+}
+
 void Profiler::Capture::finalize()
 {
     FALCOR_ASSERT(!mFinalized);
 
+    captureTraceEvents();
+    getCpuEventRegistry().captureCount.fetch_sub(1);
+
     for (auto& lane : mLanes)
     {
         lane.stats = Stats::compute(lane.records.data(), lane.records.size());
     }
 
+    // Events from different threads are merged, sort them by time.
+    std::stable_sort(
+        mTraceEvents.begin(),
+        mTraceEvents.end(),
+        [](const TraceEvent& lhs, const TraceEvent& rhs) { return lhs.startTime < rhs.startTime; }
+    );
+
+    if (mDroppedTraceEventCount > 0)
+        logWarning("Profiler capture dropped {} CPU events because of full event buffers.", mDroppedTraceEventCount);
+
     mFinalized = true;
 }
 
@@ -319,48 +562,67 @@ Profiler::Profiler(ref<Device> pDevice) : mpDevice(pDevice)
 
 void Profiler::startEvent(RenderContext* pRenderContext, const std::string& name, Flags flags)
 {
-    if (mEnabled && is_set(flags, Flags::Internal))
+    // '/' is used as a "path delimiter", so it cannot be used in the event name.
+    if (name.find('/') != std::string::npos)
     {
-        // '/' is used as a "path delimiter", so it cannot be used in the event name.
-        if (name.find('/') != std::string::npos)
-        {
-            logWarning("Profiler event names must not contain '/'. Ignoring this profiler event.");
-            return;
-        }
+        logWarning("Profiler event names must not contain '/'. Ignoring this profiler event.");
+        return;
+    }
 
-        mCurrentEventName = mCurrentEventName + "/" + name;
+    startEvent(pRenderContext, internEventName(name), flags);
+}
 
-        Event* pEvent = getEvent(mCurrentEventName);
+void Profiler::startEvent(RenderContext* pRenderContext, EventId id, Flags flags)
+{
+    if (mEnabled && is_set(flags, Flags::Internal))
+    {
+        Event* pEvent = getChildEvent(id);
         FALCOR_ASSERT(pEvent != nullptr);
+        mpCurrentEvent = pEvent;
         if (!mPaused)
             pEvent->start(*this, mFrameIndex);
 
-        if (std::find(mCurrentFrameEvents.begin(), mCurrentFrameEvents.end(), pEvent) == mCurrentFrameEvents.end())
+        if (pEvent->mFrameIndex != mFrameIndex)
         {
+            pEvent->mFrameIndex = mFrameIndex;
             mCurrentFrameEvents.push_back(pEvent);
         }
+
+        mEventStartTimes.push_back(mpCapture ? CpuTimer::getCurrentTimePoint() : CpuTimer::TimePoint());
     }
     if (is_set(flags, Flags::Pix))
     {
         FALCOR_ASSERT(pRenderContext);
-        pRenderContext->getLowLevelData()->beginDebugEvent(name.c_str());
+        pRenderContext->getLowLevelData()->beginDebugEvent(getEventName(id).c_str());
     }
 }
 
 void Profiler::endEvent(RenderContext* pRenderContext, const std::string& name, Flags flags)
 {
-    if (mEnabled && is_set(flags, Flags::Internal))
-    {
-        // '/' is used as a "path delimiter", so it cannot be used in the event name.
-        if (name.find('/') != std::string::npos)
-            return;
+    // '/' is used as a "path delimiter", so it cannot be used in the event name.
+    if (name.find('/') != std::string::npos)
+        return;
 
-        Event* pEvent = getEvent(mCurrentEventName);
-        FALCOR_ASSERT(pEvent != nullptr);
+    endEvent(pRenderContext, internEventName(name), flags);
+}
+
+void Profiler::endEvent(RenderContext* pRenderContext, EventId id, Flags flags)
+{
+    // The current event is nullptr if the profiler was enabled after the event was started.
+    if (mEnabled && is_set(flags, Flags::Internal) && mpCurrentEvent != nullptr)
+    {
+        Event* pEvent = mpCurrentEvent;
+        FALCOR_ASSERT(pEvent->mNameId == id);
         if (!mPaused)
             pEvent->end(mFrameIndex);
 
-        mCurrentEventName.erase(mCurrentEventName.find_last_of("/"));
+        FALCOR_ASSERT(!mEventStartTimes.empty());
+        CpuTimer::TimePoint startTime = mEventStartTimes.back();
+        mEventStartTimes.pop_back();
+        if (mpCapture && startTime != CpuTimer::TimePoint())
+            recordCpuEvent(id, startTime, CpuTimer::getCurrentTimePoint());
+
+        mpCurrentEvent = pEvent->mpParent;
     }
 
     if (is_set(flags, Flags::Pix))
@@ -373,7 +635,14 @@ void Profiler::endEvent(RenderContext* pRenderContext, const std::string& name,
 Profiler::Event* Profiler::getEvent(const std::string& name)
 {
     auto event = findEvent(name);
-    return event ? event : createEvent(name);
+    if (event)
+        return event;
+
+    // Events created by name are not linked into the event hierarchy.
+    // If the same event is started later, getChildEvent() finds it by name and links it.
+    auto pos = name.find_last_of('/');
+    EventId nameId = internEventName(pos == std::string::npos ? name : name.substr(pos + 1));
+    return createEvent(name, nameId, nullptr);
 }
 
 void Profiler::endFrame(RenderContext* pRenderContext)
@@ -397,7 +666,10 @@ void Profiler::endFrame(RenderContext* pRenderContext)
     mFenceValue = pRenderContext->signal(mpFence.get());
 
     if (mpCapture)
+    {
         mpCapture->captureEvents(mCurrentFrameEvents);
+        mpCapture->captureTraceEvents();
+    }
 
     mLastFrameEvents = std::move(mCurrentFrameEvents);
     ++mFrameIndex;
@@ -435,13 +707,33 @@ bool Profiler::isCapturing() const
     return mpCapture != nullptr;
 }
 
-Profiler::Event* Profiler::createEvent(const std::string& name)
+Profiler::Event* Profiler::createEvent(const std::string& name, EventId nameId, Event* pParent)
 {
-    auto pEvent = std::shared_ptr<Event>(new Event(name));
+    auto pEvent = std::shared_ptr<Event>(new Event(name, nameId, pParent));
     mEvents.emplace(name, pEvent);
     return pEvent.get();
 }
 
+Profiler::Event* Profiler::getChildEvent(EventId nameId)
+{
+    // Events have only a few children, so a linear search is faster than hashing the nested event name.
+    auto& children = mpCurrentEvent ? mpCurrentEvent->mChildren : mRootEvents;
+    for (Event* pChild : children)
+    {
+        if (pChild->mNameId == nameId)
+            return pChild;
+    }
+
+    std::string name = (mpCurrentEvent ? mpCurrentEvent->mName : std::string()) + "/" + getEventName(nameId);
+    Event* pEvent = findEvent(name);
+    if (pEvent == nullptr)
+        pEvent = createEvent(name, nameId, mpCurrentEvent);
+    else
+        pEvent->mpParent = mpCurrentEvent; // Event was created by getEvent().
+    children.push_back(pEvent);
+    return pEvent;
+}
+
 Profiler::Event* Profiler::findEvent(const std::string& name)
 {
     auto event = mEvents.find(name);
@@ -453,16 +745,75 @@ void Profiler::breakStrongReferenceToDevice()
     mpDevice.breakStrongReference();
 }
 
+Profiler::EventId Profiler::internEventName(std::string_view name)
+{
+    return getEventNameTable().intern(name);
+}
+
+const std::string& Profiler::getEventName(EventId id)
+{
+    return getEventNameTable().getName(id);
+}
+
+bool Profiler::isRecordingCpuEvents()
+{
+    return getCpuEventRegistry().captureCount.load(std::memory_order_relaxed) > 0;
+}
+
+void Profiler::recordCpuEvent(EventId id, CpuTimer::TimePoint startTime, CpuTimer::TimePoint endTime)
+{
+    auto& registry = getCpuEventRegistry();
+    if (registry.captureCount.load(std::memory_order_relaxed) == 0)
+        return;
+    registry.getThreadBuffer().push({id, toNanoseconds(startTime), toNanoseconds(endTime)});
+}
+
+void detail::ProfilerEventName::intern(std::string_view name)
+{
+    // '/' is used as a "path delimiter", so it cannot be used in the event name.
+    if (name.find('/') != std::string_view::npos)
+    {
+        logWarning("Profiler event names must not contain '/'. Ignoring profiler event '{}'.", name);
+        return;
+    }
+    mId = Profiler::internEventName(name);
+    mValid = true;
+}
+
 ScopedProfilerEvent::ScopedProfilerEvent(RenderContext* pRenderContext, const std::string& name, Profiler::Flags flags)
-    : mpRenderContext(pRenderContext), mName(name), mFlags(flags)
+    : mpRenderContext(pRenderContext), mId(0), mFlags(flags), mValid(false)
+{
+    FALCOR_ASSERT(mpRenderContext);
+    // '/' is used as a "path delimiter", so it cannot be used in the event name.
+    if (name.find('/') != std::string::npos)
+    {
+        logWarning("Profiler event names must not contain '/'. Ignoring this profiler event.");
+        return;
+    }
+    mId = Profiler::internEventName(name);
+    mValid = true;
+    mpRenderContext->getProfiler()->startEvent(mpRenderContext, mId, mFlags);
+}
+
+ScopedProfilerEvent::ScopedProfilerEvent(RenderContext* pRenderContext, Profiler::EventId id, Profiler::Flags flags)
+    : mpRenderContext(pRenderContext), mId(id), mFlags(flags), mValid(true)
+{
+    FALCOR_ASSERT(mpRenderContext);
+    mpRenderContext->getProfiler()->startEvent(mpRenderContext, mId, mFlags);
+}
+
+ScopedProfilerEvent::ScopedProfilerEvent(RenderContext* pRenderContext, const detail::ProfilerEventName& name, Profiler::Flags flags)
+    : mpRenderContext(pRenderContext), mId(name.getId()), mFlags(flags), mValid(name.isValid())
 {
     FALCOR_ASSERT(mpRenderContext);
-    mpRenderContext->getProfiler()->startEvent(mpRenderContext, mName, mFlags);
+    if (mValid)
+        mpRenderContext->getProfiler()->startEvent(mpRenderContext, mId, mFlags);
 }
 
 ScopedProfilerEvent::~ScopedProfilerEvent()
 {
-    mpRenderContext->getProfiler()->endEvent(mpRenderContext, mName, mFlags);
+    if (mValid)
+        mpRenderContext->getProfiler()->endEvent(mpRenderContext, mId, mFlags);
 }
 
 /// Implements a Python context manager for profiling events.
@@ -32,7 +32,9 @@
 #include "Core/API/Fence.h"
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -46,6 +48,11 @@ class RenderContext;
  * It automatically creates event hierarchies based on the order and nesting of the calls made.
  * This class uses a double-buffering scheme for GPU profiling to avoid GPU stalls.
  * ProfilerEvent is a wrapper class which together with scoping can simplify event profiling.
+ *
+ * Event names are interned into event IDs, so that starting and ending events does not require string operations.
+ * In addition to the hierarchical events of the main thread, CPU events can be recorded on any thread
+ * using ScopedCpuProfilerEvent (FALCOR_PROFILE_CPU). These are written to per-thread lock-free ring buffers
+ * while a capture is active and are merged into the capture at the end of each frame.
  */
 class FALCOR_API Profiler
 {
@@ -59,6 +66,11 @@ public:
         Default = Internal | Pix
     };
 
+    /**
+     * Interned event name. IDs are shared by all profilers and threads.
+     */
+    using EventId = uint32_t;
+
     struct Stats
     {
         float min;
@@ -86,13 +98,17 @@ public:
         void resetStats();
 
     private:
-        Event(const std::string& name);
+        Event(const std::string& name, EventId nameId, Event* pParent);
 
         void start(Profiler& profiler, uint32_t frameIndex);
         void end(uint32_t frameIndex);
         void endFrame(uint32_t frameIndex);
 
-        std::string mName; ///< Nested event name.
+        std::string mName;                ///< Nested event name.
+        EventId mNameId;                  ///< Interned name of the event (not including the parent events).
+        Event* mpParent;                  ///< Parent event or nullptr for top-level events.
+        std::vector<Event*> mChildren;    ///< Child events.
+        uint32_t mFrameIndex = uint32_t(-1); ///< Last frame index in which the event was registered.
 
         float mCpuTime = 0.0; ///< CPU time (previous frame).
         float mGpuTime = 0.0; ///< GPU time (previous frame).
@@ -133,22 +149,50 @@ public:
             std::vector<float> records;
         };
 
+        /**
+         * CPU event recorded on any thread.
+         */
+        struct TraceEvent
+        {
+            EventId id;           ///< Interned event name.
+            uint32_t threadIndex; ///< Index of the thread that recorded the event.
+            double startTime;     ///< Start time in ms relative to the start of the capture.
+            double duration;      ///< Duration in ms.
+        };
+
         Capture(size_t reservedEvents, size_t reservedFrames);
+        ~Capture();
 
         size_t getFrameCount() const { return mFrameCount; }
         const std::vector<Lane>& getLanes() const { return mLanes; }
+        const std::vector<TraceEvent>& getTraceEvents() const { return mTraceEvents; }
+
+        /**
+         * Get the number of CPU events that were lost because a thread's ring buffer was full.
+         */
+        uint64_t getDroppedTraceEventCount() const { return mDroppedTraceEventCount; }
 
         std::string toJsonString() const;
         void writeToFile(const std::filesystem::path& path) const;
 
+        /**
+         * Convert the CPU events to the Chrome trace event format (viewable in chrome://tracing or Perfetto).
+         */
+        std::string toChromeTraceJsonString() const;
+        void writeChromeTraceToFile(const std::filesystem::path& path) const;
+
     private:
         void captureEvents(const std::vector<Event*>& events);
+        void captureTraceEvents();
         void finalize();
 
         size_t mReservedFrames = 0;
         size_t mFrameCount = 0;
         std::vector<Event*> mEvents;
         std::vector<Lane> mLanes;
+        CpuTimer::TimePoint mStartTime;
+        std::vector<TraceEvent> mTraceEvents;
+        uint64_t mDroppedTraceEventCount = 0;
         bool mFinalized = false;
 
         friend class Profiler;
@@ -217,6 +261,14 @@ public:
      */
     void startEvent(RenderContext* pRenderContext, const std::string& name, Flags flags = Flags::Default);
 
+    /**
+     * Start profiling a new event using an interned event name.
+     * @param[in] pRenderContext Render context for measuring GPU time.
+     * @param[in] id The interned event name.
+     * @param[in] flags The event flags.
+     */
+    void startEvent(RenderContext* pRenderContext, EventId id, Flags flags = Flags::Default);
+
     /**
      * Finish profiling a new event and update the events hierarchies.
      * @param[in] pRenderContext Render context for measuring GPU time.
@@ -225,6 +277,14 @@ public:
      */
     void endEvent(RenderContext* pRenderContext, const std::string& name, Flags flags = Flags::Default);
 
+    /**
+     * Finish profiling an event started with an interned event name.
+     * @param[in] pRenderContext Render context for measuring GPU time.
+     * @param[in] id The interned event name.
+     * @param[in] flags The event flags.
+     */
+    void endEvent(RenderContext* pRenderContext, EventId id, Flags flags = Flags::Default);
+
     /**
      * Get the event, or create a new one if the event does not yet exist.
      * This is a public interface to facilitate more complicated construction of event names and finegrained control over the profiled
@@ -246,13 +306,48 @@ public:
 
     void breakStrongReferenceToDevice();
 
+    /**
+     * Intern an event name. This function is thread-safe.
+     * @param[in] name The event name.
+     * @return Returns the event ID, which is the same for all calls with the same name.
+     */
+    static EventId internEventName(std::string_view name);
+
+    /**
+     * Get the name of an interned event. This function is thread-safe.
+     * @param[in] id The event ID.
+     * @return Returns the event name.
+     */
+    static const std::string& getEventName(EventId id);
+
+    /**
+     * Check if CPU events are currently recorded, i.e. if any profiler is capturing.
+     */
+    static bool isRecordingCpuEvents();
+
+    /**
+     * Record a CPU event on the calling thread. This function is lock-free and can be called from any thread.
+     * The event is dropped if no capture is active or the thread's ring buffer is full.
+     * @param[in] id The interned event name.
+     * @param[in] startTime The event start time.
+     * @param[in] endTime The event end time.
+     */
+    static void recordCpuEvent(EventId id, CpuTimer::TimePoint startTime, CpuTimer::TimePoint endTime);
+
 private:
     /**
      * Create a new event.
      * @param[in] name The event name.
      * @return Returns the new event.
      */
-    Event* createEvent(const std::string& name);
+    Event* createEvent(const std::string& name, EventId nameId, Event* pParent);
+
+    /**
+     * Get a child event of the current event, or create a new one if the event does not yet exist.
+     * @param[in] nameId The interned event name.
+     * @return Returns the event.
+     */
+    Event* getChildEvent(EventId nameId);
 
     /**
      * Find an event that was previously created.
@@ -267,10 +362,11 @@ private:
     bool mPaused = false;
 
     std::unordered_map<std::string, std::shared_ptr<Event>> mEvents; ///< Events by name.
+    std::vector<Event*> mRootEvents;                                 ///< Top-level events.
     std::vector<Event*> mCurrentFrameEvents;                         ///< Events registered for current frame.
     std::vector<Event*> mLastFrameEvents;                            ///< Events from last frame.
-    std::string mCurrentEventName;                                   ///< Current nested event name.
-    uint32_t mCurrentLevel = 0;                                      ///< Current nesting level.
+    Event* mpCurrentEvent = nullptr;                                 ///< Current nested event (nullptr at the top level).
+    std::vector<CpuTimer::TimePoint> mEventStartTimes; ///< Start times of the nested events (used for recording CPU events).
     uint32_t mFrameIndex = 0;                                        ///< Current frame index.
     bool mPendingReset = false;                                      ///< Reset profiler stats at the next call to endFrame().
 
@@ -282,6 +378,37 @@ private:
 
 FALCOR_ENUM_CLASS_OPERATORS(Profiler::Flags);
 
+namespace detail
+{
+/**
+ * Event name of a FALCOR_PROFILE call site.
+ * String literals are interned once on first use, so that the call site doesn't intern the name on every call.
+ * Other names are passed through and interned on every call, as they may change between calls.
+ */
+class FALCOR_API ProfilerEventName
+{
+public:
+    template<size_t N>
+    const ProfilerEventName& get(const char (&name)[N])
+    {
+        std::call_once(mInternFlag, [&]() { intern(name); });
+        return *this;
+    }
+
+    const std::string& get(const std::string& name) { return name; }
+
+    bool isValid() const { return mValid; }
+    Profiler::EventId getId() const { return mId; }
+
+private:
+    void intern(std::string_view name);
+
+    std::once_flag mInternFlag;
+    Profiler::EventId mId = 0;
+    bool mValid = false;
+};
+} // namespace detail
+
 /**
  * Helper class for starting and ending profiling events using RAII.
  * The constructor and destructor call Profiler::StartEvent() and Profiler::EndEvent().
@@ -292,21 +419,76 @@ class FALCOR_API ScopedProfilerEvent
 {
 public:
     ScopedProfilerEvent(RenderContext* pRenderContext, const std::string& name, Profiler::Flags flags = Profiler::Flags::Default);
+    ScopedProfilerEvent(RenderContext* pRenderContext, Profiler::EventId id, Profiler::Flags flags = Profiler::Flags::Default);
+    ScopedProfilerEvent(
+        RenderContext* pRenderContext,
+        const detail::ProfilerEventName& name,
+        Profiler::Flags flags = Profiler::Flags::Default
+    );
     ~ScopedProfilerEvent();
 
 private:
     RenderContext* mpRenderContext;
-    const std::string mName;
+    Profiler::EventId mId;
     Profiler::Flags mFlags;
+    bool mValid;
+};
+
+/**
+ * Helper class for recording CPU events on any thread using RAII.
+ * The event is only recorded if a profiler capture is active when the event starts.
+ * The FALCOR_PROFILE_CPU macro interns the event name once and should be used with constant names.
+ */
+class ScopedCpuProfilerEvent
+{
+public:
+    ScopedCpuProfilerEvent(Profiler::EventId id) : mId(id), mRecording(Profiler::isRecordingCpuEvents())
+    {
+        if (mRecording)
+            mStartTime = CpuTimer::getCurrentTimePoint();
+    }
+
+    ScopedCpuProfilerEvent(std::string_view name) : mRecording(Profiler::isRecordingCpuEvents())
+    {
+        if (mRecording)
+        {
+            mId = Profiler::internEventName(name);
+            mStartTime = CpuTimer::getCurrentTimePoint();
+        }
+    }
+
+    ~ScopedCpuProfilerEvent()
+    {
+        if (mRecording)
+            Profiler::recordCpuEvent(mId, mStartTime, CpuTimer::getCurrentTimePoint());
+    }
+
+    ScopedCpuProfilerEvent(const ScopedCpuProfilerEvent&) = delete;
+    ScopedCpuProfilerEvent& operator=(const ScopedCpuProfilerEvent&) = delete;
+
+private:
+    Profiler::EventId mId = 0;
+    bool mRecording;
+    CpuTimer::TimePoint mStartTime;
 };
 } // namespace Falcor
 
 #if FALCOR_ENABLE_PROFILER
-#define FALCOR_PROFILE(_pRenderContext, _name) \
-    Falcor::ScopedProfilerEvent FALCOR_CONCAT_STRINGS(_profileEvent, __LINE__)(_pRenderContext, _name)
-#define FALCOR_PROFILE_CUSTOM(_pRenderContext, _name, _flags) \
-    Falcor::ScopedProfilerEvent FALCOR_CONCAT_STRINGS(_profileEvent, __LINE__)(_pRenderContext, _name, _flags)
+#define FALCOR_PROFILE(_pRenderContext, _name)                                                   \
+    static Falcor::detail::ProfilerEventName FALCOR_CONCAT_STRINGS(_profileEventName, __LINE__); \
+    Falcor::ScopedProfilerEvent FALCOR_CONCAT_STRINGS(_profileEvent, __LINE__)(                  \
+        _pRenderContext, FALCOR_CONCAT_STRINGS(_profileEventName, __LINE__).get(_name)           \
+    )
+#define FALCOR_PROFILE_CUSTOM(_pRenderContext, _name, _flags)                                   \
+    static Falcor::detail::ProfilerEventName FALCOR_CONCAT_STRINGS(_profileEventName, __LINE__); \
+    Falcor::ScopedProfilerEvent FALCOR_CONCAT_STRINGS(_profileEvent, __LINE__)(                  \
+        _pRenderContext, FALCOR_CONCAT_STRINGS(_profileEventName, __LINE__).get(_name), _flags   \
+    )
+#define FALCOR_PROFILE_CPU(_name) \
+    static const Falcor::Profiler::EventId FALCOR_CONCAT_STRINGS(_profileEventId, __LINE__) = Falcor::Profiler::internEventName(_name); \
+    Falcor::ScopedCpuProfilerEvent FALCOR_CONCAT_STRINGS(_profileEvent, __LINE__)(FALCOR_CONCAT_STRINGS(_profileEventId, __LINE__))
 #else
 #define FALCOR_PROFILE(_pRenderContext, _name)
 #define FALCOR_PROFILE_CUSTOM(_pRenderContext, _name, _flags)
+#define FALCOR_PROFILE_CPU(_name)
 #endif
@@ -277,6 +277,10 @@ void ProfilerUI::renderOptions()
             if (saveFileDialog(filters, path))
             {
                 pCapture->writeToFile(path);
+                // Write CPU events of all threads in Chrome trace format next to the capture.
+                auto tracePath = path;
+                tracePath.replace_extension(".trace.json");
+                pCapture->writeChromeTraceToFile(tracePath);
             }
         }
     }
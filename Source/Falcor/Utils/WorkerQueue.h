@@ -0,0 +1,247 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Queue of jobs processed in FIFO order by a fixed number of worker threads.
+ *
+ * This is the common building block of the background loaders and writers (e.g. the vertex cache and tile streamers).
+ * The owner keeps the results of the jobs in its own state, guarded by the queue mutex: the complete callback is
+ * invoked with the mutex held, and the owner accesses its state while holding a lock returned by lock().
+ * Functions taking a lock must be called with a lock returned by lock().
+ *
+ * Exceptions thrown while processing a job never escape the worker threads. They are logged as warnings and the job
+ * is completed with success set to false. Owners that need the result of a failed job process it again on their own
+ * thread, so that the exception propagates to the caller.
+ *
+ * The callbacks typically access the state of the owner, so the queue must be destroyed first, i.e., declared after that state.
+ */
+template<typename Job>
+class WorkerQueue
+{
+public:
+    using Lock = std::unique_lock<std::mutex>;
+
+    struct Callbacks
+    {
+        /// Process a job. Called on a worker thread without holding the mutex.
+        std::function<void(Job&)> process;
+        /// Called on the worker thread with the mutex held when a job is done (optional). Must not throw.
+        std::function<void(Job&, bool success)> complete;
+        /// Describe a job in error messages, e.g. "load frame 3" (optional).
+        std::function<std::string(const Job&)> describe;
+    };
+
+    /**
+     * Constructor. Starts the worker threads.
+     * @param[in] threadCount Number of worker threads.
+     * @param[in] callbacks Callbacks to process jobs.
+     */
+    WorkerQueue(uint32_t threadCount, Callbacks callbacks) : mCallbacks(std::move(callbacks))
+    {
+        FALCOR_CHECK(threadCount > 0, "WorkerQueue requires at least one worker thread.");
+        FALCOR_CHECK(mCallbacks.process, "WorkerQueue requires a process callback.");
+
+        for (uint32_t i = 0; i < threadCount; i++)
+            mThreads.emplace_back(&WorkerQueue::runWorker, this);
+    }
+
+    /**
+     * Destructor. Discards the queued jobs and blocks until the running jobs are done.
+     */
+    ~WorkerQueue()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mTerminate = true;
+            mQueue.clear();
+        }
+        mWorkCondition.notify_all();
+
+        for (auto& thread : mThreads)
+            thread.join();
+    }
+
+    WorkerQueue(const WorkerQueue&) = delete;
+    WorkerQueue& operator=(const WorkerQueue&) = delete;
+
+    /// Lock the queue mutex.
+    Lock lock() const { return Lock(mMutex); }
+
+    /// Queue a job.
+    void push(Job job)
+    {
+        Lock l = lock();
+        push(l, std::move(job));
+    }
+
+    /// Queue a job.
+    void push(const Lock& lock, Job job)
+    {
+        checkLock(lock);
+        mQueue.push_back(std::move(job));
+        mWorkCondition.notify_one();
+    }
+
+    /**
+     * Remove the queued jobs for which pred(job) is true. Running jobs are not affected.
+     * @return Number of removed jobs.
+     */
+    template<typename Pred>
+    size_t cancelIf(const Lock& lock, Pred pred)
+    {
+        checkLock(lock);
+        size_t count = mQueue.size();
+        mQueue.erase(std::remove_if(mQueue.begin(), mQueue.end(), pred), mQueue.end());
+        return count - mQueue.size();
+    }
+
+    /// Check if a queued job satisfies pred(job).
+    template<typename Pred>
+    bool isQueued(const Lock& lock, Pred pred) const
+    {
+        checkLock(lock);
+        return std::any_of(mQueue.begin(), mQueue.end(), pred);
+    }
+
+    /// Check if a running job satisfies pred(job).
+    template<typename Pred>
+    bool isRunning(const Lock& lock, Pred pred) const
+    {
+        checkLock(lock);
+        return std::any_of(mRunning.begin(), mRunning.end(), [&](const Job* pJob) { return pred(*pJob); });
+    }
+
+    /// Block until pred() is true. The predicate is evaluated with the mutex held, and again each time a job is done.
+    template<typename Pred>
+    void wait(Lock& lock, Pred pred)
+    {
+        checkLock(lock);
+        mDoneCondition.wait(lock, pred);
+    }
+
+    /// Block until all queued and running jobs are done.
+    void flush()
+    {
+        Lock l = lock();
+        wait(l, [&]() { return mQueue.empty() && mRunning.empty(); });
+    }
+
+    /// Get the number of queued and running jobs.
+    uint32_t getPendingCount(const Lock& lock) const
+    {
+        checkLock(lock);
+        return (uint32_t)(mQueue.size() + mRunning.size());
+    }
+
+private:
+    void checkLock(const Lock& lock) const { FALCOR_ASSERT(lock.owns_lock() && lock.mutex() == &mMutex); }
+
+    bool process(Job& job)
+    {
+        try
+        {
+            mCallbacks.process(job);
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            logWarning("Failed to {}: {}", describe(job), e.what());
+        }
+        catch (...)
+        {
+            logWarning("Failed to {}: Unknown error.", describe(job));
+        }
+        return false;
+    }
+
+    std::string describe(const Job& job) const
+    {
+        if (!mCallbacks.describe)
+            return "process job";
+        try
+        {
+            return mCallbacks.describe(job);
+        }
+        catch (...)
+        {
+            return "process job";
+        }
+    }
+
+    void runWorker()
+    {
+        Lock lock(mMutex);
+        while (true)
+        {
+            mWorkCondition.wait(lock, [&]() { return mTerminate || !mQueue.empty(); });
+            if (mTerminate)
+                break;
+
+            Job job = std::move(mQueue.front());
+            mQueue.pop_front();
+            mRunning.push_back(&job);
+
+            lock.unlock();
+            bool success = process(job);
+            lock.lock();
+
+            if (mCallbacks.complete)
+                mCallbacks.complete(job, success);
+            mRunning.erase(std::find(mRunning.begin(), mRunning.end(), &job));
+            mDoneCondition.notify_all();
+        }
+    }
+
+    Callbacks mCallbacks;
+
+    mutable std::mutex mMutex;
+    std::condition_variable mWorkCondition; ///< Signaled when a job is queued or the workers should terminate.
+    std::condition_variable mDoneCondition; ///< Signaled when a job is done.
+    std::vector<std::thread> mThreads;
+
+    // Internal state. Do not access outside of critical section.
+    std::deque<Job> mQueue;            ///< Jobs waiting to be processed.
+    std::vector<const Job*> mRunning;  ///< Jobs being processed.
+    bool mTerminate = false;
+};
+} // namespace Falcor
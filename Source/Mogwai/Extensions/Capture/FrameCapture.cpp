@@ -41,6 +41,13 @@ namespace Mogwai
         const std::string kUI = "ui";
         const std::string kOutputs = "outputs";
         const std::string kCapture = "capture";
+        const std::string kFlush = "flush";
+
+        // Number of frames a readback can be in flight before the capture waits for it. Independent of the number of outputs.
+        const uint32_t kReadbackFrameCount = 3;
+        // Limits for the image writer. When all images are pending, the capture waits for the writer.
+        const uint32_t kMaxWriterThreads = 4;
+        const uint32_t kMaxPendingImages = 8;
 
         template<typename T>
         std::vector<typename T::value_type::first_type> getFirstOfPair(const T& pair)
@@ -63,6 +70,17 @@ namespace Mogwai
         : CaptureTrigger(pRenderer, "Frame Capture")
     {
         mpImageProcessing = std::make_unique<ImageProcessing>(pRenderer->getDevice());
+
+        AsyncImageWriter::Options writerOptions;
+        writerOptions.threadCount = std::clamp(std::thread::hardware_concurrency(), 1u, kMaxWriterThreads);
+        writerOptions.maxPendingImages = kMaxPendingImages;
+        mpImageWriter = std::make_unique<AsyncImageWriter>(writerOptions);
+        mpReadbackRing = std::make_unique<TextureReadbackRing>(pRenderer->getDevice(), kReadbackFrameCount);
+    }
+
+    FrameCapture::~FrameCapture()
+    {
+        flush();
     }
 
     void FrameCapture::renderUI(Gui* pGui)
@@ -95,6 +113,7 @@ namespace Mogwai
         auto printGraph = [](FrameCapture* pFC, RenderGraph* pGraph) { pybind11::print(pFC->graphFramesStr(pGraph)); };
         frameCapture.def(kPrintFrames.c_str(), printGraph, "graph"_a);
         frameCapture.def(kCapture.c_str(), &FrameCapture::capture);
+        frameCapture.def(kFlush.c_str(), &FrameCapture::flush);
         auto printAllGraphs = [](FrameCapture* pFC)
         {
             std::string s;
@@ -134,6 +153,9 @@ namespace Mogwai
 
     void FrameCapture::triggerFrame(RenderContext* pRenderContext, RenderGraph* pGraph, uint64_t frameID)
     {
+        // Hand over the readbacks of previous frames that have completed to the writer.
+        mpReadbackRing->poll();
+
         std::vector<std::string> unmarkedOutputs;
 
         if (mCaptureAllOutputs)
@@ -154,6 +176,19 @@ namespace Mogwai
             for (const auto& output : unmarkedOutputs) pGraph->unmarkOutput(output);
             pGraph->compile(pRenderContext);
         }
+
+        // Release the scratch textures that were not used in this frame, e.g. after the outputs have been resized.
+        for (auto it = mScratchTextures.begin(); it != mScratchTextures.end();)
+        {
+            if (!it->second.used) it = mScratchTextures.erase(it);
+            else
+            {
+                it->second.used = false;
+                ++it;
+            }
+        }
+
+        mpReadbackRing->endFrame();
     }
 
     void FrameCapture::captureOutput(RenderContext* pRenderContext, RenderGraph* pGraph, const uint32_t outputIndex)
@@ -237,21 +272,53 @@ namespace Mogwai
                 }
 
                 // Copy color channel into temporary texture.
-                pTex = mpRenderer->getDevice()->createTexture2D(pOutput->getWidth(), pOutput->getHeight(), outputFormat, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess);
+                pTex = getScratchTexture(pOutput->getWidth(), pOutput->getHeight(), outputFormat, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess);
                 mpImageProcessing->copyColorChannel(pRenderContext, pOutput->getSRV(0, 1, 0, 1), pTex->getUAV(), mask);
             }
 
-            // Write output image.
+            // Determine output file.
             auto ext = Bitmap::getFileExtFromResourceFormat(pTex->getFormat());
             auto fileformat = Bitmap::getFormatFromFileExtension(ext);
             std::string filename = basename + suffix + "." + ext;
             Bitmap::ExportFlags flags = Bitmap::ExportFlags::None;
             if (mask == TextureChannelFlags::RGBA) flags |= Bitmap::ExportFlags::ExportAlpha;
 
-            pTex->captureToFile(0, 0, filename, fileformat, flags);
+            if (fileformat == Bitmap::FileFormat::DdsFile) FALCOR_THROW("Graph output {} can't be captured to DDS.", outputName);
+            if (pTex->getType() != Texture::Type::Texture2D) FALCOR_THROW("Graph output {} is not a 2D texture.", outputName);
+
+            // HDR textures with less than 3 channels are expanded to RGBA32Float before writing (same as Texture::captureToFile()).
+            if (getFormatType(pTex->getFormat()) == FormatType::Float && getFormatChannelCount(pTex->getFormat()) < 3)
+            {
+                ref<Texture> pExpanded = getScratchTexture(pTex->getWidth(), pTex->getHeight(), ResourceFormat::RGBA32Float, ResourceBindFlags::RenderTarget | ResourceBindFlags::ShaderResource);
+                pRenderContext->blit(pTex->getSRV(0, 1, 0, 1), pExpanded->getRTV(0, 0, 1));
+                pTex = pExpanded;
+            }
+
+            // Read back the image without waiting for the GPU and pass it on to the writer once available.
+            AsyncImageWriter::Image image;
+            image.path = filename;
+            image.width = pTex->getWidth();
+            image.height = pTex->getHeight();
+            image.fileFormat = fileformat;
+            image.exportFlags = flags;
+            image.resourceFormat = pTex->getFormat();
+
+            mpReadbackRing->read(pTex.get(), 0, [this, image = std::move(image)](std::vector<uint8_t> data) mutable
+            {
+                image.data = std::move(data);
+                mpImageWriter->write(std::move(image));
+            });
         }
     }
 
+    ref<Texture> FrameCapture::getScratchTexture(uint32_t width, uint32_t height, ResourceFormat format, ResourceBindFlags bindFlags)
+    {
+        ScratchTexture& scratch = mScratchTextures[{ width, height, format, bindFlags }];
+        if (!scratch.pTexture) scratch.pTexture = mpRenderer->getDevice()->createTexture2D(width, height, format, 1, 1, nullptr, bindFlags);
+        scratch.used = true;
+        return scratch.pTexture;
+    }
+
     void FrameCapture::addFrames(const RenderGraph* pGraph, const uint64_vec& frames)
     {
         for (auto f : frames) addRange(pGraph, f, 1);
@@ -278,5 +345,17 @@ namespace Mogwai
         if (!pGraph) return;
         uint64_t frameID = mpRenderer->getGlobalClock().getFrame();
         triggerFrame(mpRenderer->getRenderContext(), pGraph, frameID);
+        flush();
+    }
+
+    void FrameCapture::flush()
+    {
+        mpReadbackRing->flush();
+        mpImageWriter->flush();
+    }
+
+    void FrameCapture::endRange(RenderGraph* pGraph, const Range& r)
+    {
+        flush();
     }
 }
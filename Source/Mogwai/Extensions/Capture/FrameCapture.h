@@ -28,7 +28,11 @@
 #pragma once
 #include "../../Mogwai.h"
 #include "CaptureTrigger.h"
+#include "Utils/Image/AsyncImageWriter.h"
 #include "Utils/Image/ImageProcessing.h"
+#include "Utils/Image/TextureReadbackRing.h"
+#include <map>
+#include <tuple>
 
 namespace Mogwai
 {
@@ -36,6 +40,7 @@ namespace Mogwai
     {
     public:
         static UniquePtr create(Renderer* pRenderer);
+        virtual ~FrameCapture();
         virtual void renderUI(Gui* pGui) override;
         virtual void registerScriptBindings(pybind11::module& m) override;
         virtual std::string getScriptVar() const override;
@@ -43,16 +48,32 @@ namespace Mogwai
         virtual void triggerFrame(RenderContext* pRenderContext, RenderGraph* pGraph, uint64_t frameID) override;
         void capture();
 
+        /** Wait for all captured images to be read back and written to disk.
+        */
+        void flush();
+
     private:
         FrameCapture(Renderer* pRenderer);
+        virtual void endRange(RenderGraph* pGraph, const Range& r) override;
 
         using uint64_vec = std::vector<uint64_t>;
         void addFrames(const RenderGraph* pGraph, const uint64_vec& frames);
         void addFrames(const std::string& graphName, const uint64_vec& frames);
         std::string graphFramesStr(const RenderGraph* pGraph);
         void captureOutput(RenderContext* pRenderContext, RenderGraph* pGraph, const uint32_t outputIndex);
+        ref<Texture> getScratchTexture(uint32_t width, uint32_t height, ResourceFormat format, ResourceBindFlags bindFlags);
+
+        struct ScratchTexture
+        {
+            ref<Texture> pTexture;
+            bool used = false;      ///< True if the texture was used in the current frame.
+        };
+        using ScratchKey = std::tuple<uint32_t, uint32_t, ResourceFormat, ResourceBindFlags>;
 
         bool mCaptureAllOutputs = false;
         std::unique_ptr<ImageProcessing> mpImageProcessing;
+        std::unique_ptr<AsyncImageWriter> mpImageWriter;        ///< Encodes and writes images on worker threads.
+        std::unique_ptr<TextureReadbackRing> mpReadbackRing;    ///< Reads back captured textures without stalling the GPU.
+        std::map<ScratchKey, ScratchTexture> mScratchTextures;  ///< Textures for channel extraction and format conversion, keyed by size, format and bind flags.
     };
 }
@@ -839,6 +839,7 @@ int runMain(int argc, char** argv)
     args::Flag deferredFlag(parser, "deferred", "The script is loaded deferred.", {"deferred"});
     args::ValueFlag<std::string> sceneFlag(parser, "path", "Scene file (for example, a .pyscene file) to open.", { 'S', "scene" });
     args::ValueFlag<std::string> shaderCacheFlag(parser, "shadercache", "Path to the GFX shader cache.", { "shadercache" });
+    args::ValueFlag<std::string> programCacheFlag(parser, "programcache", "Path to the program cache.", { "programcache" });
     args::ValueFlag<std::string> logfileFlag(parser, "path", "File to write log into.", {'l', "logfile"});
     args::ValueFlag<int32_t> verbosityFlag(parser, "verbosity", "Logging verbosity (0=disabled, 1=fatal errors, 2=errors, 3=warnings, 4=infos, 5=debugging)", { 'v', "verbosity" }, 4);
     args::Flag silentFlag(parser, "", "Start without opening a window and handling user input (deprecated: use --headless).", {"silent"});
@@ -934,6 +935,8 @@ int runMain(int argc, char** argv)
         config.headless = true;
     if (shaderCacheFlag)
         config.deviceDesc.shaderCachePath = args::get(shaderCacheFlag);
+    if (programCacheFlag)
+        config.deviceDesc.programCachePath = args::get(programCacheFlag);
     if (enableDebugLayerFlag)
         config.deviceDesc.enableDebugLayer = true;
     if (generateShaderDebugInfoFlag)
@@ -233,6 +233,7 @@ namespace Mogwai
                 << "Program kernels time (total): " << s.programKernelsTotalTime << " s" << std::endl
                 << "Program version time (max): " << s.programVersionMaxTime << " s" << std::endl
                 << "Program kernels time (max): " << s.programKernelsMaxTime << " s" << std::endl
+                << "Program cache hits/misses: " << s.programCacheHitCount << " / " << s.programCacheMissCount << std::endl
                 << "Total shader code-gen time: " << totalTime << " s" << std::endl
                 << "Downstream compilation time: " << downstreamTime << " s" << std::endl;
             g.text(oss.str());
@@ -56,6 +56,17 @@ int runMain(int argc, char** argv)
     args::ValueFlag<std::string> tagFilterFlag(parser, "tags", "Filter test cases by tags.", {'t', "tags"});
     args::ValueFlag<std::string> xmlReportFlag(parser, "path", "XML report output file.", {'x', "xml-report"});
     args::ValueFlag<uint32_t> repeatFlag(parser, "N", "Number of times to repeat the test.", {'r', "repeat"});
+    args::Flag benchmarkFlag(parser, "", "Run benchmarks with warm-up and repetitions (otherwise a single iteration is run).", {'b', "benchmark"});
+    args::ValueFlag<uint32_t> benchmarkWarmupFlag(parser, "N", "Number of benchmark warm-up iterations (default: 1).", {"benchmark-warmup"});
+    args::ValueFlag<uint32_t> benchmarkRepetitionsFlag(parser, "N", "Number of timed benchmark iterations (default: 10).", {"benchmark-repetitions"});
+    args::ValueFlag<std::string> benchmarkReportFlag(parser, "path", "Benchmark JSON report output file.", {"benchmark-report"});
+    args::ValueFlag<std::string> benchmarkBaselineFlag(parser, "path", "Benchmark JSON report to compare against.", {"benchmark-baseline"});
+    args::ValueFlag<double> benchmarkThresholdFlag(
+        parser, "ratio", "Relative increase of the median time reported as regression (default: 0.1).", {"benchmark-threshold"}
+    );
+    args::ValueFlag<double> benchmarkMinDeltaFlag(
+        parser, "ms", "Absolute increase of the median time below which changes are ignored (default: 0.05).", {"benchmark-min-delta"}
+    );
     args::Flag enableDebugLayerFlag(parser, "", "Enable debug layer (enabled by default in Debug build).", {"enable-debug-layer"});
     args::Flag enableAftermathFlag(parser, "", "Enable Aftermath GPU crash dump.", {"enable-aftermath"});
 
@@ -130,6 +141,26 @@ int runMain(int argc, char** argv)
     if (repeatFlag)
         options.repeat = args::get(repeatFlag);
 
+    // Setting any of the benchmark options implies running benchmarks.
+    options.benchmark = benchmarkFlag || benchmarkWarmupFlag || benchmarkRepetitionsFlag || benchmarkReportFlag || benchmarkBaselineFlag;
+    if (benchmarkWarmupFlag)
+        options.benchmarkOptions.warmup = args::get(benchmarkWarmupFlag);
+    if (benchmarkRepetitionsFlag)
+        options.benchmarkOptions.repetitions = args::get(benchmarkRepetitionsFlag);
+    if (benchmarkReportFlag)
+        options.benchmarkReportPath = args::get(benchmarkReportFlag);
+    if (benchmarkBaselineFlag)
+        options.benchmarkBaselinePath = args::get(benchmarkBaselineFlag);
+    if (benchmarkThresholdFlag)
+        options.benchmarkCompareOptions.threshold = args::get(benchmarkThresholdFlag);
+    if (benchmarkMinDeltaFlag)
+        options.benchmarkCompareOptions.minDeltaMS = args::get(benchmarkMinDeltaFlag);
+    if (options.benchmark && options.benchmarkOptions.repetitions == 0)
+    {
+        std::cerr << "Number of benchmark repetitions must be at least 1" << std::endl;
+        return 1;
+    }
+
     if (listTestSuites || listTestCases || listTags)
     {
         std::vector<unittest::Test> tests = unittest::enumerateTests();
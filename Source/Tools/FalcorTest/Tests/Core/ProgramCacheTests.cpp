@@ -0,0 +1,229 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Program/ProgramCache.h"
+#include "Core/Program/ProgramManager.h"
+#include <chrono>
+#include <fstream>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kElementCount = 256;
+
+std::filesystem::path createTempDirectory()
+{
+    auto path = std::filesystem::temp_directory_path() / fmt::format("FalcorProgramCacheTest-{:08x}", std::random_device()());
+    std::filesystem::create_directories(path);
+    return path;
+}
+
+void writeTextFile(const std::filesystem::path& path, const std::string& text)
+{
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    stream << text;
+}
+
+ProgramCache::Key makeKey(uint8_t value)
+{
+    ProgramCache::Key key{};
+    key[0] = value;
+    return key;
+}
+
+void testProgram(GPUUnitTestContext& ctx, const DefineList& defines)
+{
+    ctx.createProgram("Tests/Core/ProgramCacheTests.cs.slang", "main", defines);
+    ctx.allocateStructuredBuffer("result", kElementCount);
+    ctx.runProgram(kElementCount, 1, 1);
+
+    std::vector<uint32_t> result = ctx.readBuffer<uint32_t>("result");
+    for (uint32_t i = 0; i < kElementCount; i++)
+        EXPECT_EQ(result[i], i * 3 + 1) << "i = " << i;
+}
+} // namespace
+
+CPU_TEST(ProgramCacheStoreLoad)
+{
+    auto directory = createTempDirectory();
+    auto sourcePath = directory / "source.slang";
+    writeTextFile(sourcePath, "void foo() {}");
+
+    {
+        ProgramCache cache(directory);
+
+        ProgramCache::Entry entry;
+        auto hash = cache.getFileHash(sourcePath);
+        ASSERT(hash.has_value());
+        entry.dependencies.push_back({sourcePath.string(), *hash});
+        entry.modules.push_back({"imported", "imported.slang", {1, 2, 3}});
+        entry.modules.push_back({"main", sourcePath.string(), {4, 5, 6, 7}});
+        entry.translationUnits = {1};
+
+        EXPECT(!cache.load(makeKey(1)));
+        EXPECT(cache.store(makeKey(1), entry));
+
+        auto loaded = cache.load(makeKey(1));
+        ASSERT(loaded.has_value());
+        ASSERT_EQ(loaded->dependencies.size(), 1);
+        EXPECT_EQ(loaded->dependencies[0].path, sourcePath.string());
+        EXPECT(loaded->dependencies[0].hash == *hash);
+        ASSERT_EQ(loaded->modules.size(), 2);
+        EXPECT_EQ(loaded->modules[0].name, "imported");
+        EXPECT_EQ(loaded->modules[0].path, "imported.slang");
+        EXPECT(loaded->modules[0].data == std::vector<uint8_t>({1, 2, 3}));
+        EXPECT_EQ(loaded->modules[1].name, "main");
+        EXPECT(loaded->modules[1].data == std::vector<uint8_t>({4, 5, 6, 7}));
+        ASSERT_EQ(loaded->translationUnits.size(), 1);
+        EXPECT_EQ(loaded->translationUnits[0], 1);
+
+        // Other keys are not affected.
+        EXPECT(!cache.load(makeKey(2)));
+
+        // Changing a dependency invalidates the entry.
+        // Note: Hashes are memoized on modification time, so use a new cache instance to not depend on file time resolution.
+        writeTextFile(sourcePath, "void bar() {}");
+    }
+
+    {
+        ProgramCache cache(directory);
+        EXPECT(!cache.load(makeKey(1)));
+
+        // Truncated entries are rejected.
+        ProgramCache::Entry entry;
+        entry.modules.push_back({"main", "", std::vector<uint8_t>(1000, 0)});
+        entry.translationUnits = {0};
+        EXPECT(cache.store(makeKey(3), entry));
+        EXPECT(cache.load(makeKey(3)).has_value());
+        auto entryPath = directory / (SHA1::toString(makeKey(3)) + ".bin");
+        std::filesystem::resize_file(entryPath, std::filesystem::file_size(entryPath) / 2);
+        EXPECT(!cache.load(makeKey(3)));
+
+        cache.clear();
+        EXPECT(!std::filesystem::exists(entryPath));
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+CPU_TEST(ProgramCacheEviction)
+{
+    auto directory = createTempDirectory();
+    const uint32_t kMaxEntryCount = 8;
+
+    ProgramCache::Entry entry;
+    entry.modules.push_back({"main", "", {1, 2, 3}});
+    entry.translationUnits = {0};
+
+    {
+        ProgramCache cache(directory, kMaxEntryCount);
+        for (uint32_t i = 0; i < kMaxEntryCount; i++)
+            EXPECT(cache.store(makeKey(i), entry));
+        EXPECT_EQ(cache.getEntryCount(), kMaxEntryCount);
+
+        // Mark the first entry as most recently used. Set the times explicitly to not depend on file time resolution.
+        auto now = std::filesystem::file_time_type::clock::now();
+        for (uint32_t i = 0; i < kMaxEntryCount; i++)
+            std::filesystem::last_write_time(directory / (SHA1::toString(makeKey(i)) + ".bin"), now - std::chrono::hours(kMaxEntryCount - i));
+        EXPECT(cache.load(makeKey(0)).has_value());
+
+        // Exceeding the limit evicts the least recently used entries down to three quarters of the limit.
+        EXPECT(cache.store(makeKey(kMaxEntryCount), entry));
+        EXPECT_EQ(cache.getEntryCount(), kMaxEntryCount - kMaxEntryCount / 4);
+        EXPECT(cache.load(makeKey(0)).has_value());
+        EXPECT(cache.load(makeKey(kMaxEntryCount)).has_value());
+        EXPECT(!cache.load(makeKey(1)));
+        EXPECT(!cache.load(makeKey(2)));
+        EXPECT(cache.load(makeKey(kMaxEntryCount - 1)).has_value());
+
+        // Replacing an entry doesn't change the count.
+        EXPECT(cache.store(makeKey(0), entry));
+        EXPECT_EQ(cache.getEntryCount(), kMaxEntryCount - kMaxEntryCount / 4);
+    }
+
+    // Existing entries are counted and evicted when opening the cache with a lower limit.
+    {
+        ProgramCache cache(directory, 2);
+        EXPECT_EQ(cache.getEntryCount(), 2);
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+GPU_TEST(ProgramCacheHit)
+{
+    ProgramManager* pProgramManager = ctx.getDevice()->getProgramManager();
+
+    // Use a temporary cache directory, so that the first compilation is not found in the cache
+    // and the test doesn't add entries to the user's cache.
+    auto directory = createTempDirectory();
+    std::filesystem::path prevDirectory = pProgramManager->getProgramCache() ? pProgramManager->getProgramCache()->getDirectory() : "";
+    pProgramManager->setProgramCachePath(directory);
+
+    const bool enabled = pProgramManager->isProgramCacheEnabled();
+    if (enabled)
+    {
+        auto stats = pProgramManager->getCompilationStats();
+        testProgram(ctx, {});
+        EXPECT_EQ(pProgramManager->getCompilationStats().programCacheMissCount, stats.programCacheMissCount + 1);
+        EXPECT_EQ(pProgramManager->getCompilationStats().programCacheHitCount, stats.programCacheHitCount);
+
+        // Creating the same program again loads it from the cache and produces the same results.
+        stats = pProgramManager->getCompilationStats();
+        testProgram(ctx, {});
+        EXPECT_EQ(pProgramManager->getCompilationStats().programCacheHitCount, stats.programCacheHitCount + 1);
+        EXPECT_EQ(pProgramManager->getCompilationStats().programCacheMissCount, stats.programCacheMissCount);
+    }
+
+    pProgramManager->setProgramCachePath(prevDirectory);
+    std::filesystem::remove_all(directory);
+
+    if (!enabled)
+        ctx.skip("Program cache is disabled");
+}
+
+GPU_TEST(ProgramCacheInvalidPath)
+{
+    ProgramManager* pProgramManager = ctx.getDevice()->getProgramManager();
+
+    // A cache path that can't be used as a directory disables the cache instead of failing.
+    auto directory = createTempDirectory();
+    auto filePath = directory / "file";
+    writeTextFile(filePath, "");
+
+    std::filesystem::path prevDirectory = pProgramManager->getProgramCache() ? pProgramManager->getProgramCache()->getDirectory() : "";
+    pProgramManager->setProgramCachePath(filePath);
+    EXPECT(pProgramManager->getProgramCache() == nullptr);
+    EXPECT(!pProgramManager->isProgramCacheEnabled());
+
+    pProgramManager->setProgramCachePath(prevDirectory);
+    std::filesystem::remove_all(directory);
+}
+} // namespace Falcor
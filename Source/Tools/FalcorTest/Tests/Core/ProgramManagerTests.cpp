@@ -0,0 +1,113 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Program/ProgramManager.h"
+#include <random>
+
+namespace Falcor
+{
+GPU_TEST(ProgramManagerCompilePrograms)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    ProgramManager* pProgramManager = pDevice->getProgramManager();
+
+    // Create a few programs with unique defines so they are not found in the program cache.
+    const uint32_t kProgramCount = 4;
+    const uint32_t seed = std::random_device()();
+    std::vector<ref<Program>> programs;
+    std::vector<const Program*> programPtrs;
+    for (uint32_t i = 0; i < kProgramCount; i++)
+    {
+        DefineList defines = {{"VALUE", std::to_string(i)}, {"SEED", std::to_string(seed)}};
+        programs.push_back(Program::createCompute(pDevice, "Tests/Core/ProgramManagerTests.cs.slang", "main", defines));
+        programPtrs.push_back(programs.back().get());
+    }
+    // Duplicates are ignored.
+    programPtrs.push_back(programs[0].get());
+
+    bool parallelCompilationEnabled = pProgramManager->isParallelCompilationEnabled();
+    pProgramManager->setParallelCompilationEnabled(true);
+
+    size_t versionCount = pProgramManager->getCompilationStats().programVersionCount;
+    pProgramManager->compilePrograms(programPtrs);
+    EXPECT_EQ(pProgramManager->getCompilationStats().programVersionCount, versionCount + kProgramCount);
+
+    // Programs are linked, so using them doesn't compile again.
+    versionCount = pProgramManager->getCompilationStats().programVersionCount;
+    for (const auto& pProgram : programs)
+    {
+        EXPECT(pProgram->getActiveVersion() != nullptr);
+        EXPECT(pProgram->getReflector()->getDefaultParameterBlock()->getResourceBinding("result").isValid());
+    }
+    EXPECT_EQ(pProgramManager->getCompilationStats().programVersionCount, versionCount);
+
+    // Compiling again is a no-op.
+    pProgramManager->compilePrograms(programPtrs);
+    EXPECT_EQ(pProgramManager->getCompilationStats().programVersionCount, versionCount);
+
+    pProgramManager->setParallelCompilationEnabled(parallelCompilationEnabled);
+}
+
+GPU_TEST(ProgramManagerCompilePendingPrograms)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    ProgramManager* pProgramManager = pDevice->getProgramManager();
+
+    // Create programs with and without an owner.
+    const uint32_t kProgramCount = 2;
+    const uint32_t seed = std::random_device()();
+    const int owner = 0;
+    std::vector<ref<Program>> ownedPrograms;
+    std::vector<ref<Program>> otherPrograms;
+    for (uint32_t i = 0; i < kProgramCount; i++)
+    {
+        DefineList defines = {{"VALUE", std::to_string(i)}, {"SEED", std::to_string(seed)}};
+        {
+            ProgramManager::ProgramOwnerScope programOwnerScope(pProgramManager, &owner);
+            ownedPrograms.push_back(Program::createCompute(pDevice, "Tests/Core/ProgramManagerTests.cs.slang", "main", defines));
+        }
+        defines.add("OTHER", "1");
+        otherPrograms.push_back(Program::createCompute(pDevice, "Tests/Core/ProgramManagerTests.cs.slang", "main", defines));
+    }
+
+    bool parallelCompilationEnabled = pProgramManager->isParallelCompilationEnabled();
+    pProgramManager->setParallelCompilationEnabled(true);
+
+    // Only the programs of the owner are compiled.
+    size_t versionCount = pProgramManager->getCompilationStats().programVersionCount;
+    pProgramManager->compilePendingPrograms(&owner);
+    EXPECT_EQ(pProgramManager->getCompilationStats().programVersionCount, versionCount + kProgramCount);
+
+    versionCount = pProgramManager->getCompilationStats().programVersionCount;
+    for (const auto& pProgram : otherPrograms)
+        EXPECT(pProgram->getActiveVersion() != nullptr);
+    EXPECT_EQ(pProgramManager->getCompilationStats().programVersionCount, versionCount + kProgramCount);
+
+    pProgramManager->setParallelCompilationEnabled(parallelCompilationEnabled);
+}
+} // namespace Falcor
@@ -0,0 +1,119 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "RenderGraph/ResourceCache.h"
+
+namespace Falcor
+{
+namespace
+{
+using Field = RenderPassReflection::Field;
+
+Field createField(const std::string& name, Field::Visibility visibility, ResourceFormat format = ResourceFormat::RGBA32Float)
+{
+    return Field(name, "", visibility).texture2D(64, 64).format(format);
+}
+
+/**
+ * Register a simple chain of passes A -> B -> C -> D, where each pass reads the output of the previous pass.
+ * Pass D writes the graph output and pass B additionally has an internal field.
+ */
+void registerChain(ResourceCache& cache, ResourceFormat formatC = ResourceFormat::RGBA32Float)
+{
+    cache.registerField("A.out", createField("out", Field::Visibility::Output), 0);
+
+    cache.registerField("B.out", createField("out", Field::Visibility::Output), 1);
+    cache.registerField("B.internal", createField("internal", Field::Visibility::Internal), 1);
+    cache.registerField("B.in", createField("in", Field::Visibility::Input), 1, "A.out");
+
+    cache.registerField("C.out", createField("out", Field::Visibility::Output, formatC), 2);
+    cache.registerField("C.in", createField("in", Field::Visibility::Input), 2, "B.out");
+
+    cache.registerField("D.out", createField("out", Field::Visibility::Output), uint32_t(-1));
+    cache.registerField("D.in", createField("in", Field::Visibility::Input, formatC), 3, "C.out");
+}
+} // namespace
+
+GPU_TEST(ResourceCacheAliasing)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    ResourceCache::DefaultProperties params{uint2(64, 64), ResourceFormat::RGBA32Float};
+
+    ResourceCache cache;
+    cache.setAliasingEnabled(true);
+    registerChain(cache);
+    cache.allocateResources(pDevice, params);
+
+    // A.out is dead after pass B and can be reused by C.out.
+    EXPECT(cache.getResource("A.out") == cache.getResource("C.out"));
+    EXPECT(cache.getResource("A.out") != cache.getResource("B.out"));
+    // Internal fields and graph outputs are never shared.
+    EXPECT(cache.getResource("B.internal") != cache.getResource("A.out"));
+    EXPECT(cache.getResource("D.out") != cache.getResource("A.out"));
+    EXPECT(cache.getResource("D.out") != cache.getResource("B.out"));
+
+    const auto& stats = cache.getMemoryStats();
+    const uint64_t size = cache.getResource("A.out")->asTexture()->getTextureSizeInBytes();
+    EXPECT_EQ(stats.fieldCount, 5u);
+    EXPECT_EQ(stats.resourceCount, 4u);
+    EXPECT_EQ(stats.unaliasedMemory, 5 * size);
+    EXPECT_EQ(stats.allocatedMemory, 4 * size);
+    EXPECT_EQ(stats.getSavedMemory(), size);
+    // At time point 1: A.out, B.out, B.internal and D.out are alive.
+    EXPECT_EQ(stats.peakMemory, 4 * size);
+}
+
+GPU_TEST(ResourceCacheAliasingIncompatible)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    ResourceCache::DefaultProperties params{uint2(64, 64), ResourceFormat::RGBA32Float};
+
+    // Resources with different formats are not shared.
+    ResourceCache cache;
+    cache.setAliasingEnabled(true);
+    registerChain(cache, ResourceFormat::RGBA8Unorm);
+    cache.allocateResources(pDevice, params);
+    EXPECT(cache.getResource("A.out") != cache.getResource("C.out"));
+    EXPECT_EQ(cache.getMemoryStats().getSavedMemory(), 0u);
+}
+
+GPU_TEST(ResourceCacheAliasingDisabled)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    ResourceCache::DefaultProperties params{uint2(64, 64), ResourceFormat::RGBA32Float};
+
+    // Aliasing is opt-in.
+    ResourceCache cache;
+    EXPECT(!cache.isAliasingEnabled());
+    registerChain(cache);
+    cache.allocateResources(pDevice, params);
+    EXPECT(cache.getResource("A.out") != cache.getResource("C.out"));
+    EXPECT_EQ(cache.getMemoryStats().resourceCount, 5u);
+    EXPECT_EQ(cache.getMemoryStats().getSavedMemory(), 0u);
+}
+} // namespace Falcor
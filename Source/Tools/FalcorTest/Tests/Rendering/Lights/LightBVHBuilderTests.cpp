@@ -0,0 +1,184 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Rendering/Lights/LightBVH.h"
+#include "Rendering/Lights/LightBVHBuilder.h"
+#include "Scene/Lights/ILightCollection.h"
+#include <cstring>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+/// Light collection with a fixed list of emissive triangles.
+class TestLightCollection : public ILightCollection
+{
+public:
+    TestLightCollection(ref<Device> pDevice, std::vector<MeshLightTriangle> triangles)
+        : mpDevice(pDevice), mTriangles(std::move(triangles))
+    {
+        mStats.triangleCount = (uint32_t)mTriangles.size();
+        mStats.trianglesActive = (uint32_t)mTriangles.size();
+    }
+
+    const ref<Device>& getDevice() const override { return mpDevice; }
+    bool update(RenderContext* pRenderContext, UpdateStatus* pUpdateStatus) override { return false; }
+    void bindShaderData(const ShaderVar& var) const override {}
+    uint32_t getTotalLightCount() const override { return (uint32_t)mTriangles.size(); }
+    const MeshLightStats& getStats(RenderContext* pRenderContext) const override { return mStats; }
+    const std::vector<MeshLightTriangle>& getMeshLightTriangles(RenderContext* pRenderContext) const override { return mTriangles; }
+    const std::vector<MeshLightData>& getMeshLights() const override { return mMeshLights; }
+    void prepareSyncCPUData(RenderContext* pRenderContext) const override {}
+    uint64_t getMemoryUsageInBytes() const override { return 0; }
+    UpdateFlagsSignal::Interface getUpdateFlagsSignal() override { return mUpdateFlagsSignal.getInterface(); }
+
+private:
+    ref<Device> mpDevice;
+    std::vector<MeshLightTriangle> mTriangles;
+    std::vector<MeshLightData> mMeshLights;
+    MeshLightStats mStats;
+    UpdateFlagsSignal mUpdateFlagsSignal;
+};
+
+/// Light BVH with access to the CPU-side nodes.
+class TestLightBVH : public LightBVH
+{
+public:
+    using LightBVH::LightBVH;
+    const std::vector<PackedNode>& getNodes() const { return mNodes; }
+};
+
+/// Creates emissive triangles scattered in clusters of varying density, orientation and flux.
+std::vector<ILightCollection::MeshLightTriangle> createTriangles(uint32_t triangleCount, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+
+    std::vector<ILightCollection::MeshLightTriangle> triangles(triangleCount);
+    float3 clusterCenter = float3(0.f);
+    float clusterRadius = 1.f;
+    for (uint32_t i = 0; i < triangleCount; i++)
+    {
+        if (i % 1000 == 0)
+        {
+            clusterCenter = float3(u(rng), u(rng), u(rng)) * 100.f;
+            clusterRadius = 0.1f + 10.f * u(rng);
+        }
+
+        auto& tri = triangles[i];
+        float3 p = clusterCenter + (float3(u(rng), u(rng), u(rng)) - 0.5f) * clusterRadius;
+        for (uint32_t j = 0; j < 3; j++)
+            tri.vtx[j].pos = p + (float3(u(rng), u(rng), u(rng)) - 0.5f) * 0.1f;
+        float3 n = cross(tri.vtx[1].pos - tri.vtx[0].pos, tri.vtx[2].pos - tri.vtx[0].pos);
+        tri.area = 0.5f * length(n);
+        tri.normal = tri.area > 0.f ? normalize(n) : float3(0.f, 0.f, 1.f);
+        tri.lightIdx = 0;
+        // Cull some triangles to exercise the pre-integration path.
+        tri.flux = u(rng) < 0.05f ? 0.f : tri.area * (1.f + 10.f * u(rng));
+        tri.averageRadiance = float3(tri.area > 0.f ? tri.flux / tri.area : 0.f);
+    }
+    return triangles;
+}
+
+void build(RenderContext* pRenderContext, LightBVH& bvh, const LightBVHBuilder::Options& options)
+{
+    LightBVHBuilder builder(options);
+    builder.build(pRenderContext, bvh);
+}
+} // namespace
+
+GPU_TEST(LightBVHBuilderParallel)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = ctx.getRenderContext();
+
+    ref<TestLightCollection> pLightCollection = make_ref<TestLightCollection>(pDevice, createTriangles(100000, 1));
+
+    const LightBVHBuilder::SplitHeuristic heuristics[] = {
+        LightBVHBuilder::SplitHeuristic::Equal,
+        LightBVHBuilder::SplitHeuristic::BinnedSAH,
+        LightBVHBuilder::SplitHeuristic::BinnedSAOH,
+    };
+
+    for (auto heuristic : heuristics)
+    {
+        for (bool createLeavesASAP : {true, false})
+        {
+            LightBVHBuilder::Options options;
+            options.splitHeuristicSelection = heuristic;
+            options.createLeavesASAP = createLeavesASAP;
+
+            TestLightBVH serialBVH(pDevice, pLightCollection);
+            options.useParallelBuild = false;
+            build(pRenderContext, serialBVH, options);
+
+            TestLightBVH parallelBVH(pDevice, pLightCollection);
+            options.useParallelBuild = true;
+            build(pRenderContext, parallelBVH, options);
+
+            ASSERT(serialBVH.isValid());
+            ASSERT(parallelBVH.isValid());
+
+            // The parallel build must produce the exact same tree.
+            const auto& serialNodes = serialBVH.getNodes();
+            const auto& parallelNodes = parallelBVH.getNodes();
+            EXPECT_EQ(serialNodes.size(), parallelNodes.size());
+            if (serialNodes.size() == parallelNodes.size())
+                EXPECT(std::memcmp(serialNodes.data(), parallelNodes.data(), serialNodes.size() * sizeof(PackedNode)) == 0);
+
+            const auto& serialStats = serialBVH.getStats();
+            const auto& parallelStats = parallelBVH.getStats();
+            EXPECT_EQ(serialStats.triangleCount, parallelStats.triangleCount);
+            EXPECT_EQ(serialStats.treeHeight, parallelStats.treeHeight);
+            EXPECT_EQ(serialStats.leafNodeCount, parallelStats.leafNodeCount);
+            EXPECT_EQ(serialStats.internalNodeCount, parallelStats.internalNodeCount);
+            EXPECT_EQ(parallelStats.internalNodeCount + 1, parallelStats.leafNodeCount);
+        }
+    }
+}
+
+GPU_BENCHMARK(LightBVHBuilderBenchmark)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = ctx.getRenderContext();
+
+    ref<TestLightCollection> pLightCollection = make_ref<TestLightCollection>(pDevice, createTriangles(1000000, 2));
+    const BenchmarkCounters counters = {{"triangles", 1000000.0}};
+
+    LightBVHBuilder::Options options;
+    TestLightBVH bvh(pDevice, pLightCollection);
+
+    options.useParallelBuild = false;
+    ctx.measure("serial", [&]() { build(pRenderContext, bvh, options); }, counters);
+    options.useParallelBuild = true;
+    ctx.measure("parallel", [&]() { build(pRenderContext, bvh, options); }, counters);
+
+    EXPECT(bvh.isValid());
+}
+} // namespace Falcor
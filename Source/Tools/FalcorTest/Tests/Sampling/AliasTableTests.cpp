@@ -27,10 +27,12 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Utils/Sampling/AliasTable.h"
+#include "Utils/Sampling/AliasTableBuilder.h"
 
 #include <hypothesis/hypothesis.h>
 
 #include <iostream>
+#include <random>
 
 namespace Falcor
 {
@@ -56,7 +58,7 @@ void testAliasTable(GPUUnitTestContext& ctx, uint32_t N, std::vector<float> spec
     }
 
     // Create alias table.
-    AliasTable aliasTable(pDevice, weights, rng);
+    AliasTable aliasTable(pDevice, weights);
 
     // Compute weight sum.
     double weightSum = 0.0;
@@ -137,8 +139,139 @@ void testAliasTable(GPUUnitTestContext& ctx, uint32_t N, std::vector<float> spec
         }
     }
 }
+
+std::vector<float> createWeights(uint32_t N, std::mt19937& rng)
+{
+    // Mix of uniform, zero and a few very large weights.
+    std::uniform_real_distribution<float> uniform;
+    std::vector<float> weights(N);
+    for (auto& w : weights)
+    {
+        float u = uniform(rng);
+        w = u < 0.05f ? 0.f : (u > 0.999f ? 1000.f * uniform(rng) : uniform(rng));
+    }
+    return weights;
+}
+
+void testAliasTableBuilder(CPUUnitTestContext& ctx, const std::vector<float>& weights)
+{
+    std::vector<AliasTableEntry> entries;
+    double weightSum = buildAliasTable(weights, entries);
+    ASSERT_EQ(entries.size(), weights.size());
+
+    double expectedSum = 0.0;
+    for (float w : weights)
+        expectedSum += w;
+    EXPECT_LE(std::abs(weightSum - expectedSum), 1e-9 * expectedSum);
+
+    // Accumulate the probability mass each item receives from the table, in units of one entry.
+    const size_t N = weights.size();
+    std::vector<double> mass(N, 0.0);
+    for (size_t i = 0; i < N; ++i)
+    {
+        const auto& entry = entries[i];
+        EXPECT(entry.threshold >= 0.f && entry.threshold <= 1.f);
+        ASSERT(entry.alias < N);
+        mass[i] += entry.threshold;
+        mass[entry.alias] += 1.0 - entry.threshold;
+    }
+
+    // Each item should be picked proportional to its weight (uniformly if all weights are zero).
+    size_t mismatchCount = 0;
+    for (size_t i = 0; i < N; ++i)
+    {
+        double expected = weightSum > 0.0 ? weights[i] * (N / weightSum) : 1.0;
+        if (std::abs(mass[i] - expected) > 1e-4 * std::max(1.0, expected))
+            mismatchCount++;
+    }
+    EXPECT_EQ(mismatchCount, 0u);
+}
+
+// Sequential construction (Vose 1991) as used by AliasTable before the parallel builder. Used as benchmark reference.
+void buildAliasTableReference(
+    std::vector<float> weights,
+    std::vector<uint32_t>& indexA,
+    std::vector<uint32_t>& indexB,
+    std::vector<float>& thresholds
+)
+{
+    const uint32_t N = (uint32_t)weights.size();
+    std::vector<uint32_t> lowIdx(N, 0xFFFFFFFFu);
+    std::vector<uint32_t> highIdx(N, 0xFFFFFFFFu);
+
+    double weightSum = 0.0;
+    for (float f : weights)
+        weightSum += f;
+    float avgWeight = float(weightSum / double(N));
+
+    uint32_t lowCount = 0;
+    uint32_t highCount = 0;
+    for (uint32_t i = 0; i < N; ++i)
+    {
+        if (weights[i] < avgWeight)
+            lowIdx[lowCount++] = i;
+        else
+            highIdx[highCount++] = i;
+    }
+
+    indexA.resize(N);
+    indexB.resize(N);
+    thresholds.resize(N);
+    for (uint32_t i = 0; i < N; ++i)
+    {
+        if (lowIdx[i] != 0xFFFFFFFFu && highIdx[i] != 0xFFFFFFFFu)
+        {
+            thresholds[i] = weights[lowIdx[i]] / avgWeight;
+            indexA[i] = highIdx[i];
+            indexB[i] = lowIdx[i];
+            float updatedWeight = (weights[lowIdx[i]] + weights[highIdx[i]]) - avgWeight;
+            weights[highIdx[i]] = updatedWeight;
+            if (updatedWeight < avgWeight)
+                lowIdx[lowCount++] = highIdx[i];
+            else
+                highIdx[highCount++] = highIdx[i];
+        }
+        else
+        {
+            uint32_t idx = highIdx[i] != 0xFFFFFFFFu ? highIdx[i] : lowIdx[i];
+            thresholds[i] = 1.f;
+            indexA[i] = idx;
+            indexB[i] = idx;
+        }
+    }
+}
 } // namespace
 
+CPU_TEST(AliasTableBuild)
+{
+    testAliasTableBuilder(ctx, {});
+    testAliasTableBuilder(ctx, {1.f});
+    testAliasTableBuilder(ctx, {1.f, 2.f});
+    testAliasTableBuilder(ctx, {0.f, 0.f, 0.f});
+    testAliasTableBuilder(ctx, {1.f, 1.f, 1.f, 1.f});
+    testAliasTableBuilder(ctx, {0.f, 0.f, 5.f, 0.f});
+
+    // Sizes spanning several chunks of the parallel build.
+    std::mt19937 rng;
+    testAliasTableBuilder(ctx, createWeights(1000, rng));
+    testAliasTableBuilder(ctx, createWeights(100000, rng));
+}
+
+CPU_BENCHMARK(AliasTableBuildBenchmark)
+{
+    std::mt19937 rng;
+    std::vector<float> weights = createWeights(4000000, rng);
+    const BenchmarkCounters counters = {{"weights", double(weights.size())}};
+
+    std::vector<uint32_t> indexA, indexB;
+    std::vector<float> thresholds;
+    std::vector<AliasTableEntry> entries;
+    ctx.measure("reference", [&]() { buildAliasTableReference(weights, indexA, indexB, thresholds); }, counters);
+    ctx.measure("parallel", [&]() { buildAliasTable(weights, entries); }, counters);
+
+    EXPECT_EQ(entries.size(), weights.size());
+}
+
 GPU_TEST(AliasTable)
 {
     testAliasTable(ctx, 1, {1.f});
@@ -0,0 +1,187 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Animation/AnimationEvaluator.h"
+#include <cmath>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+ref<Animation> createRandomAnimation(std::mt19937& rng, uint32_t keyframeCount)
+{
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+    const Animation::Behavior behaviors[] = {
+        Animation::Behavior::Constant,
+        Animation::Behavior::Linear,
+        Animation::Behavior::Cycle,
+        Animation::Behavior::Oscillate,
+    };
+
+    const double duration = 10.0;
+    ref<Animation> pAnimation = Animation::create("anim", NodeID{0}, duration);
+    pAnimation->setPreInfinityBehavior(behaviors[rng() % 4]);
+    pAnimation->setPostInfinityBehavior(behaviors[rng() % 4]);
+    pAnimation->setInterpolationMode(rng() % 2 ? Animation::InterpolationMode::Hermite : Animation::InterpolationMode::Linear);
+    pAnimation->setEnableWarping(rng() % 2 == 0);
+
+    // Keyframes start after zero to exercise the pre-infinity behavior.
+    for (uint32_t i = 0; i < keyframeCount; i++)
+    {
+        Animation::Keyframe keyframe;
+        keyframe.time = 1.0 + 8.0 * (i + u(rng) * 0.9) / keyframeCount;
+        keyframe.translation = float3(u(rng), u(rng), u(rng)) * 10.f - 5.f;
+        keyframe.scaling = float3(u(rng), u(rng), u(rng)) + 0.5f;
+        keyframe.rotation = normalize(quatf(u(rng) - 0.5f, u(rng) - 0.5f, u(rng) - 0.5f, u(rng) - 0.5f));
+        pAnimation->addKeyframe(keyframe);
+    }
+    return pAnimation;
+}
+
+std::vector<ref<Animation>> createRandomAnimations(uint32_t count, uint32_t maxKeyframeCount, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<ref<Animation>> animations;
+    for (uint32_t i = 0; i < count; i++) animations.push_back(createRandomAnimation(rng, 1 + rng() % maxKeyframeCount));
+    return animations;
+}
+
+size_t countMismatches(const std::vector<float4x4>& result, const std::vector<float4x4>& ref)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < ref.size(); i++)
+    {
+        bool match = true;
+        for (int r = 0; r < 4; r++)
+            for (int c = 0; c < 4; c++)
+                match = match && std::abs(result[i][r][c] - ref[i][r][c]) <= 1e-5f * std::max(1.f, std::abs(ref[i][r][c]));
+        if (!match) count++;
+    }
+    return count;
+}
+
+std::vector<float4x4> animateReference(const std::vector<ref<Animation>>& animations, double time)
+{
+    std::vector<float4x4> transforms;
+    for (const auto& pAnimation : animations) transforms.push_back(pAnimation->animate(time));
+    return transforms;
+}
+} // namespace
+
+CPU_TEST(AnimationEvaluatorMatchesAnimate)
+{
+    auto animations = createRandomAnimations(1000, 8, 1);
+
+    for (bool parallel : {false, true})
+    {
+        AnimationEvaluator evaluator;
+        // Step forward, backward and beyond the keyframe range in both directions.
+        for (double time : {0.0, 0.5, 1.5, 3.0, 4.5, 2.0, 9.5, 12.0, 25.0, -3.0, 7.0})
+        {
+            evaluator.evaluate(animations, time, parallel);
+            EXPECT_EQ(countMismatches(evaluator.getTransforms(), animateReference(animations, time)), size_t(0)) << "time = " << time;
+        }
+    }
+}
+
+CPU_TEST(AnimationEvaluatorBehavior)
+{
+    // Translation from 0 to 1 between time 1 and 2.
+    auto create = [](Animation::Behavior behavior)
+    {
+        ref<Animation> pAnimation = Animation::create("anim", NodeID{0}, 2.0);
+        pAnimation->addKeyframe({1.0, float3(0.f), float3(1.f), quatf::identity()});
+        pAnimation->addKeyframe({2.0, float3(1.f, 0.f, 0.f), float3(1.f), quatf::identity()});
+        pAnimation->setPreInfinityBehavior(behavior);
+        pAnimation->setPostInfinityBehavior(behavior);
+        return pAnimation;
+    };
+
+    std::vector<ref<Animation>> animations = {
+        create(Animation::Behavior::Constant),
+        create(Animation::Behavior::Linear),
+        create(Animation::Behavior::Cycle),
+        create(Animation::Behavior::Oscillate),
+    };
+
+    AnimationEvaluator evaluator;
+    auto translationX = [&](double time, size_t i)
+    {
+        evaluator.evaluate(animations, time);
+        return evaluator.getTransforms()[i][0][3];
+    };
+
+    EXPECT_EQ(translationX(1.25, 0), 0.25f);
+    EXPECT_EQ(translationX(3.25, 0), 1.f);
+    EXPECT_EQ(translationX(0.5, 0), 0.f);
+    EXPECT_LE(std::abs(translationX(3.5, 1) - 2.5f), 0.05f);
+    EXPECT_LE(std::abs(translationX(0.5, 1) + 0.5f), 0.05f);
+    EXPECT_EQ(translationX(3.25, 2), 0.25f);
+    EXPECT_EQ(translationX(0.75, 2), 0.75f);
+    EXPECT_EQ(translationX(2.25, 3), 0.75f);
+    EXPECT_EQ(translationX(3.25, 3), 0.25f);
+}
+
+CPU_TEST(AnimationEvaluatorRepack)
+{
+    auto animations = createRandomAnimations(10, 4, 2);
+    AnimationEvaluator evaluator;
+    evaluator.evaluate(animations, 5.0);
+
+    // Changed keyframes and a changed list of animations are picked up.
+    animations[3]->addKeyframe({5.0, float3(1.f, 2.f, 3.f), float3(1.f), quatf::identity()});
+    evaluator.evaluate(animations, 5.0);
+    EXPECT_EQ(countMismatches(evaluator.getTransforms(), animateReference(animations, 5.0)), size_t(0));
+
+    std::mt19937 rng(3);
+    animations.push_back(createRandomAnimation(rng, 5));
+    evaluator.evaluate(animations, 5.0);
+    EXPECT_EQ(evaluator.getTransforms().size(), animations.size());
+    EXPECT_EQ(countMismatches(evaluator.getTransforms(), animateReference(animations, 5.0)), size_t(0));
+}
+
+CPU_BENCHMARK(AnimationEvaluatorBenchmark)
+{
+    auto animations = createRandomAnimations(100000, 64, 1);
+    AnimationEvaluator evaluator;
+    evaluator.evaluate(animations, 0.0);
+    const BenchmarkCounters counters = {{"animations", double(animations.size())}};
+
+    // Advance the time every iteration, as for consecutive frames.
+    auto measure = [&](const std::string& name, auto func)
+    {
+        uint32_t frame = 0;
+        ctx.measure(name, [&]() { func(1.0 + frame++ / 60.0); }, counters);
+    };
+
+    measure("Animation::animate", [&](double time) { for (auto& pAnimation : animations) pAnimation->animate(time); });
+    measure("serial", [&](double time) { evaluator.evaluate(animations, time, false); });
+    measure("parallel", [&](double time) { evaluator.evaluate(animations, time, true); });
+}
+} // namespace Falcor
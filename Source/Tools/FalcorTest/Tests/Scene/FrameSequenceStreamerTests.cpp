@@ -0,0 +1,198 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Volume/FrameSequenceStreamer.h"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+namespace Falcor
+{
+namespace
+{
+using TestStreamer = FrameSequenceStreamer<std::vector<uint32_t>, std::vector<uint32_t>>;
+
+const uint32_t kFrameSize = 1000;
+
+TestStreamer::Callbacks createCallbacks(std::chrono::milliseconds loadTime)
+{
+    TestStreamer::Callbacks callbacks;
+    callbacks.load = [loadTime](uint32_t frame)
+    {
+        std::this_thread::sleep_for(loadTime);
+        return std::vector<uint32_t>(kFrameSize, frame);
+    };
+    callbacks.convert = [](std::vector<uint32_t>& data)
+    {
+        for (auto& v : data) v *= 2;
+    };
+    callbacks.create = [](std::vector<uint32_t>&& data) { return std::move(data); };
+    callbacks.getByteSize = [](const std::vector<uint32_t>& data) { return data.size() * sizeof(uint32_t); };
+    return callbacks;
+}
+
+bool isFrame(const std::vector<uint32_t>& data, uint32_t frame)
+{
+    return data.size() == kFrameSize && data.front() == 2 * frame && data.back() == 2 * frame;
+}
+} // namespace
+
+CPU_TEST(FrameSequenceStreamerPlayback)
+{
+    const uint32_t frameCount = 50;
+    TestStreamer::Options options;
+    options.maxResidentFrames = 4;
+    options.prefetchCount = 3;
+    TestStreamer streamer(frameCount, createCallbacks(std::chrono::milliseconds(1)), options);
+
+    // Forward playback, skipping every other frame, followed by backward playback.
+    std::vector<uint32_t> frames;
+    for (uint32_t i = 0; i < 20; i++) frames.push_back((2 * i) % frameCount);
+    for (uint32_t i = 0; i < 20; i++) frames.push_back(frameCount - 1 - i);
+
+    for (uint32_t frame : frames)
+    {
+        EXPECT(isFrame(streamer.getFrame(frame), frame)) << "frame " << frame;
+        EXPECT(streamer.isResident(frame));
+        EXPECT_LE(streamer.getResidentFrameCount(), options.maxResidentFrames);
+        // Give the background thread time to read ahead.
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    // Only the first request and the requests after changing direction should miss.
+    const auto& stats = streamer.getStats();
+    EXPECT_EQ(stats.requestCount, uint64_t(frames.size()));
+    EXPECT_EQ(stats.hitCount + stats.prefetchHitCount + stats.missCount, stats.requestCount);
+    EXPECT_GE(stats.prefetchHitCount, stats.requestCount - 6);
+    EXPECT_GE(stats.evictionCount, uint64_t(frames.size() - options.maxResidentFrames));
+
+    auto frameStats = streamer.getFrameStats(frames.back());
+    EXPECT_GE(frameStats.loadCount, 1u);
+    EXPECT_GE(frameStats.loadTimeMs, 0.5);
+    auto average = streamer.getAverageFrameStats();
+    EXPECT_GE(average.loadTimeMs, 0.5);
+    EXPECT_GE(average.loadCount, uint32_t(frames.size()) - 2);
+}
+
+CPU_TEST(FrameSequenceStreamerMemoryBudget)
+{
+    const uint32_t frameCount = 20;
+    TestStreamer::Options options;
+    options.maxResidentFrames = 10;
+    options.memoryBudget = 3 * kFrameSize * sizeof(uint32_t) + 1;
+    options.prefetchCount = 0;
+    TestStreamer streamer(frameCount, createCallbacks(std::chrono::milliseconds(0)), options);
+
+    for (uint32_t frame = 0; frame < frameCount; frame++)
+    {
+        EXPECT(isFrame(streamer.getFrame(frame), frame));
+        EXPECT_LE(streamer.getResidentByteSize(), options.memoryBudget);
+    }
+    EXPECT_EQ(streamer.getResidentFrameCount(), 3u);
+
+    // The most recently used frames are resident, requesting them again hits.
+    EXPECT(streamer.isResident(frameCount - 1));
+    EXPECT(!streamer.isResident(0));
+    uint64_t hitCount = streamer.getStats().hitCount;
+    streamer.getFrame(frameCount - 2);
+    EXPECT_EQ(streamer.getStats().hitCount, hitCount + 1);
+
+    // Without prefetching every new frame is a miss.
+    EXPECT_EQ(streamer.getStats().prefetchHitCount, uint64_t(0));
+    EXPECT_EQ(streamer.getStats().missCount, uint64_t(frameCount));
+}
+
+CPU_TEST(FrameSequenceStreamerSeek)
+{
+    const uint32_t frameCount = 100;
+    TestStreamer::Options options;
+    options.maxResidentFrames = 2;
+    options.prefetchCount = 4;
+    TestStreamer streamer(frameCount, createCallbacks(std::chrono::milliseconds(2)), options);
+
+    // Random seeks must always return the requested frame, also while read-ahead is in flight.
+    uint32_t frame = 0;
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        frame = (frame * 37 + 11) % frameCount;
+        EXPECT(isFrame(streamer.getFrame(frame), frame)) << "frame " << frame;
+        EXPECT(isFrame(streamer.getFrame((frame + 1) % frameCount), (frame + 1) % frameCount));
+    }
+    EXPECT_LE(streamer.getResidentFrameCount(), options.maxResidentFrames);
+
+    // Looped playback wraps around the end of the sequence.
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        uint32_t f = (frameCount - 5 + i) % frameCount;
+        EXPECT(isFrame(streamer.getFrame(f), f));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    EXPECT(streamer.isResident(4));
+}
+
+CPU_TEST(FrameSequenceStreamerLoadFailure)
+{
+    const uint32_t frameCount = 10;
+    const uint32_t failingFrame = 3;
+    TestStreamer::Options options;
+    options.maxResidentFrames = 2;
+    options.prefetchCount = 3;
+
+    // Fail the first loads of a frame. The read-ahead load fails on the background thread.
+    std::atomic<uint32_t> failureCount = 1;
+    TestStreamer::Callbacks callbacks = createCallbacks(std::chrono::milliseconds(1));
+    auto load = callbacks.load;
+    callbacks.load = [&, load](uint32_t frame)
+    {
+        if (frame == failingFrame && failureCount > 0)
+        {
+            failureCount--;
+            throw std::runtime_error("Failed to load frame");
+        }
+        return load(frame);
+    };
+    TestStreamer streamer(frameCount, callbacks, options);
+
+    // A failed read-ahead load is retried when the frame is requested.
+    EXPECT(isFrame(streamer.getFrame(1), 1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(failureCount, 0);
+    EXPECT(isFrame(streamer.getFrame(2), 2));
+    EXPECT(isFrame(streamer.getFrame(failingFrame), failingFrame));
+    EXPECT_EQ(streamer.getStats().missCount, 2);
+
+    // Load errors on the requesting thread are reported to the caller.
+    failureCount = 100;
+    EXPECT(isFrame(streamer.getFrame(7), 7));
+    EXPECT(isFrame(streamer.getFrame(8), 8));
+    EXPECT_THROW(streamer.getFrame(failingFrame));
+    EXPECT(!streamer.isResident(failingFrame));
+    EXPECT(isFrame(streamer.getFrame(4), 4));
+}
+} // namespace Falcor
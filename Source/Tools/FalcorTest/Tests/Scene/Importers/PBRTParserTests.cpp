@@ -0,0 +1,170 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "PBRTImporter/Parser.h"
+#include <fstream>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+std::filesystem::path getTempDirectory()
+{
+    auto path = std::filesystem::temp_directory_path() / fmt::format("FalcorPBRTParserTest-{:08x}", std::random_device()());
+    std::filesystem::create_directories(path);
+    return path;
+}
+
+void writeFile(const std::filesystem::path& path, const std::string& str)
+{
+    std::ofstream(path) << str;
+}
+
+/// Parser target logging the parsed directives (without file locations) for comparing parses.
+class LoggingTarget : public pbrt::ParserTarget
+{
+public:
+    std::vector<std::string> log;
+
+    // clang-format off
+    void onScale(pbrt::Float sx, pbrt::Float sy, pbrt::Float sz, pbrt::FileLoc loc) override { add("Scale {} {} {}", sx, sy, sz); }
+    void onShape(const std::string& name, pbrt::ParsedParameterVector params, pbrt::FileLoc loc) override { add("Shape {} {}", name, params.size()); }
+    void onOption(const std::string& name, const std::string& value, pbrt::FileLoc loc) override { add("Option {} {}", name, value); }
+    void onIdentity(pbrt::FileLoc loc) override { add("Identity"); }
+    void onTranslate(pbrt::Float dx, pbrt::Float dy, pbrt::Float dz, pbrt::FileLoc loc) override { add("Translate {} {} {}", dx, dy, dz); }
+    void onRotate(pbrt::Float angle, pbrt::Float ax, pbrt::Float ay, pbrt::Float az, pbrt::FileLoc loc) override { add("Rotate {} {} {} {}", angle, ax, ay, az); }
+    void onLookAt(pbrt::Float ex, pbrt::Float ey, pbrt::Float ez, pbrt::Float lx, pbrt::Float ly, pbrt::Float lz, pbrt::Float ux, pbrt::Float uy, pbrt::Float uz, pbrt::FileLoc loc) override { add("LookAt"); }
+    void onConcatTransform(pbrt::Float transform[16], pbrt::FileLoc loc) override { add("ConcatTransform"); }
+    void onTransform(pbrt::Float transform[16], pbrt::FileLoc loc) override { add("Transform"); }
+    void onCoordinateSystem(const std::string& name, pbrt::FileLoc loc) override { add("CoordinateSystem {}", name); }
+    void onCoordSysTransform(const std::string& name, pbrt::FileLoc loc) override { add("CoordSysTransform {}", name); }
+    void onActiveTransformAll(pbrt::FileLoc loc) override { add("ActiveTransformAll"); }
+    void onActiveTransformEndTime(pbrt::FileLoc loc) override { add("ActiveTransformEndTime"); }
+    void onActiveTransformStartTime(pbrt::FileLoc loc) override { add("ActiveTransformStartTime"); }
+    void onTransformTimes(pbrt::Float start, pbrt::Float end, pbrt::FileLoc loc) override { add("TransformTimes {} {}", start, end); }
+    void onColorSpace(const std::string& n, pbrt::FileLoc loc) override { add("ColorSpace {}", n); }
+    void onPixelFilter(const std::string& name, pbrt::ParsedParameterVector params, pbrt::FileLoc loc) override { add("PixelFilter {}", name); }
+    void onFilm(const std::string& type, pbrt::ParsedParameterVector params, pbrt::FileLoc loc) override { add("Film {}", type); }
+    void onAccelerator(const std::string& name, pbrt::ParsedParameterVector params, pbrt::FileLoc loc) override { add("Accelerator {}", name); }
+    void onIntegrator(const std::string& name, pbrt::ParsedParameterVector params, pbrt::FileLoc loc) override { add("Integrator {}", name); }
+    void onCamera(const std::string& name, pbrt::ParsedParameterVector params, pbrt::FileLoc loc) override { add("Camera {}", name); }
+    void onMakeNamedMedium(const std::string& name, pbrt::ParsedParameterVector params, pbrt::FileLoc loc) override { add("MakeNamedMedium {}", name); }
+    void onMediumInterface(const std::string& insideName, const std::string& outsideName, pbrt::FileLoc loc) override { add("MediumInterface {} {}", insideName, outsideName); }
+    void onSampler(const std::string& name, pbrt::ParsedParameterVector params, pbrt::FileLoc loc) override { add("Sampler {}", name); }
+    void onWorldBegin(pbrt::FileLoc loc) override { add("WorldBegin"); }
+    void onAttributeBegin(pbrt::FileLoc loc) override { add("AttributeBegin"); }
+    void onAttributeEnd(pbrt::FileLoc loc) override { add("AttributeEnd"); }
+    void onAttribute(const std::string& target, pbrt::ParsedParameterVector params, pbrt::FileLoc loc) override { add("Attribute {}", target); }
+    void onTexture(const std::string& name, const std::string& type, const std::string& texname, pbrt::ParsedParameterVector params, pbrt::FileLoc loc) override { add("Texture {} {} {}", name, type, texname); }
+    void onMaterial(const std::string& name, pbrt::ParsedParameterVector params, pbrt::FileLoc loc) override { add("Material {}", name); }
+    void onMakeNamedMaterial(const std::string& name, pbrt::ParsedParameterVector params, pbrt::FileLoc loc) override { add("MakeNamedMaterial {}", name); }
+    void onNamedMaterial(const std::string& name, pbrt::FileLoc loc) override { add("NamedMaterial {}", name); }
+    void onLightSource(const std::string& name, pbrt::ParsedParameterVector params, pbrt::FileLoc loc) override { add("LightSource {}", name); }
+    void onAreaLightSource(const std::string& name, pbrt::ParsedParameterVector params, pbrt::FileLoc loc) override { add("AreaLightSource {}", name); }
+    void onReverseOrientation(pbrt::FileLoc loc) override { add("ReverseOrientation"); }
+    void onObjectBegin(const std::string& name, pbrt::FileLoc loc) override { add("ObjectBegin {}", name); }
+    void onObjectEnd(pbrt::FileLoc loc) override { add("ObjectEnd"); }
+    void onObjectInstance(const std::string& name, pbrt::FileLoc loc) override { add("ObjectInstance {}", name); }
+    void onEndOfFiles() override { add("EndOfFiles"); }
+    // clang-format on
+
+private:
+    template<typename... Args>
+    void add(fmt::format_string<Args...> format, Args&&... args)
+    {
+        log.push_back(fmt::format(format, std::forward<Args>(args)...));
+    }
+};
+
+/**
+ * Write a scene with nested imports and includes to a directory.
+ * With useImport == false, each 'Import' is replaced by an 'Include' enclosed in an attribute block,
+ * which is what the merged result of parsing the imports concurrently has to match.
+ */
+std::filesystem::path writeScene(const std::filesystem::path& dir, bool useImport, uint32_t importCount)
+{
+    auto import = [&](const std::string& filename)
+    { return useImport ? fmt::format("Import \"{}\"\n", filename) : fmt::format("AttributeBegin\nInclude \"{}\"\nAttributeEnd\n", filename); };
+
+    writeFile(dir / "leaf.pbrt", "Translate 0 0 1\nShape \"sphere\" \"float radius\" [ 0.5 ]\n");
+    writeFile(dir / "common.pbrt", "Material \"diffuse\"\n");
+
+    std::string main = "LookAt 0 0 0 0 0 1 0 1 0\nCamera \"perspective\"\nWorldBegin\n";
+    for (uint32_t i = 0; i < importCount; i++)
+    {
+        std::string mid = fmt::format("Translate {} 0 0\nInclude \"common.pbrt\"\n", i);
+        for (uint32_t j = 0; j < i % 3; j++)
+            mid += import("leaf.pbrt") + fmt::format("Shape \"trianglemesh\" \"integer indices\" [ {} ]\n", j);
+        writeFile(dir / fmt::format("mid{}.pbrt", i), mid);
+
+        main += import(fmt::format("mid{}.pbrt", i));
+        main += fmt::format("Rotate {} 0 1 0\n", i);
+    }
+    main += "Shape \"disk\"\n";
+
+    auto path = dir / (useImport ? "import.pbrt" : "include.pbrt");
+    writeFile(path, main);
+    return path;
+}
+} // namespace
+
+CPU_TEST(PBRTParser_ImportMatchesSerialParse)
+{
+    auto dir = getTempDirectory();
+
+    // Use more imports than are kept pending, so that merging the imports is interleaved with parsing the main file.
+    const uint32_t importCount = 4 * std::max(1u, std::thread::hardware_concurrency()) + 5;
+
+    LoggingTarget serial;
+    pbrt::parseFile(serial, writeScene(dir, false, importCount));
+
+    LoggingTarget concurrent;
+    pbrt::parseFile(concurrent, writeScene(dir, true, importCount));
+
+    EXPECT_GT(serial.log.size(), importCount);
+    EXPECT_EQ(concurrent.log.size(), serial.log.size());
+    for (size_t i = 0; i < std::min(serial.log.size(), concurrent.log.size()); i++)
+        EXPECT_EQ(concurrent.log[i], serial.log[i]) << "i = " << i;
+
+    std::filesystem::remove_all(dir);
+}
+
+CPU_TEST(PBRTParser_ImportErrorIsRethrown)
+{
+    auto dir = getTempDirectory();
+
+    writeFile(dir / "mid.pbrt", "Import \"missing.pbrt\"\n");
+    writeFile(dir / "main.pbrt", "WorldBegin\nImport \"mid.pbrt\"\nShape \"disk\"\n");
+
+    LoggingTarget target;
+    EXPECT_THROW(pbrt::parseFile(target, dir / "main.pbrt"));
+
+    std::filesystem::remove_all(dir);
+}
+} // namespace Falcor
@@ -0,0 +1,198 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "PBRTImporter/PlyReader.h"
+#include <cstring>
+#include <string>
+
+namespace Falcor
+{
+namespace
+{
+const std::string kAsciiQuad =
+    "ply\n"
+    "format ascii 1.0\n"
+    "comment quad with normals and texture coordinates\n"
+    "element vertex 4\n"
+    "property float x\n"
+    "property float y\n"
+    "property float z\n"
+    "property float nx\n"
+    "property float ny\n"
+    "property float nz\n"
+    "property float u\n"
+    "property float v\n"
+    "element face 1\n"
+    "property list uchar int vertex_indices\n"
+    "end_header\n"
+    "0 0 0 0 0 1 0 0\n"
+    "1 0 0 0 0 1 1 0\n"
+    "1 1 0 0 0 1 1 1\n"
+    "0 1 0 0 0 1 0 1\n"
+    "4 0 1 2 3\n";
+
+/// Returns the header of a binary PLY file with the same content as kAsciiQuad, but without texture coordinates.
+std::string getBinaryHeader(bool bigEndian, std::string_view vertexCount = "4", std::string_view faceCount = "1")
+{
+    return fmt::format(
+        "ply\n"
+        "format {} 1.0\n"
+        "element vertex {}\n"
+        "property float x\n"
+        "property float y\n"
+        "property float z\n"
+        "property float nx\n"
+        "property float ny\n"
+        "property float nz\n"
+        "element face {}\n"
+        "property list uchar int vertex_indices\n"
+        "end_header\n",
+        bigEndian ? "binary_big_endian" : "binary_little_endian",
+        vertexCount,
+        faceCount
+    );
+}
+
+template<typename T>
+void appendBinary(std::string& data, T value, bool bigEndian)
+{
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    if (bigEndian)
+        std::reverse(bytes, bytes + sizeof(T));
+    data.append(bytes, sizeof(T));
+}
+
+std::string getBinaryBody(bool bigEndian)
+{
+    const float kPositions[4][2] = {{0.f, 0.f}, {1.f, 0.f}, {1.f, 1.f}, {0.f, 1.f}};
+
+    std::string data;
+    for (const auto& p : kPositions)
+    {
+        for (float value : {p[0], p[1], 0.f, 0.f, 0.f, 1.f})
+            appendBinary(data, value, bigEndian);
+    }
+    appendBinary(data, uint8_t(4), bigEndian);
+    for (int32_t index : {0, 1, 2, 3})
+        appendBinary(data, index, bigEndian);
+    return data;
+}
+
+void checkQuad(CPUUnitTestContext& ctx, const pbrt::PlyMesh& mesh, bool hasTexCoords)
+{
+    ASSERT_EQ(mesh.vertices.size(), 4);
+    ASSERT_EQ(mesh.indices.size(), 6);
+
+    const uint32_t kIndices[6] = {0, 1, 2, 0, 2, 3};
+    for (size_t i = 0; i < 6; ++i)
+        EXPECT_EQ(mesh.indices[i], kIndices[i]) << "i = " << i;
+
+    EXPECT(all(mesh.vertices[2].position == float3(1.f, 1.f, 0.f)));
+    for (const auto& vertex : mesh.vertices)
+        EXPECT(all(vertex.normal == float3(0.f, 0.f, 1.f)));
+
+    // Texture coordinates are flipped vertically.
+    if (hasTexCoords)
+        EXPECT(all(mesh.vertices[1].texCoord == float2(1.f, 1.f)));
+}
+} // namespace
+
+CPU_TEST(PlyReader_Ascii)
+{
+    checkQuad(ctx, pbrt::readPlyMesh(kAsciiQuad, "quad.ply"), true);
+}
+
+CPU_TEST(PlyReader_Binary)
+{
+    for (bool bigEndian : {false, true})
+        checkQuad(ctx, pbrt::readPlyMesh(getBinaryHeader(bigEndian) + getBinaryBody(bigEndian), "quad.ply"), false);
+}
+
+CPU_TEST(PlyReader_MalformedHeader)
+{
+    const std::string kBody = "0 0 0\n1 0 0\n0 1 0\n3 0 1 2\n";
+    const std::string kElements =
+        "element vertex 3\nproperty float x\nproperty float y\nproperty float z\n"
+        "element face 1\nproperty list uchar int vertex_indices\n";
+
+    // The well-formed file is read correctly.
+    auto mesh = pbrt::readPlyMesh("ply\nformat ascii 1.0\n" + kElements + "end_header\n" + kBody, "valid.ply");
+    EXPECT_EQ(mesh.indices.size(), 3);
+
+    const std::string kMalformed[] = {
+        // Invalid magic.
+        "plx\nformat ascii 1.0\n" + kElements + "end_header\n" + kBody,
+        // Missing end of header.
+        "ply\nformat ascii 1.0\n" + kElements,
+        // Missing format.
+        "ply\n" + kElements + "end_header\n" + kBody,
+        // Unknown format.
+        "ply\nformat binary_middle_endian 1.0\n" + kElements + "end_header\n" + kBody,
+        // Unknown keyword.
+        "ply\nformat ascii 1.0\nunknown\n" + kElements + "end_header\n" + kBody,
+        // Property before any element.
+        "ply\nformat ascii 1.0\nproperty float w\n" + kElements + "end_header\n" + kBody,
+        // Invalid property type.
+        "ply\nformat ascii 1.0\n" + kElements + "property half w\nend_header\n" + kBody,
+        // Invalid element count.
+        "ply\nformat ascii 1.0\nelement vertex -3\nproperty float x\nend_header\n" + kBody,
+        // Element count that doesn't fit the file. This must not try to allocate the vertices.
+        "ply\nformat ascii 1.0\nelement vertex 100000000000000\nproperty float x\nproperty float y\nproperty float z\nend_header\n" +
+            kBody,
+        // Missing position properties.
+        "ply\nformat ascii 1.0\nelement vertex 3\nproperty float x\nproperty float y\nend_header\n" + kBody,
+        // Missing vertex element.
+        "ply\nformat ascii 1.0\nelement face 1\nproperty list uchar int vertex_indices\nend_header\n3 0 1 2\n",
+    };
+
+    for (const auto& data : kMalformed)
+        EXPECT_THROW_AS(pbrt::readPlyMesh(data, "malformed.ply"), RuntimeError);
+}
+
+CPU_TEST(PlyReader_TruncatedBinary)
+{
+    for (bool bigEndian : {false, true})
+    {
+        const std::string header = getBinaryHeader(bigEndian);
+        const std::string body = getBinaryBody(bigEndian);
+
+        // Every truncation of the binary data has to be detected.
+        for (size_t size = 0; size < body.size(); ++size)
+            EXPECT_THROW_AS(pbrt::readPlyMesh(header + body.substr(0, size), "truncated.ply"), RuntimeError);
+
+        // Element and list counts that don't fit the file must not try to allocate the data.
+        EXPECT_THROW_AS(pbrt::readPlyMesh(getBinaryHeader(bigEndian, "4000000000000") + body, "truncated.ply"), RuntimeError);
+        EXPECT_THROW_AS(pbrt::readPlyMesh(getBinaryHeader(bigEndian, "4", "4000000000000") + body, "truncated.ply"), RuntimeError);
+
+        std::string hugeList = body;
+        hugeList[4 * 6 * sizeof(float)] = char(255);
+        EXPECT_THROW_AS(pbrt::readPlyMesh(header + hugeList, "truncated.ply"), RuntimeError);
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,189 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/InstanceDescUpdate.h"
+#include <cstring>
+#include <random>
+#include <utility>
+
+namespace Falcor
+{
+namespace
+{
+using namespace InstanceDescUpdate;
+
+struct TestScene
+{
+    std::vector<uint32_t> instanceDescIndex; ///< Instance desc index of each geometry instance.
+    std::vector<uint32_t> instanceMatrixID;  ///< Global matrix ID of each geometry instance.
+    std::vector<uint32_t> descMatrixIDs;     ///< Global matrix ID of each instance desc.
+    std::vector<float4x4> globalMatrices;
+};
+
+float4x4 randomMatrix(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> u(-10.f, 10.f);
+    float4x4 m = float4x4::identity();
+    for (int r = 0; r < 3; r++)
+        for (int c = 0; c < 4; c++)
+            m[r][c] = u(rng);
+    return m;
+}
+
+/// Create a scene where most descs have their own matrix, some share a matrix and some have an identity transform.
+TestScene createTestScene(std::mt19937& rng, uint32_t descCount, uint32_t matrixCount)
+{
+    TestScene scene;
+    for (uint32_t i = 0; i < matrixCount; i++)
+        scene.globalMatrices.push_back(randomMatrix(rng));
+
+    for (uint32_t descIndex = 0; descIndex < descCount; descIndex++)
+    {
+        uint32_t matrixID = descIndex % 7 == 0 ? kInvalidMatrixID : (uint32_t)(rng() % matrixCount);
+        scene.descMatrixIDs.push_back(matrixID);
+
+        // Descs with an identity transform (static mesh groups) are referenced by several geometry instances with their own matrices.
+        uint32_t instanceCount = matrixID == kInvalidMatrixID ? 3 : 1;
+        for (uint32_t i = 0; i < instanceCount; i++)
+        {
+            scene.instanceDescIndex.push_back(descIndex);
+            scene.instanceMatrixID.push_back(matrixID == kInvalidMatrixID ? (uint32_t)(rng() % matrixCount) : matrixID);
+        }
+    }
+    return scene;
+}
+
+/// Fill all instance descs from scratch, as done by a full TLAS instance desc update.
+std::vector<RtInstanceDesc> fillDescs(const TestScene& scene)
+{
+    std::vector<RtInstanceDesc> descs(scene.descMatrixIDs.size(), RtInstanceDesc{});
+    for (size_t i = 0; i < descs.size(); i++)
+    {
+        uint32_t matrixID = scene.descMatrixIDs[i];
+        descs[i].setTransform(matrixID == kInvalidMatrixID ? float4x4::identity() : scene.globalMatrices[matrixID]);
+    }
+    return descs;
+}
+
+std::vector<std::pair<uint32_t, uint32_t>> getRanges(const std::vector<uint32_t>& sortedIndices)
+{
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+    forEachIndexRange(sortedIndices, [&](uint32_t offset, uint32_t count) { ranges.emplace_back(offset, count); });
+    return ranges;
+}
+} // namespace
+
+CPU_TEST(InstanceDescUpdate_IndexRanges)
+{
+    using Ranges = std::vector<std::pair<uint32_t, uint32_t>>;
+
+    EXPECT(getRanges({}).empty());
+    EXPECT(getRanges({5}) == Ranges({{5, 1}}));
+    EXPECT(getRanges({3, 4, 5}) == Ranges({{3, 3}}));
+
+    // Indices separated by at most kMaxUploadRangeGap unchanged elements are merged.
+    EXPECT(getRanges({0, kMaxUploadRangeGap + 1}) == Ranges({{0, kMaxUploadRangeGap + 2}}));
+    EXPECT(getRanges({0, kMaxUploadRangeGap + 2}) == Ranges({{0, 1}, {kMaxUploadRangeGap + 2, 1}}));
+    EXPECT(getRanges({0, 1, 2, 10, 100, 101, 500}) == Ranges({{0, 11}, {100, 2}, {500, 1}}));
+}
+
+CPU_TEST(InstanceDescUpdate_IncrementalMatchesFullUpdate)
+{
+    std::mt19937 rng(1234);
+    TestScene scene = createTestScene(rng, 5000, 2000);
+    std::vector<RtInstanceDesc> descs = fillDescs(scene);
+
+    // Move a few matrices per frame and update the descs incrementally.
+    for (uint32_t frame = 0; frame < 10; frame++)
+    {
+        std::vector<uint8_t> matrixChanged(scene.globalMatrices.size(), 0);
+        for (uint32_t i = 0; i < 50; i++)
+        {
+            uint32_t matrixID = (uint32_t)(rng() % scene.globalMatrices.size());
+            scene.globalMatrices[matrixID] = randomMatrix(rng);
+            matrixChanged[matrixID] = 1;
+        }
+
+        std::vector<uint32_t> movedInstances;
+        for (uint32_t instanceID = 0; instanceID < scene.instanceMatrixID.size(); instanceID++)
+        {
+            if (matrixChanged[scene.instanceMatrixID[instanceID]]) movedInstances.push_back(instanceID);
+        }
+
+        std::vector<uint32_t> dirtyDescs;
+        collectDirtyDescs(movedInstances, [&](uint32_t instanceID) { return scene.instanceDescIndex[instanceID]; }, scene.descMatrixIDs, dirtyDescs);
+
+        // The dirty descs are sorted, unique and never include descs with an identity transform.
+        EXPECT(std::is_sorted(dirtyDescs.begin(), dirtyDescs.end()));
+        EXPECT(std::adjacent_find(dirtyDescs.begin(), dirtyDescs.end()) == dirtyDescs.end());
+        for (uint32_t descIndex : dirtyDescs)
+            EXPECT_NE(scene.descMatrixIDs[descIndex], kInvalidMatrixID);
+
+        updateTransforms(descs, scene.descMatrixIDs, dirtyDescs, scene.globalMatrices);
+
+        std::vector<RtInstanceDesc> reference = fillDescs(scene);
+        EXPECT(std::memcmp(descs.data(), reference.data(), descs.size() * sizeof(RtInstanceDesc)) == 0);
+    }
+}
+
+CPU_TEST(InstanceDescUpdate_RangeUploadMatchesFullUpload)
+{
+    std::mt19937 rng(4321);
+    TestScene scene = createTestScene(rng, 3000, 1000);
+    std::vector<RtInstanceDesc> descs = fillDescs(scene);
+    std::vector<RtInstanceDesc> gpuDescs = descs;
+
+    for (uint32_t frame = 0; frame < 10; frame++)
+    {
+        std::vector<uint32_t> movedInstances;
+        for (uint32_t i = 0; i < 100; i++)
+        {
+            uint32_t instanceID = (uint32_t)(rng() % scene.instanceMatrixID.size());
+            scene.globalMatrices[scene.instanceMatrixID[instanceID]] = randomMatrix(rng);
+            // All instances using the matrix moved.
+            for (uint32_t j = 0; j < scene.instanceMatrixID.size(); j++)
+            {
+                if (scene.instanceMatrixID[j] == scene.instanceMatrixID[instanceID]) movedInstances.push_back(j);
+            }
+        }
+
+        std::vector<uint32_t> dirtyDescs;
+        collectDirtyDescs(movedInstances, [&](uint32_t instanceID) { return scene.instanceDescIndex[instanceID]; }, scene.descMatrixIDs, dirtyDescs);
+        updateTransforms(descs, scene.descMatrixIDs, dirtyDescs, scene.globalMatrices);
+
+        // Upload the dirty descs in ranges into the persistent GPU copy.
+        forEachIndexRange(dirtyDescs, [&](uint32_t offset, uint32_t count)
+        {
+            std::memcpy(&gpuDescs[offset], &descs[offset], count * sizeof(RtInstanceDesc));
+        });
+
+        std::vector<RtInstanceDesc> reference = fillDescs(scene);
+        EXPECT(std::memcmp(gpuDescs.data(), reference.data(), gpuDescs.size() * sizeof(RtInstanceDesc)) == 0);
+    }
+}
+} // namespace Falcor
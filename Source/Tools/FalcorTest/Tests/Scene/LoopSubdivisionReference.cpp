@@ -1,5 +1,5 @@
 /***************************************************************************
- # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
  #
  # Redistribution and use in source and binary forms, with or without
  # modification, are permitted provided that the following conditions
@@ -26,25 +26,24 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 
-// This code is based on pbrt:
+// The reference implementation is pbrt's pointer-based Loop subdivision:
 // pbrt is Copyright(c) 1998-2020 Matt Pharr, Wenzel Jakob, and Greg Humphreys.
 // The pbrt source code is licensed under the Apache License, Version 2.0.
 // SPDX: Apache-2.0
 
-#include "LoopSubdivide.h"
+#include "LoopSubdivisionReference.h"
 #include "Core/Error.h"
-
 #include <algorithm>
+#include <cmath>
 #include <map>
 #include <memory>
 #include <memory_resource>
 #include <set>
 
-#include <cmath>
-
-namespace Falcor::pbrt
+namespace Falcor
+{
+namespace
 {
-
 struct SDFace;
 struct SDVertex;
 
@@ -131,8 +130,8 @@ struct SDEdge
     int f0edgeNum;
 };
 
-static float3 weightOneRing(SDVertex* vert, float beta);
-static float3 weightBoundary(SDVertex* vert, float beta);
+float3 weightOneRing(SDVertex* vert, float beta);
+float3 weightBoundary(SDVertex* vert, float beta);
 
 inline int SDVertex::valence()
 {
@@ -171,7 +170,68 @@ inline float loopGamma(uint32_t valence)
     return 1.f / (valence + 3.f / (8.f * beta(valence)));
 }
 
-LoopSubdivideResult loopSubdivide(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
+float3 weightOneRing(SDVertex* vert, float beta)
+{
+    // Put vert one-ring in pRing.
+    uint32_t valence = vert->valence();
+    FALCOR_ASSERT(valence < 16);
+    float3 pRing[16];
+
+    vert->oneRing(pRing);
+    float3 p = (1 - valence * beta) * vert->p;
+    for (uint32_t i = 0; i < valence; ++i)
+    {
+        p += beta * pRing[i];
+    }
+    return p;
+}
+
+void SDVertex::oneRing(float3* p_)
+{
+    if (!boundary)
+    {
+        // Get one-ring vertices for interior vertex.
+        SDFace* face = startFace;
+        do
+        {
+            *p_++ = face->nextVert(this)->p;
+            face = face->nextFace(this);
+        } while (face != startFace);
+    }
+    else
+    {
+        // Get one-ring vertices for boundary vertex.
+        SDFace* face = startFace;
+        SDFace* f2;
+        while ((f2 = face->nextFace(this)) != nullptr)
+        {
+            face = f2;
+        }
+        *p_++ = face->nextVert(this)->p;
+        do
+        {
+            *p_++ = face->prevVert(this)->p;
+            face = face->prevFace(this);
+        } while (face != nullptr);
+    }
+}
+
+float3 weightBoundary(SDVertex* vert, float beta)
+{
+    // Put vert one-ring in pRing.
+    uint32_t valence = vert->valence();
+    FALCOR_ASSERT(valence < 16);
+    float3 pRing[16];
+
+    vert->oneRing(pRing);
+    float3 p = (1 - 2 * beta) * vert->p;
+    p += beta * pRing[0];
+    p += beta * pRing[valence - 1];
+    return p;
+}
+} // namespace
+
+LoopSubdivision::Result subdivideReference(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
 {
     std::vector<SDVertex*> vertices;
     std::vector<SDFace*> faces;
@@ -471,72 +531,11 @@ LoopSubdivideResult loopSubdivide(uint32_t levels, fstd::span<const float3> posi
             }
         }
 
-        LoopSubdivideResult result;
+        LoopSubdivision::Result result;
         result.positions = std::move(pLimit);
         result.normals = std::move(Ns);
         result.indices = std::move(verts);
         return result;
     }
 }
-
-static float3 weightOneRing(SDVertex* vert, float beta)
-{
-    // Put vert one-ring in pRing.
-    uint32_t valence = vert->valence();
-    FALCOR_ASSERT(valence < 16);
-    float3 pRing[16];
-
-    vert->oneRing(pRing);
-    float3 p = (1 - valence * beta) * vert->p;
-    for (uint32_t i = 0; i < valence; ++i)
-    {
-        p += beta * pRing[i];
-    }
-    return p;
-}
-
-void SDVertex::oneRing(float3* p_)
-{
-    if (!boundary)
-    {
-        // Get one-ring vertices for interior vertex.
-        SDFace* face = startFace;
-        do
-        {
-            *p_++ = face->nextVert(this)->p;
-            face = face->nextFace(this);
-        } while (face != startFace);
-    }
-    else
-    {
-        // Get one-ring vertices for boundary vertex.
-        SDFace* face = startFace;
-        SDFace* f2;
-        while ((f2 = face->nextFace(this)) != nullptr)
-        {
-            face = f2;
-        }
-        *p_++ = face->nextVert(this)->p;
-        do
-        {
-            *p_++ = face->prevVert(this)->p;
-            face = face->prevFace(this);
-        } while (face != nullptr);
-    }
-}
-
-static float3 weightBoundary(SDVertex* vert, float beta)
-{
-    // Put vert one-ring in pRing.
-    uint32_t valence = vert->valence();
-    FALCOR_ASSERT(valence < 16);
-    float3 pRing[16];
-
-    vert->oneRing(pRing);
-    float3 p = (1 - 2 * beta) * vert->p;
-    p += beta * pRing[0];
-    p += beta * pRing[valence - 1];
-    return p;
-}
-
-} // namespace Falcor::pbrt
+} // namespace Falcor
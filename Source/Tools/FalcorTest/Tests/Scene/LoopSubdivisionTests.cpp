@@ -0,0 +1,128 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/LoopSubdivision.h"
+#include "LoopSubdivisionReference.h"
+#include "TestMeshes.h"
+#include <cstring>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+/**
+ * Creates an open grid mesh in the xy-plane with randomly jittered heights.
+ * The diagonals alternate so that interior vertices have valence 4, 6 and 8.
+ */
+TestMesh createJitteredGridMesh(uint32_t size, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> height(-0.25f, 0.25f);
+    return createGridMesh(size, [&](uint32_t, uint32_t) { return height(rng); }, true);
+}
+
+/// Creates a closed octahedron with one face split into three, giving vertices of valence 3, 4 and 5.
+TestMesh createClosedMesh()
+{
+    TestMesh m;
+    m.positions = {{1.f, 0.f, 0.f}, {-1.f, 0.f, 0.f}, {0.f, 1.f, 0.f}, {0.f, -1.f, 0.f}, {0.f, 0.f, 1.f}, {0.f, 0.f, -1.f}};
+    m.indices = {1, 3, 4, 3, 0, 4, 0, 2, 4, 2, 1, 4, 3, 1, 5, 0, 3, 5, 2, 0, 5, 1, 2, 5};
+
+    // Split the last face at its centroid.
+    m.positions.push_back(float3(-0.3f, 0.3f, -0.4f));
+    m.indices.resize(m.indices.size() - 3);
+    m.indices.insert(m.indices.end(), {1, 2, 6, 2, 5, 6, 5, 1, 6});
+    return m;
+}
+
+template<typename T>
+bool isIdentical(const std::vector<T>& a, const std::vector<T>& b)
+{
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+void expectIdentical(CPUUnitTestContext& ctx, const LoopSubdivision::Result& result, const LoopSubdivision::Result& ref, const std::string& msg)
+{
+    EXPECT_MSG(isIdentical(result.indices, ref.indices), msg);
+    EXPECT_MSG(isIdentical(result.positions, ref.positions), msg);
+    EXPECT_MSG(isIdentical(result.normals, ref.normals), msg);
+}
+} // namespace
+
+CPU_TEST(LoopSubdivisionFlat)
+{
+    const TestMesh meshes[] = {createClosedMesh(), createJitteredGridMesh(1, 1), createJitteredGridMesh(5, 2), createJitteredGridMesh(32, 3)};
+
+    for (size_t i = 0; i < std::size(meshes); i++)
+    {
+        const auto& m = meshes[i];
+        for (uint32_t levels = 0; levels <= 3; levels++)
+        {
+            auto ref = subdivideReference(levels, m.positions, m.indices);
+            EXPECT_EQ(ref.indices.size(), m.indices.size() << (2 * levels));
+
+            for (bool parallel : {false, true})
+            {
+                auto result = LoopSubdivision::subdivideFlat(levels, m.positions, m.indices, parallel);
+                expectIdentical(ctx, result, ref, fmt::format("mesh={} levels={} parallel={}", i, levels, parallel));
+            }
+        }
+    }
+}
+
+CPU_TEST(LoopSubdivisionFlatInvalid)
+{
+    TestMesh m = createClosedMesh();
+
+    // Out of range index.
+    auto indices = m.indices;
+    indices[4] = (uint32_t)m.positions.size();
+    EXPECT_THROW(LoopSubdivision::subdivideFlat(1, m.positions, indices));
+
+    // Vertex not referenced by any triangle.
+    auto positions = m.positions;
+    positions.push_back(float3(0.f));
+    EXPECT_THROW(LoopSubdivision::subdivideFlat(1, positions, m.indices));
+}
+
+CPU_BENCHMARK(LoopSubdivisionBenchmark)
+{
+    const TestMesh m = createJitteredGridMesh(64, 1);
+    const uint32_t levels = 4;
+    const BenchmarkCounters counters = {{"triangles", double(m.indices.size() / 3)}};
+
+    LoopSubdivision::Result ref, serial, parallel;
+    ctx.measure("pointer-based", [&]() { ref = subdivideReference(levels, m.positions, m.indices); }, counters);
+    ctx.measure("flat", [&]() { serial = LoopSubdivision::subdivideFlat(levels, m.positions, m.indices, false); }, counters);
+    ctx.measure("flat parallel", [&]() { parallel = LoopSubdivision::subdivideFlat(levels, m.positions, m.indices, true); }, counters);
+
+    expectIdentical(ctx, serial, ref, "serial");
+    expectIdentical(ctx, parallel, ref, "parallel");
+}
+} // namespace Falcor
@@ -0,0 +1,241 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SDFs/SDFMeshBaker.h"
+#include "Utils/Math/MathConstants.slangh"
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+struct Mesh
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+};
+
+/// Creates an axis-aligned box with outward facing triangles, optionally without its +z face.
+Mesh createBoxMesh(float3 halfExtent, bool open = false)
+{
+    Mesh m;
+    for (uint32_t i = 0; i < 8; i++)
+        m.positions.push_back(float3(i & 1 ? 1.f : -1.f, i & 2 ? 1.f : -1.f, i & 4 ? 1.f : -1.f) * halfExtent);
+
+    // Faces -x, +x, -y, +y, -z, +z given as quads in counter-clockwise order seen from the outside.
+    const uint32_t quads[6][4] = {{0, 4, 6, 2}, {1, 3, 7, 5}, {0, 1, 5, 4}, {2, 6, 7, 3}, {0, 2, 3, 1}, {4, 5, 7, 6}};
+    for (uint32_t f = 0; f < (open ? 5u : 6u); f++)
+    {
+        const uint32_t* q = quads[f];
+        m.indices.insert(m.indices.end(), {q[0], q[1], q[2], q[0], q[2], q[3]});
+    }
+    return m;
+}
+
+/// Creates a UV sphere with outward facing triangles.
+Mesh createSphereMesh(float3 center, float radius, uint32_t segments)
+{
+    Mesh m;
+    uint32_t rings = segments / 2;
+    for (uint32_t r = 0; r <= rings; r++)
+    {
+        float theta = float(M_PI) * r / rings;
+        for (uint32_t s = 0; s < segments; s++)
+        {
+            float phi = 2.f * float(M_PI) * s / segments;
+            m.positions.push_back(center + radius * float3(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta)));
+        }
+    }
+    for (uint32_t r = 0; r < rings; r++)
+    {
+        for (uint32_t s = 0; s < segments; s++)
+        {
+            uint32_t i0 = r * segments + s;
+            uint32_t i1 = r * segments + (s + 1) % segments;
+            uint32_t i2 = i0 + segments;
+            uint32_t i3 = i1 + segments;
+            m.indices.insert(m.indices.end(), {i0, i2, i1, i1, i2, i3});
+        }
+    }
+    return m;
+}
+
+float boxSDF(float3 p, float3 halfExtent)
+{
+    float3 d = abs(p) - halfExtent;
+    return length(max(d, float3(0.f))) + std::min(std::max(std::max(d.x, d.y), d.z), 0.f);
+}
+} // namespace
+
+CPU_TEST(SDFMeshBakerQueries)
+{
+    const float3 halfExtent(0.3f, 0.2f, 0.25f);
+    Mesh m = createBoxMesh(halfExtent);
+    SDFMeshBaker baker(m.positions, m.indices);
+    EXPECT_EQ(baker.getTriangleCount(), 12u);
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        float3 p(dist(rng), dist(rng), dist(rng));
+        float sd = boxSDF(p, halfExtent);
+        if (std::abs(sd) < 1e-3f)
+            continue;
+
+        EXPECT_LE(std::abs(baker.distance(p) - std::abs(sd)), 1e-5f);
+        EXPECT_LE(std::abs(baker.signedDistance(p, SDFMeshBaker::SignMode::WindingNumber) - sd), 1e-5f);
+        EXPECT_LE(std::abs(baker.signedDistance(p, SDFMeshBaker::SignMode::RayParity) - sd), 1e-5f);
+        EXPECT_LE(std::abs(baker.windingNumber(p, 0.f) - (sd < 0.f ? 1.f : 0.f)), 1e-3f);
+        EXPECT_LE(std::abs(baker.windingNumber(p) - (sd < 0.f ? 1.f : 0.f)), 0.1f);
+    }
+
+    // Bounded queries ignore triangles further away than the maximum distance.
+    EXPECT_EQ(baker.distance(float3(0.f), 0.1f), std::numeric_limits<float>::infinity());
+    EXPECT_LE(std::abs(baker.distance(float3(0.f), 0.2f) - 0.2f), 1e-6f);
+
+    // The winding number classifies points inside a box with a missing face as inside.
+    Mesh open = createBoxMesh(halfExtent, true);
+    SDFMeshBaker openBaker(open.positions, open.indices);
+    EXPECT(openBaker.isInside(float3(0.f), SDFMeshBaker::SignMode::WindingNumber));
+    EXPECT(!openBaker.isInside(float3(0.f, 0.f, 0.45f), SDFMeshBaker::SignMode::WindingNumber));
+
+    std::vector<uint32_t> invalidIndices = {0, 1, 8};
+    EXPECT_THROW(SDFMeshBaker(m.positions, invalidIndices));
+}
+
+CPU_TEST(SDFMeshBakerValues)
+{
+    const float3 halfExtent(0.3f, 0.2f, 0.25f);
+    Mesh m = createBoxMesh(halfExtent);
+    SDFMeshBaker baker(m.positions, m.indices);
+
+    const uint32_t gridWidth = 20;
+    const uint32_t gridWidthInValues = gridWidth + 1;
+    SDFMeshBaker::Options options;
+    std::vector<float> values = baker.bakeValues(gridWidth, options);
+    ASSERT_EQ(values.size(), size_t(gridWidthInValues * gridWidthInValues * gridWidthInValues));
+
+    for (uint32_t z = 0; z < gridWidthInValues; z++)
+    {
+        for (uint32_t y = 0; y < gridWidthInValues; y++)
+        {
+            for (uint32_t x = 0; x < gridWidthInValues; x++)
+            {
+                float3 p = float3(x, y, z) / float(gridWidth) - 0.5f;
+                float value = values[x + gridWidthInValues * (y + gridWidthInValues * z)];
+                EXPECT_LE(std::abs(value - boxSDF(p, halfExtent)), 1e-5f) << fmt::format("x={} y={} z={}", x, y, z);
+            }
+        }
+    }
+}
+
+CPU_TEST(SDFMeshBakerBricks)
+{
+    Mesh m = createSphereMesh(float3(0.03f, -0.02f, 0.01f), 0.35f, 48);
+    SDFMeshBaker baker(m.positions, m.indices);
+
+    // The grid width is not a multiple of the brick width, so the last bricks are partially outside the grid.
+    const uint32_t gridWidth = 40;
+    const uint32_t gridWidthInValues = gridWidth + 1;
+    SDFMeshBaker::Options options;
+    options.brickWidth = 7;
+
+    SDFMeshBaker::Bricks bricks = baker.bakeBricks(gridWidth, options);
+    EXPECT_EQ(bricks.virtualBricksPerAxis, 6u);
+    EXPECT_GT(bricks.getBrickCount(), 0u);
+    EXPECT_LT(bricks.getBrickCount(), 6u * 6u * 6u);
+
+    options.parallel = false;
+    SDFMeshBaker::Bricks serialBricks = baker.bakeBricks(gridWidth, options);
+    EXPECT(serialBricks.indirection == bricks.indirection);
+    EXPECT(serialBricks.fillValues == bricks.fillValues);
+    EXPECT(serialBricks.values == bricks.values);
+
+    // Compare against the quantized dense values.
+    std::vector<float> values = baker.bakeValues(gridWidth, options);
+    std::vector<int8_t> sdField = bricks.expand();
+    ASSERT_EQ(sdField.size(), values.size());
+
+    auto getValue = [&](uint3 c) { return SDFMeshBaker::quantize(values[c.x + gridWidthInValues * (c.y + gridWidthInValues * c.z)], gridWidth); };
+
+    const uint32_t n = bricks.virtualBricksPerAxis;
+    for (uint32_t virtualBrickID = 0; virtualBrickID < n * n * n; virtualBrickID++)
+    {
+        uint3 brickCoords(virtualBrickID % n, (virtualBrickID / n) % n, virtualBrickID / (n * n));
+        uint3 minVoxel = brickCoords * bricks.brickWidth;
+        uint3 maxVoxel = min(minVoxel + bricks.brickWidth, uint3(gridWidth));
+
+        // A brick must exist if and only if one of its voxels has corners of both signs.
+        bool hasSurface = false;
+        for (uint32_t z = minVoxel.z; z < maxVoxel.z; z++)
+        {
+            for (uint32_t y = minVoxel.y; y < maxVoxel.y; y++)
+            {
+                for (uint32_t x = minVoxel.x; x < maxVoxel.x; x++)
+                {
+                    bool anyInside = false, anyOutside = false;
+                    for (uint32_t i = 0; i < 8; i++)
+                    {
+                        int8_t v = getValue(uint3(x + (i & 1), y + ((i >> 1) & 1), z + (i >> 2)));
+                        anyInside |= v <= 0;
+                        anyOutside |= v >= 0;
+                    }
+                    hasSurface |= anyInside && anyOutside;
+                }
+            }
+        }
+
+        uint32_t brickID = bricks.indirection[virtualBrickID];
+        EXPECT_EQ(brickID != SDFMeshBaker::Bricks::kInvalidBrick, hasSurface) << fmt::format("brick={}", virtualBrickID);
+        if (brickID == SDFMeshBaker::Bricks::kInvalidBrick)
+            continue;
+
+        // Values of bricks match the dense values.
+        for (uint32_t z = minVoxel.z; z <= maxVoxel.z; z++)
+        {
+            for (uint32_t y = minVoxel.y; y <= maxVoxel.y; y++)
+            {
+                for (uint32_t x = minVoxel.x; x <= maxVoxel.x; x++)
+                {
+                    uint3 c(x, y, z);
+                    EXPECT_EQ(sdField[x + gridWidthInValues * (y + gridWidthInValues * z)], getValue(c))
+                        << fmt::format("x={} y={} z={}", x, y, z);
+                }
+            }
+        }
+    }
+
+    // Corners outside of bricks have the correct sign.
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        if (std::abs(values[i]) > 0.5f / gridWidth)
+            EXPECT_EQ(sdField[i] < 0, values[i] < 0.f) << fmt::format("i={}", i);
+    }
+}
+} // namespace Falcor
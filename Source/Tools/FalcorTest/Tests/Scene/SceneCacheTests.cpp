@@ -0,0 +1,102 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneCache.h"
+#include <cstring>
+#include <random>
+
+namespace Falcor
+{
+GPU_TEST(SceneCacheRoundTrip)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+
+    Scene::SceneData sceneData;
+    sceneData.pMaterials = std::make_unique<MaterialSystem>(pDevice);
+
+    // Mesh data with multiple split buffers to exercise the raw chunks.
+    const uint32_t kVertexCount = 10000;
+    sceneData.meshIndexData.setBufferCount(3);
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        std::vector<uint32_t> indices(kVertexCount * (i + 1));
+        for (uint32_t j = 0; j < indices.size(); ++j)
+            indices[j] = (j * 7 + i) % kVertexCount;
+        sceneData.meshIndexData.insert(indices.begin(), indices.end());
+    }
+    std::vector<PackedStaticVertexData> vertices(kVertexCount);
+    for (auto& v : vertices)
+    {
+        v.position = float3(dist(rng), dist(rng), dist(rng));
+        v.packedNormalTangentCurveRadius = float3(dist(rng), dist(rng), dist(rng));
+        v.texCrd = float2(dist(rng), dist(rng));
+    }
+    sceneData.meshStaticData.insert(vertices.begin(), vertices.end());
+    sceneData.meshSkinningData.resize(100);
+    for (uint32_t i = 0; i < sceneData.meshSkinningData.size(); ++i)
+        sceneData.meshSkinningData[i].staticIndex = i;
+    sceneData.meshNames = {"mesh0", "mesh1"};
+    sceneData.meshDrawCount = 42;
+    sceneData.curveIndexData = {1, 2, 3};
+
+    // Use a temporary cache file instead of the user's scene cache.
+    auto directory = std::filesystem::temp_directory_path() / fmt::format("FalcorSceneCacheTest-{:08x}", std::random_device()());
+    auto cachePath = directory / "SceneCacheRoundTrip";
+    SceneCache::writeCache(sceneData, cachePath);
+    Scene::SceneData result;
+    bool valid = SceneCache::hasValidCache(cachePath);
+    if (valid)
+        result = SceneCache::readCache(pDevice, cachePath);
+    std::filesystem::remove_all(directory);
+    ASSERT(valid);
+
+    ASSERT_EQ(result.meshIndexData.getBufferCount(), sceneData.meshIndexData.getBufferCount());
+    for (uint32_t i = 0; i < sceneData.meshIndexData.getBufferCount(); ++i)
+        EXPECT(result.meshIndexData.getCpuBuffer(i) == sceneData.meshIndexData.getCpuBuffer(i)) << "buffer " << i;
+
+    ASSERT_EQ(result.meshStaticData.getBufferCount(), sceneData.meshStaticData.getBufferCount());
+    for (uint32_t i = 0; i < sceneData.meshStaticData.getBufferCount(); ++i)
+    {
+        const auto& expected = sceneData.meshStaticData.getCpuBuffer(i);
+        const auto& actual = result.meshStaticData.getCpuBuffer(i);
+        ASSERT_EQ(actual.size(), expected.size());
+        EXPECT(std::memcmp(actual.data(), expected.data(), expected.size() * sizeof(expected[0])) == 0) << "buffer " << i;
+    }
+
+    ASSERT_EQ(result.meshSkinningData.size(), sceneData.meshSkinningData.size());
+    for (size_t i = 0; i < sceneData.meshSkinningData.size(); ++i)
+        EXPECT_EQ(result.meshSkinningData[i].staticIndex, sceneData.meshSkinningData[i].staticIndex);
+
+    EXPECT(result.meshNames == sceneData.meshNames);
+    EXPECT_EQ(result.meshDrawCount, sceneData.meshDrawCount);
+    EXPECT(result.curveIndexData == sceneData.curveIndexData);
+}
+} // namespace Falcor
@@ -0,0 +1,162 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/TangentGenerator.h"
+#include "TestMeshes.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+/**
+ * Creates a height field grid mesh with per-vertex attributes, optionally with the faces in random order.
+ * To exercise the special cases in MikkTSpace, some faces have zero texture area, some faces are degenerate,
+ * and some corners reference a duplicate vertex whose position differs only by the sign of zero.
+ */
+TestMesh createTangentGridMesh(uint32_t size, uint32_t seed, float zeroTexAreaProbability, float degenerateProbability, bool shuffleFaces)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+
+    TestMesh m =
+        createGridMesh(size, [](uint32_t x, uint32_t y) { return (x + y) % 5 == 0 ? 0.f : std::sin(x * 0.3f) * std::cos(y * 0.2f); });
+    const uint32_t gridVertexCount = (uint32_t)m.positions.size();
+    for (const float3& p : m.positions)
+    {
+        m.normals.push_back(normalize(float3(u(rng) - 0.5f, u(rng) - 0.5f, 1.f)));
+        m.texCrds.push_back(p.xy() * 0.1f);
+    }
+    // Duplicate vertices with negative zero height.
+    for (uint32_t i = 0; i < gridVertexCount; i++)
+    {
+        float3 p = m.positions[i];
+        m.positions.push_back(float3(p.x, p.y, p.z == 0.f ? -0.f : p.z));
+        m.normals.push_back(m.normals[i]);
+        m.texCrds.push_back(m.texCrds[i]);
+    }
+
+    auto getIndex = [&](uint32_t index) { return u(rng) < 0.5f ? index : index + gridVertexCount; };
+
+    // Each quad of the grid is stored as the triangles (a, b, c) and (b, d, c).
+    const std::vector<uint32_t> gridIndices = std::move(m.indices);
+    std::vector<uint32_t> indices;
+    for (size_t quad = 0; quad < gridIndices.size() / 6; quad++)
+    {
+        const uint32_t* q = &gridIndices[quad * 6];
+        uint32_t a = getIndex(q[0]), b = getIndex(q[1]), c = getIndex(q[2]), d = getIndex(q[4]);
+        if (u(rng) < zeroTexAreaProbability)
+        {
+            for (uint32_t i : {a, b, c}) m.texCrds[i % gridVertexCount] = m.texCrds[i % gridVertexCount + gridVertexCount] = float2(0.5f);
+        }
+        if (u(rng) < degenerateProbability) indices.insert(indices.end(), {a, a, b});
+        indices.insert(indices.end(), {a, b, c});
+        indices.insert(indices.end(), {b, d, c});
+    }
+
+    const uint32_t faceCount = (uint32_t)indices.size() / 3;
+    std::vector<uint32_t> faces(faceCount);
+    for (uint32_t i = 0; i < faceCount; i++) faces[i] = i;
+    if (shuffleFaces) std::shuffle(faces.begin(), faces.end(), rng);
+    m.indices.clear();
+    for (uint32_t face : faces)
+        for (uint32_t vert = 0; vert < 3; vert++) m.indices.push_back(indices[face * 3 + vert]);
+
+    m.updateMesh();
+    return m;
+}
+
+/// Returns the number of tangents that differ. NaNs compare equal to each other.
+size_t countMismatches(const std::vector<float4>& a, const std::vector<float4>& b)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < std::min(a.size(), b.size()); i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            if (!(a[i][j] == b[i][j] || (std::isnan(a[i][j]) && std::isnan(b[i][j]))))
+            {
+                count++;
+                break;
+            }
+        }
+    }
+    return count;
+}
+} // namespace
+
+CPU_TEST(TangentGeneratorChunked)
+{
+    for (float zeroTexAreaProbability : {0.f, 0.05f, 1.f})
+    {
+        for (uint32_t size : {2u, 9u, 60u})
+        {
+            TestMesh m = createTangentGridMesh(size, size, zeroTexAreaProbability, 0.02f, true);
+
+            auto ref = TangentGenerator::generate(m.mesh);
+            ASSERT_EQ(ref.size(), m.mesh.indexCount);
+
+            for (uint32_t chunkFaceCount : {1u, 16u, 1000u})
+            {
+                for (bool parallel : {false, true})
+                {
+                    auto result = TangentGenerator::generateChunked(m.mesh, parallel, chunkFaceCount);
+                    EXPECT_EQ(result.size(), ref.size());
+                    EXPECT_EQ(countMismatches(result, ref), size_t(0)) << "size=" << size << " zeroTexArea=" << zeroTexAreaProbability
+                                                               << " chunkFaceCount=" << chunkFaceCount << " parallel=" << parallel;
+                }
+            }
+        }
+    }
+}
+
+CPU_TEST(TangentGeneratorMissingAttributes)
+{
+    TestMesh m = createTangentGridMesh(4, 1, 0.f, 0.f, false);
+    m.mesh.texCrds = {};
+
+    EXPECT(TangentGenerator::generate(m.mesh).empty());
+    EXPECT(TangentGenerator::generateChunked(m.mesh).empty());
+}
+
+CPU_BENCHMARK(TangentGeneratorBenchmark)
+{
+    TestMesh m = createTangentGridMesh(1000, 1, 0.001f, 0.f, false);
+    const BenchmarkCounters counters = {{"faces", double(m.mesh.faceCount)}};
+
+    std::vector<float4> ref, serial, parallel;
+    ctx.measure("single pass", [&]() { ref = TangentGenerator::generate(m.mesh); }, counters);
+    ctx.measure("chunked", [&]() { serial = TangentGenerator::generateChunked(m.mesh, false); }, counters);
+    ctx.measure("chunked parallel", [&]() { parallel = TangentGenerator::generateChunked(m.mesh, true); }, counters);
+
+    EXPECT_EQ(countMismatches(serial, ref), size_t(0));
+    EXPECT_EQ(countMismatches(parallel, ref), size_t(0));
+}
+} // namespace Falcor
@@ -0,0 +1,97 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Scene/SceneBuilder.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Mesh data for the scene unit tests, together with a SceneBuilder::Mesh that references it.
+ */
+struct TestMesh
+{
+    std::vector<uint32_t> indices;
+    std::vector<float3> positions;
+    std::vector<float3> normals;
+    std::vector<float2> texCrds;
+    SceneBuilder::Mesh mesh;
+
+    /**
+     * Sets up the SceneBuilder::Mesh to reference the triangle list in this object.
+     * Must be called again after any of the vectors is reallocated.
+     * @param[in] attributeFrequency Frequency of the normals and texture coordinates.
+     */
+    void updateMesh(SceneBuilder::Mesh::AttributeFrequency attributeFrequency = SceneBuilder::Mesh::AttributeFrequency::Vertex)
+    {
+        mesh.name = "grid";
+        mesh.topology = Vao::Topology::TriangleList;
+        mesh.vertexCount = (uint32_t)positions.size();
+        mesh.indexCount = (uint32_t)indices.size();
+        mesh.faceCount = mesh.indexCount / 3;
+        mesh.pIndices = indices.data();
+        mesh.positions = {positions.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex};
+        mesh.normals = {normals.data(), attributeFrequency};
+        mesh.texCrds = {texCrds.data(), attributeFrequency};
+    }
+};
+
+/**
+ * Creates a grid mesh of size x size quads in the xy-plane, without normals and texture coordinates.
+ * The vertices are stored in row-major order. Each quad (x, y) is split into two triangles stored at indices [6 * (y * size + x), +6).
+ * With corners a = (x, y), b = (x + 1, y), c = (x, y + 1) and d = (x + 1, y + 1), the triangles are (a, b, c) and (b, d, c).
+ * @param[in] size Number of quads along each axis.
+ * @param[in] getHeight Function (x, y) -> float returning the z coordinate of each vertex. It is called in vertex order.
+ * @param[in] alternateDiagonals If true, quads with even x + y are split along the other diagonal into (a, b, d) and (a, d, c),
+ * so that interior vertices have valence 4, 6 and 8.
+ * @return The grid mesh. The SceneBuilder::Mesh is not set up.
+ */
+template<typename GetHeight>
+TestMesh createGridMesh(uint32_t size, GetHeight getHeight, bool alternateDiagonals = false)
+{
+    TestMesh m;
+    for (uint32_t y = 0; y <= size; y++)
+        for (uint32_t x = 0; x <= size; x++)
+            m.positions.push_back(float3(float(x), float(y), getHeight(x, y)));
+
+    auto index = [&](uint32_t x, uint32_t y) { return y * (size + 1) + x; };
+    for (uint32_t y = 0; y < size; y++)
+    {
+        for (uint32_t x = 0; x < size; x++)
+        {
+            uint32_t a = index(x, y), b = index(x + 1, y), c = index(x, y + 1), d = index(x + 1, y + 1);
+            if (alternateDiagonals && (x + y) % 2 == 0)
+                m.indices.insert(m.indices.end(), {a, b, d, a, d, c});
+            else
+                m.indices.insert(m.indices.end(), {a, b, c, b, d, c});
+        }
+    }
+    return m;
+}
+} // namespace Falcor
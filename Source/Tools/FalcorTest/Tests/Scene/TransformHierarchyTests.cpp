@@ -0,0 +1,282 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Animation/TransformHierarchy.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kInvalid = TransformHierarchy::kInvalidNode;
+
+struct TestGraph
+{
+    std::vector<uint32_t> parents;
+    std::vector<float4x4> local;
+    std::vector<float4x4> localToBind;
+    std::vector<float4x4> global;
+    std::vector<float4x4> invTransposeGlobal;
+    std::vector<float4x4> skinning;
+    std::vector<float4x4> invTransposeSkinning;
+    std::vector<uint8_t> changed;
+
+    TransformHierarchy::Matrices getMatrices(bool withSkinning)
+    {
+        TransformHierarchy::Matrices m;
+        m.pLocal = local.data();
+        m.pGlobal = global.data();
+        m.pInvTransposeGlobal = invTransposeGlobal.data();
+        if (withSkinning)
+        {
+            m.pLocalToBind = localToBind.data();
+            m.pSkinning = skinning.data();
+            m.pInvTransposeSkinning = invTransposeSkinning.data();
+        }
+        return m;
+    }
+};
+
+float4x4 randomTransform(std::mt19937& rng, float projectiveProbability)
+{
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+    float4x4 m = math::matrixFromTranslation(float3(u(rng), u(rng), u(rng)) * 20.f - 10.f);
+    m = math::rotate(m, u(rng) * 6.28f, normalize(float3(u(rng), u(rng), u(rng)) + 0.1f));
+    m = math::scale(m, float3(0.5f + u(rng), 0.5f + u(rng), 0.5f + u(rng)));
+    if (u(rng) < projectiveProbability)
+    {
+        m[3][0] = u(rng) * 0.1f;
+        m[3][3] = 1.f + u(rng);
+    }
+    return m;
+}
+
+/**
+ * Creates a forest of nodes where each node is a root or has a parent with a lower index.
+ * Node i attaches to one of the previous `fanout` nodes, unless that node is at the maximum depth.
+ */
+void createGraph(TestGraph& g, uint32_t nodeCount, uint32_t fanout, uint32_t maxDepth, uint32_t seed, float projectiveProbability)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+
+    std::vector<uint32_t> depths(nodeCount, 0);
+    g.parents.resize(nodeCount);
+    g.local.resize(nodeCount);
+    g.localToBind.resize(nodeCount);
+    for (uint32_t i = 0; i < nodeCount; i++)
+    {
+        g.parents[i] = kInvalid;
+        if (i > 0)
+        {
+            uint32_t parent = i - 1 - std::min(i - 1, (uint32_t)(u(rng) * fanout));
+            if (depths[parent] + 1 < maxDepth)
+            {
+                g.parents[i] = parent;
+                depths[i] = depths[parent] + 1;
+            }
+        }
+        g.local[i] = randomTransform(rng, projectiveProbability);
+        g.localToBind[i] = randomTransform(rng, projectiveProbability);
+    }
+    g.global.resize(nodeCount);
+    g.invTransposeGlobal.resize(nodeCount);
+    g.skinning.resize(nodeCount);
+    g.invTransposeSkinning.resize(nodeCount);
+    g.changed.assign(nodeCount, 1);
+}
+
+/// Reference implementation, this is the serial update previously done by AnimationController. Requires parents to have lower indices.
+void updateReference(TestGraph& g, bool updateAll, bool withSkinning)
+{
+    for (size_t i = 0; i < g.local.size(); i++)
+    {
+        if (g.parents[i] != kInvalid) g.changed[i] = g.changed[i] || g.changed[g.parents[i]];
+        if (!g.changed[i] && !updateAll) continue;
+
+        g.global[i] = g.local[i];
+        if (g.parents[i] != kInvalid) g.global[i] = mul(g.global[g.parents[i]], g.global[i]);
+        g.invTransposeGlobal[i] = transpose(inverse(g.global[i]));
+
+        if (withSkinning)
+        {
+            g.skinning[i] = mul(g.global[i], g.localToBind[i]);
+            g.invTransposeSkinning[i] = transpose(inverse(g.skinning[i]));
+        }
+    }
+}
+
+/// Counts the matrices whose elements differ by more than a tolerance relative to the largest element of the reference matrix.
+size_t countMismatches(const std::vector<float4x4>& result, const std::vector<float4x4>& ref)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < ref.size(); i++)
+    {
+        float maxElem = 0.f;
+        for (int r = 0; r < 4; r++)
+            for (int c = 0; c < 4; c++)
+                maxElem = std::max(maxElem, std::abs(ref[i][r][c]));
+        bool match = true;
+        for (int r = 0; r < 4; r++)
+            for (int c = 0; c < 4; c++)
+                match = match && std::abs(result[i][r][c] - ref[i][r][c]) <= 1e-4f * maxElem;
+        if (!match) count++;
+    }
+    return count;
+}
+
+std::vector<TransformHierarchy::Range> getChangedRanges(const std::vector<uint8_t>& changed)
+{
+    std::vector<TransformHierarchy::Range> ranges;
+    for (uint32_t i = 0; i < changed.size(); i++)
+    {
+        if (!changed[i]) continue;
+        if (!ranges.empty() && ranges.back().offset + ranges.back().count == i)
+            ranges.back().count++;
+        else
+            ranges.push_back({i, 1});
+    }
+    return ranges;
+}
+
+void testUpdate(CPUUnitTestContext& ctx, uint32_t nodeCount, uint32_t fanout, uint32_t maxDepth, float projectiveProbability, bool withSkinning, bool parallel)
+{
+    TestGraph ref;
+    createGraph(ref, nodeCount, fanout, maxDepth, 1, projectiveProbability);
+    TestGraph g = ref;
+    TransformHierarchy hierarchy(g.parents);
+    EXPECT_EQ(hierarchy.getNodeCount(), nodeCount);
+
+    // Full update.
+    updateReference(ref, true, withSkinning);
+    hierarchy.update(g.getMatrices(withSkinning), g.changed.data(), true, parallel);
+    EXPECT_EQ(countMismatches(g.global, ref.global), size_t(0));
+    EXPECT_EQ(countMismatches(g.invTransposeGlobal, ref.invTransposeGlobal), size_t(0));
+    EXPECT_EQ(countMismatches(g.skinning, ref.skinning), size_t(0));
+    EXPECT_EQ(countMismatches(g.invTransposeSkinning, ref.invTransposeSkinning), size_t(0));
+
+    // Incremental update of a few animated nodes.
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+    std::fill(ref.changed.begin(), ref.changed.end(), uint8_t(0));
+    for (uint32_t i = 0; i < nodeCount; i++)
+    {
+        if (u(rng) < 0.01f)
+        {
+            ref.local[i] = randomTransform(rng, projectiveProbability);
+            ref.changed[i] = 1;
+        }
+    }
+    g.local = ref.local;
+    g.changed = ref.changed;
+
+    updateReference(ref, false, withSkinning);
+    hierarchy.update(g.getMatrices(withSkinning), g.changed.data(), false, parallel);
+    EXPECT(g.changed == ref.changed);
+    EXPECT_EQ(countMismatches(g.global, ref.global), size_t(0));
+    EXPECT_EQ(countMismatches(g.invTransposeGlobal, ref.invTransposeGlobal), size_t(0));
+    EXPECT_EQ(countMismatches(g.skinning, ref.skinning), size_t(0));
+    EXPECT_EQ(countMismatches(g.invTransposeSkinning, ref.invTransposeSkinning), size_t(0));
+
+    auto refRanges = getChangedRanges(ref.changed);
+    const auto& ranges = hierarchy.getChangedRanges();
+    EXPECT_EQ(ranges.size(), refRanges.size());
+    for (size_t i = 0; i < std::min(ranges.size(), refRanges.size()); i++)
+    {
+        EXPECT_EQ(ranges[i].offset, refRanges[i].offset);
+        EXPECT_EQ(ranges[i].count, refRanges[i].count);
+    }
+}
+} // namespace
+
+CPU_TEST(TransformHierarchyUpdate)
+{
+    for (bool parallel : {false, true})
+    {
+        // Wide and shallow, and narrow and deep hierarchies.
+        testUpdate(ctx, 20000, 5000, 4, 0.f, false, parallel);
+        testUpdate(ctx, 20000, 3, 20, 0.f, true, parallel);
+        // Non-affine transforms use the general path.
+        testUpdate(ctx, 20000, 5000, 4, 0.05f, true, parallel);
+    }
+}
+
+CPU_TEST(TransformHierarchyNodeOrder)
+{
+    // Store the nodes in random order, so that parents are not necessarily before their children.
+    TestGraph ref;
+    createGraph(ref, 5000, 10, 8, 3, 0.f);
+    updateReference(ref, true, false);
+
+    std::vector<uint32_t> perm(ref.parents.size());
+    for (uint32_t i = 0; i < perm.size(); i++) perm[i] = i;
+    std::shuffle(perm.begin(), perm.end(), std::mt19937(4));
+
+    TestGraph g = ref;
+    for (uint32_t i = 0; i < perm.size(); i++)
+    {
+        g.parents[perm[i]] = ref.parents[i] == kInvalid ? kInvalid : perm[ref.parents[i]];
+        g.local[perm[i]] = ref.local[i];
+    }
+
+    TransformHierarchy hierarchy(g.parents);
+    hierarchy.update(g.getMatrices(false), g.changed.data(), true);
+
+    std::vector<float4x4> global(perm.size());
+    for (uint32_t i = 0; i < perm.size(); i++) global[i] = g.global[perm[i]];
+    EXPECT_EQ(countMismatches(global, ref.global), size_t(0));
+}
+
+CPU_TEST(TransformHierarchyLevels)
+{
+    EXPECT_THROW(TransformHierarchy({1, 0}));
+    EXPECT_THROW(TransformHierarchy({kInvalid, 2}));
+    // Children stored after their parent share its level, others are placed in the next level.
+    EXPECT_EQ(TransformHierarchy({kInvalid, 0, 1, 0}).getLevelCount(), 1u);
+    EXPECT_EQ(TransformHierarchy({3, kInvalid, 1, 2}).getLevelCount(), 2u);
+}
+
+CPU_BENCHMARK(TransformHierarchyBenchmark)
+{
+    // Crowd-like scene: many small hierarchies with a handful of levels.
+    TestGraph ref;
+    createGraph(ref, 200000, 16, 6, 1, 0.f);
+    TestGraph g = ref;
+    TransformHierarchy hierarchy(g.parents);
+    const BenchmarkCounters counters = {{"nodes", double(hierarchy.getNodeCount())}};
+
+    ctx.measure("reference", [&]() { updateReference(ref, true, true); }, counters);
+    ctx.measure("serial", [&]() { hierarchy.update(g.getMatrices(true), g.changed.data(), true, false); }, counters);
+    ctx.measure("parallel", [&]() { hierarchy.update(g.getMatrices(true), g.changed.data(), true, true); }, counters);
+
+    EXPECT_EQ(countMismatches(g.global, ref.global), size_t(0));
+    EXPECT_EQ(countMismatches(g.invTransposeSkinning, ref.invTransposeSkinning), size_t(0));
+}
+} // namespace Falcor
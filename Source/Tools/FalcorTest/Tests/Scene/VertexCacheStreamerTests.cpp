@@ -0,0 +1,162 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Animation/VertexCacheStreamer.h"
+#include "Utils/Math/PackedFormats.h"
+#include <cstring>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+std::vector<PackedStaticVertexData> createMeshKeyframe(std::mt19937& rng, uint32_t vertexCount)
+{
+    std::uniform_real_distribution<float> u(-1.f, 1.f);
+    std::vector<PackedStaticVertexData> vertices(vertexCount);
+    for (auto& v : vertices)
+    {
+        StaticVertexData data;
+        data.position = float3(u(rng), u(rng), u(rng)) * 10.f;
+        data.normal = normalize(float3(u(rng), u(rng), u(rng)) + float3(0.f, 0.f, 0.01f));
+        data.tangent = float4(normalize(float3(u(rng), u(rng), u(rng)) + float3(0.01f, 0.f, 0.f)), u(rng) < 0.f ? -1.f : 1.f);
+        data.texCrd = float2(u(rng), u(rng));
+        data.curveRadius = 0.f;
+        v.pack(data);
+    }
+    return vertices;
+}
+
+struct SlotStorage
+{
+    uint32_t slotCount;
+    std::vector<std::vector<std::vector<uint8_t>>> clips;
+
+    void upload(uint32_t clipID, uint32_t slot, const void* pData, size_t byteSize)
+    {
+        if (clipID >= clips.size()) clips.resize(clipID + 1, std::vector<std::vector<uint8_t>>(slotCount));
+        auto& dst = clips[clipID][slot];
+        dst.resize(byteSize);
+        std::memcpy(dst.data(), pData, byteSize);
+    }
+};
+}
+
+CPU_TEST(VertexCacheStreamerCompression)
+{
+    std::mt19937 rng(7);
+    const uint32_t vertexCount = 1000;
+    auto mesh = createMeshKeyframe(rng, vertexCount);
+    std::vector<DynamicCurveVertexData> curve(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; i++) curve[i].position = mesh[i].position * 0.5f + 100.f;
+
+    VertexCacheStreamer streamer(2, 0, [](uint32_t, uint32_t, const void*, size_t) {});
+    uint32_t meshClip = streamer.addMeshClip(vertexCount);
+    uint32_t curveClip = streamer.addCurveClip(vertexCount);
+    streamer.addKeyframe(meshClip, mesh);
+    streamer.addKeyframe(curveClip, curve);
+
+    // Compressed keyframes take half the memory of the mesh vertex data.
+    EXPECT_LE(streamer.getCompressedByteSize(), (sizeof(PackedStaticVertexData) / 2 + sizeof(DynamicCurveVertexData) / 2) * vertexCount + 1024);
+
+    std::vector<uint8_t> data;
+    streamer.decodeKeyframe(meshClip, 0, data);
+    EXPECT_EQ(data.size(), vertexCount * sizeof(PackedStaticVertexData));
+    const PackedStaticVertexData* pMesh = reinterpret_cast<const PackedStaticVertexData*>(data.data());
+
+    // Positions span 20 units, so the quantization error is at most 20 / 65535 / 2 per component.
+    const float positionTolerance = 20.f / 65535.f;
+    for (uint32_t i = 0; i < vertexCount; i++)
+    {
+        StaticVertexData ref = mesh[i].unpack();
+        StaticVertexData result = pMesh[i].unpack();
+        EXPECT_LE(length(result.position - ref.position), positionTolerance) << "vertex " << i;
+        EXPECT_GE(dot(result.normal, ref.normal), 0.9999f) << "vertex " << i;
+        EXPECT_EQ(result.tangent.x, ref.tangent.x) << "vertex " << i;
+        EXPECT_EQ(result.tangent.y, ref.tangent.y) << "vertex " << i;
+        EXPECT_EQ(result.tangent.z, ref.tangent.z) << "vertex " << i;
+        EXPECT_EQ(result.tangent.w, ref.tangent.w) << "vertex " << i;
+    }
+
+    streamer.decodeKeyframe(curveClip, 0, data);
+    EXPECT_EQ(data.size(), vertexCount * sizeof(DynamicCurveVertexData));
+    const DynamicCurveVertexData* pCurve = reinterpret_cast<const DynamicCurveVertexData*>(data.data());
+    for (uint32_t i = 0; i < vertexCount; i++)
+    {
+        EXPECT_LE(length(pCurve[i].position - curve[i].position), positionTolerance) << "vertex " << i;
+    }
+}
+
+CPU_TEST(VertexCacheStreamerPlayback)
+{
+    std::mt19937 rng(11);
+    const uint32_t vertexCount = 256;
+    const uint32_t keyframeCount = 40;
+    const uint32_t slotCount = 4;
+
+    SlotStorage storage{slotCount};
+    VertexCacheStreamer streamer(slotCount, 2, [&](uint32_t clipID, uint32_t slot, const void* pData, size_t byteSize)
+        { storage.upload(clipID, slot, pData, byteSize); });
+
+    for (uint32_t c = 0; c < 3; c++)
+    {
+        uint32_t clipID = streamer.addMeshClip(vertexCount);
+        for (uint32_t k = 0; k < keyframeCount; k++) streamer.addKeyframe(clipID, createMeshKeyframe(rng, vertexCount));
+    }
+
+    std::vector<uint8_t> expected;
+    auto check = [&](uint32_t clipID, uint2 keyframes)
+    {
+        uint2 slots = streamer.request(clipID, keyframes);
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            EXPECT_LT(slots[i], slotCount);
+            EXPECT_EQ(streamer.getSlotKeyframe(clipID, slots[i]), keyframes[i]);
+            streamer.decodeKeyframe(clipID, keyframes[i], expected);
+            EXPECT(storage.clips[clipID][slots[i]] == expected) << "clip " << clipID << " keyframe " << keyframes[i];
+        }
+    };
+
+    // Sequential looped playback of all clips, followed by random seeks.
+    for (uint32_t frame = 0; frame < 3 * keyframeCount; frame++)
+    {
+        uint32_t k = frame % keyframeCount;
+        for (uint32_t c = 0; c < 3; c++) check(c, uint2(k, (k + 1) % keyframeCount));
+    }
+    for (uint32_t i = 0; i < 50; i++)
+    {
+        uint32_t k = rng() % keyframeCount;
+        check(rng() % 3, uint2(k, rng() % keyframeCount));
+    }
+
+    // Every keyframe of a sequential playback is uploaded at most once per loop.
+    const auto& stats = streamer.getStats();
+    EXPECT_GE(stats.uploadCount, uint64_t(3 * keyframeCount));
+    EXPECT_LE(stats.uploadCount, uint64_t(3 * 3 * keyframeCount + 100 + 3 * 4));
+}
+} // namespace Falcor
@@ -0,0 +1,104 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/VertexDeduplication.h"
+#include "TestMeshes.h"
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+/**
+ * Creates a grid mesh with face-varying normals and texture coordinates.
+ * Neighboring faces randomly share or split their attributes, and some attributes
+ * differ by less than the merge threshold, to exercise all paths of the vertex comparison.
+ */
+TestMesh createFaceVaryingGridMesh(uint32_t size, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint32_t> variant(0, 3);
+
+    TestMesh m = createGridMesh(size, [](uint32_t x, uint32_t y) { return (x + y) % 7 == 0 ? -0.f : 0.f; });
+    for (uint32_t index : m.indices)
+    {
+        switch (variant(rng))
+        {
+        case 0:
+            m.normals.push_back(float3(0.f, 0.f, 1.f));
+            break;
+        case 1:
+            m.normals.push_back(float3(0.f, 0.f, 1.f - 1e-7f)); // Within merge threshold.
+            break;
+        case 2:
+            m.normals.push_back(float3(0.f, 1.f, 0.f));
+            break;
+        default:
+            m.normals.push_back(float3(0.f, 0.f, -1.f));
+            break;
+        }
+        m.texCrds.push_back(m.positions[index].xy() / float(size));
+    }
+
+    m.updateMesh(SceneBuilder::Mesh::AttributeFrequency::FaceVarying);
+    return m;
+}
+} // namespace
+
+CPU_TEST(VertexDeduplicationHashed)
+{
+    for (uint32_t size : {1u, 7u, 64u, 300u})
+    {
+        TestMesh m = createFaceVaryingGridMesh(size, size);
+
+        auto ref = VertexDeduplication::mergeLinkedList(m.mesh);
+        EXPECT_LE(ref.uniqueCorners.size(), m.mesh.indexCount);
+
+        for (bool parallel : {false, true})
+        {
+            auto result = VertexDeduplication::mergeHashed(m.mesh, parallel);
+            EXPECT(result.indices == ref.indices) << "size=" << size << " parallel=" << parallel;
+            EXPECT(result.uniqueCorners == ref.uniqueCorners) << "size=" << size << " parallel=" << parallel;
+        }
+    }
+}
+
+CPU_BENCHMARK(VertexDeduplicationBenchmark)
+{
+    TestMesh m = createFaceVaryingGridMesh(1024, 1);
+    const BenchmarkCounters counters = {{"corners", double(m.mesh.indexCount)}};
+
+    VertexDeduplication::Result ref, serial, parallel;
+    ctx.measure("linked list", [&]() { ref = VertexDeduplication::mergeLinkedList(m.mesh); }, counters);
+    ctx.measure("hashed", [&]() { serial = VertexDeduplication::mergeHashed(m.mesh, false); }, counters);
+    ctx.measure("hashed parallel", [&]() { parallel = VertexDeduplication::mergeHashed(m.mesh, true); }, counters);
+
+    EXPECT(serial.indices == ref.indices);
+    EXPECT(parallel.indices == ref.indices);
+}
+} // namespace Falcor
@@ -0,0 +1,156 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/VertexOrderOptimizer.h"
+#include "Scene/TriangleMesh.h"
+#include <algorithm>
+#include <array>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+struct TestMesh
+{
+    std::vector<uint32_t> indices;
+    std::vector<float3> positions;
+};
+
+/// Creates a sphere mesh with shuffled triangles and vertices to produce a poor initial vertex order.
+TestMesh createShuffledSphere(uint32_t segmentsU, uint32_t segmentsV, uint32_t seed)
+{
+    auto pSphere = TriangleMesh::createSphere(1.f, segmentsU, segmentsV);
+    const auto& vertices = pSphere->getVertices();
+    const auto& indices = pSphere->getIndices();
+
+    std::mt19937 rng(seed);
+
+    std::vector<uint32_t> vertexPermutation(vertices.size());
+    for (uint32_t i = 0; i < vertexPermutation.size(); i++)
+        vertexPermutation[i] = i;
+    std::shuffle(vertexPermutation.begin(), vertexPermutation.end(), rng);
+
+    std::vector<uint32_t> trianglePermutation(indices.size() / 3);
+    for (uint32_t i = 0; i < trianglePermutation.size(); i++)
+        trianglePermutation[i] = i;
+    std::shuffle(trianglePermutation.begin(), trianglePermutation.end(), rng);
+
+    TestMesh m;
+    m.positions.resize(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++)
+        m.positions[vertexPermutation[i]] = vertices[i].position;
+    for (uint32_t t : trianglePermutation)
+        for (uint32_t j = 0; j < 3; j++)
+            m.indices.push_back(vertexPermutation[indices[t * 3 + j]]);
+    return m;
+}
+
+/// Returns the sorted list of triangles with each triangle rotated to start with its smallest index, preserving winding.
+std::vector<std::array<uint32_t, 3>> getCanonicalTriangles(const std::vector<uint32_t>& indices, const std::vector<uint32_t>* pRemap = nullptr)
+{
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        std::array<uint32_t, 3> t;
+        for (uint32_t j = 0; j < 3; j++)
+            t[j] = pRemap ? (*pRemap)[indices[i + j]] : indices[i + j];
+        std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+        triangles.push_back(t);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+} // namespace
+
+CPU_TEST(VertexOrderOptimizerCacheStats)
+{
+    // A strip of triangles sharing edges: each new triangle introduces one new vertex.
+    std::vector<uint32_t> indices = {0, 1, 2, 2, 1, 3, 2, 3, 4, 4, 3, 5};
+    auto stats = VertexOrderOptimizer::analyzeVertexCache(indices, 6);
+    EXPECT_EQ(stats.triangleCount, 4u);
+    EXPECT_EQ(stats.vertexCount, 6u);
+    EXPECT_EQ(stats.cacheMissCount, 6u);
+    EXPECT_EQ(stats.getATVR(), 1.f);
+    EXPECT_EQ(stats.getACMR(), 1.5f);
+
+    // With a single entry cache, only consecutive repeats hit.
+    stats = VertexOrderOptimizer::analyzeVertexCache(indices, 6, 1);
+    EXPECT_EQ(stats.cacheMissCount, 10u);
+}
+
+CPU_TEST(VertexOrderOptimizerSphere)
+{
+    for (uint32_t seed = 0; seed < 3; seed++)
+    {
+        TestMesh m = createShuffledSphere(64, 32, seed);
+        const uint32_t vertexCount = (uint32_t)m.positions.size();
+        const auto referenceTriangles = getCanonicalTriangles(m.indices);
+        const auto statsBefore = VertexOrderOptimizer::analyzeVertexCache(m.indices, vertexCount);
+
+        // Vertex cache optimization only reorders triangles.
+        std::vector<uint32_t> indices = m.indices;
+        std::vector<uint32_t> clusters;
+        VertexOrderOptimizer::optimizeVertexCache(indices, vertexCount, VertexOrderOptimizer::kDefaultCacheSize, &clusters);
+        EXPECT(getCanonicalTriangles(indices) == referenceTriangles);
+        EXPECT(!clusters.empty());
+        if (!clusters.empty())
+            EXPECT_EQ(clusters[0], 0u);
+        EXPECT(std::is_sorted(clusters.begin(), clusters.end()));
+
+        const auto statsOptimized = VertexOrderOptimizer::analyzeVertexCache(indices, vertexCount);
+        EXPECT_LT(statsOptimized.getACMR(), statsBefore.getACMR());
+        EXPECT_LT(statsOptimized.getACMR(), 1.f) << "seed = " << seed;
+
+        // Overdraw optimization only reorders clusters.
+        VertexOrderOptimizer::optimizeOverdraw(indices, m.positions, clusters);
+        EXPECT(getCanonicalTriangles(indices) == referenceTriangles);
+
+        // Vertex fetch optimization renumbers vertices in order of first use.
+        auto remap = VertexOrderOptimizer::optimizeVertexFetch(indices, vertexCount);
+        EXPECT_EQ(remap.size(), vertexCount);
+        EXPECT(getCanonicalTriangles(indices, &remap) == referenceTriangles);
+
+        uint32_t nextVertex = 0;
+        bool firstUseOrder = true;
+        for (uint32_t index : indices)
+        {
+            if (index > nextVertex)
+                firstUseOrder = false;
+            if (index == nextVertex)
+                nextVertex++;
+        }
+        EXPECT(firstUseOrder);
+
+        // Cache efficiency is unaffected by vertex renumbering.
+        const auto statsAfter = VertexOrderOptimizer::analyzeVertexCache(indices, vertexCount);
+        EXPECT_LE(statsAfter.getACMR(), statsBefore.getACMR());
+        EXPECT_EQ(statsAfter.vertexCount, statsBefore.vertexCount);
+    }
+}
+} // namespace Falcor
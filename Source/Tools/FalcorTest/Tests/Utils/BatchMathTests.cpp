@@ -0,0 +1,384 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Math/BatchMath.h"
+#include <fmt/format.h>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const math::SIMDLevel kSIMDLevels[] = {math::SIMDLevel::Scalar, math::SIMDLevel::SSE, math::SIMDLevel::AVX2, math::SIMDLevel::NEON};
+const size_t kCounts[] = {1, 2, 3, 17, 1000};
+const float kEpsilon = 1e-5f;
+
+/// Vertex with interleaved attributes for testing strided access.
+struct Vertex
+{
+    float3 position;
+    float3 normal;
+    float2 texCoord;
+};
+
+/// Interleaved transform components for testing composeTransforms().
+struct TransformComponents
+{
+    float3 translation;
+    quatf rotation;
+    float3 scaling;
+};
+
+/// Sets the SIMD level for the lifetime of the object.
+class ScopedSIMDLevel
+{
+public:
+    ScopedSIMDLevel(math::SIMDLevel level) : mPrevLevel(math::getSIMDLevel()) { math::setSIMDLevel(level); }
+    ~ScopedSIMDLevel() { math::setSIMDLevel(mPrevLevel); }
+
+private:
+    math::SIMDLevel mPrevLevel;
+};
+
+/// Relative error, falling back to absolute error for small values.
+float relativeError(float a, float b)
+{
+    return std::abs(a - b) / std::max(1.f, std::abs(b));
+}
+
+template<int N>
+float maxError(const math::vector<float, N>& a, const math::vector<float, N>& b)
+{
+    float e = 0.f;
+    for (int i = 0; i < N; i++)
+        e = std::max(e, relativeError(a[i], b[i]));
+    return e;
+}
+
+float maxError(const float4x4& a, const float4x4& b)
+{
+    float e = 0.f;
+    for (int i = 0; i < 4; i++)
+        e = std::max(e, maxError(a[i], b[i]));
+    return e;
+}
+
+float3 randomVector(std::mt19937& rng, float range)
+{
+    std::uniform_real_distribution<float> u(-range, range);
+    return float3(u(rng), u(rng), u(rng));
+}
+
+quatf randomRotation(std::mt19937& rng)
+{
+    std::normal_distribution<float> n;
+    const float4 v = normalize(float4(n(rng), n(rng), n(rng), n(rng)));
+    return quatf(v.x, v.y, v.z, v.w);
+}
+
+/// Random affine transform with non-uniform scaling.
+float4x4 randomTransform(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> u(0.5f, 2.f);
+    float4x4 m = math::matrixFromQuat(randomRotation(rng));
+    for (int r = 0; r < 3; r++)
+        m[r] = float4(m[r].xyz() * float3(u(rng), u(rng), u(rng)), u(rng));
+    return m;
+}
+
+std::vector<Vertex> createVertices(size_t count, std::mt19937& rng)
+{
+    std::vector<Vertex> vertices(count);
+    for (auto& v : vertices)
+    {
+        v.position = randomVector(rng, 100.f);
+        v.normal = normalize(randomVector(rng, 1.f));
+        v.texCoord = float2(0.5f);
+    }
+    return vertices;
+}
+} // namespace
+
+CPU_TEST(BatchMath_Transforms)
+{
+    std::mt19937 rng;
+    const float4x4 transform = randomTransform(rng);
+    const float3x3 transform3x3 = float3x3(transform);
+    const float3x3 invTranspose3x3 = float3x3(transpose(inverse(transform)));
+
+    for (size_t count : kCounts)
+    {
+        const std::vector<Vertex> vertices = createVertices(count, rng);
+
+        // The scalar reference.
+        std::vector<float3> refPositions(count), refNormals(count), refVectors(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            refPositions[i] = transformPoint(transform, vertices[i].position);
+            refNormals[i] = normalize(transformVector(invTranspose3x3, vertices[i].normal));
+            refVectors[i] = transformVector(transform3x3, vertices[i].normal);
+        }
+
+        for (math::SIMDLevel level : kSIMDLevels)
+        {
+            if (!math::isSIMDLevelSupported(level))
+                continue;
+            ScopedSIMDLevel scopedLevel(level);
+
+            // Strided in-place transforms.
+            std::vector<Vertex> result = vertices;
+            const size_t stride = sizeof(Vertex);
+            math::transformPoints(transform, &result.data()->position, &result.data()->position, count, stride, stride);
+            math::transformNormals(invTranspose3x3, &result.data()->normal, &result.data()->normal, count, stride, stride);
+
+            // Strided input to contiguous output.
+            std::vector<float3> vectors(count);
+            math::transformVectors(transform3x3, &vertices.data()->normal, vectors.data(), count, stride);
+
+            for (size_t i = 0; i < count; i++)
+            {
+                EXPECT_LE(maxError(result[i].position, refPositions[i]), kEpsilon) << "level " << (int)level << " i = " << i;
+                EXPECT_LE(maxError(result[i].normal, refNormals[i]), kEpsilon) << "level " << (int)level << " i = " << i;
+                EXPECT_LE(maxError(vectors[i], refVectors[i]), kEpsilon) << "level " << (int)level << " i = " << i;
+                EXPECT(all(result[i].texCoord == vertices[i].texCoord)) << "level " << (int)level << " i = " << i;
+            }
+        }
+    }
+}
+
+CPU_TEST(BatchMath_Bounds)
+{
+    std::mt19937 rng;
+    for (size_t count : kCounts)
+    {
+        const std::vector<Vertex> vertices = createVertices(count, rng);
+        std::vector<AABB> boxes(count);
+        AABB refPointBounds, refBoxBounds;
+        for (size_t i = 0; i < count; i++)
+        {
+            boxes[i] = AABB(vertices[i].position, vertices[i].position + abs(randomVector(rng, 10.f)));
+            refPointBounds.include(vertices[i].position);
+            refBoxBounds.include(boxes[i]);
+        }
+
+        for (math::SIMDLevel level : kSIMDLevels)
+        {
+            if (!math::isSIMDLevelSupported(level))
+                continue;
+            ScopedSIMDLevel scopedLevel(level);
+
+            // Bounds are exact.
+            const AABB pointBounds = math::computeBounds(&vertices.data()->position, count, sizeof(Vertex));
+            const AABB boxBounds = math::computeBounds(boxes.data(), count);
+            EXPECT(pointBounds == refPointBounds) << "level " << (int)level << " count = " << count;
+            EXPECT(boxBounds == refBoxBounds) << "level " << (int)level << " count = " << count;
+        }
+    }
+
+    EXPECT(!math::computeBounds(static_cast<const float3*>(nullptr), 0).valid());
+    EXPECT(!math::computeBounds(static_cast<const AABB*>(nullptr), 0).valid());
+}
+
+CPU_TEST(BatchMath_Matrices)
+{
+    std::mt19937 rng;
+    const size_t count = 100;
+    std::vector<float4x4> a(count), b(count);
+    std::vector<float3> translations(count), scalings(count);
+    std::vector<quatf> rotations(count);
+    std::uniform_real_distribution<float> u(0.5f, 2.f);
+    for (size_t i = 0; i < count; i++)
+    {
+        a[i] = randomTransform(rng);
+        b[i] = randomTransform(rng);
+        translations[i] = randomVector(rng, 10.f);
+        rotations[i] = randomRotation(rng);
+        scalings[i] = float3(u(rng), u(rng), u(rng));
+    }
+
+    for (math::SIMDLevel level : kSIMDLevels)
+    {
+        if (!math::isSIMDLevelSupported(level))
+            continue;
+        ScopedSIMDLevel scopedLevel(level);
+
+        std::vector<float4x4> products(count), inverses(count), inverseTransposes(count), transforms(count);
+        math::mulAffine(a.data(), b.data(), products.data(), count);
+        math::inverseAffine(a.data(), inverses.data(), count);
+        math::inverseTransposeAffine(a.data(), inverseTransposes.data(), count);
+
+        // Interleave the inputs to test the stride.
+        std::vector<float4> packed(count * 3);
+        for (size_t i = 0; i < count; i++)
+        {
+            packed[3 * i + 0] = float4(translations[i], 0.f);
+            packed[3 * i + 1] = float4(rotations[i].x, rotations[i].y, rotations[i].z, rotations[i].w);
+            packed[3 * i + 2] = float4(scalings[i], 0.f);
+        }
+        math::composeTransforms(
+            reinterpret_cast<const float3*>(&packed[0]),
+            reinterpret_cast<const quatf*>(&packed[1]),
+            reinterpret_cast<const float3*>(&packed[2]),
+            3 * sizeof(float4),
+            transforms.data(),
+            count
+        );
+
+        // In-place multiplication.
+        std::vector<float4x4> inPlace = a;
+        math::mulAffine(inPlace.data(), b.data(), inPlace.data(), count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const float4x4 refTransform = mul(
+                mul(math::matrixFromTranslation(translations[i]), float4x4(math::matrixFromQuat(rotations[i]))), math::matrixFromScaling(scalings[i])
+            );
+            EXPECT_LE(maxError(products[i], mul(a[i], b[i])), kEpsilon) << "level " << (int)level << " i = " << i;
+            EXPECT_LE(maxError(inverses[i], inverse(a[i])), kEpsilon) << "level " << (int)level << " i = " << i;
+            EXPECT_LE(maxError(inverseTransposes[i], transpose(inverse(a[i]))), kEpsilon) << "level " << (int)level << " i = " << i;
+            EXPECT_LE(maxError(transforms[i], refTransform), kEpsilon) << "level " << (int)level << " i = " << i;
+            EXPECT(inPlace[i] == products[i]) << "level " << (int)level << " i = " << i;
+        }
+    }
+}
+
+CPU_TEST(BatchMath_X64MatchesScalar)
+{
+    // The x86-64 kernels evaluate the same expressions in the same order as the scalar kernels without FMA, so the results are
+    // bit-identical.
+    if (!math::isSIMDLevelSupported(math::SIMDLevel::SSE))
+        ctx.skip("SSE is not supported");
+
+    std::mt19937 rng;
+    const size_t count = 1000;
+    const float4x4 transform = randomTransform(rng);
+    const float3x3 invTranspose3x3 = float3x3(transpose(inverse(transform)));
+    const std::vector<Vertex> vertices = createVertices(count, rng);
+    std::vector<float4x4> matrices(count);
+    std::vector<TransformComponents> components(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        matrices[i] = randomTransform(rng);
+        components[i] = {randomVector(rng, 10.f), randomRotation(rng), abs(randomVector(rng, 2.f)) + 0.5f};
+    }
+
+    struct Results
+    {
+        std::vector<Vertex> vertices;
+        std::vector<float4x4> products, inverses, inverseTransposes, transforms;
+        AABB bounds;
+    };
+    auto run = [&](math::SIMDLevel level)
+    {
+        ScopedSIMDLevel scopedLevel(level);
+        Results r;
+        r.vertices = vertices;
+        r.products.resize(count);
+        r.inverses.resize(count);
+        r.inverseTransposes.resize(count);
+        r.transforms.resize(count);
+        const size_t stride = sizeof(Vertex);
+        math::transformPoints(transform, &r.vertices.data()->position, &r.vertices.data()->position, count, stride, stride);
+        math::transformNormals(invTranspose3x3, &r.vertices.data()->normal, &r.vertices.data()->normal, count, stride, stride);
+        r.bounds = math::computeBounds(&r.vertices.data()->position, count, stride);
+        math::mulAffine(matrices.data(), matrices.data() + 1, r.products.data(), count - 1);
+        math::inverseAffine(matrices.data(), r.inverses.data(), count);
+        math::inverseTransposeAffine(matrices.data(), r.inverseTransposes.data(), count);
+        const TransformComponents* pComponents = components.data();
+        math::composeTransforms(
+            &pComponents->translation,
+            &pComponents->rotation,
+            &pComponents->scaling,
+            sizeof(TransformComponents),
+            r.transforms.data(),
+            count
+        );
+        return r;
+    };
+
+    const Results scalar = run(math::SIMDLevel::Scalar);
+    for (math::SIMDLevel level : {math::SIMDLevel::SSE, math::SIMDLevel::AVX2})
+    {
+        if (!math::isSIMDLevelSupported(level))
+            continue;
+        const Results simd = run(level);
+        EXPECT(std::memcmp(scalar.vertices.data(), simd.vertices.data(), count * sizeof(Vertex)) == 0) << "level " << (int)level;
+        EXPECT(scalar.bounds == simd.bounds) << "level " << (int)level;
+        EXPECT(scalar.products == simd.products) << "level " << (int)level;
+        EXPECT(scalar.inverses == simd.inverses) << "level " << (int)level;
+        EXPECT(scalar.inverseTransposes == simd.inverseTransposes) << "level " << (int)level;
+        EXPECT(scalar.transforms == simd.transforms) << "level " << (int)level;
+    }
+}
+
+CPU_BENCHMARK(BatchMathBenchmark)
+{
+    std::mt19937 rng;
+    const size_t count = 1000000;
+    const float4x4 transform = randomTransform(rng);
+    const float3x3 invTranspose3x3 = float3x3(transpose(inverse(transform)));
+    const std::vector<Vertex> vertices = createVertices(count, rng);
+    std::vector<float4x4> matrices(count);
+    for (auto& m : matrices)
+        m = randomTransform(rng);
+    const BenchmarkCounters counters = {{"elements", double(count)}};
+
+    // The kernels write to separate output buffers so that every iteration operates on the same input data.
+    std::vector<Vertex> outVertices(count);
+    std::vector<float4x4> outMatrices(count);
+
+    for (math::SIMDLevel level : kSIMDLevels)
+    {
+        if (!math::isSIMDLevelSupported(level))
+            continue;
+        ScopedSIMDLevel scopedLevel(level);
+        const std::string suffix = fmt::format("_{}", (int)level);
+        const size_t stride = sizeof(Vertex);
+
+        ctx.measure(
+            "transformPoints" + suffix,
+            [&]() { math::transformPoints(transform, &vertices.data()->position, &outVertices.data()->position, count, stride, stride); },
+            counters
+        );
+        ctx.measure(
+            "transformNormals" + suffix,
+            [&]() { math::transformNormals(invTranspose3x3, &vertices.data()->normal, &outVertices.data()->normal, count, stride, stride); },
+            counters
+        );
+        ctx.measure("computeBounds" + suffix, [&]() { math::computeBounds(&vertices.data()->position, count, stride); }, counters);
+        ctx.measure(
+            "mulAffine" + suffix, [&]() { math::mulAffine(matrices.data(), matrices.data(), outMatrices.data(), count); }, counters
+        );
+        ctx.measure(
+            "inverseTransposeAffine" + suffix, [&]() { math::inverseTransposeAffine(matrices.data(), outMatrices.data(), count); }, counters
+        );
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,184 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/AsyncImageWriter.h"
+#include "Utils/Image/TextureReadbackRing.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace Falcor
+{
+namespace
+{
+AsyncImageWriter::Image createImage(uint32_t index)
+{
+    AsyncImageWriter::Image image;
+    image.path = fmt::format("image{}.png", index);
+    image.width = 4;
+    image.height = 4;
+    image.resourceFormat = ResourceFormat::RGBA8Unorm;
+    image.data.resize(4 * 4 * 4, uint8_t(index));
+    return image;
+}
+} // namespace
+
+CPU_TEST(AsyncImageWriterBackPressure)
+{
+    const uint32_t kImageCount = 64;
+    const uint32_t kMaxPendingImages = 3;
+
+    std::mutex mutex;
+    std::set<std::filesystem::path> written;
+    std::atomic<uint32_t> activeCount = 0;
+    std::atomic<uint32_t> maxActiveCount = 0;
+    std::atomic<bool> dataValid = true;
+
+    AsyncImageWriter::Options options;
+    options.threadCount = 4;
+    options.maxPendingImages = kMaxPendingImages;
+
+    AsyncImageWriter writer(
+        options,
+        [&](const AsyncImageWriter::Image& image)
+        {
+            uint32_t active = ++activeCount;
+            uint32_t prevMax = maxActiveCount;
+            while (prevMax < active && !maxActiveCount.compare_exchange_weak(prevMax, active))
+                ;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            for (uint8_t value : image.data)
+                if (value != image.data[0])
+                    dataValid = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                written.insert(image.path);
+            }
+            --activeCount;
+        }
+    );
+
+    for (uint32_t i = 0; i < kImageCount; i++)
+    {
+        writer.write(createImage(i));
+        EXPECT_LE(writer.getPendingCount(), kMaxPendingImages);
+    }
+    writer.flush();
+
+    EXPECT_EQ(writer.getPendingCount(), 0);
+    EXPECT_EQ(writer.getWrittenCount(), kImageCount);
+    EXPECT_EQ(writer.getFailedCount(), 0);
+    EXPECT_EQ(written.size(), kImageCount);
+    EXPECT_LE(maxActiveCount.load(), kMaxPendingImages);
+    EXPECT(dataValid);
+    // Images are produced much faster than written, so the producer must have been stalled.
+    EXPECT_GT(writer.getStallTime(), 0.0);
+}
+
+CPU_TEST(AsyncImageWriterFailure)
+{
+    AsyncImageWriter::Options options;
+    options.threadCount = 2;
+    options.maxPendingImages = 2;
+
+    AsyncImageWriter writer(
+        options,
+        [](const AsyncImageWriter::Image& image)
+        {
+            if (image.data[0] % 2 == 1)
+                FALCOR_THROW("Failed to write '{}'.", image.path);
+        }
+    );
+
+    for (uint32_t i = 0; i < 10; i++)
+        writer.write(createImage(i));
+    writer.flush();
+
+    EXPECT_EQ(writer.getWrittenCount(), 5);
+    EXPECT_EQ(writer.getFailedCount(), 5);
+}
+
+GPU_TEST(TextureReadbackRingOrder)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    const uint32_t kWidth = 37;
+    const uint32_t kHeight = 19;
+    const uint32_t kFrameCount = 8;
+    const uint32_t kReadsPerFrame = 5;
+    const uint32_t kRingFrameCount = 3;
+
+    std::vector<ref<Texture>> textures;
+    std::vector<std::vector<uint8_t>> expected;
+    for (uint32_t i = 0; i < kFrameCount * kReadsPerFrame; i++)
+    {
+        std::vector<uint8_t> data(kWidth * kHeight * 4);
+        for (size_t j = 0; j < data.size(); j++)
+            data[j] = uint8_t(j * 3 + i * 17);
+        textures.push_back(pDevice->createTexture2D(kWidth, kHeight, ResourceFormat::RGBA8Unorm, 1, 1, data.data()));
+        expected.push_back(std::move(data));
+    }
+
+    TextureReadbackRing ring(pDevice, kRingFrameCount);
+    std::vector<uint32_t> order;
+
+    for (uint32_t frame = 0; frame < kFrameCount; frame++)
+    {
+        // Reading more textures than the ring has frames must not wait for the reads of the same frame.
+        uint32_t pendingCount = ring.getPendingCount();
+        for (uint32_t r = 0; r < kReadsPerFrame; r++)
+        {
+            uint32_t i = frame * kReadsPerFrame + r;
+            ring.read(
+                textures[i].get(),
+                0,
+                [&, i](std::vector<uint8_t> data)
+                {
+                    EXPECT(data == expected[i]) << "read " << i;
+                    order.push_back(i);
+                }
+            );
+            EXPECT_EQ(ring.getPendingCount(), pendingCount + r + 1);
+        }
+
+        ring.endFrame();
+        EXPECT_LT(ring.getPendingFrameCount(), kRingFrameCount);
+        EXPECT_LE(ring.getPendingCount(), (kRingFrameCount - 1) * kReadsPerFrame);
+        ring.poll();
+    }
+    ring.flush();
+
+    EXPECT_EQ(ring.getPendingCount(), 0);
+    ASSERT_EQ(order.size(), kFrameCount * kReadsPerFrame);
+    for (uint32_t i = 0; i < kFrameCount * kReadsPerFrame; i++)
+        EXPECT_EQ(order[i], i);
+}
+} // namespace Falcor
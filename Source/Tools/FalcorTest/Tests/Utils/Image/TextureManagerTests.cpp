@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Utils/Image/TextureManager.h"
+#include <random>
 
 namespace Falcor
 {
@@ -51,4 +52,111 @@ GPU_TEST(TextureManager_LoadMips)
     EXPECT_EQ(tex->getMipCount(), 3);
     EXPECT_EQ(tex->getArraySize(), 1);
 }
+
+GPU_TEST(TextureManager_ContentDeduplication)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    // Create copies of the same image under different names.
+    auto dir = std::filesystem::temp_directory_path() / fmt::format("FalcorTextureManagerTest-{:08x}", std::random_device()());
+    std::filesystem::create_directories(dir);
+    std::filesystem::path srcPath = getRuntimeDirectory() / "data/tests/tiny_mip0.png";
+    std::filesystem::copy_file(srcPath, dir / "a.png");
+    std::filesystem::copy_file(srcPath, dir / "b.png");
+    std::filesystem::copy_file(getRuntimeDirectory() / "data/tests/tiny_mip1.png", dir / "c.png");
+
+    {
+        TextureManager textureManager(pDevice, 10);
+
+        auto handleA = textureManager.loadTexture(dir / "a.png", true, false, ResourceBindFlags::ShaderResource, false);
+        auto handleB = textureManager.loadTexture(dir / "b.png", true, false, ResourceBindFlags::ShaderResource, false);
+        auto handleC = textureManager.loadTexture(dir / "c.png", true, false, ResourceBindFlags::ShaderResource, false);
+        EXPECT(handleA.isValid());
+        EXPECT(handleA == handleB);
+        EXPECT(!(handleA == handleC));
+
+        // Different load flags result in a different texture.
+        auto handleSrgb = textureManager.loadTexture(dir / "b.png", true, true, ResourceBindFlags::ShaderResource, false);
+        EXPECT(!(handleA == handleSrgb));
+
+        EXPECT_EQ(textureManager.getStats().textureCount, 3);
+        EXPECT_EQ(textureManager.getStats().textureDeduplicatedCount, 1);
+
+        // Without deduplication each path is loaded separately.
+        textureManager.setContentDeduplication(false);
+        std::filesystem::copy_file(srcPath, dir / "d.png");
+        auto handleD = textureManager.loadTexture(dir / "d.png", true, false, ResourceBindFlags::ShaderResource, false);
+        EXPECT(!(handleA == handleD));
+    }
+
+    {
+        // With deferred loading, the handles of duplicates are distinct but share one texture.
+        TextureManager textureManager(pDevice, 10);
+        textureManager.beginDeferredLoading();
+        auto handleA = textureManager.loadTexture(dir / "a.png", true, false);
+        auto handleB = textureManager.loadTexture(dir / "b.png", true, false);
+        auto handleC = textureManager.loadTexture(dir / "c.png", true, false);
+        textureManager.endDeferredLoading();
+
+        auto pTextureA = textureManager.getTexture(handleA);
+        EXPECT(pTextureA != nullptr);
+        EXPECT(pTextureA == textureManager.getTexture(handleB));
+        EXPECT(pTextureA != textureManager.getTexture(handleC));
+        EXPECT_EQ(textureManager.getStats().textureCount, 2);
+        EXPECT_EQ(textureManager.getStats().textureDeduplicatedCount, 1);
+
+        // Later loads of the duplicate resolve to the handle of the loaded texture.
+        EXPECT(textureManager.loadTexture(dir / "b.png", true, false) == handleA);
+    }
+
+    std::filesystem::remove_all(dir);
+}
+
+GPU_TEST(TextureManager_DiskCache)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    auto dir = std::filesystem::temp_directory_path() / fmt::format("FalcorTextureManagerTest-{:08x}", std::random_device()());
+    auto cacheDir = dir / "cache";
+    std::filesystem::create_directories(dir);
+    std::filesystem::copy_file(getRuntimeDirectory() / "data/tests/tiny_mip0.png", dir / "a.png");
+
+    auto loadTexture = [&](uint64_t expectedHitCount, uint64_t expectedWriteCount)
+    {
+        TextureManager textureManager(pDevice, 10);
+        textureManager.setDiskCacheDirectory(cacheDir);
+        auto handle = textureManager.loadTexture(dir / "a.png", true, false, ResourceBindFlags::ShaderResource, false);
+        auto stats = textureManager.getStats();
+        EXPECT_EQ(stats.diskCacheHitCount, expectedHitCount);
+        EXPECT_EQ(stats.diskCacheWriteCount, expectedWriteCount);
+        return textureManager.getTexture(handle);
+    };
+
+    // The first load converts the image and writes it to the cache, the second load reads it from the cache.
+    ref<Texture> pTexture = loadTexture(0, 1);
+    ref<Texture> pCached = loadTexture(1, 0);
+    ASSERT(pTexture != nullptr);
+    ASSERT(pCached != nullptr);
+
+    EXPECT_EQ(pCached->getWidth(), pTexture->getWidth());
+    EXPECT_EQ(pCached->getHeight(), pTexture->getHeight());
+    EXPECT_EQ(pCached->getMipCount(), pTexture->getMipCount());
+    EXPECT_EQ(pCached->getFormat(), pTexture->getFormat());
+    EXPECT_EQ(pCached->getSourcePath(), dir / "a.png");
+
+    for (uint32_t mip = 0; mip < pTexture->getMipCount(); mip++)
+    {
+        auto data = pDevice->getRenderContext()->readTextureSubresource(pTexture.get(), pTexture->getSubresourceIndex(0, mip));
+        auto cachedData = pDevice->getRenderContext()->readTextureSubresource(pCached.get(), pCached->getSubresourceIndex(0, mip));
+        EXPECT(data == cachedData) << "mip " << mip;
+    }
+
+    // Changing the source file invalidates the cache entry.
+    std::filesystem::copy_file(
+        getRuntimeDirectory() / "data/tests/tiny_mip1.png", dir / "a.png", std::filesystem::copy_options::overwrite_existing
+    );
+    loadTexture(0, 1);
+
+    std::filesystem::remove_all(dir);
+}
 } // namespace Falcor
@@ -0,0 +1,416 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/TilePack.h"
+#include "Utils/Image/TilePageTable.h"
+#include "Utils/Image/TileStreamer.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <random>
+#include <set>
+
+namespace Falcor
+{
+namespace
+{
+std::filesystem::path getTempDirectory()
+{
+    auto path = std::filesystem::temp_directory_path() / fmt::format("FalcorTileStreamingTest-{:08x}", std::random_device()());
+    std::filesystem::create_directories(path);
+    return path;
+}
+
+std::vector<uint8_t> createImage(uint32_t width, uint32_t height)
+{
+    std::vector<uint8_t> data(size_t(width) * height * 4);
+    for (uint32_t y = 0; y < height; y++)
+    {
+        for (uint32_t x = 0; x < width; x++)
+        {
+            uint8_t* p = &data[(size_t(y) * width + x) * 4];
+            p[0] = uint8_t(x * 7);
+            p[1] = uint8_t(y * 13);
+            p[2] = uint8_t((x ^ y) * 3);
+            p[3] = 255;
+        }
+    }
+    return data;
+}
+
+/// Create a trace of a view panning across a texture and zooming in and out.
+TileFeedbackTrace createPanningTrace(const TilePageTable& pageTable, uint32_t textureID, uint32_t frameCount)
+{
+    // Determine the number of tiles per mip level.
+    std::vector<uint2> mipTileCounts;
+    for (uint32_t mip = 0; pageTable.isValidTile(TileID{textureID, mip, 0, 0}); mip++)
+    {
+        uint2 count(1, 1);
+        while (pageTable.isValidTile(TileID{textureID, mip, count.x, 0}))
+            count.x++;
+        while (pageTable.isValidTile(TileID{textureID, mip, 0, count.y}))
+            count.y++;
+        mipTileCounts.push_back(count);
+    }
+
+    TileFeedbackTrace trace;
+    for (uint32_t frame = 0; frame < frameCount; frame++)
+    {
+        uint32_t mip = (frame / 16) % 2;
+        uint2 count = mipTileCounts[mip];
+        uint32_t x0 = (frame / 2) % count.x;
+        std::vector<TileID> tiles;
+        for (uint32_t y = 0; y < std::min(count.y, 2u); y++)
+        {
+            for (uint32_t x = x0; x < std::min(x0 + 2, count.x); x++)
+            {
+                // Feedback usually contains each tile many times.
+                tiles.push_back(TileID{textureID, mip, x, y});
+                tiles.push_back(TileID{textureID, mip, x, y});
+            }
+        }
+        trace.frames.push_back(std::move(tiles));
+    }
+    return trace;
+}
+} // namespace
+
+CPU_TEST(TilePackRoundTrip)
+{
+    auto dir = getTempDirectory();
+    const uint32_t width = 100, height = 60, tileSize = 32, borderSize = 2;
+    auto image = createImage(width, height);
+    TilePack::MipData mip0{width, height, image.data()};
+    auto mipData = TilePack::generateMips(ResourceFormat::RGBA8Unorm, mip0);
+    EXPECT_EQ(mipData.size(), 6);
+
+    std::vector<TilePack::MipData> mips{mip0};
+    for (const auto& data : mipData)
+        mips.push_back(TilePack::MipData{std::max(mips.back().width / 2, 1u), std::max(mips.back().height / 2, 1u), data.data()});
+    TilePack::write(dir / "test.tilepack", ResourceFormat::RGBA8Unorm, mips, tileSize, borderSize);
+
+    {
+        TilePack pack(dir / "test.tilepack");
+        EXPECT_EQ(pack.getWidth(), width);
+        EXPECT_EQ(pack.getHeight(), height);
+        EXPECT_EQ(pack.getMipCount(), 7);
+        EXPECT(pack.getFormat() == ResourceFormat::RGBA8Unorm);
+        EXPECT_EQ(pack.getPaddedTileSize(), tileSize + 2 * borderSize);
+        EXPECT_EQ(pack.getTileByteSize(), 36 * 36 * 4);
+        EXPECT(all(pack.getTileCount(0) == uint2(4, 2)));
+        EXPECT(all(pack.getTileCount(1) == uint2(2, 1)));
+        EXPECT(all(pack.getTileCount(6) == uint2(1, 1)));
+
+        // Compare all texels of all tiles, including the clamped borders.
+        const uint32_t paddedTileSize = pack.getPaddedTileSize();
+        for (uint32_t mip = 0; mip < pack.getMipCount(); mip++)
+        {
+            const auto& src = mips[mip];
+            uint2 count = pack.getTileCount(mip);
+            for (uint32_t ty = 0; ty < count.y; ty++)
+            {
+                for (uint32_t tx = 0; tx < count.x; tx++)
+                {
+                    const uint8_t* pTile = pack.getTileData(mip, uint2(tx, ty));
+                    bool match = true;
+                    for (uint32_t y = 0; y < paddedTileSize; y++)
+                    {
+                        for (uint32_t x = 0; x < paddedTileSize; x++)
+                        {
+                            int sx = std::clamp<int>(tx * tileSize + x - borderSize, 0, src.width - 1);
+                            int sy = std::clamp<int>(ty * tileSize + y - borderSize, 0, src.height - 1);
+                            match &= std::memcmp(pTile + (y * paddedTileSize + x) * 4, src.pData + (sy * src.width + sx) * 4, 4) == 0;
+                        }
+                    }
+                    EXPECT(match) << "mip " << mip << " tile " << tx << ", " << ty;
+                }
+            }
+        }
+    }
+
+    // Invalid files are rejected.
+    std::filesystem::resize_file(dir / "test.tilepack", 100);
+    EXPECT_THROW(TilePack(dir / "test.tilepack"));
+
+    std::filesystem::remove_all(dir);
+}
+
+CPU_TEST(TilePackMipGeneration)
+{
+    // Texels are averaged, sRGB formats in linear space.
+    uint8_t unorm[16] = {0, 0, 0, 0, 255, 255, 255, 255, 0, 0, 0, 0, 255, 255, 255, 255};
+    auto mips = TilePack::generateMips(ResourceFormat::RGBA8Unorm, TilePack::MipData{2, 2, unorm});
+    ASSERT_EQ(mips.size(), 1);
+    EXPECT_EQ(mips[0][0], 128);
+    EXPECT_EQ(mips[0][3], 128);
+
+    mips = TilePack::generateMips(ResourceFormat::RGBA8UnormSrgb, TilePack::MipData{2, 2, unorm});
+    EXPECT_EQ(mips[0][0], 188);
+    EXPECT_EQ(mips[0][3], 128);
+
+    float values[8] = {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f};
+    mips = TilePack::generateMips(ResourceFormat::R32Float, TilePack::MipData{4, 2, reinterpret_cast<const uint8_t*>(values)});
+    ASSERT_EQ(mips.size(), 2);
+    float mip1[2], mip2;
+    std::memcpy(mip1, mips[0].data(), sizeof(mip1));
+    std::memcpy(&mip2, mips[1].data(), sizeof(mip2));
+    EXPECT_EQ(mip1[0], 3.5f);
+    EXPECT_EQ(mip1[1], 5.5f);
+    EXPECT_EQ(mip2, 4.5f);
+
+    EXPECT_THROW(TilePack::generateMips(ResourceFormat::BC1Unorm, TilePack::MipData{4, 4, unorm}));
+}
+
+CPU_TEST(TilePageTableLRU)
+{
+    TilePageTable pageTable(4);
+    uint32_t textureID = pageTable.addTexture({uint2(4, 4), uint2(2, 2), uint2(1, 1)});
+    EXPECT_EQ(textureID, 0);
+
+    // Requesting a tile schedules the tile and its ancestors, coarse tiles first.
+    pageTable.beginFrame();
+    TileID tile0{0, 0, 0, 0};
+    auto loads = pageTable.processFeedback({&tile0, 1});
+    ASSERT_EQ(loads.size(), 3);
+    EXPECT(loads[0] == (TileID{0, 2, 0, 0}));
+    EXPECT(loads[1] == (TileID{0, 1, 0, 0}));
+    EXPECT(loads[2] == tile0);
+    EXPECT_EQ(pageTable.getLoadingCount(), 3);
+
+    // Loading tiles are not scheduled again.
+    EXPECT(pageTable.processFeedback({&tile0, 1}).empty());
+
+    for (const auto& tile : loads)
+    {
+        auto allocation = pageTable.completeLoad(tile);
+        EXPECT_NE(allocation.slot, TilePageTable::kInvalidSlot);
+        EXPECT(!allocation.hasEvictedTile);
+    }
+    EXPECT_EQ(pageTable.getResidentCount(), 3);
+
+    // The coarsest resident tile is used as fallback.
+    TileID residentTile;
+    TileID tile1{0, 0, 3, 3};
+    EXPECT_EQ(pageTable.findResidentTile(tile1, residentTile), pageTable.getSlot(TileID{0, 2, 0, 0}));
+    EXPECT(residentTile == (TileID{0, 2, 0, 0}));
+
+    // Requesting a tile in another quadrant evicts the least recently used tile (the ancestor of tile0 is not requested).
+    pageTable.beginFrame();
+    loads = pageTable.processFeedback({&tile1, 1});
+    ASSERT_EQ(loads.size(), 2);
+    EXPECT(!pageTable.completeLoad(loads[0]).hasEvictedTile);
+    auto allocation = pageTable.completeLoad(loads[1]);
+    EXPECT(allocation.hasEvictedTile);
+    EXPECT(allocation.evictedTile == (TileID{0, 1, 0, 0}));
+    EXPECT(pageTable.isResident(tile0));
+    EXPECT(pageTable.isResident(tile1));
+    EXPECT_EQ(pageTable.findResidentTile(tile1, residentTile), allocation.slot);
+    EXPECT(residentTile == tile1);
+
+    // Tiles requested in the current frame are never evicted, loads are dropped instead.
+    pageTable.beginFrame();
+    std::vector<TileID> requests = {TileID{0, 0, 0, 3}, TileID{0, 0, 3, 0}, tile1};
+    loads = pageTable.processFeedback(requests);
+    EXPECT_EQ(loads.size(), 4); // Two tiles and two ancestors in mip 1.
+    uint32_t dropCount = 0;
+    for (const auto& tile : loads)
+    {
+        auto a = pageTable.completeLoad(tile);
+        if (a.slot == TilePageTable::kInvalidSlot)
+            dropCount++;
+        EXPECT(!a.hasEvictedTile || a.evictedTile == tile0);
+    }
+    EXPECT_EQ(dropCount, 3);
+    EXPECT_EQ(pageTable.getStats().dropCount, 3);
+    EXPECT(!pageTable.isResident(tile0));
+    EXPECT(pageTable.isResident(tile1));
+    EXPECT(pageTable.isResident(TileID{0, 2, 0, 0}));
+
+    // Failed loads can be canceled and scheduled again. Invalid requests are ignored.
+    pageTable.beginFrame();
+    std::vector<TileID> invalid = {TileID{0, 0, 4, 0}, TileID{1, 0, 0, 0}, TileID{0, 3, 0, 0}};
+    EXPECT(pageTable.processFeedback(invalid).empty());
+    loads = pageTable.processFeedback({&tile0, 1}, 1);
+    ASSERT_EQ(loads.size(), 1);
+    EXPECT(loads[0] == (TileID{0, 1, 0, 0}));
+    pageTable.cancelLoad(loads[0]);
+    EXPECT(!pageTable.isLoading(loads[0]));
+    EXPECT_EQ(pageTable.processFeedback({&tile0, 1}).size(), 2);
+}
+
+CPU_TEST(TilePageTableTrace)
+{
+    auto dir = getTempDirectory();
+
+    TilePageTable pageTable(12);
+    uint32_t textureID = pageTable.addTexture({uint2(8, 4), uint2(4, 2), uint2(2, 1), uint2(1, 1)});
+    TileFeedbackTrace trace = createPanningTrace(pageTable, textureID, 64);
+
+    // Traces can be stored and loaded.
+    trace.write(dir / "trace.bin");
+    TileFeedbackTrace loadedTrace = TileFeedbackTrace::read(dir / "trace.bin");
+    ASSERT_EQ(loadedTrace.frames.size(), trace.frames.size());
+    for (size_t i = 0; i < trace.frames.size(); i++)
+        EXPECT(loadedTrace.frames[i] == trace.frames[i]);
+
+    // Replay the trace, completing all loads within the frame.
+    auto replay = [&](TilePageTable& table, uint32_t maxLoads)
+    {
+        for (const auto& requests : loadedTrace.frames)
+        {
+            table.beginFrame();
+            std::set<TileID> used;
+            for (auto tile : requests)
+            {
+                for (; table.isValidTile(tile); tile = tile.getParent())
+                    used.insert(tile);
+            }
+
+            for (const auto& tile : table.processFeedback(requests, maxLoads))
+            {
+                auto allocation = table.completeLoad(tile);
+                EXPECT(!allocation.hasEvictedTile || used.count(allocation.evictedTile) == 0);
+            }
+            EXPECT_LE(table.getResidentCount(), table.getSlotCount());
+            EXPECT_EQ(table.getLoadingCount(), 0);
+
+            // All requested tiles have a resident fallback.
+            for (const auto& tile : requests)
+            {
+                TileID residentTile;
+                EXPECT_NE(table.findResidentTile(tile, residentTile), TilePageTable::kInvalidSlot);
+            }
+        }
+    };
+
+    replay(pageTable, 64);
+    const auto stats = pageTable.getStats();
+    EXPECT_EQ(stats.dropCount, 0);
+    EXPECT_GT(stats.evictionCount, 0);
+    EXPECT_EQ(stats.loadCount, stats.scheduleCount);
+    EXPECT_GT(stats.hitCount, stats.requestCount / 2);
+
+    // Replaying is deterministic.
+    TilePageTable pageTable2(12);
+    pageTable2.addTexture({uint2(8, 4), uint2(4, 2), uint2(2, 1), uint2(1, 1)});
+    replay(pageTable2, 64);
+    EXPECT_EQ(pageTable2.getStats().hitCount, stats.hitCount);
+    EXPECT_EQ(pageTable2.getStats().evictionCount, stats.evictionCount);
+
+    // A larger budget keeps everything resident, so each tile is only loaded once.
+    TilePageTable pageTable3(64);
+    pageTable3.addTexture({uint2(8, 4), uint2(4, 2), uint2(2, 1), uint2(1, 1)});
+    replay(pageTable3, 64);
+    EXPECT_EQ(pageTable3.getStats().evictionCount, 0);
+    EXPECT_EQ(pageTable3.getStats().loadCount, pageTable3.getResidentCount());
+    EXPECT_GT(pageTable3.getStats().hitCount, stats.hitCount);
+
+    std::filesystem::remove_all(dir);
+}
+
+CPU_TEST(TileStreamerAsync)
+{
+    auto dir = getTempDirectory();
+    const uint32_t width = 256, height = 128, tileSize = 30, borderSize = 1;
+    auto image = createImage(width, height);
+    TilePack::MipData mip0{width, height, image.data()};
+    auto mipData = TilePack::generateMips(ResourceFormat::RGBA8Unorm, mip0);
+    std::vector<TilePack::MipData> mips{mip0};
+    for (const auto& data : mipData)
+        mips.push_back(TilePack::MipData{std::max(mips.back().width / 2, 1u), std::max(mips.back().height / 2, 1u), data.data()});
+    TilePack::write(dir / "a.tilepack", ResourceFormat::RGBA8Unorm, mips, tileSize, borderSize);
+    TilePack::write(dir / "b.tilepack", ResourceFormat::RGBA8Unorm, fstd::span<const TilePack::MipData>(mips.data(), 3), tileSize, borderSize);
+
+    // Mirror of the physical tile pool, maintained by the callbacks.
+    std::map<uint32_t, TileID> slots;
+    std::vector<std::shared_ptr<const TilePack>> packs;
+    bool dataValid = true;
+    auto upload = [&](const TileID& tile, uint32_t slot, const uint8_t* pData, size_t size)
+    {
+        EXPECT(slots.count(slot) == 0);
+        slots[slot] = tile;
+        const auto& pack = packs[tile.textureID];
+        dataValid &= size == pack->getTileByteSize() && std::memcmp(pData, pack->getTileData(tile.mip, uint2(tile.x, tile.y)), size) == 0;
+    };
+    auto evict = [&](const TileID& tile, uint32_t slot)
+    {
+        EXPECT(slots.count(slot) == 1 && slots[slot] == tile);
+        slots.erase(slot);
+    };
+
+    TileStreamer::Options options;
+    options.memoryBudget = 10 * 32 * 32 * 4;
+    options.maxLoadsPerFrame = 8;
+    options.threadCount = 2;
+    TileStreamer streamer(ResourceFormat::RGBA8Unorm, tileSize + 2 * borderSize, options, upload, evict);
+    EXPECT_EQ(streamer.getPageTable().getSlotCount(), 10);
+
+    packs.push_back(std::make_shared<const TilePack>(dir / "a.tilepack"));
+    packs.push_back(std::make_shared<const TilePack>(dir / "b.tilepack"));
+    EXPECT_EQ(streamer.addTexture(packs[0]), 0);
+    EXPECT_EQ(streamer.addTexture(packs[1]), 1);
+
+    // Textures with a different tile size are rejected.
+    TilePack::write(dir / "c.tilepack", ResourceFormat::RGBA8Unorm, mips, 16, borderSize);
+    EXPECT_THROW(streamer.addTexture(dir / "c.tilepack"));
+
+    TileFeedbackTrace trace = createPanningTrace(streamer.getPageTable(), 0, 48);
+    TileFeedbackTrace traceB = createPanningTrace(streamer.getPageTable(), 1, 48);
+    for (size_t i = 0; i < trace.frames.size(); i++)
+        trace.frames[i].insert(trace.frames[i].end(), traceB.frames[i].begin(), traceB.frames[i].end());
+
+    // Replay the trace, applying finished loads in the next frame like a renderer would.
+    streamer.startTraceRecording();
+    for (const auto& requests : trace.frames)
+    {
+        streamer.update();
+        streamer.submitFeedback(requests);
+    }
+    streamer.flush();
+    TileFeedbackTrace recorded = streamer.stopTraceRecording();
+
+    EXPECT(dataValid);
+    EXPECT_EQ(recorded.frames.size(), trace.frames.size());
+    EXPECT(recorded.frames.back() == trace.frames.back());
+
+    // The mirrored pool matches the page table.
+    const auto& pageTable = streamer.getPageTable();
+    EXPECT_EQ(slots.size(), pageTable.getResidentCount());
+    EXPECT_EQ(pageTable.getLoadingCount(), 0);
+    for (const auto& [slot, tile] : slots)
+        EXPECT_EQ(pageTable.getSlot(tile), slot);
+
+    const auto& stats = streamer.getStats();
+    EXPECT_EQ(stats.loadedTileCount, pageTable.getStats().scheduleCount);
+    EXPECT_EQ(stats.loadedByteCount, stats.loadedTileCount * streamer.getTileByteSize());
+    EXPECT_EQ(stats.uploadedTileCount, pageTable.getStats().loadCount);
+    EXPECT_GT(pageTable.getStats().evictionCount, 0);
+
+    std::filesystem::remove_all(dir);
+}
+} // namespace Falcor
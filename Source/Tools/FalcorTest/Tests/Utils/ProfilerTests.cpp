@@ -0,0 +1,131 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Timing/Profiler.h"
+#include <set>
+#include <thread>
+
+namespace Falcor
+{
+CPU_TEST(ProfilerInternEventName)
+{
+    Profiler::EventId a = Profiler::internEventName("ProfilerTestEventA");
+    Profiler::EventId b = Profiler::internEventName("ProfilerTestEventB");
+    EXPECT_NE(a, b);
+    EXPECT_EQ(Profiler::internEventName(std::string("ProfilerTestEventA")), a);
+    EXPECT_EQ(Profiler::getEventName(a), "ProfilerTestEventA");
+    EXPECT_EQ(Profiler::getEventName(b), "ProfilerTestEventB");
+}
+
+CPU_TEST(ProfilerEventName)
+{
+    // String literals are interned once per call site.
+    detail::ProfilerEventName name;
+    EXPECT(name.get("ProfilerTestEventName").isValid());
+    EXPECT_EQ(name.get("ProfilerTestEventName").getId(), Profiler::internEventName("ProfilerTestEventName"));
+
+    detail::ProfilerEventName invalidName;
+    EXPECT(!invalidName.get("ProfilerTest/EventName").isValid());
+
+    // Other names are passed through to be interned on every call.
+    detail::ProfilerEventName dynamicName;
+    std::string dynamic = "ProfilerTestDynamicEventName";
+    EXPECT_EQ(&dynamicName.get(dynamic), &dynamic);
+}
+
+GPU_TEST(ProfilerCpuEvents)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = ctx.getRenderContext();
+    Profiler* pProfiler = pDevice->getProfiler();
+    const bool wasEnabled = pProfiler->isEnabled();
+
+    // Events are not recorded while no capture is active.
+    EXPECT(!Profiler::isRecordingCpuEvents());
+
+    const uint32_t kThreadCount = 4;
+    const uint32_t kEventsPerThread = 100;
+
+    pProfiler->startCapture();
+    EXPECT(Profiler::isRecordingCpuEvents());
+
+    {
+        FALCOR_PROFILE(pRenderContext, "ProfilerTestMainThread");
+
+        std::vector<std::thread> threads;
+        for (uint32_t i = 0; i < kThreadCount; ++i)
+        {
+            threads.emplace_back(
+                []()
+                {
+                    for (uint32_t j = 0; j < kEventsPerThread; ++j)
+                    {
+                        FALCOR_PROFILE_CPU("ProfilerTestWorker");
+                    }
+                }
+            );
+        }
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    pProfiler->endFrame(pRenderContext);
+    auto pCapture = pProfiler->endCapture();
+    ASSERT(pCapture != nullptr);
+    EXPECT(!Profiler::isRecordingCpuEvents());
+    EXPECT_EQ(pCapture->getDroppedTraceEventCount(), 0u);
+    pProfiler->setEnabled(wasEnabled);
+
+    const Profiler::EventId workerId = Profiler::internEventName("ProfilerTestWorker");
+    const Profiler::EventId mainId = Profiler::internEventName("ProfilerTestMainThread");
+    std::set<uint32_t> workerThreads;
+    uint32_t workerEventCount = 0;
+    uint32_t mainEventCount = 0;
+    double lastStartTime = 0.0;
+    for (const auto& event : pCapture->getTraceEvents())
+    {
+        EXPECT_GE(event.startTime, lastStartTime);
+        EXPECT_GE(event.duration, 0.0);
+        lastStartTime = event.startTime;
+        if (event.id == workerId)
+        {
+            workerThreads.insert(event.threadIndex);
+            workerEventCount++;
+        }
+        if (event.id == mainId)
+            mainEventCount++;
+    }
+    EXPECT_EQ(workerEventCount, kThreadCount * kEventsPerThread);
+    EXPECT_EQ(workerThreads.size(), (size_t)kThreadCount);
+    EXPECT_EQ(mainEventCount, 1u);
+
+    std::string trace = pCapture->toChromeTraceJsonString();
+    EXPECT(trace.find("\"traceEvents\"") != std::string::npos);
+    EXPECT(trace.find("ProfilerTestWorker") != std::string::npos);
+}
+} // namespace Falcor
@@ -0,0 +1,152 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/WorkerQueue.h"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+struct TestJob
+{
+    uint32_t index = 0;
+    uint32_t result = 0;
+};
+} // namespace
+
+CPU_TEST(WorkerQueueProcessesAllJobs)
+{
+    const uint32_t kJobCount = 1000;
+
+    std::vector<uint32_t> results(kJobCount, 0);
+    uint32_t completedCount = 0;
+
+    WorkerQueue<TestJob> queue(
+        4,
+        {
+            [](TestJob& job) { job.result = job.index * 2; },
+            [&](TestJob& job, bool success)
+            {
+                results[job.index] = success ? job.result : 0;
+                completedCount++;
+            },
+        }
+    );
+
+    for (uint32_t i = 0; i < kJobCount; i++)
+        queue.push(TestJob{i});
+    queue.flush();
+
+    auto lock = queue.lock();
+    EXPECT_EQ(queue.getPendingCount(lock), 0);
+    EXPECT_EQ(completedCount, kJobCount);
+    for (uint32_t i = 0; i < kJobCount; i++)
+        EXPECT_EQ(results[i], i * 2) << "i = " << i;
+}
+
+CPU_TEST(WorkerQueueExceptions)
+{
+    const uint32_t kJobCount = 30;
+
+    uint32_t successCount = 0;
+    uint32_t failedCount = 0;
+
+    // Failing jobs must not terminate the workers or stop them from processing the following jobs.
+    WorkerQueue<TestJob> queue(
+        2,
+        {
+            [](TestJob& job)
+            {
+                if (job.index % 3 == 0)
+                    throw std::runtime_error("Expected failure");
+                if (job.index % 3 == 1)
+                    throw 1;
+            },
+            [&](TestJob& job, bool success) { success ? successCount++ : failedCount++; },
+            [](const TestJob& job) { return fmt::format("process test job {}", job.index); },
+        }
+    );
+
+    for (uint32_t i = 0; i < kJobCount; i++)
+        queue.push(TestJob{i});
+    queue.flush();
+
+    auto lock = queue.lock();
+    EXPECT_EQ(successCount, kJobCount / 3);
+    EXPECT_EQ(failedCount, kJobCount - kJobCount / 3);
+}
+
+CPU_TEST(WorkerQueueCancelAndWait)
+{
+    std::atomic<bool> release = false;
+    std::vector<uint32_t> completed;
+
+    WorkerQueue<TestJob> queue(
+        1,
+        {
+            [&](TestJob& job)
+            {
+                if (job.index == 0)
+                    while (!release)
+                        std::this_thread::yield();
+            },
+            [&](TestJob& job, bool) { completed.push_back(job.index); },
+        }
+    );
+
+    auto isJob = [](uint32_t index) { return [index](const TestJob& job) { return job.index == index; }; };
+
+    auto lock = queue.lock();
+    for (uint32_t i = 0; i < 4; i++)
+        queue.push(lock, TestJob{i});
+
+    // Wait for the worker to pick up the first job, which blocks until released.
+    while (!queue.isRunning(lock, isJob(0)))
+    {
+        lock.unlock();
+        std::this_thread::yield();
+        lock.lock();
+    }
+    EXPECT(!queue.isQueued(lock, isJob(0)));
+    EXPECT(queue.isQueued(lock, isJob(2)));
+    EXPECT_EQ(queue.getPendingCount(lock), 4);
+
+    // Running jobs can't be cancelled.
+    EXPECT_EQ(queue.cancelIf(lock, [](const TestJob& job) { return job.index != 1; }), 2);
+    EXPECT(queue.isRunning(lock, isJob(0)));
+    EXPECT_EQ(queue.getPendingCount(lock), 2);
+
+    release = true;
+    queue.wait(lock, [&]() { return queue.getPendingCount(lock) == 0; });
+    EXPECT(completed == std::vector<uint32_t>({0, 1}));
+}
+} // namespace Falcor
@@ -38,6 +38,8 @@
  * (see PBRTImporter::import() for more details):
  * - A scene file is parsed using pbrt::parseFile() or pbrt::parseString().
  * - The parser dispatches commands via the pbrt::ParserTarget interface.
+ * Files referenced by 'Import' directives are parsed concurrently into
+ * pbrt::ParserRecorder buffers, which are replayed in file order.
  * - The pbrt::BasicSceneBuilder (implementing pbrt::ParserTarget) builds
  * a pbrt::BasicScene representing the parsed scene.
  * - The buildScene() function in this file takes a pbrt::BasicScene
@@ -62,12 +64,13 @@
 #include "Parser.h"
 #include "Builder.h"
 #include "Helpers.h"
-#include "LoopSubdivide.h"
+#include "PlyReader.h"
 #include "EnvMapConverter.h"
 #include "Core/Error.h"
 #include "Core/API/Device.h"
 #include "Utils/Settings/Settings.h"
 #include "Utils/Logger.h"
+#include "Utils/NumericRange.h"
 #include "Utils/Timing/TimeReport.h"
 #include "Utils/Math/FalcorMath.h"
 #include "Utils/Math/FNVHash.h"
@@ -83,9 +86,13 @@
 #include "Scene/Material/PBRT/PBRTDielectricMaterial.h"
 #include "Scene/Material/PBRT/PBRTDiffuseTransmissionMaterial.h"
 #include "Scene/Curves/CurveTessellation.h"
+#include "Scene/LoopSubdivision.h"
 
 #include <pybind11/pybind11.h>
 
+#include <exception>
+#include <execution>
+#include <optional>
 #include <unordered_map>
 
 namespace Falcor
@@ -178,6 +185,15 @@ struct Shape
     Falcor::ref<Falcor::Material> pMaterial;
 };
 
+/**
+ * Holds the data of a PLY file that was loaded ahead of shape creation.
+ */
+struct PreloadedPlyMesh
+{
+    std::optional<PlyMesh> mesh; ///< Mesh data, empty if the file failed to load.
+    uint32_t useCount = 0;       ///< Number of shapes still referencing the file.
+};
+
 /**
  * Holds a list of aggregated curve shapes (strands).
  * PBRT's curve shape only contains a single strand.
@@ -226,6 +242,8 @@ struct BuilderContext
 
     std::map<std::string, InstanceDefinition> instanceDefinitions;
 
+    std::map<std::filesystem::path, PreloadedPlyMesh> plyMeshes;
+
     size_t curveCount = 0;
 
     bool usePBRTMaterials = false;
@@ -259,6 +277,40 @@ struct BuilderContext
         return pMaterial;
     }
 
+    /**
+     * Get the mesh data of a PLY file.
+     * Preloaded data is moved out on its last use, otherwise the file is loaded on demand.
+     * Returns an empty optional if the file failed to load.
+     */
+    std::optional<PlyMesh> getPlyMesh(const std::filesystem::path& path)
+    {
+        auto it = plyMeshes.find(path);
+        if (it == plyMeshes.end())
+        {
+            try
+            {
+                return readPlyMesh(path);
+            }
+            catch (const RuntimeError& e)
+            {
+                Falcor::logWarning(e.what());
+                return {};
+            }
+        }
+
+        std::optional<PlyMesh> mesh;
+        if (--it->second.useCount == 0)
+        {
+            mesh = std::move(it->second.mesh);
+            plyMeshes.erase(it);
+        }
+        else
+        {
+            mesh = it->second.mesh;
+        }
+        return mesh;
+    }
+
     Resolver resolver = [this](const std::filesystem::path& path) { return scene.resolvePath(path); };
 };
 
@@ -1593,9 +1645,11 @@ Shape createShape(BuilderContext& ctx, const ShapeSceneEntity& entity)
         auto filename = params.getString("filename", "");
         auto path = ctx.resolver(filename);
 
-        shape.pTriangleMesh = Falcor::TriangleMesh::createFromFile(path.string());
-        if (shape.pTriangleMesh)
+        if (auto plyMesh = ctx.getPlyMesh(path))
+        {
+            shape.pTriangleMesh = Falcor::TriangleMesh::create(std::move(plyMesh->vertices), std::move(plyMesh->indices));
             shape.pTriangleMesh->setName(filename);
+        }
         shape.transform = entity.transform;
     }
     else if (type == "loopsubdiv")
@@ -1614,8 +1668,17 @@ Shape createShape(BuilderContext& ctx, const ShapeSceneEntity& entity)
         if (P.empty())
             throwError(entity.loc, "Missing vertex positions in 'P'.");
 
-        auto result =
-            loopSubdivide(levels, P, fstd::span<const uint32_t>(reinterpret_cast<const uint32_t*>(indices.data()), indices.size()));
+        LoopSubdivision::Result result;
+        try
+        {
+            result = LoopSubdivision::subdivideFlat(
+                levels, P, fstd::span<const uint32_t>(reinterpret_cast<const uint32_t*>(indices.data()), indices.size())
+            );
+        }
+        catch (const RuntimeError& e)
+        {
+            throwError(entity.loc, "Invalid loop subdivision mesh: {}", e.what());
+        }
 
         Falcor::TriangleMesh::VertexList vertexList(result.positions.size());
         for (size_t i = 0; i < result.positions.size(); ++i)
@@ -1626,7 +1689,7 @@ Shape createShape(BuilderContext& ctx, const ShapeSceneEntity& entity)
             vertex.texCoord = float2(0.f);
         }
 
-        shape.pTriangleMesh = Falcor::TriangleMesh::create(vertexList, result.indices);
+        shape.pTriangleMesh = Falcor::TriangleMesh::create(std::move(vertexList), std::move(result.indices));
         shape.pTriangleMesh->setName("loopsubdiv");
         shape.transform = entity.transform;
     }
@@ -1791,6 +1854,71 @@ InstanceDefinition createInstanceDefinition(BuilderContext& ctx, const InstanceD
     return instanceDefinition;
 }
 
+/**
+ * Load the PLY files of all 'plymesh' shapes concurrently.
+ * This covers top-level shapes and shapes of instanced object definitions.
+ * The loaded meshes are consumed by createShape().
+ */
+void loadPlyMeshes(BuilderContext& ctx)
+{
+    auto addShape = [&ctx](const ShapeSceneEntity& entity)
+    {
+        if (entity.name == "plymesh")
+            ctx.plyMeshes[ctx.resolver(entity.params.getString("filename", ""))].useCount++;
+    };
+
+    for (const auto& entity : ctx.scene.getShapes())
+        addShape(entity);
+
+    std::set<std::string> instancedNames;
+    for (const auto& entity : ctx.scene.getInstances())
+        instancedNames.insert(entity.name);
+    for (const auto& name : instancedNames)
+    {
+        auto it = ctx.scene.getInstanceDefinitions().find(name);
+        if (it != ctx.scene.getInstanceDefinitions().end())
+        {
+            for (const auto& entity : it->second.shapes)
+                addShape(entity);
+        }
+    }
+
+    std::vector<std::pair<const std::filesystem::path, PreloadedPlyMesh>*> entries;
+    for (auto& entry : ctx.plyMeshes)
+        entries.push_back(&entry);
+
+    // Malformed files are skipped with a warning. Other errors are rethrown on the calling thread,
+    // as exceptions must not escape the parallel algorithm.
+    std::vector<std::exception_ptr> errors(entries.size());
+    auto range = NumericRange<size_t>(0, entries.size());
+    std::for_each(
+        std::execution::par,
+        range.begin(),
+        range.end(),
+        [&](size_t i)
+        {
+            try
+            {
+                entries[i]->second.mesh = readPlyMesh(entries[i]->first);
+            }
+            catch (const RuntimeError& e)
+            {
+                Falcor::logWarning(e.what());
+            }
+            catch (const std::exception&)
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+    );
+
+    for (const auto& error : errors)
+    {
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
+
 void buildScene(BuilderContext& ctx)
 {
     // Load float textures.
@@ -1842,18 +1970,27 @@ void buildScene(BuilderContext& ctx)
         }
     }
 
+    // Load PLY meshes concurrently before creating shapes.
+    loadPlyMeshes(ctx);
+
     // Process shapes and create meshes.
+    // The triangle meshes are added as a batch, so that they are processed concurrently.
+    std::vector<Falcor::NodeID> meshNodeIDs;
+    std::vector<std::pair<ref<TriangleMesh>, ref<Material>>> triangleMeshes;
     for (const auto& entity : ctx.scene.getShapes())
     {
         auto shape = createShape(ctx, entity);
         if (shape.pTriangleMesh)
         {
-            auto nodeID = ctx.builder.addNode({entity.name, shape.transform});
-            auto meshID = ctx.builder.addTriangleMesh(shape.pTriangleMesh, shape.pMaterial);
-            ctx.builder.addMeshInstance(nodeID, meshID);
+            meshNodeIDs.push_back(ctx.builder.addNode({entity.name, shape.transform}));
+            triangleMeshes.emplace_back(shape.pTriangleMesh, shape.pMaterial);
         }
     }
 
+    auto meshIDs = ctx.builder.addTriangleMeshes(triangleMeshes);
+    for (size_t i = 0; i < meshIDs.size(); ++i)
+        ctx.builder.addMeshInstance(meshNodeIDs[i], meshIDs[i]);
+
     // Create curves from curve aggregates assembled during the processing step above.
     for (const auto& [_, curveAggregate] : ctx.curveAggregates)
     {
@@ -38,8 +38,11 @@
 #include "Utils/Logger.h"
 
 #include <fast_float/fast_float.h>
+#include <BS_thread_pool/BS_thread_pool.hpp>
 
+#include <array>
 #include <atomic>
+#include <mutex>
 #include <utility>
 #include <charconv>
 
@@ -48,6 +51,263 @@ namespace Falcor::pbrt
 
 ParserTarget::~ParserTarget() {}
 
+void ParserRecorder::onScale(Float sx, Float sy, Float sz, FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onScale(sx, sy, sz, loc); });
+}
+
+void ParserRecorder::onShape(const std::string& name, ParsedParameterVector params, FileLoc loc)
+{
+    record([name, params = std::move(params), loc](ParserTarget& t) mutable { t.onShape(name, std::move(params), loc); });
+}
+
+void ParserRecorder::onOption(const std::string& name, const std::string& value, FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onOption(name, value, loc); });
+}
+
+void ParserRecorder::onIdentity(FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onIdentity(loc); });
+}
+
+void ParserRecorder::onTranslate(Float dx, Float dy, Float dz, FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onTranslate(dx, dy, dz, loc); });
+}
+
+void ParserRecorder::onRotate(Float angle, Float ax, Float ay, Float az, FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onRotate(angle, ax, ay, az, loc); });
+}
+
+void ParserRecorder::onLookAt(Float ex, Float ey, Float ez, Float lx, Float ly, Float lz, Float ux, Float uy, Float uz, FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onLookAt(ex, ey, ez, lx, ly, lz, ux, uy, uz, loc); });
+}
+
+void ParserRecorder::onConcatTransform(Float transform[16], FileLoc loc)
+{
+    std::array<Float, 16> m;
+    std::copy(transform, transform + 16, m.begin());
+    record([=](ParserTarget& t) mutable { t.onConcatTransform(m.data(), loc); });
+}
+
+void ParserRecorder::onTransform(Float transform[16], FileLoc loc)
+{
+    std::array<Float, 16> m;
+    std::copy(transform, transform + 16, m.begin());
+    record([=](ParserTarget& t) mutable { t.onTransform(m.data(), loc); });
+}
+
+void ParserRecorder::onCoordinateSystem(const std::string& name, FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onCoordinateSystem(name, loc); });
+}
+
+void ParserRecorder::onCoordSysTransform(const std::string& name, FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onCoordSysTransform(name, loc); });
+}
+
+void ParserRecorder::onActiveTransformAll(FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onActiveTransformAll(loc); });
+}
+
+void ParserRecorder::onActiveTransformEndTime(FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onActiveTransformEndTime(loc); });
+}
+
+void ParserRecorder::onActiveTransformStartTime(FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onActiveTransformStartTime(loc); });
+}
+
+void ParserRecorder::onTransformTimes(Float start, Float end, FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onTransformTimes(start, end, loc); });
+}
+
+void ParserRecorder::onColorSpace(const std::string& n, FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onColorSpace(n, loc); });
+}
+
+void ParserRecorder::onPixelFilter(const std::string& name, ParsedParameterVector params, FileLoc loc)
+{
+    record([name, params = std::move(params), loc](ParserTarget& t) mutable { t.onPixelFilter(name, std::move(params), loc); });
+}
+
+void ParserRecorder::onFilm(const std::string& type, ParsedParameterVector params, FileLoc loc)
+{
+    record([type, params = std::move(params), loc](ParserTarget& t) mutable { t.onFilm(type, std::move(params), loc); });
+}
+
+void ParserRecorder::onAccelerator(const std::string& name, ParsedParameterVector params, FileLoc loc)
+{
+    record([name, params = std::move(params), loc](ParserTarget& t) mutable { t.onAccelerator(name, std::move(params), loc); });
+}
+
+void ParserRecorder::onIntegrator(const std::string& name, ParsedParameterVector params, FileLoc loc)
+{
+    record([name, params = std::move(params), loc](ParserTarget& t) mutable { t.onIntegrator(name, std::move(params), loc); });
+}
+
+void ParserRecorder::onCamera(const std::string& name, ParsedParameterVector params, FileLoc loc)
+{
+    record([name, params = std::move(params), loc](ParserTarget& t) mutable { t.onCamera(name, std::move(params), loc); });
+}
+
+void ParserRecorder::onMakeNamedMedium(const std::string& name, ParsedParameterVector params, FileLoc loc)
+{
+    record([name, params = std::move(params), loc](ParserTarget& t) mutable { t.onMakeNamedMedium(name, std::move(params), loc); });
+}
+
+void ParserRecorder::onMediumInterface(const std::string& insideName, const std::string& outsideName, FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onMediumInterface(insideName, outsideName, loc); });
+}
+
+void ParserRecorder::onSampler(const std::string& name, ParsedParameterVector params, FileLoc loc)
+{
+    record([name, params = std::move(params), loc](ParserTarget& t) mutable { t.onSampler(name, std::move(params), loc); });
+}
+
+void ParserRecorder::onWorldBegin(FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onWorldBegin(loc); });
+}
+
+void ParserRecorder::onAttributeBegin(FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onAttributeBegin(loc); });
+}
+
+void ParserRecorder::onAttributeEnd(FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onAttributeEnd(loc); });
+}
+
+void ParserRecorder::onAttribute(const std::string& target, ParsedParameterVector params, FileLoc loc)
+{
+    record([target, params = std::move(params), loc](ParserTarget& t) mutable { t.onAttribute(target, std::move(params), loc); });
+}
+
+void ParserRecorder::onTexture(
+    const std::string& name,
+    const std::string& type,
+    const std::string& texname,
+    ParsedParameterVector params,
+    FileLoc loc
+)
+{
+    record([name, type, texname, params = std::move(params), loc](ParserTarget& t) mutable
+        { t.onTexture(name, type, texname, std::move(params), loc); });
+}
+
+void ParserRecorder::onMaterial(const std::string& name, ParsedParameterVector params, FileLoc loc)
+{
+    record([name, params = std::move(params), loc](ParserTarget& t) mutable { t.onMaterial(name, std::move(params), loc); });
+}
+
+void ParserRecorder::onMakeNamedMaterial(const std::string& name, ParsedParameterVector params, FileLoc loc)
+{
+    record([name, params = std::move(params), loc](ParserTarget& t) mutable { t.onMakeNamedMaterial(name, std::move(params), loc); });
+}
+
+void ParserRecorder::onNamedMaterial(const std::string& name, FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onNamedMaterial(name, loc); });
+}
+
+void ParserRecorder::onLightSource(const std::string& name, ParsedParameterVector params, FileLoc loc)
+{
+    record([name, params = std::move(params), loc](ParserTarget& t) mutable { t.onLightSource(name, std::move(params), loc); });
+}
+
+void ParserRecorder::onAreaLightSource(const std::string& name, ParsedParameterVector params, FileLoc loc)
+{
+    record([name, params = std::move(params), loc](ParserTarget& t) mutable { t.onAreaLightSource(name, std::move(params), loc); });
+}
+
+void ParserRecorder::onReverseOrientation(FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onReverseOrientation(loc); });
+}
+
+void ParserRecorder::onObjectBegin(const std::string& name, FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onObjectBegin(name, loc); });
+}
+
+void ParserRecorder::onObjectEnd(FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onObjectEnd(loc); });
+}
+
+void ParserRecorder::onObjectInstance(const std::string& name, FileLoc loc)
+{
+    record([=](ParserTarget& t) { t.onObjectInstance(name, loc); });
+}
+
+void ParserRecorder::onImport(ImportFuture import, FileLoc loc)
+{
+    mCommands.push_back(Command{nullptr, std::move(import), loc});
+    mImportCount++;
+}
+
+void ParserRecorder::replay(ParserTarget& target)
+{
+    while (!mCommands.empty())
+        replayFront(target);
+}
+
+bool ParserRecorder::replayReady(ParserTarget& target)
+{
+    while (!mCommands.empty())
+    {
+        const Command& command = mCommands.front();
+        if (!command.func && command.import.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return false;
+        replayFront(target);
+    }
+    return true;
+}
+
+void ParserRecorder::replayNextImport(ParserTarget& target)
+{
+    size_t importCount = mImportCount;
+    while (!mCommands.empty() && mImportCount == importCount)
+        replayFront(target);
+}
+
+void ParserRecorder::record(std::function<void(ParserTarget&)> func)
+{
+    mCommands.push_back(Command{std::move(func), {}, {}});
+}
+
+void ParserRecorder::replayFront(ParserTarget& target)
+{
+    // Pop the command before replaying it to release it (and its parameters) as soon as possible.
+    Command command = std::move(mCommands.front());
+    mCommands.pop_front();
+
+    if (command.func)
+    {
+        command.func(target);
+    }
+    else
+    {
+        mImportCount--;
+        std::unique_ptr<ParserRecorder> pRecorder = command.import.get();
+        target.onAttributeBegin(command.loc);
+        pRecorder->replay(target);
+        target.onAttributeEnd(command.loc);
+    }
+}
+
 std::string toString(const std::string_view sv)
 {
     return std::string(sv);
@@ -109,7 +369,12 @@ Tokenizer::Tokenizer(std::string str, const std::filesystem::path& path) : mPath
 {
     auto pFilename = std::make_unique<std::string>(path.string());
     mLoc = FileLoc(*pFilename);
-    getFilenames().push_back(std::move(pFilename));
+    {
+        // Tokenizers for imported files are created concurrently.
+        static std::mutex mutex;
+        std::lock_guard<std::mutex> lock(mutex);
+        getFilenames().push_back(std::move(pFilename));
+    }
 
     mPos = mContents.data();
     mEnd = mPos + mContents.size();
@@ -448,13 +713,71 @@ static ParsedParameterVector parseParameters(Next nextToken, Unget ungetToken)
     return parameterVector;
 }
 
-void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
+namespace
+{
+/**
+ * Thread pool for parsing imported files.
+ * The pool is created on the first 'Import' directive, so scenes without imports don't spawn any threads.
+ * Imported files are parsed into recorders. Imports nested in imported files are submitted
+ * to the pool as well and only waited on while replaying on the main thread,
+ * so the pool threads never block on each other.
+ */
+class ImportPool
+{
+public:
+    ParserRecorder::ImportFuture submit(std::filesystem::path path, std::filesystem::path searchPath);
+
+    /// Get the max number of imports the main file keeps pending before merging them into the final target.
+    size_t getMaxPendingImports() const { return 2 * mpThreadPool->get_thread_count(); }
+
+private:
+    std::unique_ptr<BS::thread_pool> mpThreadPool;
+};
+} // namespace
+
+static void parse(
+    ParserTarget& finalTarget,
+    std::unique_ptr<Tokenizer> tokenizer,
+    const std::filesystem::path& searchPath,
+    ImportPool& importPool
+);
+
+ParserRecorder::ImportFuture ImportPool::submit(std::filesystem::path path, std::filesystem::path searchPath)
+{
+    // The first import is always submitted from the main file, so creating the pool here is not racy.
+    if (!mpThreadPool)
+        mpThreadPool = std::make_unique<BS::thread_pool>();
+
+    return mpThreadPool->submit(
+        [this, path = std::move(path), searchPath = std::move(searchPath)]()
+        {
+            auto pImportRecorder = std::make_unique<ParserRecorder>();
+            parse(*pImportRecorder, Tokenizer::createFromFile(path), searchPath, *this);
+            return pImportRecorder;
+        }
+    );
+}
+
+static void parse(
+    ParserTarget& finalTarget,
+    std::unique_ptr<Tokenizer> tokenizer,
+    const std::filesystem::path& searchPath,
+    ImportPool& importPool
+)
 {
     static std::atomic<bool> warnedTransformBeginEndDeprecated{false};
 
-    logInfo("PBRTImporter: Started parsing '{}'.", tokenizer->getPath().string());
+    const std::string pathString = tokenizer->getPath().string();
+    logInfo("PBRTImporter: Started parsing '{}'.", pathString);
 
-    auto searchPath = tokenizer->getPath().parent_path();
+    // Imported files are merged into the final target in order, enclosed in an attribute block.
+    // When parsing an imported file, the final target is a recorder and nested imports are recorded into it.
+    // Otherwise, commands are dispatched directly to the final target while no imports are pending.
+    // Commands following a pending import are recorded and streamed to the final target
+    // as soon as the import is done. The number of pending imports is bounded to limit memory usage.
+    ParserRecorder* pImportRecorder = dynamic_cast<ParserRecorder*>(&finalTarget);
+    ParserTarget* pTarget = &finalTarget;
+    std::unique_ptr<ParserRecorder> pRecorder;
 
     std::vector<std::unique_ptr<Tokenizer>> fileStack;
     fileStack.push_back(std::move(tokenizer));
@@ -515,7 +838,7 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
         std::string_view dequoted = dequoteString(t);
         std::string n = toString(dequoted);
         ParsedParameterVector parameterVector = parseParameters(nextToken, unget);
-        (target.*apiFunc)(n, std::move(parameterVector), loc);
+        (pTarget->*apiFunc)(n, std::move(parameterVector), loc);
     };
 
     auto syntaxError = [&](const Token& t)
@@ -530,6 +853,14 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
 
     while (true)
     {
+        if (pRecorder && pTarget == pRecorder.get())
+        {
+            while (pRecorder->getImportCount() > importPool.getMaxPendingImports())
+                pRecorder->replayNextImport(finalTarget);
+            if (pRecorder->replayReady(finalTarget))
+                pTarget = &finalTarget;
+        }
+
         tok = nextToken(TokenOptional);
         if (!tok.has_value())
             break;
@@ -539,11 +870,11 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
         case 'A':
             if (tok->token == "AttributeBegin")
             {
-                target.onAttributeBegin(tok->loc);
+                pTarget->onAttributeBegin(tok->loc);
             }
             else if (tok->token == "AttributeEnd")
             {
-                target.onAttributeEnd(tok->loc);
+                pTarget->onAttributeEnd(tok->loc);
             }
             else if (tok->token == "Attribute")
             {
@@ -553,11 +884,11 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
             {
                 Token a = *nextToken(TokenRequired);
                 if (a.token == "All")
-                    target.onActiveTransformAll(tok->loc);
+                    pTarget->onActiveTransformAll(tok->loc);
                 else if (a.token == "EndTime")
-                    target.onActiveTransformEndTime(tok->loc);
+                    pTarget->onActiveTransformEndTime(tok->loc);
                 else if (a.token == "StartTime")
-                    target.onActiveTransformStartTime(tok->loc);
+                    pTarget->onActiveTransformStartTime(tok->loc);
                 else
                     syntaxError(*tok);
             }
@@ -585,22 +916,22 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
                     m[i] = parseFloat(*nextToken(TokenRequired));
                 if (nextToken(TokenRequired)->token != "]")
                     syntaxError(*tok);
-                target.onConcatTransform(m, tok->loc);
+                pTarget->onConcatTransform(m, tok->loc);
             }
             else if (tok->token == "CoordinateSystem")
             {
                 std::string_view n = dequoteString(*nextToken(TokenRequired));
-                target.onCoordinateSystem(toString(n), tok->loc);
+                pTarget->onCoordinateSystem(toString(n), tok->loc);
             }
             else if (tok->token == "CoordSysTransform")
             {
                 std::string_view n = dequoteString(*nextToken(TokenRequired));
-                target.onCoordSysTransform(toString(n), tok->loc);
+                pTarget->onCoordSysTransform(toString(n), tok->loc);
             }
             else if (tok->token == "ColorSpace")
             {
                 std::string_view n = dequoteString(*nextToken(TokenRequired));
-                target.onColorSpace(toString(n), tok->loc);
+                pTarget->onColorSpace(toString(n), tok->loc);
             }
             else if (tok->token == "Camera")
             {
@@ -639,11 +970,28 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
             }
             else if (tok->token == "Import")
             {
-                throwError(tok->loc, "'Import' directive not supported yet.");
+                Token filenameToken = *nextToken(TokenRequired);
+                std::string filename = toString(dequoteString(filenameToken));
+                auto path = searchPath / filename;
+
+                // Tokenize and parse the imported file on the import pool.
+                ParserRecorder::ImportFuture import = importPool.submit(path, searchPath);
+
+                if (pImportRecorder)
+                {
+                    pImportRecorder->onImport(std::move(import), tok->loc);
+                }
+                else
+                {
+                    if (!pRecorder)
+                        pRecorder = std::make_unique<ParserRecorder>();
+                    pTarget = pRecorder.get();
+                    pRecorder->onImport(std::move(import), tok->loc);
+                }
             }
             else if (tok->token == "Identity")
             {
-                target.onIdentity(tok->loc);
+                pTarget->onIdentity(tok->loc);
             }
             else
             {
@@ -661,7 +1009,7 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
                 Float v[9];
                 for (int i = 0; i < 9; ++i)
                     v[i] = parseFloat(*nextToken(TokenRequired));
-                target.onLookAt(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8], tok->loc);
+                pTarget->onLookAt(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8], tok->loc);
             }
             else
             {
@@ -703,7 +1051,7 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
                 else
                     names[1] = names[0];
 
-                target.onMediumInterface(names[0], names[1], tok->loc);
+                pTarget->onMediumInterface(names[0], names[1], tok->loc);
             }
             else
             {
@@ -715,7 +1063,7 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
             if (tok->token == "NamedMaterial")
             {
                 std::string_view n = dequoteString(*nextToken(TokenRequired));
-                target.onNamedMaterial(toString(n), tok->loc);
+                pTarget->onNamedMaterial(toString(n), tok->loc);
             }
             else
             {
@@ -727,22 +1075,22 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
             if (tok->token == "ObjectBegin")
             {
                 std::string_view n = dequoteString(*nextToken(TokenRequired));
-                target.onObjectBegin(toString(n), tok->loc);
+                pTarget->onObjectBegin(toString(n), tok->loc);
             }
             else if (tok->token == "ObjectEnd")
             {
-                target.onObjectEnd(tok->loc);
+                pTarget->onObjectEnd(tok->loc);
             }
             else if (tok->token == "ObjectInstance")
             {
                 std::string_view n = dequoteString(*nextToken(TokenRequired));
-                target.onObjectInstance(toString(n), tok->loc);
+                pTarget->onObjectInstance(toString(n), tok->loc);
             }
             else if (tok->token == "Option")
             {
                 std::string name = toString(dequoteString(*nextToken(TokenRequired)));
                 std::string value = toString(nextToken(TokenRequired)->token);
-                target.onOption(name, value, tok->loc);
+                pTarget->onOption(name, value, tok->loc);
             }
             else
             {
@@ -764,14 +1112,14 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
         case 'R':
             if (tok->token == "ReverseOrientation")
             {
-                target.onReverseOrientation(tok->loc);
+                pTarget->onReverseOrientation(tok->loc);
             }
             else if (tok->token == "Rotate")
             {
                 Float v[4];
                 for (int i = 0; i < 4; ++i)
                     v[i] = parseFloat(*nextToken(TokenRequired));
-                target.onRotate(v[0], v[1], v[2], v[3], tok->loc);
+                pTarget->onRotate(v[0], v[1], v[2], v[3], tok->loc);
             }
             else
             {
@@ -793,7 +1141,7 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
                 Float v[3];
                 for (int i = 0; i < 3; ++i)
                     v[i] = parseFloat(*nextToken(TokenRequired));
-                target.onScale(v[0], v[1], v[2], tok->loc);
+                pTarget->onScale(v[0], v[1], v[2], tok->loc);
             }
             else
             {
@@ -809,11 +1157,11 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
                     logWarning(tok->loc, "TransformBegin/End are deprecated and should be replaced with AttributeBegin/End.");
                     warnedTransformBeginEndDeprecated = true;
                 }
-                target.onAttributeBegin(tok->loc);
+                pTarget->onAttributeBegin(tok->loc);
             }
             else if (tok->token == "TransformEnd")
             {
-                target.onAttributeEnd(tok->loc);
+                pTarget->onAttributeEnd(tok->loc);
             }
             else if (tok->token == "Transform")
             {
@@ -824,21 +1172,21 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
                     m[i] = parseFloat(*nextToken(TokenRequired));
                 if (nextToken(TokenRequired)->token != "]")
                     syntaxError(*tok);
-                target.onTransform(m, tok->loc);
+                pTarget->onTransform(m, tok->loc);
             }
             else if (tok->token == "Translate")
             {
                 Float v[3];
                 for (int i = 0; i < 3; ++i)
                     v[i] = parseFloat(*nextToken(TokenRequired));
-                target.onTranslate(v[0], v[1], v[2], tok->loc);
+                pTarget->onTranslate(v[0], v[1], v[2], tok->loc);
             }
             else if (tok->token == "TransformTimes")
             {
                 Float v[2];
                 for (int i = 0; i < 2; ++i)
                     v[i] = parseFloat(*nextToken(TokenRequired));
-                target.onTransformTimes(v[0], v[1], tok->loc);
+                pTarget->onTransformTimes(v[0], v[1], tok->loc);
             }
             else if (tok->token == "Texture")
             {
@@ -851,7 +1199,7 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
                 std::string_view dequoted = dequoteString(t);
                 std::string texName = toString(dequoted);
                 ParsedParameterVector params = parseParameters(nextToken, unget);
-                target.onTexture(name, type, texName, std::move(params), tok->loc);
+                pTarget->onTexture(name, type, texName, std::move(params), tok->loc);
             }
             else
             {
@@ -862,7 +1210,7 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
         case 'W':
             if (tok->token == "WorldBegin")
             {
-                target.onWorldBegin(tok->loc);
+                pTarget->onWorldBegin(tok->loc);
             }
             else
             {
@@ -874,19 +1222,28 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
             syntaxError(*tok);
         }
     }
+
+    if (pRecorder && pRecorder->getCommandCount() > 0)
+    {
+        logInfo("PBRTImporter: Merging imported files into '{}'.", pathString);
+        pRecorder->replay(finalTarget);
+    }
 }
 
 void parseFile(ParserTarget& target, const std::filesystem::path& path)
 {
     auto tokenizer = Tokenizer::createFromFile(path);
-    parse(target, std::move(tokenizer));
+    ImportPool importPool;
+    parse(target, std::move(tokenizer), path.parent_path(), importPool);
     target.onEndOfFiles();
 }
 
 void parseString(ParserTarget& target, std::string str)
 {
     auto tokenizer = Tokenizer::createFromString(std::move(str));
-    parse(target, std::move(tokenizer));
+    auto searchPath = tokenizer->getPath().parent_path();
+    ImportPool importPool;
+    parse(target, std::move(tokenizer), searchPath, importPool);
     target.onEndOfFiles();
 }
 
@@ -35,11 +35,14 @@
 
 #include "Types.h"
 #include "Parameters.h"
+#include <deque>
 #include <functional>
 #include <filesystem>
+#include <future>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace Falcor::pbrt
 {
@@ -101,6 +104,112 @@ public:
     virtual void onEndOfFiles() = 0;
 };
 
+/**
+ * Parser target recording all commands into a buffer for later replay.
+ * This is used to parse imported files (pbrt 'Import' directive) concurrently
+ * and merge the results into the main parser target in a deterministic order.
+ */
+class ParserRecorder : public ParserTarget
+{
+public:
+    using ImportFuture = std::future<std::unique_ptr<ParserRecorder>>;
+
+    void onScale(Float sx, Float sy, Float sz, FileLoc loc) override;
+    void onShape(const std::string& name, ParsedParameterVector params, FileLoc loc) override;
+    void onOption(const std::string& name, const std::string& value, FileLoc loc) override;
+    void onIdentity(FileLoc loc) override;
+    void onTranslate(Float dx, Float dy, Float dz, FileLoc loc) override;
+    void onRotate(Float angle, Float ax, Float ay, Float az, FileLoc loc) override;
+    void onLookAt(Float ex, Float ey, Float ez, Float lx, Float ly, Float lz, Float ux, Float uy, Float uz, FileLoc loc) override;
+    void onConcatTransform(Float transform[16], FileLoc loc) override;
+    void onTransform(Float transform[16], FileLoc loc) override;
+    void onCoordinateSystem(const std::string& name, FileLoc loc) override;
+    void onCoordSysTransform(const std::string& name, FileLoc loc) override;
+    void onActiveTransformAll(FileLoc loc) override;
+    void onActiveTransformEndTime(FileLoc loc) override;
+    void onActiveTransformStartTime(FileLoc loc) override;
+    void onTransformTimes(Float start, Float end, FileLoc loc) override;
+    void onColorSpace(const std::string& n, FileLoc loc) override;
+    void onPixelFilter(const std::string& name, ParsedParameterVector params, FileLoc loc) override;
+    void onFilm(const std::string& type, ParsedParameterVector params, FileLoc loc) override;
+    void onAccelerator(const std::string& name, ParsedParameterVector params, FileLoc loc) override;
+    void onIntegrator(const std::string& name, ParsedParameterVector params, FileLoc loc) override;
+    void onCamera(const std::string& name, ParsedParameterVector params, FileLoc loc) override;
+    void onMakeNamedMedium(const std::string& name, ParsedParameterVector params, FileLoc loc) override;
+    void onMediumInterface(const std::string& insideName, const std::string& outsideName, FileLoc loc) override;
+    void onSampler(const std::string& name, ParsedParameterVector params, FileLoc loc) override;
+    void onWorldBegin(FileLoc loc) override;
+    void onAttributeBegin(FileLoc loc) override;
+    void onAttributeEnd(FileLoc loc) override;
+    void onAttribute(const std::string& target, ParsedParameterVector params, FileLoc loc) override;
+    void onTexture(const std::string& name, const std::string& type, const std::string& texname, ParsedParameterVector params, FileLoc loc)
+        override;
+    void onMaterial(const std::string& name, ParsedParameterVector params, FileLoc loc) override;
+    void onMakeNamedMaterial(const std::string& name, ParsedParameterVector params, FileLoc loc) override;
+    void onNamedMaterial(const std::string& name, FileLoc loc) override;
+    void onLightSource(const std::string& name, ParsedParameterVector params, FileLoc loc) override;
+    void onAreaLightSource(const std::string& name, ParsedParameterVector params, FileLoc loc) override;
+    void onReverseOrientation(FileLoc loc) override;
+    void onObjectBegin(const std::string& name, FileLoc loc) override;
+    void onObjectEnd(FileLoc loc) override;
+    void onObjectInstance(const std::string& name, FileLoc loc) override;
+
+    /// End of files is signaled by the parser on the final target only, not on recorders.
+    void onEndOfFiles() override {}
+
+    /**
+     * Record an imported file that is being parsed asynchronously.
+     * On replay, this waits for the import to finish and replays its commands
+     * enclosed in an attribute block, i.e. the imported file starts with a copy
+     * of the current graphics state and changes to it do not leak out.
+     * \param[in] import Future returning the recorder the imported file was parsed into.
+     * \param[in] loc Location of the 'Import' directive.
+     */
+    void onImport(ImportFuture import, FileLoc loc);
+
+    /**
+     * Replay all recorded commands into a parser target.
+     * The recorded commands are released while replaying.
+     * Errors that occurred while parsing imported files are rethrown here.
+     * \param[in] target Target to replay the commands into.
+     */
+    void replay(ParserTarget& target);
+
+    /**
+     * Replay the recorded commands up to the first import that is still being parsed.
+     * This lets the commands following an import be streamed to the target as soon as the import is done.
+     * \param[in] target Target to replay the commands into.
+     * \return True if all commands were replayed.
+     */
+    bool replayReady(ParserTarget& target);
+
+    /**
+     * Replay the recorded commands up to and including the first import, waiting for the import if needed.
+     * \param[in] target Target to replay the commands into.
+     */
+    void replayNextImport(ParserTarget& target);
+
+    /// Get the number of recorded commands (imports count as a single command).
+    size_t getCommandCount() const { return mCommands.size(); }
+
+    /// Get the number of recorded imports.
+    size_t getImportCount() const { return mImportCount; }
+
+private:
+    struct Command
+    {
+        std::function<void(ParserTarget&)> func; ///< Recorded command, or empty for an import.
+        ImportFuture import;
+        FileLoc loc;
+    };
+
+    void record(std::function<void(ParserTarget&)> func);
+    void replayFront(ParserTarget& target);
+
+    std::deque<Command> mCommands;
+    size_t mImportCount = 0;
+};
+
 void parseFile(ParserTarget& target, const std::filesystem::path& path);
 void parseString(ParserTarget& target, std::string str);
 
@@ -0,0 +1,654 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+
+#include "PlyReader.h"
+#include "Core/Error.h"
+#include "Core/Platform/OS.h"
+#include "Core/Platform/MemoryMappedFile.h"
+
+#include <fast_float/fast_float.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Falcor::pbrt
+{
+
+namespace
+{
+enum class PlyFormat
+{
+    Ascii,
+    BinaryLittleEndian,
+    BinaryBigEndian,
+};
+
+enum class PlyType
+{
+    Int8,
+    UInt8,
+    Int16,
+    UInt16,
+    Int32,
+    UInt32,
+    Float32,
+    Float64,
+};
+
+std::optional<PlyType> parsePlyType(std::string_view str)
+{
+    if (str == "char" || str == "int8")
+        return PlyType::Int8;
+    if (str == "uchar" || str == "uint8")
+        return PlyType::UInt8;
+    if (str == "short" || str == "int16")
+        return PlyType::Int16;
+    if (str == "ushort" || str == "uint16")
+        return PlyType::UInt16;
+    if (str == "int" || str == "int32")
+        return PlyType::Int32;
+    if (str == "uint" || str == "uint32")
+        return PlyType::UInt32;
+    if (str == "float" || str == "float32")
+        return PlyType::Float32;
+    if (str == "double" || str == "float64")
+        return PlyType::Float64;
+    return {};
+}
+
+size_t getPlyTypeSize(PlyType type)
+{
+    switch (type)
+    {
+    case PlyType::Int8:
+    case PlyType::UInt8:
+        return 1;
+    case PlyType::Int16:
+    case PlyType::UInt16:
+        return 2;
+    case PlyType::Int32:
+    case PlyType::UInt32:
+    case PlyType::Float32:
+        return 4;
+    case PlyType::Float64:
+        return 8;
+    }
+    FALCOR_UNREACHABLE();
+    return 0;
+}
+
+struct PlyProperty
+{
+    std::string name;
+    PlyType type = PlyType::Float32;
+    bool isList = false;
+    PlyType countType = PlyType::UInt8;
+};
+
+struct PlyElement
+{
+    std::string name;
+    size_t count = 0;
+    std::vector<PlyProperty> properties;
+
+    int findProperty(std::string_view name) const
+    {
+        for (size_t i = 0; i < properties.size(); ++i)
+            if (properties[i].name == name)
+                return (int)i;
+        return -1;
+    }
+
+    /// Returns the size in bytes of a single binary element or 0 if the element contains list properties.
+    size_t getFixedSize() const
+    {
+        size_t size = 0;
+        for (const auto& property : properties)
+        {
+            if (property.isList)
+                return 0;
+            size += getPlyTypeSize(property.type);
+        }
+        return size;
+    }
+};
+
+template<typename T>
+T loadBinary(const char* p, bool swap)
+{
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, p, sizeof(T));
+    if (swap)
+        std::reverse(bytes, bytes + sizeof(T));
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+double loadBinary(const char* p, PlyType type, bool swap)
+{
+    switch (type)
+    {
+    case PlyType::Int8:
+        return (double)loadBinary<int8_t>(p, false);
+    case PlyType::UInt8:
+        return (double)loadBinary<uint8_t>(p, false);
+    case PlyType::Int16:
+        return (double)loadBinary<int16_t>(p, swap);
+    case PlyType::UInt16:
+        return (double)loadBinary<uint16_t>(p, swap);
+    case PlyType::Int32:
+        return (double)loadBinary<int32_t>(p, swap);
+    case PlyType::UInt32:
+        return (double)loadBinary<uint32_t>(p, swap);
+    case PlyType::Float32:
+        return (double)loadBinary<float>(p, swap);
+    case PlyType::Float64:
+        return loadBinary<double>(p, swap);
+    }
+    FALCOR_UNREACHABLE();
+    return 0.0;
+}
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+class PlyParser
+{
+public:
+    PlyParser(std::string_view data, std::string_view name) : mData(data), mName(name)
+    {
+        mPos = mData.data();
+        mEnd = mData.data() + mData.size();
+    }
+
+    PlyMesh parse()
+    {
+        parseHeader();
+
+        PlyMesh mesh;
+        bool hasVertices = false;
+        bool hasNormals = false;
+
+        for (const auto& element : mElements)
+        {
+            if (element.name == "vertex")
+            {
+                hasNormals = readVertices(element, mesh.vertices);
+                hasVertices = true;
+            }
+            else if (element.name == "face")
+            {
+                readFaces(element, mesh.indices);
+            }
+            else
+            {
+                skipElement(element);
+            }
+        }
+
+        if (!hasVertices)
+            error("No 'vertex' element found");
+
+        for (uint32_t index : mesh.indices)
+        {
+            if (index >= mesh.vertices.size())
+                error("Vertex index {} is out of bounds", index);
+        }
+
+        if (!hasNormals)
+            generateFacetNormals(mesh);
+
+        return mesh;
+    }
+
+private:
+    template<typename... Args>
+    [[noreturn]] void error(fmt::format_string<Args...> format, Args&&... args) const
+    {
+        auto msg = fmt::format(format, std::forward<Args>(args)...);
+        FALCOR_THROW("Failed to read PLY file '{}': {}.", mName, msg);
+    }
+
+    std::string_view nextHeaderLine()
+    {
+        const char* lineEnd = std::find(mPos, mEnd, '\n');
+        if (lineEnd == mEnd)
+            error("Unexpected end of header");
+        std::string_view line(mPos, lineEnd - mPos);
+        mPos = lineEnd + 1;
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        return line;
+    }
+
+    static std::vector<std::string_view> splitTokens(std::string_view line)
+    {
+        std::vector<std::string_view> tokens;
+        size_t i = 0;
+        while (i < line.size())
+        {
+            while (i < line.size() && isSpace(line[i]))
+                ++i;
+            size_t start = i;
+            while (i < line.size() && !isSpace(line[i]))
+                ++i;
+            if (i > start)
+                tokens.push_back(line.substr(start, i - start));
+        }
+        return tokens;
+    }
+
+    void parseHeader()
+    {
+        if (nextHeaderLine() != "ply")
+            error("Invalid magic");
+
+        bool hasFormat = false;
+        while (true)
+        {
+            auto tokens = splitTokens(nextHeaderLine());
+            if (tokens.empty() || tokens[0] == "comment" || tokens[0] == "obj_info")
+                continue;
+
+            if (tokens[0] == "end_header")
+                break;
+
+            if (tokens[0] == "format")
+            {
+                if (tokens.size() < 2)
+                    error("Invalid format declaration");
+                if (tokens[1] == "ascii")
+                    mFormat = PlyFormat::Ascii;
+                else if (tokens[1] == "binary_little_endian")
+                    mFormat = PlyFormat::BinaryLittleEndian;
+                else if (tokens[1] == "binary_big_endian")
+                    mFormat = PlyFormat::BinaryBigEndian;
+                else
+                    error("Unknown format '{}'", tokens[1]);
+                hasFormat = true;
+            }
+            else if (tokens[0] == "element")
+            {
+                if (tokens.size() != 3)
+                    error("Invalid element declaration");
+                PlyElement element;
+                element.name = std::string(tokens[1]);
+                auto result = std::from_chars(tokens[2].data(), tokens[2].data() + tokens[2].size(), element.count);
+                if (result.ec != std::errc())
+                    error("Invalid element count '{}'", tokens[2]);
+                mElements.push_back(std::move(element));
+            }
+            else if (tokens[0] == "property")
+            {
+                if (mElements.empty())
+                    error("Property declared before any element");
+                PlyProperty property;
+                if (tokens.size() == 5 && tokens[1] == "list")
+                {
+                    auto countType = parsePlyType(tokens[2]);
+                    auto type = parsePlyType(tokens[3]);
+                    if (!countType || !type)
+                        error("Invalid list property types '{} {}'", tokens[2], tokens[3]);
+                    property.isList = true;
+                    property.countType = *countType;
+                    property.type = *type;
+                    property.name = std::string(tokens[4]);
+                }
+                else if (tokens.size() == 3)
+                {
+                    auto type = parsePlyType(tokens[1]);
+                    if (!type)
+                        error("Invalid property type '{}'", tokens[1]);
+                    property.type = *type;
+                    property.name = std::string(tokens[2]);
+                }
+                else
+                {
+                    error("Invalid property declaration");
+                }
+                mElements.back().properties.push_back(std::move(property));
+            }
+            else
+            {
+                error("Unknown header keyword '{}'", tokens[0]);
+            }
+        }
+
+        if (!hasFormat)
+            error("Missing format declaration");
+
+        mSwap = mFormat == PlyFormat::BinaryBigEndian;
+    }
+
+    /// Read the next value of the given type and advance.
+    double readValue(PlyType type)
+    {
+        if (mFormat == PlyFormat::Ascii)
+        {
+            while (mPos < mEnd && isSpace(*mPos))
+                ++mPos;
+            const char* start = mPos;
+            while (mPos < mEnd && !isSpace(*mPos))
+                ++mPos;
+            if (start == mPos)
+                error("Unexpected end of file");
+            // Skip '+' character, fast_float::from_chars doesn't handle '+'.
+            if (*start == '+')
+                ++start;
+            double value;
+            auto result = fast_float::from_chars(start, mPos, value);
+            if (result.ptr != mPos)
+                error("Invalid number '{}'", std::string_view(start, mPos - start));
+            return value;
+        }
+        else
+        {
+            size_t size = getPlyTypeSize(type);
+            if (size_t(mEnd - mPos) < size)
+                error("Unexpected end of file");
+            double value = loadBinary(mPos, type, mSwap);
+            mPos += size;
+            return value;
+        }
+    }
+
+    /// Returns the min size in bytes of a value of the given type in the file.
+    size_t getMinValueSize(PlyType type) const
+    {
+        // ASCII values take at least one character and a separator.
+        return mFormat == PlyFormat::Ascii ? 2 : getPlyTypeSize(type);
+    }
+
+    /**
+     * Check that the remaining data is large enough to hold a number of items.
+     * This is done before allocating memory for the items, so that malformed counts don't lead to huge allocations.
+     */
+    void checkRemainingSize(size_t count, size_t minItemSize, std::string_view elementName) const
+    {
+        // The last ASCII value doesn't need a separator.
+        size_t remaining = size_t(mEnd - mPos) + (mFormat == PlyFormat::Ascii ? 1 : 0);
+        if (minItemSize > 0 && remaining / minItemSize < count)
+            error("Unexpected end of file in element '{}'", elementName);
+    }
+
+    void checkRemainingSize(const PlyElement& element) const
+    {
+        size_t minSize = 0;
+        for (const auto& property : element.properties)
+            minSize += getMinValueSize(property.isList ? property.countType : property.type);
+        checkRemainingSize(element.count, minSize, element.name);
+    }
+
+    void skipProperty(const PlyProperty& property)
+    {
+        if (property.isList)
+        {
+            size_t count = (size_t)readValue(property.countType);
+            if (mFormat == PlyFormat::Ascii)
+            {
+                for (size_t i = 0; i < count; ++i)
+                    readValue(property.type);
+            }
+            else
+            {
+                size_t size = count * getPlyTypeSize(property.type);
+                if (size_t(mEnd - mPos) < size)
+                    error("Unexpected end of file");
+                mPos += size;
+            }
+        }
+        else
+        {
+            readValue(property.type);
+        }
+    }
+
+    void skipElement(const PlyElement& element)
+    {
+        size_t fixedSize = element.getFixedSize();
+        if (mFormat != PlyFormat::Ascii && fixedSize > 0)
+        {
+            if (size_t(mEnd - mPos) / fixedSize < element.count)
+                error("Unexpected end of file in element '{}'", element.name);
+            mPos += element.count * fixedSize;
+            return;
+        }
+
+        for (size_t i = 0; i < element.count; ++i)
+            for (const auto& property : element.properties)
+                skipProperty(property);
+    }
+
+    /**
+     * Read the vertex element.
+     * \return Returns true if the vertices have normals.
+     */
+    bool readVertices(const PlyElement& element, TriangleMesh::VertexList& vertices)
+    {
+        // Map vertex attributes to property indices (component order x, y, z / u, v).
+        auto findAny = [&](std::initializer_list<std::string_view> names)
+        {
+            for (auto name : names)
+                if (int index = element.findProperty(name); index >= 0)
+                    return index;
+            return -1;
+        };
+        const int positionProps[3] = {element.findProperty("x"), element.findProperty("y"), element.findProperty("z")};
+        const int normalProps[3] = {element.findProperty("nx"), element.findProperty("ny"), element.findProperty("nz")};
+        const int texCoordProps[2] = {
+            findAny({"u", "s", "texture_u", "texture_s"}),
+            findAny({"v", "t", "texture_v", "texture_t"}),
+        };
+
+        for (int prop : positionProps)
+            if (prop < 0)
+                error("Vertex element is missing position properties");
+        for (const auto& property : element.properties)
+            if (property.isList)
+                error("Vertex element has unsupported list property '{}'", property.name);
+
+        const bool hasNormals = normalProps[0] >= 0 && normalProps[1] >= 0 && normalProps[2] >= 0;
+        const bool hasTexCoords = texCoordProps[0] >= 0 && texCoordProps[1] >= 0;
+
+        checkRemainingSize(element);
+
+        // Byte offset within TriangleMesh::Vertex each property is decoded into (SIZE_MAX if unused).
+        vertices.resize(element.count);
+        std::vector<size_t> componentOffsets(element.properties.size(), SIZE_MAX);
+        for (int i = 0; i < 3; ++i)
+        {
+            componentOffsets[positionProps[i]] = offsetof(TriangleMesh::Vertex, position) + i * sizeof(float);
+            if (hasNormals)
+                componentOffsets[normalProps[i]] = offsetof(TriangleMesh::Vertex, normal) + i * sizeof(float);
+            if (hasTexCoords && i < 2)
+                componentOffsets[texCoordProps[i]] = offsetof(TriangleMesh::Vertex, texCoord) + i * sizeof(float);
+        }
+
+        auto storeComponent = [&](TriangleMesh::Vertex& vertex, size_t propIndex, double value)
+        {
+            size_t offset = componentOffsets[propIndex];
+            if (offset != SIZE_MAX)
+            {
+                float f = (float)value;
+                std::memcpy(reinterpret_cast<char*>(&vertex) + offset, &f, sizeof(float));
+            }
+        };
+
+        if (mFormat == PlyFormat::Ascii)
+        {
+            for (auto& vertex : vertices)
+            {
+                vertex = {};
+                for (size_t p = 0; p < element.properties.size(); ++p)
+                    storeComponent(vertex, p, readValue(element.properties[p].type));
+            }
+        }
+        else
+        {
+            // Binary vertices have a fixed stride, decode the properties at precomputed byte offsets.
+            // The remaining size for all vertices has been checked above.
+            const size_t stride = element.getFixedSize();
+
+            std::vector<size_t> byteOffsets(element.properties.size());
+            for (size_t p = 0, offset = 0; p < element.properties.size(); ++p)
+            {
+                byteOffsets[p] = offset;
+                offset += getPlyTypeSize(element.properties[p].type);
+            }
+
+            const char* pBase = mPos;
+            for (size_t i = 0; i < element.count; ++i, pBase += stride)
+            {
+                auto& vertex = vertices[i];
+                vertex = {};
+                for (size_t p = 0; p < element.properties.size(); ++p)
+                {
+                    if (componentOffsets[p] != SIZE_MAX)
+                        storeComponent(vertex, p, loadBinary(pBase + byteOffsets[p], element.properties[p].type, mSwap));
+                }
+            }
+            mPos += element.count * stride;
+        }
+
+        if (hasTexCoords)
+        {
+            for (auto& vertex : vertices)
+                vertex.texCoord.y = 1.f - vertex.texCoord.y;
+        }
+
+        return hasNormals;
+    }
+
+    void readFaces(const PlyElement& element, TriangleMesh::IndexList& indices)
+    {
+        int indicesProp = element.findProperty("vertex_indices");
+        if (indicesProp < 0)
+            indicesProp = element.findProperty("vertex_index");
+        if (indicesProp < 0 || !element.properties[indicesProp].isList)
+            error("Face element is missing the 'vertex_indices' list property");
+
+        checkRemainingSize(element);
+
+        // Most meshes are triangle meshes, reserve for that.
+        indices.reserve(indices.size() + element.count * 3);
+
+        std::vector<uint32_t> polygon;
+        for (size_t i = 0; i < element.count; ++i)
+        {
+            for (size_t p = 0; p < element.properties.size(); ++p)
+            {
+                const auto& property = element.properties[p];
+                if ((int)p != indicesProp)
+                {
+                    skipProperty(property);
+                    continue;
+                }
+
+                size_t count = (size_t)readValue(property.countType);
+                checkRemainingSize(count, getMinValueSize(property.type), element.name);
+                polygon.resize(count);
+                for (size_t j = 0; j < count; ++j)
+                {
+                    double index = readValue(property.type);
+                    if (index < 0.0)
+                        error("Negative vertex index {}", index);
+                    polygon[j] = (uint32_t)index;
+                }
+
+                // Triangulate the polygon as a fan. Faces with less than 3 vertices are ignored.
+                for (size_t j = 2; j < count; ++j)
+                {
+                    indices.push_back(polygon[0]);
+                    indices.push_back(polygon[j - 1]);
+                    indices.push_back(polygon[j]);
+                }
+            }
+        }
+    }
+
+    static void generateFacetNormals(PlyMesh& mesh)
+    {
+        TriangleMesh::VertexList vertices(mesh.indices.size());
+        for (size_t i = 0; i < mesh.indices.size(); i += 3)
+        {
+            for (size_t j = 0; j < 3; ++j)
+                vertices[i + j] = mesh.vertices[mesh.indices[i + j]];
+
+            float3 n = cross(vertices[i + 1].position - vertices[i].position, vertices[i + 2].position - vertices[i].position);
+            float len = length(n);
+            n = len > 0.f ? n / len : float3(0.f);
+            for (size_t j = 0; j < 3; ++j)
+            {
+                vertices[i + j].normal = n;
+                mesh.indices[i + j] = (uint32_t)(i + j);
+            }
+        }
+        mesh.vertices = std::move(vertices);
+    }
+
+    std::string_view mData;
+    std::string_view mName;
+    const char* mPos;
+    const char* mEnd;
+
+    PlyFormat mFormat = PlyFormat::Ascii;
+    bool mSwap = false;
+    std::vector<PlyElement> mElements;
+};
+
+} // namespace
+
+PlyMesh readPlyMesh(std::string_view data, std::string_view name)
+{
+    PlyParser parser(data, name);
+    return parser.parse();
+}
+
+PlyMesh readPlyMesh(const std::filesystem::path& path)
+{
+    if (hasExtension(path, "gz"))
+    {
+        std::string data = decompressFile(path);
+        return readPlyMesh(data, path.string());
+    }
+
+    MemoryMappedFile file(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
+    if (!file.isOpen())
+        FALCOR_THROW("Failed to open PLY file '{}'.", path);
+    return readPlyMesh(std::string_view(static_cast<const char*>(file.getData()), file.getSize()), path.string());
+}
+
+} // namespace Falcor::pbrt
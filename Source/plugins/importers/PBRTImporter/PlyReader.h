@@ -0,0 +1,69 @@
+/***************************************************************************
+ # Copyright (c) 2015-24, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+
+#pragma once
+#include "Scene/TriangleMesh.h"
+#include <filesystem>
+#include <string_view>
+
+namespace Falcor::pbrt
+{
+
+/**
+ * Triangle mesh data read from a PLY file.
+ * The data is decoded directly into the layout used by Falcor::TriangleMesh.
+ */
+struct PlyMesh
+{
+    TriangleMesh::VertexList vertices;
+    TriangleMesh::IndexList indices;
+};
+
+/**
+ * Read a triangle mesh from a PLY file.
+ * Supports ASCII and binary (little and big endian) PLY files, including gzip compressed files (.ply.gz)
+ * as written by pbrt-v4. Uncompressed files are memory mapped. This function is thread safe.
+ * Polygons are triangulated as triangle fans. Vertex attributes are read from the 'x/y/z',
+ * 'nx/ny/nz' and 'u/v' (or 's/t', 'texture_u/texture_v') properties, all other data is ignored.
+ * Texture coordinates are flipped vertically to account for pbrt's bottom-left image origin.
+ * If the file does not contain normals, vertices are unshared and facet normals are generated.
+ * Throws a RuntimeError if the file cannot be read or is malformed.
+ * \param[in] path File path.
+ * \return Returns the mesh data.
+ */
+PlyMesh readPlyMesh(const std::filesystem::path& path);
+
+/**
+ * Read a triangle mesh from PLY data in memory.
+ * \param[in] data PLY file contents.
+ * \param[in] name Name used in error messages.
+ * \return Returns the mesh data.
+ */
+PlyMesh readPlyMesh(std::string_view data, std::string_view name);
+
+} // namespace Falcor::pbrt
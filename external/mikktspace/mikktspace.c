@@ -1532,6 +1532,8 @@ static void BuildNeighborsFast(STriInfo pTriInfos[], SEdge * pEdges, const int p
 			QuickSortEdges(pEdges, iL, iR, 1, uSeed);	// sort channel 1 which is i1
 		}
 	}
+	// Falcor local change (patches/0001-sort-last-edge-segment.patch): the loop above does not visit the last segment
+	QuickSortEdges(pEdges, iCurStartIndex, iEntries-1, 1, uSeed);
 
 	// sub sort over f, which should be fast.
 	// this step is to remain compliant with BuildNeighborsSlow() when
@@ -1548,6 +1550,8 @@ static void BuildNeighborsFast(STriInfo pTriInfos[], SEdge * pEdges, const int p
 			QuickSortEdges(pEdges, iL, iR, 2, uSeed);	// sort channel 2 which is f
 		}
 	}
+	// Falcor local change (patches/0001-sort-last-edge-segment.patch): same for channel 2
+	QuickSortEdges(pEdges, iCurStartIndex, iEntries-1, 2, uSeed);
 
 	// pair up, adjacent triangles
 	for (i=0; i<iEntries; i++)